@@ -185,6 +185,7 @@ export enum BinaryMessageType {
   RESPONSE = 0x02,
   STATE = 0x03,
   EVENT = 0x04,
+  METRICS = 0x05,
   PING = 0xfe,
   PONG = 0xff,
 }
@@ -242,6 +243,112 @@ export function decodeBinaryMessage(data: Uint8Array): {
   return { type, flags, payload };
 }
 
+// ============================================================================
+// METRICS
+// ============================================================================
+
+/**
+ * Firmware metrics, in wire order (mirrors MetricId in ucf_metrics.h).
+ * Append only; the firmware bumps the format version if one is removed.
+ */
+export const METRIC_DEFINITIONS = [
+  { name: "i2c_errors", kind: "counter" },
+  { name: "sensor_errors", kind: "counter" },
+  { name: "validation_errors", kind: "counter" },
+  { name: "triad_unlocks", kind: "counter" },
+  { name: "k_formations", kind: "counter" },
+  { name: "sync_events", kind: "counter" },
+  { name: "frames_dropped", kind: "counter" },
+  { name: "events_dropped", kind: "counter" },
+  { name: "session_dropped", kind: "counter" },
+  { name: "log_dropped", kind: "counter" },
+  { name: "output_writes", kind: "counter" },
+  { name: "output_writes_avoided", kind: "counter" },
+  { name: "kuramoto_overruns", kind: "counter" },
+  { name: "kuramoto_steps_dropped", kind: "counter" },
+  { name: "mesh_lost", kind: "counter" },
+  { name: "kuramoto_misses", kind: "counter" },
+  { name: "loop_rate_hz", kind: "gauge" },
+  { name: "sensor_rate_hz", kind: "gauge" },
+  { name: "order_param", kind: "gauge" },
+  { name: "ota_bytes", kind: "gauge" },
+  { name: "heap_free", kind: "gauge" },
+  { name: "heap_min_free", kind: "gauge" },
+  { name: "mesh_peers", kind: "gauge" },
+  { name: "sensor_read_us", kind: "histogram" },
+] as const;
+
+/** Metrics payload format version */
+export const METRICS_FORMAT_VERSION = 1;
+
+/** Power-of-two histogram buckets per histogram metric */
+export const METRICS_HIST_BUCKETS = 16;
+
+/** Histogram metric value */
+export interface MetricHistogram {
+  count: number;
+  sum: number;
+  /** Bucket i holds samples up to 2^i - 1; the last is unbounded */
+  buckets: number[];
+}
+
+/** Decoded METRICS payload */
+export interface MetricsSnapshot {
+  uptimeMs: number;
+  counters: Record<string, number>;
+  gauges: Record<string, number>;
+  histograms: Record<string, MetricHistogram>;
+}
+
+/** Decode the payload of a METRICS binary message */
+export function decodeMetricsPayload(payload: Uint8Array): MetricsSnapshot {
+  const view = new DataView(payload.buffer, payload.byteOffset, payload.byteLength);
+  if (payload.length < 6 || payload[0] !== METRICS_FORMAT_VERSION) {
+    throw new Error("Unsupported metrics payload");
+  }
+
+  const count = payload[1];
+  let pos = 6;
+  const varint = (): number => {
+    let value = 0;
+    let shift = 0;
+    let byte: number;
+    do {
+      if (pos >= payload.length) throw new Error("Truncated metrics payload");
+      byte = payload[pos++];
+      value += (byte & 0x7f) * 2 ** shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return value;
+  };
+
+  const snapshot: MetricsSnapshot = {
+    uptimeMs: view.getUint32(2, true),
+    counters: {},
+    gauges: {},
+    histograms: {},
+  };
+
+  // Metrics newer than this definition list cannot be sized; stop there
+  for (let i = 0; i < Math.min(count, METRIC_DEFINITIONS.length); i++) {
+    const { name, kind } = METRIC_DEFINITIONS[i];
+    if (kind === "counter") {
+      snapshot.counters[name] = varint();
+    } else if (kind === "gauge") {
+      snapshot.gauges[name] = view.getFloat32(pos, true);
+      pos += 4;
+    } else {
+      const histogram: MetricHistogram = { count: varint(), sum: varint(), buckets: [] };
+      for (let b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        histogram.buckets.push(varint());
+      }
+      snapshot.histograms[name] = histogram;
+    }
+  }
+
+  return snapshot;
+}
+
 // ============================================================================
 // STATE SUBSCRIPTION
 // ============================================================================
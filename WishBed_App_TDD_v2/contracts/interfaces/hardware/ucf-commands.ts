@@ -253,6 +253,31 @@ export interface DisplayPatternCommand extends UCFCommand<"DISPLAY_PATTERN"> {
   };
 }
 
+/** Get per-module timing (firmware profiler, absent in production builds) */
+export interface GetProfileCommand extends UCFCommand<"GET_PROFILE"> {
+  category: "DEBUG";
+  payload?: {
+    /** Start a new measurement window after reading */
+    reset?: boolean;
+  };
+}
+
+/** Timing of one firmware module (nanoseconds) */
+export interface ProfileProbe {
+  name: string;
+  count: number;
+  minNs: number;
+  meanNs: number;
+  p50Ns: number;
+  p99Ns: number;
+  maxNs: number;
+}
+
+/** GET_PROFILE response data */
+export interface GetProfileResponseData {
+  probes: ProfileProbe[];
+}
+
 // ============================================================================
 // COMMAND UNION
 // ============================================================================
@@ -289,7 +314,8 @@ export type AnyUCFCommand =
   | ReadSigilCommand
   | ListSigilsCommand
   | GetSensorCommand
-  | DisplayPatternCommand;
+  | DisplayPatternCommand
+  | GetProfileCommand;
 
 // ============================================================================
 // COMMAND RESPONSE
@@ -338,6 +338,7 @@ namespace Timing {
     constexpr uint32_t SENSOR_POLL_INTERVAL = 10;      // 100 Hz
     constexpr uint32_t PHASE_UPDATE_INTERVAL = 50;     // 20 Hz
     constexpr uint32_t KURAMOTO_STEP_INTERVAL = 1;     // 1000 Hz
+    constexpr uint8_t KURAMOTO_MAX_CATCHUP = 4;        // Steps one late run may replay
     constexpr uint32_t EMANATION_UPDATE_INTERVAL = 100; // 10 Hz
     constexpr uint32_t COHERENCE_WINDOW_MS = 1000;     // 1 second history
 }
@@ -281,14 +281,16 @@ private:
 
     /**
      * @brief Update breath phase
+     * @param now Clock time
      */
-    void updateBreathPhase();
+    void updateBreathPhase(uint32_t now);
 
     /**
      * @brief Compute modulation for breath sync
+     * @param now Clock time
      * @return Modulation factor [0, 1]
      */
-    float getBreathModulation();
+    float getBreathModulation(uint32_t now);
 
     /**
      * @brief Set LED pixel color
@@ -299,10 +301,18 @@ private:
      */
     void setPixel(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
 
+    /**
+     * @brief Advance the animation and show the strip
+     * @param now Clock time
+     */
+    void updateLeds(uint32_t now);
+
     /**
      * @brief Apply pattern to LED strip
+     * @param now Clock time
      */
-    void applyLedPattern();
+    void applyLedPattern(uint32_t now);
+
 
     /**
      * @brief Generate interference pattern for LEDs
@@ -65,12 +65,38 @@ public:
      */
     void calibrate(uint16_t samples = 100);
 
+    /**
+     * @brief Install baselines (warm start or background calibration)
+     * @param baselines HEX_SENSOR_COUNT baseline values
+     */
+    void setBaselines(const uint16_t* baselines);
+
+    /**
+     * @brief Copy current baselines
+     * @param baselines Output, HEX_SENSOR_COUNT values
+     * @return true if calibrated
+     */
+    bool getBaselines(uint16_t* baselines) const;
+
+    /**
+     * @brief Copy raw readings from the last readField()
+     * @param raw Output, HEX_SENSOR_COUNT values
+     */
+    void getRaw(uint16_t* raw) const;
+
     /**
      * @brief Read all sensors and compute field state
      * @return Current field state
      */
     HexFieldState readField();
 
+    /**
+     * @brief Compute field state from readings taken elsewhere
+     * @param raw HEX_SENSOR_COUNT raw values (same order as getRaw())
+     * @return Current field state
+     */
+    HexFieldState readField(const uint16_t* raw);
+
     /**
      * @brief Get raw reading for specific sensor
      * @param index Sensor index (0-18)
@@ -162,6 +188,11 @@ private:
      */
     void readMPR121(uint16_t* data);
 
+    /**
+     * @brief Compute field state from m_raw
+     */
+    HexFieldState computeField();
+
     /**
      * @brief Normalize raw reading
      * @param raw Raw ADC value
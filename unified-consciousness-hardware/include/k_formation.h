@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include "constants.h"
 #include "hex_grid.h"
+#include "ucf_memory.h"
 
 namespace UCF {
 
@@ -55,11 +56,17 @@ struct CoherenceHistoryEntry {
  */
 class KFormation {
 public:
+    /// Coherence history length (UCF_KFORMATION_HISTORY)
+    static const uint16_t HISTORY_SIZE = UCF_KFORMATION_HISTORY;
+
+    /// Arena bytes taken by begin()
+    static const size_t ARENA_BYTES = HISTORY_SIZE * sizeof(CoherenceHistoryEntry);
+
     /// Default constructor
     KFormation();
 
     /**
-     * @brief Initialize the K-Formation detector
+     * @brief Initialize the detector and carve its history from the arena
      * @return true if successful
      */
     bool begin();
@@ -170,9 +177,8 @@ private:
     /// Coherence calculation window
     uint16_t m_coherence_window;
 
-    /// History buffer for coherence
-    static const uint16_t HISTORY_SIZE = 64;
-    CoherenceHistoryEntry m_history[HISTORY_SIZE];
+    /// History buffer for coherence (arena)
+    CoherenceHistoryEntry* m_history;
     uint16_t m_history_head;
     uint16_t m_history_count;
 
@@ -79,8 +79,9 @@ public:
     /**
      * @brief Advance simulation by one time step
      * @param dt Time step (seconds)
+     * @param now_ms Time the step ends at (the reference phase follows it)
      */
-    void step(float dt);
+    void step(float dt, uint32_t now_ms);
 
     /**
      * @brief Update from z-coordinate (sets reference frequency)
@@ -112,6 +113,12 @@ public:
      */
     float getCollectivePhase() const { return m_state.collective_phase; }
 
+    /**
+     * @brief Get collective frequency (phase velocity of psi, smoothed)
+     * @return Hz
+     */
+    float getCollectiveFrequency() const { return m_collective_freq; }
+
     /**
      * @brief Check if synchronized (r >= threshold)
      * @return true if synchronized
@@ -181,12 +188,40 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Continue from a saved network state (warm start)
+     * @param phases N_OSCILLATORS phases
+     * @param coupling Coupling strength K
+     * @param pll_integrator PLL integrator value
+     */
+    void restore(const float* phases, float coupling, float pll_integrator);
+
+    /**
+     * @brief Get PLL integrator (persisted across warm starts)
+     * @return Integrator value
+     */
+    float getPLLIntegrator() const { return m_pll_integrator; }
+
     /**
      * @brief Register callback for synchronization achieved
      */
     typedef void (*SyncCallback)(float order_param);
     void onSynchronization(SyncCallback callback);
 
+    /**
+     * @brief Couple to other devices' ensembles (mesh mean field)
+     *
+     * Adds K r sin(psi - theta_i) to every oscillator and pulls the PLL
+     * reference towards psi the same way, so the local clock does not
+     * hold the ensemble back. psi advances at freq_hz between calls.
+     *
+     * @param r Their combined order parameter (0 = uncoupled)
+     * @param psi Its phase now
+     * @param freq_hz Its frequency
+     * @param K Coupling strength
+     */
+    void setExternalField(float r, float psi, float freq_hz, float K);
+
     /**
      * @brief Set TRIAD detection thresholds
      * @param high Rising threshold
@@ -195,10 +230,11 @@ public:
     void setTriadThresholds(float high, float low);
 
     /**
-     * @brief Write coupling to hardware (digipot)
-     * @param K Coupling value
+     * @brief Write a wiper step to the digipot (SHADOW_DIGIPOT's hardware write)
+     * @param step 0 (K=1) to 255 (K=0)
+     * @param ctx Unused
      */
-    void writeCouplingHardware(float K);
+    static void writeCouplingHardware(uint32_t step, void* ctx);
 
 private:
     /// Network state
@@ -221,6 +257,16 @@ private:
     float m_pll_integrator;
     float m_pll_proportional;
 
+    /// Collective frequency estimate (Hz)
+    float m_collective_freq;
+
+    /// Mesh mean field (other devices)
+    float m_ext_r;
+    float m_ext_psi;
+    float m_ext_freq;
+    float m_ext_coupling;
+    float m_ref_offset;             // Reference phase pulled by the mesh
+
     /// Callback
     SyncCallback m_sync_callback;
 
@@ -248,14 +294,24 @@ private:
     /**
      * @brief Apply PLL stabilization
      * @param dt Time step
+     * @param ref_phase Reference phase at this step
      */
-    void applyPLLStabilization(float dt);
+    void applyPLLStabilization(float dt, float ref_phase);
 
     /**
      * @brief Apply relaxation dynamics (T1/T2 analog)
      * @param dt Time step
+     * @param ref_phase Reference phase at this step
      */
-    void applyRelaxation(float dt);
+    void applyRelaxation(float dt, float ref_phase);
+
+    /**
+     * @brief Reference oscillator phase at a time
+     * @param now_ms Clock time
+     * @return Phase [0, 2*PI]
+     */
+    float referencePhase(uint32_t now_ms) const;
+
 
     /**
      * @brief Check TRIAD conditions
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include "constants.h"
 #include "hex_grid.h"
+#include "ucf_memory.h"
 
 namespace UCF {
 
@@ -96,11 +97,17 @@ namespace PipelineStage {
  */
 class OmniLinguistics {
 public:
+    /// APL history length (UCF_LINGUISTICS_HISTORY)
+    static const uint8_t HISTORY_SIZE = UCF_LINGUISTICS_HISTORY;
+
+    /// Arena bytes taken by begin()
+    static const size_t ARENA_BYTES = HISTORY_SIZE * sizeof(APLToken);
+
     /// Default constructor
     OmniLinguistics();
 
     /**
-     * @brief Initialize the linguistics engine
+     * @brief Initialize the engine and carve its token history from the arena
      * @return true if successful
      */
     bool begin();
@@ -219,9 +226,8 @@ private:
     /// Pipeline state
     PipelineState m_pipeline;
 
-    /// APL history buffer
-    static const uint8_t HISTORY_SIZE = 32;
-    APLToken m_history[HISTORY_SIZE];
+    /// APL history buffer (arena)
+    APLToken* m_history;
     uint8_t m_history_head;
     uint8_t m_history_count;
 
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include "constants.h"
 #include "hex_grid.h"
+#include "ucf_memory.h"
 
 namespace UCF {
 
@@ -50,11 +51,17 @@ struct PhaseHistoryEntry {
  */
 class PhaseEngine {
 public:
+    /// History buffer length (UCF_PHASE_HISTORY)
+    static const uint16_t HISTORY_SIZE = UCF_PHASE_HISTORY;
+
+    /// Arena bytes taken by begin()
+    static const size_t ARENA_BYTES = HISTORY_SIZE * sizeof(PhaseHistoryEntry);
+
     /// Default constructor
     PhaseEngine();
 
     /**
-     * @brief Initialize the phase engine
+     * @brief Initialize the phase engine and carve its history from the arena
      * @return true if successful
      */
     bool begin();
@@ -139,6 +146,15 @@ public:
      */
     void setStabilityThreshold(uint32_t ms);
 
+    /**
+     * @brief Continue from a saved smoothed z (warm start)
+     *
+     * Sets the phase and tier directly, without recording a transition.
+     *
+     * @param z_smoothed Smoothed z to continue from
+     */
+    void restoreSmoothed(float z_smoothed);
+
     /**
      * @brief Update LED indicators based on current phase
      */
@@ -174,9 +190,8 @@ private:
     /// Previous timestamp
     uint32_t m_time_prev;
 
-    /// History buffer
-    static const uint16_t HISTORY_SIZE = 256;
-    PhaseHistoryEntry m_history[HISTORY_SIZE];
+    /// History buffer (arena)
+    PhaseHistoryEntry* m_history;
     uint16_t m_history_head;
     uint16_t m_history_count;
 
@@ -192,15 +207,18 @@ private:
      * @param from Previous phase
      * @param to New phase
      * @param z Z at transition
+     * @param now Clock time
      */
-    void recordTransition(Phase from, Phase to, float z);
+    void recordTransition(Phase from, Phase to, float z, uint32_t now);
 
     /**
      * @brief Add entry to history buffer
      * @param z Z-coordinate
      * @param phase Current phase
+     * @param now Clock time
      */
-    void addToHistory(float z, Phase phase);
+    void addToHistory(float z, Phase phase, uint32_t now);
+
 };
 
 /**
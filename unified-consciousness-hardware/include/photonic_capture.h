@@ -15,6 +15,7 @@
 
 #include <stdint.h>
 #include "constants.h"
+#include "ucf_memory.h"
 
 namespace UCF {
 
@@ -58,11 +59,14 @@ struct LIMNUSPoint {
  */
 class PhotonicCapture {
 public:
+    /// Arena bytes taken by begin()
+    static const size_t ARENA_BYTES = sizeof(PhotonicPattern);
+
     /// Default constructor
     PhotonicCapture();
 
     /**
-     * @brief Initialize photonic capture system
+     * @brief Initialize photonic capture and carve its pattern buffer from the arena
      * @return true if successful
      */
     bool begin();
@@ -72,18 +76,18 @@ public:
      * @param z Z-coordinate [0, 1]
      * @param phase Phase (0=UNTRUE, 1=PARADOX, 2=TRUE)
      * @param kappa Coherence [0, 1]
-     * @return Generated pattern
+     * @return Generated pattern, valid until the next generate or decode call
      */
-    PhotonicPattern generatePattern(float z, uint8_t phase, float kappa);
+    const PhotonicPattern& generatePattern(float z, uint8_t phase, float kappa);
 
     /**
      * @brief Generate pattern from Phase enum
      * @param phase Phase enum
      * @param z Z-coordinate
      * @param kappa Coherence
-     * @return Generated pattern
+     * @return Generated pattern, valid until the next generate or decode call
      */
-    PhotonicPattern generateFromPhase(Phase phase, float z, float kappa);
+    const PhotonicPattern& generateFromPhase(Phase phase, float z, float kappa);
 
     /**
      * @brief Decode state from captured pattern
@@ -95,9 +99,10 @@ public:
     /**
      * @brief Generate LIMNUS fractal pattern
      * @param z Z-coordinate for modulation
-     * @return Pattern encoding LIMNUS structure
+     * @return Pattern encoding LIMNUS structure, valid until the next
+     *         generate or decode call
      */
-    PhotonicPattern generateLIMNUS(float z);
+    const PhotonicPattern& generateLIMNUS(float z);
 
     /**
      * @brief Get LIMNUS point coordinates
@@ -153,8 +158,8 @@ public:
     static uint8_t hexCoordToIndex(float x, float y);
 
 private:
-    /// Reference pattern for decoding
-    PhotonicPattern m_reference;
+    /// Pattern the generate calls fill (arena)
+    PhotonicPattern* m_pattern;
 
     /// Camera/sensor initialized
     bool m_sensor_ready;
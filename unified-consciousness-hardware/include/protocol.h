@@ -14,8 +14,12 @@
 #ifndef UCF_PROTOCOL_H
 #define UCF_PROTOCOL_H
 
+#include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <Arduino.h>
+#include "ucf_profiler.h"
+#include "ucf_metrics.h"
 
 namespace UCF {
 namespace Protocol {
@@ -122,13 +126,14 @@ enum class BinaryMessageType : uint8_t {
     RESPONSE = 0x02,
     STATE = 0x03,
     EVENT = 0x04,
+    METRICS = 0x05,
     PING = 0xFE,
     PONG = 0xFF
 };
 
 /// Binary message flags
 enum BinaryFlags : uint8_t {
-    NONE = 0x00,
+    NO_FLAGS = 0x00,
     COMPRESSED = 0x01,
     FRAGMENTED = 0x02,
     LAST_FRAGMENT = 0x04
@@ -149,7 +154,7 @@ struct BinaryMessageHeader {
 
     BinaryMessageHeader() : type(0), length(0), flags(0) {}
 
-    BinaryMessageHeader(BinaryMessageType t, uint16_t len, uint8_t f = BinaryFlags::NONE)
+    BinaryMessageHeader(BinaryMessageType t, uint16_t len, uint8_t f = BinaryFlags::NO_FLAGS)
         : type(static_cast<uint8_t>(t)), length(len), flags(f) {}
 
     /// Serialize to byte array
@@ -358,6 +363,9 @@ constexpr uint32_t CONNECTION_TIMEOUT = 10000; // 10 seconds
 /// Message timeout (ms)
 constexpr uint32_t MESSAGE_TIMEOUT = 10000; // 10 seconds
 
+/// Metrics snapshot interval (ms)
+constexpr uint32_t METRICS_INTERVAL = 10000; // 10 seconds
+
 // ============================================================================
 // BUFFER SIZES
 // ============================================================================
@@ -378,8 +386,13 @@ constexpr uint16_t MAX_COMMAND_PAYLOAD_SIZE = 256;
 /**
  * JSON message builder for WebSocket communication
  *
+ * Builds into a caller buffer, so sending a message never touches the
+ * heap. Text that does not fit is dropped and the message marked as
+ * overflowed; length() is then 0.
+ *
  * Usage:
- *   JsonMessageBuilder builder;
+ *   char json[256];
+ *   JsonMessageBuilder builder(json, sizeof(json));
  *   builder.beginMessage(MessageType::EVENT);
  *   builder.addTimestamp();
  *   builder.beginPayload();
@@ -387,91 +400,160 @@ constexpr uint16_t MAX_COMMAND_PAYLOAD_SIZE = 256;
  *   builder.addNumber("duration", 3200);
  *   builder.endPayload();
  *   builder.endMessage();
- *   const char* json = builder.getString();
+ *   size_t len = builder.length();
  */
 class JsonMessageBuilder {
 private:
-    String buffer;
+    char* buffer;
+    size_t capacity;
+    size_t used;
+    bool overflow;
     bool inPayload;
 
+    void append(const char* text) {
+        while (*text) {
+            if (used + 1 >= capacity) {
+                overflow = true;
+                return;
+            }
+            buffer[used++] = *text++;
+        }
+        buffer[used] = '\0';
+    }
+
+    void appendNumber(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char digits[24];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(digits, sizeof(digits), format, args);
+        va_end(args);
+        append(digits);
+    }
+
+    void addSeparator(bool comma) {
+        char last = used > 0 ? buffer[used - 1] : '\0';
+        if (comma && last != '{' && last != '[') {
+            append(",");
+        }
+    }
+
+    void addKey(const char* key) {
+        append("\"");
+        append(key);
+        append("\":");
+    }
+
 public:
-    JsonMessageBuilder() : inPayload(false) {}
+    JsonMessageBuilder(char* buffer, size_t capacity)
+        : buffer(buffer), capacity(capacity), used(0), overflow(capacity == 0), inPayload(false) {
+        if (capacity > 0) {
+            buffer[0] = '\0';
+        }
+    }
 
     void beginMessage(MessageType type) {
-        buffer = "{";
+        clear();
+        append("{");
         addString("type", messageTypeToString(type), false);
-        buffer += ",";
+        append(",");
         addString("version", PROTOCOL_VERSION, false);
-        buffer += ",";
+        append(",");
     }
 
     void addTimestamp() {
-        buffer += "\"timestamp\":";
-        buffer += String(millis());
+        append("\"timestamp\":");
+        appendNumber("%lu", (unsigned long)millis());
     }
 
     void beginPayload() {
-        buffer += ",\"payload\":{";
+        append(",\"payload\":{");
         inPayload = true;
     }
 
     void endPayload() {
-        buffer += "}";
+        append("}");
         inPayload = false;
     }
 
     void endMessage() {
-        buffer += "}";
+        append("}");
     }
 
     void addString(const char* key, const char* value, bool comma = true) {
-        if (comma && buffer.charAt(buffer.length() - 1) != '{') {
-            buffer += ",";
-        }
-        buffer += "\"";
-        buffer += key;
-        buffer += "\":\"";
-        buffer += value;
-        buffer += "\"";
+        addSeparator(comma);
+        addKey(key);
+        append("\"");
+        append(value);
+        append("\"");
     }
 
     void addNumber(const char* key, float value, bool comma = true) {
-        if (comma && buffer.charAt(buffer.length() - 1) != '{') {
-            buffer += ",";
-        }
-        buffer += "\"";
-        buffer += key;
-        buffer += "\":";
-        buffer += String(value, 6);
+        addSeparator(comma);
+        addKey(key);
+        appendNumber("%.6f", value);
     }
 
     void addNumber(const char* key, int value, bool comma = true) {
-        if (comma && buffer.charAt(buffer.length() - 1) != '{') {
-            buffer += ",";
-        }
-        buffer += "\"";
-        buffer += key;
-        buffer += "\":";
-        buffer += String(value);
+        addSeparator(comma);
+        addKey(key);
+        appendNumber("%d", value);
+    }
+
+    void addNumber(const char* key, uint32_t value, bool comma = true) {
+        addSeparator(comma);
+        addKey(key);
+        appendNumber("%lu", (unsigned long)value);
     }
 
     void addBoolean(const char* key, bool value, bool comma = true) {
-        if (comma && buffer.charAt(buffer.length() - 1) != '{') {
-            buffer += ",";
+        addSeparator(comma);
+        addKey(key);
+        append(value ? "true" : "false");
+    }
+
+    /// Open a nested object (pass no key inside an array)
+    void beginObject(const char* key = nullptr, bool comma = true) {
+        addSeparator(comma);
+        if (key) {
+            addKey(key);
         }
-        buffer += "\"";
-        buffer += key;
-        buffer += "\":";
-        buffer += value ? "true" : "false";
+        append("{");
+    }
+
+    void endObject() {
+        append("}");
+    }
+
+    void beginArray(const char* key, bool comma = true) {
+        addSeparator(comma);
+        addKey(key);
+        append("[");
+    }
+
+    void endArray() {
+        append("]");
     }
 
     const char* getString() const {
-        return buffer.c_str();
+        return buffer;
+    }
+
+    /// Message length, 0 if it did not fit
+    size_t length() const {
+        return overflow ? 0 : used;
+    }
+
+    bool overflowed() const {
+        return overflow;
     }
 
     void clear() {
-        buffer = "";
+        used = 0;
+        overflow = capacity == 0;
         inPayload = false;
+        if (capacity > 0) {
+            buffer[0] = '\0';
+        }
     }
 };
 
@@ -480,38 +562,42 @@ public:
 // ============================================================================
 
 /**
- * Send PING message
+ * Build PING message
+ * @return Message length, 0 if the buffer is too small
  */
-inline String createPingMessage(uint32_t seq) {
-    JsonMessageBuilder builder;
+inline size_t createPingMessage(char* buffer, size_t capacity, uint32_t seq) {
+    JsonMessageBuilder builder(buffer, capacity);
     builder.beginMessage(MessageType::PING);
     builder.addTimestamp();
     builder.beginPayload();
     builder.addNumber("seq", seq, false);
     builder.endPayload();
     builder.endMessage();
-    return String(builder.getString());
+    return builder.length();
 }
 
 /**
- * Send PONG response
+ * Build PONG response
+ * @return Message length, 0 if the buffer is too small
  */
-inline String createPongMessage(uint32_t seq) {
-    JsonMessageBuilder builder;
+inline size_t createPongMessage(char* buffer, size_t capacity, uint32_t seq) {
+    JsonMessageBuilder builder(buffer, capacity);
     builder.beginMessage(MessageType::PONG);
     builder.addTimestamp();
     builder.beginPayload();
     builder.addNumber("seq", seq, false);
     builder.endPayload();
     builder.endMessage();
-    return String(builder.getString());
+    return builder.length();
 }
 
 /**
- * Send ERROR message
+ * Build ERROR message
+ * @return Message length, 0 if the buffer is too small
  */
-inline String createErrorMessage(const char* code, const char* message) {
-    JsonMessageBuilder builder;
+inline size_t createErrorMessage(char* buffer, size_t capacity, const char* code,
+                                 const char* message) {
+    JsonMessageBuilder builder(buffer, capacity);
     builder.beginMessage(MessageType::ERROR);
     builder.addTimestamp();
     builder.beginPayload();
@@ -519,7 +605,81 @@ inline String createErrorMessage(const char* code, const char* message) {
     builder.addString("message", message);
     builder.endPayload();
     builder.endMessage();
-    return String(builder.getString());
+    return builder.length();
+}
+
+// ============================================================================
+// PROFILE
+// ============================================================================
+
+/// Buffer that holds a GET_PROFILE response with every probe (bytes)
+constexpr size_t MAX_PROFILE_RESPONSE_SIZE = 192 + PROF_PROBE_COUNT * 160;
+
+/**
+ * Build GET_PROFILE response (per-probe timing in nanoseconds)
+ *
+ * Probes without samples are omitted; in builds without UCF_PROFILE the
+ * probe list is empty.
+ *
+ * @param buffer Output, MAX_PROFILE_RESPONSE_SIZE bytes holds any response
+ * @return Message length, 0 if the buffer is too small
+ */
+inline size_t createProfileResponse(char* buffer, size_t capacity, const char* requestId) {
+    JsonMessageBuilder builder(buffer, capacity);
+    builder.beginMessage(MessageType::COMMAND_RESPONSE);
+    builder.addTimestamp();
+    builder.beginPayload();
+    if (requestId) {
+        builder.addString("requestId", requestId, false);
+    }
+    builder.addString("command", "GET_PROFILE");
+    builder.addString("status", commandStatusToString(CommandStatus::OK));
+    builder.beginObject("data");
+    builder.beginArray("probes", false);
+    for (int p = 0; p < PROF_PROBE_COUNT; p++) {
+        ProfSummary summary;
+        if (!prof_get((ProfProbe)p, &summary)) {
+            continue;
+        }
+        builder.beginObject();
+        builder.addString("name", prof_probe_name((ProfProbe)p), false);
+        builder.addNumber("count", summary.count);
+        builder.addNumber("minNs", summary.min_ns);
+        builder.addNumber("meanNs", summary.mean_ns);
+        builder.addNumber("p50Ns", summary.p50_ns);
+        builder.addNumber("p99Ns", summary.p99_ns);
+        builder.addNumber("maxNs", summary.max_ns);
+        builder.endObject();
+    }
+    builder.endArray();
+    builder.endObject();
+    builder.endPayload();
+    builder.endMessage();
+    return builder.length();
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+/**
+ * Encode a binary METRICS message (header + metrics_encode() payload)
+ *
+ * @param buffer Output, at least 4 + METRICS_MAX_ENCODED bytes
+ * @param capacity Output size
+ * @return Message length, 0 if the buffer is too small
+ */
+inline size_t createMetricsMessage(uint8_t* buffer, size_t capacity) {
+    if (capacity <= sizeof(BinaryMessageHeader)) {
+        return 0;
+    }
+    size_t len = metrics_encode(buffer + sizeof(BinaryMessageHeader),
+                                capacity - sizeof(BinaryMessageHeader), millis());
+    if (len == 0) {
+        return 0;
+    }
+    BinaryMessageHeader(BinaryMessageType::METRICS, (uint16_t)len).serialize(buffer);
+    return sizeof(BinaryMessageHeader) + len;
 }
 
 } // namespace Protocol
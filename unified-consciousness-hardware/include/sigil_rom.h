@@ -2,7 +2,8 @@
  * @file sigil_rom.h
  * @brief Neural Sigil ROM Module
  *
- * Manages 121 neural sigils stored in EEPROM.
+ * Manages 121 neural sigils stored in the sigil region of the
+ * persistent storage manager (ucf_storage.h).
  * Each sigil has a 5-character ternary code, frequency,
  * and breath pattern for emanation.
  *
@@ -60,7 +61,7 @@ namespace SigilFlags {
 
 /**
  * @class SigilROM
- * @brief Manages neural sigil database in EEPROM
+ * @brief Manages neural sigil database in persistent storage
  */
 class SigilROM {
 public:
@@ -68,19 +69,19 @@ public:
     SigilROM();
 
     /**
-     * @brief Initialize EEPROM and load sigil data
+     * @brief Mount storage and load sigil data
      * @return true if successful
      */
     bool begin();
 
     /**
-     * @brief Check if EEPROM contains valid sigil data
+     * @brief Check if storage contains valid sigil data
      * @return true if valid data present
      */
     bool isInitialized();
 
     /**
-     * @brief Initialize EEPROM with default sigil patterns
+     * @brief Write default sigil patterns (committed lazily)
      * @return true if successful
      */
     bool initializeDefaults();
@@ -178,59 +179,28 @@ public:
     void debugPrintSigil(const NeuralSigil& sigil);
 
 private:
-    /// EEPROM base address
-    static const uint16_t EEPROM_BASE = 0x0000;
+    /// Storage layout version of the sigil table
+    static const uint16_t STORAGE_VERSION = 1;
 
-    /// Magic number for validation
-    static const uint32_t MAGIC_NUMBER = 0x5347494C;  // "SGIL"
-
-    /// Header structure
-    struct EEPROMHeader {
-        uint32_t magic;
-        uint8_t version;
-        uint8_t sigil_count;
-        uint16_t checksum;
-    };
+    /// Older firmware's EEPROM table: magic(4) version(1) count(1) checksum(2), then sigils
+    static const uint32_t LEGACY_MAGIC = 0x5347494C;  // "SGIL"
+    static const uint16_t LEGACY_HEADER_SIZE = 8;
 
     /// Initialized flag
     bool m_initialized;
 
-    /// Cached sigils (optional, for speed)
-    NeuralSigil m_cache[SIGIL_COUNT];
-    bool m_cache_valid;
-
-    /**
-     * @brief Read header from EEPROM
-     * @param header Output header
-     * @return true if valid
-     */
-    bool readHeader(EEPROMHeader& header);
-
-    /**
-     * @brief Write header to EEPROM
-     * @param header Header to write
-     */
-    void writeHeader(const EEPROMHeader& header);
-
-    /**
-     * @brief Compute checksum of sigil data
-     * @return 16-bit checksum
-     */
-    uint16_t computeChecksum();
-
-    /**
-     * @brief Get EEPROM address for sigil index
-     * @param index Sigil index
-     * @return EEPROM byte address
-     */
-    uint16_t sigilAddress(uint8_t index);
-
     /**
      * @brief Generate default sigil for index
      * @param index Sigil index
      * @param sigil Output sigil
      */
     void generateDefaultSigil(uint8_t index, NeuralSigil& sigil);
+
+    /**
+     * @brief Import the table older firmware kept at fixed EEPROM addresses
+     * @return true if a table with a matching checksum was imported
+     */
+    bool importLegacy();
 };
 
 /**
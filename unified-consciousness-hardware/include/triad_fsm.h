@@ -194,16 +194,18 @@ private:
     /**
      * @brief Check for rising edge
      * @param value Current value
+     * @param now Clock time
      * @return true if rising edge detected
      */
-    bool detectRisingEdge(float value);
+    bool detectRisingEdge(float value, uint32_t now);
 
     /**
      * @brief Check for falling edge
      * @param value Current value
+     * @param now Clock time
      * @return true if falling edge detected
      */
-    bool detectFallingEdge(float value);
+    bool detectFallingEdge(float value, uint32_t now);
 
     /**
      * @brief Handle sequence timeout
@@ -214,6 +216,7 @@ private:
      * @brief Handle lockout expiry
      */
     void handleLockoutEnd();
+
 };
 
 /**
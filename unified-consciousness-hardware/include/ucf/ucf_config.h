@@ -11,6 +11,8 @@
 #ifndef UCF_CONFIG_H
 #define UCF_CONFIG_H
 
+#include "ucf_log.h"
+
 // ============================================================================
 // BUILD MODE CONFIGURATION
 // ============================================================================
@@ -89,6 +91,16 @@
 #define BLE_ENABLED 0
 #endif
 
+// Couple Kuramoto ensembles of nearby devices over ESP-NOW (ucf_mesh.h)
+#ifndef MESH_ENABLED
+#define MESH_ENABLED 1
+#endif
+
+// Strength of the other devices' mean field, in the units of the local coupling
+#ifndef MESH_COUPLING
+#define MESH_COUPLING 0.5f
+#endif
+
 // ============================================================================
 // LATTICE CONFIGURATION
 // ============================================================================
@@ -153,23 +165,13 @@
 // LOGGING MACROS
 // ============================================================================
 
-#if UCF_VERBOSE_LOGGING
-    #define UCF_LOG(fmt, ...) Serial.printf("[UCF] " fmt "\n", ##__VA_ARGS__)
-    #define UCF_LOG_LATTICE(fmt, ...) Serial.printf("[LAT] " fmt "\n", ##__VA_ARGS__)
-    #define UCF_LOG_KURAMOTO(fmt, ...) Serial.printf("[KUR] " fmt "\n", ##__VA_ARGS__)
-    #define UCF_LOG_TRIAD(fmt, ...) Serial.printf("[TRI] " fmt "\n", ##__VA_ARGS__)
-#else
-    #define UCF_LOG(fmt, ...)
-    #define UCF_LOG_LATTICE(fmt, ...)
-    #define UCF_LOG_KURAMOTO(fmt, ...)
-    #define UCF_LOG_TRIAD(fmt, ...)
-#endif
-
-#if DEBUG_MODE
-    #define UCF_DEBUG(fmt, ...) Serial.printf("[DBG] " fmt "\n", ##__VA_ARGS__)
-#else
-    #define UCF_DEBUG(fmt, ...)
-#endif
+// Deferred (ucf_log.h): a few stores per call, formatted by the log task.
+// UCF_VERBOSE_LOGGING and DEBUG_MODE raise the default UCF_LOG_LEVEL.
+#define UCF_LOG(fmt, ...) UCF_LOGV(LOG_CAT_UCF, fmt, ##__VA_ARGS__)
+#define UCF_LOG_LATTICE(fmt, ...) UCF_LOGV(LOG_CAT_LATTICE, fmt, ##__VA_ARGS__)
+#define UCF_LOG_KURAMOTO(fmt, ...) UCF_LOGV(LOG_CAT_KURAMOTO, fmt, ##__VA_ARGS__)
+#define UCF_LOG_TRIAD(fmt, ...) UCF_LOGV(LOG_CAT_TRIAD, fmt, ##__VA_ARGS__)
+#define UCF_DEBUG(fmt, ...) UCF_LOGD(LOG_CAT_DEBUG, fmt, ##__VA_ARGS__)
 
 // ============================================================================
 // ASSERT MACROS
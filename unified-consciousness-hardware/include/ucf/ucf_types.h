@@ -105,17 +105,6 @@ typedef struct {
     uint8_t current_tier;
 } AudioState;
 
-// ============================================================================
-// MAGNETOMETER STATE
-// ============================================================================
-
-typedef struct {
-    int16_t raw[3];              // Raw x, y, z
-    float heading;               // Compass heading in degrees
-    float theta;                 // UCF theta coordinate (0 to 2π)
-    bool calibrated;
-} MagnetometerState;
-
 // ============================================================================
 // SYSTEM STATUS
 // ============================================================================
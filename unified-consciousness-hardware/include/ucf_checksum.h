@@ -0,0 +1,104 @@
+/**
+ * @file ucf_checksum.h
+ * @brief UCF Shared Checksum Engine v4.0.0
+ *
+ * One CRC implementation for every integrity check (calibration records,
+ * storage records, OTA images, trace files):
+ *
+ * - CRC-32 (IEEE 802.3, reflected 0xEDB88320): ESP32 ROM routine on the
+ *   device, slicing-by-8 tables elsewhere
+ * - CRC-32C (Castagnoli, reflected 0x82F63B78): SSE4.2 crc32 instruction on
+ *   x86 hosts that have it, slicing-by-8 tables elsewhere
+ *
+ * All update functions use zlib conventions: start from 0 and pass the
+ * previous result back in, so checksumming in chunks gives the same value
+ * as one call over the whole buffer.
+ *
+ * Define UCF_CHECKSUM_PORTABLE to force the table implementations.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_CHECKSUM_H
+#define UCF_CHECKSUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// CHECKSUM CONSTANTS
+// ============================================================================
+
+#define CHECKSUM_CRC32_POLY     0xEDB88320  // Reflected IEEE polynomial
+#define CHECKSUM_CRC32C_POLY    0x82F63B78  // Reflected Castagnoli polynomial
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Continue a CRC-32 over more data
+ * @param crc Previous result (0 to start)
+ * @param data Bytes to add
+ * @param len Byte count
+ * @return CRC-32 of everything so far
+ */
+uint32_t checksum_crc32_update(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief CRC-32 of a buffer
+ * @param data Buffer
+ * @param len Byte count
+ * @return CRC-32 (0xCBF43926 for "123456789")
+ */
+uint32_t checksum_crc32(const void* data, size_t len);
+
+/**
+ * @brief Continue a CRC-32C over more data
+ * @param crc Previous result (0 to start)
+ * @param data Bytes to add
+ * @param len Byte count
+ * @return CRC-32C of everything so far
+ */
+uint32_t checksum_crc32c_update(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief CRC-32C of a buffer
+ * @param data Buffer
+ * @param len Byte count
+ * @return CRC-32C (0xE3069283 for "123456789")
+ */
+uint32_t checksum_crc32c(const void* data, size_t len);
+
+/**
+ * @brief Table-driven CRC-32, bypassing ROM routines (tests, benchmarks)
+ */
+uint32_t checksum_crc32_sw_update(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief Table-driven CRC-32C, bypassing CPU instructions (tests, benchmarks)
+ */
+uint32_t checksum_crc32c_sw_update(uint32_t crc, const void* data, size_t len);
+
+/**
+ * @brief Name of the CRC-32 implementation in use
+ * @return "esp32-rom" or "slice8"
+ */
+const char* checksum_crc32_impl(void);
+
+/**
+ * @brief Name of the CRC-32C implementation in use
+ * @return "sse4.2" or "slice8"
+ */
+const char* checksum_crc32c_impl(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_CHECKSUM_H
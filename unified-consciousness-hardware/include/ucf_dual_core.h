@@ -0,0 +1,298 @@
+/**
+ * @file ucf_dual_core.h
+ * @brief UCF Dual-Core Partition v4.0.0
+ *
+ * Splits the loop tasks over the two ESP32 cores:
+ *
+ * - Real-time core (CORE_RT, APP CPU): acquisition, Kuramoto, audio
+ * - I/O core (CORE_IO, PRO CPU, shared with WiFi): console and protocol,
+ *   OTA, storage, session log, LED transmit
+ *
+ * Each core runs its own Scheduler (ucf_scheduler.h). The cores share no
+ * mutable state except through the two primitives below, which are
+ * lock-free and never block either side:
+ *
+ * - CoreQueue: single-producer/single-consumer ring of fixed-size items
+ *   (events, session frames, commands). A full queue refuses the item
+ *   and counts it; the producer never waits.
+ * - CoreSnapshot: triple buffer holding the latest copy of a state
+ *   struct. The writer publishes whole structs, the reader always gets
+ *   the newest complete one, and neither side ever copies under the
+ *   other's feet.
+ *
+ * Backends: FreeRTOS tasks pinned to the two cores (ucf_dual_core_esp32.cpp)
+ * and std::threads on the host (ucf_dual_core_thread.cpp), so the same
+ * partition runs under ThreadSanitizer:
+ *
+ *   g++ -std=c++17 -O1 -g -fsanitize=thread -DUNIT_TEST=1 -I/path/to/unity \
+ *       -Iinclude -Iinclude/ucf test/test_dual_core.cpp src/ucf_dual_core.cpp \
+ *       src/ucf_dual_core_thread.cpp src/ucf_scheduler.cpp -o test_dual_core
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_DUAL_CORE_H
+#define UCF_DUAL_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PARTITION CONSTANTS
+// ============================================================================
+
+#define CORE_COUNT                  2
+#define CORE_RT_CPU                 1       // APP CPU (Arduino loop core)
+#define CORE_IO_CPU                 0       // PRO CPU (WiFi, lwIP, OTA task)
+#define CORE_RT_PRIORITY            5       // Above loopTask (1)
+#define CORE_IO_PRIORITY            2       // Below WiFi/lwIP, above OTA (1)
+#define CORE_TASK_STACK             8192
+#define CORE_MAX_SLEEP_US           10000   // Bounds stop latency on the host
+
+#define CORE_SNAPSHOT_BUFFERS       3
+#define CORE_SNAPSHOT_FRESH         0x80    // Flag in CoreSnapshot.spare
+
+/**
+ * @brief Partition side
+ */
+typedef enum {
+    CORE_RT = 0,                    // Real-time: sensing, Kuramoto, audio
+    CORE_IO = 1                     // I/O: protocol, OTA, logging, LEDs
+} CoreRole;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Lock-free single-producer/single-consumer queue
+ *
+ * head is written only by the producer, tail only by the consumer.
+ */
+typedef struct {
+    uint8_t* buffer;                // capacity * item_size bytes
+    uint16_t item_size;
+    uint16_t capacity;              // Power of two
+    uint32_t head;                  // Items pushed (producer)
+    uint32_t tail;                  // Items popped (consumer)
+    uint32_t dropped;               // Pushes refused while full (producer)
+} CoreQueue;
+
+/**
+ * @brief Latest-value triple buffer (one writer, one reader)
+ */
+typedef struct {
+    uint8_t* buffer;                // CORE_SNAPSHOT_BUFFERS * size bytes
+    uint16_t size;
+    uint8_t write_index;            // Writer-owned buffer
+    uint8_t read_index;             // Reader-owned buffer
+    uint8_t spare;                  // Exchanged; CORE_SNAPSHOT_FRESH if unread
+    uint32_t published;             // Publish count (writer)
+} CoreSnapshot;
+
+/**
+ * @brief Per-core statistics (updated atomically by the core's worker)
+ */
+typedef struct {
+    uint32_t passes;                // sched_run() calls that ran a task
+    uint32_t runs;                  // Task runs
+    uint32_t idle_passes;           // Passes that left nothing due
+} CoreStats;
+
+/**
+ * @brief Spend a side's gap between passes (e.g. idle_run())
+ * @param idle_us Microseconds until the side has work again
+ * @param ctx Context from core_partition_set_idle()
+ * @return true if the gap was spent, false to let the worker wait its own way
+ */
+typedef bool (*CoreIdleFn)(uint32_t idle_us, void* ctx);
+
+/**
+ * @brief Two schedulers and their worker state
+ */
+typedef struct {
+    Scheduler* sched[CORE_COUNT];
+    CoreStats stats[CORE_COUNT];    // Read with core_partition_get_stats()
+    CoreIdleFn idle[CORE_COUNT];    // NULL: the worker's own wait
+    void* idle_ctx[CORE_COUNT];
+    uint8_t running;                // Cleared to stop the workers
+} CorePartition;
+
+// ============================================================================
+// QUEUE API
+// ============================================================================
+
+/**
+ * @brief Initialize an empty queue over caller storage
+ * @param q Queue state
+ * @param buffer capacity * item_size bytes
+ * @param item_size Bytes per item
+ * @param capacity Items (power of two)
+ * @return false if capacity is not a power of two
+ */
+bool core_queue_init(CoreQueue* q, void* buffer, uint16_t item_size, uint16_t capacity);
+
+/**
+ * @brief Append an item (producer only, never blocks)
+ * @param q Queue state
+ * @param item item_size bytes
+ * @return false if the queue is full (the item is counted as dropped)
+ */
+bool core_queue_push(CoreQueue* q, const void* item);
+
+/**
+ * @brief Remove the oldest item (consumer only, never blocks)
+ * @param q Queue state
+ * @param item Output, item_size bytes
+ * @return false if the queue is empty
+ */
+bool core_queue_pop(CoreQueue* q, void* item);
+
+/**
+ * @brief Get the number of queued items (approximate from the other side)
+ */
+uint16_t core_queue_count(const CoreQueue* q);
+
+/**
+ * @brief Get the number of refused pushes (producer side)
+ */
+uint32_t core_queue_dropped(const CoreQueue* q);
+
+// ============================================================================
+// SNAPSHOT API
+// ============================================================================
+
+/**
+ * @brief Initialize a snapshot over caller storage (all buffers zeroed)
+ * @param s Snapshot state
+ * @param buffer CORE_SNAPSHOT_BUFFERS * size bytes
+ * @param size Bytes per copy
+ */
+void core_snapshot_init(CoreSnapshot* s, void* buffer, uint16_t size);
+
+/**
+ * @brief Get the writer's buffer to fill (writer only)
+ */
+void* core_snapshot_begin(CoreSnapshot* s);
+
+/**
+ * @brief Publish the buffer returned by core_snapshot_begin() (writer only)
+ */
+void core_snapshot_publish(CoreSnapshot* s);
+
+/**
+ * @brief Copy and publish a whole struct (writer only)
+ */
+void core_snapshot_write(CoreSnapshot* s, const void* data);
+
+/**
+ * @brief Get the newest published copy (reader only)
+ *
+ * The pointer stays valid and unchanged until the reader's next call.
+ *
+ * @param s Snapshot state
+ * @param fresh Output: true if published since the last call (may be NULL)
+ * @return size bytes (all zero before the first publish)
+ */
+const void* core_snapshot_read(CoreSnapshot* s, bool* fresh);
+
+// ============================================================================
+// PARTITION API
+// ============================================================================
+
+/**
+ * @brief Bind the two schedulers
+ * @param p Partition state
+ * @param rt Real-time core tasks
+ * @param io I/O core tasks
+ */
+void core_partition_init(CorePartition* p, Scheduler* rt, Scheduler* io);
+
+/**
+ * @brief Run one scheduler pass for one side (called by its worker)
+ * @param p Partition state
+ * @param role Side to run
+ * @return Microseconds until that side has work again
+ */
+uint32_t core_partition_pass(CorePartition* p, CoreRole role);
+
+/**
+ * @brief Hand a side's gaps to an idle function (before the workers start)
+ * @param p Partition state
+ * @param role Side
+ * @param fn Idle function (NULL = the worker's own wait)
+ * @param ctx Passed to fn
+ */
+void core_partition_set_idle(CorePartition* p, CoreRole role, CoreIdleFn fn, void* ctx);
+
+/**
+ * @brief Spend a gap with the side's idle function (called by its worker)
+ * @param p Partition state
+ * @param role Side
+ * @param idle_us Result of core_partition_pass()
+ * @return false if there is no idle function or it left the gap to the worker
+ */
+bool core_partition_idle(CorePartition* p, CoreRole role, uint32_t idle_us);
+
+/**
+ * @brief Read a side's statistics (safe from either core)
+ * @param p Partition state
+ * @param role Side
+ * @param stats Output statistics
+ */
+void core_partition_get_stats(const CorePartition* p, CoreRole role, CoreStats* stats);
+
+/**
+ * @brief Check whether the workers should keep running
+ */
+bool core_partition_running(const CorePartition* p);
+
+/**
+ * @brief Get a side's name
+ */
+const char* core_role_string(CoreRole role);
+
+/**
+ * @brief Start both sides on FreeRTOS tasks pinned to their cores
+ *
+ * After this call loop() has nothing left to do. On failure neither task
+ * is left running, so the caller may run both schedulers itself.
+ *
+ * @param p Partition state (must stay valid while running)
+ * @return true if both tasks are running
+ */
+bool core_partition_start(CorePartition* p);
+
+// ============================================================================
+// THREAD BACKEND (ucf_dual_core_thread.cpp, host only)
+// ============================================================================
+
+/**
+ * @brief Start both sides on std::threads
+ * @param p Partition state (must stay valid while running)
+ * @return true if both threads are running
+ */
+bool core_partition_start_threads(CorePartition* p);
+
+/**
+ * @brief Stop and join the threads started by core_partition_start_threads()
+ * @param p Partition state
+ */
+void core_partition_stop_threads(CorePartition* p);
+
+/**
+ * @brief Monotonic microsecond clock for schedulers run on threads
+ */
+uint32_t core_thread_clock_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_DUAL_CORE_H
@@ -0,0 +1,110 @@
+/**
+ * @file ucf_heap.h
+ * @brief UCF Heap Monitor v4.0.0
+ *
+ * The firmware allocates only while it starts: module buffers come from
+ * the arena (ucf_memory.h), messages are built into caller buffers and
+ * nothing on the loop or task paths uses String or new. Once start-up is
+ * done the firmware calls heap_mark_steady(), and from then on the heap
+ * should stay flat for as long as the device runs.
+ *
+ * Backends:
+ * - Device (ucf_heap_esp32.cpp): heap_caps free, minimum free and largest
+ *   block for the internal 8-bit heap. Allocations are not counted; a
+ *   falling heap_free gauge is what shows a leak or fragmentation.
+ * - Host (ucf_heap_host.cpp): malloc, calloc, realloc and the aligned
+ *   allocators are interposed (operator new and std::string allocate
+ *   through them), so every allocation is counted. After heap_mark_steady() each one is a
+ *   steady-state allocation, and the first few call stacks are kept for
+ *   the report. Not available under ASan or TSan, which own malloc.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_HEAP_H
+#define UCF_HEAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// HEAP CONSTANTS
+// ============================================================================
+
+#define HEAP_MAX_SITES              4       // Steady-state call stacks kept (host)
+#define HEAP_SITE_DEPTH             8       // Frames per call stack
+#define HEAP_LINE_MAX               96
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Heap totals
+ */
+typedef struct {
+    bool counted;                   // Allocations are counted (host builds)
+    bool steady;                    // heap_mark_steady() was called
+    uint32_t allocs;                // Allocations since boot (counted builds)
+    uint32_t steady_allocs;         // Allocations since heap_mark_steady()
+    uint32_t steady_bytes;
+    uint32_t free_bytes;            // Device heap (0 on the host)
+    uint32_t min_free_bytes;        // Lowest free_bytes since boot
+    uint32_t largest_block;         // Largest allocatable block
+    uint32_t steady_free_bytes;     // free_bytes at heap_mark_steady()
+} HeapStats;
+
+/**
+ * @brief Call stack of a steady-state allocation (host)
+ */
+typedef struct {
+    uint32_t bytes;
+    uint8_t depth;
+    void* frames[HEAP_SITE_DEPTH];
+} HeapSite;
+
+/**
+ * @brief Text export sink (one line, no newline)
+ */
+typedef void (*HeapLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// HEAP API
+// ============================================================================
+
+/**
+ * @brief Start-up is over: count every allocation from here on
+ */
+void heap_mark_steady(void);
+
+/**
+ * @brief Forget the steady-state allocations and start counting again
+ */
+void heap_reset_steady(void);
+
+/**
+ * @brief Get heap totals
+ */
+void heap_get_stats(HeapStats* stats);
+
+/**
+ * @brief Copy the first steady-state call stacks (host builds)
+ * @return Sites copied
+ */
+size_t heap_sites(HeapSite* sites, size_t max);
+
+/**
+ * @brief Write the totals as text
+ */
+void heap_write_text(HeapLineFn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_HEAP_H
@@ -0,0 +1,406 @@
+/**
+ * @file ucf_i2c_bus.h
+ * @brief UCF I2C Bus Manager v4.0.0
+ *
+ * Owns the shared 400 kHz sensor bus (MPR121 A/B, HMC5883L). Drivers
+ * submit transfers instead of calling Wire; a worker runs them and hands
+ * the results back, so sensor reads no longer block the compute tasks.
+ *
+ * - Order: highest priority first, then earliest deadline, then FIFO.
+ *   A transfer whose deadline has passed before it starts completes with
+ *   I2C_EXPIRED and costs no bus time.
+ * - Batching: register reads on one auto-incrementing device whose ranges
+ *   touch are merged into a single burst (up to I2C_BUS_MAX_BATCH bytes)
+ *   and split again on completion. The 19 per-electrode reads of a sensor
+ *   frame become two bursts.
+ * - Tracing: per-device counts, bytes, errors and worst transfer time,
+ *   bus utilization, and a ring of the last I2C_BUS_TRACE_SIZE
+ *   transactions.
+ *
+ * Threading: one client context submits and dispatches, one worker
+ * context services. They share only two CoreQueues (ucf_dual_core.h).
+ * Completion callbacks run in the client's i2c_bus_dispatch(), never on
+ * the worker. A transfer's rx buffer belongs to the bus until its
+ * callback. Statistics are written by the worker; reading them elsewhere
+ * gives a best-effort snapshot, and i2c_bus_reset_stats() only posts a
+ * request that the worker applies on its next service.
+ *
+ * Setup and configuration writes (chip init, magnetometer reset) still
+ * call Wire directly; Wire's bus lock serializes them with the worker.
+ *
+ * Backends: Wire on a FreeRTOS worker task (ucf_i2c_bus_esp32.cpp; the
+ * ESP32 I2C driver is interrupt-driven, so only the worker blocks while a
+ * transfer is on the wire) and a mock bus with simulated register files
+ * and timing for host tests (ucf_i2c_bus_mock.cpp).
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_I2C_BUS_H
+#define UCF_I2C_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_dual_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// BUS CONSTANTS
+// ============================================================================
+
+#define I2C_BUS_QUEUE_SIZE          32      // Submitted, not yet taken (power of two)
+#define I2C_BUS_MAX_PENDING         32      // Taken by the worker, not yet run
+#define I2C_BUS_COMPLETION_SIZE     64      // Run, not yet dispatched (power of two)
+#define I2C_BUS_MAX_TX              4       // Bytes written after the register
+#define I2C_BUS_MAX_BATCH           32      // Bytes in one merged read
+#define I2C_BUS_TRACE_SIZE          32
+
+#define I2C_BUS_TASK_STACK          4096
+#define I2C_BUS_TASK_PRIORITY       (CORE_RT_PRIORITY + 1)
+
+/**
+ * @brief Devices on the sensor bus (index into I2cBus.devices)
+ */
+typedef enum {
+    I2C_DEV_MPR121_A = 0,
+    I2C_DEV_MPR121_B,
+    I2C_DEV_HMC5883L,
+    I2C_DEV_COUNT
+} I2cDeviceId;
+
+/**
+ * @brief Transfer result
+ */
+typedef enum {
+    I2C_OK = 0,
+    I2C_ERR_NACK,                   // Address or data not acknowledged
+    I2C_ERR_SHORT,                  // Fewer bytes than requested
+    I2C_ERR_TIMEOUT,
+    I2C_ERR_BUS,                    // Arbitration lost or other bus error
+    I2C_ERR_DEVICE,                 // Unknown device id
+    I2C_EXPIRED                     // Deadline passed before it started
+} I2cStatus;
+
+/**
+ * @brief Transfer priority
+ */
+typedef enum {
+    I2C_PRIO_LOW = 0,               // Diagnostics, configuration
+    I2C_PRIO_NORMAL = 1,            // Magnetometer
+    I2C_PRIO_HIGH = 2               // Touch grid
+} I2cPriority;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Completion callback (runs in i2c_bus_dispatch())
+ * @param rx The transfer's rx buffer (filled if status is I2C_OK)
+ * @param rx_len Bytes requested
+ * @param status Result
+ * @param ctx Transfer context
+ */
+typedef void (*I2cDoneFn)(uint8_t* rx, uint8_t rx_len, I2cStatus status, void* ctx);
+
+/**
+ * @brief One register transaction
+ *
+ * Writes reg followed by tx[0..tx_len), or writes reg and reads rx_len
+ * bytes after a repeated start.
+ */
+typedef struct {
+    uint8_t device;                 // I2cDeviceId
+    uint8_t reg;
+    uint8_t tx_len;                 // Write if non-zero
+    uint8_t rx_len;                 // Read if non-zero
+    uint8_t tx[I2C_BUS_MAX_TX];
+    uint8_t priority;               // I2cPriority
+    uint8_t* rx;                    // rx_len bytes, owned by the bus until done
+    uint32_t deadline_us;           // Latest start (bus clock), 0 = none
+    I2cDoneFn done;                 // May be NULL
+    void* ctx;
+} I2cTransfer;
+
+/**
+ * @brief Bus backend
+ */
+typedef struct {
+    /**
+     * @brief Run one transaction (blocking)
+     * @return I2C_OK or an error
+     */
+    I2cStatus (*transfer)(void* ctx, uint8_t addr, uint8_t reg,
+                          const uint8_t* tx, uint8_t tx_len,
+                          uint8_t* rx, uint8_t rx_len);
+
+    uint32_t (*clock_us)(void* ctx);    // Monotonic microseconds
+    void* ctx;
+} I2cBackend;
+
+/**
+ * @brief Device description
+ */
+typedef struct {
+    const char* name;
+    uint8_t addr;                   // 7-bit address (0 = not added)
+    bool auto_increment;            // Burst reads walk the register map
+} I2cDevice;
+
+/**
+ * @brief Per-device statistics (written by the worker)
+ */
+typedef struct {
+    uint32_t transfers;             // Completed transfers (merged count each)
+    uint32_t transactions;          // Bus transactions
+    uint32_t bytes;                 // Data bytes moved
+    uint32_t errors;
+    uint32_t expired;
+    uint32_t busy_us;               // Time on the bus
+    uint32_t max_us;                // Longest transaction
+    uint8_t last_status;            // I2cStatus of the last transaction
+} I2cDeviceStats;
+
+/**
+ * @brief One traced transaction
+ */
+typedef struct {
+    uint32_t start_us;
+    uint16_t duration_us;
+    uint8_t device;
+    uint8_t reg;
+    uint8_t len;                    // Bytes read or written
+    uint8_t merged;                 // Transfers carried
+    uint8_t status;                 // I2cStatus
+    uint8_t write;                  // 1 for writes
+} I2cTraceEntry;
+
+/**
+ * @brief Completed transfer on its way back to the client
+ */
+typedef struct {
+    I2cDoneFn done;
+    void* ctx;
+    uint8_t* rx;
+    uint8_t rx_len;
+    uint8_t status;
+} I2cCompletion;
+
+/**
+ * @brief Bus manager state
+ */
+typedef struct {
+    I2cBackend backend;
+    I2cDevice devices[I2C_DEV_COUNT];
+    I2cDeviceStats stats[I2C_DEV_COUNT];
+
+    // Client -> worker, worker -> client
+    CoreQueue requests;
+    I2cTransfer request_buffer[I2C_BUS_QUEUE_SIZE];
+    CoreQueue completions;
+    I2cCompletion completion_buffer[I2C_BUS_COMPLETION_SIZE];
+    uint32_t reset_requested;       // Bumped by i2c_bus_reset_stats()
+    uint32_t reset_applied;         // Worker: last request carried out
+
+    // Worker only
+    I2cTransfer pending[I2C_BUS_MAX_PENDING];
+    uint32_t pending_seq[I2C_BUS_MAX_PENDING];
+    uint8_t pending_count;
+    uint32_t next_seq;
+    uint8_t batch[I2C_BUS_MAX_BATCH];
+
+    I2cTraceEntry trace[I2C_BUS_TRACE_SIZE];
+    uint32_t trace_count;           // Total traced (ring index = count % size)
+    uint32_t window_start_us;       // Utilization window
+    uint32_t window_busy_us;
+
+    void (*notify)(void* ctx);      // Wakes the worker in i2c_bus_flush() (may be NULL)
+    void* notify_ctx;
+} I2cBus;
+
+// ============================================================================
+// CLIENT API
+// ============================================================================
+
+/**
+ * @brief Initialize a bus with no devices
+ * @param bus Bus state
+ * @param backend Transaction backend (copied)
+ */
+void i2c_bus_init(I2cBus* bus, const I2cBackend* backend);
+
+/**
+ * @brief Describe a device
+ * @param bus Bus state
+ * @param id Device slot
+ * @param name Short name for traces
+ * @param addr 7-bit address
+ * @param auto_increment true if burst reads walk the register map
+ * @return false if id is out of range
+ */
+bool i2c_bus_add_device(I2cBus* bus, I2cDeviceId id, const char* name,
+                        uint8_t addr, bool auto_increment);
+
+/**
+ * @brief Queue a transfer (client only, never blocks)
+ *
+ * The worker is not woken until i2c_bus_flush(), so a frame of reads
+ * submitted together can be merged.
+ *
+ * @return false if the request queue is full
+ */
+bool i2c_bus_submit(I2cBus* bus, const I2cTransfer* transfer);
+
+/**
+ * @brief Queue a register read
+ */
+bool i2c_bus_read(I2cBus* bus, I2cDeviceId device, uint8_t reg, uint8_t* rx, uint8_t len,
+                  I2cPriority priority, uint32_t deadline_us, I2cDoneFn done, void* ctx);
+
+/**
+ * @brief Wake the worker for everything queued so far
+ */
+void i2c_bus_flush(I2cBus* bus);
+
+/**
+ * @brief Read the bus clock (for deadlines)
+ */
+uint32_t i2c_bus_now(const I2cBus* bus);
+
+/**
+ * @brief Run the callbacks of completed transfers (client only)
+ * @return Callbacks run
+ */
+uint16_t i2c_bus_dispatch(I2cBus* bus);
+
+// ============================================================================
+// WORKER API
+// ============================================================================
+
+/**
+ * @brief Take new requests and run the next transaction (worker only)
+ *
+ * Runs at most one bus transaction (possibly carrying several merged
+ * transfers), plus any expired transfers, which take no bus time.
+ *
+ * @return Transfers completed (0 if there was nothing to do)
+ */
+uint8_t i2c_bus_service(I2cBus* bus);
+
+/**
+ * @brief Service until nothing more can run (tests and setup)
+ * @return Transfers completed
+ */
+uint32_t i2c_bus_service_all(I2cBus* bus);
+
+// ============================================================================
+// STATISTICS API
+// ============================================================================
+
+/**
+ * @brief Get a device's statistics
+ */
+const I2cDeviceStats* i2c_bus_get_stats(const I2cBus* bus, I2cDeviceId id);
+
+/**
+ * @brief Bus busy time since the last reset, in percent
+ */
+float i2c_bus_utilization(const I2cBus* bus);
+
+/**
+ * @brief Clear statistics and start a new utilization window (keeps the trace)
+ *
+ * Safe from the client: the worker clears them at the start of its next
+ * i2c_bus_service(), woken as by i2c_bus_flush().
+ */
+void i2c_bus_reset_stats(I2cBus* bus);
+
+/**
+ * @brief Get a traced transaction
+ * @param bus Bus state
+ * @param age 0 = most recent
+ * @return NULL if fewer than age + 1 transactions were traced
+ */
+const I2cTraceEntry* i2c_bus_trace(const I2cBus* bus, uint32_t age);
+
+/**
+ * @brief Get a status name
+ */
+const char* i2c_status_string(I2cStatus status);
+
+// ============================================================================
+// ESP32 BACKEND (ucf_i2c_bus_esp32.cpp)
+// ============================================================================
+
+/**
+ * @brief Fill a backend that runs transactions through Wire
+ */
+void i2c_bus_wire_backend(I2cBackend* backend);
+
+/**
+ * @brief Start the worker task on the real-time core
+ *
+ * Wire must not be used directly once this returns.
+ *
+ * @return true if the task is running
+ */
+bool i2c_bus_start(I2cBus* bus);
+
+// ============================================================================
+// MOCK BACKEND (ucf_i2c_bus_mock.cpp, host tests)
+// ============================================================================
+
+#define I2C_MOCK_MAX_DEVICES        4
+
+/**
+ * @brief Simulated device
+ */
+typedef struct {
+    uint8_t addr;                   // 0 = free slot
+    uint8_t regs[256];              // Register file (reads and writes walk it)
+    uint8_t fail_count;             // Next transactions that fail
+    uint8_t fail_status;            // I2cStatus returned while failing
+} I2cMockDevice;
+
+/**
+ * @brief Simulated bus with a virtual clock
+ */
+typedef struct {
+    I2cMockDevice devices[I2C_MOCK_MAX_DEVICES];
+    uint32_t now_us;                // Virtual clock
+    uint32_t byte_us;               // Per byte on the wire (~23 us at 400 kHz)
+    uint32_t transactions;
+} I2cMockBus;
+
+/**
+ * @brief Initialize an empty mock bus
+ * @param mock Mock state
+ * @param byte_us Time per byte on the wire (address, register and data)
+ */
+void i2c_mock_init(I2cMockBus* mock, uint32_t byte_us);
+
+/**
+ * @brief Attach a simulated device
+ * @return Its register file, NULL if all slots are used
+ */
+uint8_t* i2c_mock_add_device(I2cMockBus* mock, uint8_t addr);
+
+/**
+ * @brief Make a device's next transactions fail
+ */
+void i2c_mock_fail(I2cMockBus* mock, uint8_t addr, uint8_t count, I2cStatus status);
+
+/**
+ * @brief Fill a backend bound to the mock
+ */
+void i2c_mock_backend(I2cMockBus* mock, I2cBackend* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_I2C_BUS_H
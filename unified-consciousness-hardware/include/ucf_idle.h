@@ -0,0 +1,198 @@
+/**
+ * @file ucf_idle.h
+ * @brief UCF Idle Governor v4.0.0
+ *
+ * Between scheduler passes the loop used to spin until the next release.
+ * The governor takes the gap sched_idle_us() reports and picks how to
+ * spend it:
+ *
+ * - IDLE_RUN: gaps shorter than wait_min_us; waking costs about as much
+ *   as the gap, so the caller just runs the scheduler again
+ * - IDLE_WAIT: block until a one-shot timer just before the next release;
+ *   the core halts in the RTOS idle task (WFI) until an interrupt
+ * - IDLE_LIGHT_SLEEP: gaps of sleep_min_us or more, when enabled; the
+ *   chip sleeps until the timer, a UART RX edge or the touch IRQ
+ *
+ * Waits and sleeps end a margin early to cover the wake-up latency, so
+ * tasks keep their release times. The governor records how long each mode
+ * lasted and what ended it (residency, 'd').
+ *
+ * Light sleep stops both cores and the radio, so it is only for the
+ * single-loop firmware; main_v4 uses IDLE_WAIT on the real-time core.
+ *
+ * The backend is ucf_idle_esp32.cpp (esp_timer, FreeRTOS notifications and
+ * esp_sleep), which the native HAL also provides, so host runs exercise
+ * the same code. Tests pass their own enter function.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_IDLE_H
+#define UCF_IDLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// IDLE CONSTANTS
+// ============================================================================
+
+#define IDLE_WAIT_MIN_US            100     // Shorter gaps stay awake
+#define IDLE_WAIT_MARGIN_US         30      // esp_timer dispatch and task switch
+#define IDLE_SLEEP_MIN_US           5000    // Light sleep pays off from here
+#define IDLE_SLEEP_MARGIN_US        1000    // Light sleep entry and exit
+#define IDLE_LINE_MAX               96
+
+#ifndef UCF_TOUCH_IRQ_PIN
+#define UCF_TOUCH_IRQ_PIN           -1      // MPR121 IRQ (active low), -1 = not wired
+#endif
+
+/**
+ * @brief How a gap is spent
+ */
+typedef enum {
+    IDLE_RUN = 0,                   // Stay awake
+    IDLE_WAIT,                      // Block until the timer (core halts)
+    IDLE_LIGHT_SLEEP,               // Chip light sleep
+    IDLE_MODE_COUNT
+} IdleMode;
+
+/**
+ * @brief What ended a wait or sleep
+ */
+typedef enum {
+    IDLE_WAKE_TIMER = 0,
+    IDLE_WAKE_UART,
+    IDLE_WAKE_TOUCH,
+    IDLE_WAKE_OTHER,
+    IDLE_WAKE_COUNT
+} IdleWake;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Thresholds (see IDLE_* defaults)
+ */
+typedef struct {
+    uint32_t wait_min_us;           // Shortest gap worth waiting
+    uint32_t wait_margin_us;        // Waits end this early
+    uint32_t sleep_min_us;          // Shortest gap worth light sleep (0 = never)
+    uint32_t sleep_margin_us;       // Light sleeps end this early
+} IdleConfig;
+
+/**
+ * @brief Enter a mode for up to us microseconds (IDLE_WAIT or IDLE_LIGHT_SLEEP)
+ * @return What ended it
+ */
+typedef IdleWake (*IdleEnterFn)(IdleMode mode, uint32_t us, void* ctx);
+
+/**
+ * @brief Totals since idle_init() or the last idle_reset_stats()
+ */
+typedef struct {
+    uint32_t window_us;                     // Time covered
+    uint32_t entries[IDLE_MODE_COUNT];      // [IDLE_RUN]: gaps too short to wait
+    uint32_t time_us[IDLE_MODE_COUNT];      // Time spent waiting / asleep
+    uint32_t wakes[IDLE_WAKE_COUNT];
+    uint32_t max_late_us;                   // Worst wake-up after the planned time
+} IdleStats;
+
+/**
+ * @brief One core's governor (owned by the core it runs on)
+ */
+typedef struct {
+    IdleConfig config;
+    uint32_t (*clock_us)(void);
+    IdleEnterFn enter;
+    void* ctx;
+    uint32_t stats_start_us;
+    IdleStats stats;
+} IdleGovernor;
+
+/**
+ * @brief Text report sink (one line, no newline)
+ */
+typedef void (*IdleLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// IDLE API
+// ============================================================================
+
+/**
+ * @brief Set up a governor
+ * @param g Governor
+ * @param config Thresholds
+ * @param clock_us Microsecond clock (the scheduler's)
+ * @param enter Backend (e.g. idle_esp32_enter)
+ * @param ctx Passed to enter
+ */
+void idle_init(IdleGovernor* g, const IdleConfig* config, uint32_t (*clock_us)(void),
+               IdleEnterFn enter, void* ctx);
+
+/**
+ * @brief Choose a mode for a gap
+ * @param config Thresholds
+ * @param idle_us Time to the next release (sched_idle_us(), 0 = work due)
+ * @param enter_us Output: how long to wait or sleep
+ */
+IdleMode idle_plan(const IdleConfig* config, uint32_t idle_us, uint32_t* enter_us);
+
+/**
+ * @brief Spend a gap (call after sched_run())
+ * @return Mode used
+ */
+IdleMode idle_run(IdleGovernor* g, uint32_t idle_us);
+
+/**
+ * @brief Get totals
+ */
+void idle_get_stats(const IdleGovernor* g, IdleStats* stats);
+
+/**
+ * @brief Clear totals (with sched_reset_stats())
+ */
+void idle_reset_stats(IdleGovernor* g);
+
+/**
+ * @brief Write residency as text lines
+ * @param g Governor
+ * @param fn Called once per line
+ * @param ctx Passed to fn
+ */
+void idle_write_text(const IdleGovernor* g, IdleLineFn fn, void* ctx);
+
+// ============================================================================
+// ESP32 BACKEND (ucf_idle_esp32.cpp)
+// ============================================================================
+
+/**
+ * @brief Wake-up state of one core
+ */
+typedef struct {
+    void* timer;                    // esp_timer_handle_t
+    void* task;                     // TaskHandle_t waiting, NULL when none
+} IdleEsp32;
+
+/**
+ * @brief Create the core's wake-up timer (during setup, it allocates)
+ * @return false if the timer cannot be created
+ */
+bool idle_esp32_begin(IdleEsp32* e);
+
+/**
+ * @brief IdleEnterFn for the ESP32 (ctx is the core's IdleEsp32)
+ */
+IdleWake idle_esp32_enter(IdleMode mode, uint32_t us, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_IDLE_H
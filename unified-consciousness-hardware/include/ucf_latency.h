@@ -0,0 +1,226 @@
+/**
+ * @file ucf_latency.h
+ * @brief UCF Touch Latency Tracer v4.0.0
+ *
+ * Follows one touch at a time through the pipeline and records when each
+ * stage first passes it on:
+ *
+ *   touch      pad touched (native HAL only: the device cannot see it)
+ *   mpr121     the filtered data read that showed the touch
+ *   field      readField() with the touch active (opens the frame)
+ *   phase      PhaseEngine's EMA moves the tier or phase
+ *   emanation  Emanation::update() (main.cpp) or leds_update() (main_v4.cpp)
+ *              takes up the new state
+ *   led        the show() that put it on the strip
+ *   audio      the tone frequency change
+ *
+ * A frame gets an ID when readField() sees the grid go from untouched to
+ * touched, and ends at the first led or audio stamp. Each stage stamps
+ * the open frame when its own output changes and every stamp must follow
+ * the last one, so a stage that runs off older data (or is not on this
+ * build's output path) is skipped rather than stamped out of order. A new
+ * touch, or LAT_TIMEOUT_US without output, closes the frame incomplete.
+ *
+ * For each hop the tracer keeps a log-linear histogram of the time since
+ * the previous stamp, plus one for touch-to-output, and it keeps the last
+ * LAT_RING_FRAMES frames for a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Stages may stamp from any core. Frames are opened, closed and recorded
+ * only by the readField() caller; other stages take their stamp with a
+ * compare-and-swap on the frame word. Reads from the other core are a
+ * best-effort snapshot, as for the profiler.
+ *
+ * Compiled out with the profiler (UCF_PROFILE=0): LAT_MARK() and
+ * LAT_FIELD() expand to nothing and the API reports no frames.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_LATENCY_H
+#define UCF_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_profiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// LATENCY CONSTANTS
+// ============================================================================
+
+#define LAT_RING_FRAMES             16      // Recent frames kept for the trace export
+#define LAT_TIMEOUT_US              1000000 // A frame with no output by then is incomplete
+#define LAT_LINE_MAX                160
+
+/**
+ * @brief Pipeline stages, in order
+ */
+typedef enum {
+    LAT_TOUCH = 0,                  // lat_touch() (host)
+    LAT_MPR121,                     // MPR121 filtered data read
+    LAT_FIELD,                      // HexGrid::readField
+    LAT_PHASE,                      // PhaseEngine EMA tier/phase change
+    LAT_EMANATION,                  // Emanation::update / leds_update
+    LAT_LED,                        // NeoPixel show()
+    LAT_AUDIO,                      // Tone frequency change
+    LAT_HOP_COUNT
+} LatHop;
+
+#define LAT_HOP_BIT(hop)            (1u << (hop))
+#define LAT_OUTPUT_BITS             (LAT_HOP_BIT(LAT_LED) | LAT_HOP_BIT(LAT_AUDIO))
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief One traced touch
+ */
+typedef struct {
+    uint16_t id;
+    uint16_t mask;                  // LAT_HOP_BIT of each stamped hop
+    uint32_t stamps_us[LAT_HOP_COUNT];
+} LatFrame;
+
+/**
+ * @brief Latency summary of a hop or of touch-to-output (microseconds)
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t p50_us;                // Histogram estimate
+    uint32_t p99_us;                // Histogram estimate
+    uint32_t max_us;
+} LatSummary;
+
+/**
+ * @brief Frame totals since the last reset
+ */
+typedef struct {
+    uint32_t complete;              // Reached an output
+    uint32_t incomplete;            // Timed out or replaced by a new touch
+} LatStats;
+
+/**
+ * @brief Microsecond clock (micros() on the device)
+ */
+typedef uint32_t (*LatClockFn)(void);
+
+/**
+ * @brief Called with every recorded frame, from the readField() caller
+ */
+typedef void (*LatFrameFn)(const LatFrame* frame, void* ctx);
+
+/**
+ * @brief Text and trace export sink (one line, no newline)
+ */
+typedef void (*LatLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// TRACE API
+// ============================================================================
+
+/**
+ * @brief Clear the tracer and start tracing
+ * @param clock Time source, or NULL to stop tracing
+ */
+void lat_init(LatClockFn clock);
+
+/**
+ * @brief Note a pad touch for the next frame (host HAL)
+ * @param touch_us When the finger landed, on the tracer's clock
+ */
+void lat_touch(uint32_t touch_us);
+
+/**
+ * @brief Stamp a stage into the open frame
+ *
+ * LAT_MPR121 notes the read for the frame readField() may open next.
+ */
+void lat_mark(LatHop hop);
+
+/**
+ * @brief Stamp readField(): opens a frame on touch onset, records finished ones
+ * @param touched Any cell active in the field just computed
+ */
+void lat_field(bool touched);
+
+/**
+ * @brief Set the recorded-frame callback (kept across lat_init())
+ */
+void lat_on_frame(LatFrameFn fn, void* ctx);
+
+// ============================================================================
+// READ API
+// ============================================================================
+
+/**
+ * @brief Summarize one hop (time since the previous stamp)
+ * @return true if the hop has samples
+ */
+bool lat_get(LatHop hop, LatSummary* summary);
+
+/**
+ * @brief Summarize touch-to-output (first stamp to led/audio)
+ * @return true if any frame completed
+ */
+bool lat_get_total(LatSummary* summary);
+
+/**
+ * @brief Get frame totals
+ */
+void lat_get_stats(LatStats* stats);
+
+/**
+ * @brief Copy the most recent frames, oldest first
+ * @return Frames copied (at most LAT_RING_FRAMES)
+ */
+size_t lat_recent(LatFrame* frames, size_t max);
+
+/**
+ * @brief Clear histograms, totals and recent frames (keeps the clock)
+ */
+void lat_reset(void);
+
+/**
+ * @brief Get a hop's name
+ */
+const char* lat_hop_name(LatHop hop);
+
+// ============================================================================
+// EXPORT API
+// ============================================================================
+
+/**
+ * @brief Write the frame totals and per-hop summaries as text
+ */
+void lat_write_text(LatLineFn fn, void* ctx);
+
+/**
+ * @brief Write frames as Chrome trace JSON
+ *
+ * One row (tid) per frame: a complete event per hop from the previous
+ * stamp, and one "touch_to_output" event spanning a finished frame.
+ */
+void lat_write_chrome(const LatFrame* frames, size_t count, LatLineFn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ============================================================================
+// TRACE POINTS
+// ============================================================================
+
+#if UCF_PROFILE
+#define LAT_MARK(hop)               lat_mark(hop)
+#define LAT_FIELD(touched)          lat_field(touched)
+#else
+#define LAT_MARK(hop)               do {} while (0)
+#define LAT_FIELD(touched)          do {} while (0)
+#endif
+
+#endif // UCF_LATENCY_H
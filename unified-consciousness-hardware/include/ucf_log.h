@@ -0,0 +1,222 @@
+/**
+ * @file ucf_log.h
+ * @brief UCF Deferred Logger v4.0.0
+ *
+ * Log calls do not format text. A call site owns a static LogSite (format
+ * string, level, category) and stores a pointer to it with its raw
+ * arguments in a lock-free ring: one compare-and-swap and a few stores.
+ * A low-priority task formats the records later with log_drain(), as
+ * many as the UART can take without blocking, so a log line never stalls
+ * the control loop. A full ring refuses the record and counts it.
+ *
+ * Arguments are stored as 32-bit words: integers (wider ones truncated),
+ * floats (doubles narrowed) and pointers. A %s argument must outlive the
+ * drain, so only string literals and other static strings may be logged.
+ *
+ * Levels and categories are filtered at compile time: a disabled UCF_LOG_AT()
+ * compiles to nothing, format string included.
+ *
+ *   -DUCF_LOG_LEVEL=4                  ; LOG_LEVEL_DEBUG (default INFO,
+ *                                      ; VERBOSE with UCF_VERBOSE_LOGGING)
+ *   -DUCF_LOG_CATEGORIES=0x31          ; LOG_CAT_BIT() mask (default all)
+ *
+ * Any number of tasks and cores may log; one task drains.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_LOG_H
+#define UCF_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// LOG CONSTANTS
+// ============================================================================
+
+#ifndef UCF_LOG_RECORDS
+#define UCF_LOG_RECORDS             32      // Ring size (power of two)
+#endif
+
+#define LOG_MAX_ARGS                10
+#define LOG_LINE_MAX                128
+
+#define LOG_LEVEL_NONE              0
+#define LOG_LEVEL_ERROR             1
+#define LOG_LEVEL_WARN              2
+#define LOG_LEVEL_INFO              3
+#define LOG_LEVEL_DEBUG             4
+#define LOG_LEVEL_VERBOSE           5
+
+/**
+ * @brief Categories (each prints with its own prefix)
+ */
+typedef enum {
+    LOG_CAT_UCF = 0,                // [UCF] module messages
+    LOG_CAT_LATTICE,                // [LAT]
+    LOG_CAT_KURAMOTO,               // [KUR]
+    LOG_CAT_TRIAD,                  // [TRI]
+    LOG_CAT_DEBUG,                  // [DBG]
+    LOG_CAT_STATUS,                 // 1 Hz status line
+    LOG_CAT_EVENT,                  // TRIAD, K-Formation and sync announcements
+    LOG_CAT_COUNT
+} LogCategory;
+
+#define LOG_CAT_BIT(cat)            (1u << (cat))
+
+#ifndef UCF_LOG_LEVEL
+#if defined(UCF_VERBOSE_LOGGING) && UCF_VERBOSE_LOGGING
+#define UCF_LOG_LEVEL               LOG_LEVEL_VERBOSE
+#elif defined(DEBUG_MODE) && DEBUG_MODE
+#define UCF_LOG_LEVEL               LOG_LEVEL_DEBUG
+#else
+#define UCF_LOG_LEVEL               LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifndef UCF_LOG_CATEGORIES
+#define UCF_LOG_CATEGORIES          0xFFFFFFFFu
+#endif
+
+#define UCF_LOG_ENABLED(level, cat) \
+    ((level) <= UCF_LOG_LEVEL && (UCF_LOG_CATEGORIES & LOG_CAT_BIT(cat)) != 0)
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief A log call site (static, so its address identifies the format)
+ */
+typedef struct {
+    const char* format;             // printf format, no newline
+    uint8_t level;
+    uint8_t category;
+} LogSite;
+
+/**
+ * @brief One stored argument
+ */
+typedef union {
+    int32_t i;
+    uint32_t u;
+    float f;
+    const char* s;
+    const void* p;
+} LogArg;
+
+/**
+ * @brief A record as stored in the ring
+ */
+typedef struct {
+    const LogSite* site;
+    uint8_t argc;
+    LogArg args[LOG_MAX_ARGS];
+} LogRecord;
+
+/**
+ * @brief Totals since log_init()
+ */
+typedef struct {
+    uint32_t written;               // Records stored
+    uint32_t dropped;               // Refused by a full ring
+    uint32_t pending;               // Stored, not yet drained
+} LogStats;
+
+/**
+ * @brief Text sink (one line, no newline)
+ */
+typedef void (*LogLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// LOG API
+// ============================================================================
+
+/**
+ * @brief Empty the ring and clear the totals (before any task logs)
+ */
+void log_init(void);
+
+/**
+ * @brief Store a record (any task or core)
+ * @return false if the ring was full
+ */
+bool log_push(const LogSite* site, const LogArg* args, uint8_t argc);
+
+/**
+ * @brief Take the oldest record (the draining task only)
+ * @return false if the ring is empty
+ */
+bool log_pop(LogRecord* record);
+
+/**
+ * @brief Format a record as its line: category prefix, then the text
+ * @return Characters written (truncated to capacity - 1)
+ */
+size_t log_format(const LogRecord* record, char* out, size_t capacity);
+
+/**
+ * @brief Format and emit up to max records (the draining task only)
+ * @return Records emitted
+ */
+size_t log_drain(LogLineFn fn, void* ctx, size_t max);
+
+/**
+ * @brief Get totals
+ */
+void log_get_stats(LogStats* stats);
+
+#ifdef __cplusplus
+}
+
+// ============================================================================
+// CALL SITES (C++)
+// ============================================================================
+
+inline LogArg log_arg(int v)                { LogArg a; a.i = v; return a; }
+inline LogArg log_arg(long v)               { LogArg a; a.i = (int32_t)v; return a; }
+inline LogArg log_arg(long long v)          { LogArg a; a.i = (int32_t)v; return a; }
+inline LogArg log_arg(unsigned v)           { LogArg a; a.u = v; return a; }
+inline LogArg log_arg(unsigned long v)      { LogArg a; a.u = (uint32_t)v; return a; }
+inline LogArg log_arg(unsigned long long v) { LogArg a; a.u = (uint32_t)v; return a; }
+inline LogArg log_arg(double v)             { LogArg a; a.f = (float)v; return a; }
+inline LogArg log_arg(const char* v)        { LogArg a; a.s = v; return a; }
+inline LogArg log_arg(const void* v)        { LogArg a; a.p = v; return a; }
+
+template <typename... Args>
+inline bool log_write(const LogSite* site, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    const LogArg argv[sizeof...(Args) + 1] = { log_arg(args)... };
+    return log_push(site, argv, (uint8_t)sizeof...(Args));
+}
+
+// Never called: lets the compiler check the arguments against the format
+int log_check_format(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Log at a level and category, filtered out at compile time
+ */
+#define UCF_LOG_AT(level, cat, fmt, ...) \
+    do { \
+        if (UCF_LOG_ENABLED(level, cat)) { \
+            (void)sizeof(log_check_format(fmt, ##__VA_ARGS__)); \
+            static const LogSite log_site_ = { fmt, (uint8_t)(level), (uint8_t)(cat) }; \
+            log_write(&log_site_, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define UCF_LOGE(cat, fmt, ...)     UCF_LOG_AT(LOG_LEVEL_ERROR, cat, fmt, ##__VA_ARGS__)
+#define UCF_LOGW(cat, fmt, ...)     UCF_LOG_AT(LOG_LEVEL_WARN, cat, fmt, ##__VA_ARGS__)
+#define UCF_LOGI(cat, fmt, ...)     UCF_LOG_AT(LOG_LEVEL_INFO, cat, fmt, ##__VA_ARGS__)
+#define UCF_LOGD(cat, fmt, ...)     UCF_LOG_AT(LOG_LEVEL_DEBUG, cat, fmt, ##__VA_ARGS__)
+#define UCF_LOGV(cat, fmt, ...)     UCF_LOG_AT(LOG_LEVEL_VERBOSE, cat, fmt, ##__VA_ARGS__)
+
+#endif // __cplusplus
+
+#endif // UCF_LOG_H
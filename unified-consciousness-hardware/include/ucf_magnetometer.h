@@ -46,6 +46,8 @@ extern "C" {
 #define HMC5883L_REG_ID_B       0x0B
 #define HMC5883L_REG_ID_C       0x0C
 
+#define HMC5883L_DATA_BYTES     6       // X, Z, Y data registers
+
 // Configuration values
 #define HMC5883L_SAMPLES_8      0x60    // 8 samples averaged
 #define HMC5883L_RATE_15HZ      0x10    // 15 Hz data output rate
@@ -170,6 +172,20 @@ bool magnetometer_data_ready(void);
  */
 MagnetometerRaw magnetometer_read_raw(void);
 
+/**
+ * @brief Decode the data registers (X, Z, Y, big-endian)
+ * @param data HMC5883L_DATA_BYTES bytes read from HMC5883L_REG_DATA_X_H
+ * @return Raw axis values
+ */
+MagnetometerRaw magnetometer_decode_raw(const uint8_t* data);
+
+/**
+ * @brief Calibrate and smooth a raw sample read elsewhere (e.g. by the bus manager)
+ * @param raw Raw axis values
+ * @return Current calibrated data
+ */
+MagnetometerData magnetometer_process(MagnetometerRaw raw);
+
 /**
  * @brief Set gain/sensitivity
  * @param gain Gain setting
@@ -229,13 +245,13 @@ bool magnetometer_calibrate_finish(void);
 void magnetometer_set_declination(float declination);
 
 /**
- * @brief Load calibration from EEPROM
+ * @brief Load calibration from persistent storage
  * @return true if valid calibration found
  */
 bool magnetometer_load_calibration(void);
 
 /**
- * @brief Save calibration to EEPROM
+ * @brief Save calibration to persistent storage
  * @return true if save successful
  */
 bool magnetometer_save_calibration(void);
@@ -0,0 +1,166 @@
+/**
+ * @file ucf_memory.h
+ * @brief UCF Memory Budget v4.0.0
+ *
+ * Two views of where SRAM goes:
+ *
+ * - Static: each firmware builds a table of its module objects with
+ *   MEM_STATIC(), so the sizes are fixed at compile time. 'b' prints them.
+ * - Arena: one fixed block of UCF_ARENA_BYTES from which modules carve
+ *   their history buffers in begin(). The buffer sizes below are build
+ *   flags, so a product SKU can trade history depth for RAM without code
+ *   changes. Each firmware static_asserts that its modules' buffers fit.
+ *
+ * Arena blocks are never freed. Short-lived buffers that are too big for
+ * a task stack can be taken between mem_mark() and mem_release(); the
+ * arena's peak counts them, and requests that did not fit are totalled
+ * so the report shows how far a build is from its budget.
+ *
+ * Not thread safe: allocate from setup() or one task.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_MEMORY_H
+#define UCF_MEMORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================================
+// MODULE BUFFER SIZES (override with -D flags per SKU)
+// ============================================================================
+
+#ifndef UCF_ARENA_BYTES
+#define UCF_ARENA_BYTES             9216    // Fits the legacy firmware's defaults
+#endif
+
+#ifndef UCF_PHASE_HISTORY
+#define UCF_PHASE_HISTORY           256     // PhaseEngine z/phase entries (12 bytes)
+#endif
+
+#ifndef UCF_KFORMATION_HISTORY
+#define UCF_KFORMATION_HISTORY      64      // KFormation field frames (80 bytes)
+#endif
+
+#ifndef UCF_LINGUISTICS_HISTORY
+#define UCF_LINGUISTICS_HISTORY     32      // OmniLinguistics tokens (20 bytes)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// MEMORY CONSTANTS
+// ============================================================================
+
+#define MEM_ALIGN                   8
+#define MEM_MAX_BLOCKS              16
+#define MEM_LINE_MAX                96
+
+/**
+ * @brief Bytes a request takes from the arena (rounded up to MEM_ALIGN)
+ */
+#define MEM_ROUND(bytes)            (((bytes) + MEM_ALIGN - 1) & ~(size_t)(MEM_ALIGN - 1))
+
+/**
+ * @brief Static table entry for a module object
+ */
+#define MEM_STATIC(object)          { #object, (uint32_t)sizeof(object) }
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief A statically allocated module object
+ */
+typedef struct {
+    const char* name;
+    uint32_t bytes;
+} MemStaticEntry;
+
+/**
+ * @brief A block carved from the arena
+ */
+typedef struct {
+    const char* owner;
+    uint32_t offset;
+    uint32_t bytes;                 // As requested (the arena rounds up)
+} MemBlock;
+
+/**
+ * @brief Arena totals
+ */
+typedef struct {
+    uint32_t capacity;
+    uint32_t used;                  // Blocks and open scratch
+    uint32_t peak;                  // Highest used since mem_init()
+    uint32_t refused;               // Bytes of requests that did not fit
+    uint8_t blocks;
+} MemStats;
+
+/**
+ * @brief Text export sink (one line, no newline)
+ */
+typedef void (*MemLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// ARENA API
+// ============================================================================
+
+/**
+ * @brief Empty the arena (tests; firmware starts empty)
+ */
+void mem_init(void);
+
+/**
+ * @brief Carve a zeroed block for the life of the firmware
+ * @param owner Name shown in the report (kept, not copied)
+ * @param bytes Block size
+ * @return Block aligned to MEM_ALIGN, or NULL if the arena is full
+ */
+void* mem_alloc(const char* owner, size_t bytes);
+
+/**
+ * @brief Note the arena's current end before scratch allocations
+ */
+uint32_t mem_mark(void);
+
+/**
+ * @brief Give back everything allocated since mem_mark()
+ */
+void mem_release(uint32_t mark);
+
+/**
+ * @brief Get arena totals
+ */
+void mem_get_stats(MemStats* stats);
+
+/**
+ * @brief Copy the arena's blocks in allocation order
+ * @return Blocks copied
+ */
+size_t mem_blocks(MemBlock* blocks, size_t max);
+
+// ============================================================================
+// REPORT API
+// ============================================================================
+
+/**
+ * @brief Set the firmware's static module table (kept, not copied)
+ */
+void mem_set_static(const MemStaticEntry* table, size_t count);
+
+/**
+ * @brief Write the static table, arena totals and blocks as text
+ */
+void mem_write_text(MemLineFn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_MEMORY_H
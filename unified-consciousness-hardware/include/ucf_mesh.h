@@ -0,0 +1,299 @@
+/**
+ * @file ucf_mesh.h
+ * @brief UCF Kuramoto Mesh v4.0.0
+ *
+ * Couples the Kuramoto ensembles of several devices (beds) without
+ * shipping phase vectors. Each node broadcasts a summary of its own
+ * ensemble, MESH_PACKET_BYTES long:
+ *
+ *   magic, node, seq, r, psi, collective frequency, sender time
+ *
+ * and sums its neighbours' summaries into one external mean field that
+ * the local oscillators are pulled towards (KuramotoStabilizer::
+ * setExternalField()).
+ *
+ * Latency compensation: a summary describes the sender at its own clock
+ * time, and the backend stamps each packet with its local arrival time
+ * (not the later poll). Per peer the node keeps the smallest (arrival -
+ * send) difference seen, which is the clock offset plus the shortest path
+ * delay; adding
+ * the nominal MESH_LINK_LATENCY_US back gives the local time the summary
+ * held, and the peer's phase is advanced at its frequency from there to
+ * now. Queueing and retry delays on top of the shortest one are thus
+ * taken out, whatever they were for that packet.
+ *
+ * The transport is a MeshBackend: ESP-NOW broadcast on the device
+ * (ucf_mesh_esp32.cpp, which the native HAL runs over UDP on the loopback
+ * interface between processes) or the in-process hub of
+ * ucf_mesh_mock.cpp for host tests.
+ *
+ * One task owns a Mesh (main_v4: the I/O core).
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_MESH_H
+#define UCF_MESH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// MESH CONSTANTS
+// ============================================================================
+
+#define MESH_MAX_PEERS              8
+#define MESH_PACKET_BYTES           14
+#define MESH_MAGIC                  0x4B    // 'K'
+#define MESH_BROADCAST_US           20000   // 50 Hz summaries
+#define MESH_PEER_TIMEOUT_US        250000  // Silent peers leave the field
+#define MESH_LINK_LATENCY_US        1000    // Shortest one-way delay (ESP-NOW)
+#define MESH_OFFSET_CREEP_US        1       // Per packet, follows crystal drift
+#define MESH_POLL_MAX               16      // Packets handled per mesh_poll()
+#define MESH_LINE_MAX               128
+#define MESH_NODE_NONE              0xFF
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief One node's ensemble at one instant
+ */
+typedef struct {
+    uint8_t node;
+    uint16_t seq;
+    float r;                        // Order parameter [0, 1]
+    float psi;                      // Collective phase [0, 2*PI)
+    float freq_hz;                  // Collective frequency (phase velocity)
+    uint32_t sent_us;               // Sender clock when r and psi held
+} MeshSummary;
+
+/**
+ * @brief Transport (broadcast datagrams, never blocking)
+ */
+typedef struct {
+    /**
+     * @brief Broadcast one packet
+     * @return false if it could not be queued
+     */
+    bool (*send)(void* ctx, const uint8_t* data, uint8_t len);
+
+    /**
+     * @brief Take the next received packet
+     * @param rx_us Output: local time it arrived (left as is if unknown)
+     * @return Its length, 0 if none is waiting
+     */
+    uint8_t (*recv)(void* ctx, uint8_t* data, uint8_t max, uint32_t* rx_us);
+
+    void* ctx;
+} MeshBackend;
+
+/**
+ * @brief A neighbour
+ */
+typedef struct {
+    MeshSummary last;               // Newest summary
+    uint32_t held_us;               // Local time its r and psi held
+    uint32_t rx_us;                 // Local time the newest summary arrived
+    int32_t offset_us;              // min(receive - send): clock offset + shortest delay
+    uint32_t packets;
+    uint32_t lost;                  // Sequence gaps
+    bool active;                    // Slot in use
+} MeshPeer;
+
+/**
+ * @brief Combined field of the fresh peers
+ */
+typedef struct {
+    float r;                        // |mean of r e^(i psi)|
+    float psi;                      // Its phase at at_us
+    float freq_hz;                  // r-weighted mean frequency
+    uint32_t at_us;
+    uint8_t peers;
+} MeshField;
+
+/**
+ * @brief Totals since mesh_init()
+ */
+typedef struct {
+    uint32_t sent;
+    uint32_t send_errors;
+    uint32_t received;              // Summaries accepted
+    uint32_t rejected;              // Foreign, malformed, own or stale packets
+    uint32_t lost;                  // Sequence gaps over all peers
+    uint32_t no_slot;               // Summaries from peers beyond MESH_MAX_PEERS
+} MeshStats;
+
+/**
+ * @brief Node state
+ */
+typedef struct {
+    MeshBackend backend;
+    uint8_t node;
+    uint16_t seq;
+    MeshPeer peers[MESH_MAX_PEERS];
+    MeshStats stats;
+} Mesh;
+
+/**
+ * @brief Text report sink (one line, no newline)
+ */
+typedef void (*MeshLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// PACKET API
+// ============================================================================
+
+/**
+ * @brief Write a summary as a packet
+ * @param summary Summary (r clamped to [0, 1], psi wrapped)
+ * @param out MESH_PACKET_BYTES bytes
+ */
+void mesh_encode(const MeshSummary* summary, uint8_t* out);
+
+/**
+ * @brief Read a packet
+ * @return false if it is not a summary
+ */
+bool mesh_decode(const uint8_t* data, uint8_t len, MeshSummary* summary);
+
+// ============================================================================
+// MESH API
+// ============================================================================
+
+/**
+ * @brief Start a node with no peers
+ * @param m Node state
+ * @param backend Transport (copied)
+ * @param node This node's ID (not MESH_NODE_NONE)
+ */
+void mesh_init(Mesh* m, const MeshBackend* backend, uint8_t node);
+
+/**
+ * @brief Broadcast this node's ensemble
+ * @param m Node state
+ * @param r Order parameter
+ * @param psi Collective phase
+ * @param freq_hz Collective frequency
+ * @param held_us Local time r and psi held
+ * @return false if the transport refused it
+ */
+bool mesh_broadcast(Mesh* m, float r, float psi, float freq_hz, uint32_t held_us);
+
+/**
+ * @brief Take in received summaries
+ * @param m Node state
+ * @param now_us Local time (arrival time where the backend has none)
+ * @return Summaries accepted
+ */
+uint8_t mesh_poll(Mesh* m, uint32_t now_us);
+
+/**
+ * @brief Combine the fresh peers into one field
+ * @param m Node state
+ * @param now_us Time to predict the field for
+ * @param field Output
+ * @return false if no peer is fresh (field zeroed)
+ */
+bool mesh_field(const Mesh* m, uint32_t now_us, MeshField* field);
+
+/**
+ * @brief Predict a peer's collective phase
+ * @param peer Peer
+ * @param now_us Local time
+ * @return Phase [0, 2*PI)
+ */
+float mesh_peer_phase(const MeshPeer* peer, uint32_t now_us);
+
+/**
+ * @brief Get totals
+ */
+void mesh_get_stats(const Mesh* m, MeshStats* stats);
+
+/**
+ * @brief Write the node and its peers as text lines
+ * @param m Node state
+ * @param now_us Local time (peer ages)
+ * @param fn Called once per line
+ * @param ctx Passed to fn
+ */
+void mesh_write_text(const Mesh* m, uint32_t now_us, MeshLineFn fn, void* ctx);
+
+// ============================================================================
+// ESP32 BACKEND (ucf_mesh_esp32.cpp)
+// ============================================================================
+
+/**
+ * @brief Start ESP-NOW and fill a backend that broadcasts on it
+ *
+ * Brings WiFi up in station mode if it is off. Call once, during
+ * start-up (ESP-NOW allocates).
+ *
+ * @param backend Output
+ * @param node Output: this node's ID (low byte of the station MAC)
+ * @return false if ESP-NOW cannot start
+ */
+bool mesh_espnow_backend(MeshBackend* backend, uint8_t* node);
+
+// ============================================================================
+// MOCK BACKEND (ucf_mesh_mock.cpp, host tests)
+// ============================================================================
+
+#define MESH_MOCK_MAX_NODES         4
+#define MESH_MOCK_QUEUE             16      // Packets in flight per node
+
+/**
+ * @brief One node's inbox
+ */
+typedef struct {
+    uint8_t data[MESH_MOCK_QUEUE][MESH_PACKET_BYTES];
+    uint8_t len[MESH_MOCK_QUEUE];
+    uint32_t due_us[MESH_MOCK_QUEUE];       // Delivery time
+    uint8_t head;
+    uint8_t count;
+} MeshMockInbox;
+
+/**
+ * @brief In-process broadcast medium with a delay and losses
+ */
+typedef struct {
+    MeshMockInbox inbox[MESH_MOCK_MAX_NODES];
+    uint8_t nodes;
+    uint32_t now_us;                // Set by the test
+    uint32_t delay_us;              // Added to every packet
+    uint32_t jitter_us;             // Extra delay of every other packet per node
+    uint8_t drop_every;             // Drop every Nth packet (0 = none)
+    uint32_t sent;
+} MeshMockHub;
+
+/**
+ * @brief Endpoint of one node on a hub
+ */
+typedef struct {
+    MeshMockHub* hub;
+    uint8_t index;
+    uint32_t sent;                  // This node's packets (jitter applies to odd ones)
+} MeshMockPort;
+
+/**
+ * @brief Initialize an empty hub
+ */
+void mesh_mock_init(MeshMockHub* hub, uint8_t nodes, uint32_t delay_us);
+
+/**
+ * @brief Fill a backend for one node of a hub
+ * @param port Endpoint state (must outlive the backend)
+ */
+void mesh_mock_backend(MeshMockHub* hub, uint8_t index, MeshMockPort* port, MeshBackend* backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_MESH_H
@@ -0,0 +1,226 @@
+/**
+ * @file ucf_metrics.h
+ * @brief UCF Metrics Registry v4.0.0
+ *
+ * One place for the runtime telemetry the fleet dashboards read: error
+ * counts, drop counts, loop and sensor rates, event counts and latency
+ * histograms. Every metric is a MetricId below; its kind follows from the
+ * range it sits in (counters, then gauges, then histograms) and its name
+ * from the table in ucf_metrics.cpp, so the registry is fixed at compile
+ * time and needs no allocation or registration calls.
+ *
+ * - Counter: monotonic uint32 (wraps; readers take differences)
+ * - Gauge: latest float value
+ * - Histogram: count, sum and METRICS_HIST_BUCKETS power-of-two buckets
+ *
+ * Updates are relaxed atomics, so any core may write any metric without
+ * locks. A snapshot reads each value atomically but not all of them at
+ * the same instant.
+ *
+ * Exports:
+ * - Text (serial 'x'): one "name value" line per value, histogram buckets
+ *   cumulative as name_bucket{le="N"}
+ * - Binary (protocol METRICS message): see metrics_encode()
+ *
+ * MetricIds are part of the binary format: append new metrics at the end
+ * of their group and bump METRICS_FORMAT_VERSION if one is removed.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_METRICS_H
+#define UCF_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// METRICS CONSTANTS
+// ============================================================================
+
+#define METRICS_FORMAT_VERSION      1
+#define METRICS_HIST_BUCKETS        16      // 0, 1, 2-3, ... 8192-16383, >=16384
+#define METRICS_HEADER_SIZE         6       // Version, count, uptime
+#define METRICS_MAX_ENCODED         512     // Fits one BLE payload
+#define METRICS_LINE_MAX            64
+
+/**
+ * @brief Metric kind
+ */
+typedef enum {
+    METRIC_TYPE_COUNTER = 0,
+    METRIC_TYPE_GAUGE = 1,
+    METRIC_TYPE_HISTOGRAM = 2
+} MetricType;
+
+/**
+ * @brief Metric identifiers (grouped by kind, stable wire ids)
+ */
+typedef enum {
+    // Counters
+    METRIC_I2C_ERRORS = 0,          // Failed I2C transactions
+    METRIC_SENSOR_ERRORS,           // Sensor health check failures
+    METRIC_VALIDATION_ERRORS,       // Conservation law violations
+    METRIC_TRIAD_UNLOCKS,
+    METRIC_K_FORMATIONS,
+    METRIC_SYNC_EVENTS,             // Kuramoto synchronization events
+    METRIC_FRAMES_DROPPED,          // Session frames refused by the cross-core queue
+    METRIC_EVENTS_DROPPED,          // Events refused by the cross-core queue
+    METRIC_SESSION_DROPPED,         // Records the session log could not store
+    METRIC_LOG_DROPPED,             // Log records refused by a full ring
+    METRIC_OUTPUT_WRITES,           // Digipot and indicator writes
+    METRIC_OUTPUT_WRITES_AVOIDED,   // Output sets that matched the hardware
+    METRIC_KURAMOTO_OVERRUNS,       // Kuramoto runs that hit the catch-up cap
+    METRIC_KURAMOTO_STEPS_DROPPED,  // Kuramoto steps beyond the cap
+    METRIC_MESH_LOST,               // Mesh summaries missing from peers' sequences
+    METRIC_KURAMOTO_MISSES,         // Kuramoto runs finished after their 1 ms deadline
+
+    // Gauges
+    METRIC_FIRST_GAUGE,
+    METRIC_LOOP_RATE_HZ = METRIC_FIRST_GAUGE,   // Real-time scheduler passes
+    METRIC_SENSOR_RATE_HZ,
+    METRIC_ORDER_PARAM,             // Kuramoto r
+    METRIC_OTA_BYTES,               // Bytes received by the current transfer
+    METRIC_HEAP_FREE,               // Device heap (flat once running)
+    METRIC_HEAP_MIN_FREE,           // Lowest heap_free since boot
+    METRIC_MESH_PEERS,              // Devices heard within the peer timeout
+
+    // Histograms
+    METRIC_FIRST_HISTOGRAM,
+    METRIC_SENSOR_READ_US = METRIC_FIRST_HISTOGRAM,  // sensors_update() duration
+
+    METRIC_COUNT
+} MetricId;
+
+#define METRICS_HISTOGRAM_COUNT     (METRIC_COUNT - METRIC_FIRST_HISTOGRAM)
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Histogram snapshot
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t sum;                   // Wraps like a counter
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+} MetricHistogram;
+
+/**
+ * @brief Text export sink (one line, no newline)
+ */
+typedef void (*MetricsLineFn)(const char* line, void* ctx);
+
+// ============================================================================
+// UPDATE API
+// ============================================================================
+
+/**
+ * @brief Zero every metric
+ */
+void metrics_init(void);
+
+/**
+ * @brief Add to a counter (ignored for other kinds)
+ */
+void metrics_count(MetricId id, uint32_t n);
+
+/**
+ * @brief Set a counter to a total kept elsewhere (e.g. a queue's drop count)
+ */
+void metrics_set_total(MetricId id, uint32_t total);
+
+/**
+ * @brief Set a gauge (ignored for other kinds)
+ */
+void metrics_set(MetricId id, float value);
+
+/**
+ * @brief Add one sample to a histogram (ignored for other kinds)
+ */
+void metrics_observe(MetricId id, uint32_t value);
+
+// ============================================================================
+// READ API
+// ============================================================================
+
+/**
+ * @brief Get a metric's kind
+ */
+MetricType metrics_type(MetricId id);
+
+/**
+ * @brief Get a metric's export name
+ */
+const char* metrics_name(MetricId id);
+
+/**
+ * @brief Read a counter (0 for other kinds)
+ */
+uint32_t metrics_counter(MetricId id);
+
+/**
+ * @brief Read a gauge (0 for other kinds)
+ */
+float metrics_gauge(MetricId id);
+
+/**
+ * @brief Read a histogram
+ * @param id Histogram metric
+ * @param out Output snapshot
+ * @return false if id is not a histogram
+ */
+bool metrics_histogram(MetricId id, MetricHistogram* out);
+
+/**
+ * @brief Map a sample to its histogram bucket
+ */
+uint8_t metrics_bucket_index(uint32_t value);
+
+/**
+ * @brief Get the largest sample in a bucket (UINT32_MAX for the last)
+ */
+uint32_t metrics_bucket_upper(uint8_t bucket);
+
+// ============================================================================
+// EXPORT API
+// ============================================================================
+
+/**
+ * @brief Encode a snapshot of every metric
+ *
+ * Little-endian; varints are LEB128:
+ *
+ *   [0]    METRICS_FORMAT_VERSION
+ *   [1]    METRIC_COUNT
+ *   [2-5]  Uptime (ms)
+ *   then per metric, in MetricId order:
+ *     counter:   varint value
+ *     gauge:     float32
+ *     histogram: varint count, varint sum, METRICS_HIST_BUCKETS varints
+ *
+ * @param buffer Output
+ * @param capacity Output size (METRICS_MAX_ENCODED is always enough)
+ * @param uptime_ms Device uptime at the snapshot
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t metrics_encode(uint8_t* buffer, size_t capacity, uint32_t uptime_ms);
+
+/**
+ * @brief Write every metric as text lines
+ * @param fn Called once per line
+ * @param ctx Passed to fn
+ */
+void metrics_write_text(MetricsLineFn fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_METRICS_H
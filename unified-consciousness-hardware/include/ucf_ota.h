@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "ucf/ucf_sacred_constants_v4.h"
 
 #ifdef __cplusplus
@@ -141,6 +142,66 @@ OTAStatus ota_start_update(const char* url);
  */
 OTAStatus ota_process(void);
 
+/**
+ * @brief Begin a streamed update from a custom transport
+ *
+ * Every chunk passed to ota_stream_write() is verified (lattice signature,
+ * SHA-256, CRC32) before it is written, and the image only becomes bootable
+ * if the verdict on the last byte is positive.
+ *
+ * @param size Total image size in bytes
+ * @param expected_sha256 Manifest digest of the whole image (NULL to use the
+ *        digest ESP-IDF appends to the image)
+ * @return true if the update partition was opened
+ */
+bool ota_stream_begin(uint32_t size, const uint8_t* expected_sha256);
+
+/**
+ * @brief Verify and write the next chunk of a streamed update
+ * @param data Chunk data
+ * @param len Chunk length
+ * @return OTA_STATUS_DOWNLOADING, OTA_STATUS_APPLYING once the image is
+ *         accepted, or an error status
+ */
+OTAStatus ota_stream_write(const uint8_t* data, size_t len);
+
+/**
+ * @brief Close a streamed update (reboots into it if accepted and auto_reboot)
+ * @return Final status
+ */
+OTAStatus ota_stream_end(void);
+
+/**
+ * @brief Begin a delta update (patch produced by tools/ota_delta_host.cpp)
+ *
+ * The patch is applied against the running partition as it arrives and the
+ * reconstructed image is fed through ota_stream_write(), so it is verified
+ * exactly like a full image. RAM use is independent of image size.
+ *
+ * @return true if a delta update can start
+ */
+bool ota_patch_begin(void);
+
+/**
+ * @brief Apply the next chunk of a delta patch
+ * @param data Patch data
+ * @param len Chunk length
+ * @return Current status (as for ota_stream_write())
+ */
+OTAStatus ota_patch_write(const uint8_t* data, size_t len);
+
+/**
+ * @brief Close a delta update (reboots into it if accepted and auto_reboot)
+ * @return Final status
+ */
+OTAStatus ota_patch_end(void);
+
+/**
+ * @brief Get the validation record of the most recently verified image
+ * @return Validation result
+ */
+const LatticeValidation* ota_get_last_validation(void);
+
 /**
  * @brief Validate downloaded firmware
  * @return Validation result
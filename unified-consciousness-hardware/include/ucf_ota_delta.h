@@ -0,0 +1,182 @@
+/**
+ * @file ucf_ota_delta.h
+ * @brief UCF Delta OTA Patch Decoder v4.0.0
+ *
+ * Applies a binary patch against the running firmware image to reconstruct
+ * the new image, so only the difference between two builds is transferred.
+ *
+ * Patch format (all integers little-endian, lengths LEB128 varints):
+ *
+ *   Header (80 bytes):
+ *     magic "UCFD" | version u16 | flags u16 | old_size u32 | new_size u32 |
+ *     old_sha256[32] | new_sha256[32]
+ *
+ *   Operations (bsdiff-style, old cursor starts at 0):
+ *     COPY   len          new += old[pos..pos+len), pos += len
+ *     ADD    len, bytes   new += old[pos+i] + bytes[i], pos += len
+ *     INSERT len, bytes   new += bytes
+ *     SEEK   zigzag delta pos += delta
+ *     END
+ *
+ * The decoder is a push parser: the patch can arrive in chunks of any size
+ * and RAM use is fixed (one OTA_DELTA_BLOCK_SIZE output block). Old image
+ * bytes are pulled through a read callback, reconstructed bytes are pushed
+ * to a write callback (on device: ota_stream_write(), which verifies them).
+ *
+ * Platform independent; the patch generator is tools/ota_delta_host.cpp.
+ */
+
+#ifndef UCF_OTA_DELTA_H
+#define UCF_OTA_DELTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PATCH FORMAT CONSTANTS
+// ============================================================================
+
+#define OTA_DELTA_MAGIC             0x44464355  // "UCFD"
+#define OTA_DELTA_VERSION           1
+#define OTA_DELTA_HEADER_SIZE       80
+#define OTA_DELTA_DIGEST_SIZE       32
+
+// Operation codes
+#define OTA_DELTA_OP_END            0x00
+#define OTA_DELTA_OP_COPY           0x01
+#define OTA_DELTA_OP_ADD            0x02
+#define OTA_DELTA_OP_INSERT         0x03
+#define OTA_DELTA_OP_SEEK           0x04
+
+// Output block size (bounds decoder RAM and read/write granularity)
+#define OTA_DELTA_BLOCK_SIZE        256
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Decoder status
+ */
+typedef enum {
+    OTA_DELTA_PENDING = 0,          // More patch data expected
+    OTA_DELTA_DONE,                 // END reached, new image complete
+    OTA_DELTA_ERR_HEADER,           // Bad magic/version
+    OTA_DELTA_ERR_BASE,             // Base image rejected by begin callback
+    OTA_DELTA_ERR_FORMAT,           // Unknown opcode, bad varint, data after END
+    OTA_DELTA_ERR_RANGE,            // Old cursor or output outside declared sizes
+    OTA_DELTA_ERR_READ,             // Old image read failed
+    OTA_DELTA_ERR_WRITE,            // Output sink rejected data
+    OTA_DELTA_ERR_TRUNCATED         // Patch ended before END
+} OTADeltaStatus;
+
+/**
+ * @brief Decoded patch header
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint32_t old_size;
+    uint32_t new_size;
+    uint8_t old_sha256[OTA_DELTA_DIGEST_SIZE];  // Base image the patch was built against
+    uint8_t new_sha256[OTA_DELTA_DIGEST_SIZE];  // Reconstructed image
+} OTADeltaHeader;
+
+/**
+ * @brief Decoder I/O callbacks
+ */
+typedef struct {
+    bool (*begin)(const OTADeltaHeader* header, void* ctx);
+    bool (*read_old)(uint32_t offset, uint8_t* buf, size_t len, void* ctx);
+    bool (*write_new)(const uint8_t* data, size_t len, void* ctx);
+    void* ctx;
+} OTADeltaIO;
+
+/**
+ * @brief Streaming patch decoder state
+ */
+typedef struct {
+    OTADeltaIO io;
+    OTADeltaHeader header;
+    uint8_t header_buf[OTA_DELTA_HEADER_SIZE];
+    uint8_t header_len;
+
+    // Operation parser
+    uint8_t state;
+    uint8_t opcode;
+    uint32_t varint;
+    uint8_t varint_shift;
+    uint32_t remaining;             // Bytes left in current ADD/INSERT
+
+    // Cursors
+    uint32_t old_pos;
+    uint32_t new_pos;               // Bytes reconstructed (including unflushed)
+    uint32_t patch_bytes;
+
+    // Output block
+    uint8_t block[OTA_DELTA_BLOCK_SIZE];
+    uint16_t block_len;
+
+    OTADeltaStatus status;
+} OTADeltaDecoder;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Initialize a patch decoder
+ * @param d Decoder state
+ * @param io I/O callbacks (begin may be NULL)
+ */
+void ota_delta_init(OTADeltaDecoder* d, const OTADeltaIO* io);
+
+/**
+ * @brief Feed the next chunk of patch data
+ * @param d Decoder state
+ * @param data Patch bytes
+ * @param len Chunk length
+ * @return OTA_DELTA_PENDING, OTA_DELTA_DONE, or an error
+ */
+OTADeltaStatus ota_delta_update(OTADeltaDecoder* d, const uint8_t* data, size_t len);
+
+/**
+ * @brief Signal end of patch data
+ * @param d Decoder state
+ * @return OTA_DELTA_DONE if the patch was complete, otherwise an error
+ */
+OTADeltaStatus ota_delta_finish(OTADeltaDecoder* d);
+
+/**
+ * @brief Serialize a patch header
+ * @param header Header to encode
+ * @param out Output buffer of OTA_DELTA_HEADER_SIZE bytes
+ */
+void ota_delta_encode_header(const OTADeltaHeader* header, uint8_t* out);
+
+/**
+ * @brief Parse a patch header
+ * @param in OTA_DELTA_HEADER_SIZE bytes
+ * @param header Output header
+ * @return true if magic and version are supported
+ */
+bool ota_delta_decode_header(const uint8_t* in, OTADeltaHeader* header);
+
+/**
+ * @brief Get human-readable decoder status
+ * @param status Status code
+ * @return Status string
+ */
+const char* ota_delta_status_string(OTADeltaStatus status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_OTA_DELTA_H
@@ -0,0 +1,290 @@
+/**
+ * @file ucf_ota_task.h
+ * @brief UCF Background OTA Transfer Scheduler v4.0.0
+ *
+ * Moves firmware download and flash programming out of the control loop.
+ * A transfer pulls chunks from a transport and pushes them into a sink
+ * (on device: the verified ota_stream_* / ota_patch_* paths) in short,
+ * budgeted slices:
+ *
+ * - Chunked writes of at most OTA_TASK_MAX_CHUNK bytes
+ * - Bandwidth budget (token bucket, bytes per second)
+ * - CPU budget (slice length and duty cycle)
+ * - Pause/resume at slice boundaries
+ *
+ * ota_task_step() returns how long the caller should sleep before the next
+ * slice. On the ESP32 it is driven by a low-priority FreeRTOS task on the
+ * protocol core (see ota_background_start()); on the host it is driven by
+ * tests and tools/ota_task_host.cpp with a virtual clock.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_OTA_TASK_H
+#define UCF_OTA_TASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_ota.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// TASK CONSTANTS
+// ============================================================================
+
+#define OTA_TASK_MAX_CHUNK          1460    // One TCP segment
+#define OTA_TASK_POLL_US            20000   // Sleep hint while idle or paused
+#define OTA_TASK_STARVED_US         2000    // Retry delay when the transport has no data
+
+// Default budget: well under one 1 kHz control tick per slice
+#define OTA_TASK_DEFAULT_CHUNK      512
+#define OTA_TASK_DEFAULT_BPS        (64 * 1024)
+#define OTA_TASK_DEFAULT_SLICE_US   400
+#define OTA_TASK_DEFAULT_DUTY       25
+
+// Transport read() results besides a positive byte count
+#define OTA_TRANSPORT_WOULD_BLOCK   0
+#define OTA_TRANSPORT_EOF           (-1)
+#define OTA_TRANSPORT_ERROR         (-2)
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Transfer description reported by the transport when opened
+ */
+typedef struct {
+    uint32_t size;                  // Payload size (image or patch)
+    bool is_delta;                  // Payload is a UCFD patch
+    bool has_sha256;                // sha256 holds a manifest digest
+    uint8_t sha256[32];
+} OTATransferInfo;
+
+/**
+ * @brief Source of update bytes (network client, file, test buffer)
+ */
+typedef struct {
+    bool (*open)(OTATransferInfo* info, void* ctx);
+    int32_t (*read)(uint8_t* buf, size_t max_len, void* ctx);
+    void (*close)(void* ctx);
+    void* ctx;
+} OTATransport;
+
+/**
+ * @brief Destination of update bytes
+ *
+ * write() returns OTA_STATUS_DOWNLOADING to continue, OTA_STATUS_APPLYING
+ * once the image is accepted, or an error status.
+ */
+typedef struct {
+    bool (*begin)(const OTATransferInfo* info, void* ctx);
+    OTAStatus (*write)(const uint8_t* data, size_t len, void* ctx);
+    OTAStatus (*end)(void* ctx);
+    void* ctx;
+} OTASink;
+
+/**
+ * @brief Transfer budget
+ */
+typedef struct {
+    uint16_t chunk_size;            // Bytes per sink write (<= OTA_TASK_MAX_CHUNK)
+    uint32_t bytes_per_sec;         // Bandwidth budget (0 = unlimited)
+    uint32_t slice_us;              // Maximum CPU time per slice
+    uint8_t duty_percent;           // CPU share while transferring (1-100)
+} OTATaskConfig;
+
+/**
+ * @brief Transfer state
+ */
+typedef enum {
+    OTA_TASK_IDLE = 0,
+    OTA_TASK_RUNNING,
+    OTA_TASK_PAUSED,
+    OTA_TASK_DONE,
+    OTA_TASK_FAILED
+} OTATaskState;
+
+/**
+ * @brief Transfer statistics
+ */
+typedef struct {
+    uint32_t bytes;                 // Payload bytes delivered to the sink
+    uint32_t slices;                // Slices that did work
+    uint32_t max_slice_us;          // Longest slice
+    uint64_t busy_us;               // Total time spent in slices
+    uint32_t starved;               // Slices with no data from the transport
+} OTATaskStats;
+
+/**
+ * @brief Background transfer state
+ */
+typedef struct {
+    OTATaskConfig config;
+    uint32_t (*clock_us)(void);
+
+    OTATransport transport;
+    OTASink sink;
+    OTATransferInfo info;
+
+    volatile uint8_t state;         // OTATaskState, written from both cores
+    OTAStatus result;
+
+    // Token bucket
+    uint32_t tokens;
+    uint32_t last_refill_us;
+    uint32_t next_run_us;
+
+    OTATaskStats stats;
+    uint8_t buffer[OTA_TASK_MAX_CHUNK];
+} OTATask;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Fill a configuration with the default budget
+ * @param config Output configuration
+ */
+void ota_task_default_config(OTATaskConfig* config);
+
+/**
+ * @brief Initialize a transfer scheduler
+ * @param t Task state
+ * @param config Budget (NULL for defaults)
+ * @param clock_us Monotonic microsecond clock (micros() on device)
+ */
+void ota_task_init(OTATask* t, const OTATaskConfig* config, uint32_t (*clock_us)(void));
+
+/**
+ * @brief Change the budget of a running transfer
+ * @param t Task state
+ * @param config New budget
+ */
+void ota_task_set_config(OTATask* t, const OTATaskConfig* config);
+
+/**
+ * @brief Open the transport and start a transfer
+ * @param t Task state
+ * @param transport Byte source
+ * @param sink Byte destination
+ * @return true if the transfer started
+ */
+bool ota_task_start(OTATask* t, const OTATransport* transport, const OTASink* sink);
+
+/**
+ * @brief Run one budgeted slice of the transfer
+ * @param t Task state
+ * @return Microseconds to sleep before the next call
+ */
+uint32_t ota_task_step(OTATask* t);
+
+/**
+ * @brief Pause after the current slice (safe to call from another core)
+ * @param t Task state
+ */
+void ota_task_pause(OTATask* t);
+
+/**
+ * @brief Resume a paused transfer
+ * @param t Task state
+ */
+void ota_task_resume(OTATask* t);
+
+/**
+ * @brief Abandon the transfer and close the transport
+ *
+ * Must be called from the context that runs ota_task_step().
+ *
+ * @param t Task state
+ */
+void ota_task_abort(OTATask* t);
+
+/**
+ * @brief Get transfer state
+ * @param t Task state
+ * @return Current state
+ */
+OTATaskState ota_task_get_state(const OTATask* t);
+
+/**
+ * @brief Get human-readable task state
+ * @param state State code
+ * @return State string
+ */
+const char* ota_task_state_string(OTATaskState state);
+
+// ============================================================================
+// DEVICE BACKGROUND TASK (ucf_ota.cpp)
+// ============================================================================
+
+/**
+ * @brief Start the background OTA task
+ *
+ * After this call ArduinoOTA is serviced by the task and ota_handle()
+ * becomes a no-op, so transfers never run inside loop().
+ *
+ * @param config Transfer budget (NULL for defaults)
+ * @return true if the task is running
+ */
+bool ota_background_init(const OTATaskConfig* config);
+
+/**
+ * @brief Queue a pull transfer from a custom transport
+ * @param transport Byte source (copied)
+ * @return true if accepted
+ */
+bool ota_background_start(const OTATransport* transport);
+
+/**
+ * @brief Check whether any update is in progress
+ * @return true while a transfer is running, paused or being applied
+ */
+bool ota_background_busy(void);
+
+/**
+ * @brief Pause transfers (pull or ArduinoOTA) until resumed
+ *
+ * Applied by the background task on its next pass; a transfer started
+ * while paused waits for ota_background_resume().
+ */
+void ota_background_pause(void);
+
+/**
+ * @brief Resume a paused transfer
+ */
+void ota_background_resume(void);
+
+/**
+ * @brief Check whether transfers are paused
+ * @return true if paused
+ */
+bool ota_background_is_paused(void);
+
+/**
+ * @brief Abandon the current transfer
+ */
+void ota_background_abort(void);
+
+/**
+ * @brief Change the transfer budget (applied by the task on its next pass)
+ * @param config New budget (copied)
+ */
+void ota_background_set_config(const OTATaskConfig* config);
+
+/**
+ * @brief Get statistics of the current or last pull transfer
+ * @return Transfer statistics
+ */
+const OTATaskStats* ota_background_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_OTA_TASK_H
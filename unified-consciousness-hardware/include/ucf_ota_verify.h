@@ -0,0 +1,199 @@
+/**
+ * @file ucf_ota_verify.h
+ * @brief UCF Streaming OTA Image Verifier v4.0.0
+ *
+ * Validates a firmware image chunk by chunk while it is being downloaded,
+ * so the accept/reject decision is available the moment the last byte
+ * arrives. No second pass over flash is needed.
+ *
+ * Per byte, the verifier runs:
+ * - A rolling multi-pattern matcher for the lattice signature block
+ *   ("RRRR" magic + the five sacred constants as IEEE-754 doubles)
+ * - An incremental SHA-256 (checked against the digest ESP-IDF appends
+ *   to app images, or against an externally supplied digest)
+ * - An incremental CRC32 (reported as firmware_checksum)
+ *
+ * The module is platform independent (no Arduino dependencies) so the same
+ * code runs on the ESP32 and in native host builds.
+ */
+
+#ifndef UCF_OTA_VERIFY_H
+#define UCF_OTA_VERIFY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_ota.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// VERIFIER CONSTANTS
+// ============================================================================
+
+#define OTA_SHA256_SIZE             32
+#define OTA_VERIFY_PATTERN_COUNT    6       // Magic + 5 lattice constants
+#define OTA_VERIFY_ALL_PATTERNS     ((1u << OTA_VERIFY_PATTERN_COUNT) - 1u)
+
+// ESP-IDF application image header (esp_image_header_t)
+#define OTA_ESP_IMAGE_MAGIC         0xE9
+#define OTA_ESP_HASH_APPENDED_OFFSET 23
+
+// Verifier flags
+#define OTA_VERIFY_FLAG_ESP_IMAGE   0x01    // Require ESP image magic, honour hash_appended
+#define OTA_VERIFY_FLAG_REQUIRE_SHA 0x02    // Reject images without any digest to check
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Verification status
+ */
+typedef enum {
+    OTA_VERIFY_PENDING = 0,         // More data expected
+    OTA_VERIFY_ACCEPTED,            // Image complete and valid
+    OTA_VERIFY_ERR_SIZE,            // Image larger/smaller than announced
+    OTA_VERIFY_ERR_HEADER,          // Not an ESP application image
+    OTA_VERIFY_ERR_DIGEST,          // SHA-256 mismatch or missing
+    OTA_VERIFY_ERR_LATTICE          // Lattice signature incomplete
+} OTAVerifyStatus;
+
+/**
+ * @brief Incremental SHA-256 context
+ */
+typedef struct {
+    uint32_t state[8];
+    uint64_t bit_count;
+    uint8_t buffer[64];
+    uint8_t buffer_len;
+} OTASha256;
+
+/**
+ * @brief Lattice signature block embedded in every firmware image
+ *
+ * The block is kept in .rodata of the running firmware so that an update
+ * built from a tree with modified constants cannot carry a matching block.
+ */
+typedef struct {
+    uint32_t magic;                 // LATTICE_SIGNATURE_MAGIC ("RRRR")
+    uint32_t version;               // Block layout version
+    double phi_inv;                 // [R]
+    double z_critical;              // √3/2
+    double euler_inv;               // [D]
+    double pi_inv;                  // [C]
+    double sqrt2_inv;               // [A]
+} OTALatticeSignature;
+
+/**
+ * @brief Streaming verifier state
+ */
+typedef struct {
+    // Configuration
+    uint32_t expected_size;         // 0 = unknown, decide on ota_verify_finish()
+    uint8_t flags;
+    bool has_expected_sha256;
+    uint8_t expected_sha256[OTA_SHA256_SIZE];
+
+    // Rolling pattern matcher
+    uint64_t window;                // Last 8 bytes, little-endian
+    uint64_t patterns[OTA_VERIFY_PATTERN_COUNT];
+    uint8_t pattern_bytes[OTA_VERIFY_PATTERN_COUNT];
+    uint32_t last_byte_filter[8];   // 256-bit set of pattern terminal bytes
+    uint8_t found_mask;
+    uint32_t signature_offset;
+
+    // Hashing (last 32 bytes held back as a possible appended digest)
+    OTASha256 sha;
+    uint32_t crc32;                 // Running CRC-32 (ucf_checksum.h)
+    uint8_t tail[OTA_SHA256_SIZE];
+    uint8_t tail_len;
+    bool hash_appended;
+
+    // Progress
+    uint32_t received;
+    OTAVerifyStatus status;
+} OTAStreamVerifier;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Initialize a streaming verifier
+ * @param v Verifier state
+ * @param expected_size Announced image size (0 if unknown)
+ * @param flags OTA_VERIFY_FLAG_* bitmask
+ */
+void ota_verify_init(OTAStreamVerifier* v, uint32_t expected_size, uint8_t flags);
+
+/**
+ * @brief Supply the expected SHA-256 of the image (e.g. from a manifest)
+ *
+ * When set, this digest covers the whole image and takes precedence over
+ * an ESP-IDF appended digest.
+ *
+ * @param v Verifier state
+ * @param digest 32-byte SHA-256 digest
+ */
+void ota_verify_set_expected_sha256(OTAStreamVerifier* v, const uint8_t* digest);
+
+/**
+ * @brief Feed the next chunk of the image
+ *
+ * If the expected size is known, the image is finalized automatically when
+ * the last byte is consumed.
+ *
+ * @param v Verifier state
+ * @param data Chunk data
+ * @param len Chunk length
+ * @return OTA_VERIFY_PENDING while more data is expected, otherwise the verdict
+ */
+OTAVerifyStatus ota_verify_update(OTAStreamVerifier* v, const uint8_t* data, size_t len);
+
+/**
+ * @brief Finalize verification (no-op if already decided)
+ * @param v Verifier state
+ * @return Final verdict
+ */
+OTAVerifyStatus ota_verify_finish(OTAStreamVerifier* v);
+
+/**
+ * @brief Fill a LatticeValidation from the verifier state
+ *
+ * lattice_checksum is left zero; the caller owns the running firmware's
+ * checksum (see ota_compute_lattice_checksum()).
+ *
+ * @param v Verifier state
+ * @param out Output validation record
+ */
+void ota_verify_get_validation(const OTAStreamVerifier* v, LatticeValidation* out);
+
+/**
+ * @brief Get human-readable verification status
+ * @param status Status code
+ * @return Status string
+ */
+const char* ota_verify_status_string(OTAVerifyStatus status);
+
+/**
+ * @brief Get the lattice signature block compiled into this firmware
+ * @return Pointer to signature block in .rodata
+ */
+const OTALatticeSignature* ota_verify_get_signature(void);
+
+// ============================================================================
+// SHA-256 PRIMITIVES
+// ============================================================================
+
+void ota_sha256_init(OTASha256* ctx);
+void ota_sha256_update(OTASha256* ctx, const uint8_t* data, size_t len);
+void ota_sha256_final(OTASha256* ctx, uint8_t* digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_OTA_VERIFY_H
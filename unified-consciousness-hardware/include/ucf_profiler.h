@@ -0,0 +1,194 @@
+/**
+ * @file ucf_profiler.h
+ * @brief UCF Module Profiler v4.0.0
+ *
+ * Scoped timing probes around the per-frame module calls (field read,
+ * K-Formation, Kuramoto step, LED update, sigil match). Each probe keeps
+ * exact min/max/total and a log-linear histogram of its durations, from
+ * which p50/p99 are read back to within a quarter octave.
+ *
+ * Time source:
+ * - ESP32 (Xtensa): the CCOUNT cycle counter, one tick per CPU cycle.
+ *   CCOUNT is per core; every probe begins and ends on the same core.
+ * - Host: std::chrono::steady_clock in nanoseconds. rdtsc is not used
+ *   because its rate is not known without calibration.
+ *
+ * Each probe is meant to be recorded from one core. A dump from the other
+ * core ('f' command, PROFILE_RESPONSE) is a best-effort snapshot.
+ *
+ * Everything compiles out when UCF_PROFILE is 0, which is the default for
+ * production builds (UCF_PRODUCTION): PROF_SCOPE() expands to nothing and
+ * the API reports no samples.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_PROFILER_H
+#define UCF_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef UCF_PROFILE
+#if defined(UCF_PRODUCTION) && UCF_PRODUCTION
+#define UCF_PROFILE 0
+#else
+#define UCF_PROFILE 1
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PROFILER CONSTANTS
+// ============================================================================
+
+#define PROF_SUB_BUCKETS            4       // Histogram buckets per octave
+#define PROF_BUCKETS                124     // Covers the full 32-bit range
+
+#define PROF_HOST_TICKS_PER_US      1000    // steady_clock nanoseconds
+
+/**
+ * @brief Probe identifiers (one per instrumented call)
+ */
+typedef enum {
+    PROF_READ_FIELD = 0,            // HexGrid::readField
+    PROF_K_FORMATION,               // KFormation::update
+    PROF_KURAMOTO_STEP,             // KuramotoStabilizer::step
+    PROF_LEDS_UPDATE,               // leds_update
+    PROF_SIGIL_MATCH,               // SigilROM::findMatchingSigil
+    PROF_SENSORS_UPDATE,            // sensors_update
+    PROF_PHASE_UPDATE,              // PhaseEngine::update
+    PROF_EMANATION_UPDATE,          // Emanation::update
+    PROF_PROBE_COUNT
+} ProfProbe;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Duration summary of one probe (nanoseconds)
+ */
+typedef struct {
+    uint32_t count;                 // Samples since the last reset
+    uint32_t min_ns;
+    uint32_t mean_ns;
+    uint32_t p50_ns;                // Histogram estimate
+    uint32_t p99_ns;                // Histogram estimate
+    uint32_t max_ns;
+} ProfSummary;
+
+// ============================================================================
+// TIME SOURCE
+// ============================================================================
+
+#if defined(__XTENSA__)
+/**
+ * @brief Read the current core's cycle counter
+ */
+static inline uint32_t prof_ticks(void) {
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+}
+#else
+/**
+ * @brief Read the host clock (nanoseconds, wraps every 4.29 s)
+ */
+uint32_t prof_ticks(void);
+#endif
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+/**
+ * @brief Clear all probes and set the tick rate
+ * @param ticks_per_us CPU MHz on the ESP32, PROF_HOST_TICKS_PER_US on the host
+ */
+void prof_init(uint32_t ticks_per_us);
+
+/**
+ * @brief Add one duration to a probe
+ * @param probe Probe identifier
+ * @param ticks Duration in prof_ticks() units
+ */
+void prof_record(ProfProbe probe, uint32_t ticks);
+
+/**
+ * @brief Summarize a probe
+ * @param probe Probe identifier
+ * @param summary Output (all zero if the probe has no samples)
+ * @return true if the probe has samples
+ */
+bool prof_get(ProfProbe probe, ProfSummary* summary);
+
+/**
+ * @brief Estimate a percentile of a probe's durations
+ * @param probe Probe identifier
+ * @param percent 0-100
+ * @return Upper bound of the bucket holding the percentile (ns), 0 if empty
+ */
+uint32_t prof_percentile(ProfProbe probe, float percent);
+
+/**
+ * @brief Clear every probe's samples (keeps the tick rate)
+ */
+void prof_reset(void);
+
+/**
+ * @brief Get a probe's name
+ */
+const char* prof_probe_name(ProfProbe probe);
+
+/**
+ * @brief Map a duration to its histogram bucket
+ */
+uint8_t prof_bucket_index(uint32_t ticks);
+
+/**
+ * @brief Get the largest duration that maps to a bucket
+ */
+uint32_t prof_bucket_upper(uint8_t bucket);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ============================================================================
+// SCOPED PROBES (C++)
+// ============================================================================
+
+#ifdef __cplusplus
+
+#define PROF_CONCAT_(a, b)  a##b
+#define PROF_CONCAT(a, b)   PROF_CONCAT_(a, b)
+
+#if UCF_PROFILE
+/**
+ * @brief Records the lifetime of the enclosing scope into a probe
+ */
+class ProfScope {
+public:
+    explicit ProfScope(ProfProbe probe) : probe_(probe), start_(prof_ticks()) {}
+    ~ProfScope() { prof_record(probe_, prof_ticks() - start_); }
+
+    ProfScope(const ProfScope&) = delete;
+    ProfScope& operator=(const ProfScope&) = delete;
+
+private:
+    ProfProbe probe_;
+    uint32_t start_;
+};
+
+#define PROF_SCOPE(probe)   ProfScope PROF_CONCAT(prof_scope_, __LINE__)(probe)
+#else
+#define PROF_SCOPE(probe)   do {} while (0)
+#endif
+
+#endif // __cplusplus
+
+#endif // UCF_PROFILER_H
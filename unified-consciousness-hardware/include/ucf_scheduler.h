@@ -0,0 +1,237 @@
+/**
+ * @file ucf_scheduler.h
+ * @brief UCF Cooperative Loop Scheduler v4.0.0
+ *
+ * Runs the periodic work of loop() (Kuramoto steps, sensor reads, LEDs,
+ * status output, storage) as tasks with:
+ *
+ * - Fixed periods on an absolute release grid (no drift)
+ * - Priorities: of the tasks due, the highest priority runs first, the
+ *   earliest deadline breaks ties
+ * - A relative deadline and CPU budget per task
+ * - Statistics: deadline misses, budget overruns, dropped releases,
+ *   execution time and release jitter
+ * - A catch-up cap: a late task runs at most max_catchup extra times back
+ *   to back, older releases are dropped and counted
+ *
+ * Tasks are never preempted; a task that overruns its budget delays the
+ * others and shows up in their jitter and misses. sched_run() returns once
+ * nothing is due, or after SCHED_MAX_DISPATCH runs when overloaded, so
+ * loop() always gets control back.
+ *
+ * A run hook, when set, sees every task run and the end of every
+ * sched_run() pass; host tools time the loop with it (the native HAL's
+ * --loop-report).
+ *
+ * The clock is a microsecond function (micros() on device). Host tests use
+ * the virtual clock below: tasks "take time" by calling
+ * sched_virtual_advance(), and sched_run_virtual() jumps idle gaps.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_SCHEDULER_H
+#define UCF_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SCHEDULER CONSTANTS
+// ============================================================================
+
+#define SCHED_MAX_TASKS             12
+#define SCHED_MAX_DISPATCH          32      // Task runs per sched_run() call
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Task body
+ * @param now_us Clock when the task started
+ * @param ctx Task context
+ */
+typedef void (*SchedTaskFn)(uint32_t now_us, void* ctx);
+
+/**
+ * @brief Run hook events
+ */
+typedef enum {
+    SCHED_HOOK_BEGIN = 0,           // Task about to run
+    SCHED_HOOK_END,                 // Task returned
+    SCHED_HOOK_PASS                 // sched_run() returning (task is NULL)
+} SchedHookEvent;
+
+/**
+ * @brief Task description
+ */
+typedef struct {
+    const char* name;
+    SchedTaskFn fn;
+    void* ctx;
+    uint32_t period_us;
+    uint32_t deadline_us;           // Relative to release (0 = period)
+    uint32_t budget_us;             // CPU time per run (0 = unbudgeted)
+    uint32_t offset_us;             // First release after sched_add()
+    uint8_t priority;               // Higher runs first
+    uint8_t max_catchup;            // Overdue releases kept when late (0 = realign)
+} SchedTaskConfig;
+
+/**
+ * @brief Task statistics
+ */
+typedef struct {
+    uint32_t runs;
+    uint32_t misses;                // Finished after release + deadline
+    uint32_t overruns;              // Ran longer than the budget
+    uint32_t skipped;               // Releases dropped by the catch-up cap
+    uint32_t max_exec_us;
+    uint32_t max_jitter_us;         // Start - release
+    uint64_t total_exec_us;
+    uint64_t total_jitter_us;
+} SchedTaskStats;
+
+/**
+ * @brief Task state
+ */
+typedef struct {
+    SchedTaskConfig config;
+    uint32_t release_us;            // Next release
+    bool enabled;
+    SchedTaskStats stats;
+} SchedTask;
+
+/**
+ * @brief Scheduler state
+ */
+typedef struct {
+    SchedTask tasks[SCHED_MAX_TASKS];
+    uint8_t count;
+    uint32_t (*clock_us)(void);
+
+    uint32_t stats_start_us;        // Start of the statistics window
+    uint64_t busy_us;               // Time spent in tasks since then
+    uint32_t dispatches;
+} Scheduler;
+
+/**
+ * @brief Run hook, called on the thread running the scheduler
+ * @param s Scheduler
+ * @param task Task of a BEGIN or END event, NULL for PASS
+ * @param event What happened
+ */
+typedef void (*SchedHookFn)(const Scheduler* s, const SchedTask* task, SchedHookEvent event);
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Initialize a scheduler with no tasks
+ * @param s Scheduler state
+ * @param clock_us Monotonic microsecond clock (micros() on device)
+ */
+void sched_init(Scheduler* s, uint32_t (*clock_us)(void));
+
+/**
+ * @brief Add a periodic task (enabled, first release now + offset_us)
+ * @param s Scheduler state
+ * @param config Task description (copied)
+ * @return Task ID, or -1 if the table is full or the config is invalid
+ */
+int sched_add(Scheduler* s, const SchedTaskConfig* config);
+
+/**
+ * @brief Enable or disable a task; enabling releases it immediately
+ * @param s Scheduler state
+ * @param id Task ID
+ * @param enabled New state
+ */
+void sched_enable(Scheduler* s, int id, bool enabled);
+
+/**
+ * @brief Change a task's period (takes effect from its next release)
+ * @param s Scheduler state
+ * @param id Task ID
+ * @param period_us New period
+ */
+void sched_set_period(Scheduler* s, int id, uint32_t period_us);
+
+/**
+ * @brief Run due tasks, most urgent first, until none is due
+ * @param s Scheduler state
+ * @return Number of tasks run
+ */
+uint8_t sched_run(Scheduler* s);
+
+/**
+ * @brief Get time until the next release
+ * @param s Scheduler state
+ * @return Microseconds until a task is due (0 if one is due now)
+ */
+uint32_t sched_idle_us(const Scheduler* s);
+
+/**
+ * @brief Get a task (name, config, statistics)
+ * @param s Scheduler state
+ * @param id Task ID
+ * @return Task, or NULL for an unknown ID
+ */
+const SchedTask* sched_get_task(const Scheduler* s, int id);
+
+/**
+ * @brief Get CPU load since the statistics window started
+ * @param s Scheduler state
+ * @return Percent of wall time spent in tasks
+ */
+float sched_load_percent(const Scheduler* s);
+
+/**
+ * @brief Clear all task statistics and start a new window
+ * @param s Scheduler state
+ */
+void sched_reset_stats(Scheduler* s);
+
+/**
+ * @brief Install the run hook for every scheduler (set before they run)
+ * @param hook Hook, or NULL to remove it
+ */
+void sched_set_hook(SchedHookFn hook);
+
+// ============================================================================
+// VIRTUAL TIME (host tests and tools)
+// ============================================================================
+
+/**
+ * @brief Virtual clock; pass to sched_init() on the host
+ */
+uint32_t sched_virtual_clock(void);
+
+/**
+ * @brief Set the virtual clock
+ */
+void sched_virtual_set(uint32_t now_us);
+
+/**
+ * @brief Advance the virtual clock (a task consuming CPU time)
+ */
+void sched_virtual_advance(uint32_t us);
+
+/**
+ * @brief Run a scheduler on the virtual clock, skipping idle time
+ * @param s Scheduler initialized with sched_virtual_clock
+ * @param duration_us Virtual time to simulate
+ * @return Number of task runs
+ */
+uint32_t sched_run_virtual(Scheduler* s, uint32_t duration_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_SCHEDULER_H
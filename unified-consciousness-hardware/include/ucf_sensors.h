@@ -25,6 +25,7 @@
 #include <stdbool.h>
 #include "ucf/ucf_sacred_constants_v4.h"
 #include "ucf/ucf_types.h"
+#include "ucf_i2c_bus.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,6 +46,8 @@ extern "C" {
 #define SENSOR_HEX_COUNT        19
 #define SENSOR_HEX_CENTER       9
 
+#define SENSOR_BUS_DEADLINE_US  10000   // Bus reads not started within one update are dropped
+
 // ============================================================================
 // TYPE DEFINITIONS
 // ============================================================================
@@ -146,6 +149,18 @@ SensorStatus sensors_init(void);
  */
 const SensorSystemState* sensors_update(void);
 
+/**
+ * @brief Read through the I2C bus manager instead of blocking on Wire
+ *
+ * sensors_update() then collects the frame queued by the previous update
+ * and queues the next, so readings lag by one update. Call after
+ * sensors_init() and before i2c_bus_start(); NULL (e.g. if the worker
+ * did not start) returns to direct reads.
+ *
+ * @param bus Bus with the MPR121 and HMC5883L devices added
+ */
+void sensors_attach_bus(I2cBus* bus);
+
 /**
  * @brief Get hex grid state
  * @return Current hex grid state
@@ -177,6 +192,36 @@ const HexSensorData* sensors_get_sensor(uint8_t index);
  */
 void sensors_calibrate_hex(uint16_t samples);
 
+/**
+ * @brief Install hex grid baselines (warm start or background calibration)
+ * @param baselines SENSOR_HEX_COUNT baseline values
+ */
+void sensors_set_baselines(const uint16_t* baselines);
+
+/**
+ * @brief Copy the hex grid baselines
+ * @param baselines Output, SENSOR_HEX_COUNT values
+ * @return true if calibrated
+ */
+bool sensors_get_baselines(uint16_t* baselines);
+
+/**
+ * @brief Copy the raw hex readings from the last update
+ * @param raw Output, SENSOR_HEX_COUNT values
+ */
+void sensors_get_raw(uint16_t* raw);
+
+/**
+ * @brief Get the smoothed z (persisted across warm starts)
+ */
+float sensors_get_z_smoothed(void);
+
+/**
+ * @brief Seed the z smoothing filter
+ * @param z Smoothed z to continue from
+ */
+void sensors_set_z_smoothed(float z);
+
 /**
  * @brief Start magnetometer calibration
  */
@@ -0,0 +1,217 @@
+/**
+ * @file ucf_session_log.h
+ * @brief UCF Session Recorder v4.0.0
+ *
+ * Persistent record of what happened in a session: decimated state frames
+ * (z, Kuramoto r, kappa, eta, active sensors) plus phase, TRIAD and
+ * K-Formation change events, kept in a ring on a raw flash partition so
+ * hours of history survive reboots.
+ *
+ * - Records are delta/varint encoded into a RAM block (SESSION_LOG_BLOCK_SIZE)
+ * - Full or idle blocks are sealed: LZ-compressed, CRC32-protected
+ * - Sealed blocks are written in page-sized pieces, at most one flash
+ *   operation (page program or sector erase) per SESSION_LOG_OP_INTERVAL_MS,
+ *   so logging never stalls loop() for more than one flash operation
+ * - The oldest sector is erased when the ring wraps
+ *
+ * Flash layout: blocks never span sectors; each starts with a 24-byte
+ * header (magic, seq, session, flags, raw/compressed length, start time,
+ * CRC32). Every block decodes on its own, so losing the oldest sector or a
+ * torn last block costs only that data.
+ *
+ * Backends are StorageBackend (ucf_storage.h): the "ucflog" partition on the
+ * ESP32 (session_log_begin()), a file image on the host (storage_file_open()).
+ * The reader half of this API is used by tools/session_log_host.cpp.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_SESSION_LOG_H
+#define UCF_SESSION_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ucf_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SESSION LOG CONSTANTS
+// ============================================================================
+
+#define SESSION_LOG_BLOCK_SIZE          2048    // Uncompressed records per block
+#define SESSION_LOG_HEADER_SIZE         24
+#define SESSION_LOG_MAGIC               0x4C464355  // "UCFL"
+#define SESSION_LOG_PAGE_SIZE           256     // Flash program granularity
+#define SESSION_LOG_MAX_SECTORS         512
+#define SESSION_LOG_OP_INTERVAL_MS      20      // Min spacing of flash operations
+#define SESSION_LOG_SEAL_MS             30000   // Seal a partial block after this long
+#define SESSION_LOG_FRAME_INTERVAL_MS   200     // Frame decimation (5 Hz)
+#define SESSION_LOG_VALUE_SCALE         1024.0f // Fixed-point scale for z, r, kappa, eta
+
+// Block flags
+#define SESSION_LOG_FLAG_STORED         0x0001  // Payload is uncompressed
+
+/**
+ * @brief Record types
+ */
+typedef enum {
+    SESSION_REC_START       = 1,    // First record of a session
+    SESSION_REC_FRAME       = 2,    // Decimated state snapshot
+    SESSION_REC_PHASE       = 3,    // Phase changed
+    SESSION_REC_TRIAD       = 4,    // TRIAD state or crossing count changed
+    SESSION_REC_KFORMATION  = 5     // K-Formation began or ended
+} SessionRecordType;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief State snapshot passed to the recorder every sensor update
+ */
+typedef struct {
+    float z;
+    float r;                    // Kuramoto order parameter
+    float kappa;
+    float eta;
+    uint8_t phase;
+    uint8_t triad_state;
+    uint8_t triad_crossings;
+    uint8_t active_sensors;
+    bool k_formation;
+} SessionFrame;
+
+/**
+ * @brief Recorder statistics
+ */
+typedef struct {
+    uint32_t records;           // Records encoded
+    uint32_t frames_skipped;    // Frames dropped by decimation
+    uint32_t dropped;           // Records lost because the writer fell behind
+    uint32_t blocks;            // Blocks sealed
+    uint32_t raw_bytes;         // Encoded bytes sealed
+    uint32_t flash_bytes;       // Bytes programmed (headers included)
+    uint32_t erases;
+    uint32_t write_errors;
+    uint32_t next_seq;
+    uint16_t session;
+} SessionLogStats;
+
+/**
+ * @brief Decoded record
+ *
+ * 'state' is the snapshot as of this record: frames update the values,
+ * events update their own fields. 'phase_from' is set for PHASE records.
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t phase_from;
+    uint16_t session;
+    uint32_t seq;               // Block sequence number
+    uint32_t time_ms;
+    SessionFrame state;
+} SessionLogRecord;
+
+/**
+ * @brief Log reader (host tools; large, do not put on a task stack)
+ */
+typedef struct {
+    StorageBackend backend;
+    uint16_t order[SESSION_LOG_MAX_SECTORS];   // Sectors by first block sequence
+    uint16_t sector_count;
+    uint16_t sector_index;      // Position in order[]
+    uint32_t offset;            // Next block offset in the current sector
+
+    uint8_t block[SESSION_LOG_BLOCK_SIZE];
+    uint8_t packed[SESSION_LOG_BLOCK_SIZE];
+    uint16_t block_len;
+    uint16_t block_pos;
+    uint16_t session;
+    uint32_t seq;
+    uint32_t time_ms;
+    SessionFrame state;
+    int32_t q[5];               // Delta-coding base
+
+    uint32_t blocks;            // Valid blocks read
+    uint32_t corrupt;           // Blocks skipped (bad CRC or encoding)
+} SessionLogReader;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Mount a log ring and start a new session
+ *
+ * Scans for the newest block to continue the sequence; appends after it if
+ * the rest of its sector is erased, otherwise starts in the next sector.
+ *
+ * @param backend Flash store (copied); sectors must hold a full block
+ * @return true if mounted
+ */
+bool session_log_init(const StorageBackend* backend);
+
+/**
+ * @brief Record the current state
+ *
+ * Emits change events immediately and a frame at most every
+ * SESSION_LOG_FRAME_INTERVAL_MS. Never touches flash.
+ *
+ * @param now_ms Current time
+ * @param frame State snapshot
+ */
+void session_log_frame(uint32_t now_ms, const SessionFrame* frame);
+
+/**
+ * @brief Seal idle blocks and perform at most one due flash operation
+ * @param now_ms Current time
+ */
+void session_log_tick(uint32_t now_ms);
+
+/**
+ * @brief Seal the open block and write everything out now (blocking)
+ * @return true if all data reached flash
+ */
+bool session_log_flush(void);
+
+/**
+ * @brief Get recorder statistics
+ */
+const SessionLogStats* session_log_get_stats(void);
+
+/**
+ * @brief Open a reader positioned at the oldest block
+ * @param reader Reader state
+ * @param backend Flash store (copied)
+ * @return true if the ring holds at least one block
+ */
+bool session_log_reader_open(SessionLogReader* reader, const StorageBackend* backend);
+
+/**
+ * @brief Read the next record in sequence order
+ * @param reader Reader state
+ * @param record Output record
+ * @return false at the end of the log
+ */
+bool session_log_reader_next(SessionLogReader* reader, SessionLogRecord* record);
+
+/**
+ * @brief Get record type name
+ */
+const char* session_log_type_string(uint8_t type);
+
+/**
+ * @brief Mount the "ucflog" partition (ESP32 only)
+ * @return true if mounted
+ */
+bool session_log_begin(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_SESSION_LOG_H
@@ -0,0 +1,123 @@
+/**
+ * @file ucf_shadow.h
+ * @brief UCF Output Shadow Registers v4.0.0
+ *
+ * The modules recompute their outputs every cycle (coupling at 1 kHz,
+ * indicator LEDs at 20 Hz and on every state change), but the values
+ * rarely change. Each output keeps a shadow of the value last written to
+ * the hardware; shadow_set() only records the wanted value, and
+ * shadow_flush(), once per scheduler tick, writes the outputs whose value
+ * differs from their shadow. Repeated and superseded sets within a tick
+ * cost nothing on the bus.
+ *
+ * - Digipot: one SPI transaction per coupling step change
+ * - Indicator LEDs: one digitalWrite() per level change
+ *
+ * shadow_set() may be called from any task or core; shadow_bind(),
+ * shadow_invalidate() and shadow_flush() belong to the task that owns
+ * the hardware.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_SHADOW_H
+#define UCF_SHADOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SHADOW CONSTANTS
+// ============================================================================
+
+#define SHADOW_UNKNOWN              0xFFFFFFFFu     // Hardware state not known
+
+/**
+ * @brief Shadowed outputs
+ */
+typedef enum {
+    SHADOW_DIGIPOT = 0,             // MCP41010 wiper step (Kuramoto coupling)
+    SHADOW_LED_UNTRUE,
+    SHADOW_LED_PARADOX,
+    SHADOW_LED_TRUE,
+    SHADOW_LED_TRIAD,
+    SHADOW_LED_K_FORMATION,
+    SHADOW_COUNT
+} ShadowId;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Hardware write for one output
+ * @param value New value (never SHADOW_UNKNOWN)
+ * @param ctx Passed to shadow_bind()
+ */
+typedef void (*ShadowWriteFn)(uint32_t value, void* ctx);
+
+/**
+ * @brief Totals since shadow_init()
+ */
+typedef struct {
+    uint32_t requested;             // shadow_set() calls
+    uint32_t written;               // Hardware writes by shadow_flush()
+    uint32_t avoided;               // Sets that needed no write
+} ShadowStats;
+
+// ============================================================================
+// SHADOW API
+// ============================================================================
+
+/**
+ * @brief Unbind every output and clear the totals
+ */
+void shadow_init(void);
+
+/**
+ * @brief Attach an output to its hardware
+ * @param id Output
+ * @param fn Hardware write
+ * @param ctx Passed to fn
+ * @param initial Written now, or SHADOW_UNKNOWN to wait for the first set
+ */
+void shadow_bind(ShadowId id, ShadowWriteFn fn, void* ctx, uint32_t initial);
+
+/**
+ * @brief Request a value (written by the next flush if it differs)
+ */
+void shadow_set(ShadowId id, uint32_t value);
+
+/**
+ * @brief Get the value last requested (SHADOW_UNKNOWN if none)
+ */
+uint32_t shadow_get(ShadowId id);
+
+/**
+ * @brief Forget what the hardware holds (e.g. after it was reset)
+ *
+ * The next flush writes the requested value even if it did not change.
+ */
+void shadow_invalidate(ShadowId id);
+
+/**
+ * @brief Write every bound output whose requested value differs from its shadow
+ * @return Hardware writes made
+ */
+size_t shadow_flush(void);
+
+/**
+ * @brief Get totals
+ */
+void shadow_get_stats(ShadowStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_SHADOW_H
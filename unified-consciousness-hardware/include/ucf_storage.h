@@ -0,0 +1,293 @@
+/**
+ * @file ucf_storage.h
+ * @brief UCF Persistent Storage Manager v4.0.0
+ *
+ * One owner for all non-volatile settings (sigil ROM, sensor calibration,
+ * magnetometer calibration, OTA calibration backup). Replaces per-module
+ * EEPROM.begin()/end() cycles and hand-assigned byte addresses:
+ *
+ * - Named, versioned regions with centrally allocated IDs
+ * - One shared RAM shadow: reads never touch flash
+ * - Lazy, coalesced commits: writes only mark a region dirty; all dirty
+ *   regions are committed together by storage_tick() or storage_flush()
+ * - Log-structured records (header + CRC32) appended to the active sector;
+ *   a torn write leaves the previous record in force
+ * - Wear levelling by rotating compaction through all sectors
+ *
+ * Backends provide NOR-flash semantics (erase to 0xFF, program clears bits).
+ * On the ESP32 the backend is the "ucfstore" data partition, or the EEPROM
+ * library as a fallback (see storage_begin()); on the host it is a file
+ * (storage_file_open()).
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_STORAGE_H
+#define UCF_STORAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// STORAGE CONSTANTS
+// ============================================================================
+
+#define STORAGE_MAX_REGIONS         8
+#define STORAGE_SHADOW_SIZE         2048    // Shared RAM shadow for all regions
+#define STORAGE_COMMIT_DELAY_MS     2000    // Coalescing window after the first write
+#define STORAGE_MIN_SECTORS         2       // Compaction needs a spare sector
+
+#define STORAGE_SECTOR_HEADER_SIZE  16
+#define STORAGE_RECORD_HEADER_SIZE  12
+#define STORAGE_SECTOR_MAGIC        0x53464355  // "UCFS"
+
+/**
+ * @brief Region IDs (one per persistent data set; never reuse a retired ID)
+ */
+typedef enum {
+    STORAGE_REGION_SIGIL        = 1,    // SigilROM table
+    STORAGE_REGION_CALIBRATION  = 2,    // CalibrationData
+    STORAGE_REGION_MAGNETOMETER = 3,    // MagnetometerCalibration
+    STORAGE_REGION_OTA          = 4,    // OTA restore flag + calibration backup
+    STORAGE_REGION_SNAPSHOT     = 5     // WarmSnapshot (ucf_warm_start.h)
+} StorageRegionId;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Storage operation result
+ */
+typedef enum {
+    STORAGE_OK = 0,
+    STORAGE_ERR_NOT_READY,      // storage_init() not called or failed
+    STORAGE_ERR_PARAM,          // Unknown region, bad size or range
+    STORAGE_ERR_NOT_FOUND,      // Region has never been written
+    STORAGE_ERR_VERSION,        // Stored record has a different version
+    STORAGE_ERR_FULL,           // Shadow or sector cannot hold the data
+    STORAGE_ERR_IO              // Backend read/write/erase failed
+} StorageStatus;
+
+/**
+ * @brief Flash-like backing store
+ *
+ * Addresses are byte offsets from the start of the store. write() only
+ * programs erased bytes; erase() sets a whole sector to 0xFF. sync() makes
+ * preceding writes durable and may be NULL if writes are immediate.
+ * lock()/unlock() serialize API calls from several tasks (NULL when the
+ * store is used from one context only). before_format() runs when the
+ * store holds no valid sector, before anything is erased, so a backend
+ * can save older data kept in the same medium (may be NULL).
+ */
+typedef struct {
+    uint32_t sector_size;
+    uint16_t sector_count;
+    bool (*read)(uint32_t addr, void* buf, size_t len, void* ctx);
+    bool (*write)(uint32_t addr, const void* data, size_t len, void* ctx);
+    bool (*erase)(uint16_t sector, void* ctx);
+    bool (*sync)(void* ctx);
+    void (*lock)(void* ctx);
+    void (*unlock)(void* ctx);
+    void (*before_format)(void* ctx);
+    void* ctx;
+} StorageBackend;
+
+/**
+ * @brief Storage statistics
+ */
+typedef struct {
+    uint32_t commits;           // storage_flush() calls that wrote records
+    uint32_t records;           // Records appended (including compaction copies)
+    uint32_t bytes;             // Bytes programmed
+    uint32_t compactions;
+    uint32_t erases;
+    uint32_t coalesced;         // Writes absorbed by an already pending commit
+    uint32_t unchanged;         // Writes skipped because the data was identical
+    uint32_t corrupt;           // Invalid records found while mounting
+    uint32_t generation;        // Active sector generation
+    uint32_t max_erase_count;   // Highest per-sector erase count seen
+} StorageStats;
+
+/**
+ * @brief File-backed store for host tests and tools
+ */
+typedef struct {
+    FILE* file;
+    uint32_t sector_size;
+    uint16_t sector_count;
+} StorageFile;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Mount a backend, formatting it if it holds no valid sector
+ *
+ * Drops all region registrations; modules register again afterwards.
+ *
+ * @param backend Backing store (copied)
+ * @return true if mounted
+ */
+bool storage_init(const StorageBackend* backend);
+
+/**
+ * @brief Register a region and load its stored record into the shadow
+ *
+ * Registering the same ID again with the same size and version is a no-op,
+ * so every user of a region may register it.
+ *
+ * @param id Region ID
+ * @param name Short name for diagnostics (static string)
+ * @param size Region size in bytes
+ * @param version Layout version; records of other versions are not loaded
+ * @return true if registered
+ */
+bool storage_register(uint8_t id, const char* name, uint16_t size, uint16_t version);
+
+/**
+ * @brief Check whether a region holds data of the registered version
+ * @param id Region ID
+ * @return STORAGE_OK, STORAGE_ERR_NOT_FOUND or STORAGE_ERR_VERSION
+ */
+StorageStatus storage_region_status(uint8_t id);
+
+/**
+ * @brief Copy region bytes out of the shadow
+ * @param id Region ID
+ * @param offset Byte offset within the region
+ * @param buf Output buffer
+ * @param len Bytes to read
+ * @return STORAGE_OK, or why no data is available
+ */
+StorageStatus storage_read_at(uint8_t id, uint16_t offset, void* buf, uint16_t len);
+
+/**
+ * @brief Update region bytes in the shadow and schedule a commit
+ *
+ * Never touches flash. Identical data does not dirty the region.
+ *
+ * @param id Region ID
+ * @param offset Byte offset within the region
+ * @param data Bytes to write
+ * @param len Byte count
+ * @return STORAGE_OK or STORAGE_ERR_PARAM
+ */
+StorageStatus storage_write_at(uint8_t id, uint16_t offset, const void* data, uint16_t len);
+
+/**
+ * @brief Read a whole region (offset 0)
+ */
+StorageStatus storage_read(uint8_t id, void* buf, uint16_t len);
+
+/**
+ * @brief Write a whole region (offset 0)
+ */
+StorageStatus storage_write(uint8_t id, const void* data, uint16_t len);
+
+/**
+ * @brief Check for uncommitted writes
+ * @return true if any region is dirty
+ */
+bool storage_pending(void);
+
+/**
+ * @brief Commit all dirty regions now (e.g. before a reboot)
+ * @return STORAGE_OK or the first failure
+ */
+StorageStatus storage_flush(void);
+
+/**
+ * @brief Commit once the coalescing window has passed; call from the loop
+ *
+ * When idle, also pre-erases the next sector so the commit that triggers
+ * compaction does not pay for the erase.
+ *
+ * @param now_ms Current time in milliseconds
+ */
+void storage_tick(uint32_t now_ms);
+
+/**
+ * @brief Get storage statistics
+ * @return Statistics since storage_init()
+ */
+const StorageStats* storage_get_stats(void);
+
+/**
+ * @brief Get bytes used in the active sector
+ * @return Used bytes (including the sector header)
+ */
+uint32_t storage_get_used(void);
+
+/**
+ * @brief Get human-readable status
+ * @param status Status code
+ * @return Status string
+ */
+const char* storage_status_string(StorageStatus status);
+
+// ============================================================================
+// FILE BACKEND (ucf_storage_file.cpp)
+// ============================================================================
+
+/**
+ * @brief Open or create a file-backed store
+ *
+ * The file is created erased (0xFF). Writes are ANDed into existing
+ * contents, as on NOR flash.
+ *
+ * @param sf File store state
+ * @param path File path
+ * @param sector_size Sector size in bytes
+ * @param sector_count Number of sectors
+ * @param backend Output backend bound to sf
+ * @return true if opened
+ */
+bool storage_file_open(StorageFile* sf, const char* path, uint32_t sector_size,
+                       uint16_t sector_count, StorageBackend* backend);
+
+/**
+ * @brief Close a file-backed store
+ * @param sf File store state
+ */
+void storage_file_close(StorageFile* sf);
+
+// ============================================================================
+// DEVICE BACKEND (ucf_storage_esp32.cpp)
+// ============================================================================
+
+/**
+ * @brief Mount device storage once; safe to call from every user module
+ *
+ * Uses the "ucfstore" data partition when present, otherwise a single
+ * EEPROM library buffer of STORAGE_EEPROM_SIZE bytes.
+ *
+ * @return true if storage is available
+ */
+bool storage_begin(void);
+
+/**
+ * @brief Read settings left by older firmware at fixed EEPROM addresses
+ *
+ * Only available on the boot that first formats the store; modules whose
+ * region is empty then import and validate their old layout once.
+ *
+ * @param addr Old EEPROM address
+ * @param buf Output buffer
+ * @param len Bytes to read
+ * @return true if legacy data exists and the range is covered
+ */
+bool storage_legacy_read(uint16_t addr, void* buf, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_STORAGE_H
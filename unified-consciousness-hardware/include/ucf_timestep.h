@@ -0,0 +1,110 @@
+/**
+ * @file ucf_timestep.h
+ * @brief UCF Fixed Timestep v4.0.0
+ *
+ * The Kuramoto task used to integrate over whatever time had passed since
+ * its last run, so a late release (a long LED transmit or console burst in
+ * front of it) became one long Euler step. The accumulator instead turns
+ * elapsed time into whole steps of a constant length:
+ *
+ * - Every step uses the same dt, so the error per step is fixed and a
+ *   task's cost is a whole number of steps
+ * - A late run takes the steps it missed, up to max_steps; anything
+ *   beyond the cap is dropped (an overrun) instead of being replayed
+ * - The remainder carries over, so no time is lost between runs
+ *
+ * Step boundaries start half a step away from the first run: a task whose
+ * period equals the step then takes exactly one step per release, however
+ * its start jitters within half a period.
+ *
+ * One task owns the accumulator; timestep_get_stats() may be called from
+ * any task or core.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_TIMESTEP_H
+#define UCF_TIMESTEP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Totals since timestep_init()
+ */
+typedef struct {
+    uint32_t steps;                 // Steps taken
+    uint32_t overruns;              // Runs that hit the catch-up cap
+    uint32_t dropped_steps;         // Steps discarded by the cap
+    uint32_t max_steps;             // Most steps in one run
+} TimestepStats;
+
+/**
+ * @brief Fixed-step accumulator
+ */
+typedef struct {
+    uint32_t step_us;               // Step length
+    uint8_t max_steps;              // Catch-up cap per run
+    uint32_t last_us;               // Time of the last advance
+    uint32_t accum_us;              // Elapsed time not yet stepped (< step_us)
+    TimestepStats stats;
+} Timestep;
+
+// ============================================================================
+// TIMESTEP API
+// ============================================================================
+
+/**
+ * @brief Start an accumulator
+ * @param t Accumulator
+ * @param step_us Step length (> 0)
+ * @param max_steps Most steps one run may take (1..255)
+ * @param now_us Current time
+ */
+void timestep_init(Timestep* t, uint32_t step_us, uint8_t max_steps, uint32_t now_us);
+
+/**
+ * @brief Account for the time since the last call
+ * @param t Accumulator
+ * @param now_us Current time
+ * @return Steps to take now (0..max_steps)
+ */
+uint8_t timestep_advance(Timestep* t, uint32_t now_us);
+
+/**
+ * @brief Get the step length in seconds
+ */
+float timestep_dt(const Timestep* t);
+
+/**
+ * @brief How long before the last advance one of its steps ends
+ *
+ * Catch-up steps each stand for their own moment of simulated time; code
+ * that reads a clock during a step should use now minus this age.
+ *
+ * @param t Accumulator
+ * @param steps Steps returned by the last timestep_advance()
+ * @param i Step index (0 = oldest)
+ * @return Age in us (the time not yet stepped for the newest)
+ */
+uint32_t timestep_age_us(const Timestep* t, uint8_t steps, uint8_t i);
+
+/**
+ * @brief Get totals (safe from any task or core)
+ */
+void timestep_get_stats(const Timestep* t, TimestepStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_TIMESTEP_H
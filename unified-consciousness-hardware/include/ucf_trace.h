@@ -0,0 +1,263 @@
+/**
+ * @file ucf_trace.h
+ * @brief UCF Sensor Trace v4.0.0
+ *
+ * Binary record of every input the firmware acts on: raw MPR121 filtered
+ * data for the 19 cells, raw HMC5883L samples and serial console commands,
+ * each time-stamped, so a session from the field can be replayed
+ * bit-exactly on a workstation.
+ *
+ * Image layout (little-endian):
+ * - 32-byte file header: magic "UCFT", version, chunk size, start time
+ * - Fixed-size chunks (TRACE_CHUNK_SIZE) from offset TRACE_FILE_HEADER_SIZE.
+ *   Each has a 20-byte header (magic, sequence, first record time, payload
+ *   length, record count, CRC32) and whole records; the unused tail is
+ *   zero. Chunk i sits at a computed offset, so readers over a mapped image
+ *   seek by time with a binary search over the chunk headers.
+ * - Records: type (1), payload length (1), time_ms (4), payload
+ *
+ * Recording: the input hooks append into a RAM chunk; full chunks wait in a
+ * small ring until trace_tick() hands them to the sink, so the hooks never
+ * do I/O. If the sink falls behind, whole chunks are dropped and counted.
+ *
+ * Replay: the hooks substitute recorded values for live ones. Touch frames
+ * and magnetometer samples are returned in recorded order, one per read;
+ * commands are released after as many touch frames as when they were
+ * recorded. The sensors' own readings are discarded, so the firmware sees
+ * exactly the recorded inputs. Recording and replay can run together (to
+ * re-record a replay for comparison).
+ *
+ * The hooks compile out when UCF_TRACE is 0, the default for production
+ * builds (UCF_PRODUCTION). The native HAL records and replays trace files
+ * (--record, --replay); tools/trace_host.cpp prints them.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_TRACE_H
+#define UCF_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef UCF_TRACE
+#if defined(UCF_PRODUCTION) && UCF_PRODUCTION
+#define UCF_TRACE 0
+#else
+#define UCF_TRACE 1
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// TRACE CONSTANTS
+// ============================================================================
+
+#define TRACE_MAGIC                 0x54464355  // "UCFT"
+#define TRACE_CHUNK_MAGIC           0x43544355  // "UCTC"
+#define TRACE_VERSION               1
+#define TRACE_FILE_HEADER_SIZE      32
+#define TRACE_CHUNK_HEADER_SIZE     20
+#define TRACE_RECORD_HEADER_SIZE    6
+#define TRACE_CHUNK_SIZE            4096
+#define TRACE_RING_CHUNKS           3       // Sealed chunks awaiting trace_tick()
+#define TRACE_HEX_COUNT             19      // Cells per touch frame
+
+/**
+ * @brief Record types
+ */
+typedef enum {
+    TRACE_REC_TOUCH     = 1,    // 19 x uint16 filtered data, cell order
+    TRACE_REC_MAG       = 2,    // 3 x int16 raw X, Y, Z
+    TRACE_REC_COMMAND   = 3     // Command byte + touch frames before it (uint32)
+} TraceRecordType;
+
+/**
+ * @brief Active modes (bit mask)
+ */
+typedef enum {
+    TRACE_MODE_OFF      = 0,
+    TRACE_MODE_RECORD   = 1,
+    TRACE_MODE_REPLAY   = 2
+} TraceMode;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Sink for finished chunks (and the file header)
+ * @return false on a write error
+ */
+typedef bool (*TraceWriteFn)(const void* data, size_t len, void* ctx);
+
+/**
+ * @brief Decoded record
+ *
+ * Only the fields of the record's type are set.
+ */
+typedef struct {
+    uint8_t type;
+    uint32_t time_ms;
+    uint16_t touch[TRACE_HEX_COUNT];
+    int16_t mag[3];             // X, Y, Z
+    uint8_t command;
+    uint32_t frame;             // Touch frames recorded before the command
+} TraceRecord;
+
+/**
+ * @brief Reader over a trace image in memory (usually mmap()ed)
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint32_t chunk_size;
+    uint32_t chunk_count;
+    uint32_t start_ms;          // Recorder clock at trace_record_begin()
+
+    uint32_t chunk;             // Current chunk
+    uint32_t pos;               // Next record offset in the chunk
+    uint32_t end;               // Payload end of the current chunk (0 = not entered)
+    uint32_t corrupt;           // Chunks skipped (bad magic, length or CRC)
+} TraceReader;
+
+/**
+ * @brief Recorder and replay statistics
+ */
+typedef struct {
+    uint8_t mode;               // TraceMode bits
+    uint32_t records;           // Records appended
+    uint32_t chunks;            // Chunks handed to the sink
+    uint32_t dropped_chunks;    // Chunks lost because the ring was full
+    uint32_t write_errors;
+    uint32_t bytes;             // Bytes written, file header included
+
+    uint32_t replay_frames;     // Touch frames substituted
+    uint32_t replay_mags;       // Magnetometer samples substituted
+    uint32_t replay_commands;   // Commands released
+    bool replay_done;           // Recorded touch frames exhausted
+} TraceStats;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Start recording
+ *
+ * Writes the file header immediately; later chunks go out from trace_tick().
+ *
+ * @param write Sink for the image, appended in order
+ * @param ctx Passed to write
+ * @param now_ms Current time, stored as the trace start
+ * @return true if the header was written
+ */
+bool trace_record_begin(TraceWriteFn write, void* ctx, uint32_t now_ms);
+
+/**
+ * @brief Seal the open chunk, write everything out and stop recording
+ */
+void trace_record_end(void);
+
+/**
+ * @brief Hand sealed chunks to the sink (call from a non-real-time context)
+ */
+void trace_tick(void);
+
+/**
+ * @brief Start replaying an image
+ * @param data Trace image; must stay valid until trace_replay_end()
+ * @param size Image size in bytes
+ * @return true if the image has a valid header
+ */
+bool trace_replay_begin(const uint8_t* data, size_t size);
+
+/**
+ * @brief Stop replaying; live inputs are used again
+ */
+void trace_replay_end(void);
+
+/**
+ * @brief Touch frame hook, called after every read of the 19 cells
+ * @param now_ms Current time
+ * @param raw TRACE_HEX_COUNT values; replaced with the recorded frame in replay
+ */
+void trace_touch(uint32_t now_ms, uint16_t* raw);
+
+/**
+ * @brief Magnetometer hook, called after every raw sample
+ * @param now_ms Current time
+ * @param xyz X, Y, Z raw counts; replaced with the recorded sample in replay
+ */
+void trace_mag(uint32_t now_ms, int16_t* xyz);
+
+/**
+ * @brief Console hook, called on every console poll
+ * @param now_ms Current time
+ * @param live Byte read from the console, or -1 if none
+ * @return Command to execute, or -1. In replay, a due recorded command
+ *         takes precedence over live input.
+ */
+int trace_command(uint32_t now_ms, int live);
+
+/**
+ * @brief Get recorder and replay statistics
+ */
+const TraceStats* trace_get_stats(void);
+
+/**
+ * @brief Open a reader positioned at the first record
+ * @param reader Reader state
+ * @param data Trace image
+ * @param size Image size in bytes
+ * @return true if the header is valid
+ */
+bool trace_reader_open(TraceReader* reader, const uint8_t* data, size_t size);
+
+/**
+ * @brief Position the reader at the chunk holding time_ms
+ *
+ * The next record returned is the first of the last chunk that starts at
+ * or before time_ms, so records slightly earlier than time_ms may follow.
+ *
+ * @param reader Reader state
+ * @param time_ms Recorder time
+ */
+void trace_reader_seek(TraceReader* reader, uint32_t time_ms);
+
+/**
+ * @brief Read the next record
+ * @param reader Reader state
+ * @param record Output record
+ * @return false at the end of the trace
+ */
+bool trace_reader_next(TraceReader* reader, TraceRecord* record);
+
+/**
+ * @brief Get record type name
+ */
+const char* trace_type_string(uint8_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+// ============================================================================
+// HOOKS (compile out with UCF_TRACE=0)
+// ============================================================================
+
+#if UCF_TRACE
+#define TRACE_TOUCH(now_ms, raw)        trace_touch((now_ms), (raw))
+#define TRACE_MAG(now_ms, xyz)          trace_mag((now_ms), (xyz))
+#define TRACE_COMMAND(now_ms, live)     trace_command((now_ms), (live))
+#else
+#define TRACE_TOUCH(now_ms, raw)        ((void)0)
+#define TRACE_MAG(now_ms, xyz)          ((void)0)
+#define TRACE_COMMAND(now_ms, live)     (live)
+#endif
+
+#endif // UCF_TRACE_H
@@ -0,0 +1,142 @@
+/**
+ * @file ucf_warm_start.h
+ * @brief UCF Warm Start v4.0.0
+ *
+ * Boots from the last known state instead of recalibrating:
+ * - WarmSnapshot: hex baselines, smoothed z, Kuramoto phases, coupling and
+ *   PLL integrator, kept in STORAGE_REGION_SNAPSHOT and refreshed from the
+ *   loop (warm_start_save() only updates the storage shadow)
+ * - BaselineCheck: validates restored baselines against fresh samples taken
+ *   by the normal sensor reads, so nothing blocks in setup(). A quiet window
+ *   that agrees with the snapshot confirms it; one that disagrees replaces
+ *   it. Windows with a finger on the grid (too much spread) are discarded.
+ *
+ * A cold boot (no snapshot, or a snapshot of another version) runs the same
+ * check without expected values, which turns the blocking calibration loop
+ * into a background one.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#ifndef UCF_WARM_START_H
+#define UCF_WARM_START_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ucf_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// WARM START CONSTANTS
+// ============================================================================
+
+#define WARM_SNAPSHOT_VERSION           1
+#define WARM_SNAPSHOT_HEX_COUNT         19      // 1 + 6 + 12 configuration
+#define WARM_SNAPSHOT_OSCILLATORS       8
+#define WARM_SNAPSHOT_INTERVAL_MS       300000  // Loop refresh period (5 min)
+
+#define WARM_CHECK_SAMPLES              32      // Samples per validation window
+#define WARM_CHECK_TOLERANCE            12      // Max |mean - baseline| in counts
+#define WARM_CHECK_NOISE                8       // Max spread in a quiet window
+#define WARM_CHECK_MIN_AGREE            16      // Channels within tolerance to confirm
+#define WARM_CHECK_MAX_WINDOWS          50      // Give up after this many noisy windows
+
+/**
+ * @brief Baseline check progress
+ */
+typedef enum {
+    WARM_CHECK_IDLE = 0,        // Not started
+    WARM_CHECK_COLLECTING,      // Sampling
+    WARM_CHECK_CONFIRMED,       // Restored baselines agree with the grid
+    WARM_CHECK_REPLACED,        // Fresh baselines measured (result[] is valid)
+    WARM_CHECK_GAVE_UP          // Never saw a quiet window; baselines unchanged
+} WarmCheckState;
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Persisted warm-start state
+ */
+typedef struct {
+    uint16_t hex_baselines[WARM_SNAPSHOT_HEX_COUNT];
+    uint16_t flags;                                 // Reserved
+    float z_smoothed;                               // sensors_* z filter
+    float phase_z_smoothed;                         // PhaseEngine z filter
+    float kuramoto_phases[WARM_SNAPSHOT_OSCILLATORS];
+    float kuramoto_coupling;
+    float pll_integrator;
+    uint32_t boot_count;                            // Boots that restored this snapshot
+} WarmSnapshot;
+
+/**
+ * @brief Background baseline validation / calibration
+ */
+typedef struct {
+    uint16_t expected[WARM_SNAPSHOT_HEX_COUNT];
+    uint16_t result[WARM_SNAPSHOT_HEX_COUNT];
+    uint32_t accum[WARM_SNAPSHOT_HEX_COUNT];
+    uint16_t min[WARM_SNAPSHOT_HEX_COUNT];
+    uint16_t max[WARM_SNAPSHOT_HEX_COUNT];
+    uint16_t samples;           // Samples in the current window
+    uint16_t windows;           // Windows discarded as noisy
+    uint8_t agree;              // Channels within tolerance (last window)
+    bool have_expected;
+    WarmCheckState state;
+} BaselineCheck;
+
+// ============================================================================
+// API FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Load the snapshot from storage (storage must be initialized)
+ * @param snapshot Output snapshot
+ * @return true if a snapshot of this version exists
+ */
+bool warm_start_load(WarmSnapshot* snapshot);
+
+/**
+ * @brief Store a snapshot; storage_tick() commits it
+ *
+ * Identical snapshots do not dirty storage.
+ *
+ * @param snapshot Snapshot to store
+ * @return true if the storage shadow was updated
+ */
+bool warm_start_save(const WarmSnapshot* snapshot);
+
+/**
+ * @brief Start a baseline check
+ * @param check Check state
+ * @param expected Restored baselines, or NULL to just measure (cold boot)
+ */
+void baseline_check_begin(BaselineCheck* check, const uint16_t* expected);
+
+/**
+ * @brief Feed one set of raw readings
+ * @param check Check state
+ * @param raw WARM_SNAPSHOT_HEX_COUNT raw channel values
+ * @return Check state after this sample
+ */
+WarmCheckState baseline_check_add(BaselineCheck* check, const uint16_t* raw);
+
+/**
+ * @brief Check whether a check is still sampling
+ */
+bool baseline_check_active(const BaselineCheck* check);
+
+/**
+ * @brief Get check state name
+ */
+const char* baseline_check_state_string(WarmCheckState state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UCF_WARM_START_H
@@ -0,0 +1,66 @@
+/**
+ * @file Adafruit_NeoPixel.h
+ * @brief WS2812 strip for the native firmware build
+ *
+ * Same pixel storage as the Adafruit library (wire-order bytes, scaled by
+ * the brightness when set). show() publishes the buffer as the strip's
+ * framebuffer (native_hal_led_frame()) and takes as long as the device
+ * takes to clock it out: 30 us per pixel plus the latch.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ADAFRUIT_NEOPIXEL_H
+#define NATIVE_HAL_ADAFRUIT_NEOPIXEL_H
+
+#include "Arduino.h"
+
+// Byte offsets of R, G and B in each pixel (RGB strips only)
+#define NEO_RGB     ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB     ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_BRG     ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_KHZ800  0x0000
+#define NEO_KHZ400  0x0100
+
+typedef uint16_t neoPixelType;
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800);
+    Adafruit_NeoPixel(const Adafruit_NeoPixel&) = delete;
+    Adafruit_NeoPixel& operator=(const Adafruit_NeoPixel&) = delete;
+    ~Adafruit_NeoPixel();
+
+    void begin(void);
+    void show(void);
+    bool canShow(void) const;
+    void clear(void);
+
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+    void setPixelColor(uint16_t n, uint32_t c);
+    uint32_t getPixelColor(uint16_t n) const;
+    void setBrightness(uint8_t b);
+    uint8_t getBrightness(void) const { return (uint8_t)(m_brightness - 1); }
+
+    uint8_t* getPixels(void) const { return m_pixels; }
+    uint16_t numPixels(void) const { return m_count; }
+    int16_t getPin(void) const { return m_pin; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+private:
+    uint16_t m_count;
+    int16_t m_pin;
+    uint8_t m_r_offset;
+    uint8_t m_g_offset;
+    uint8_t m_b_offset;
+    uint8_t m_brightness = 0;       // Stored +1; 0 = full scale, as in the library
+    uint8_t* m_pixels;
+    bool m_begun = false;
+    uint32_t m_end_time_us = 0;
+    int m_slot = -1;
+};
+
+#endif // NATIVE_HAL_ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,289 @@
+/**
+ * @file Arduino.h
+ * @brief Arduino core for the native (Linux) firmware build
+ *
+ * The part of the arduino-esp32 core the firmware uses: timing, GPIO,
+ * random numbers, String, Print/Stream and a Serial port on stdin/stdout.
+ * Simulated devices and their controls are declared in ucf_native_hal.h.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ARDUINO_H
+#define NATIVE_HAL_ARDUINO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+// Same names the ESP32 core pulls into the global namespace
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+#define INPUT_PULLDOWN  0x09
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define PI              3.1415926535897932384626433832795
+#define HALF_PI         1.5707963267948966192313216916398
+#define TWO_PI          6.283185307179586476925286766559
+#define DEG_TO_RAD      0.017453292519943295769236907684886
+#define RAD_TO_DEG      57.295779513082320876798154814105
+
+#define DEC             10
+#define HEX             16
+#define OCT             8
+#define BIN             2
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(string_literal)   (string_literal)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define radians(deg)    ((deg) * DEG_TO_RAD)
+#define degrees(rad)    ((rad) * RAD_TO_DEG)
+#define sq(x)           ((x) * (x))
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+// ============================================================================
+// TIMING
+// ============================================================================
+
+/**
+ * @brief Milliseconds since the process started (wraps like the device)
+ */
+unsigned long millis(void);
+
+/**
+ * @brief Microseconds since the process started (wraps like the device)
+ */
+unsigned long micros(void);
+
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void dacWrite(uint8_t pin, uint8_t value);
+
+// ============================================================================
+// MATH
+// ============================================================================
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+uint32_t getCpuFrequencyMhz(void);
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+/**
+ * @brief Heap-backed string with the Arduino String interface
+ */
+class String {
+public:
+    String(const char* cstr = "");
+    String(const String& other) = default;
+    String(String&& other) = default;
+    explicit String(char c);
+    explicit String(int value, unsigned char base = DEC);
+    explicit String(unsigned int value, unsigned char base = DEC);
+    explicit String(long value, unsigned char base = DEC);
+    explicit String(unsigned long value, unsigned char base = DEC);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+
+    String& operator=(const String& other) = default;
+    String& operator=(String&& other) = default;
+    String& operator=(const char* cstr);
+
+    String& operator+=(const String& other);
+    String& operator+=(const char* cstr);
+    String& operator+=(char c);
+    String& operator+=(int value);
+    String& operator+=(unsigned int value);
+    String& operator+=(long value);
+    String& operator+=(unsigned long value);
+    String& operator+=(float value);
+    String& operator+=(double value);
+
+    friend String operator+(const String& lhs, const String& rhs);
+    friend String operator+(const String& lhs, const char* rhs);
+    friend String operator+(const char* lhs, const String& rhs);
+
+    bool operator==(const String& other) const { return m_str == other.m_str; }
+    bool operator==(const char* cstr) const { return m_str == (cstr ? cstr : ""); }
+    bool operator!=(const String& other) const { return !(*this == other); }
+    bool operator!=(const char* cstr) const { return !(*this == cstr); }
+    char operator[](unsigned int index) const;
+
+    bool reserve(unsigned int size);
+    unsigned int length(void) const { return (unsigned int)m_str.size(); }
+    const char* c_str(void) const { return m_str.c_str(); }
+
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const char* str, unsigned int from = 0) const;
+    bool startsWith(const char* prefix) const;
+    bool endsWith(const char* suffix) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    void trim(void);
+    void toLowerCase(void);
+    void toUpperCase(void);
+    long toInt(void) const;
+    float toFloat(void) const;
+
+private:
+    std::string m_str;
+};
+
+// ============================================================================
+// PRINT / STREAM
+// ============================================================================
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const char* str);
+    size_t print(const String& str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println(void);
+    size_t println(const char* str);
+    size_t println(const String& str);
+    size_t println(char c);
+    size_t println(unsigned char value, int base = DEC);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+
+private:
+    size_t printNumber(unsigned long value, int base);
+};
+
+class Stream : public Print {
+public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+    String readStringUntil(char terminator);
+};
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+/**
+ * @brief UART0 on the process's stdin/stdout
+ *
+ * Reads never block: available() polls stdin. Output is written through
+ * to stdout on every call, so lines from several tasks interleave as they
+ * would on the device.
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    void end(void);
+    void flush(void);
+    operator bool() const { return true; }
+
+    int available(void) override;
+    int read(void) override;
+    int peek(void) override;
+    int availableForWrite(void) { return 128; }
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+private:
+    bool fill(void);
+
+    uint8_t m_rx[256];
+    size_t m_rx_head = 0;
+    size_t m_rx_tail = 0;
+    bool m_eof = false;
+};
+
+extern HardwareSerial Serial;
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+class EspClass {
+public:
+    /**
+     * @brief Reboot: the process re-executes itself with the same arguments
+     */
+    [[noreturn]] void restart(void);
+
+    uint32_t getCpuFreqMHz(void) { return getCpuFrequencyMhz(); }
+};
+
+extern EspClass ESP;
+
+// ============================================================================
+// SKETCH ENTRY POINTS
+// ============================================================================
+
+void setup(void);
+void loop(void);
+
+#endif // NATIVE_HAL_ARDUINO_H
@@ -0,0 +1,59 @@
+/**
+ * @file ArduinoOTA.h
+ * @brief Network OTA for the native firmware build
+ *
+ * Accepts the configuration and callbacks; with no network no update
+ * ever arrives, so handle() returns at once.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ARDUINO_OTA_H
+#define NATIVE_HAL_ARDUINO_OTA_H
+
+#include "Arduino.h"
+#include "Update.h"
+#include <functional>
+
+typedef enum {
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    ArduinoOTAClass& setHostname(const char* hostname);
+    ArduinoOTAClass& setPort(uint16_t port);
+    ArduinoOTAClass& setPassword(const char* password);
+    ArduinoOTAClass& setRebootOnSuccess(bool reboot);
+
+    ArduinoOTAClass& onStart(THandlerFunction fn);
+    ArduinoOTAClass& onEnd(THandlerFunction fn);
+    ArduinoOTAClass& onError(THandlerFunction_Error fn);
+    ArduinoOTAClass& onProgress(THandlerFunction_Progress fn);
+
+    void begin(void);
+    void end(void);
+    void handle(void);
+    int getCommand(void) const { return U_FLASH; }
+
+private:
+    String m_hostname;
+    uint16_t m_port = 3232;
+    bool m_started = false;
+    THandlerFunction m_start;
+    THandlerFunction m_end;
+    THandlerFunction_Error m_error;
+    THandlerFunction_Progress m_progress;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif // NATIVE_HAL_ARDUINO_OTA_H
@@ -0,0 +1,55 @@
+/**
+ * @file EEPROM.h
+ * @brief Emulated EEPROM for the native firmware build
+ *
+ * The buffer is loaded from eeprom.bin in the flash directory at begin()
+ * and written back whole by commit(), replacing the file atomically.
+ * Bytes never written read 0xFF, as after the first begin() on a device.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_EEPROM_H
+#define NATIVE_HAL_EEPROM_H
+
+#include "Arduino.h"
+
+class EEPROMClass {
+public:
+    ~EEPROMClass();
+
+    bool begin(size_t size);
+    void end(void);
+    bool commit(void);
+
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    uint8_t* getDataPtr(void);
+    uint16_t length(void) const { return (uint16_t)m_size; }
+
+    template <typename T>
+    T& get(int address, T& t) {
+        if (address >= 0 && address + sizeof(T) <= m_size) {
+            memcpy((uint8_t*)&t, m_data + address, sizeof(T));
+        }
+        return t;
+    }
+
+    template <typename T>
+    const T& put(int address, const T& t) {
+        if (address >= 0 && address + sizeof(T) <= m_size) {
+            memcpy(m_data + address, (const uint8_t*)&t, sizeof(T));
+            m_dirty = true;
+        }
+        return t;
+    }
+
+private:
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_dirty = false;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_HAL_EEPROM_H
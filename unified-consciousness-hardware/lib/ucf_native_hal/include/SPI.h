@@ -0,0 +1,54 @@
+/**
+ * @file SPI.h
+ * @brief SPI master for the native firmware build
+ *
+ * Nothing answers on MISO (reads return 0xFF); the bytes sent are kept
+ * for native_hal_spi_history().
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_SPI_H
+#define NATIVE_HAL_SPI_H
+
+#include "Arduino.h"
+
+#define SPI_MODE0   0
+#define SPI_MODE1   1
+#define SPI_MODE2   2
+#define SPI_MODE3   3
+#define SPI_LSBFIRST 0
+#define SPI_MSBFIRST 1
+
+#ifndef MSBFIRST
+#define MSBFIRST    SPI_MSBFIRST
+#define LSBFIRST    SPI_LSBFIRST
+#endif
+
+class SPISettings {
+public:
+    SPISettings() : clock(1000000), bitOrder(SPI_MSBFIRST), dataMode(SPI_MODE0) {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1);
+    void end(void);
+
+    void beginTransaction(SPISettings settings);
+    void endTransaction(void);
+
+    uint8_t transfer(uint8_t data);
+    uint16_t transfer16(uint16_t data);
+    void transfer(void* data, uint32_t size);
+};
+
+extern SPIClass SPI;
+
+#endif // NATIVE_HAL_SPI_H
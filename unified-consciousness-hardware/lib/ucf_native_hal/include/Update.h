@@ -0,0 +1,56 @@
+/**
+ * @file Update.h
+ * @brief Firmware updater for the native firmware build
+ *
+ * Writes the image to the next OTA partition image (app0 / app1 files in
+ * the flash directory) and marks it bootable on end(), so the partition
+ * read-back and boot switch paths behave as on the device.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_UPDATE_H
+#define NATIVE_HAL_UPDATE_H
+
+#include "Arduino.h"
+#include "esp_partition.h"
+
+#define U_FLASH     0
+#define U_SPIFFS    100
+
+#define UPDATE_ERROR_OK         0
+#define UPDATE_ERROR_WRITE      1
+#define UPDATE_ERROR_ERASE      2
+#define UPDATE_ERROR_SPACE      4
+#define UPDATE_ERROR_SIZE       5
+#define UPDATE_ERROR_MAGIC_BYTE 7
+#define UPDATE_ERROR_NO_PARTITION 10
+#define UPDATE_ERROR_BAD_ARGUMENT 11
+#define UPDATE_ERROR_ABORT      12
+
+#define UPDATE_SIZE_UNKNOWN     0xFFFFFFFF
+
+class UpdateClass {
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH);
+    size_t write(uint8_t* data, size_t len);
+    bool end(bool evenIfRemaining = false);
+    void abort(void);
+
+    bool isRunning(void) const { return m_partition != NULL; }
+    bool hasError(void) const { return m_error != UPDATE_ERROR_OK; }
+    uint8_t getError(void) const { return m_error; }
+    size_t size(void) const { return m_size; }
+    size_t progress(void) const { return m_progress; }
+    size_t remaining(void) const { return m_size - m_progress; }
+
+private:
+    const esp_partition_t* m_partition = NULL;
+    size_t m_size = 0;
+    size_t m_progress = 0;
+    uint8_t m_error = UPDATE_ERROR_OK;
+};
+
+extern UpdateClass Update;
+
+#endif // NATIVE_HAL_UPDATE_H
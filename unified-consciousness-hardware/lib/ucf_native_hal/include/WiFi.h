@@ -0,0 +1,47 @@
+/**
+ * @file WiFi.h
+ * @brief WiFi station for the native firmware build
+ *
+ * There is no radio: begin() is accepted and the station never connects,
+ * which is what the firmware sees on a device with no access point.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_WIFI_H
+#define NATIVE_HAL_WIFI_H
+
+#include "Arduino.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t mode) { m_mode = mode; return true; }
+    wifi_mode_t getMode(void) const { return m_mode; }
+    wl_status_t begin(const char* ssid, const char* passphrase = NULL) { return WL_DISCONNECTED; }
+    bool disconnect(bool wifioff = false) { return true; }
+    wl_status_t status(void) const { return WL_DISCONNECTED; }
+    bool isConnected(void) const { return false; }
+
+private:
+    wifi_mode_t m_mode = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_HAL_WIFI_H
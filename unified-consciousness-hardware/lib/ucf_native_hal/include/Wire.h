@@ -0,0 +1,65 @@
+/**
+ * @file Wire.h
+ * @brief I2C master for the native firmware build
+ *
+ * Transfers go to the simulated devices in ucf_native_hal.h and take
+ * their length on the wire at the configured clock (9 bits per byte plus
+ * start and stop). Like the ESP32 driver, each transmission holds the bus
+ * lock from beginTransmission() to endTransmission(), so several tasks
+ * can share Wire.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_WIRE_H
+#define NATIVE_HAL_WIRE_H
+
+#include "Arduino.h"
+#include <mutex>
+
+#define I2C_BUFFER_LENGTH   128
+
+class TwoWire : public Stream {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end(void);
+    bool setClock(uint32_t frequency);
+    uint32_t getClock(void) const { return m_clock_hz; }
+
+    void beginTransmission(uint16_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint16_t address, uint8_t size, bool sendStop = true);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+
+    // Integer literals, as in the ESP32 core
+    size_t write(int data) { return write((uint8_t)data); }
+    size_t write(unsigned int data) { return write((uint8_t)data); }
+    size_t write(long data) { return write((uint8_t)data); }
+    size_t write(unsigned long data) { return write((uint8_t)data); }
+
+    int available(void) override;
+    int read(void) override;
+    int peek(void) override;
+    void flush(void);
+
+private:
+    uint32_t wire_time_us(size_t bytes) const;
+
+    std::recursive_mutex m_lock;
+    uint32_t m_clock_hz = 100000;
+    uint16_t m_tx_address = 0;
+    uint8_t m_tx[I2C_BUFFER_LENGTH];
+    size_t m_tx_len = 0;
+    bool m_tx_overflow = false;
+    bool m_held_for_read = false;
+    uint8_t m_rx[I2C_BUFFER_LENGTH];
+    size_t m_rx_len = 0;
+    size_t m_rx_pos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_HAL_WIRE_H
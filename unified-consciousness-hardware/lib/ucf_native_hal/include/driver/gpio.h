@@ -0,0 +1,32 @@
+/**
+ * @file gpio.h
+ * @brief GPIO wake-up configuration for the native firmware build
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_DRIVER_GPIO_H
+#define NATIVE_HAL_DRIVER_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int gpio_num_t;
+
+typedef enum {
+    GPIO_INTR_DISABLE = 0,
+    GPIO_INTR_LOW_LEVEL = 4,
+    GPIO_INTR_HIGH_LEVEL = 5
+} gpio_int_type_t;
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_DRIVER_GPIO_H
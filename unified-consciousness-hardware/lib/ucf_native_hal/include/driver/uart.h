@@ -0,0 +1,35 @@
+/**
+ * @file uart.h
+ * @brief UART driver calls used around light sleep (native firmware build)
+ *
+ * Console output goes straight to stdout, so transmission is always done.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_DRIVER_UART_H
+#define NATIVE_HAL_DRIVER_UART_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    UART_NUM_0 = 0,
+    UART_NUM_1,
+    UART_NUM_2,
+    UART_NUM_MAX
+} uart_port_t;
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t uart_num, int wakeup_threshold);
+esp_err_t uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_DRIVER_UART_H
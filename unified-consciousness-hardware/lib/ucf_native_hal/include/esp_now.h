@@ -0,0 +1,68 @@
+/**
+ * @file esp_now.h
+ * @brief ESP-NOW for the native firmware build
+ *
+ * Each process started with --mesh-node N is one station: a UDP socket on
+ * 127.0.0.1, port NATIVE_HAL_MESH_PORT + N. A broadcast goes to the ports
+ * of all NATIVE_HAL_MESH_NODES nodes but its own; received packets reach
+ * the receive callback on a thread of its own, as they reach the WiFi
+ * task on the device. Without --mesh-node there is no radio and
+ * esp_now_init() fails.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_NOW_H
+#define NATIVE_HAL_ESP_NOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_wifi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_NOW_ETH_ALEN            6
+#define ESP_NOW_KEY_LEN             16
+#define ESP_NOW_MAX_DATA_LEN        250
+
+#define ESP_ERR_ESPNOW_BASE         0x3064
+#define ESP_ERR_ESPNOW_NOT_INIT     (ESP_ERR_ESPNOW_BASE + 1)
+#define ESP_ERR_ESPNOW_ARG          (ESP_ERR_ESPNOW_BASE + 2)
+#define ESP_ERR_ESPNOW_FULL         (ESP_ERR_ESPNOW_BASE + 4)
+#define ESP_ERR_ESPNOW_NOT_FOUND    (ESP_ERR_ESPNOW_BASE + 5)
+#define ESP_ERR_ESPNOW_INTERNAL     (ESP_ERR_ESPNOW_BASE + 6)
+#define ESP_ERR_ESPNOW_EXIST        (ESP_ERR_ESPNOW_BASE + 7)
+
+typedef enum {
+    ESP_NOW_SEND_SUCCESS = 0,
+    ESP_NOW_SEND_FAIL
+} esp_now_send_status_t;
+
+typedef struct {
+    uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+    uint8_t lmk[ESP_NOW_KEY_LEN];
+    uint8_t channel;
+    wifi_interface_t ifidx;
+    bool encrypt;
+    void* priv;
+} esp_now_peer_info_t;
+
+typedef void (*esp_now_recv_cb_t)(const uint8_t* mac_addr, const uint8_t* data, int data_len);
+typedef void (*esp_now_send_cb_t)(const uint8_t* mac_addr, esp_now_send_status_t status);
+
+esp_err_t esp_now_init(void);
+esp_err_t esp_now_deinit(void);
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb);
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_NOW_H
@@ -0,0 +1,29 @@
+/**
+ * @file esp_ota_ops.h
+ * @brief OTA slot selection for the native firmware build
+ *
+ * The boot slot is kept in the otadata image, so a restart after an
+ * update runs "from" the other app partition, as on the device.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_OTA_OPS_H
+#define NATIVE_HAL_ESP_OTA_OPS_H
+
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const esp_partition_t* esp_ota_get_running_partition(void);
+const esp_partition_t* esp_ota_get_boot_partition(void);
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_OTA_OPS_H
@@ -0,0 +1,70 @@
+/**
+ * @file esp_partition.h
+ * @brief Flash partitions for the native firmware build
+ *
+ * The table mirrors partitions_ucf.csv. Each partition is a file of its
+ * size in the flash directory (<label>.bin) with NOR semantics: erase
+ * fills 4 KB sectors with 0xFF and writes can only clear bits. A partition
+ * image is also a valid esptool read_flash dump, so the host tools read
+ * them directly.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_PARTITION_H
+#define NATIVE_HAL_ESP_PARTITION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPI_FLASH_SEC_SIZE      4096
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+    ESP_PARTITION_TYPE_ANY = 0xff
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_APP_OTA_0 = 0x10,
+    ESP_PARTITION_SUBTYPE_APP_OTA_1 = 0x11,
+    ESP_PARTITION_SUBTYPE_DATA_OTA = 0x00,
+    ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+    ESP_PARTITION_SUBTYPE_DATA_COREDUMP = 0x03,
+    ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+    ESP_PARTITION_SUBTYPE_ANY = 0xff
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+    bool encrypted;
+} esp_partition_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label);
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset,
+                             void* dst, size_t size);
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset,
+                              const void* src, size_t size);
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset,
+                                    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_PARTITION_H
@@ -0,0 +1,40 @@
+/**
+ * @file esp_sleep.h
+ * @brief Light sleep for the native firmware build
+ *
+ * esp_light_sleep_start() blocks the caller until the timer wake-up, or
+ * until console input arrives (UART wake-up) or an enabled GPIO reaches
+ * its wake level, and reports which. The clock (wall or virtual) moves on
+ * as it would on the device.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_SLEEP_H
+#define NATIVE_HAL_ESP_SLEEP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+    ESP_SLEEP_WAKEUP_TIMER = 4,
+    ESP_SLEEP_WAKEUP_GPIO = 7,
+    ESP_SLEEP_WAKEUP_UART = 8
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num);
+esp_err_t esp_sleep_enable_gpio_wakeup(void);
+esp_err_t esp_light_sleep_start(void);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_SLEEP_H
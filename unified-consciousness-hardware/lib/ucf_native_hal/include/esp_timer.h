@@ -0,0 +1,47 @@
+/**
+ * @file esp_timer.h
+ * @brief One-shot microsecond timers for the native firmware build
+ *
+ * Callbacks run on one dispatcher thread, as on the device's esp_timer
+ * task, and follow the virtual clock when it is on.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_TIMER_H
+#define NATIVE_HAL_ESP_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+    ESP_TIMER_TASK = 0
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_TIMER_H
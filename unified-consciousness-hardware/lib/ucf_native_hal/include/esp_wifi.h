@@ -0,0 +1,32 @@
+/**
+ * @file esp_wifi.h
+ * @brief WiFi driver calls for the native firmware build
+ *
+ * The station MAC is 02:00:00:00:00:NN, NN being the --mesh-node number
+ * (0 without one), so each process of a host mesh has its own.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_ESP_WIFI_H
+#define NATIVE_HAL_ESP_WIFI_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WIFI_IF_STA = 0,
+    WIFI_IF_AP = 1
+} wifi_interface_t;
+
+esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_ESP_WIFI_H
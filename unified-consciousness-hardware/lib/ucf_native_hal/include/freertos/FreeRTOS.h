@@ -0,0 +1,37 @@
+/**
+ * @file FreeRTOS.h
+ * @brief FreeRTOS types for the native firmware build
+ *
+ * Tasks run on pthreads (task.h). There is no scheduler: priorities and
+ * core affinity are recorded but the host kernel decides who runs, so
+ * timing between tasks is only as good as the host is idle.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_FREERTOS_H
+#define NATIVE_HAL_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdFAIL                  pdFALSE
+#define pdPASS                  pdTRUE
+
+#define configTICK_RATE_HZ      1000
+#define configMAX_PRIORITIES    25
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#define tskIDLE_PRIORITY        ((UBaseType_t)0U)
+#define tskNO_AFFINITY          ((BaseType_t)0x7FFFFFFF)
+
+#endif // NATIVE_HAL_FREERTOS_H
@@ -0,0 +1,34 @@
+/**
+ * @file semphr.h
+ * @brief FreeRTOS semaphores for the native firmware build
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_FREERTOS_SEMPHR_H
+#define NATIVE_HAL_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct QueueDefinition;
+typedef struct QueueDefinition* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xBlockTime);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_FREERTOS_SEMPHR_H
@@ -0,0 +1,54 @@
+/**
+ * @file task.h
+ * @brief FreeRTOS tasks for the native firmware build
+ *
+ * One detached pthread per task, named after it (visible in top -H and
+ * perf). vTaskDelete() only supports deleting the calling task.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_HAL_FREERTOS_TASK_H
+#define NATIVE_HAL_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tskTaskControlBlock;
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char* pcName,
+                                   uint32_t usStackDepth, void* pvParameters,
+                                   UBaseType_t uxPriority, TaskHandle_t* pvCreatedTask,
+                                   BaseType_t xCoreID);
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char* pcName,
+                       uint32_t usStackDepth, void* pvParameters,
+                       UBaseType_t uxPriority, TaskHandle_t* pvCreatedTask);
+
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskDelay(TickType_t xTicksToDelay);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char* pcTaskGetName(TaskHandle_t xTaskToQuery);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+/**
+ * @brief Core the calling task was pinned to (loop() runs on core 1)
+ */
+BaseType_t xPortGetCoreID(void);
+
+void vPortYield(void);
+#define taskYIELD() vPortYield()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_FREERTOS_TASK_H
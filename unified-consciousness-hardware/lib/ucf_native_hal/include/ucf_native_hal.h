@@ -0,0 +1,204 @@
+/**
+ * @file ucf_native_hal.h
+ * @brief Native (Linux) hardware abstraction layer v4.0.0
+ *
+ * Runs main.cpp and main_v4.cpp unmodified as Linux processes. The
+ * Arduino, Wire, SPI, EEPROM, Adafruit_NeoPixel, Adafruit_MPR121,
+ * FreeRTOS, esp_partition, OTA, esp_timer, esp_sleep, esp_now and
+ * esp_wifi headers in this library replace the ESP32 framework:
+ *
+ * - Time: millis()/micros() from the monotonic clock, or a virtual clock
+ *   that skips idle time (--virtual-time)
+ * - Serial: stdin (non-blocking) and stdout
+ * - Wire: a bus of simulated devices, two MPR121s (0x5A, 0x5B) and an
+ *   HMC5883L (0x1E), with transfers taking their time on the wire
+ * - NeoPixel: a framebuffer per strip, show() as long as on the device
+ * - EEPROM and flash partitions (partitions_ucf.csv): files in one
+ *   directory, with NOR semantics for the partitions
+ * - FreeRTOS: tasks on pthreads, mutexes, task notifications
+ * - esp_timer: one-shot timers on a dispatcher thread; light sleep blocks
+ *   the caller until its timer or console input
+ * - WiFi / ArduinoOTA: present but never connect
+ * - ESP-NOW: UDP datagrams between processes on the loopback interface
+ *   (--mesh-node; wall time only)
+ *
+ * Touches come from a scripted scenario (--scenario) plus any strength
+ * set here; the functions below are the hooks for host tools driving a
+ * running firmware.
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef UCF_NATIVE_HAL_H
+#define UCF_NATIVE_HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================================
+// HAL CONSTANTS
+// ============================================================================
+
+#define NATIVE_HAL_CELL_COUNT       19      // Hex grid cells (12 on 0x5A, 7 on 0x5B)
+#define NATIVE_HAL_MPR121_ADDR_A    0x5A
+#define NATIVE_HAL_MPR121_ADDR_B    0x5B
+#define NATIVE_HAL_HMC5883L_ADDR    0x1E
+#define NATIVE_HAL_MAX_STRIPS       4
+#define NATIVE_HAL_MAX_PINS         40      // ESP32 GPIO 0-39
+#define NATIVE_HAL_SPI_HISTORY      16
+#define NATIVE_HAL_LEAD_IN_MS       5000    // Hands off while the firmware calibrates
+#define NATIVE_HAL_MESH_NODES       8       // --mesh-node 0..7
+#define NATIVE_HAL_MESH_PORT        47800   // UDP port of node 0 (127.0.0.1)
+
+// ============================================================================
+// HAL TYPES
+// ============================================================================
+
+/**
+ * @brief Scripted touch input
+ */
+typedef enum {
+    NATIVE_SCENARIO_IDLE = 0,       // Nobody touches the grid
+    NATIVE_SCENARIO_SWEEP,          // One finger walks the grid, centre to outer ring
+    NATIVE_SCENARIO_PRESS,          // A palm presses and lifts over 12 s (z sweeps 0..1)
+    NATIVE_SCENARIO_COUNT
+} NativeScenario;
+
+/**
+ * @brief Process options (command line)
+ */
+typedef struct {
+    const char* flash_dir;          // EEPROM and partition images
+    NativeScenario scenario;
+    uint32_t run_seconds;           // 0 = until interrupted
+    uint32_t seed;                  // random() and sensor noise
+    bool stock_partitions;          // No ucfstore / ucflog: EEPROM fallback paths
+    bool fast_bus;                  // Wire and show() return without waiting
+    const char* record_path;        // Sensor trace to write (NULL = none)
+    const char* replay_path;        // Sensor trace to replay (NULL = none)
+    bool virtual_time;              // Clock advances only while every task waits
+    const char* loop_report_path;   // Loop timing report to write at exit (NULL = none)
+    float cpu_scale;                // Device / host compute time for the loop report
+    const char* latency_path;       // Touch latency Chrome trace to write at exit (NULL = none)
+    bool heap_check;                // Fail the exit if the heap was used after start-up
+    int mesh_node;                  // ESP-NOW station number (-1 = no radio)
+} NativeHalOptions;
+
+/**
+ * @brief Snapshot of one LED strip as last shown
+ */
+typedef struct {
+    int16_t pin;
+    uint16_t count;
+    uint32_t frames;                // show() calls
+    uint32_t last_show_us;          // micros() at the last show()
+    const uint8_t* pixels;          // count x 3 bytes, wire order (GRB)
+} NativeLedFrame;
+
+/**
+ * @brief Simulated I2C target
+ *
+ * A write transfers the register address and any data; a read continues
+ * from the register pointer that the last write left.
+ */
+class NativeI2cDevice {
+public:
+    virtual ~NativeI2cDevice() {}
+
+    virtual uint8_t address(void) const = 0;
+    virtual void write(const uint8_t* data, size_t len) = 0;
+    virtual void read(uint8_t* data, size_t len) = 0;
+};
+
+// ============================================================================
+// PROCESS
+// ============================================================================
+
+/**
+ * @brief Get the options the process was started with
+ */
+const NativeHalOptions* native_hal_options(void);
+
+/**
+ * @brief Parse the command line (see --help)
+ * @return false on a usage error
+ */
+bool native_hal_parse_args(NativeHalOptions* options, int argc, char** argv);
+
+/**
+ * @brief Get the scenario name
+ */
+const char* native_hal_scenario_name(NativeScenario scenario);
+
+/**
+ * @brief Wait out a bus transfer (busy until the deadline; no-op with fast_bus)
+ * @param us Transfer time in microseconds
+ */
+void native_hal_bus_wait(uint32_t us);
+
+/**
+ * @brief Open a file in the flash directory, created at @p size bytes of 0xFF
+ * @return File descriptor, or -1
+ */
+int native_hal_open_image(const char* name, size_t size);
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+/**
+ * @brief Attach a device to the simulated bus (not owned)
+ */
+void native_hal_attach_i2c(NativeI2cDevice* device);
+
+/**
+ * @brief Set how hard a hex cell is touched
+ *
+ * Overrides the scenario for that cell while above zero.
+ *
+ * @param cell Cell index (0-18)
+ * @param strength 0 = untouched, 1 = full contact
+ */
+void native_hal_set_touch(uint8_t cell, float strength);
+
+/**
+ * @brief Get the touch strength of a cell at a time (scenario and overrides)
+ */
+float native_hal_touch_strength(uint8_t cell, uint32_t now_ms);
+
+/**
+ * @brief Set the magnetic field seen by the HMC5883L
+ *
+ * The default field rotates once a minute (0.45 G horizontal, -0.3 G vertical).
+ *
+ * @param x, y, z Field in gauss
+ */
+void native_hal_set_field(float x, float y, float z);
+
+// ============================================================================
+// OUTPUTS
+// ============================================================================
+
+/**
+ * @brief Copy the last shown frame of the strip on a pin
+ * @param pin Data pin
+ * @param frame Output; pixels stays valid until the next call
+ * @return false if no strip uses the pin
+ */
+bool native_hal_led_frame(int16_t pin, NativeLedFrame* frame);
+
+/**
+ * @brief Get the level last written to a GPIO
+ */
+uint8_t native_hal_pin_level(uint8_t pin);
+
+/**
+ * @brief Get the most recent SPI bytes
+ * @param out Output, oldest first
+ * @param max Capacity of @p out (at most NATIVE_HAL_SPI_HISTORY are kept)
+ * @return Number of bytes copied
+ */
+size_t native_hal_spi_history(uint8_t* out, size_t max);
+
+#endif // UCF_NATIVE_HAL_H
@@ -0,0 +1,421 @@
+/**
+ * @file native_arduino.cpp
+ * @brief Arduino core for the native firmware build
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <ctype.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static std::atomic<uint8_t> g_pin_levels[NATIVE_HAL_MAX_PINS];
+static std::mutex g_random_lock;
+static std::mt19937 g_random;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ============================================================================
+// TIMING
+// ============================================================================
+
+unsigned long millis(void) {
+    return (uint32_t)(native_clock_us() / 1000);
+}
+
+unsigned long micros(void) {
+    return (uint32_t)native_clock_us();
+}
+
+void delay(uint32_t ms) {
+    native_clock_sleep_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    // Busy-waits on the device too
+    native_clock_spin_us(us);
+}
+
+void yield(void) {
+    native_clock_yield();
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < NATIVE_HAL_MAX_PINS) {
+        g_pin_levels[pin].store(val ? HIGH : LOW, std::memory_order_relaxed);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return native_hal_pin_level(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return 0;
+}
+
+void dacWrite(uint8_t pin, uint8_t value) {
+}
+
+uint8_t native_hal_pin_level(uint8_t pin) {
+    return pin < NATIVE_HAL_MAX_PINS ? g_pin_levels[pin].load(std::memory_order_relaxed) : LOW;
+}
+
+// ============================================================================
+// MATH
+// ============================================================================
+
+long random(long howbig) {
+    if (howbig <= 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> guard(g_random_lock);
+    return (long)(g_random() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    std::lock_guard<std::mutex> guard(g_random_lock);
+    g_random.seed((uint32_t)seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    if (in_max == in_min) {
+        return out_min;
+    }
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+uint32_t getCpuFrequencyMhz(void) {
+    return 240;
+}
+
+// ============================================================================
+// STRING
+// ============================================================================
+
+static std::string format_number(unsigned long value, unsigned char base, bool negative) {
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    char buf[8 * sizeof(long) + 2];
+    char* p = &buf[sizeof(buf) - 1];
+    *p = '\0';
+    do {
+        unsigned long digit = value % base;
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    if (negative) {
+        *--p = '-';
+    }
+    return std::string(p);
+}
+
+static std::string format_signed(long value, unsigned char base) {
+    // Like the Arduino core, only base 10 is signed
+    if (base == 10 && value < 0) {
+        return format_number(0UL - (unsigned long)value, base, true);
+    }
+    return format_number((unsigned long)value, base, false);
+}
+
+static std::string format_float(double value, unsigned int decimals) {
+    if (isnan(value)) return "nan";
+    if (isinf(value)) return "inf";
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    return std::string(buf);
+}
+
+String::String(const char* cstr) : m_str(cstr ? cstr : "") {}
+String::String(char c) : m_str(1, c) {}
+String::String(int value, unsigned char base) : m_str(format_signed(value, base)) {}
+String::String(unsigned int value, unsigned char base) : m_str(format_number(value, base, false)) {}
+String::String(long value, unsigned char base) : m_str(format_signed(value, base)) {}
+String::String(unsigned long value, unsigned char base) : m_str(format_number(value, base, false)) {}
+String::String(float value, unsigned int decimals) : m_str(format_float(value, decimals)) {}
+String::String(double value, unsigned int decimals) : m_str(format_float(value, decimals)) {}
+
+String& String::operator=(const char* cstr) {
+    m_str = cstr ? cstr : "";
+    return *this;
+}
+
+String& String::operator+=(const String& other) { m_str += other.m_str; return *this; }
+String& String::operator+=(const char* cstr) { if (cstr) m_str += cstr; return *this; }
+String& String::operator+=(char c) { m_str += c; return *this; }
+String& String::operator+=(int value) { return *this += String(value); }
+String& String::operator+=(unsigned int value) { return *this += String(value); }
+String& String::operator+=(long value) { return *this += String(value); }
+String& String::operator+=(unsigned long value) { return *this += String(value); }
+String& String::operator+=(float value) { return *this += String(value); }
+String& String::operator+=(double value) { return *this += String(value); }
+
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+char String::operator[](unsigned int index) const {
+    return index < m_str.size() ? m_str[index] : '\0';
+}
+
+bool String::reserve(unsigned int size) {
+    m_str.reserve(size);
+    return true;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = m_str.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const char* str, unsigned int from) const {
+    size_t pos = m_str.find(str, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+bool String::startsWith(const char* prefix) const {
+    return m_str.compare(0, strlen(prefix), prefix) == 0;
+}
+
+bool String::endsWith(const char* suffix) const {
+    size_t n = strlen(suffix);
+    return m_str.size() >= n && m_str.compare(m_str.size() - n, n, suffix) == 0;
+}
+
+String String::substring(unsigned int from) const {
+    return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    if (from >= m_str.size()) {
+        return String();
+    }
+    return String(m_str.substr(from, to - from).c_str());
+}
+
+void String::trim(void) {
+    size_t begin = 0;
+    size_t end = m_str.size();
+    while (begin < end && isspace((unsigned char)m_str[begin])) begin++;
+    while (end > begin && isspace((unsigned char)m_str[end - 1])) end--;
+    m_str = m_str.substr(begin, end - begin);
+}
+
+void String::toLowerCase(void) {
+    for (char& c : m_str) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase(void) {
+    for (char& c : m_str) c = (char)toupper((unsigned char)c);
+}
+
+long String::toInt(void) const {
+    return atol(m_str.c_str());
+}
+
+float String::toFloat(void) const {
+    return (float)atof(m_str.c_str());
+}
+
+// ============================================================================
+// PRINT / STREAM
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    // The core's buffer: longer lines go to the heap, as they do on the device
+    char local[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(local, sizeof(local), format, args);
+    va_end(args);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(local)) {
+        return write((const uint8_t*)local, (size_t)len);
+    }
+
+    char* buf = (char*)malloc((size_t)len + 1);
+    if (buf == NULL) {
+        return 0;
+    }
+    va_start(args, format);
+    vsnprintf(buf, (size_t)len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)buf, (size_t)len);
+    free(buf);
+    return n;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+    std::string s = format_number(value, (unsigned char)base, false);
+    return write((const uint8_t*)s.data(), s.size());
+}
+
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(const String& str) { return write((const uint8_t*)str.c_str(), str.length()); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned int value, int base) { return printNumber(value, base); }
+size_t Print::print(unsigned long value, int base) { return printNumber(value, base); }
+size_t Print::print(int value, int base) { return print((long)value, base); }
+
+size_t Print::print(long value, int base) {
+    std::string s = format_signed(value, (unsigned char)base);
+    return write((const uint8_t*)s.data(), s.size());
+}
+
+size_t Print::print(double value, int digits) {
+    std::string s = format_float(value, (unsigned int)digits);
+    return write((const uint8_t*)s.data(), s.size());
+}
+
+size_t Print::println(void) { return write((const uint8_t*)"\r\n", 2); }
+size_t Print::println(const char* str) { return print(str) + println(); }
+size_t Print::println(const String& str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char value, int base) { return print(value, base) + println(); }
+size_t Print::println(int value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t Print::println(long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base) { return print(value, base) + println(); }
+size_t Print::println(double value, int digits) { return print(value, digits) + println(); }
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+        int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[n++] = (uint8_t)c;
+    }
+    return n;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+void HardwareSerial::begin(unsigned long baud) {
+}
+
+void HardwareSerial::end(void) {
+    fflush(stdout);
+}
+
+void HardwareSerial::flush(void) {
+    fflush(stdout);
+}
+
+bool HardwareSerial::fill(void) {
+    if (m_rx_head != m_rx_tail) {
+        return true;
+    }
+    if (m_eof) {
+        return false;
+    }
+
+    struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+    if (poll(&pfd, 1, 0) <= 0) {
+        return false;
+    }
+    ssize_t n = ::read(STDIN_FILENO, m_rx, sizeof(m_rx));
+    if (n <= 0) {
+        // Closed stdin (a pipe or /dev/null): nothing more will arrive
+        m_eof = true;
+        return false;
+    }
+    m_rx_head = 0;
+    m_rx_tail = (size_t)n;
+    return true;
+}
+
+int HardwareSerial::available(void) {
+    return fill() ? (int)(m_rx_tail - m_rx_head) : 0;
+}
+
+int HardwareSerial::read(void) {
+    return fill() ? m_rx[m_rx_head++] : -1;
+}
+
+int HardwareSerial::peek(void) {
+    return fill() ? m_rx[m_rx_head] : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+// ============================================================================
+// ESP
+// ============================================================================
+
+void EspClass::restart(void) {
+    native_hal_restart();
+}
@@ -0,0 +1,201 @@
+/**
+ * @file native_clock.cpp
+ * @brief Wall and virtual time for the native firmware build
+ *
+ * Wall time: millis()/micros() follow the monotonic clock and waits sleep.
+ *
+ * Virtual time (--virtual-time): the clock stands still while any firmware
+ * thread runs and jumps to the earliest wake-up once all of them wait, so
+ * code takes no time and idle time costs none. The participants are the
+ * loop thread, every FreeRTOS task, the --seconds deadline and the trace
+ * writer. A thread that yields without having waited (loop() returning,
+ * taskYIELD()) waits NATIVE_CLOCK_YIELD_US, so polling loops still see
+ * time pass.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define NATIVE_CLOCK_YIELD_US   100
+
+typedef struct Waiter {
+    uint64_t deadline_us;
+    const std::function<bool()>* ready;     // NULL: the deadline only
+    struct Waiter* next;
+} Waiter;
+
+static bool g_virtual = false;
+static std::atomic<uint64_t> g_virtual_us(0);
+static std::mutex g_lock;
+static std::condition_variable g_wake;
+static Waiter* g_waiters = NULL;            // Under g_lock
+static int g_running = 1;                   // Participants not waiting (the loop thread)
+static bool g_stalled = false;
+static thread_local bool t_waited = false;  // Waited since the last yield
+static thread_local uint64_t t_spun_ns = 0; // Busy-waited CPU time (wall)
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint64_t wall_us(void) {
+    static const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+/**
+ * @brief Find the next wake-up if every participant waits and none can
+ *        go on now (caller holds g_lock)
+ */
+static bool idle_locked(uint64_t* next_us) {
+    if (g_running > 0) {
+        return false;
+    }
+
+    uint64_t now = g_virtual_us.load(std::memory_order_relaxed);
+    uint64_t next = NATIVE_CLOCK_NEVER;
+    for (Waiter* w = g_waiters; w != NULL; w = w->next) {
+        if (w->deadline_us <= now || (w->ready != NULL && (*w->ready)())) {
+            return false;           // Woken, about to run
+        }
+        if (w->deadline_us < next) {
+            next = w->deadline_us;
+        }
+    }
+
+    if (next == NATIVE_CLOCK_NEVER) {
+        if (!g_stalled) {
+            fprintf(stderr, "[HAL] Virtual time stalled: every task waits forever\n");
+            g_stalled = true;
+        }
+        return false;
+    }
+    *next_us = next;
+    return true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void native_clock_begin(bool virtual_time) {
+    g_virtual = virtual_time;
+    wall_us();
+}
+
+bool native_clock_is_virtual(void) {
+    return g_virtual;
+}
+
+uint64_t native_clock_us(void) {
+    return g_virtual ? g_virtual_us.load(std::memory_order_acquire) : wall_us();
+}
+
+uint64_t native_clock_wall_us(void) {
+    return wall_us();
+}
+
+bool native_clock_block(uint64_t deadline_us, const std::function<bool()>& ready) {
+    std::unique_lock<std::mutex> lock(g_lock);
+    Waiter self = { deadline_us, ready ? &ready : NULL, g_waiters };
+    g_waiters = &self;
+    g_running--;
+    t_waited = true;
+
+    bool woken;
+    for (;;) {
+        if (self.ready != NULL && ready()) {
+            woken = true;
+            break;
+        }
+        if (g_virtual_us.load(std::memory_order_relaxed) >= deadline_us) {
+            woken = false;
+            break;
+        }
+        uint64_t next;
+        if (idle_locked(&next)) {
+            g_virtual_us.store(next, std::memory_order_release);
+            g_wake.notify_all();
+            continue;
+        }
+        g_wake.wait(lock);
+    }
+
+    for (Waiter** w = &g_waiters; *w != NULL; w = &(*w)->next) {
+        if (*w == &self) {
+            *w = self.next;
+            break;
+        }
+    }
+    g_running++;
+    return woken;
+}
+
+void native_clock_kick(void) {
+    if (!g_virtual) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(g_lock);
+    g_wake.notify_all();
+}
+
+void native_clock_sleep_us(uint64_t us) {
+    if (!g_virtual) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+        return;
+    }
+    native_clock_block(native_clock_us() + us, std::function<bool()>());
+}
+
+void native_clock_spin_us(uint64_t us) {
+    if (g_virtual) {
+        native_clock_sleep_us(us);
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::microseconds(us);
+    auto now = start;
+    while (now < deadline) {
+        now = std::chrono::steady_clock::now();
+    }
+    t_spun_ns += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+}
+
+uint64_t native_clock_spun_ns(void) {
+    return t_spun_ns;
+}
+
+void native_clock_yield(void) {
+    if (!g_virtual) {
+        std::this_thread::yield();
+        return;
+    }
+    if (t_waited) {
+        t_waited = false;
+        return;
+    }
+    native_clock_sleep_us(NATIVE_CLOCK_YIELD_US);
+    t_waited = false;
+}
+
+void native_clock_attach(void) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    g_running++;
+}
+
+void native_clock_detach(void) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    g_running--;
+    g_wake.notify_all();
+}
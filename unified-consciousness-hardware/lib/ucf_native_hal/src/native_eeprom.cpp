@@ -0,0 +1,109 @@
+/**
+ * @file native_eeprom.cpp
+ * @brief EEPROM emulation in eeprom.bin
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <EEPROM.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define EEPROM_FILE     "eeprom.bin"
+
+EEPROMClass EEPROM;
+
+// ============================================================================
+// EEPROM CLASS
+// ============================================================================
+
+EEPROMClass::~EEPROMClass() {
+    free(m_data);
+}
+
+bool EEPROMClass::begin(size_t size) {
+    if (size == 0) {
+        return false;
+    }
+    if (m_data != nullptr) {
+        if (size == m_size) {
+            return true;
+        }
+        end();
+    }
+
+    m_data = (uint8_t*)malloc(size);
+    if (m_data == nullptr) {
+        return false;
+    }
+    memset(m_data, 0xFF, size);
+    m_size = size;
+    m_dirty = false;
+
+    std::string path = native_hal_path(EEPROM_FILE);
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f) {
+        size_t n = fread(m_data, 1, size, f);
+        (void)n;                    // A shorter file leaves the rest erased
+        fclose(f);
+    }
+    return true;
+}
+
+void EEPROMClass::end(void) {
+    commit();
+    free(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    m_dirty = false;
+}
+
+bool EEPROMClass::commit(void) {
+    if (m_data == nullptr) {
+        return false;
+    }
+    if (!m_dirty) {
+        return true;
+    }
+
+    // Write aside and rename so a crash never leaves half a commit
+    std::string path = native_hal_path(EEPROM_FILE);
+    std::string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(m_data, 1, m_size, f) == m_size;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+uint8_t EEPROMClass::read(int address) {
+    if (address < 0 || (size_t)address >= m_size) {
+        return 0;
+    }
+    return m_data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+    if (address < 0 || (size_t)address >= m_size) {
+        return;
+    }
+    if (m_data[address] != value) {
+        m_data[address] = value;
+        m_dirty = true;
+    }
+}
+
+uint8_t* EEPROMClass::getDataPtr(void) {
+    // Callers may write through the pointer, as in the ESP32 library
+    m_dirty = true;
+    return m_data;
+}
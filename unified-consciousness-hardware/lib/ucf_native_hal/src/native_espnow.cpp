@@ -0,0 +1,221 @@
+/**
+ * @file native_espnow.cpp
+ * @brief ESP-NOW between firmware processes over loopback UDP
+ *
+ * Node N binds 127.0.0.1:NATIVE_HAL_MESH_PORT + N. A broadcast is one
+ * datagram to each other node's port, whether a process is there or not,
+ * as a radio broadcast reaches whoever listens. The receive thread is not
+ * a virtual-time participant; each process has its own clock, so the
+ * mesh is only offered in wall time.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <thread>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define ESPNOW_MAX_PEERS        20          // As on the device
+
+static const uint8_t BROADCAST_MAC[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static int g_socket = -1;
+static uint8_t g_peers[ESPNOW_MAX_PEERS][ESP_NOW_ETH_ALEN];
+static int g_peer_count = 0;
+static esp_now_recv_cb_t g_recv_cb = NULL;
+static esp_now_send_cb_t g_send_cb = NULL;
+static bool g_receiver_started = false;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static int own_node(void) {
+    int node = native_hal_options()->mesh_node;
+    return node >= 0 ? node : 0;
+}
+
+static void node_mac(int node, uint8_t mac[ESP_NOW_ETH_ALEN]) {
+    static const uint8_t BASE[ESP_NOW_ETH_ALEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    memcpy(mac, BASE, ESP_NOW_ETH_ALEN);
+    mac[ESP_NOW_ETH_ALEN - 1] = (uint8_t)node;
+}
+
+static sockaddr_in node_addr(int node) {
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)(NATIVE_HAL_MESH_PORT + node));
+    return addr;
+}
+
+static bool is_peer(const uint8_t* mac) {
+    for (int i = 0; i < g_peer_count; i++) {
+        if (memcmp(g_peers[i], mac, ESP_NOW_ETH_ALEN) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void receive_thread(int fd) {
+    uint8_t data[ESP_NOW_MAX_DATA_LEN];
+    for (;;) {
+        sockaddr_in from = {};
+        socklen_t from_len = sizeof(from);
+        ssize_t len = recvfrom(fd, data, sizeof(data), 0, (sockaddr*)&from, &from_len);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        int node = (int)ntohs(from.sin_port) - NATIVE_HAL_MESH_PORT;
+        esp_now_recv_cb_t cb = __atomic_load_n(&g_recv_cb, __ATOMIC_ACQUIRE);
+        if (cb != NULL && node >= 0 && node < NATIVE_HAL_MESH_NODES) {
+            uint8_t mac[ESP_NOW_ETH_ALEN];
+            node_mac(node, mac);
+            cb(mac, data, (int)len);
+        }
+    }
+}
+
+// ============================================================================
+// ESP-NOW API
+// ============================================================================
+
+esp_err_t esp_now_init(void) {
+    const NativeHalOptions* options = native_hal_options();
+    if (options->mesh_node < 0) {
+        fprintf(stderr, "[HAL] ESP-NOW has no radio (start with --mesh-node N)\n");
+        return ESP_ERR_ESPNOW_INTERNAL;
+    }
+    if (native_clock_is_virtual()) {
+        fprintf(stderr, "[HAL] ESP-NOW needs wall time (processes do not share a virtual clock)\n");
+        return ESP_ERR_ESPNOW_INTERNAL;
+    }
+    if (g_socket >= 0) {
+        return ESP_OK;
+    }
+
+    // Close-on-exec: a restart (native_hal_restart()) binds the port again
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr = node_addr(options->mesh_node);
+    if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "[HAL] ESP-NOW node %d cannot bind UDP port %d: %s\n",
+                options->mesh_node, NATIVE_HAL_MESH_PORT + options->mesh_node, strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return ESP_ERR_ESPNOW_INTERNAL;
+    }
+
+    g_socket = fd;
+    g_peer_count = 0;
+    fprintf(stderr, "[HAL] ESP-NOW node %d on 127.0.0.1:%d\n",
+            options->mesh_node, NATIVE_HAL_MESH_PORT + options->mesh_node);
+    return ESP_OK;
+}
+
+esp_err_t esp_now_deinit(void) {
+    // The receive thread keeps the socket; it only stops delivering
+    __atomic_store_n(&g_recv_cb, (esp_now_recv_cb_t)NULL, __ATOMIC_RELEASE);
+    g_send_cb = NULL;
+    g_peer_count = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+    if (g_socket < 0) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    __atomic_store_n(&g_recv_cb, cb, __ATOMIC_RELEASE);
+    if (!g_receiver_started) {
+        g_receiver_started = true;
+        std::thread(receive_thread, g_socket).detach();
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+    if (g_socket < 0) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    g_send_cb = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+    if (g_socket < 0) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    if (peer == NULL) {
+        return ESP_ERR_ESPNOW_ARG;
+    }
+    if (is_peer(peer->peer_addr)) {
+        return ESP_ERR_ESPNOW_EXIST;
+    }
+    if (g_peer_count == ESPNOW_MAX_PEERS) {
+        return ESP_ERR_ESPNOW_FULL;
+    }
+    memcpy(g_peers[g_peer_count++], peer->peer_addr, ESP_NOW_ETH_ALEN);
+    return ESP_OK;
+}
+
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t len) {
+    if (g_socket < 0) {
+        return ESP_ERR_ESPNOW_NOT_INIT;
+    }
+    if (data == NULL || len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+        return ESP_ERR_ESPNOW_ARG;
+    }
+    const uint8_t* mac = peer_addr != NULL ? peer_addr : BROADCAST_MAC;
+    if (!is_peer(mac)) {
+        return ESP_ERR_ESPNOW_NOT_FOUND;
+    }
+
+    bool broadcast = memcmp(mac, BROADCAST_MAC, ESP_NOW_ETH_ALEN) == 0;
+    bool sent = false;
+    for (int node = 0; node < NATIVE_HAL_MESH_NODES; node++) {
+        uint8_t node_address[ESP_NOW_ETH_ALEN];
+        node_mac(node, node_address);
+        if (node == own_node() || (!broadcast && memcmp(mac, node_address, ESP_NOW_ETH_ALEN) != 0)) {
+            continue;
+        }
+        sockaddr_in addr = node_addr(node);
+        if (sendto(g_socket, data, len, MSG_DONTWAIT, (sockaddr*)&addr, sizeof(addr)) == (ssize_t)len) {
+            sent = true;
+        }
+    }
+
+    // Unacknowledged broadcasts report success once on the air
+    if (g_send_cb != NULL) {
+        g_send_cb(mac, (sent || broadcast) ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+    }
+    return ESP_OK;
+}
+
+// ============================================================================
+// WIFI API
+// ============================================================================
+
+esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]) {
+    node_mac(own_node(), mac);
+    if (ifx == WIFI_IF_AP) {
+        mac[ESP_NOW_ETH_ALEN - 1] += 1;     // As on the device: AP = STA + 1
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,288 @@
+/**
+ * @file native_flash.cpp
+ * @brief Flash partitions, OTA slots and the updater on image files
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <esp_partition.h>
+#include <esp_ota_ops.h>
+#include <Update.h>
+#include <mutex>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define IMAGE_MAGIC     0xE9        // First byte of an ESP32 app image
+#define OTADATA_LABEL   "otadata"
+
+typedef struct {
+    esp_partition_t info;
+    bool custom;                    // Not in a stock table
+    int fd;
+} NativePartition;
+
+// partitions_ucf.csv
+static NativePartition g_table[] = {
+    { { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS,      0x9000,   0x5000,   "nvs",      false }, false, -1 },
+    { { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA,      0xE000,   0x2000,   "otadata",  false }, false, -1 },
+    { { ESP_PARTITION_TYPE_APP,  ESP_PARTITION_SUBTYPE_APP_OTA_0,     0x10000,  0x140000, "app0",     false }, false, -1 },
+    { { ESP_PARTITION_TYPE_APP,  ESP_PARTITION_SUBTYPE_APP_OTA_1,     0x150000, 0x140000, "app1",     false }, false, -1 },
+    { { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS,   0x290000, 0xD0000,  "spiffs",   false }, false, -1 },
+    { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x41,       0x360000, 0x80000,  "ucflog",   false }, true,  -1 },
+    { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40,       0x3E0000, 0x10000,  "ucfstore", false }, true,  -1 },
+    { { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_COREDUMP, 0x3F0000, 0x10000,  "coredump", false }, false, -1 },
+};
+
+#define PARTITION_COUNT (sizeof(g_table) / sizeof(g_table[0]))
+
+static std::mutex g_open_lock;
+static const esp_partition_t* g_running = NULL;
+
+UpdateClass Update;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static NativePartition* lookup(const esp_partition_t* partition) {
+    for (size_t i = 0; i < PARTITION_COUNT; i++) {
+        if (&g_table[i].info == partition) {
+            return &g_table[i];
+        }
+    }
+    return NULL;
+}
+
+static int image_fd(NativePartition* p) {
+    std::lock_guard<std::mutex> guard(g_open_lock);
+    if (p->fd < 0) {
+        std::string name = std::string(p->info.label) + ".bin";
+        p->fd = native_hal_open_image(name.c_str(), p->info.size);
+    }
+    return p->fd;
+}
+
+static esp_err_t check_range(NativePartition* p, size_t offset, size_t size) {
+    if (p == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset > p->info.size || size > p->info.size - offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return image_fd(p) < 0 ? ESP_FAIL : ESP_OK;
+}
+
+static const esp_partition_t* app_slot(int slot) {
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP,
+                                    slot == 1 ? ESP_PARTITION_SUBTYPE_APP_OTA_1
+                                              : ESP_PARTITION_SUBTYPE_APP_OTA_0, NULL);
+}
+
+// ============================================================================
+// PARTITIONS
+// ============================================================================
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (size_t i = 0; i < PARTITION_COUNT; i++) {
+        const NativePartition& p = g_table[i];
+        if (p.custom && native_hal_options()->stock_partitions) {
+            continue;
+        }
+        if ((type == ESP_PARTITION_TYPE_ANY || p.info.type == type) &&
+            (subtype == ESP_PARTITION_SUBTYPE_ANY || p.info.subtype == subtype) &&
+            (label == NULL || strcmp(p.info.label, label) == 0)) {
+            return &p.info;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset,
+                             void* dst, size_t size) {
+    NativePartition* p = lookup(partition);
+    esp_err_t err = check_range(p, src_offset, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return pread(p->fd, dst, size, (off_t)src_offset) == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset,
+                              const void* src, size_t size) {
+    NativePartition* p = lookup(partition);
+    esp_err_t err = check_range(p, dst_offset, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // Programming can only clear bits
+    const uint8_t* in = (const uint8_t*)src;
+    uint8_t buf[256];
+    for (size_t off = 0; off < size; off += sizeof(buf)) {
+        size_t n = (size - off < sizeof(buf)) ? size - off : sizeof(buf);
+        off_t at = (off_t)(dst_offset + off);
+        if (pread(p->fd, buf, n, at) != (ssize_t)n) {
+            return ESP_FAIL;
+        }
+        for (size_t i = 0; i < n; i++) {
+            buf[i] &= in[off + i];
+        }
+        if (pwrite(p->fd, buf, n, at) != (ssize_t)n) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset,
+                                    size_t size) {
+    NativePartition* p = lookup(partition);
+    if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = check_range(p, offset, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint8_t erased[SPI_FLASH_SEC_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    for (size_t off = 0; off < size; off += SPI_FLASH_SEC_SIZE) {
+        if (pwrite(p->fd, erased, SPI_FLASH_SEC_SIZE, (off_t)(offset + off)) != SPI_FLASH_SEC_SIZE) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+// ============================================================================
+// OTA SLOTS (otadata byte 0: boot slot, 0xFF = app0)
+// ============================================================================
+
+void native_flash_boot(void) {
+    g_running = esp_ota_get_boot_partition();
+}
+
+const esp_partition_t* esp_ota_get_boot_partition(void) {
+    const esp_partition_t* otadata = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                              ESP_PARTITION_SUBTYPE_DATA_OTA,
+                                                              OTADATA_LABEL);
+    uint8_t slot = 0xFF;
+    if (otadata == NULL || esp_partition_read(otadata, 0, &slot, 1) != ESP_OK) {
+        slot = 0xFF;
+    }
+    return app_slot(slot == 1 ? 1 : 0);
+}
+
+const esp_partition_t* esp_ota_get_running_partition(void) {
+    return g_running ? g_running : app_slot(0);
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from) {
+    const esp_partition_t* from = start_from ? start_from : esp_ota_get_running_partition();
+    return app_slot(from->subtype == ESP_PARTITION_SUBTYPE_APP_OTA_0 ? 1 : 0);
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+    if (partition == NULL || partition->type != ESP_PARTITION_TYPE_APP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const esp_partition_t* otadata = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                              ESP_PARTITION_SUBTYPE_DATA_OTA,
+                                                              OTADATA_LABEL);
+    if (otadata == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t slot = (partition->subtype == ESP_PARTITION_SUBTYPE_APP_OTA_1) ? 1 : 0;
+    esp_err_t err = esp_partition_erase_range(otadata, 0, SPI_FLASH_SEC_SIZE);
+    return err != ESP_OK ? err : esp_partition_write(otadata, 0, &slot, 1);
+}
+
+// ============================================================================
+// UPDATE CLASS
+// ============================================================================
+
+bool UpdateClass::begin(size_t size, int command) {
+    if (m_partition != NULL) {
+        return false;
+    }
+    m_error = UPDATE_ERROR_OK;
+    m_progress = 0;
+
+    if (command != U_FLASH) {
+        m_error = UPDATE_ERROR_BAD_ARGUMENT;
+        return false;
+    }
+    const esp_partition_t* partition = esp_ota_get_next_update_partition(NULL);
+    if (partition == NULL) {
+        m_error = UPDATE_ERROR_NO_PARTITION;
+        return false;
+    }
+    if (size == UPDATE_SIZE_UNKNOWN) {
+        size = partition->size;
+    }
+    if (size == 0 || size > partition->size) {
+        m_error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+
+    size_t erase = (size + SPI_FLASH_SEC_SIZE - 1) / SPI_FLASH_SEC_SIZE * SPI_FLASH_SEC_SIZE;
+    if (esp_partition_erase_range(partition, 0, erase) != ESP_OK) {
+        m_error = UPDATE_ERROR_ERASE;
+        return false;
+    }
+    m_partition = partition;
+    m_size = size;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+    if (m_partition == NULL || hasError()) {
+        return 0;
+    }
+    if (len > m_size - m_progress) {
+        m_error = UPDATE_ERROR_SPACE;
+        return 0;
+    }
+    if (m_progress == 0 && len > 0 && data[0] != IMAGE_MAGIC) {
+        m_error = UPDATE_ERROR_MAGIC_BYTE;
+        return 0;
+    }
+    if (esp_partition_write(m_partition, m_progress, data, len) != ESP_OK) {
+        m_error = UPDATE_ERROR_WRITE;
+        return 0;
+    }
+    m_progress += len;
+    return len;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (m_partition == NULL || hasError()) {
+        return false;
+    }
+    if (m_progress < m_size && !evenIfRemaining) {
+        m_error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    if (esp_ota_set_boot_partition(m_partition) != ESP_OK) {
+        m_error = UPDATE_ERROR_WRITE;
+        return false;
+    }
+    m_partition = NULL;
+    m_size = m_progress;
+    return true;
+}
+
+void UpdateClass::abort(void) {
+    m_partition = NULL;
+    m_size = 0;
+    m_progress = 0;
+    m_error = UPDATE_ERROR_ABORT;
+}
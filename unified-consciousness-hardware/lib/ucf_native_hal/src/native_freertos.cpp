@@ -0,0 +1,313 @@
+/**
+ * @file native_freertos.cpp
+ * @brief FreeRTOS tasks and semaphores on pthreads
+ *
+ * Threads that are not tasks (main, which runs setup() and loop()) act as
+ * the Arduino loopTask on core 1. With virtual time, every blocking call
+ * waits on the virtual clock (native_clock.cpp) and every give wakes it.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+
+// ============================================================================
+// PRIVATE TYPES
+// ============================================================================
+
+#define LOOP_TASK_CORE      1
+#define LOOP_TASK_PRIORITY  1
+
+struct tskTaskControlBlock {
+    TaskFunction_t code;
+    void* params;
+    char name[16];
+    UBaseType_t priority;
+    BaseType_t core;
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notify_count;
+};
+
+typedef enum {
+    SEM_MUTEX,
+    SEM_RECURSIVE,
+    SEM_BINARY
+} SemaphoreKind;
+
+struct QueueDefinition {
+    SemaphoreKind kind;
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t count;
+    TaskHandle_t holder;
+    uint32_t depth;                 // Recursive takes by the holder
+};
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static tskTaskControlBlock g_loop_task;
+static thread_local TaskHandle_t t_current = NULL;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static TaskHandle_t current_task(void) {
+    if (t_current == NULL) {
+        if (g_loop_task.name[0] == '\0') {
+            strcpy(g_loop_task.name, "loopTask");
+            g_loop_task.priority = LOOP_TASK_PRIORITY;
+            g_loop_task.core = LOOP_TASK_CORE;
+        }
+        return &g_loop_task;
+    }
+    return t_current;
+}
+
+static void* task_entry(void* arg) {
+    TaskHandle_t task = (TaskHandle_t)arg;
+    t_current = task;
+    pthread_setname_np(pthread_self(), task->name);
+
+    task->code(task->params);
+
+    // Returning from a task function is an error under FreeRTOS
+    fprintf(stderr, "[HAL] Task %s returned without vTaskDelete()\n", task->name);
+    native_clock_detach();
+    return NULL;
+}
+
+/**
+ * @brief Wait on a condition with a FreeRTOS timeout in ticks (1 ms)
+ */
+template <typename Predicate>
+static bool wait_ticks(std::condition_variable& cv, std::unique_lock<std::mutex>& lock,
+                       TickType_t ticks, Predicate ready) {
+    if (native_clock_is_virtual()) {
+        uint64_t deadline = (ticks == portMAX_DELAY)
+            ? NATIVE_CLOCK_NEVER
+            : native_clock_us() + (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+        std::mutex* m = lock.mutex();
+        std::function<bool()> check = [m, &ready] {
+            std::lock_guard<std::mutex> guard(*m);
+            return ready();
+        };
+        while (!ready()) {
+            lock.unlock();
+            bool woken = native_clock_block(deadline, check);
+            lock.lock();
+            if (!woken && !ready()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+}
+
+static SemaphoreHandle_t create_semaphore(SemaphoreKind kind, uint32_t count) {
+    SemaphoreHandle_t sem = new QueueDefinition();
+    sem->kind = kind;
+    sem->count = count;
+    sem->holder = NULL;
+    sem->depth = 0;
+    return sem;
+}
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char* pcName,
+                                   uint32_t usStackDepth, void* pvParameters,
+                                   UBaseType_t uxPriority, TaskHandle_t* pvCreatedTask,
+                                   BaseType_t xCoreID) {
+    TaskHandle_t task = new tskTaskControlBlock();
+    task->code = pvTaskCode;
+    task->params = pvParameters;
+    strncpy(task->name, pcName ? pcName : "", sizeof(task->name) - 1);
+    task->priority = uxPriority;
+    task->core = xCoreID;
+    task->notify_count = 0;
+
+    // Host frames are larger than Xtensa ones, so keep the default stack
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    native_clock_attach();
+    int rc = pthread_create(&thread, &attr, task_entry, task);
+    pthread_attr_destroy(&attr);
+
+    if (rc != 0) {
+        native_clock_detach();
+        delete task;
+        return pdFAIL;
+    }
+    if (pvCreatedTask) {
+        *pvCreatedTask = task;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char* pcName,
+                       uint32_t usStackDepth, void* pvParameters,
+                       UBaseType_t uxPriority, TaskHandle_t* pvCreatedTask) {
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters,
+                                   uxPriority, pvCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete) {
+    if (xTaskToDelete != NULL && xTaskToDelete != t_current) {
+        fprintf(stderr, "[HAL] vTaskDelete(%s) from another task is not supported\n",
+                xTaskToDelete->name);
+        return;
+    }
+    if (t_current == NULL) {
+        fprintf(stderr, "[HAL] vTaskDelete(NULL) outside a task\n");
+        return;
+    }
+
+    // The handle stays valid: other tasks may still hold it
+    native_clock_detach();
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+    if (xTicksToDelay == 0) {
+        native_clock_yield();
+        return;
+    }
+    native_clock_sleep_us((uint64_t)xTicksToDelay * portTICK_PERIOD_MS * 1000);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(millis() / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return current_task();
+}
+
+const char* pcTaskGetName(TaskHandle_t xTaskToQuery) {
+    return (xTaskToQuery ? xTaskToQuery : current_task())->name;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify) {
+    {
+        std::lock_guard<std::mutex> guard(xTaskToNotify->lock);
+        xTaskToNotify->notify_count++;
+    }
+    xTaskToNotify->wake.notify_one();
+    native_clock_kick();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+    TaskHandle_t task = current_task();
+    std::unique_lock<std::mutex> lock(task->lock);
+    wait_ticks(task->wake, lock, xTicksToWait, [task] { return task->notify_count > 0; });
+
+    uint32_t value = task->notify_count;
+    if (value > 0) {
+        task->notify_count = xClearCountOnExit ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xPortGetCoreID(void) {
+    BaseType_t core = current_task()->core;
+    return core == tskNO_AFFINITY ? 0 : core;
+}
+
+void vPortYield(void) {
+    native_clock_yield();
+}
+
+// ============================================================================
+// SEMAPHORES
+// ============================================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return create_semaphore(SEM_MUTEX, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    return create_semaphore(SEM_RECURSIVE, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return create_semaphore(SEM_BINARY, 0);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore) {
+    delete xSemaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime) {
+    std::unique_lock<std::mutex> lock(xSemaphore->lock);
+    if (!wait_ticks(xSemaphore->wake, lock, xBlockTime, [xSemaphore] { return xSemaphore->count > 0; })) {
+        return pdFALSE;
+    }
+    xSemaphore->count--;
+    xSemaphore->holder = current_task();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+    {
+        std::lock_guard<std::mutex> guard(xSemaphore->lock);
+        if (xSemaphore->count > 0) {
+            return pdFALSE;         // Already available
+        }
+        if (xSemaphore->kind != SEM_BINARY && xSemaphore->holder != current_task()) {
+            return pdFALSE;         // Only the holder gives a mutex back
+        }
+        xSemaphore->count = 1;
+        xSemaphore->holder = NULL;
+    }
+    xSemaphore->wake.notify_one();
+    native_clock_kick();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t xMutex, TickType_t xBlockTime) {
+    {
+        std::lock_guard<std::mutex> guard(xMutex->lock);
+        if (xMutex->holder == current_task() && xMutex->count == 0) {
+            xMutex->depth++;
+            return pdTRUE;
+        }
+    }
+    return xSemaphoreTake(xMutex, xBlockTime);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t xMutex) {
+    {
+        std::lock_guard<std::mutex> guard(xMutex->lock);
+        if (xMutex->holder != current_task()) {
+            return pdFALSE;
+        }
+        if (xMutex->depth > 0) {
+            xMutex->depth--;
+            return pdTRUE;
+        }
+    }
+    return xSemaphoreGive(xMutex);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file native_heap.cpp
+ * @brief Steady-state heap check for --heap-check
+ *
+ * At exit prints the heap monitor's totals (ucf_heap.h) and the call
+ * stack of each steady-state allocation it kept, as raw addresses that
+ * addr2line resolves. With --heap-check the process exits with status 1
+ * if the firmware allocated anything after start-up.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include "ucf_heap.h"
+#include <execinfo.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void print_line(const char* line, void* ctx) {
+    fprintf(stderr, "[HEAP] %s\n", line);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool native_heap_end(void) {
+    if (!native_hal_options()->heap_check) {
+        return true;
+    }
+
+    HeapStats stats;
+    heap_get_stats(&stats);
+    heap_write_text(print_line, NULL);
+    if (!stats.counted) {
+        fprintf(stderr, "[HEAP] Allocations not counted in this build (sanitizer)\n");
+        return true;
+    }
+
+    HeapSite sites[HEAP_MAX_SITES];
+    size_t count = heap_sites(sites, HEAP_MAX_SITES);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(stderr, "[HEAP] Allocation %zu: %lu bytes at\n", i + 1,
+                (unsigned long)sites[i].bytes);
+        // Straight to the descriptor: backtrace_symbols() would allocate
+        fflush(stderr);
+        backtrace_symbols_fd(sites[i].frames, sites[i].depth, STDERR_FILENO);
+    }
+    return stats.steady_allocs == 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file native_hmc5883l.cpp
+ * @brief Simulated HMC5883L magnetometer
+ *
+ * Registers as on the chip: configuration A/B and mode, data X/Z/Y
+ * big-endian, status, and the "H43" identification bytes. Data are scaled
+ * by the gain in configuration B and read -4096 when out of range.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include <atomic>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define HMC_REG_CONFIG_A    0x00
+#define HMC_REG_CONFIG_B    0x01
+#define HMC_REG_MODE        0x02
+#define HMC_REG_DATA_X_H    0x03
+#define HMC_REG_STATUS      0x09
+#define HMC_REG_ID_A        0x0A
+#define HMC_REG_LAST        0x0C
+
+#define HMC_MODE_IDLE_MASK  0x02
+#define HMC_OVERFLOW        -4096
+#define HMC_ROTATION_MS     60000   // Default field turns once a minute
+
+// LSB per gauss for configuration B gain settings 0-7
+static const uint16_t GAIN_LSB[8] = { 1370, 1090, 820, 660, 440, 390, 330, 230 };
+
+static std::atomic<bool> g_field_set(false);
+static std::atomic<float> g_field[3];
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static int16_t to_counts(float gauss, uint16_t lsb_per_gauss) {
+    float counts = gauss * lsb_per_gauss;
+    if (counts < -2048.0f || counts > 2047.0f) {
+        return HMC_OVERFLOW;
+    }
+    return (int16_t)lroundf(counts);
+}
+
+// ============================================================================
+// FIELD CONTROL
+// ============================================================================
+
+void native_hal_set_field(float x, float y, float z) {
+    g_field[0].store(x, std::memory_order_relaxed);
+    g_field[1].store(y, std::memory_order_relaxed);
+    g_field[2].store(z, std::memory_order_relaxed);
+    g_field_set.store(true, std::memory_order_release);
+}
+
+// ============================================================================
+// SIMULATED CHIP
+// ============================================================================
+
+NativeHmc5883l::NativeHmc5883l() : NativeRegisterDevice(NATIVE_HAL_HMC5883L_ADDR) {
+    m_regs[HMC_REG_CONFIG_A] = 0x10;
+    m_regs[HMC_REG_CONFIG_B] = 0x20;
+    m_regs[HMC_REG_MODE] = 0x01;
+    m_regs[HMC_REG_ID_A] = 'H';
+    m_regs[HMC_REG_ID_A + 1] = '4';
+    m_regs[HMC_REG_ID_A + 2] = '3';
+}
+
+void NativeHmc5883l::write_register(uint8_t reg, uint8_t value) {
+    if (reg <= HMC_REG_MODE) {
+        m_regs[reg] = value;
+    }
+}
+
+uint8_t NativeHmc5883l::next_register(uint8_t reg) const {
+    return reg >= HMC_REG_LAST ? 0 : (uint8_t)(reg + 1);
+}
+
+void NativeHmc5883l::refresh(void) {
+    if (m_regs[HMC_REG_MODE] & HMC_MODE_IDLE_MASK) {
+        return;
+    }
+
+    float field[3];
+    if (g_field_set.load(std::memory_order_acquire)) {
+        for (int i = 0; i < 3; i++) {
+            field[i] = g_field[i].load(std::memory_order_relaxed);
+        }
+    } else {
+        float heading = 2.0f * (float)M_PI * (float)(millis() % HMC_ROTATION_MS) / HMC_ROTATION_MS;
+        field[0] = 0.45f * cosf(heading);
+        field[1] = 0.45f * sinf(heading);
+        field[2] = -0.3f;
+    }
+
+    uint16_t lsb = GAIN_LSB[m_regs[HMC_REG_CONFIG_B] >> 5];
+    int16_t x = to_counts(field[0], lsb);
+    int16_t y = to_counts(field[1], lsb);
+    int16_t z = to_counts(field[2], lsb);
+
+    // Output order is X, Z, Y
+    const int16_t out[3] = { x, z, y };
+    for (int i = 0; i < 3; i++) {
+        m_regs[HMC_REG_DATA_X_H + 2 * i] = (uint8_t)((uint16_t)out[i] >> 8);
+        m_regs[HMC_REG_DATA_X_H + 2 * i + 1] = (uint8_t)((uint16_t)out[i] & 0xFF);
+    }
+    m_regs[HMC_REG_STATUS] = 0x01;  // RDY
+
+    // Single measurement mode drops back to idle
+    if ((m_regs[HMC_REG_MODE] & 0x03) == 0x01) {
+        m_regs[HMC_REG_MODE] |= 0x03;
+    }
+}
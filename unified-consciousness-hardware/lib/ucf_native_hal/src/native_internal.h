@@ -0,0 +1,229 @@
+/**
+ * @file native_internal.h
+ * @brief Private declarations shared by the native HAL sources
+ *
+ * Host only (POSIX).
+ */
+
+#ifndef NATIVE_INTERNAL_H
+#define NATIVE_INTERNAL_H
+
+#include "ucf_native_hal.h"
+#include <functional>
+#include <string>
+
+// ============================================================================
+// PROCESS
+// ============================================================================
+
+/**
+ * @brief Path of a file in the flash directory
+ */
+std::string native_hal_path(const char* name);
+
+/**
+ * @brief Re-execute the process with its original arguments
+ */
+[[noreturn]] void native_hal_restart(void);
+
+/**
+ * @brief Exit now, writing out the trace and loop report first
+ */
+[[noreturn]] void native_hal_exit(int code);
+
+/**
+ * @brief Open --record / --replay traces and start the trace writer
+ * @return false if a trace cannot be opened
+ */
+bool native_trace_begin(void);
+
+/**
+ * @brief Write out the recorded trace (before exit or restart)
+ */
+void native_trace_end(void);
+
+/**
+ * @brief Start timing scheduler ticks if --loop-report is set (before setup())
+ */
+void native_loop_begin(void);
+
+/**
+ * @brief Print the loop report and write its TSV (before exit or restart)
+ */
+void native_loop_end(void);
+
+/**
+ * @brief Collect every latency frame if --latency-trace is set (before setup())
+ */
+void native_latency_begin(void);
+
+/**
+ * @brief Report a touch's landing time to the latency tracer (once per touch)
+ */
+void native_latency_touch(uint32_t touch_ms);
+
+/**
+ * @brief Print the latency histograms and write the trace (before exit or restart)
+ */
+void native_latency_end(void);
+
+/**
+ * @brief Print the heap report if --heap-check is set (before exit, ahead of the other reports)
+ * @return false if the firmware allocated after heap_mark_steady()
+ */
+bool native_heap_end(void);
+
+/**
+ * @brief Latch the boot slot from otadata (the "running" partition)
+ */
+void native_flash_boot(void);
+
+/**
+ * @brief Register a NeoPixel strip's framebuffer
+ * @return Slot index, or -1 if all are in use
+ */
+int native_strip_register(int16_t pin, uint16_t count);
+
+/**
+ * @brief Publish a strip's pixels as its last shown frame
+ */
+void native_strip_publish(int slot, const uint8_t* pixels, uint32_t now_us);
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+
+#define NATIVE_CLOCK_NEVER  UINT64_MAX
+
+/**
+ * @brief Select wall or virtual time (before any thread starts)
+ */
+void native_clock_begin(bool virtual_time);
+
+/**
+ * @brief Check for virtual time
+ */
+bool native_clock_is_virtual(void);
+
+/**
+ * @brief Microseconds since start (wall or virtual)
+ */
+uint64_t native_clock_us(void);
+
+/**
+ * @brief Wall microseconds since start, whatever the mode
+ */
+uint64_t native_clock_wall_us(void);
+
+/**
+ * @brief Wait on the virtual clock until a deadline or a condition
+ *
+ * Virtual time only. @p ready is evaluated under the clock lock; whoever
+ * makes it true calls native_clock_kick() afterwards.
+ *
+ * @param deadline_us Virtual time to give up at (NATIVE_CLOCK_NEVER = none)
+ * @param ready Condition, or empty for a plain sleep
+ * @return true if @p ready became true, false at the deadline
+ */
+bool native_clock_block(uint64_t deadline_us, const std::function<bool()>& ready);
+
+/**
+ * @brief Wake virtual-time waiters to re-check their condition
+ */
+void native_clock_kick(void);
+
+/**
+ * @brief Sleep (wall) or wait on the virtual clock
+ */
+void native_clock_sleep_us(uint64_t us);
+
+/**
+ * @brief Busy-wait (wall) or wait on the virtual clock, as a device spin loop
+ */
+void native_clock_spin_us(uint64_t us);
+
+/**
+ * @brief Nanoseconds the calling thread has busy-waited in native_clock_spin_us()
+ */
+uint64_t native_clock_spun_ns(void);
+
+/**
+ * @brief Let other threads run; a busy thread in virtual time waits a little
+ */
+void native_clock_yield(void);
+
+/**
+ * @brief Count a new firmware thread (call before starting it)
+ */
+void native_clock_attach(void);
+
+/**
+ * @brief Stop counting the calling thread (before it exits)
+ */
+void native_clock_detach(void);
+
+// ============================================================================
+// SIMULATED DEVICES
+// ============================================================================
+
+/**
+ * @brief Register file with an auto-incrementing pointer
+ */
+class NativeRegisterDevice : public NativeI2cDevice {
+public:
+    explicit NativeRegisterDevice(uint8_t addr) : m_addr(addr) {}
+
+    uint8_t address(void) const override { return m_addr; }
+    void write(const uint8_t* data, size_t len) override;
+    void read(uint8_t* data, size_t len) override;
+
+protected:
+    /** Store a written byte (read-only registers ignore it) */
+    virtual void write_register(uint8_t reg, uint8_t value) = 0;
+    /** Bring the data registers up to date before a read */
+    virtual void refresh(void) = 0;
+    /** Register after @p reg when reading */
+    virtual uint8_t next_register(uint8_t reg) const { return (uint8_t)(reg + 1); }
+
+    uint8_t m_regs[256] = {};
+    uint8_t m_pointer = 0;
+
+private:
+    uint8_t m_addr;
+};
+
+/**
+ * @brief MPR121 with one hex cell on each enabled electrode
+ */
+class NativeMpr121 : public NativeRegisterDevice {
+public:
+    NativeMpr121(uint8_t addr, uint8_t first_cell, uint8_t cells);
+
+protected:
+    void write_register(uint8_t reg, uint8_t value) override;
+    void refresh(void) override;
+
+private:
+    void reset(void);
+    uint16_t baseline_counts(uint8_t cell) const;
+
+    uint8_t m_first_cell;
+    uint8_t m_cells;
+    uint16_t m_touched = 0;
+    uint32_t m_noise;
+};
+
+/**
+ * @brief HMC5883L in the field from native_hal_set_field()
+ */
+class NativeHmc5883l : public NativeRegisterDevice {
+public:
+    NativeHmc5883l();
+
+protected:
+    void write_register(uint8_t reg, uint8_t value) override;
+    void refresh(void) override;
+    uint8_t next_register(uint8_t reg) const override;
+};
+
+#endif // NATIVE_INTERNAL_H
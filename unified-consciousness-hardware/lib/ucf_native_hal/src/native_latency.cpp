@@ -0,0 +1,105 @@
+/**
+ * @file native_latency.cpp
+ * @brief Touch latency trace for --latency-trace
+ *
+ * Keeps every frame the firmware's tracer records (ucf_latency.h), not
+ * just its ring of recent ones, and at exit writes them as Chrome trace
+ * JSON and prints the per-hop histograms. The simulated MPR121s report
+ * each touch's landing time, so frames here start at the pad.
+ *
+ * Frame storage is reserved before setup() so that collecting does not
+ * show up in --heap-check; frames past it are dropped and counted.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include "ucf_latency.h"
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define LATENCY_MAX_FRAMES          131072  // About a day of the sweep scenario
+
+static std::mutex g_lock;
+static std::vector<LatFrame> g_frames;
+static uint32_t g_dropped = 0;
+static bool g_reported = false;
+static uint32_t g_last_touch_ms = UINT32_MAX;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void collect(const LatFrame* frame, void* ctx) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (g_reported) {
+        return;
+    }
+    if (g_frames.size() < g_frames.capacity()) {
+        g_frames.push_back(*frame);
+    } else {
+        g_dropped++;
+    }
+}
+
+static void write_line(const char* line, void* ctx) {
+    fprintf((FILE*)ctx, "%s\n", line);
+}
+
+static void print_line(const char* line, void* ctx) {
+    fprintf(stderr, "[LAT] %s\n", line);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void native_latency_begin(void) {
+    if (native_hal_options()->latency_path != NULL) {
+        g_frames.reserve(LATENCY_MAX_FRAMES);
+        lat_on_frame(collect, NULL);
+    }
+}
+
+void native_latency_touch(uint32_t touch_ms) {
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (touch_ms != g_last_touch_ms) {
+        g_last_touch_ms = touch_ms;
+        lat_touch((uint32_t)((uint64_t)touch_ms * 1000));
+    }
+}
+
+void native_latency_end(void) {
+    const char* path = native_hal_options()->latency_path;
+    if (path == NULL) {
+        return;
+    }
+
+    // Tasks keep running on the other threads until _exit()
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (g_reported) {
+        return;
+    }
+    g_reported = true;
+
+    lat_write_text(print_line, NULL);
+
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        fprintf(stderr, "[HAL] %s: %s\n", path, strerror(errno));
+        return;
+    }
+    lat_write_chrome(g_frames.data(), g_frames.size(), write_line, f);
+    fclose(f);
+    fprintf(stderr, "[LAT] %zu frames written to %s\n", g_frames.size(), path);
+    if (g_dropped > 0) {
+        fprintf(stderr, "[LAT] %lu frames dropped (more than %d)\n",
+                (unsigned long)g_dropped, LATENCY_MAX_FRAMES);
+    }
+}
@@ -0,0 +1,277 @@
+/**
+ * @file native_loop.cpp
+ * @brief Loop timing report for --loop-report
+ *
+ * Watches every Scheduler through the run hook and times each task run
+ * (the stages of a tick) and each pass that ran something (the tick). At
+ * exit it prints loops per second, each stage's p50/p99/max and the worst
+ * tick, then checks the worst tick of the scheduler holding "kuramoto"
+ * against its 1 ms period and that of the one holding "sensors" against
+ * 10 ms. The one number per build is the fit: the larger of the two
+ * ratios, at most 1.0 if the loop still fits.
+ *
+ * Times are device estimates: the HAL clock's time for the run (bus
+ * transfers, busy waits, blocking) plus the thread's CPU time outside busy
+ * waits scaled by --cpu-scale, the host's speed over the ESP32's for this
+ * code. The clock counts that CPU time once already in wall time and not
+ * at all in virtual time.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ucf_scheduler.h"
+#include "ucf_profiler.h"
+#include <mutex>
+#include <math.h>
+#include <time.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define LOOP_MAX_SCHEDULERS         4
+#define LOOP_KURAMOTO_DEADLINE_US   1000    // Kuramoto step period
+#define LOOP_SENSOR_DEADLINE_US     10000   // Sensor poll period
+
+/**
+ * @brief Duration distribution (device-estimated nanoseconds)
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t max_ns;
+    uint32_t buckets[PROF_BUCKETS];
+} LoopDist;
+
+typedef struct {
+    const Scheduler* sched;
+    char thread[16];                        // FreeRTOS task running it
+    uint64_t passes;                        // sched_run() calls
+    uint64_t first_us;                      // HAL clock at the first and last pass
+    uint64_t last_us;
+    LoopDist ticks;                         // Passes that ran a task
+    LoopDist stages[SCHED_MAX_TASKS];
+    uint32_t worst_tick_ms;                 // millis() at the worst tick
+    int8_t worst_stage;                     // Longest stage of the worst tick
+} LoopSched;
+
+/**
+ * @brief Per-thread run in progress
+ */
+typedef struct {
+    uint64_t clock_us;
+    uint64_t cpu_ns;
+    uint64_t spun_ns;
+    uint64_t tick_ns;                       // Stages of the current pass so far
+    uint32_t longest_ns;
+    int8_t longest_stage;
+} LoopRun;
+
+static std::mutex g_lock;
+static LoopSched g_scheds[LOOP_MAX_SCHEDULERS];
+static uint8_t g_sched_count = 0;
+static float g_cpu_scale = 1.0f;
+static bool g_reported = false;             // Report written; later runs are not counted
+static thread_local LoopRun t_run;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void dist_add(LoopDist* d, uint32_t ns) {
+    d->count++;
+    if (ns > d->max_ns) {
+        d->max_ns = ns;
+    }
+    d->buckets[prof_bucket_index(ns)]++;
+}
+
+static uint32_t dist_percentile_us(const LoopDist* d, float percent) {
+    uint32_t rank = (uint32_t)ceilf(percent / 100.0f * d->count);
+    uint32_t seen = 0;
+    for (int b = 0; b < PROF_BUCKETS; b++) {
+        seen += d->buckets[b];
+        if (seen >= rank && seen > 0) {
+            uint32_t upper = prof_bucket_upper((uint8_t)b);
+            return (upper < d->max_ns ? upper : d->max_ns) / 1000;
+        }
+    }
+    return 0;
+}
+
+static LoopSched* find_sched_locked(const Scheduler* s) {
+    if (g_reported) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < g_sched_count; i++) {
+        if (g_scheds[i].sched == s) {
+            return &g_scheds[i];
+        }
+    }
+    if (g_sched_count == LOOP_MAX_SCHEDULERS) {
+        return NULL;
+    }
+    LoopSched* ls = &g_scheds[g_sched_count++];
+    ls->sched = s;
+    strncpy(ls->thread, pcTaskGetName(NULL), sizeof(ls->thread) - 1);
+    ls->first_us = native_clock_us();
+    return ls;
+}
+
+static int find_stage(const Scheduler* s, const char* name) {
+    for (uint8_t i = 0; i < s->count; i++) {
+        if (strcmp(s->tasks[i].config.name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Estimate a run's duration on the device
+ */
+static uint32_t estimate_ns(void) {
+    uint64_t clock_ns = (native_clock_us() - t_run.clock_us) * 1000;
+    uint64_t cpu_ns = thread_cpu_ns() - t_run.cpu_ns;
+    uint64_t spun_ns = native_clock_spun_ns() - t_run.spun_ns;
+    double compute_ns = cpu_ns > spun_ns ? (double)(cpu_ns - spun_ns) : 0.0;
+
+    double scale = native_clock_is_virtual() ? g_cpu_scale : g_cpu_scale - 1.0f;
+    double ns = (double)clock_ns + compute_ns * scale;
+    return ns <= 0.0 ? 0 : (ns >= UINT32_MAX ? UINT32_MAX : (uint32_t)ns);
+}
+
+static void loop_hook(const Scheduler* s, const SchedTask* task, SchedHookEvent event) {
+    if (event == SCHED_HOOK_BEGIN) {
+        t_run.clock_us = native_clock_us();
+        t_run.spun_ns = native_clock_spun_ns();
+        t_run.cpu_ns = thread_cpu_ns();
+        return;
+    }
+
+    if (event == SCHED_HOOK_END) {
+        uint32_t ns = estimate_ns();
+        int8_t stage = (int8_t)(task - s->tasks);
+        t_run.tick_ns += ns;
+        if (ns >= t_run.longest_ns) {
+            t_run.longest_ns = ns;
+            t_run.longest_stage = stage;
+        }
+
+        std::lock_guard<std::mutex> guard(g_lock);
+        LoopSched* ls = find_sched_locked(s);
+        if (ls != NULL) {
+            dist_add(&ls->stages[stage], ns);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(g_lock);
+    LoopSched* ls = find_sched_locked(s);
+    if (ls != NULL) {
+        ls->passes++;
+        ls->last_us = native_clock_us();
+        if (t_run.tick_ns > 0) {
+            uint32_t ns = t_run.tick_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)t_run.tick_ns;
+            if (ns > ls->ticks.max_ns) {
+                ls->worst_tick_ms = millis();
+                ls->worst_stage = t_run.longest_stage;
+            }
+            dist_add(&ls->ticks, ns);
+        }
+    }
+    t_run.tick_ns = 0;
+    t_run.longest_ns = 0;
+}
+
+static void print_row(FILE* tsv, const LoopSched* ls, const char* stage, const LoopDist* d) {
+    uint32_t p50 = dist_percentile_us(d, 50.0f);
+    uint32_t p99 = dist_percentile_us(d, 99.0f);
+    fprintf(stderr, "[LOOP]   %-12s %9lu %8lu %8lu %8lu\n", stage, (unsigned long)d->count,
+            (unsigned long)p50, (unsigned long)p99, (unsigned long)(d->max_ns / 1000));
+    if (tsv != NULL) {
+        fprintf(tsv, "%s\t%s\t%lu\t%lu\t%lu\t%lu\n", ls->thread, stage, (unsigned long)d->count,
+                (unsigned long)p50, (unsigned long)p99, (unsigned long)(d->max_ns / 1000));
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void native_loop_begin(void) {
+    const NativeHalOptions* options = native_hal_options();
+    if (options->loop_report_path == NULL) {
+        return;
+    }
+    g_cpu_scale = options->cpu_scale;
+    sched_set_hook(loop_hook);
+}
+
+void native_loop_end(void) {
+    const NativeHalOptions* options = native_hal_options();
+    if (options->loop_report_path == NULL) {
+        return;
+    }
+
+    // Tasks keep running on the other threads until _exit()
+    std::lock_guard<std::mutex> guard(g_lock);
+    if (g_reported) {
+        return;
+    }
+    g_reported = true;
+
+    FILE* tsv = fopen(options->loop_report_path, "w");
+    if (tsv == NULL) {
+        fprintf(stderr, "[HAL] %s: %s\n", options->loop_report_path, strerror(errno));
+    } else {
+        fprintf(tsv, "# cpu_scale=%.2f virtual_time=%d\n", g_cpu_scale,
+                native_clock_is_virtual() ? 1 : 0);
+        fprintf(tsv, "# thread\tstage\truns\tp50_us\tp99_us\tmax_us\n");
+    }
+
+    float fit = 0.0f;
+    bool checked = false;
+    for (uint8_t i = 0; i < g_sched_count; i++) {
+        const LoopSched* ls = &g_scheds[i];
+        double seconds = (ls->last_us - ls->first_us) / 1e6;
+        uint32_t worst_us = ls->ticks.max_ns / 1000;
+
+        fprintf(stderr, "[LOOP] %s: %.0f loops/s, %.0f ticks/s, worst tick %lu us at %lu ms (%s)\n",
+                ls->thread, seconds > 0 ? ls->passes / seconds : 0.0,
+                seconds > 0 ? ls->ticks.count / seconds : 0.0, (unsigned long)worst_us,
+                (unsigned long)ls->worst_tick_ms,
+                ls->ticks.count ? ls->sched->tasks[ls->worst_stage].config.name : "-");
+        fprintf(stderr, "[LOOP]   %-12s %9s %8s %8s %8s\n", "stage", "runs", "p50 us", "p99 us", "max us");
+        for (uint8_t t = 0; t < ls->sched->count; t++) {
+            print_row(tsv, ls, ls->sched->tasks[t].config.name, &ls->stages[t]);
+        }
+        print_row(tsv, ls, "tick", &ls->ticks);
+
+        if (find_stage(ls->sched, "kuramoto") >= 0) {
+            fit = fmaxf(fit, (float)worst_us / LOOP_KURAMOTO_DEADLINE_US);
+            checked = true;
+        }
+        if (find_stage(ls->sched, "sensors") >= 0) {
+            fit = fmaxf(fit, (float)worst_us / LOOP_SENSOR_DEADLINE_US);
+            checked = true;
+        }
+    }
+
+    const char* verdict = !checked ? "UNCHECKED" : (fit <= 1.0f ? "FITS" : "LATE");
+    fprintf(stderr, "[LOOP] fit %.3f %s (worst tick over the %u us Kuramoto and %u us sensor periods, cpu scale %.2f)\n",
+            fit, verdict, LOOP_KURAMOTO_DEADLINE_US, LOOP_SENSOR_DEADLINE_US, g_cpu_scale);
+    if (tsv != NULL) {
+        fprintf(tsv, "fit\t%.3f\t%s\n", fit, verdict);
+        fclose(tsv);
+    }
+}
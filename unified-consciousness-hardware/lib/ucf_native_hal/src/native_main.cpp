@@ -0,0 +1,282 @@
+/**
+ * @file native_main.cpp
+ * @brief Process entry point for the native firmware build
+ *
+ * Does what the arduino-esp32 loopTask does: setup() once, then loop()
+ * forever. HAL messages go to stderr so stdout carries exactly what the
+ * device would send over its serial port.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static NativeHalOptions g_options = {
+    "ucf_native_flash",             // flash_dir
+    NATIVE_SCENARIO_SWEEP,          // scenario
+    0,                              // run_seconds
+    1,                              // seed
+    false,                          // stock_partitions
+    false,                          // fast_bus
+    NULL,                           // record_path
+    NULL,                           // replay_path
+    false,                          // virtual_time
+    NULL,                           // loop_report_path
+    1.0f,                           // cpu_scale
+    NULL,                           // latency_path
+    false,                          // heap_check
+    -1                              // mesh_node
+};
+
+static char** g_argv = NULL;
+
+static NativeMpr121 g_mpr121_a(NATIVE_HAL_MPR121_ADDR_A, 0, 12);
+static NativeMpr121 g_mpr121_b(NATIVE_HAL_MPR121_ADDR_B, 12, NATIVE_HAL_CELL_COUNT - 12);
+static NativeHmc5883l g_hmc5883l;
+
+static const char* SCENARIO_NAMES[NATIVE_SCENARIO_COUNT] = { "idle", "sweep", "press" };
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --flash DIR          EEPROM and partition images (default ucf_native_flash)\n"
+            "  --scenario NAME      touch script: idle, sweep, press (default sweep)\n"
+            "  --seconds N          exit after N seconds (default: run until interrupted)\n"
+            "  --seed N             random() and sensor noise seed (default 1)\n"
+            "  --stock-partitions   no ucfstore/ucflog partitions (EEPROM fallback)\n"
+            "  --fast-bus           I2C and LED transfers complete instantly\n"
+            "  --record FILE        write a sensor trace (ucf_trace.h)\n"
+            "  --replay FILE        feed the firmware a recorded sensor trace, exit at its end\n"
+            "  --virtual-time       simulated clock: code takes no time, idle time is skipped\n"
+            "  --loop-report FILE   time every scheduler tick, write a TSV report at exit\n"
+            "  --cpu-scale X        device / host compute time for the loop report (default 1)\n"
+            "  --latency-trace FILE write touch-to-output latencies as Chrome trace JSON at exit\n"
+            "  --heap-check         exit with status 1 if anything is allocated after start-up\n"
+            "  --mesh-node N        ESP-NOW over loopback UDP as node N (0-7) of a host mesh\n",
+            argv0);
+}
+
+static void deadline_thread(uint32_t seconds) {
+    native_clock_sleep_us((uint64_t)seconds * 1000000);
+    fflush(stdout);
+    if (native_clock_is_virtual()) {
+        double wall_s = native_clock_wall_us() / 1e6;
+        fprintf(stderr, "[HAL] %lu s elapsed in %.1f s (%.0fx), exiting\n",
+                (unsigned long)seconds, wall_s, wall_s > 0 ? seconds / wall_s : 0.0);
+    } else {
+        fprintf(stderr, "[HAL] %lu s elapsed, exiting\n", (unsigned long)seconds);
+    }
+    native_hal_exit(0);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+const NativeHalOptions* native_hal_options(void) {
+    return &g_options;
+}
+
+const char* native_hal_scenario_name(NativeScenario scenario) {
+    return scenario < NATIVE_SCENARIO_COUNT ? SCENARIO_NAMES[scenario] : "unknown";
+}
+
+bool native_hal_parse_args(NativeHalOptions* options, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--stock-partitions") == 0) {
+            options->stock_partitions = true;
+        } else if (strcmp(arg, "--fast-bus") == 0) {
+            options->fast_bus = true;
+        } else if (strcmp(arg, "--virtual-time") == 0) {
+            options->virtual_time = true;
+        } else if (strcmp(arg, "--heap-check") == 0) {
+            options->heap_check = true;
+        } else if (value != NULL && strcmp(arg, "--flash") == 0) {
+            options->flash_dir = value;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--seconds") == 0) {
+            options->run_seconds = (uint32_t)strtoul(value, NULL, 10);
+            i++;
+        } else if (value != NULL && strcmp(arg, "--record") == 0) {
+            options->record_path = value;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--replay") == 0) {
+            options->replay_path = value;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--loop-report") == 0) {
+            options->loop_report_path = value;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--latency-trace") == 0) {
+            options->latency_path = value;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--cpu-scale") == 0) {
+            options->cpu_scale = strtof(value, NULL);
+            if (options->cpu_scale <= 0.0f) {
+                fprintf(stderr, "Bad CPU scale: %s\n", value);
+                return false;
+            }
+            i++;
+        } else if (value != NULL && strcmp(arg, "--mesh-node") == 0) {
+            char* end;
+            long node = strtol(value, &end, 10);
+            if (*end != '\0' || node < 0 || node >= NATIVE_HAL_MESH_NODES) {
+                fprintf(stderr, "Bad mesh node: %s\n", value);
+                return false;
+            }
+            options->mesh_node = (int)node;
+            i++;
+        } else if (value != NULL && strcmp(arg, "--seed") == 0) {
+            options->seed = (uint32_t)strtoul(value, NULL, 10);
+            i++;
+        } else if (value != NULL && strcmp(arg, "--scenario") == 0) {
+            int found = -1;
+            for (int s = 0; s < NATIVE_SCENARIO_COUNT; s++) {
+                if (strcmp(value, SCENARIO_NAMES[s]) == 0) {
+                    found = s;
+                }
+            }
+            if (found < 0) {
+                fprintf(stderr, "Unknown scenario: %s\n", value);
+                return false;
+            }
+            options->scenario = (NativeScenario)found;
+            i++;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void native_hal_bus_wait(uint32_t us) {
+    if (g_options.fast_bus || us == 0) {
+        return;
+    }
+    if (native_clock_is_virtual()) {
+        native_clock_sleep_us(us);
+        return;
+    }
+
+    // Sleeping is too coarse for transfers this short, so spin like the caller would block
+    native_clock_spin_us(us);
+}
+
+std::string native_hal_path(const char* name) {
+    return std::string(g_options.flash_dir) + "/" + name;
+}
+
+int native_hal_open_image(const char* name, size_t size) {
+    std::string path = native_hal_path(name);
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[HAL] %s: %s\n", path.c_str(), strerror(errno));
+        return -1;
+    }
+
+    // New or short images are padded with erased flash
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size < size) {
+        uint8_t erased[SPI_FLASH_SEC_SIZE];
+        memset(erased, 0xFF, sizeof(erased));
+        for (size_t off = (size_t)st.st_size; off < size; off += sizeof(erased)) {
+            size_t n = (size - off < sizeof(erased)) ? size - off : sizeof(erased);
+            if (pwrite(fd, erased, n, (off_t)off) != (ssize_t)n) {
+                close(fd);
+                return -1;
+            }
+        }
+    }
+    return fd;
+}
+
+void native_hal_exit(int code) {
+    fflush(stdout);
+    // Verdict first: the report writers below allocate (fopen, stdio buffers)
+    if (!native_heap_end() && code == 0) {
+        code = 1;
+    }
+    native_trace_end();
+    native_loop_end();
+    native_latency_end();
+    // Like pulling the plug: no destructors run under the firmware's tasks
+    _exit(code);
+}
+
+void native_hal_restart(void) {
+    fflush(stdout);
+    fprintf(stderr, "[HAL] Restart\n");
+    native_trace_end();
+    native_loop_end();
+    native_latency_end();
+    execv("/proc/self/exe", g_argv);
+    fprintf(stderr, "[HAL] Restart failed: %s\n", strerror(errno));
+    _exit(1);
+}
+
+// ============================================================================
+// ENTRY POINT
+// ============================================================================
+
+int main(int argc, char** argv) {
+    if (!native_hal_parse_args(&g_options, argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+    g_argv = argv;
+
+    if (mkdir(g_options.flash_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[HAL] %s: %s\n", g_options.flash_dir, strerror(errno));
+        return 1;
+    }
+
+    // Serial lines reach a pipe as they are printed
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    native_clock_begin(g_options.virtual_time);
+
+    randomSeed(g_options.seed);
+    native_hal_attach_i2c(&g_mpr121_a);
+    native_hal_attach_i2c(&g_mpr121_b);
+    native_hal_attach_i2c(&g_hmc5883l);
+    native_flash_boot();
+
+    fprintf(stderr, "[HAL] flash %s%s, scenario %s, seed %lu%s%s\n", g_options.flash_dir,
+            g_options.stock_partitions ? " (stock partitions)" : "",
+            native_hal_scenario_name(g_options.scenario), (unsigned long)g_options.seed,
+            g_options.fast_bus ? ", fast bus" : "",
+            g_options.virtual_time ? ", virtual time" : "");
+
+    if (!native_trace_begin()) {
+        return 1;
+    }
+    if (g_options.run_seconds > 0) {
+        native_clock_attach();
+        std::thread(deadline_thread, g_options.run_seconds).detach();
+    }
+
+    native_loop_begin();
+    native_latency_begin();
+    setup();
+    for (;;) {
+        loop();
+        native_clock_yield();
+    }
+}
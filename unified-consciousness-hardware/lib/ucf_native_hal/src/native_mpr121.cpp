@@ -0,0 +1,300 @@
+/**
+ * @file native_mpr121.cpp
+ * @brief Simulated MPR121s, their Adafruit driver and the touch scenarios
+ *
+ * Each electrode reads a fixed per-cell baseline (600-760 counts) with
+ * +/-2 counts of noise; a touch pulls the filtered data down by up to 140
+ * counts, past the firmware's 100-count full scale. Touch status follows
+ * the touch/release threshold registers like the chip's own detector.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Adafruit_MPR121.h>
+#include <atomic>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define MPR121_ELECTRODES       12
+#define MPR121_TOUCH_DEPTH      140.0f  // Counts at full contact
+#define MPR121_NOISE_COUNTS     2
+
+#define SWEEP_DWELL_MS          400     // Per cell
+#define SWEEP_RAMP_MS           80      // Finger landing / lifting
+#define SWEEP_PERIOD_MS         10000   // 19 cells, then a pause
+#define PRESS_PERIOD_MS         12000
+
+static std::atomic<float> g_touch_override[NATIVE_HAL_CELL_COUNT];
+static std::atomic<uint32_t> g_override_landed_ms[NATIVE_HAL_CELL_COUNT];
+
+// ============================================================================
+// TOUCH SCENARIOS
+// ============================================================================
+
+static float sweep_strength(uint8_t cell, uint32_t t) {
+    uint32_t phase = t % SWEEP_PERIOD_MS;
+    if (phase / SWEEP_DWELL_MS != cell) {
+        return 0.0f;
+    }
+    uint32_t in_dwell = phase % SWEEP_DWELL_MS;
+    if (in_dwell < SWEEP_RAMP_MS) {
+        return (float)in_dwell / SWEEP_RAMP_MS;
+    }
+    if (in_dwell > SWEEP_DWELL_MS - SWEEP_RAMP_MS) {
+        return (float)(SWEEP_DWELL_MS - in_dwell) / SWEEP_RAMP_MS;
+    }
+    return 1.0f;
+}
+
+static float press_strength(uint32_t t) {
+    float phase = (float)(t % PRESS_PERIOD_MS) / PRESS_PERIOD_MS;
+    return 0.5f - 0.5f * cosf(2.0f * (float)M_PI * phase);
+}
+
+/**
+ * @brief When the finger on a touched cell landed (for the latency trace)
+ */
+static uint32_t touch_landed_ms(uint8_t cell, uint32_t now_ms) {
+    if (g_touch_override[cell].load(std::memory_order_relaxed) > 0.0f) {
+        return g_override_landed_ms[cell].load(std::memory_order_relaxed);
+    }
+
+    uint32_t t = now_ms - NATIVE_HAL_LEAD_IN_MS;
+    switch (native_hal_options()->scenario) {
+        case NATIVE_SCENARIO_SWEEP: return now_ms - (t % SWEEP_PERIOD_MS) % SWEEP_DWELL_MS;
+        case NATIVE_SCENARIO_PRESS: return now_ms - t % PRESS_PERIOD_MS;
+        default:                    return now_ms;
+    }
+}
+
+void native_hal_set_touch(uint8_t cell, float strength) {
+    if (cell < NATIVE_HAL_CELL_COUNT) {
+        strength = constrain(strength, 0.0f, 1.0f);
+        if (strength > 0.0f && g_touch_override[cell].load(std::memory_order_relaxed) == 0.0f) {
+            g_override_landed_ms[cell].store(millis(), std::memory_order_relaxed);
+        }
+        g_touch_override[cell].store(strength, std::memory_order_relaxed);
+    }
+}
+
+float native_hal_touch_strength(uint8_t cell, uint32_t now_ms) {
+    if (cell >= NATIVE_HAL_CELL_COUNT) {
+        return 0.0f;
+    }
+
+    float manual = g_touch_override[cell].load(std::memory_order_relaxed);
+    if (manual > 0.0f) {
+        return manual;
+    }
+
+    // Hands off while the firmware calibrates
+    if (now_ms < NATIVE_HAL_LEAD_IN_MS) {
+        return 0.0f;
+    }
+    uint32_t t = now_ms - NATIVE_HAL_LEAD_IN_MS;
+
+    switch (native_hal_options()->scenario) {
+        case NATIVE_SCENARIO_SWEEP: return sweep_strength(cell, t);
+        case NATIVE_SCENARIO_PRESS: return press_strength(t);
+        default:                    return 0.0f;
+    }
+}
+
+// ============================================================================
+// SIMULATED CHIP
+// ============================================================================
+
+NativeMpr121::NativeMpr121(uint8_t addr, uint8_t first_cell, uint8_t cells)
+    : NativeRegisterDevice(addr), m_first_cell(first_cell), m_cells(cells), m_noise(addr) {
+    reset();
+}
+
+void NativeMpr121::reset(void) {
+    memset(m_regs, 0, sizeof(m_regs));
+    m_regs[MPR121_CONFIG1] = 0x10;
+    m_regs[MPR121_CONFIG2] = 0x24;
+    m_pointer = 0;
+    m_touched = 0;
+    m_noise = address() * 2654435761u + native_hal_options()->seed;
+}
+
+uint16_t NativeMpr121::baseline_counts(uint8_t cell) const {
+    return (uint16_t)(600 + (cell * 53) % 160);
+}
+
+void NativeMpr121::write_register(uint8_t reg, uint8_t value) {
+    if (reg == MPR121_SOFTRESET) {
+        if (value == 0x63) {
+            reset();
+        }
+        return;
+    }
+    // Status, data and baseline registers are read-only
+    if (reg > MPR121_BASELINE_0 + MPR121_ELECTRODES) {
+        m_regs[reg] = value;
+    }
+}
+
+void NativeMpr121::refresh(void) {
+    uint8_t enabled = m_regs[MPR121_ECR] & 0x0F;
+    if (enabled > MPR121_ELECTRODES) {
+        enabled = MPR121_ELECTRODES;
+    }
+    uint32_t now = millis();
+    int landed_cell = -1;
+
+    for (uint8_t e = 0; e < MPR121_ELECTRODES; e++) {
+        uint16_t filtered = 0;
+        uint16_t baseline = 0;
+
+        if (e < enabled) {
+            uint8_t cell = (uint8_t)(m_first_cell + e);
+            baseline = baseline_counts(cell);
+            float strength = (e < m_cells) ? native_hal_touch_strength(cell, now) : 0.0f;
+            if (strength > 0.0f) {
+                landed_cell = cell;
+            }
+
+            m_noise = m_noise * 1664525u + 1013904223u;
+            int noise = (int)((m_noise >> 16) % (2 * MPR121_NOISE_COUNTS + 1)) - MPR121_NOISE_COUNTS;
+            int counts = (int)baseline - (int)(strength * MPR121_TOUCH_DEPTH) + noise;
+            filtered = (uint16_t)constrain(counts, 0, 1023);
+
+            int delta = (int)baseline - (int)filtered;
+            uint16_t bit = (uint16_t)(1u << e);
+            if (delta > m_regs[MPR121_TOUCHTH_0 + 2 * e]) {
+                m_touched |= bit;
+            } else if (delta < m_regs[MPR121_RELEASETH_0 + 2 * e]) {
+                m_touched &= (uint16_t)~bit;
+            }
+        }
+
+        m_regs[MPR121_FILTDATA_0L + 2 * e] = (uint8_t)(filtered & 0xFF);
+        m_regs[MPR121_FILTDATA_0H + 2 * e] = (uint8_t)(filtered >> 8);
+        m_regs[MPR121_BASELINE_0 + e] = (uint8_t)(baseline >> 2);
+    }
+
+    m_touched &= (uint16_t)((1u << enabled) - 1);
+    m_regs[MPR121_TOUCHSTATUS_L] = (uint8_t)(m_touched & 0xFF);
+    m_regs[MPR121_TOUCHSTATUS_H] = (uint8_t)(m_touched >> 8);
+
+    if (landed_cell >= 0) {
+        native_latency_touch(touch_landed_ms((uint8_t)landed_cell, now));
+    }
+}
+
+// ============================================================================
+// ADAFRUIT DRIVER
+// ============================================================================
+
+bool Adafruit_MPR121::begin(uint8_t i2caddr, TwoWire* theWire, uint8_t touchThreshold,
+                            uint8_t releaseThreshold, bool autoconfig) {
+    m_wire = theWire;
+    m_addr = i2caddr;
+
+    // Soft reset, then stop mode for configuration
+    writeRegister(MPR121_SOFTRESET, 0x63);
+    delay(1);
+    writeRegister(MPR121_ECR, 0x00);
+
+    // CONFIG2 reads 0x24 after reset; anything else is not an MPR121
+    if (readRegister8(MPR121_CONFIG2) != 0x24) {
+        return false;
+    }
+
+    setThresholds(touchThreshold, releaseThreshold);
+    writeRegister(MPR121_MHDR, 0x01);
+    writeRegister(MPR121_NHDR, 0x01);
+    writeRegister(MPR121_NCLR, 0x0E);
+    writeRegister(MPR121_FDLR, 0x00);
+    writeRegister(MPR121_MHDF, 0x01);
+    writeRegister(MPR121_NHDF, 0x05);
+    writeRegister(MPR121_NCLF, 0x01);
+    writeRegister(MPR121_FDLF, 0x00);
+    writeRegister(MPR121_NHDT, 0x00);
+    writeRegister(MPR121_NCLT, 0x00);
+    writeRegister(MPR121_FDLT, 0x00);
+    writeRegister(MPR121_DEBOUNCE, 0);
+    writeRegister(MPR121_CONFIG1, 0x10);
+    writeRegister(MPR121_CONFIG2, 0x20);
+
+    if (autoconfig) {
+        writeRegister(MPR121_AUTOCONFIG0, 0x0B);
+        writeRegister(MPR121_UPLIMIT, 200);
+        writeRegister(MPR121_TARGETLIMIT, 180);
+        writeRegister(MPR121_LOWLIMIT, 130);
+    }
+
+    // Run mode: baseline tracking on, all 12 electrodes
+    writeRegister(MPR121_ECR, 0x8C);
+    return true;
+}
+
+uint16_t Adafruit_MPR121::filteredData(uint8_t t) {
+    if (t > 12) {
+        return 0;
+    }
+    return readRegister16(MPR121_FILTDATA_0L + t * 2);
+}
+
+uint16_t Adafruit_MPR121::baselineData(uint8_t t) {
+    if (t > 12) {
+        return 0;
+    }
+    return (uint16_t)(readRegister8(MPR121_BASELINE_0 + t) << 2);
+}
+
+uint16_t Adafruit_MPR121::touched(void) {
+    return readRegister16(MPR121_TOUCHSTATUS_L) & 0x0FFF;
+}
+
+void Adafruit_MPR121::setThresholds(uint8_t touch, uint8_t release) {
+    for (uint8_t i = 0; i < 12; i++) {
+        writeRegister(MPR121_TOUCHTH_0 + 2 * i, touch);
+        writeRegister(MPR121_RELEASETH_0 + 2 * i, release);
+    }
+}
+
+uint8_t Adafruit_MPR121::readRegister8(uint8_t reg) {
+    m_wire->beginTransmission(m_addr);
+    m_wire->write(reg);
+    if (m_wire->endTransmission(false) != 0 || m_wire->requestFrom(m_addr, (uint8_t)1) != 1) {
+        return 0;
+    }
+    return (uint8_t)m_wire->read();
+}
+
+uint16_t Adafruit_MPR121::readRegister16(uint8_t reg) {
+    m_wire->beginTransmission(m_addr);
+    m_wire->write(reg);
+    if (m_wire->endTransmission(false) != 0 || m_wire->requestFrom(m_addr, (uint8_t)2) != 2) {
+        return 0;
+    }
+    uint16_t lo = (uint16_t)m_wire->read();
+    uint16_t hi = (uint16_t)m_wire->read();
+    return (uint16_t)(lo | (hi << 8));
+}
+
+void Adafruit_MPR121::writeRegister(uint8_t reg, uint8_t value) {
+    // The chip only takes configuration in stop mode
+    bool stop_required = (reg != MPR121_ECR) && (reg < 0x73 || reg > 0x7A);
+    uint8_t ecr = 0;
+    if (stop_required) {
+        ecr = readRegister8(MPR121_ECR);
+        if (ecr != 0) {
+            writeRegister(MPR121_ECR, 0x00);
+        }
+    }
+
+    m_wire->beginTransmission(m_addr);
+    m_wire->write(reg);
+    m_wire->write(value);
+    m_wire->endTransmission();
+
+    if (stop_required && ecr != 0) {
+        writeRegister(MPR121_ECR, ecr);
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file native_neopixel.cpp
+ * @brief NeoPixel strips as framebuffers
+ *
+ * Pixel and brightness handling follow the Adafruit library so colours
+ * are scaled (and lose precision) exactly as on the device.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Adafruit_NeoPixel.h>
+#include <mutex>
+#include <vector>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define NEOPIXEL_US_PER_PIXEL   30      // 24 bits at 800 kHz
+#define NEOPIXEL_LATCH_US       300     // Reset time before the next frame
+
+typedef struct {
+    int16_t pin;
+    uint16_t count;
+    uint32_t frames;
+    uint32_t last_show_us;
+    std::vector<uint8_t> shown;
+} StripSlot;
+
+static std::mutex g_strip_lock;
+static StripSlot g_strips[NATIVE_HAL_MAX_STRIPS];
+static int g_strip_count = 0;
+
+// ============================================================================
+// FRAMEBUFFERS
+// ============================================================================
+
+int native_strip_register(int16_t pin, uint16_t count) {
+    std::lock_guard<std::mutex> guard(g_strip_lock);
+    for (int i = 0; i < g_strip_count; i++) {
+        if (g_strips[i].pin == pin) {
+            g_strips[i].count = count;
+            g_strips[i].shown.assign((size_t)count * 3, 0);
+            return i;
+        }
+    }
+    if (g_strip_count >= NATIVE_HAL_MAX_STRIPS) {
+        return -1;
+    }
+
+    StripSlot& slot = g_strips[g_strip_count];
+    slot.pin = pin;
+    slot.count = count;
+    slot.frames = 0;
+    slot.last_show_us = 0;
+    slot.shown.assign((size_t)count * 3, 0);
+    return g_strip_count++;
+}
+
+void native_strip_publish(int slot, const uint8_t* pixels, uint32_t now_us) {
+    std::lock_guard<std::mutex> guard(g_strip_lock);
+    StripSlot& strip = g_strips[slot];
+    memcpy(strip.shown.data(), pixels, strip.shown.size());
+    strip.frames++;
+    strip.last_show_us = now_us;
+}
+
+bool native_hal_led_frame(int16_t pin, NativeLedFrame* frame) {
+    static thread_local std::vector<uint8_t> snapshot;
+
+    std::lock_guard<std::mutex> guard(g_strip_lock);
+    for (int i = 0; i < g_strip_count; i++) {
+        if (g_strips[i].pin == pin) {
+            snapshot = g_strips[i].shown;
+            frame->pin = pin;
+            frame->count = g_strips[i].count;
+            frame->frames = g_strips[i].frames;
+            frame->last_show_us = g_strips[i].last_show_us;
+            frame->pixels = snapshot.data();
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// ADAFRUIT NEOPIXEL
+// ============================================================================
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+    : m_count(n), m_pin(pin) {
+    m_r_offset = (uint8_t)((type >> 4) & 0x03);
+    m_g_offset = (uint8_t)((type >> 2) & 0x03);
+    m_b_offset = (uint8_t)(type & 0x03);
+    m_pixels = (uint8_t*)calloc((size_t)n * 3, 1);
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+    free(m_pixels);
+}
+
+void Adafruit_NeoPixel::begin(void) {
+    pinMode((uint8_t)m_pin, OUTPUT);
+    digitalWrite((uint8_t)m_pin, LOW);
+    m_slot = native_strip_register(m_pin, m_count);
+    m_begun = true;
+}
+
+bool Adafruit_NeoPixel::canShow(void) const {
+    return (uint32_t)(micros() - m_end_time_us) >= NEOPIXEL_LATCH_US;
+}
+
+void Adafruit_NeoPixel::show(void) {
+    if (!m_pixels || !m_begun || m_slot < 0) {
+        return;
+    }
+
+    // Waited out like the transfer, so virtual time moves and --fast-bus skips it
+    uint32_t since_us = micros() - m_end_time_us;
+    if (since_us < NEOPIXEL_LATCH_US) {
+        native_hal_bus_wait(NEOPIXEL_LATCH_US - since_us);
+    }
+    native_strip_publish(m_slot, m_pixels, micros());
+    native_hal_bus_wait((uint32_t)m_count * NEOPIXEL_US_PER_PIXEL);
+    m_end_time_us = micros();
+}
+
+void Adafruit_NeoPixel::clear(void) {
+    memset(m_pixels, 0, (size_t)m_count * 3);
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+    if (n >= m_count) {
+        return;
+    }
+    if (m_brightness) {
+        r = (uint8_t)((r * m_brightness) >> 8);
+        g = (uint8_t)((g * m_brightness) >> 8);
+        b = (uint8_t)((b * m_brightness) >> 8);
+    }
+    uint8_t* p = &m_pixels[n * 3];
+    p[m_r_offset] = r;
+    p[m_g_offset] = g;
+    p[m_b_offset] = b;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+    setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const {
+    if (n >= m_count) {
+        return 0;
+    }
+    const uint8_t* p = &m_pixels[n * 3];
+    if (m_brightness) {
+        // Stored values were scaled down; this is only an approximation back
+        return (((uint32_t)(p[m_r_offset] << 8) / m_brightness) << 16) |
+               (((uint32_t)(p[m_g_offset] << 8) / m_brightness) << 8) |
+               ((uint32_t)(p[m_b_offset] << 8) / m_brightness);
+    }
+    return ((uint32_t)p[m_r_offset] << 16) | ((uint32_t)p[m_g_offset] << 8) | p[m_b_offset];
+}
+
+void Adafruit_NeoPixel::setBrightness(uint8_t b) {
+    // Stored +1 so 0 means full scale; existing pixels are rescaled in place
+    uint8_t new_brightness = (uint8_t)(b + 1);
+    if (new_brightness == m_brightness) {
+        return;
+    }
+
+    uint8_t old_brightness = (uint8_t)(m_brightness - 1);
+    uint16_t scale;
+    if (old_brightness == 0) {
+        scale = 0;
+    } else if (b == 255) {
+        scale = (uint16_t)(65535 / old_brightness);
+    } else {
+        scale = (uint16_t)((((uint16_t)new_brightness << 8) - 1) / old_brightness);
+    }
+    for (size_t i = 0; i < (size_t)m_count * 3; i++) {
+        m_pixels[i] = (uint8_t)((m_pixels[i] * scale) >> 8);
+    }
+    m_brightness = new_brightness;
+}
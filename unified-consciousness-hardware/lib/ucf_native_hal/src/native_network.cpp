@@ -0,0 +1,68 @@
+/**
+ * @file native_network.cpp
+ * @brief WiFi and ArduinoOTA without a network
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <WiFi.h>
+#include <ArduinoOTA.h>
+
+WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+
+// ============================================================================
+// ARDUINO OTA
+// ============================================================================
+
+ArduinoOTAClass& ArduinoOTAClass::setHostname(const char* hostname) {
+    m_hostname = hostname;
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::setPort(uint16_t port) {
+    m_port = port;
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::setPassword(const char* password) {
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::setRebootOnSuccess(bool reboot) {
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::onStart(THandlerFunction fn) {
+    m_start = fn;
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::onEnd(THandlerFunction fn) {
+    m_end = fn;
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::onError(THandlerFunction_Error fn) {
+    m_error = fn;
+    return *this;
+}
+
+ArduinoOTAClass& ArduinoOTAClass::onProgress(THandlerFunction_Progress fn) {
+    m_progress = fn;
+    return *this;
+}
+
+void ArduinoOTAClass::begin(void) {
+    m_started = true;
+    fprintf(stderr, "[HAL] ArduinoOTA %s:%u has no network, no update will arrive\n",
+            m_hostname.c_str(), m_port);
+}
+
+void ArduinoOTAClass::end(void) {
+    m_started = false;
+}
+
+void ArduinoOTAClass::handle(void) {
+}
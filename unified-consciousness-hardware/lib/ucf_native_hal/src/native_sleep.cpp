@@ -0,0 +1,311 @@
+/**
+ * @file native_sleep.cpp
+ * @brief esp_timer, light sleep and their driver calls on the host
+ *
+ * One dispatcher thread runs the expired one-shot timers' callbacks, as
+ * the device's esp_timer task does. It counts as a virtual-time
+ * participant, so a timer deadline is a wake-up time like any task's.
+ *
+ * Light sleep blocks only the caller (the other threads are not stopped)
+ * until the timer wake-up, or until console input is waiting when UART
+ * wake-up is enabled. GPIO wake-up is accepted but nothing drives the
+ * pins, so it never fires. In virtual time console input is only seen at
+ * the start of a sleep.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <driver/uart.h>
+#include <driver/gpio.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    const char* name;
+    bool armed;                     // Under g_timer_lock
+    uint64_t deadline_us;
+    struct esp_timer* next;
+};
+
+static std::mutex g_timer_lock;
+static std::condition_variable g_timer_wake;
+static esp_timer_handle_t g_timers = NULL;      // Under g_timer_lock
+static bool g_timers_changed = false;           // Under g_timer_lock
+static bool g_dispatcher_started = false;       // Under g_timer_lock
+
+static uint64_t g_sleep_timer_us = 0;
+static bool g_uart_wake = false;
+static esp_sleep_wakeup_cause_t g_wake_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Earliest armed deadline (caller holds g_timer_lock)
+ */
+static uint64_t next_deadline_locked(void) {
+    uint64_t next = NATIVE_CLOCK_NEVER;
+    for (esp_timer_handle_t t = g_timers; t != NULL; t = t->next) {
+        if (t->armed && t->deadline_us < next) {
+            next = t->deadline_us;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Disarm one expired timer (caller holds g_timer_lock)
+ * @return The timer, or NULL if none has expired
+ */
+static esp_timer_handle_t take_expired_locked(uint64_t now) {
+    for (esp_timer_handle_t t = g_timers; t != NULL; t = t->next) {
+        if (t->armed && t->deadline_us <= now) {
+            t->armed = false;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static void dispatcher_thread(void) {
+    std::function<bool()> changed = [] {
+        std::lock_guard<std::mutex> guard(g_timer_lock);
+        return g_timers_changed;
+    };
+
+    for (;;) {
+        esp_timer_cb_t callback = NULL;
+        void* arg = NULL;
+        uint64_t next;
+        {
+            std::lock_guard<std::mutex> guard(g_timer_lock);
+            g_timers_changed = false;
+            esp_timer_handle_t t = take_expired_locked(native_clock_us());
+            if (t != NULL) {
+                callback = t->callback;
+                arg = t->arg;
+            }
+            next = next_deadline_locked();
+        }
+
+        if (callback != NULL) {
+            callback(arg);
+            continue;
+        }
+
+        if (native_clock_is_virtual()) {
+            native_clock_block(next, changed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(g_timer_lock);
+        if (next == NATIVE_CLOCK_NEVER) {
+            g_timer_wake.wait(lock, [] { return g_timers_changed; });
+        } else {
+            uint64_t now = native_clock_us();
+            if (next > now) {
+                g_timer_wake.wait_for(lock, std::chrono::microseconds(next - now),
+                                      [] { return g_timers_changed; });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tell the dispatcher the armed set changed (caller holds no lock)
+ */
+static void timers_changed(void) {
+    {
+        std::lock_guard<std::mutex> guard(g_timer_lock);
+        g_timers_changed = true;
+    }
+    g_timer_wake.notify_one();
+    native_clock_kick();
+}
+
+/**
+ * @brief Bytes waiting on stdin (0 at end of input or when not readable)
+ */
+static int console_pending(void) {
+    int pending = 0;
+    if (ioctl(STDIN_FILENO, FIONREAD, &pending) != 0) {
+        return 0;
+    }
+    return pending;
+}
+
+/**
+ * @brief Sleep until a deadline or console input (wall time)
+ * @return true if input arrived first
+ */
+static bool wait_console(uint64_t us) {
+    uint64_t deadline = native_clock_us() + us;
+    for (;;) {
+        uint64_t now = native_clock_us();
+        if (now >= deadline) {
+            return false;
+        }
+        uint64_t left = deadline - now;
+        struct timespec timeout = { (time_t)(left / 1000000), (long)(left % 1000000) * 1000 };
+        struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+        if (ppoll(&pfd, 1, &timeout, NULL) <= 0) {
+            continue;
+        }
+        if (console_pending() > 0) {
+            return true;
+        }
+        // End of input or an error: readable forever, so just sleep
+        now = native_clock_us();
+        if (now < deadline) {
+            native_clock_sleep_us(deadline - now);
+        }
+        return false;
+    }
+}
+
+// ============================================================================
+// ESP TIMER
+// ============================================================================
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_timer_handle_t timer = new esp_timer();
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->name = create_args->name;
+    timer->armed = false;
+    timer->deadline_us = 0;
+
+    bool start;
+    {
+        std::lock_guard<std::mutex> guard(g_timer_lock);
+        timer->next = g_timers;
+        g_timers = timer;
+        start = !g_dispatcher_started;
+        g_dispatcher_started = true;
+    }
+    if (start) {
+        native_clock_attach();
+        std::thread(dispatcher_thread).detach();
+    }
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    {
+        std::lock_guard<std::mutex> guard(g_timer_lock);
+        if (timer->armed) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        timer->armed = true;
+        timer->deadline_us = native_clock_us() + timeout_us;
+    }
+    timers_changed();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> guard(g_timer_lock);
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    {
+        std::lock_guard<std::mutex> guard(g_timer_lock);
+        if (timer->armed) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        for (esp_timer_handle_t* t = &g_timers; *t != NULL; t = &(*t)->next) {
+            if (*t == timer) {
+                *t = timer->next;
+                break;
+            }
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) {
+    return (int64_t)native_clock_us();
+}
+
+// ============================================================================
+// LIGHT SLEEP
+// ============================================================================
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+    g_sleep_timer_us = time_in_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num) {
+    if (uart_num != UART_NUM_0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    g_uart_wake = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void) {
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start(void) {
+    if (g_uart_wake && console_pending() > 0) {
+        g_wake_cause = ESP_SLEEP_WAKEUP_UART;
+        return ESP_OK;
+    }
+
+    if (g_uart_wake && !native_clock_is_virtual()) {
+        g_wake_cause = wait_console(g_sleep_timer_us) ? ESP_SLEEP_WAKEUP_UART : ESP_SLEEP_WAKEUP_TIMER;
+        return ESP_OK;
+    }
+
+    native_clock_sleep_us(g_sleep_timer_us);
+    g_wake_cause = ESP_SLEEP_WAKEUP_TIMER;
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) {
+    return g_wake_cause;
+}
+
+// ============================================================================
+// DRIVERS
+// ============================================================================
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t uart_num, int wakeup_threshold) {
+    return (uart_num == UART_NUM_0 && wakeup_threshold >= 3) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t uart_num, TickType_t ticks_to_wait) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+    return (intr_type == GPIO_INTR_LOW_LEVEL || intr_type == GPIO_INTR_HIGH_LEVEL)
+        ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file native_spi.cpp
+ * @brief SPI master with a record of the bytes sent
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <SPI.h>
+#include <mutex>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static std::mutex g_spi_lock;
+static uint8_t g_history[NATIVE_HAL_SPI_HISTORY];
+static size_t g_history_count = 0;     // Total bytes sent
+
+SPIClass SPI;
+
+// ============================================================================
+// HISTORY
+// ============================================================================
+
+size_t native_hal_spi_history(uint8_t* out, size_t max) {
+    std::lock_guard<std::mutex> guard(g_spi_lock);
+    size_t kept = g_history_count < NATIVE_HAL_SPI_HISTORY ? g_history_count : NATIVE_HAL_SPI_HISTORY;
+    size_t n = kept < max ? kept : max;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = g_history[(g_history_count - n + i) % NATIVE_HAL_SPI_HISTORY];
+    }
+    return n;
+}
+
+// ============================================================================
+// SPI CLASS
+// ============================================================================
+
+void SPIClass::begin(int8_t sck, int8_t miso, int8_t mosi, int8_t ss) {
+}
+
+void SPIClass::end(void) {
+}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+}
+
+void SPIClass::endTransaction(void) {
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    std::lock_guard<std::mutex> guard(g_spi_lock);
+    g_history[g_history_count % NATIVE_HAL_SPI_HISTORY] = data;
+    g_history_count++;
+    return 0xFF;                    // Nothing drives MISO
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+    uint16_t hi = transfer((uint8_t)(data >> 8));
+    uint16_t lo = transfer((uint8_t)data);
+    return (uint16_t)((hi << 8) | lo);
+}
+
+void SPIClass::transfer(void* data, uint32_t size) {
+    uint8_t* bytes = (uint8_t*)data;
+    for (uint32_t i = 0; i < size; i++) {
+        bytes[i] = transfer(bytes[i]);
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file native_trace.cpp
+ * @brief Sensor trace files for --record and --replay
+ *
+ * Recording appends to a regular file from a writer thread that drains
+ * the trace ring every TRACE_WRITER_MS (of virtual time with
+ * --virtual-time, so the ring keeps up), standing in for the I/O core.
+ * Replay maps the file read-only; when the recorded touch frames run out
+ * the process exits like --seconds does.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Arduino.h>
+#include "ucf_trace.h"
+#include <mutex>
+#include <thread>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define TRACE_WRITER_MS     20
+
+static std::mutex g_trace_lock;         // trace_tick() has a single consumer
+static FILE* g_record_file = NULL;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static bool file_write(const void* data, size_t len, void* ctx) {
+    return fwrite(data, 1, len, (FILE*)ctx) == len;
+}
+
+static const uint8_t* map_trace(const char* path, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[HAL] %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "[HAL] %s: cannot map\n", path);
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return (const uint8_t*)data;
+}
+
+static void writer_thread(void) {
+    for (;;) {
+        native_clock_sleep_us(TRACE_WRITER_MS * 1000);
+
+        {
+            std::lock_guard<std::mutex> guard(g_trace_lock);
+            trace_tick();
+        }
+
+        const TraceStats* stats = trace_get_stats();
+        if (stats->replay_done) {
+            fflush(stdout);
+            fprintf(stderr, "[HAL] Replay finished: %lu frames, %lu magnetometer samples, %lu commands\n",
+                    (unsigned long)stats->replay_frames, (unsigned long)stats->replay_mags,
+                    (unsigned long)stats->replay_commands);
+            native_hal_exit(0);
+        }
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool native_trace_begin(void) {
+    const NativeHalOptions* options = native_hal_options();
+
+    if (options->replay_path != NULL) {
+        size_t size = 0;
+        const uint8_t* data = map_trace(options->replay_path, &size);
+        if (data == NULL) {
+            return false;
+        }
+        if (!trace_replay_begin(data, size)) {
+            fprintf(stderr, "[HAL] %s: not a sensor trace\n", options->replay_path);
+            return false;
+        }
+        fprintf(stderr, "[HAL] Replaying %s\n", options->replay_path);
+    }
+
+    if (options->record_path != NULL) {
+        g_record_file = fopen(options->record_path, "wb");
+        if (g_record_file == NULL || !trace_record_begin(file_write, g_record_file, millis())) {
+            fprintf(stderr, "[HAL] %s: %s\n", options->record_path, strerror(errno));
+            return false;
+        }
+        fprintf(stderr, "[HAL] Recording %s\n", options->record_path);
+    }
+
+    if (options->record_path != NULL || options->replay_path != NULL) {
+        native_clock_attach();
+        std::thread(writer_thread).detach();
+    }
+    return true;
+}
+
+void native_trace_end(void) {
+    std::lock_guard<std::mutex> guard(g_trace_lock);
+    if (g_record_file == NULL) {
+        return;
+    }
+
+    trace_record_end();
+    fclose(g_record_file);
+    g_record_file = NULL;
+
+    const TraceStats* stats = trace_get_stats();
+    fprintf(stderr, "[HAL] Trace: %lu records, %lu bytes, %lu chunks dropped, %lu write errors\n",
+            (unsigned long)stats->records, (unsigned long)stats->bytes,
+            (unsigned long)stats->dropped_chunks, (unsigned long)stats->write_errors);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file native_wire.cpp
+ * @brief I2C master and simulated bus for the native firmware build
+ *
+ * endTransmission() returns the ESP32 driver's codes: 0 ok, 1 data too
+ * long, 2 address NACK.
+ *
+ * Host only (POSIX).
+ */
+
+#include "native_internal.h"
+#include <Wire.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define NATIVE_MAX_I2C_DEVICES  8
+
+static NativeI2cDevice* g_devices[NATIVE_MAX_I2C_DEVICES];
+static size_t g_device_count = 0;
+
+TwoWire Wire;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static NativeI2cDevice* find_device(uint16_t address) {
+    for (size_t i = 0; i < g_device_count; i++) {
+        if (g_devices[i]->address() == address) {
+            return g_devices[i];
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// DEVICE REGISTRY
+// ============================================================================
+
+void native_hal_attach_i2c(NativeI2cDevice* device) {
+    if (g_device_count < NATIVE_MAX_I2C_DEVICES) {
+        g_devices[g_device_count++] = device;
+    }
+}
+
+// ============================================================================
+// REGISTER DEVICES
+// ============================================================================
+
+void NativeRegisterDevice::write(const uint8_t* data, size_t len) {
+    if (len == 0) {
+        return;                     // Address probe
+    }
+    m_pointer = data[0];
+    for (size_t i = 1; i < len; i++) {
+        write_register(m_pointer, data[i]);
+        m_pointer++;
+    }
+}
+
+void NativeRegisterDevice::read(uint8_t* data, size_t len) {
+    refresh();
+    for (size_t i = 0; i < len; i++) {
+        data[i] = m_regs[m_pointer];
+        m_pointer = next_register(m_pointer);
+    }
+}
+
+// ============================================================================
+// TWO WIRE
+// ============================================================================
+
+uint32_t TwoWire::wire_time_us(size_t bytes) const {
+    // 9 clocks per byte (8 data + ACK) plus start and stop
+    uint64_t bits = (uint64_t)bytes * 9 + 2;
+    return (uint32_t)((bits * 1000000ULL + m_clock_hz - 1) / m_clock_hz);
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    if (frequency > 0) {
+        m_clock_hz = frequency;
+    }
+    return true;
+}
+
+bool TwoWire::end(void) {
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    if (frequency == 0) {
+        return false;
+    }
+    m_clock_hz = frequency;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint16_t address) {
+    m_lock.lock();
+    m_tx_address = address;
+    m_tx_len = 0;
+    m_tx_overflow = false;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    uint8_t result = 0;
+    NativeI2cDevice* device = find_device(m_tx_address);
+
+    if (m_tx_overflow) {
+        result = 1;
+    } else if (device == NULL) {
+        native_hal_bus_wait(wire_time_us(1));
+        result = 2;
+    } else {
+        device->write(m_tx, m_tx_len);
+        native_hal_bus_wait(wire_time_us(1 + m_tx_len));
+    }
+
+    // A repeated start keeps the bus until the read
+    if (sendStop || result != 0) {
+        m_lock.unlock();
+    } else {
+        m_held_for_read = true;
+    }
+    return result;
+}
+
+uint8_t TwoWire::requestFrom(uint16_t address, uint8_t size, bool sendStop) {
+    std::lock_guard<std::recursive_mutex> guard(m_lock);
+    if (m_held_for_read) {
+        m_held_for_read = false;
+        m_lock.unlock();
+    }
+
+    m_rx_len = 0;
+    m_rx_pos = 0;
+    NativeI2cDevice* device = find_device(address);
+    if (device == NULL) {
+        native_hal_bus_wait(wire_time_us(1));
+        return 0;
+    }
+
+    if (size > I2C_BUFFER_LENGTH) {
+        size = I2C_BUFFER_LENGTH;
+    }
+    device->read(m_rx, size);
+    native_hal_bus_wait(wire_time_us(1 + (size_t)size));
+    m_rx_len = size;
+    return size;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (m_tx_len >= I2C_BUFFER_LENGTH) {
+        m_tx_overflow = true;
+        return 0;
+    }
+    m_tx[m_tx_len++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    for (size_t i = 0; i < quantity; i++) {
+        if (write(data[i]) == 0) {
+            return i;
+        }
+    }
+    return quantity;
+}
+
+int TwoWire::available(void) {
+    return (int)(m_rx_len - m_rx_pos);
+}
+
+int TwoWire::read(void) {
+    return m_rx_pos < m_rx_len ? m_rx[m_rx_pos++] : -1;
+}
+
+int TwoWire::peek(void) {
+    return m_rx_pos < m_rx_len ? m_rx[m_rx_pos] : -1;
+}
+
+void TwoWire::flush(void) {
+    m_rx_len = 0;
+    m_rx_pos = 0;
+}
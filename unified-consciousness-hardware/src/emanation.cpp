@@ -4,6 +4,8 @@
  */
 
 #include "emanation.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
 #include <Adafruit_NeoPixel.h>
 #include <Arduino.h>
 #include <math.h>
@@ -59,7 +61,12 @@ bool Emanation::begin() {
 }
 
 void Emanation::update(const PhaseState& phase) {
-    m_state.timestamp = millis();
+    PROF_SCOPE(PROF_EMANATION_UPDATE);
+
+    uint32_t now = millis();
+    m_state.timestamp = now;
+    uint16_t prev_frequency = m_state.frequency;
+    uint8_t prev_rgb[3] = { m_state.rgb[0], m_state.rgb[1], m_state.rgb[2] };
 
     // Update frequency from tier
     m_state.frequency = tierToSolfeggio(phase.tier);
@@ -70,14 +77,21 @@ void Emanation::update(const PhaseState& phase) {
     // Calculate phase increment for audio
     m_audio_phase_inc = static_cast<float>(m_state.frequency) / SAMPLE_RATE;
 
+    if (m_state.frequency != prev_frequency || memcmp(m_state.rgb, prev_rgb, 3) != 0) {
+        LAT_MARK(LAT_EMANATION);
+    }
+    if (m_state.frequency != prev_frequency) {
+        LAT_MARK(LAT_AUDIO);
+    }
+
     // Update breath phase if syncing
     if (m_state.breath_sync) {
-        updateBreathPhase();
+        updateBreathPhase(now);
     }
 
     // Update LED display
     if (m_state.visual_enabled) {
-        updateLeds();
+        updateLeds(now);
     }
 }
 
@@ -90,12 +104,13 @@ void Emanation::updateFromZ(float z) {
 
     phaseToColor(phase, m_state.rgb[0], m_state.rgb[1], m_state.rgb[2]);
 
+    uint32_t now = millis();
     if (m_state.breath_sync) {
-        updateBreathPhase();
+        updateBreathPhase(now);
     }
 
     if (m_state.visual_enabled) {
-        updateLeds();
+        updateLeds(now);
     }
 }
 
@@ -212,8 +227,7 @@ void Emanation::stop() {
     strip.show();
 }
 
-void Emanation::updateBreathPhase() {
-    uint32_t now = millis();
+void Emanation::updateBreathPhase(uint32_t now) {
     uint32_t elapsed = now - m_state.breath_timer;
 
     // Determine which phase we're in based on elapsed time
@@ -243,10 +257,9 @@ void Emanation::updateBreathPhase() {
     }
 }
 
-float Emanation::getBreathModulation() {
+float Emanation::getBreathModulation(uint32_t now) {
     if (!m_state.breath_sync) return 1.0f;
 
-    uint32_t now = millis();
     uint32_t elapsed = now - m_state.breath_timer;
 
     // Calculate position within current phase
@@ -289,7 +302,7 @@ int16_t Emanation::getNextAudioSample() {
     }
 
     int16_t sample = 0;
-    float breath_mod = getBreathModulation();
+    float breath_mod = m_state.breath_sync ? getBreathModulation(millis()) : 1.0f;
 
     switch (m_state.waveform) {
         case Waveform::SINE:
@@ -352,9 +365,12 @@ void Emanation::setPixel(uint8_t index, uint8_t r, uint8_t g, uint8_t b) {
 }
 
 void Emanation::updateLeds() {
+    updateLeds(millis());
+}
+
+void Emanation::updateLeds(uint32_t now) {
     if (!m_state.visual_enabled) return;
 
-    uint32_t now = millis();
     float dt = (now - m_led_last_update) / 1000.0f;
     m_led_last_update = now;
 
@@ -364,12 +380,13 @@ void Emanation::updateLeds() {
         m_led_anim_phase -= 1.0f;
     }
 
-    applyLedPattern();
+    applyLedPattern(now);
     strip.show();
+    LAT_MARK(LAT_LED);
 }
 
-void Emanation::applyLedPattern() {
-    float breath_mod = getBreathModulation();
+void Emanation::applyLedPattern(uint32_t now) {
+    float breath_mod = getBreathModulation(now);
 
     switch (m_state.pattern) {
         case LedPattern::SOLID:
@@ -4,6 +4,9 @@
  */
 
 #include "hex_grid.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
+#include "ucf_trace.h"
 #include <Wire.h>
 #include <Adafruit_MPR121.h>
 #include <math.h>
@@ -69,6 +72,20 @@ void HexGrid::calibrate(uint16_t samples) {
     m_calibrated = true;
 }
 
+void HexGrid::setBaselines(const uint16_t* baselines) {
+    memcpy(m_baselines, baselines, sizeof(m_baselines));
+    m_calibrated = true;
+}
+
+bool HexGrid::getBaselines(uint16_t* baselines) const {
+    memcpy(baselines, m_baselines, sizeof(m_baselines));
+    return m_calibrated;
+}
+
+void HexGrid::getRaw(uint16_t* raw) const {
+    memcpy(raw, m_raw, sizeof(m_raw));
+}
+
 void HexGrid::readMPR121(uint16_t* data) {
     // Read from first controller (channels 0-11)
     for (uint8_t i = 0; i < 12; i++) {
@@ -79,6 +96,9 @@ void HexGrid::readMPR121(uint16_t* data) {
     for (uint8_t i = 0; i < 7; i++) {
         data[12 + i] = mpr121_b.filteredData(i);
     }
+
+    LAT_MARK(LAT_MPR121);
+    TRACE_TOUCH(millis(), data);
 }
 
 float HexGrid::normalize(uint16_t raw, uint16_t baseline) {
@@ -98,11 +118,22 @@ float HexGrid::normalize(uint16_t raw, uint16_t baseline) {
 }
 
 HexFieldState HexGrid::readField() {
-    HexFieldState state;
-    state.timestamp = millis();
+    PROF_SCOPE(PROF_READ_FIELD);
 
-    // Read raw values
     readMPR121(m_raw);
+    return computeField();
+}
+
+HexFieldState HexGrid::readField(const uint16_t* raw) {
+    PROF_SCOPE(PROF_READ_FIELD);
+
+    memcpy(m_raw, raw, sizeof(m_raw));
+    return computeField();
+}
+
+HexFieldState HexGrid::computeField() {
+    HexFieldState state;
+    state.timestamp = millis();
 
     // Process each sensor
     state.total_energy = 0.0f;
@@ -141,6 +172,7 @@ HexFieldState HexGrid::readField() {
     state.theta = computeTheta(state);
     state.r = computeR(state);
 
+    LAT_FIELD(state.active_count > 0);
     return state;
 }
 
@@ -4,32 +4,48 @@
  */
 
 #include "k_formation.h"
+#include "ucf_profiler.h"
+#include "ucf_shadow.h"
 #include <Arduino.h>
 #include <math.h>
 #include <string.h>
 
 namespace UCF {
 
+// SHADOW_LED_K_FORMATION hardware write
+static void writeIndicator(uint32_t level, void* ctx) {
+    digitalWrite(Pins::LED_K_FORMATION, level ? HIGH : LOW);
+}
+
 KFormation::KFormation()
     : m_kappa_threshold(K_KAPPA)
     , m_eta_threshold(K_ETA)
     , m_R_threshold(K_R)
-    , m_coherence_window(32)
+    , m_coherence_window(HISTORY_SIZE < 32 ? HISTORY_SIZE : 32)
+    , m_history(nullptr)
     , m_history_head(0)
     , m_history_count(0)
     , m_callback(nullptr)
 {
     memset(&m_status, 0, sizeof(m_status));
-    memset(m_history, 0, sizeof(m_history));
 }
 
 bool KFormation::begin() {
+    if (m_history == nullptr) {
+        m_history = static_cast<CoherenceHistoryEntry*>(mem_alloc("kformation_history", ARENA_BYTES));
+        if (m_history == nullptr) {
+            return false;
+        }
+    }
+
     pinMode(Pins::LED_K_FORMATION, OUTPUT);
-    digitalWrite(Pins::LED_K_FORMATION, LOW);
+    shadow_bind(SHADOW_LED_K_FORMATION, writeIndicator, nullptr, LOW);
     return true;
 }
 
 KFormationMetrics KFormation::update(const HexFieldState& field) {
+    PROF_SCOPE(PROF_K_FORMATION);
+
     // Add current field to history for coherence calculation
     addToHistory(field);
 
@@ -80,6 +96,10 @@ KFormationMetrics KFormation::update(const HexFieldState& field) {
 }
 
 void KFormation::addToHistory(const HexFieldState& field) {
+    if (m_history == nullptr) {
+        return;
+    }
+
     // Copy readings to history
     memcpy(m_history[m_history_head].readings, field.readings,
            sizeof(float) * HEX_SENSOR_COUNT);
@@ -187,13 +207,13 @@ void KFormation::resetStats() {
 void KFormation::updateIndicator() {
     if (m_status.is_active) {
         // Solid on when K-Formation active
-        digitalWrite(Pins::LED_K_FORMATION, HIGH);
+        shadow_set(SHADOW_LED_K_FORMATION, HIGH);
     } else if (m_status.current.kappa >= 0.8f ||
                m_status.current.eta >= 0.5f) {
         // Blink when approaching K-Formation
-        digitalWrite(Pins::LED_K_FORMATION, (millis() / 250) % 2);
+        shadow_set(SHADOW_LED_K_FORMATION, (millis() / 250) % 2);
     } else {
-        digitalWrite(Pins::LED_K_FORMATION, LOW);
+        shadow_set(SHADOW_LED_K_FORMATION, LOW);
     }
 }
 
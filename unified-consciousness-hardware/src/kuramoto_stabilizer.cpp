@@ -4,6 +4,9 @@
  */
 
 #include "kuramoto_stabilizer.h"
+#include "ucf_profiler.h"
+#include "ucf_trace.h"
+#include "ucf_shadow.h"
 #include <Arduino.h>
 #include <Wire.h>
 #include <SPI.h>
@@ -12,6 +15,9 @@
 
 namespace UCF {
 
+// Weight of each step's psi velocity in the collective frequency (~50 ms at 1 kHz)
+#define COLLECTIVE_FREQ_SMOOTHING   0.02f
+
 // HMC5883L magnetometer registers (if available)
 #define HMC5883L_CONFIG_A   0x00
 #define HMC5883L_CONFIG_B   0x01
@@ -25,6 +31,12 @@ KuramotoStabilizer::KuramotoStabilizer()
     , m_sync_start(0)
     , m_pll_integrator(0.0f)
     , m_pll_proportional(0.0f)
+    , m_collective_freq(0.0f)
+    , m_ext_r(0.0f)
+    , m_ext_psi(0.0f)
+    , m_ext_freq(0.0f)
+    , m_ext_coupling(0.0f)
+    , m_ref_offset(0.0f)
     , m_sync_callback(nullptr)
     , m_mag_initialized(false)
 {
@@ -48,6 +60,9 @@ bool KuramotoStabilizer::begin(float base_freq) {
     // Try to initialize magnetometer
     m_mag_initialized = initMagnetometer();
 
+    // The wiper is written on the first flush after setCoupling()
+    shadow_bind(SHADOW_DIGIPOT, writeCouplingHardware, nullptr, SHADOW_UNKNOWN);
+
     return true;
 }
 
@@ -72,23 +87,41 @@ bool KuramotoStabilizer::initMagnetometer() {
     return true;
 }
 
-void KuramotoStabilizer::step(float dt) {
-    uint32_t now = millis();
-    m_state.timestamp = now;
+void KuramotoStabilizer::step(float dt, uint32_t now_ms) {
+    PROF_SCOPE(PROF_KURAMOTO_STEP);
+
+    m_state.timestamp = now_ms;
+
+    // The reference is one more oscillator coupled to the mesh field
+    if (m_ext_coupling > 0.0f && m_ext_r > 0.0f) {
+        float pull = m_ext_coupling * m_ext_r * kuramotoCoupling(m_ext_psi - referencePhase(now_ms));
+        m_ref_offset = wrapAngle(m_ref_offset + pull * TWO_PI * dt);
+    }
+    float ref_phase = referencePhase(now_ms);
 
     // Apply Kuramoto dynamics
     applyKuramotoDynamics(dt);
 
     // Apply relaxation (T1/T2 analog)
-    applyRelaxation(dt);
+    applyRelaxation(dt, ref_phase);
 
     // Apply PLL stabilization
-    applyPLLStabilization(dt);
+    applyPLLStabilization(dt, ref_phase);
 
     // Compute order parameter
+    float prev_psi = m_state.collective_phase;
     m_state.order_param = computeOrderParameter();
     m_state.collective_phase = computeCollectivePhase();
 
+    // Phase velocity of psi (what the mesh broadcasts) and the mesh field's phase
+    if (dt > 0.0f) {
+        float dpsi = m_state.collective_phase - prev_psi;
+        if (dpsi > PI) dpsi -= TWO_PI;
+        if (dpsi < -PI) dpsi += TWO_PI;
+        m_collective_freq += (dpsi / (TWO_PI * dt) - m_collective_freq) * COLLECTIVE_FREQ_SMOOTHING;
+        m_ext_psi = wrapAngle(m_ext_psi + m_ext_freq * TWO_PI * dt);
+    }
+
     // Check TRIAD conditions
     checkTriadConditions();
 
@@ -97,7 +130,7 @@ void KuramotoStabilizer::step(float dt) {
     m_status.is_synchronized = (m_state.order_param >= K_KAPPA);
 
     if (m_status.is_synchronized && !m_status.is_stabilized) {
-        m_sync_start = now;
+        m_sync_start = now_ms;
         m_status.is_stabilized = true;
 
         if (m_sync_callback) {
@@ -108,7 +141,7 @@ void KuramotoStabilizer::step(float dt) {
     }
 
     if (m_status.is_stabilized) {
-        m_status.sync_duration = now - m_sync_start;
+        m_status.sync_duration = now_ms - m_sync_start;
     }
 
     m_prev_order_param = m_state.order_param;
@@ -125,8 +158,10 @@ void KuramotoStabilizer::applyKuramotoDynamics(float dt) {
         }
 
         // Kuramoto equation: dθᵢ/dt = ωᵢ + (K/N) Σⱼ sin(θⱼ - θᵢ)
+        //                              + K_ext R_ext sin(Φ_ext - θᵢ)  (mesh)
         float dtheta = m_state.frequencies[i] +
-                       (m_state.coupling / N_OSCILLATORS) * coupling_sum;
+                       (m_state.coupling / N_OSCILLATORS) * coupling_sum +
+                       m_ext_coupling * m_ext_r * kuramotoCoupling(m_ext_psi - m_state.phases[i]);
 
         new_phases[i] = m_state.phases[i] + dtheta * TWO_PI * dt;
         new_phases[i] = wrapAngle(new_phases[i]);
@@ -135,14 +170,13 @@ void KuramotoStabilizer::applyKuramotoDynamics(float dt) {
     memcpy(m_state.phases, new_phases, sizeof(m_state.phases));
 }
 
-void KuramotoStabilizer::applyRelaxation(float dt) {
+void KuramotoStabilizer::applyRelaxation(float dt, float ref_phase) {
     // T1 relaxation: phases drift toward equilibrium
     const float T1 = 2.0f;  // Relaxation time constant (seconds)
     const float gamma = 1.0f / T1;
 
     // Equilibrium is uniform distribution based on reference phase
-    float equilibrium_phase = m_status.reference_freq * TWO_PI * (millis() / 1000.0f);
-    equilibrium_phase = wrapAngle(equilibrium_phase);
+    float equilibrium_phase = ref_phase;
 
     for (uint8_t i = 0; i < N_OSCILLATORS; i++) {
         float target = equilibrium_phase + static_cast<float>(i) * TWO_PI / N_OSCILLATORS;
@@ -160,13 +194,9 @@ void KuramotoStabilizer::applyRelaxation(float dt) {
     }
 }
 
-void KuramotoStabilizer::applyPLLStabilization(float dt) {
+void KuramotoStabilizer::applyPLLStabilization(float dt, float ref_phase) {
     // Phase-locked loop to lock collective phase to reference
 
-    // Reference phase
-    float ref_phase = m_status.reference_freq * TWO_PI * (millis() / 1000.0f);
-    ref_phase = wrapAngle(ref_phase);
-
     // Phase error
     float error = ref_phase - m_state.collective_phase;
     if (error > PI) error -= TWO_PI;
@@ -196,6 +226,12 @@ void KuramotoStabilizer::applyPLLStabilization(float dt) {
     m_status.pll_locked = (fabsf(error) < 0.1f);
 }
 
+float KuramotoStabilizer::referencePhase(uint32_t now_ms) const {
+    // Cycles in double: in float, f * t loses the fraction after a few hours
+    double cycles = (double)m_status.reference_freq * now_ms / 1000.0;
+    return wrapAngle(TWO_PI * (float)(cycles - floor(cycles)) + m_ref_offset);
+}
+
 float KuramotoStabilizer::computeOrderParameter() {
     // r·e^(iψ) = (1/N) Σⱼ e^(iθⱼ)
     float sum_cos = 0.0f;
@@ -258,8 +294,10 @@ void KuramotoStabilizer::setCoupling(float K) {
     if (K > 1.0f) K = 1.0f;
     m_state.coupling = K;
 
-    // Write to hardware
-    writeCouplingHardware(K);
+    // K=0 → R=10kΩ → step 255
+    // K=1 → R=0 → step 0
+    // Written on the next flush, and only if the step changed
+    shadow_set(SHADOW_DIGIPOT, static_cast<uint8_t>((1.0f - K) * 255));
 }
 
 MagneticField KuramotoStabilizer::readMagneticField() {
@@ -279,12 +317,14 @@ MagneticField KuramotoStabilizer::readMagneticField() {
         int16_t x = (Wire.read() << 8) | Wire.read();
         int16_t z = (Wire.read() << 8) | Wire.read();  // Note: HMC order is X, Z, Y
         int16_t y = (Wire.read() << 8) | Wire.read();
+        int16_t xyz[3] = { x, y, z };
+        TRACE_MAG(millis(), xyz);
 
         // Convert to microtesla (approximate, depends on gain setting)
         const float scale = 0.092f;  // For gain = 1090 LSB/Gauss
-        field.x = x * scale;
-        field.y = y * scale;
-        field.z = z * scale;
+        field.x = xyz[0] * scale;
+        field.y = xyz[1] * scale;
+        field.z = xyz[2] * scale;
 
         field.magnitude = sqrtf(field.x * field.x + field.y * field.y + field.z * field.z);
         field.inclination = atan2f(field.z, sqrtf(field.x * field.x + field.y * field.y));
@@ -324,6 +364,7 @@ void KuramotoStabilizer::reset() {
     m_state.triad_unlocked = false;
     m_state.order_param = 0.0f;
     m_state.collective_phase = 0.0f;
+    m_collective_freq = 0.0f;
 
     m_pll_integrator = 0.0f;
     m_pll_proportional = 0.0f;
@@ -334,6 +375,26 @@ void KuramotoStabilizer::reset() {
     m_status.sync_duration = 0;
 }
 
+void KuramotoStabilizer::restore(const float* phases, float coupling, float pll_integrator) {
+    for (uint8_t i = 0; i < N_OSCILLATORS; i++) {
+        m_state.phases[i] = wrapAngle(phases[i]);
+    }
+
+    m_pll_integrator = pll_integrator;
+    setCoupling(coupling);
+
+    m_state.order_param = computeOrderParameter();
+    m_state.collective_phase = computeCollectivePhase();
+    m_prev_order_param = m_state.order_param;
+}
+
+void KuramotoStabilizer::setExternalField(float r, float psi, float freq_hz, float K) {
+    m_ext_r = r < 0.0f ? 0.0f : (r > 1.0f ? 1.0f : r);
+    m_ext_psi = wrapAngle(psi);
+    m_ext_freq = freq_hz;
+    m_ext_coupling = K < 0.0f ? 0.0f : K;
+}
+
 bool KuramotoStabilizer::checkKFormation(float eta, uint8_t R) const {
     return (m_state.order_param >= K_KAPPA) &&
            (eta > K_ETA) &&
@@ -351,19 +412,13 @@ void KuramotoStabilizer::setTriadThresholds(float high, float low) {
     }
 }
 
-void KuramotoStabilizer::writeCouplingHardware(float K) {
-    // Write to MCP41010 digipot
-    // K=0 → R=10kΩ → step 255
-    // K=1 → R=0 → step 0
-
-    uint8_t step = static_cast<uint8_t>((1.0f - K) * 255);
-
-    // SPI transaction to digipot
+void KuramotoStabilizer::writeCouplingHardware(uint32_t step, void* ctx) {
+    // SPI transaction to MCP41010 digipot
     digitalWrite(Pins::SPI_CS_DIGIPOT, LOW);
 
     // Command byte: write to potentiometer
     SPI.transfer(0x11);  // Write command
-    SPI.transfer(step);
+    SPI.transfer(static_cast<uint8_t>(step));
 
     digitalWrite(Pins::SPI_CS_DIGIPOT, HIGH);
 }
@@ -9,7 +9,7 @@
  * - Phase Engine: z-coordinate and phase detection
  * - TRIAD FSM: Hysteresis unlock system
  * - K-Formation: Meta-cognition detection
- * - Sigil ROM: 121 neural sigils in EEPROM
+ * - Sigil ROM: 121 neural sigils in persistent storage
  * - Emanation: Audio and visual output
  * - Omni-Linguistics: APL translation engine
  * - Photonic Capture: Interference pattern encoding
@@ -32,6 +32,20 @@
 #include "omni_linguistics.h"
 #include "photonic_capture.h"
 #include "kuramoto_stabilizer.h"
+#include "ucf_storage.h"
+#include "ucf_session_log.h"
+#include "ucf_warm_start.h"
+#include "ucf_scheduler.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
+#include "ucf_memory.h"
+#include "ucf_heap.h"
+#include "ucf_log.h"
+#include "ucf_shadow.h"
+#include "ucf_idle.h"
+#include "ucf_timestep.h"
+#include "ucf_trace.h"
+#include "protocol.h"
 
 using namespace UCF;
 
@@ -42,6 +56,24 @@ using namespace UCF;
 void printDetailedStatus();
 void cycleEmanationPattern();
 void listSigils();
+void printSessionLogStatus();
+void saveSnapshot();
+void printScheduleStats();
+void printProfile();
+void printProfileResponse();
+void printLatency(bool chrome);
+void printMemory();
+void printLine(const char* line, void* ctx);
+void sensorTask(uint32_t nowUs, void* ctx);
+void kuramotoTask(uint32_t nowUs, void* ctx);
+void emanationTask(uint32_t nowUs, void* ctx);
+void phaseTask(uint32_t nowUs, void* ctx);
+void statusTask(uint32_t nowUs, void* ctx);
+void servicesTask(uint32_t nowUs, void* ctx);
+void snapshotTask(uint32_t nowUs, void* ctx);
+void consoleTask(uint32_t nowUs, void* ctx);
+void logTask(uint32_t nowUs, void* ctx);
+void outputsTask(uint32_t nowUs, void* ctx);
 void printHelp();
 
 // ============================================================================
@@ -58,15 +90,60 @@ OmniLinguistics omniLing;
 PhotonicCapture photonic;
 KuramotoStabilizer kuramoto;
 
+// Static RAM per module ('b'); history buffers come from the arena in begin()
+const MemStaticEntry staticModules[] = {
+    MEM_STATIC(hexGrid),
+    MEM_STATIC(phaseEngine),
+    MEM_STATIC(triadFSM),
+    MEM_STATIC(kFormation),
+    MEM_STATIC(sigilROM),
+    MEM_STATIC(emanation),
+    MEM_STATIC(omniLing),
+    MEM_STATIC(photonic),
+    MEM_STATIC(kuramoto),
+};
+
+static_assert(MEM_ROUND(PhaseEngine::ARENA_BYTES) + MEM_ROUND(KFormation::ARENA_BYTES) +
+              MEM_ROUND(OmniLinguistics::ARENA_BYTES) + MEM_ROUND(PhotonicCapture::ARENA_BYTES)
+              <= UCF_ARENA_BYTES, "module buffers do not fit UCF_ARENA_BYTES");
+
 // ============================================================================
 // TIMING
 // ============================================================================
 
-uint32_t lastSensorUpdate = 0;
-uint32_t lastPhaseUpdate = 0;
-uint32_t lastKuramotoStep = 0;
-uint32_t lastEmanationUpdate = 0;
-uint32_t lastSerialPrint = 0;
+Scheduler scheduler;
+Timestep kuramotoClock;         // Fixed 1 ms Kuramoto steps
+
+// Gaps between releases: timed waits, light sleep from IDLE_SLEEP_MIN_US
+// (no radio in this build, so nothing is lost while the chip sleeps)
+IdleGovernor idleGovernor;
+IdleEsp32 idleEsp32;
+const IdleConfig IDLE_CONFIG = {
+    IDLE_WAIT_MIN_US, IDLE_WAIT_MARGIN_US, IDLE_SLEEP_MIN_US, IDLE_SLEEP_MARGIN_US
+};
+
+uint32_t clockMicros() {
+    return micros();
+}
+
+// Loop tasks (periods in us; priority: higher runs first). The Kuramoto
+// deadline is its period; tasks are not preempted, so 'd' counts a miss
+// whenever a longer task holds it up.
+const uint32_t SNAPSHOT_PERIOD_US = WARM_SNAPSHOT_INTERVAL_MS * 1000UL;
+
+const SchedTaskConfig loopTasks[] = {
+    // name         fn             ctx   period                                      deadline budget offset  prio catchup
+    { "kuramoto",   kuramotoTask,  NULL, Timing::KURAMOTO_STEP_INTERVAL * 1000,      0,       200,   0,      7,   0 },
+    { "outputs",    outputsTask,   NULL, Timing::KURAMOTO_STEP_INTERVAL * 1000,      0,       100,   0,      0,   0 },
+    { "sensors",    sensorTask,    NULL, Timing::SENSOR_POLL_INTERVAL * 1000,        0,       4000,  0,      6,   0 },
+    { "phase",      phaseTask,     NULL, Timing::PHASE_UPDATE_INTERVAL * 1000,       0,       1500,  5000,   5,   0 },
+    { "emanation",  emanationTask, NULL, Timing::EMANATION_UPDATE_INTERVAL * 1000,   0,       2000,  2500,   5,   0 },
+    { "console",    consoleTask,   NULL, 20000,                                      0,       500,   7500,   4,   0 },
+    { "services",   servicesTask,  NULL, 5000,                                       0,       1000,  1250,   3,   0 },
+    { "status",     statusTask,    NULL, 1000000,                                    0,       2000,  0,      2,   0 },
+    { "log",        logTask,       NULL, 10000,                                      0,       1000,  3750,   1,   0 },
+    { "snapshot",   snapshotTask,  NULL, SNAPSHOT_PERIOD_US,                         0,       500,   SNAPSHOT_PERIOD_US, 0, 0 },
+};
 
 // ============================================================================
 // STATE
@@ -75,12 +152,17 @@ uint32_t lastSerialPrint = 0;
 HexFieldState currentField;
 bool systemReady = false;
 
+// Warm start: last run's state, validated against the grid in the background
+WarmSnapshot snapshot;
+BaselineCheck baselineCheck;
+bool warmStart = false;
+
 // ============================================================================
 // CALLBACKS
 // ============================================================================
 
 void onTriadUnlock() {
-    Serial.println(">>> TRIAD UNLOCKED <<<");
+    UCF_LOGI(LOG_CAT_EVENT, ">>> TRIAD UNLOCKED <<<");
 
     // Special emanation for TRIAD unlock
     emanation.setPattern(LedPattern::PULSE);
@@ -88,9 +170,8 @@ void onTriadUnlock() {
 }
 
 void onKFormation(const KFormationMetrics& metrics) {
-    Serial.println(">>> K-FORMATION ACHIEVED <<<");
-    Serial.printf("    kappa=%.3f eta=%.3f R=%d\n",
-                  metrics.kappa, metrics.eta, metrics.R);
+    UCF_LOGI(LOG_CAT_EVENT, ">>> K-FORMATION ACHIEVED <<<");
+    UCF_LOGI(LOG_CAT_EVENT, "    kappa=%.3f eta=%.3f R=%d", metrics.kappa, metrics.eta, metrics.R);
 
     // Special pattern for K-Formation
     emanation.setPattern(LedPattern::SPIRAL);
@@ -98,7 +179,7 @@ void onKFormation(const KFormationMetrics& metrics) {
 }
 
 void onSynchronization(float order_param) {
-    Serial.printf(">>> SYNCHRONIZED r=%.3f <<<\n", order_param);
+    UCF_LOGI(LOG_CAT_EVENT, ">>> SYNCHRONIZED r=%.3f <<<", order_param);
     emanation.setPattern(LedPattern::INTERFERENCE);
 }
 
@@ -107,11 +188,10 @@ void onSynchronization(float order_param) {
 // ============================================================================
 
 void setup() {
-    // Serial for debugging
+    // Serial for debugging (no wait for a host: early output may be lost)
     Serial.begin(115200);
-    while (!Serial && millis() < 3000) {
-        delay(10);
-    }
+    log_init();
+    shadow_init();
 
     Serial.println();
     Serial.println("========================================");
@@ -131,21 +211,33 @@ void setup() {
     digitalWrite(Pins::SPI_CS_EEPROM, HIGH);
     digitalWrite(Pins::SPI_CS_DIGIPOT, HIGH);
 
-    // Initialize modules
+    // Last run's baselines and filter state; checked against the grid later
+    warmStart = storage_begin() && warm_start_load(&snapshot);
+    if (warmStart) {
+        snapshot.boot_count++;
+    } else {
+        memset(&snapshot, 0, sizeof(snapshot));
+    }
+
+    // Initialize modules (calibration runs in the background)
+    mem_set_static(staticModules, sizeof(staticModules) / sizeof(staticModules[0]));
     Serial.print("Initializing Hex Grid... ");
     if (hexGrid.begin()) {
         Serial.println("OK");
+        if (warmStart) {
+            hexGrid.setBaselines(snapshot.hex_baselines);
+        }
+        baseline_check_begin(&baselineCheck, warmStart ? snapshot.hex_baselines : NULL);
     } else {
         Serial.println("FAILED");
     }
 
-    Serial.print("Calibrating sensors... ");
-    hexGrid.calibrate(50);
-    Serial.println("OK");
-
     Serial.print("Initializing Phase Engine... ");
     if (phaseEngine.begin()) {
         Serial.println("OK");
+        if (warmStart) {
+            phaseEngine.restoreSmoothed(snapshot.phase_z_smoothed);
+        }
     } else {
         Serial.println("FAILED");
     }
@@ -202,24 +294,57 @@ void setup() {
     Serial.print("Initializing Kuramoto Stabilizer... ");
     if (kuramoto.begin(10.0f)) {  // 10 Hz base frequency
         kuramoto.onSynchronization(onSynchronization);
+        if (warmStart) {
+            kuramoto.restore(snapshot.kuramoto_phases, snapshot.kuramoto_coupling,
+                             snapshot.pll_integrator);
+        }
         Serial.println("OK");
     } else {
         Serial.println("FAILED");
     }
 
+    MemStats mem;
+    mem_get_stats(&mem);
+    Serial.printf("Module arena: %lu of %lu bytes\n", (unsigned long)mem.used,
+                  (unsigned long)mem.capacity);
+
+    // Session recorder on the ucflog partition (reports its own status)
+    session_log_begin();
+
     // Set default emanation state
     emanation.setOutputMode(OutputMode::VISUAL | OutputMode::AUDIO);
     emanation.setPattern(LedPattern::BREATHE);
     emanation.setBrightness(128);
 
     Serial.println();
-    Serial.println("System ready.");
+    if (warmStart) {
+        Serial.printf("Warm start #%lu\n", (unsigned long)snapshot.boot_count);
+    } else {
+        Serial.println("Cold start, calibrating in the background (keep hands off the grid)");
+    }
+    Serial.printf("System ready at %lu ms.\n", (unsigned long)millis());
+
+    // Loop tasks (and module timing) start with the first loop() pass
+    prof_init(getCpuFrequencyMhz());
+    lat_init(clockMicros);
+    sched_init(&scheduler, clockMicros);
+    for (size_t i = 0; i < sizeof(loopTasks) / sizeof(loopTasks[0]); i++) {
+        sched_add(&scheduler, &loopTasks[i]);
+    }
+    if (!idle_esp32_begin(&idleEsp32)) {
+        Serial.println("Idle timer unavailable, the loop spins between tasks");
+    }
+    idle_init(&idleGovernor, &IDLE_CONFIG, clockMicros, idle_esp32_enter, &idleEsp32);
+    timestep_init(&kuramotoClock, Timing::KURAMOTO_STEP_INTERVAL * 1000,
+                  Timing::KURAMOTO_MAX_CATCHUP, micros());
     Serial.println("Sacred constants:");
     Serial.printf("  PHI = %.10f\n", PHI);
     Serial.printf("  PHI_INV = %.10f\n", PHI_INV);
     Serial.printf("  Z_CRITICAL = %.10f\n", Z_CRITICAL);
     Serial.println();
 
+    // Everything is allocated: the heap stays flat from here on
+    heap_mark_steady();
     systemReady = true;
 }
 
@@ -233,163 +358,271 @@ void loop() {
         return;
     }
 
+    sched_run(&scheduler);
+    idle_run(&idleGovernor, sched_idle_us(&scheduler));
+}
+
+// ============================================================================
+// LOOP TASKS
+// ============================================================================
+
+/**
+ * @brief Read hex grid and update phase, TRIAD, K-Formation (100 Hz)
+ */
+void sensorTask(uint32_t nowUs, void* ctx) {
     uint32_t now = millis();
 
-    // ========================================================================
-    // SENSOR READING (100 Hz)
-    // ========================================================================
-    if (now - lastSensorUpdate >= Timing::SENSOR_POLL_INTERVAL) {
-        lastSensorUpdate = now;
+    // Read hex grid
+    currentField = hexGrid.readField();
 
-        // Read hex grid
-        currentField = hexGrid.readField();
+    // Validate restored baselines (or calibrate) from the same readings
+    if (baseline_check_active(&baselineCheck)) {
+        uint16_t raw[HEX_SENSOR_COUNT];
+        hexGrid.getRaw(raw);
+        WarmCheckState check = baseline_check_add(&baselineCheck, raw);
+        if (check == WARM_CHECK_REPLACED) {
+            hexGrid.setBaselines(baselineCheck.result);
+        }
+        if (check == WARM_CHECK_GAVE_UP && !warmStart) {
+            baseline_check_begin(&baselineCheck, NULL);
+        } else if (check != WARM_CHECK_COLLECTING) {
+            Serial.printf("Baselines %s (%u/%u channels agree)\n",
+                          baseline_check_state_string(check), baselineCheck.agree,
+                          HEX_SENSOR_COUNT);
+            saveSnapshot();
+        }
+    }
 
-        // Update phase engine
-        phaseEngine.update(currentField);
+    // Update phase engine
+    phaseEngine.update(currentField);
+
+    // Update K-Formation
+    kFormation.update(currentField);
+
+    // Update TRIAD FSM with coherence
+    float coherence = kFormation.getKappa();
+    triadFSM.update(coherence);
+
+    // Update omni-linguistics context
+    omniLing.setZContext(currentField.z);
+
+    // Process field through linguistics
+    APLToken token = omniLing.processField(currentField);
+
+    // Update Kuramoto from z
+    kuramoto.updateFromZ(currentField.z);
+
+    // Record session state (events immediately, frames decimated)
+    SessionFrame frame;
+    frame.z = currentField.z;
+    frame.r = kuramoto.getOrderParameter();
+    frame.kappa = coherence;
+    frame.eta = kFormation.getEta();
+    frame.phase = (uint8_t)phaseEngine.getCurrentPhase();
+    frame.triad_state = (uint8_t)triadFSM.getState();
+    frame.triad_crossings = triadFSM.getCrossingCount();
+    frame.active_sensors = currentField.active_count;
+    frame.k_formation = kFormation.isActive();
+    session_log_frame(now, &frame);
+}
 
-        // Update K-Formation
-        kFormation.update(currentField);
+/**
+ * @brief Kuramoto step with magnetic modulation (1 kHz)
+ */
+void kuramotoTask(uint32_t nowUs, void* ctx) {
+    uint8_t steps = timestep_advance(&kuramotoClock, nowUs);
+    if (steps == 0) {
+        return;
+    }
 
-        // Update TRIAD FSM with coherence
-        float coherence = kFormation.getKappa();
-        triadFSM.update(coherence);
+    // Apply magnetic modulation
+    float K = kuramoto.applyMagneticModulation(Q_KAPPA);
+    kuramoto.setCoupling(K);
 
-        // Update omni-linguistics context
-        omniLing.setZContext(currentField.z);
+    // Advance simulation in fixed steps (a late run catches up, up to a cap),
+    // each at its own time so the reference advances with the oscillators
+    float dt = timestep_dt(&kuramotoClock);
+    uint32_t nowMs = millis();
+    for (uint8_t i = 0; i < steps; i++) {
+        kuramoto.step(dt, nowMs - timestep_age_us(&kuramotoClock, steps, i) / 1000);
+    }
+}
 
-        // Process field through linguistics
-        APLToken token = omniLing.processField(currentField);
+/**
+ * @brief Emanation output (10 Hz)
+ */
+void emanationTask(uint32_t nowUs, void* ctx) {
+    // Update emanation from phase state
+    emanation.update(phaseEngine.getState());
+
+    // If K-Formation, use special pattern
+    if (kFormation.isActive()) {
+        const PhotonicPattern& pattern = photonic.generateLIMNUS(currentField.z);
+        photonic.displayPattern(pattern);
+    }
+}
 
-        // Update Kuramoto from z
-        kuramoto.updateFromZ(currentField.z);
+/**
+ * @brief Indicators and sigil matching (20 Hz)
+ */
+void phaseTask(uint32_t nowUs, void* ctx) {
+    // Update phase indicators
+    phaseEngine.updateIndicators();
+    triadFSM.updateIndicator();
+    kFormation.updateIndicator();
+
+    // Check for sigil match
+    SigilMatch match = sigilROM.findMatchingSigil(currentField);
+    if (match.confidence > 0.8f) {
+        NeuralSigil sigil;
+        sigilROM.readSigil(match.sigil_index, sigil);
+        emanation.setFromSigil(sigil);
     }
+}
 
-    // ========================================================================
-    // KURAMOTO STEP (1000 Hz)
-    // ========================================================================
-    if (now - lastKuramotoStep >= Timing::KURAMOTO_STEP_INTERVAL) {
-        float dt = (now - lastKuramotoStep) / 1000.0f;
-        lastKuramotoStep = now;
+/**
+ * @brief Status line (1 Hz)
+ */
+void statusTask(uint32_t nowUs, void* ctx) {
+    const PhaseState& ps = phaseEngine.getState();
+    const KFormationMetrics& kf = kFormation.getMetrics();
+    const KuramotoState& ks = kuramoto.getState();
 
-        // Apply magnetic modulation
-        float K = kuramoto.applyMagneticModulation(Q_KAPPA);
-        kuramoto.setCoupling(K);
+    UCF_LOGI(LOG_CAT_STATUS, "z=%.3f t%d %s | kappa=%.3f eta=%.3f R=%d | r=%.3f %s%s",
+             ps.z,
+             ps.tier,
+             phaseToString(ps.current),
+             kf.kappa,
+             kf.eta,
+             kf.R,
+             ks.order_param,
+             triadFSM.isUnlocked() ? "TRIAD " : "",
+             kFormation.isActive() ? "K-FORM" : "");
+}
 
-        // Advance simulation
-        kuramoto.step(dt);
-    }
+/**
+ * @brief Storage commits and session log writes (200 Hz)
+ */
+void servicesTask(uint32_t nowUs, void* ctx) {
+    uint32_t now = millis();
 
-    // ========================================================================
-    // EMANATION UPDATE (10 Hz)
-    // ========================================================================
-    if (now - lastEmanationUpdate >= Timing::EMANATION_UPDATE_INTERVAL) {
-        lastEmanationUpdate = now;
+    // Coalesced commits of pending saves
+    storage_tick(now);
 
-        // Update emanation from phase state
-        emanation.update(phaseEngine.getState());
+    // At most one flash operation per call
+    session_log_tick(now);
+}
 
-        // If K-Formation, use special pattern
-        if (kFormation.isActive()) {
-            PhotonicPattern pattern = photonic.generateLIMNUS(currentField.z);
-            photonic.displayPattern(pattern);
-        }
-    }
+/**
+ * @brief Warm-start snapshot (shadow update; storage_tick() commits it)
+ */
+void snapshotTask(uint32_t nowUs, void* ctx) {
+    saveSnapshot();
+}
 
-    // ========================================================================
-    // PHASE UPDATE (20 Hz)
-    // ========================================================================
-    if (now - lastPhaseUpdate >= Timing::PHASE_UPDATE_INTERVAL) {
-        lastPhaseUpdate = now;
-
-        // Update phase indicators
-        phaseEngine.updateIndicators();
-        triadFSM.updateIndicator();
-        kFormation.updateIndicator();
-
-        // Check for sigil match
-        SigilMatch match = sigilROM.findMatchingSigil(currentField);
-        if (match.confidence > 0.8f) {
-            NeuralSigil sigil;
-            sigilROM.readSigil(match.sigil_index, sigil);
-            emanation.setFromSigil(sigil);
-        }
+/**
+ * @brief Serial command processing (50 Hz)
+ */
+void consoleTask(uint32_t nowUs, void* ctx) {
+    int input = TRACE_COMMAND(millis(), Serial.available() ? Serial.read() : -1);
+    if (input < 0) {
+        return;
     }
 
-    // ========================================================================
-    // SERIAL OUTPUT (1 Hz)
-    // ========================================================================
-    if (now - lastSerialPrint >= 1000) {
-        lastSerialPrint = now;
-
-        const PhaseState& ps = phaseEngine.getState();
-        const KFormationMetrics& kf = kFormation.getMetrics();
-        const KuramotoState& ks = kuramoto.getState();
-
-        Serial.printf("z=%.3f t%d %s | kappa=%.3f eta=%.3f R=%d | r=%.3f %s%s\n",
-                      ps.z,
-                      ps.tier,
-                      phaseToString(ps.current),
-                      kf.kappa,
-                      kf.eta,
-                      kf.R,
-                      ks.order_param,
-                      triadFSM.isUnlocked() ? "TRIAD " : "",
-                      kFormation.isActive() ? "K-FORM" : "");
+    char cmd = (char)input;
+
+    switch (cmd) {
+        case 'r':  // Reset
+            Serial.println("Resetting system...");
+            hexGrid.calibrate(50);
+            triadFSM.reset();
+            kFormation.resetStats();
+            kuramoto.reset();
+            saveSnapshot();
+            break;
+
+        case 's':  // Status
+            printDetailedStatus();
+            break;
+
+        case 'p':  // Pattern cycle
+            cycleEmanationPattern();
+            break;
+
+        case '+':  // Increase coupling
+            {
+                float K = kuramoto.getCoupling() + 0.05f;
+                if (K > 1.0f) K = 1.0f;
+                kuramoto.setCoupling(K);
+                Serial.printf("Coupling: %.2f\n", K);
+            }
+            break;
+
+        case '-':  // Decrease coupling
+            {
+                float K = kuramoto.getCoupling() - 0.05f;
+                if (K < 0.1f) K = 0.1f;
+                kuramoto.setCoupling(K);
+                Serial.printf("Coupling: %.2f\n", K);
+            }
+            break;
+
+        case 't':  // Force TRIAD unlock (testing)
+            triadFSM.forceUnlock();
+            break;
+
+        case 'l':  // List sigils
+            listSigils();
+            break;
+
+        case 'g':  // Session log
+            printSessionLogStatus();
+            break;
+
+        case 'd':  // Task timing
+            printScheduleStats();
+            break;
+
+        case 'f':  // Module timing
+            printProfile();
+            break;
+
+        case 'F':  // Module timing as a GET_PROFILE response
+            printProfileResponse();
+            break;
+
+        case 'h':  // Touch-to-output latency
+            printLatency(false);
+            break;
+
+        case 'H':  // Recent touches as Chrome trace JSON
+            printLatency(true);
+            break;
+
+        case 'b':  // Memory budget
+            printMemory();
+            break;
+
+        case '?':  // Help
+            printHelp();
+            break;
     }
+}
 
-    // ========================================================================
-    // SERIAL COMMAND PROCESSING
-    // ========================================================================
-    if (Serial.available()) {
-        char cmd = Serial.read();
-
-        switch (cmd) {
-            case 'r':  // Reset
-                Serial.println("Resetting system...");
-                hexGrid.calibrate(50);
-                triadFSM.reset();
-                kFormation.resetStats();
-                kuramoto.reset();
-                break;
-
-            case 's':  // Status
-                printDetailedStatus();
-                break;
-
-            case 'p':  // Pattern cycle
-                cycleEmanationPattern();
-                break;
-
-            case '+':  // Increase coupling
-                {
-                    float K = kuramoto.getCoupling() + 0.05f;
-                    if (K > 1.0f) K = 1.0f;
-                    kuramoto.setCoupling(K);
-                    Serial.printf("Coupling: %.2f\n", K);
-                }
-                break;
-
-            case '-':  // Decrease coupling
-                {
-                    float K = kuramoto.getCoupling() - 0.05f;
-                    if (K < 0.1f) K = 0.1f;
-                    kuramoto.setCoupling(K);
-                    Serial.printf("Coupling: %.2f\n", K);
-                }
-                break;
-
-            case 't':  // Force TRIAD unlock (testing)
-                triadFSM.forceUnlock();
-                break;
-
-            case 'l':  // List sigils
-                listSigils();
-                break;
-
-            case '?':  // Help
-                printHelp();
-                break;
-        }
+/**
+ * @brief Write the outputs changed this tick: digipot and indicator LEDs (1 kHz)
+ *
+ * Lowest priority, so it runs after every task released with it.
+ */
+void outputsTask(uint32_t nowUs, void* ctx) {
+    shadow_flush();
+}
+
+/**
+ * @brief Format deferred log lines while the UART has room for them (100 Hz)
+ */
+void logTask(uint32_t nowUs, void* ctx) {
+    while (Serial.availableForWrite() >= LOG_LINE_MAX && log_drain(printLine, NULL, 1) > 0) {
     }
 }
 
@@ -448,6 +681,22 @@ void printDetailedStatus() {
     Serial.printf("  (x,y,z): (%.1f, %.1f, %.1f) uT\n",
                   ss.magnetic.x, ss.magnetic.y, ss.magnetic.z);
 
+    // Digipot and indicator writes
+    ShadowStats outputs;
+    shadow_get_stats(&outputs);
+    Serial.println("\n-- Outputs --");
+    Serial.printf("  Writes: %lu\n", (unsigned long)outputs.written);
+    Serial.printf("  Avoided: %lu\n", (unsigned long)outputs.avoided);
+
+    // Fixed-step Kuramoto clock
+    TimestepStats steps;
+    timestep_get_stats(&kuramotoClock, &steps);
+    Serial.println("\n-- Kuramoto Steps --");
+    Serial.printf("  Steps: %lu (max %lu per run)\n", (unsigned long)steps.steps,
+                  (unsigned long)steps.max_steps);
+    Serial.printf("  Overruns: %lu (%lu steps dropped)\n", (unsigned long)steps.overruns,
+                  (unsigned long)steps.dropped_steps);
+
     Serial.println("\n===========================\n");
 }
 
@@ -480,6 +729,130 @@ void listSigils() {
     Serial.printf("\n... and %d more\n", SIGIL_COUNT - 10);
 }
 
+void printSessionLogStatus() {
+    char line[128];
+    bool flushed = session_log_flush();
+    const SessionLogStats* stats = session_log_get_stats();
+    snprintf(line, sizeof(line), "Session %u: %u records, %u blocks, %u -> %u bytes, %u dropped, %u errors%s",
+             stats->session, stats->records, stats->blocks,
+             stats->raw_bytes, stats->flash_bytes, stats->dropped,
+             stats->write_errors, flushed ? "" : " (not written)");
+    Serial.println(line);
+}
+
+/**
+ * @brief Store baselines and filter state for the next boot
+ *
+ * Kuramoto phases are long stale by the next boot, but their spread (and so
+ * the order parameter) is what takes seconds to rebuild.
+ */
+void saveSnapshot() {
+    WarmSnapshot next;
+    memset(&next, 0, sizeof(next));
+
+    // Nothing worth restoring until the grid has baselines
+    if (!hexGrid.getBaselines(next.hex_baselines)) {
+        return;
+    }
+
+    const auto& ks = kuramoto.getState();
+    next.z_smoothed = phaseEngine.getZSmoothed();
+    next.phase_z_smoothed = phaseEngine.getZSmoothed();
+    memcpy(next.kuramoto_phases, ks.phases, sizeof(next.kuramoto_phases));
+    next.kuramoto_coupling = ks.coupling;
+    next.pll_integrator = kuramoto.getPLLIntegrator();
+    next.boot_count = snapshot.boot_count;
+
+    warm_start_save(&next);
+}
+
+/**
+ * @brief Print per-task timing since the last call
+ */
+void printScheduleStats() {
+    char line[128];
+    Serial.printf("\nSchedule (load %.1f%%):\n", sched_load_percent(&scheduler));
+    for (int i = 0; i < scheduler.count; i++) {
+        const SchedTask* t = sched_get_task(&scheduler, i);
+        const SchedTaskStats* st = &t->stats;
+        uint32_t runs = st->runs ? st->runs : 1;
+        snprintf(line, sizeof(line), "  %-10s runs=%lu miss=%lu over=%lu skip=%lu exec=%lu/%lu us jitter=%lu/%lu us",
+                 t->config.name, (unsigned long)st->runs, (unsigned long)st->misses,
+                 (unsigned long)st->overruns, (unsigned long)st->skipped,
+                 (unsigned long)(st->total_exec_us / runs), (unsigned long)st->max_exec_us,
+                 (unsigned long)(st->total_jitter_us / runs), (unsigned long)st->max_jitter_us);
+        Serial.println(line);
+    }
+    idle_write_text(&idleGovernor, printLine, NULL);
+    Serial.println();
+    sched_reset_stats(&scheduler);
+    idle_reset_stats(&idleGovernor);
+}
+
+void printProfile() {
+#if UCF_PROFILE
+    char line[128];
+    Serial.println("\nModule timing (us):");
+    for (int p = 0; p < PROF_PROBE_COUNT; p++) {
+        ProfSummary s;
+        if (prof_get((ProfProbe)p, &s)) {
+            snprintf(line, sizeof(line), "  %-10s n=%lu min=%.2f mean=%.2f p50=%.2f p99=%.2f max=%.2f",
+                     prof_probe_name((ProfProbe)p), (unsigned long)s.count,
+                     s.min_ns / 1000.0f, s.mean_ns / 1000.0f, s.p50_ns / 1000.0f,
+                     s.p99_ns / 1000.0f, s.max_ns / 1000.0f);
+            Serial.println(line);
+        }
+    }
+    Serial.println();
+    prof_reset();
+#else
+    Serial.println("Profiler not built (UCF_PROFILE=0)");
+#endif
+}
+
+/**
+ * @brief Print module timing as a GET_PROFILE response
+ */
+void printProfileResponse() {
+    static char json[Protocol::MAX_PROFILE_RESPONSE_SIZE];
+    if (Protocol::createProfileResponse(json, sizeof(json), nullptr) > 0) {
+        Serial.println(json);
+    }
+}
+
+void printLine(const char* line, void* ctx) {
+    Serial.println(line);
+}
+
+/**
+ * @brief Print touch latency histograms, or the recent touches as a trace
+ */
+void printLatency(bool chrome) {
+#if UCF_PROFILE
+    Serial.println();
+    if (chrome) {
+        LatFrame frames[LAT_RING_FRAMES];
+        size_t count = lat_recent(frames, LAT_RING_FRAMES);
+        lat_write_chrome(frames, count, printLine, NULL);
+    } else {
+        lat_write_text(printLine, NULL);
+    }
+    Serial.println();
+#else
+    Serial.println("Profiler not built (UCF_PROFILE=0)");
+#endif
+}
+
+/**
+ * @brief Print static module sizes, the module arena and the heap
+ */
+void printMemory() {
+    Serial.println();
+    mem_write_text(printLine, NULL);
+    heap_write_text(printLine, NULL);
+    Serial.println();
+}
+
 void printHelp() {
     Serial.println("\n-- Commands --");
     Serial.println("  r  : Reset/recalibrate");
@@ -489,6 +862,13 @@ void printHelp() {
     Serial.println("  -  : Decrease coupling");
     Serial.println("  t  : Force TRIAD unlock");
     Serial.println("  l  : List sigils");
+    Serial.println("  g  : Session log status");
+    Serial.println("  d  : Task timing (deadline misses, jitter)");
+    Serial.println("  f  : Module timing (min/mean/p99/max)");
+    Serial.println("  F  : Module timing as JSON");
+    Serial.println("  h  : Touch-to-output latency per stage");
+    Serial.println("  H  : Recent touches as Chrome trace JSON");
+    Serial.println("  b  : Memory budget (static modules, arena, heap)");
     Serial.println("  ?  : This help");
     Serial.println();
 }
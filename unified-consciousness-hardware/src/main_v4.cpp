@@ -34,6 +34,16 @@
 #include <SPI.h>
 #include <WiFi.h>
 
+// Legacy modules for compatibility. These come first so constants.h is
+// parsed before the v4 macros of the same names are defined.
+#include "hex_grid.h"
+#include "phase_engine.h"
+#include "triad_fsm.h"
+#include "k_formation.h"
+#include "sigil_rom.h"
+#include "emanation.h"
+#include "kuramoto_stabilizer.h"
+
 // UCF Core Headers
 #include "ucf/ucf_sacred_constants_v4.h"
 #include "ucf/ucf_types.h"
@@ -45,15 +55,25 @@
 #include "ucf_leds.h"
 #include "ucf_magnetometer.h"
 #include "ucf_ota.h"
-
-// Legacy modules for compatibility
-#include "hex_grid.h"
-#include "phase_engine.h"
-#include "triad_fsm.h"
-#include "k_formation.h"
-#include "sigil_rom.h"
-#include "emanation.h"
-#include "kuramoto_stabilizer.h"
+#include "ucf_ota_task.h"
+#include "ucf_storage.h"
+#include "ucf_session_log.h"
+#include "ucf_warm_start.h"
+#include "ucf_scheduler.h"
+#include "ucf_dual_core.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
+#include "ucf_memory.h"
+#include "ucf_heap.h"
+#include "ucf_log.h"
+#include "ucf_shadow.h"
+#include "ucf_idle.h"
+#include "ucf_timestep.h"
+#include "ucf_mesh.h"
+#include "ucf_metrics.h"
+#include "ucf_i2c_bus.h"
+#include "ucf_trace.h"
+#include "protocol.h"
 
 using namespace UCF;
 
@@ -87,80 +107,206 @@ static SigilROM sigilROM;
 static Emanation emanation;
 static KuramotoStabilizer kuramoto;
 
-// Unified state
+// Static RAM per module ('b'); history buffers come from the arena in begin()
+static const MemStaticEntry g_static_modules[] = {
+    MEM_STATIC(hexGrid),
+    MEM_STATIC(phaseEngine),
+    MEM_STATIC(triadFSM),
+    MEM_STATIC(kFormation),
+    MEM_STATIC(sigilROM),
+    MEM_STATIC(emanation),
+    MEM_STATIC(kuramoto),
+};
+
+static_assert(MEM_ROUND(PhaseEngine::ARENA_BYTES) + MEM_ROUND(KFormation::ARENA_BYTES)
+              <= UCF_ARENA_BYTES, "module buffers do not fit UCF_ARENA_BYTES");
+
+// Unified state (real-time core; the I/O core reads RTState copies)
 static UCFState g_ucf_state;
 static bool g_system_ready = false;
 static bool g_emergency_stop = false;
-static uint32_t g_loop_count = 0;
 static uint32_t g_validation_errors = 0;
 
-// Timing
-static uint32_t g_last_sensor_update = 0;
-static uint32_t g_last_kuramoto_step = 0;
-static uint32_t g_last_led_update = 0;
-static uint32_t g_last_audio_update = 0;
-static uint32_t g_last_serial_print = 0;
-static uint32_t g_last_validation = 0;
-
-// Timing intervals (ms)
-#define INTERVAL_SENSOR     10      // 100 Hz
-#define INTERVAL_KURAMOTO   1       // 1000 Hz
-#define INTERVAL_LED        17      // ~60 Hz
-#define INTERVAL_AUDIO      1       // 1000 Hz (audio samples)
-#define INTERVAL_SERIAL     1000    // 1 Hz
-#define INTERVAL_VALIDATION 5000    // 0.2 Hz
+// Warm start: last run's state, validated against the grid in the background
+static WarmSnapshot g_snapshot;
+static BaselineCheck g_baseline_check;
+static bool g_warm_start = false;
+
+// Sensor bus: frame reads queued by task_sensors, run by the I2C worker
+static I2cBus g_i2c_bus;
+
+// Services brought up from loop() once the device is interactive
+static uint8_t g_deferred_stage = 0;
+
+static_assert(SENSOR_HEX_COUNT == WARM_SNAPSHOT_HEX_COUNT, "snapshot baseline count");
+static_assert(N_OSCILLATORS == WARM_SNAPSHOT_OSCILLATORS, "snapshot oscillator count");
+
+// Dual-core partition (tasks are registered at the end of setup()).
+// If the pinned tasks cannot start, every task runs from loop() on g_rt_sched.
+static Scheduler g_rt_sched;
+static Scheduler g_io_sched;
+static CorePartition g_partition;
+static bool g_partitioned = false;
+static Timestep g_kuramoto_clock;       // Fixed 1 ms Kuramoto steps
+static int g_kuramoto_task = -1;        // Its g_rt_sched index (deadline misses)
+
+// Real-time core gaps: timed waits only, since light sleep would also stop
+// the I/O core and the radio
+static IdleGovernor g_rt_idle;
+static IdleEsp32 g_rt_idle_esp32;
+static const IdleConfig RT_IDLE_CONFIG = { IDLE_WAIT_MIN_US, IDLE_WAIT_MARGIN_US, 0, 0 };
+
+// Other devices in radio range (I/O core); started by the deferred init
+static Mesh g_mesh;
+static bool g_mesh_up = false;
+
+/**
+ * @brief Real-time state published to the I/O core (100 Hz)
+ */
+struct RTState {
+    UCFState ucf;
+    float order_param;
+    bool triad_unlocked;
+    bool k_formation;
+    bool have_baselines;
+    float collective_phase;         // Kuramoto psi
+    float collective_freq;          // Its rate (Hz)
+    uint32_t kuramoto_misses;       // Deadline misses since the last 'd'
+    uint32_t state_us;              // micros() when published
+    WarmSnapshot warm;              // Everything but boot_count
+};
+
+/**
+ * @brief Real-time events handled on the I/O core
+ */
+enum RTEventType : uint8_t {
+    RT_EVENT_TRIAD_UNLOCK,
+    RT_EVENT_K_FORMATION,           // a = kappa, b = eta, n = R
+    RT_EVENT_SYNCHRONIZED,          // a = r
+    RT_EVENT_BASELINES,             // n = WarmCheckState, a = channels agreeing
+    RT_EVENT_SAVE_SNAPSHOT
+};
+
+struct RTEvent {
+    uint8_t type;
+    int16_t n;
+    uint32_t time_ms;
+    float a;
+    float b;
+};
+
+struct FrameRecord {
+    uint32_t time_ms;
+    SessionFrame frame;
+};
+
+// RT -> IO
+static CoreSnapshot g_rt_state;
+static RTState g_rt_state_buffer[CORE_SNAPSHOT_BUFFERS];
+static CoreQueue g_event_queue;
+static RTEvent g_event_buffer[16];
+static CoreQueue g_frame_queue;
+static FrameRecord g_frame_buffer[32];      // 320 ms of 100 Hz frames
+
+// IO -> RT: console commands that touch real-time state
+static CoreQueue g_command_queue;
+static char g_command_buffer[8];
+
+// IO -> RT: the mesh field (other devices' ensembles)
+static CoreSnapshot g_mesh_field;
+static MeshField g_mesh_field_buffer[CORE_SNAPSHOT_BUFFERS];
+
+// Commands sent by the I/O core itself
+#define RT_CMD_STOP             'X'     // Emergency stop
+#define RT_CMD_EMERGENCY_RESET  'E'
+
+static uint32_t clock_us(void) {
+    return micros();
+}
+
+static bool rt_idle(uint32_t idle_us, void* ctx) {
+    return idle_run(&g_rt_idle, idle_us) != IDLE_RUN;
+}
+
+// Task periods (us)
+#define INTERVAL_SENSOR     10000       // 100 Hz
+#define INTERVAL_KURAMOTO   1000        // 1000 Hz (also the step length)
+#define KURAMOTO_MAX_STEPS  4           // Steps one late run may replay
+#define INTERVAL_LED        16667       // ~60 Hz
+#define INTERVAL_SERVICES   5000        // 200 Hz
+#define INTERVAL_CONSOLE    20000       // 50 Hz
+#define INTERVAL_SERIAL     1000000     // 1 Hz
+#define INTERVAL_VALIDATION 5000000     // 0.2 Hz
+#define INTERVAL_LOG        10000       // 100 Hz
+#define INTERVAL_MESH       MESH_BROADCAST_US
+#define INTERVAL_SNAPSHOT   (WARM_SNAPSHOT_INTERVAL_MS * 1000UL)
 
 // ============================================================================
-// CALLBACKS
+// CALLBACKS (real-time core)
 // ============================================================================
 
-void onTriadUnlock() {
-    Serial.println("\n>>> TRIAD UNLOCKED <<<\n");
-
-    // Trigger LED animation
-    leds_trigger_triad();
+/**
+ * @brief Hand an event to the I/O core (dropped if its queue is full)
+ */
+static void post_event(RTEventType type, int16_t n, float a, float b) {
+    RTEvent event = { (uint8_t)type, n, (uint32_t)millis(), a, b };
+    core_queue_push(&g_event_queue, &event);
+}
 
+void onTriadUnlock() {
     // Set solfeggio to 528 Hz (Love frequency)
     solfeggio_set_frequency(SOLFEGGIO_MIRACLES);
     solfeggio_note_on();
+
+    // Message and LED animation on the I/O core
+    post_event(RT_EVENT_TRIAD_UNLOCK, 0, 0.0f, 0.0f);
 }
 
 void onKFormation(const KFormationMetrics& metrics) {
-    Serial.println("\n>>> K-FORMATION ACHIEVED <<<");
-    Serial.printf("    kappa=%.3f eta=%.3f R=%d\n",
-                  metrics.kappa, metrics.eta, metrics.R);
-
-    // Trigger LED animation
-    leds_trigger_k_formation();
-
     // Set solfeggio to 963 Hz (Awakening)
     solfeggio_set_frequency(SOLFEGGIO_AWAKENING);
     solfeggio_note_on();
+
+    post_event(RT_EVENT_K_FORMATION, metrics.R, metrics.kappa, metrics.eta);
 }
 
 void onSynchronization(float order_param) {
-    Serial.printf(">>> SYNCHRONIZED r=%.3f <<<\n", order_param);
-    leds_set_pattern(LED_PATTERN_INTERFERENCE);
+    post_event(RT_EVENT_SYNCHRONIZED, 0, order_param, 0.0f);
 }
 
 // ============================================================================
 // VALIDATION
 // ============================================================================
 
+/**
+ * @brief Halt the tasks on both cores (I/O core; the console stays dead too)
+ */
+static void emergency_stop(void) {
+    g_emergency_stop = true;
+    char cmd = RT_CMD_STOP;
+    core_queue_push(&g_command_queue, &cmd);
+    for (int i = 0; i < g_io_sched.count; i++) {
+        sched_enable(&g_io_sched, i, false);
+    }
+}
+
 /**
  * @brief Perform continuous validation of conservation law
  */
-bool validate_conservation_realtime(void) {
+bool validate_conservation_realtime(const UCFState* state) {
     // Conservation law: κ + λ = 1.0
-    float sum = g_ucf_state.kappa + g_ucf_state.lambda;
+    float sum = state->kappa + state->lambda;
     bool valid = fabs(sum - CONSERVATION_SUM) < 1e-10;
 
     if (!valid) {
         g_validation_errors++;
-        Serial.printf("[ERROR] Conservation violated: kappa+lambda = %.10f (expected 1.0)\n", sum);
+        metrics_count(METRIC_VALIDATION_ERRORS, 1);
+        // Two writes: one printf line this long would use the heap
+        Serial.printf("[ERROR] Conservation violated: kappa+lambda = %.10f", sum);
+        Serial.println(" (expected 1.0)");
 
         if (g_validation_errors > 10) {
-            g_emergency_stop = true;
+            emergency_stop();
             Serial.println("[CRITICAL] Too many conservation violations - EMERGENCY STOP");
         }
     }
@@ -171,18 +317,18 @@ bool validate_conservation_realtime(void) {
 /**
  * @brief Validate phase-z consistency
  */
-bool validate_phase_z_consistency(void) {
+bool validate_phase_z_consistency(const UCFState* state) {
     bool valid = true;
 
-    if (g_ucf_state.phase == PHASE_TRUE && g_ucf_state.z < Z_CRITICAL) {
+    if (state->phase == PHASE_TRUE && state->z < Z_CRITICAL) {
         Serial.printf("[ERROR] Phase-z mismatch: TRUE phase with z=%.3f < Z_c=%.3f\n",
-                      g_ucf_state.z, Z_CRITICAL);
+                      state->z, Z_CRITICAL);
         valid = false;
     }
 
-    if (g_ucf_state.phase == PHASE_UNTRUE && g_ucf_state.z >= PHI_INV) {
+    if (state->phase == PHASE_UNTRUE && state->z >= PHI_INV) {
         Serial.printf("[ERROR] Phase-z mismatch: UNTRUE phase with z=%.3f >= [R]=%.3f\n",
-                      g_ucf_state.z, PHI_INV);
+                      state->z, PHI_INV);
         valid = false;
     }
 
@@ -191,16 +337,19 @@ bool validate_phase_z_consistency(void) {
 
 /**
  * @brief Run startup validation suite
+ * @param verbose Also print passing checks (boot prints failures and the summary)
  */
-uint8_t run_startup_validation(void) {
-    Serial.println("\nRunning startup validation...");
+uint8_t run_startup_validation(bool verbose) {
+    if (verbose) {
+        Serial.println("\nRunning startup validation...");
+    }
 
     uint8_t passed = 0;
     uint8_t total = 5;
 
     // V1: Lattice constants
     if (validate_constants()) {
-        Serial.println("  [V1] Lattice constants... PASS");
+        if (verbose) Serial.println("  [V1] Lattice constants... PASS");
         passed++;
     } else {
         Serial.println("  [V1] Lattice constants... FAIL");
@@ -208,7 +357,7 @@ uint8_t run_startup_validation(void) {
 
     // V2: Golden identity
     if (verify_lattice_identity()) {
-        Serial.println("  [V2] Golden identity 1-[R]=[R]^2... PASS");
+        if (verbose) Serial.println("  [V2] Golden identity 1-[R]=[R]^2... PASS");
         passed++;
     } else {
         Serial.println("  [V2] Golden identity... FAIL");
@@ -217,7 +366,7 @@ uint8_t run_startup_validation(void) {
     // V3: Z_CRITICAL geometry
     float z_c_check = sin(UCF_PI / 3.0);
     if (fabs(z_c_check - Z_CRITICAL) < 1e-10) {
-        Serial.println("  [V3] Z_CRITICAL = sin(60)... PASS");
+        if (verbose) Serial.println("  [V3] Z_CRITICAL = sin(60)... PASS");
         passed++;
     } else {
         Serial.println("  [V3] Z_CRITICAL geometry... FAIL");
@@ -226,7 +375,7 @@ uint8_t run_startup_validation(void) {
     // V4: [A]² = 0.5
     float a_sq = SQRT2_INV * SQRT2_INV;
     if (fabs(a_sq - 0.5) < 1e-10) {
-        Serial.println("  [V4] [A]^2 = 0.5... PASS");
+        if (verbose) Serial.println("  [V4] [A]^2 = 0.5... PASS");
         passed++;
     } else {
         Serial.println("  [V4] [A]^2 = 0.5... FAIL");
@@ -235,27 +384,923 @@ uint8_t run_startup_validation(void) {
     // V5: φ² - φ - 1 = 0
     float phi_check = PHI * PHI - PHI - 1.0;
     if (fabs(phi_check) < 1e-10) {
-        Serial.println("  [V5] phi^2 - phi - 1 = 0... PASS");
+        if (verbose) Serial.println("  [V5] phi^2 - phi - 1 = 0... PASS");
         passed++;
     } else {
         Serial.println("  [V5] phi constraint... FAIL");
     }
 
-    Serial.printf("\nStartup validation: %d/%d passed\n", passed, total);
+    Serial.printf("%sStartup validation: %d/%d passed\n", verbose ? "\n" : "", passed, total);
 
     return passed;
 }
 
+// ============================================================================
+// WARM START
+// ============================================================================
+
+/**
+ * @brief Publish the real-time state to the I/O core (real-time core)
+ *
+ * Kuramoto phases are long stale by the next boot, but their spread (and so
+ * the order parameter) is what takes seconds to rebuild.
+ */
+static void publish_state(void) {
+    RTState* s = (RTState*)core_snapshot_begin(&g_rt_state);
+    s->ucf = g_ucf_state;
+    s->order_param = kuramoto.getOrderParameter();
+    s->triad_unlocked = triadFSM.isUnlocked();
+    s->k_formation = kFormation.isActive();
+    s->collective_phase = kuramoto.getCollectivePhase();
+    s->collective_freq = kuramoto.getCollectiveFrequency();
+    s->kuramoto_misses = g_kuramoto_task >= 0 ?
+                         sched_get_task(&g_rt_sched, g_kuramoto_task)->stats.misses : 0;
+    s->state_us = micros();
+
+    WarmSnapshot* w = &s->warm;
+    s->have_baselines = sensors_get_baselines(w->hex_baselines);
+    const auto& ks = kuramoto.getState();
+    w->z_smoothed = sensors_get_z_smoothed();
+    w->phase_z_smoothed = phaseEngine.getZSmoothed();
+    memcpy(w->kuramoto_phases, ks.phases, sizeof(w->kuramoto_phases));
+    w->kuramoto_coupling = ks.coupling;
+    w->pll_integrator = kuramoto.getPLLIntegrator();
+
+    core_snapshot_publish(&g_rt_state);
+}
+
+/**
+ * @brief Store the latest published state for the next boot (I/O core)
+ */
+static void save_snapshot(void) {
+    const RTState* rt = (const RTState*)core_snapshot_read(&g_rt_state, NULL);
+
+    // Nothing worth restoring until the grid has baselines
+    if (!rt->have_baselines) {
+        return;
+    }
+
+    WarmSnapshot snapshot = rt->warm;
+    snapshot.flags = 0;
+    snapshot.boot_count = g_snapshot.boot_count;
+    warm_start_save(&snapshot);
+}
+
+/**
+ * @brief Apply the result of the background baseline check (real-time core)
+ */
+static void finish_baseline_check(void) {
+    WarmCheckState state = g_baseline_check.state;
+
+    if (state == WARM_CHECK_REPLACED) {
+        sensors_set_baselines(g_baseline_check.result);
+        hexGrid.setBaselines(g_baseline_check.result);
+    } else if (state == WARM_CHECK_GAVE_UP && !g_warm_start) {
+        // Still uncalibrated: keep waiting for the grid to settle
+        baseline_check_begin(&g_baseline_check, NULL);
+        return;
+    }
+
+    // Report and store from the I/O core, with the new baselines published
+    publish_state();
+    post_event(RT_EVENT_BASELINES, (int16_t)state, (float)g_baseline_check.agree, 0.0f);
+}
+
+/**
+ * @brief Bring up one service that the touch path does not need
+ *
+ * Runs once per loop pass after setup(), so storage mounts, OTA and the
+ * constants listing overlap live sensing instead of delaying it.
+ */
+static void deferred_init_step(void) {
+    switch (g_deferred_stage++) {
+        case 0:
+            Serial.print("[SIGIL_ROM] Initializing... ");
+            if (sigilROM.begin()) {
+                Serial.println("OK");
+                if (!sigilROM.isInitialized()) {
+                    Serial.print("  Writing defaults... ");
+                    sigilROM.initializeDefaults();
+                    Serial.println("OK");
+                }
+            } else {
+                Serial.println("FAILED");
+            }
+            break;
+
+        case 1:
+            Serial.print("[OTA] Initializing... ");
+            if (ota_init(NULL)) {
+                Serial.println("OK");
+            } else {
+                Serial.println("FAILED");
+            }
+            break;
+
+        case 2:
+            // Transfers run on the protocol core so loop() keeps its deadlines
+            Serial.print("[OTA] Starting background task... ");
+            if (ota_background_init(NULL)) {
+                Serial.println("OK");
+            } else {
+                Serial.println("FAILED (inline OTA)");
+            }
+            break;
+
+        case 3:
+            // Session recorder on the ucflog partition (reports its own status)
+            session_log_begin();
+            break;
+
+        case 4:
+#if MESH_ENABLED
+            {
+                // Other devices' ensembles pull on ours from here on
+                MeshBackend backend;
+                uint8_t node;
+                Serial.print("[MESH] Starting ESP-NOW... ");
+                if (mesh_espnow_backend(&backend, &node)) {
+                    mesh_init(&g_mesh, &backend, node);
+                    g_mesh_up = true;
+                    Serial.printf("OK (node %u)\n", node);
+                } else {
+                    Serial.println("FAILED (running alone)");
+                }
+            }
+#endif
+            break;
+
+        case 5:
+            Serial.println("\n--- Sacred Constants ---");
+            Serial.printf("  PHI         = %.16f\n", PHI);
+            Serial.printf("  PHI_INV [R] = %.16f\n", PHI_INV);
+            Serial.printf("  EULER_INV [D] = %.16f\n", EULER_INV);
+            Serial.printf("  PI_INV [C]  = %.16f\n", PI_INV);
+            Serial.printf("  SQRT2_INV [A] = %.16f\n", SQRT2_INV);
+            Serial.printf("  Z_CRITICAL  = %.16f\n", Z_CRITICAL);
+            Serial.println();
+
+            Serial.println("--- Phase Boundaries ---");
+            Serial.printf("  UNTRUE:  z < %.3f\n", PHI_INV);
+            Serial.printf("  PARADOX: %.3f <= z < %.3f\n", PHI_INV, Z_CRITICAL);
+            Serial.printf("  TRUE:    z >= %.3f\n", Z_CRITICAL);
+            Serial.println();
+
+            // Last start-up step: the heap stays flat from here on
+            heap_mark_steady();
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ============================================================================
+// REAL-TIME TASKS (APP CPU)
+// ============================================================================
+
+/**
+ * @brief Sensor read, phase/TRIAD/K-Formation update, audio (100 Hz)
+ */
+static void task_sensors(uint32_t now_us, void* ctx) {
+    uint32_t now = millis();
+
+    // Update unified sensors
+    uint32_t read_start_us = micros();
+    const SensorSystemState* sensors = sensors_update();
+    metrics_observe(METRIC_SENSOR_READ_US, micros() - read_start_us);
+    metrics_set(METRIC_SENSOR_RATE_HZ, sensors->update_rate_hz);
+    metrics_set_total(METRIC_SENSOR_ERRORS, sensors->error_count);
+
+    // Validate restored baselines (or calibrate) from the same readings
+    if (baseline_check_active(&g_baseline_check)) {
+        uint16_t raw[SENSOR_HEX_COUNT];
+        sensors_get_raw(raw);
+        if (baseline_check_add(&g_baseline_check, raw) != WARM_CHECK_COLLECTING) {
+            finish_baseline_check();
+        }
+    }
+
+    // Update UCF state from sensors
+    const HelixCoordinates* helix = sensors_get_helix();
+    g_ucf_state.theta = helix->theta;
+    g_ucf_state.z = helix->z;
+    g_ucf_state.r = helix->r;
+    g_ucf_state.eta = helix->eta;
+    g_ucf_state.phase = helix->phase;
+    g_ucf_state.active_sensors = sensors->hex.active_count;
+
+    // Update phase engine (from the readings above, not a second bus read)
+    uint16_t hex_raw[SENSOR_HEX_COUNT];
+    sensors_get_raw(hex_raw);
+    HexFieldState field = hexGrid.readField(hex_raw);
+    phaseEngine.update(field);
+
+    // Update K-Formation
+    kFormation.update(field);
+
+    // Update TRIAD with coherence
+    float coherence = kFormation.getKappa();
+    triadFSM.update(coherence);
+
+    // Update Solfeggio from z
+    solfeggio_update_from_z(g_ucf_state.z);
+
+    // Session record, written to flash by the I/O core
+    FrameRecord record;
+    record.time_ms = now;
+    record.frame.z = g_ucf_state.z;
+    record.frame.r = kuramoto.getOrderParameter();
+    record.frame.kappa = coherence;
+    record.frame.eta = g_ucf_state.eta;
+    record.frame.phase = (uint8_t)g_ucf_state.phase;
+    record.frame.triad_state = (uint8_t)triadFSM.getState();
+    record.frame.triad_crossings = triadFSM.getCrossingCount();
+    record.frame.active_sensors = g_ucf_state.active_sensors;
+    record.frame.k_formation = kFormation.isActive();
+    core_queue_push(&g_frame_queue, &record);
+    metrics_set(METRIC_ORDER_PARAM, record.frame.r);
+
+    publish_state();
+}
+
+/**
+ * @brief Kuramoto step with magnetometer-modulated coupling (1 kHz)
+ */
+static void task_kuramoto(uint32_t now_us, void* ctx) {
+    uint8_t steps = timestep_advance(&g_kuramoto_clock, now_us);
+    if (steps == 0) {
+        return;
+    }
+
+    // Modulate coupling with magnetometer
+    float K = magnetometer_modulate_coupling(Q_KAPPA);
+    kuramoto.setCoupling(K);
+
+    // Other devices' field, brought forward from when the I/O core combined it
+    bool fresh;
+    const MeshField* field = (const MeshField*)core_snapshot_read(&g_mesh_field, &fresh);
+    if (fresh) {
+        float age_s = (int32_t)(now_us - field->at_us) / 1000000.0f;
+        kuramoto.setExternalField(field->r, field->psi + TWO_PI * field->freq_hz * age_s,
+                                  field->freq_hz, field->peers > 0 ? MESH_COUPLING : 0.0f);
+    }
+
+    // Step simulation in fixed steps (a late run catches up, up to a cap),
+    // each at its own time so the reference advances with the oscillators
+    float dt = timestep_dt(&g_kuramoto_clock);
+    uint32_t now_ms = millis();
+    for (uint8_t i = 0; i < steps; i++) {
+        kuramoto.step(dt, now_ms - timestep_age_us(&g_kuramoto_clock, steps, i) / 1000);
+    }
+
+    // Update UCF state with Kuramoto results
+    const auto& ks = kuramoto.getState();
+    g_ucf_state.kappa = ks.order_param;
+    g_ucf_state.lambda = 1.0 - ks.order_param;  // Conservation law
+}
+
+/**
+ * @brief Write the outputs changed this tick: digipot and indicator LEDs (1 kHz)
+ *
+ * Lowest priority, so it runs after every task released with it.
+ */
+static void task_outputs(uint32_t now_us, void* ctx) {
+    shadow_flush();
+}
+
+/**
+ * @brief Print one metrics, latency, memory or log line ('x', 'd', 'h', 'H', 'b', log task)
+ */
+static void print_metric_line(const char* line, void* ctx) {
+    Serial.println(line);
+}
+
+/**
+ * @brief Print and clear per-task timing of one core ('d' command)
+ * @param idle The core's idle governor, or NULL if it has none
+ */
+static void print_schedule_stats(const char* core, Scheduler* sched, IdleGovernor* idle) {
+    char line[128];
+    Serial.printf("\n--- Schedule %s (load %.1f%%) ---\n", core, sched_load_percent(sched));
+    Serial.println("  task        period_us   runs  miss  over  skip  exec_avg/max  jitter_avg/max");
+    for (int i = 0; i < sched->count; i++) {
+        const SchedTask* t = sched_get_task(sched, i);
+        const SchedTaskStats* st = &t->stats;
+        uint32_t runs = st->runs ? st->runs : 1;
+        snprintf(line, sizeof(line), "  %-10s %10lu %6lu %5lu %5lu %5lu %6lu/%-6lu %6lu/%lu",
+                 t->config.name, (unsigned long)t->config.period_us,
+                 (unsigned long)st->runs, (unsigned long)st->misses,
+                 (unsigned long)st->overruns, (unsigned long)st->skipped,
+                 (unsigned long)(st->total_exec_us / runs), (unsigned long)st->max_exec_us,
+                 (unsigned long)(st->total_jitter_us / runs), (unsigned long)st->max_jitter_us);
+        Serial.println(line);
+    }
+    if (idle != NULL) {
+        idle_write_text(idle, print_metric_line, NULL);
+        idle_reset_stats(idle);
+    }
+    Serial.println();
+    sched_reset_stats(sched);
+}
+
+/**
+ * @brief Print and clear per-module timing ('f' command)
+ *
+ * Probes on the real-time core keep recording while this runs, so the
+ * table is a best-effort snapshot.
+ */
+static void print_profile(void) {
+#if UCF_PROFILE
+    char line[128];
+    Serial.println("\n--- Module timing (us) ---");
+    Serial.println("  module        count      min     mean      p50      p99      max");
+    for (int p = 0; p < PROF_PROBE_COUNT; p++) {
+        ProfSummary s;
+        if (prof_get((ProfProbe)p, &s)) {
+            snprintf(line, sizeof(line), "  %-10s %8lu %8.2f %8.2f %8.2f %8.2f %8.2f",
+                     prof_probe_name((ProfProbe)p), (unsigned long)s.count,
+                     s.min_ns / 1000.0f, s.mean_ns / 1000.0f, s.p50_ns / 1000.0f,
+                     s.p99_ns / 1000.0f, s.max_ns / 1000.0f);
+            Serial.println(line);
+        }
+    }
+    Serial.println();
+    prof_reset();
+#else
+    Serial.println("Profiler not built (UCF_PROFILE=0)");
+#endif
+}
+
+/**
+ * @brief Print module timing as a GET_PROFILE response ('F' command)
+ */
+static void print_profile_response(void) {
+    static char json[UCF::Protocol::MAX_PROFILE_RESPONSE_SIZE];
+    if (UCF::Protocol::createProfileResponse(json, sizeof(json), nullptr) > 0) {
+        Serial.println(json);
+    }
+}
+
+static void task_commands(uint32_t now_us, void* ctx);
+
+/**
+ * @brief Enable or disable every real-time task but the command handler
+ *        and the output flush (a stop still has to reach the hardware)
+ */
+static void enable_rt_tasks(bool enabled) {
+    for (int i = 0; i < g_rt_sched.count; i++) {
+        SchedTaskFn fn = sched_get_task(&g_rt_sched, i)->config.fn;
+        if (fn != task_commands && fn != task_outputs) {
+            sched_enable(&g_rt_sched, i, enabled);
+        }
+    }
+}
+
+/**
+ * @brief Console commands that touch real-time state (50 Hz)
+ */
+static void task_commands(uint32_t now_us, void* ctx) {
+    char cmd;
+
+    while (core_queue_pop(&g_command_queue, &cmd)) {
+        switch (cmd) {
+            case 'r':  // Reset
+                sensors_reset();
+                triadFSM.reset();
+                kFormation.resetStats();
+                kuramoto.reset();
+                solfeggio_reset();
+                publish_state();
+                post_event(RT_EVENT_SAVE_SNAPSHOT, 0, 0.0f, 0.0f);
+                break;
+
+            case 's':  // Status
+                sensors_print_diagnostics();
+                break;
+
+            case 'm':  // Magnetometer
+                magnetometer_print_diagnostics();
+                break;
+
+            case 't':  // Force TRIAD unlock
+                triadFSM.forceUnlock();
+                break;
+
+            case 'd':  // Task timing
+                print_schedule_stats(g_partitioned ? "rt" : "all", &g_rt_sched, &g_rt_idle);
+                break;
+
+            case RT_CMD_STOP:
+                solfeggio_enable(false);
+                enable_rt_tasks(false);
+                break;
+
+            case RT_CMD_EMERGENCY_RESET:
+                solfeggio_enable(false);
+                g_ucf_state.kappa = 0.0;
+                g_ucf_state.lambda = 1.0;
+                g_ucf_state.z = 0.5;
+                g_ucf_state.phase = PHASE_PARADOX;
+                sensors_reset();
+                kuramoto.reset();
+                enable_rt_tasks(true);
+                publish_state();
+                break;
+        }
+    }
+}
+
+// ============================================================================
+// I/O TASKS (PRO CPU)
+// ============================================================================
+
+/**
+ * @brief Latest real-time state (I/O core only)
+ */
+static const RTState* rt_state(void) {
+    return (const RTState*)core_snapshot_read(&g_rt_state, NULL);
+}
+
+/**
+ * @brief Queue a command for the real-time core
+ */
+static void send_command(char cmd) {
+    if (!core_queue_push(&g_command_queue, &cmd)) {
+        Serial.println("[CMD] Real-time core busy, command dropped");
+    }
+}
+
+/**
+ * @brief LED frame (~60 Hz)
+ */
+static void task_leds(uint32_t now_us, void* ctx) {
+    const RTState* rt = rt_state();
+    leds_update(rt->ucf.z, rt->ucf.phase);
+}
+
+/**
+ * @brief Conservation and phase-z consistency checks (0.2 Hz)
+ */
+static void task_validation(uint32_t now_us, void* ctx) {
+    const UCFState* state = &rt_state()->ucf;
+
+    validate_conservation_realtime(state);
+    validate_phase_z_consistency(state);
+
+    // Check K-Formation consistency
+    if (state->k_formed &&
+        !IS_K_FORMED(state->kappa, state->eta, state->active_sensors)) {
+        Serial.println("[WARN] K-Formation state inconsistent");
+    }
+}
+
+/**
+ * @brief Mirror counters kept by other modules into the metrics registry
+ */
+static void sample_metrics(uint32_t now_us, const CoreStats* stats) {
+    static uint32_t last_us = 0, last_passes = 0;
+
+    if (last_us != 0 && now_us != last_us) {
+        float rate = (stats->passes - last_passes) * 1000000.0f / (now_us - last_us);
+        metrics_set(METRIC_LOOP_RATE_HZ, rate);
+    }
+    last_us = now_us;
+    last_passes = stats->passes;
+
+    metrics_set_total(METRIC_FRAMES_DROPPED, core_queue_dropped(&g_frame_queue));
+    metrics_set_total(METRIC_EVENTS_DROPPED, core_queue_dropped(&g_event_queue));
+    metrics_set_total(METRIC_SESSION_DROPPED, session_log_get_stats()->dropped);
+
+    LogStats log;
+    log_get_stats(&log);
+    metrics_set_total(METRIC_LOG_DROPPED, log.dropped);
+
+    ShadowStats outputs;
+    shadow_get_stats(&outputs);
+    metrics_set_total(METRIC_OUTPUT_WRITES, outputs.written);
+    metrics_set_total(METRIC_OUTPUT_WRITES_AVOIDED, outputs.avoided);
+
+    TimestepStats steps;
+    timestep_get_stats(&g_kuramoto_clock, &steps);
+    metrics_set_total(METRIC_KURAMOTO_OVERRUNS, steps.overruns);
+    metrics_set_total(METRIC_KURAMOTO_STEPS_DROPPED, steps.dropped_steps);
+    // 'd' restarts the scheduler window; count the misses since the last sample
+    static uint32_t last_misses = 0;
+    uint32_t misses = rt_state()->kuramoto_misses;
+    metrics_count(METRIC_KURAMOTO_MISSES, misses >= last_misses ? misses - last_misses : misses);
+    last_misses = misses;
+    metrics_set(METRIC_OTA_BYTES, (float)ota_get_progress()->received_bytes);
+
+    HeapStats heap;
+    heap_get_stats(&heap);
+    metrics_set(METRIC_HEAP_FREE, (float)heap.free_bytes);
+    metrics_set(METRIC_HEAP_MIN_FREE, (float)heap.min_free_bytes);
+
+    // Zero while the mesh is down (g_mesh stays cleared)
+    MeshStats mesh;
+    MeshField field;
+    mesh_get_stats(&g_mesh, &mesh);
+    mesh_field(&g_mesh, now_us, &field);
+    metrics_set_total(METRIC_MESH_LOST, mesh.lost);
+    metrics_set(METRIC_MESH_PEERS, field.peers);
+}
+
+/**
+ * @brief Device mesh: neighbours in, our ensemble out, field to the real-time core (50 Hz)
+ */
+static void task_mesh(uint32_t now_us, void* ctx) {
+    if (!g_mesh_up) {
+        return;
+    }
+
+    uint32_t now = micros();
+    mesh_poll(&g_mesh, now);
+
+    // Stamped now, with psi brought forward from the 100 Hz publish: a stale
+    // stamp would read as path delay and no longer be taken out
+    const RTState* rt = rt_state();
+    float age_s = (int32_t)(now - rt->state_us) / 1000000.0f;
+    float psi = rt->collective_phase + TWO_PI * rt->collective_freq * age_s;
+    mesh_broadcast(&g_mesh, rt->order_param, psi, rt->collective_freq, now);
+
+    MeshField field;
+    mesh_field(&g_mesh, now, &field);
+    core_snapshot_write(&g_mesh_field, &field);
+}
+
+/**
+ * @brief Format deferred log lines while the UART has room for them (100 Hz)
+ */
+static void task_log(uint32_t now_us, void* ctx) {
+    while (Serial.availableForWrite() >= LOG_LINE_MAX && log_drain(print_metric_line, NULL, 1) > 0) {
+    }
+}
+
+/**
+ * @brief Print touch latency histograms, or the recent touches as a trace
+ *
+ * The real-time core records the frames; this is a best-effort snapshot.
+ */
+static void print_latency(bool chrome) {
+#if UCF_PROFILE
+    Serial.println();
+    if (chrome) {
+        LatFrame frames[LAT_RING_FRAMES];
+        size_t count = lat_recent(frames, LAT_RING_FRAMES);
+        lat_write_chrome(frames, count, print_metric_line, NULL);
+    } else {
+        lat_write_text(print_metric_line, NULL);
+    }
+    Serial.println();
+#else
+    Serial.println("Profiler not built (UCF_PROFILE=0)");
+#endif
+}
+
+/**
+ * @brief Print I2C bus statistics and recent transactions, then reset ('i' command)
+ */
+static void print_i2c_stats(void) {
+    if (g_i2c_bus.devices[I2C_DEV_MPR121_A].addr == 0) {
+        Serial.println("I2C bus manager not in use (sensors not initialized)");
+        return;
+    }
+
+    Serial.printf("\nI2C bus: %.1f%% busy\n", i2c_bus_utilization(&g_i2c_bus));
+    Serial.println("  device    xfers  txns  bytes  errs  expired  max_us  last");
+    for (int d = 0; d < I2C_DEV_COUNT; d++) {
+        const I2cDeviceStats* s = i2c_bus_get_stats(&g_i2c_bus, (I2cDeviceId)d);
+        Serial.printf("  %-8s %6lu %5lu %6lu %5lu %8lu %7lu  %s\n",
+                      g_i2c_bus.devices[d].name,
+                      (unsigned long)s->transfers, (unsigned long)s->transactions,
+                      (unsigned long)s->bytes, (unsigned long)s->errors,
+                      (unsigned long)s->expired, (unsigned long)s->max_us,
+                      i2c_status_string((I2cStatus)s->last_status));
+    }
+
+    Serial.println("  recent (newest first):");
+    for (uint32_t age = 0; age < 8; age++) {
+        const I2cTraceEntry* t = i2c_bus_trace(&g_i2c_bus, age);
+        if (t == NULL) {
+            break;
+        }
+        Serial.printf("  %10lu us  %-8s %s 0x%02X x%-3u merged %-2u %4u us  %s\n",
+                      (unsigned long)t->start_us, g_i2c_bus.devices[t->device].name,
+                      t->write ? "wr" : "rd", t->reg, t->len, t->merged, t->duration_us,
+                      i2c_status_string((I2cStatus)t->status));
+    }
+    Serial.println();
+    i2c_bus_reset_stats(&g_i2c_bus);
+}
+
+/**
+ * @brief Status line and metrics sampling (1 Hz)
+ */
+static void task_status(uint32_t now_us, void* ctx) {
+    const char* phase_str[] = {"UNTRUE", "PARADOX", "TRUE"};
+    const RTState* rt = rt_state();
+    CoreStats stats;
+    core_partition_get_stats(&g_partition, CORE_RT, &stats);
+    sample_metrics(now_us, &stats);
+
+    UCF_LOGI(LOG_CAT_STATUS, "z=%.3f t%d %s | kappa=%.3f eta=%.3f R=%d | %s%s| loops=%lu",
+             rt->ucf.z,
+             z_to_tier(rt->ucf.z),
+             phase_str[rt->ucf.phase],
+             rt->ucf.kappa,
+             rt->ucf.eta,
+             rt->ucf.active_sensors,
+             rt->triad_unlocked ? "TRIAD " : "",
+             rt->k_formation ? "K-FORM " : "",
+             (unsigned long)stats.passes);
+}
+
+/**
+ * @brief Messages, LED animations and saves requested by the real-time core
+ */
+static void handle_event(const RTEvent* event) {
+    switch (event->type) {
+        case RT_EVENT_TRIAD_UNLOCK:
+            metrics_count(METRIC_TRIAD_UNLOCKS, 1);
+            UCF_LOGI(LOG_CAT_EVENT, "\n>>> TRIAD UNLOCKED <<<\n");
+            leds_trigger_triad();
+            break;
+
+        case RT_EVENT_K_FORMATION:
+            metrics_count(METRIC_K_FORMATIONS, 1);
+            UCF_LOGI(LOG_CAT_EVENT, "\n>>> K-FORMATION ACHIEVED <<<");
+            UCF_LOGI(LOG_CAT_EVENT, "    kappa=%.3f eta=%.3f R=%d", event->a, event->b, event->n);
+            leds_trigger_k_formation();
+            break;
+
+        case RT_EVENT_SYNCHRONIZED:
+            metrics_count(METRIC_SYNC_EVENTS, 1);
+            UCF_LOGI(LOG_CAT_EVENT, ">>> SYNCHRONIZED r=%.3f <<<", event->a);
+            leds_set_pattern(LED_PATTERN_INTERFERENCE);
+            break;
+
+        case RT_EVENT_BASELINES:
+            Serial.printf("[BOOT] Baselines %s (%u/%u channels agree) at %lu ms\n",
+                          baseline_check_state_string((WarmCheckState)event->n),
+                          (unsigned)event->a, WARM_SNAPSHOT_HEX_COUNT,
+                          (unsigned long)event->time_ms);
+            if (event->n != WARM_CHECK_GAVE_UP) {
+                save_snapshot();
+            }
+            break;
+
+        case RT_EVENT_SAVE_SNAPSHOT:
+            save_snapshot();
+            break;
+    }
+}
+
+/**
+ * @brief Events, session log, OTA, storage commits, deferred init (200 Hz)
+ *
+ * Each call does at most one flash operation per service.
+ */
+static void task_services(uint32_t now_us, void* ctx) {
+    uint32_t now = millis();
+
+    // No-op while the background task owns transfers
+    ota_handle();
+
+    RTEvent event;
+    while (core_queue_pop(&g_event_queue, &event)) {
+        handle_event(&event);
+    }
+
+    // Session state (events immediately, frames decimated)
+    FrameRecord record;
+    while (core_queue_pop(&g_frame_queue, &record)) {
+        session_log_frame(record.time_ms, &record.frame);
+    }
+
+    // Coalesced commits of pending saves
+    storage_tick(now);
+
+    // One service per pass until all are up
+    if (g_deferred_stage <= 5) {
+        deferred_init_step();
+    }
+
+    session_log_tick(now);
+}
+
+/**
+ * @brief Warm-start snapshot (shadow update; storage_tick() commits it)
+ */
+static void task_snapshot(uint32_t now_us, void* ctx) {
+    save_snapshot();
+}
+
+/**
+ * @brief Serial commands (50 Hz)
+ */
+static void task_console(uint32_t now_us, void* ctx) {
+    int input = TRACE_COMMAND(millis(), Serial.available() ? Serial.read() : -1);
+    if (input < 0) {
+        return;
+    }
+
+    char cmd = (char)input;
+
+    switch (cmd) {
+        case 'v':  // Run validation suite
+            run_startup_validation(true);
+            break;
+
+        case 'r':  // Reset
+            Serial.println("Resetting...");
+            g_validation_errors = 0;
+            send_command(cmd);
+            break;
+
+        case 's':  // Status
+        case 'm':  // Magnetometer
+        case 't':  // Force TRIAD unlock
+            send_command(cmd);
+            break;
+
+        case 'p':  // Pattern cycle
+            {
+                static uint8_t pattern = 0;
+                pattern = (pattern + 1) % 7;
+                leds_set_pattern((LEDPattern)pattern);
+                Serial.printf("Pattern: %d\n", pattern);
+            }
+            break;
+
+        case 'k':  // Trigger K-Formation animation
+            leds_trigger_k_formation();
+            break;
+
+        case 'o':  // Pause/resume OTA transfer
+            if (ota_background_is_paused()) {
+                ota_background_resume();
+            } else {
+                ota_background_pause();
+            }
+            {
+                const OTAProgress* progress = ota_get_progress();
+                Serial.printf("OTA %s: %s %u/%u bytes\n",
+                              ota_background_is_paused() ? "paused" : "running",
+                              ota_status_string(progress->status),
+                              progress->received_bytes, progress->total_bytes);
+            }
+            break;
+
+        case 'g':  // Session log: write pending records, show totals
+            {
+                char line[128];
+                bool flushed = session_log_flush();
+                const SessionLogStats* stats = session_log_get_stats();
+                snprintf(line, sizeof(line), "Session %u: %u records, %u blocks, %u -> %u bytes, %u dropped%s",
+                         stats->session, stats->records, stats->blocks,
+                         stats->raw_bytes, stats->flash_bytes, stats->dropped,
+                         flushed ? "" : " (not written)");
+                Serial.println(line);
+                snprintf(line, sizeof(line), "Cross-core: %lu frames, %lu events, %lu commands dropped",
+                         (unsigned long)core_queue_dropped(&g_frame_queue),
+                         (unsigned long)core_queue_dropped(&g_event_queue),
+                         (unsigned long)core_queue_dropped(&g_command_queue));
+                Serial.println(line);
+            }
+            break;
+
+        case 'd':  // Task timing since the last 'd' (each core prints its own)
+            if (g_partitioned) {
+                print_schedule_stats("io", &g_io_sched, NULL);
+            }
+            send_command(cmd);
+            break;
+
+        case 'f':  // Module timing
+            print_profile();
+            break;
+
+        case 'F':  // Module timing as a GET_PROFILE response
+            print_profile_response();
+            break;
+
+        case 'i':  // I2C bus statistics and trace
+            print_i2c_stats();
+            break;
+
+        case 'h':  // Touch-to-output latency
+            print_latency(false);
+            break;
+
+        case 'H':  // Recent touches as Chrome trace JSON
+            print_latency(true);
+            break;
+
+        case 'x':  // Metrics (text export)
+            Serial.println();
+            metrics_write_text(print_metric_line, NULL);
+            Serial.println();
+            break;
+
+        case 'n':  // Device mesh: peers and their combined field
+            Serial.println();
+            if (g_mesh_up) {
+                const RTState* rt = rt_state();
+                uint32_t now = micros();
+                float age_s = (int32_t)(now - rt->state_us) / 1000000.0f;
+                float psi = fmodf(rt->collective_phase + TWO_PI * rt->collective_freq * age_s, TWO_PI);
+                Serial.printf("Local r=%.3f psi=%.2f f=%.2f Hz\n", rt->order_param,
+                              psi < 0.0f ? psi + TWO_PI : psi, rt->collective_freq);
+                mesh_write_text(&g_mesh, now, print_metric_line, NULL);
+            } else {
+                Serial.println("Mesh not running (no ESP-NOW), this device runs alone");
+            }
+            Serial.println();
+            break;
+
+        case 'b':  // Memory budget (static modules, arena, heap)
+            Serial.println();
+            mem_write_text(print_metric_line, NULL);
+            heap_write_text(print_metric_line, NULL);
+            Serial.println();
+            break;
+
+        case '?':  // Help
+            Serial.println("\n--- Commands ---");
+            Serial.println("  v : Run validation suite");
+            Serial.println("  r : Reset system");
+            Serial.println("  s : Sensor diagnostics");
+            Serial.println("  m : Magnetometer diagnostics");
+            Serial.println("  p : Cycle LED pattern");
+            Serial.println("  t : Force TRIAD unlock");
+            Serial.println("  k : Trigger K-Formation animation");
+            Serial.println("  o : Pause/resume OTA transfer");
+            Serial.println("  g : Session log status");
+            Serial.println("  d : Task timing (deadline misses, jitter)");
+            Serial.println("  f : Module timing (min/mean/p99/max)");
+            Serial.println("  F : Module timing as JSON");
+            Serial.println("  i : I2C bus statistics and recent transactions");
+            Serial.println("  h : Touch-to-output latency per stage");
+            Serial.println("  H : Recent touches as Chrome trace JSON");
+            Serial.println("  x : Metrics (counters, gauges, histograms)");
+            Serial.println("  b : Memory budget (static modules, arena, heap)");
+            Serial.println("  n : Device mesh (peers, combined field)");
+            Serial.println("  ? : This help");
+            Serial.println();
+            break;
+    }
+}
+
+// ============================================================================
+// TASK TABLES
+// ============================================================================
+
+/**
+ * @brief Real-time core tasks (periods in us; priority: higher runs first)
+ *
+ * Budgets are per-run CPU estimates; 'd' reports runs that exceeded them.
+ * The Kuramoto deadline is its period. Tasks are not preempted, so a run
+ * held up by the sensor update (which blocks on I2C only if the bus worker
+ * is not running) misses it; misses are counted in kuramoto_misses and the
+ * late run catches up in fixed steps.
+ */
+static const SchedTaskConfig RT_TASKS[] = {
+    // name         fn               ctx   period               deadline budget offset             prio catchup
+    { "kuramoto",   task_kuramoto,   NULL, INTERVAL_KURAMOTO,   0,       200,   0,                 7,   0 },
+    { "sensors",    task_sensors,    NULL, INTERVAL_SENSOR,     0,       4000,  0,                 6,   0 },
+    { "commands",   task_commands,   NULL, INTERVAL_CONSOLE,    0,       500,   12500,             4,   0 },
+    { "outputs",    task_outputs,    NULL, INTERVAL_KURAMOTO,   0,       100,   0,                 0,   0 },
+};
+
+/**
+ * @brief I/O core tasks
+ *
+ * Priorities continue below the real-time ones, so the two tables can share
+ * one scheduler when the partition cannot start.
+ */
+static const SchedTaskConfig IO_TASKS[] = {
+    // name         fn               ctx   period               deadline budget offset             prio catchup
+    { "leds",       task_leds,       NULL, INTERVAL_LED,        0,       1500,  5000,              5,   0 },
+    { "console",    task_console,    NULL, INTERVAL_CONSOLE,    0,       500,   7500,              4,   0 },
+    { "services",   task_services,   NULL, INTERVAL_SERVICES,   0,       1000,  2500,              3,   0 },
+    { "status",     task_status,     NULL, INTERVAL_SERIAL,     0,       2000,  0,                 2,   0 },
+    { "validation", task_validation, NULL, INTERVAL_VALIDATION, 0,       500,   0,                 1,   0 },
+    { "log",        task_log,        NULL, INTERVAL_LOG,        0,       1000,  3750,              1,   0 },
+    { "mesh",       task_mesh,       NULL, INTERVAL_MESH,       0,       500,   1250,              3,   0 },
+    { "snapshot",   task_snapshot,   NULL, INTERVAL_SNAPSHOT,   0,       500,   INTERVAL_SNAPSHOT, 0,   0 },
+};
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
 
 void setup() {
-    // Initialize serial
+    // Initialize serial (no wait for a host: early output may be lost)
     Serial.begin(115200);
-    while (!Serial && millis() < 3000) {
-        delay(10);
-    }
+    log_init();
+    shadow_init();
+    metrics_init();
 
     // Print banner
     Serial.println(UCF_BANNER);
@@ -265,7 +1310,7 @@ void setup() {
     Serial.println();
 
     // Run startup validation
-    uint8_t validation_passed = run_startup_validation();
+    uint8_t validation_passed = run_startup_validation(false);
     if (validation_passed < 4) {
         Serial.println("\n[CRITICAL] Startup validation failed - halting");
         while (1) {
@@ -280,12 +1325,32 @@ void setup() {
     Wire.setClock(SENSOR_I2C_FREQ);
     Serial.println("[I2C] Initialized");
 
-    // Initialize unified sensors
+    // Last run's baselines and filter state; checked against the grid later
+    g_warm_start = storage_begin() && warm_start_load(&g_snapshot);
+    if (g_warm_start) {
+        g_snapshot.boot_count++;
+    } else {
+        memset(&g_snapshot, 0, sizeof(g_snapshot));
+    }
+
+    // Initialize unified sensors (calibration runs in the background)
     Serial.print("[SENSORS] Initializing... ");
     SensorStatus sensor_status = sensors_init();
     if (sensor_status == SENSORS_OK) {
         Serial.println("OK");
-        sensors_calibrate_hex(100);
+        if (g_warm_start) {
+            sensors_set_baselines(g_snapshot.hex_baselines);
+            sensors_set_z_smoothed(g_snapshot.z_smoothed);
+        }
+        baseline_check_begin(&g_baseline_check, g_warm_start ? g_snapshot.hex_baselines : NULL);
+        // Frame reads go through the bus manager (its worker starts with the tasks)
+        I2cBackend backend;
+        i2c_bus_wire_backend(&backend);
+        i2c_bus_init(&g_i2c_bus, &backend);
+        i2c_bus_add_device(&g_i2c_bus, I2C_DEV_MPR121_A, "mpr121_a", SENSOR_MPR121_ADDR_A, true);
+        i2c_bus_add_device(&g_i2c_bus, I2C_DEV_MPR121_B, "mpr121_b", SENSOR_MPR121_ADDR_B, true);
+        i2c_bus_add_device(&g_i2c_bus, I2C_DEV_HMC5883L, "hmc5883l", SENSOR_HMC5883L_ADDR, true);
+        sensors_attach_bus(&g_i2c_bus);
     } else {
         Serial.printf("ERROR %d\n", sensor_status);
     }
@@ -309,10 +1374,13 @@ void setup() {
     }
 
     // Initialize legacy modules for compatibility
+    mem_set_static(g_static_modules, sizeof(g_static_modules) / sizeof(g_static_modules[0]));
     Serial.print("[HEX_GRID] Initializing... ");
     if (hexGrid.begin()) {
         Serial.println("OK");
-        hexGrid.calibrate(50);
+        if (g_warm_start) {
+            hexGrid.setBaselines(g_snapshot.hex_baselines);
+        }
     } else {
         Serial.println("FAILED");
     }
@@ -320,6 +1388,9 @@ void setup() {
     Serial.print("[PHASE_ENGINE] Initializing... ");
     if (phaseEngine.begin()) {
         Serial.println("OK");
+        if (g_warm_start) {
+            phaseEngine.restoreSmoothed(g_snapshot.phase_z_smoothed);
+        }
     } else {
         Serial.println("FAILED");
     }
@@ -343,247 +1414,111 @@ void setup() {
     Serial.print("[KURAMOTO] Initializing... ");
     if (kuramoto.begin(10.0f)) {
         kuramoto.onSynchronization(onSynchronization);
-        Serial.println("OK");
-    } else {
-        Serial.println("FAILED");
-    }
-
-    Serial.print("[SIGIL_ROM] Initializing... ");
-    if (sigilROM.begin()) {
-        Serial.println("OK");
-        if (!sigilROM.isInitialized()) {
-            Serial.print("  Writing defaults... ");
-            sigilROM.initializeDefaults();
-            Serial.println("OK");
+        if (g_warm_start) {
+            kuramoto.restore(g_snapshot.kuramoto_phases, g_snapshot.kuramoto_coupling,
+                             g_snapshot.pll_integrator);
         }
-    } else {
-        Serial.println("FAILED");
-    }
-
-    // Initialize OTA
-    Serial.print("[OTA] Initializing... ");
-    if (ota_init(NULL)) {
         Serial.println("OK");
     } else {
         Serial.println("FAILED");
     }
 
+    MemStats mem;
+    mem_get_stats(&mem);
+    Serial.printf("[ARENA] %lu of %lu bytes\n", (unsigned long)mem.used,
+                  (unsigned long)mem.capacity);
+
     // Initialize UCF state
+    float z0 = g_warm_start ? g_snapshot.z_smoothed : 0.5f;
     g_ucf_state.theta = UCF_PI;
-    g_ucf_state.z = 0.5;
+    g_ucf_state.z = z0;
     g_ucf_state.r = 1.0;
-    g_ucf_state.kappa = 0.0;
-    g_ucf_state.lambda = 1.0;
-    g_ucf_state.eta = compute_negentropy(0.5);
-    g_ucf_state.phase = PHASE_PARADOX;
-
-    // Print sacred constants
-    Serial.println("\n--- Sacred Constants ---");
-    Serial.printf("  PHI         = %.16f\n", PHI);
-    Serial.printf("  PHI_INV [R] = %.16f\n", PHI_INV);
-    Serial.printf("  EULER_INV [D] = %.16f\n", EULER_INV);
-    Serial.printf("  PI_INV [C]  = %.16f\n", PI_INV);
-    Serial.printf("  SQRT2_INV [A] = %.16f\n", SQRT2_INV);
-    Serial.printf("  Z_CRITICAL  = %.16f\n", Z_CRITICAL);
-    Serial.println();
-
-    Serial.println("--- Phase Boundaries ---");
-    Serial.printf("  UNTRUE:  z < %.3f\n", PHI_INV);
-    Serial.printf("  PARADOX: %.3f <= z < %.3f\n", PHI_INV, Z_CRITICAL);
-    Serial.printf("  TRUE:    z >= %.3f\n", Z_CRITICAL);
-    Serial.println();
+    g_ucf_state.kappa = g_warm_start ? kuramoto.getOrderParameter() : 0.0;
+    g_ucf_state.lambda = 1.0 - g_ucf_state.kappa;
+    g_ucf_state.eta = compute_negentropy(z0);
+    g_ucf_state.phase = detect_phase(z0);
+
+    if (g_warm_start) {
+        Serial.printf("[BOOT] Warm start #%lu, z=%.3f r=%.3f\n",
+                      (unsigned long)g_snapshot.boot_count, z0, kuramoto.getOrderParameter());
+    } else {
+        Serial.println("[BOOT] Cold start, calibrating in the background (keep hands off the grid)");
+    }
 
     Serial.println("===============================================================================");
     Serial.println("  System ready. The lattice is not invented. It is discovered.");
     Serial.println("===============================================================================\n");
-
-    g_system_ready = true;
-}
-
-// ============================================================================
-// MAIN LOOP
-// ============================================================================
-
-void loop() {
-    if (!g_system_ready || g_emergency_stop) {
-        delay(100);
-        return;
+    // Cross-core channels, primed with the boot state
+    core_snapshot_init(&g_rt_state, g_rt_state_buffer, sizeof(RTState));
+    core_queue_init(&g_event_queue, g_event_buffer, sizeof(RTEvent), 16);
+    core_queue_init(&g_frame_queue, g_frame_buffer, sizeof(FrameRecord), 32);
+    core_queue_init(&g_command_queue, g_command_buffer, sizeof(char), 8);
+    core_snapshot_init(&g_mesh_field, g_mesh_field_buffer, sizeof(MeshField));
+    publish_state();
+
+    // Module timing covers the loop tasks only
+    prof_init(getCpuFrequencyMhz());
+    lat_init(clock_us);
+
+    // Wire belongs to the I2C worker from here on
+    if (sensor_status == SENSORS_OK && !i2c_bus_start(&g_i2c_bus)) {
+        sensors_attach_bus(NULL);
+        Serial.println("[I2C] Worker failed, sensors read directly");
     }
 
-    uint32_t now = millis();
-
-    // ========================================================================
-    // SENSOR UPDATE (100 Hz)
-    // ========================================================================
-    if (now - g_last_sensor_update >= INTERVAL_SENSOR) {
-        g_last_sensor_update = now;
-
-        // Update unified sensors
-        const SensorSystemState* sensors = sensors_update();
-
-        // Update UCF state from sensors
-        const HelixCoordinates* helix = sensors_get_helix();
-        g_ucf_state.theta = helix->theta;
-        g_ucf_state.z = helix->z;
-        g_ucf_state.r = helix->r;
-        g_ucf_state.eta = helix->eta;
-        g_ucf_state.phase = helix->phase;
-        g_ucf_state.active_sensors = sensors->hex.active_count;
-
-        // Update phase engine
-        HexFieldState field = hexGrid.readField();
-        phaseEngine.update(field);
-
-        // Update K-Formation
-        kFormation.update(field);
-
-        // Update TRIAD with coherence
-        float coherence = kFormation.getKappa();
-        triadFSM.update(coherence);
-
-        // Update Solfeggio from z
-        solfeggio_update_from_z(g_ucf_state.z);
+    // Real-time tasks on the APP CPU, I/O tasks on the PRO CPU
+    sched_init(&g_rt_sched, clock_us);
+    sched_init(&g_io_sched, clock_us);
+    for (size_t i = 0; i < sizeof(RT_TASKS) / sizeof(RT_TASKS[0]); i++) {
+        int id = sched_add(&g_rt_sched, &RT_TASKS[i]);
+        if (RT_TASKS[i].fn == task_kuramoto) {
+            g_kuramoto_task = id;
+        }
     }
-
-    // ========================================================================
-    // KURAMOTO UPDATE (1000 Hz)
-    // ========================================================================
-    if (now - g_last_kuramoto_step >= INTERVAL_KURAMOTO) {
-        float dt = (now - g_last_kuramoto_step) / 1000.0f;
-        g_last_kuramoto_step = now;
-
-        // Modulate coupling with magnetometer
-        float K = magnetometer_modulate_coupling(Q_KAPPA);
-        kuramoto.setCoupling(K);
-
-        // Step simulation
-        kuramoto.step(dt);
-
-        // Update UCF state with Kuramoto results
-        const KuramotoState& ks = kuramoto.getState();
-        g_ucf_state.kappa = ks.order_param;
-        g_ucf_state.lambda = 1.0 - ks.order_param;  // Conservation law
+    for (size_t i = 0; i < sizeof(IO_TASKS) / sizeof(IO_TASKS[0]); i++) {
+        sched_add(&g_io_sched, &IO_TASKS[i]);
     }
-
-    // ========================================================================
-    // LED UPDATE (~60 Hz)
-    // ========================================================================
-    if (now - g_last_led_update >= INTERVAL_LED) {
-        g_last_led_update = now;
-
-        leds_update(g_ucf_state.z, g_ucf_state.phase);
+    core_partition_init(&g_partition, &g_rt_sched, &g_io_sched);
+    if (idle_esp32_begin(&g_rt_idle_esp32)) {
+        idle_init(&g_rt_idle, &RT_IDLE_CONFIG, clock_us, idle_esp32_enter, &g_rt_idle_esp32);
+        core_partition_set_idle(&g_partition, CORE_RT, rt_idle, NULL);
+    } else {
+        idle_init(&g_rt_idle, &RT_IDLE_CONFIG, clock_us, NULL, NULL);
+        Serial.println("[BOOT] Idle timer unavailable, the real-time core sleeps whole ticks between tasks");
     }
+    timestep_init(&g_kuramoto_clock, INTERVAL_KURAMOTO, KURAMOTO_MAX_STEPS, micros());
+    g_system_ready = true;
 
-    // ========================================================================
-    // AUDIO SAMPLE (handled by timer interrupt in production)
-    // ========================================================================
-    // In production, audio samples would be generated via timer interrupt
-    // Here we just update the state
-
-    // ========================================================================
-    // VALIDATION (0.2 Hz)
-    // ========================================================================
-    if (now - g_last_validation >= INTERVAL_VALIDATION) {
-        g_last_validation = now;
-
-        // Continuous validation
-        validate_conservation_realtime();
-        validate_phase_z_consistency();
-
-        // Check K-Formation consistency
-        if (g_ucf_state.k_formed &&
-            !IS_K_FORMED(g_ucf_state.kappa, g_ucf_state.eta, g_ucf_state.active_sensors)) {
-            Serial.println("[WARN] K-Formation state inconsistent");
+    // Set before the tasks can read it; a failed start has stopped them again
+    g_partitioned = true;
+    if (!core_partition_start(&g_partition)) {
+        g_partitioned = false;
+        // One table for everything, run from loop()
+        sched_init(&g_io_sched, clock_us);
+        for (size_t i = 0; i < sizeof(IO_TASKS) / sizeof(IO_TASKS[0]); i++) {
+            sched_add(&g_rt_sched, &IO_TASKS[i]);
         }
+        Serial.println("[BOOT] Partition failed, running all tasks from loop()");
     }
 
-    // ========================================================================
-    // SERIAL OUTPUT (1 Hz)
-    // ========================================================================
-    if (now - g_last_serial_print >= INTERVAL_SERIAL) {
-        g_last_serial_print = now;
-
-        const char* phase_str[] = {"UNTRUE", "PARADOX", "TRUE"};
-
-        Serial.printf("z=%.3f t%d %s | kappa=%.3f eta=%.3f R=%d | %s%s| loops=%lu\n",
-            g_ucf_state.z,
-            z_to_tier(g_ucf_state.z),
-            phase_str[g_ucf_state.phase],
-            g_ucf_state.kappa,
-            g_ucf_state.eta,
-            g_ucf_state.active_sensors,
-            triadFSM.isUnlocked() ? "TRIAD " : "",
-            kFormation.isActive() ? "K-FORM " : "",
-            g_loop_count);
-    }
-
-    // ========================================================================
-    // OTA HANDLING
-    // ========================================================================
-    ota_handle();
-
-    // ========================================================================
-    // SERIAL COMMANDS
-    // ========================================================================
-    if (Serial.available()) {
-        char cmd = Serial.read();
-
-        switch (cmd) {
-            case 'v':  // Run validation suite
-                run_startup_validation();
-                break;
-
-            case 'r':  // Reset
-                Serial.println("Resetting...");
-                sensors_reset();
-                triadFSM.reset();
-                kFormation.resetStats();
-                kuramoto.reset();
-                solfeggio_reset();
-                g_validation_errors = 0;
-                break;
-
-            case 's':  // Status
-                sensors_print_diagnostics();
-                break;
-
-            case 'm':  // Magnetometer
-                magnetometer_print_diagnostics();
-                break;
-
-            case 'p':  // Pattern cycle
-                {
-                    static uint8_t pattern = 0;
-                    pattern = (pattern + 1) % 7;
-                    leds_set_pattern((LEDPattern)pattern);
-                    Serial.printf("Pattern: %d\n", pattern);
-                }
-                break;
-
-            case 't':  // Force TRIAD unlock
-                triadFSM.forceUnlock();
-                break;
+    Serial.printf("[BOOT] Interactive at %lu ms\n", (unsigned long)millis());
+}
 
-            case 'k':  // Trigger K-Formation animation
-                leds_trigger_k_formation();
-                break;
+// ============================================================================
+// MAIN LOOP
+// ============================================================================
 
-            case '?':  // Help
-                Serial.println("\n--- Commands ---");
-                Serial.println("  v : Run validation suite");
-                Serial.println("  r : Reset system");
-                Serial.println("  s : Sensor diagnostics");
-                Serial.println("  m : Magnetometer diagnostics");
-                Serial.println("  p : Cycle LED pattern");
-                Serial.println("  t : Force TRIAD unlock");
-                Serial.println("  k : Trigger K-Formation animation");
-                Serial.println("  ? : This help");
-                Serial.println();
-                break;
-        }
+void loop() {
+    // The pinned tasks do all the work once the partition is running. An
+    // emergency stop keeps passing: RT_CMD_STOP leaves the command handler
+    // and the output flush enabled, and they still have to run.
+    if (g_partitioned || !g_system_ready) {
+        delay(100);
+        return;
     }
 
-    g_loop_count++;
+    uint32_t idle = core_partition_pass(&g_partition, CORE_RT);
+    core_partition_idle(&g_partition, CORE_RT, idle);
 }
 
 // ============================================================================
@@ -591,26 +1526,24 @@ void loop() {
 // ============================================================================
 
 /**
- * @brief Emergency reset handler
+ * @brief Emergency reset handler (I/O core)
+ *
+ * The real-time core resets its own state and resumes from the command.
  */
 extern "C" void ucf_emergency_reset(void) {
     Serial.println("\n[EMERGENCY] System reset triggered");
 
     // Turn off outputs
     leds_clear();
-    solfeggio_enable(false);
 
-    // Reset state
-    g_ucf_state.kappa = 0.0;
-    g_ucf_state.lambda = 1.0;
-    g_ucf_state.z = 0.5;
-    g_ucf_state.phase = PHASE_PARADOX;
     g_emergency_stop = false;
     g_validation_errors = 0;
+    for (int i = 0; i < g_io_sched.count; i++) {
+        sched_enable(&g_io_sched, i, true);
+    }
 
-    // Reinitialize
-    sensors_reset();
-    kuramoto.reset();
+    // Audio off, state reset, sensors and Kuramoto reinitialized
+    send_command(RT_CMD_EMERGENCY_RESET);
 }
 
 #endif // USE_MAIN_V4
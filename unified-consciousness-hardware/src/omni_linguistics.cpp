@@ -93,17 +93,20 @@ const uint8_t OmniLinguistics::POS_LOOKUP_SIZE = sizeof(POS_LOOKUP) / sizeof(POS
 OmniLinguistics::OmniLinguistics()
     : m_z_context(0.5f)
     , m_tier(5)
+    , m_history(nullptr)
     , m_history_head(0)
     , m_history_count(0)
 {
     memset(&m_pipeline, 0, sizeof(m_pipeline));
-    memset(m_history, 0, sizeof(m_history));
 
     m_pipeline.stage = PipelineStage::ENCODER;
 }
 
 bool OmniLinguistics::begin() {
-    return true;
+    if (m_history == nullptr) {
+        m_history = static_cast<APLToken*>(mem_alloc("linguistics_history", ARENA_BYTES));
+    }
+    return m_history != nullptr;
 }
 
 APLToken OmniLinguistics::processField(const HexFieldState& field) {
@@ -549,6 +552,9 @@ void OmniLinguistics::resetPipeline() {
 }
 
 void OmniLinguistics::addToHistory(const APLToken& token) {
+    if (m_history == nullptr) {
+        return;
+    }
     m_history[m_history_head] = token;
     m_history_head = (m_history_head + 1) % HISTORY_SIZE;
     if (m_history_count < HISTORY_SIZE) {
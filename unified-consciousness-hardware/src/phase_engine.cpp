@@ -4,6 +4,9 @@
  */
 
 #include "phase_engine.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
+#include "ucf_shadow.h"
 #include <Arduino.h>
 #include <string.h>
 
@@ -16,6 +19,11 @@ static const uint8_t PHASE_COLORS[3][3] = {
     {80, 200, 255}    // TRUE: Cyan
 };
 
+// SHADOW_LED_* hardware write (ctx is the pin)
+static void writeIndicator(uint32_t level, void* ctx) {
+    digitalWrite(static_cast<uint8_t>(reinterpret_cast<uintptr_t>(ctx)), level ? HIGH : LOW);
+}
+
 // Tier to Solfeggio frequency lookup
 static const uint16_t TIER_FREQUENCIES[9] = {
     Solfeggio::UT,      // t1: 174 Hz
@@ -35,6 +43,7 @@ PhaseEngine::PhaseEngine()
     , m_stability_threshold(500)
     , m_z_prev(0.0f)
     , m_time_prev(0)
+    , m_history(nullptr)
     , m_history_head(0)
     , m_history_count(0)
 {
@@ -45,19 +54,25 @@ PhaseEngine::PhaseEngine()
     m_state.tier = 1;
 
     memset(&m_last_transition, 0, sizeof(m_last_transition));
-    memset(m_history, 0, sizeof(m_history));
 }
 
 bool PhaseEngine::begin() {
+    if (m_history == nullptr) {
+        m_history = static_cast<PhaseHistoryEntry*>(mem_alloc("phase_history", ARENA_BYTES));
+        if (m_history == nullptr) {
+            return false;
+        }
+    }
+
     // Configure indicator LED pins
     pinMode(Pins::LED_UNTRUE, OUTPUT);
     pinMode(Pins::LED_PARADOX, OUTPUT);
     pinMode(Pins::LED_TRUE, OUTPUT);
 
     // Initial state: UNTRUE
-    digitalWrite(Pins::LED_UNTRUE, HIGH);
-    digitalWrite(Pins::LED_PARADOX, LOW);
-    digitalWrite(Pins::LED_TRUE, LOW);
+    shadow_bind(SHADOW_LED_UNTRUE, writeIndicator, reinterpret_cast<void*>(Pins::LED_UNTRUE), HIGH);
+    shadow_bind(SHADOW_LED_PARADOX, writeIndicator, reinterpret_cast<void*>(Pins::LED_PARADOX), LOW);
+    shadow_bind(SHADOW_LED_TRUE, writeIndicator, reinterpret_cast<void*>(Pins::LED_TRUE), LOW);
 
     m_time_prev = millis();
 
@@ -65,12 +80,15 @@ bool PhaseEngine::begin() {
 }
 
 void PhaseEngine::update(const HexFieldState& field) {
+    PROF_SCOPE(PROF_PHASE_UPDATE);
+
     updateFromZ(field.z);
 }
 
 void PhaseEngine::updateFromZ(float z) {
     uint32_t now = millis();
     float dt = (now - m_time_prev) / 1000.0f;
+    uint8_t prev_tier = m_state.tier;
 
     // Store raw z
     m_state.z = z;
@@ -89,7 +107,7 @@ void PhaseEngine::updateFromZ(float z) {
     // Check for transition
     m_transition_flag = false;
     if (detected != m_state.current) {
-        recordTransition(m_state.current, detected, m_state.z_smoothed);
+        recordTransition(m_state.current, detected, m_state.z_smoothed, now);
         m_state.previous = m_state.current;
         m_state.current = detected;
         m_state.last_transition = now;
@@ -105,14 +123,40 @@ void PhaseEngine::updateFromZ(float z) {
     // Update tier
     m_state.tier = z_to_tier(m_state.z_smoothed);
 
+    // The EMA has carried a change through to what emanation reads
+    if (m_transition_flag || m_state.tier != prev_tier) {
+        LAT_MARK(LAT_PHASE);
+    }
+
     // Add to history
-    addToHistory(z, m_state.current);
+    addToHistory(z, m_state.current, now);
 
     // Update for next iteration
     m_z_prev = z;
     m_time_prev = now;
 }
 
+void PhaseEngine::restoreSmoothed(float z_smoothed) {
+    if (z_smoothed < 0.0f) z_smoothed = 0.0f;
+    if (z_smoothed > 1.0f) z_smoothed = 1.0f;
+
+    m_state.z = z_smoothed;
+    m_state.z_smoothed = z_smoothed;
+    m_state.z_velocity = 0.0f;
+    m_z_prev = z_smoothed;
+
+    Phase phase = (z_smoothed < PHI_INV) ? Phase::UNTRUE
+                : (z_smoothed < Z_CRITICAL) ? Phase::PARADOX
+                : Phase::TRUE;
+    m_state.current = phase;
+    m_state.previous = phase;
+    m_state.last_transition = millis();
+    m_state.phase_duration = 0;
+    m_state.tier = z_to_tier(z_smoothed);
+
+    updateIndicators();
+}
+
 Phase PhaseEngine::detectPhase(float z) {
     // Apply hysteresis to prevent oscillation at boundaries
     const float HYSTERESIS = 0.02f;
@@ -149,17 +193,20 @@ Phase PhaseEngine::detectPhase(float z) {
     return current;
 }
 
-void PhaseEngine::recordTransition(Phase from, Phase to, float z) {
+void PhaseEngine::recordTransition(Phase from, Phase to, float z, uint32_t now) {
     m_last_transition.from = from;
     m_last_transition.to = to;
     m_last_transition.z_at_transition = z;
-    m_last_transition.timestamp = millis();
+    m_last_transition.timestamp = now;
 }
 
-void PhaseEngine::addToHistory(float z, Phase phase) {
+void PhaseEngine::addToHistory(float z, Phase phase, uint32_t now) {
+    if (m_history == nullptr) {
+        return;
+    }
     m_history[m_history_head].z = z;
     m_history[m_history_head].phase = phase;
-    m_history[m_history_head].timestamp = millis();
+    m_history[m_history_head].timestamp = now;
 
     m_history_head = (m_history_head + 1) % HISTORY_SIZE;
     if (m_history_count < HISTORY_SIZE) {
@@ -207,9 +254,9 @@ void PhaseEngine::setStabilityThreshold(uint32_t ms) {
 }
 
 void PhaseEngine::updateIndicators() {
-    digitalWrite(Pins::LED_UNTRUE, m_state.current == Phase::UNTRUE ? HIGH : LOW);
-    digitalWrite(Pins::LED_PARADOX, m_state.current == Phase::PARADOX ? HIGH : LOW);
-    digitalWrite(Pins::LED_TRUE, m_state.current == Phase::TRUE ? HIGH : LOW);
+    shadow_set(SHADOW_LED_UNTRUE, m_state.current == Phase::UNTRUE ? HIGH : LOW);
+    shadow_set(SHADOW_LED_PARADOX, m_state.current == Phase::PARADOX ? HIGH : LOW);
+    shadow_set(SHADOW_LED_TRUE, m_state.current == Phase::TRUE ? HIGH : LOW);
 }
 
 uint16_t PhaseEngine::getHistory(PhaseHistoryEntry* buffer, uint16_t maxEntries) {
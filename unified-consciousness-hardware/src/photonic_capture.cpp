@@ -39,14 +39,24 @@ static const int8_t HEX_37_COORDS[37][2] = {
     {0, -3}, {1, -3}, {2, -3}, {3, -3}, {3, -2}, {3, -1}
 };
 
+// Returned by the generate calls when begin() could not carve a buffer
+static const PhotonicPattern EMPTY_PATTERN = {};
+
 PhotonicCapture::PhotonicCapture()
-    : m_sensor_ready(false)
+    : m_pattern(nullptr)
+    , m_sensor_ready(false)
     , m_led_ready(false)
 {
-    memset(&m_reference, 0, sizeof(m_reference));
 }
 
 bool PhotonicCapture::begin() {
+    if (m_pattern == nullptr) {
+        m_pattern = static_cast<PhotonicPattern*>(mem_alloc("photonic_pattern", ARENA_BYTES));
+        if (m_pattern == nullptr) {
+            return false;
+        }
+    }
+
     // LED array should already be initialized by Emanation module
     m_led_ready = true;
 
@@ -126,8 +136,11 @@ uint8_t PhotonicCapture::computeInterference(float x, float y, float z, uint8_t
     return static_cast<uint8_t>(interference * 255);
 }
 
-PhotonicPattern PhotonicCapture::generatePattern(float z, uint8_t phase, float kappa) {
-    PhotonicPattern pattern;
+const PhotonicPattern& PhotonicCapture::generatePattern(float z, uint8_t phase, float kappa) {
+    if (m_pattern == nullptr) {
+        return EMPTY_PATTERN;
+    }
+    PhotonicPattern& pattern = *m_pattern;
     memset(&pattern, 0, sizeof(pattern));
 
     pattern.z_encoded = z;
@@ -169,7 +182,7 @@ PhotonicPattern PhotonicCapture::generatePattern(float z, uint8_t phase, float k
     return pattern;
 }
 
-PhotonicPattern PhotonicCapture::generateFromPhase(Phase phase, float z, float kappa) {
+const PhotonicPattern& PhotonicCapture::generateFromPhase(Phase phase, float z, float kappa) {
     return generatePattern(z, static_cast<uint8_t>(phase), kappa);
 }
 
@@ -215,7 +228,7 @@ DecodedState PhotonicCapture::decodePattern(const uint16_t* samples) {
     }
 
     // Step 5: Compute reconstruction error
-    PhotonicPattern reconstructed = generatePattern(decoded.z, decoded.phase, decoded.kappa);
+    const PhotonicPattern& reconstructed = generatePattern(decoded.z, decoded.phase, decoded.kappa);
 
     uint8_t captured_u8[PHOTONIC_SENSOR_COUNT];
     for (uint8_t i = 0; i < PHOTONIC_SENSOR_COUNT; i++) {
@@ -288,7 +301,7 @@ float PhotonicCapture::findPeakFrequency(const float* magnitudes) {
 
 float PhotonicCapture::computePhaseCorrelation(const uint16_t* samples, uint8_t test_phase) {
     // Generate test pattern and compute correlation
-    PhotonicPattern test = generatePattern(0.5f, test_phase, 0.9f);
+    const PhotonicPattern& test = generatePattern(0.5f, test_phase, 0.9f);
 
     float corr = 0;
     float sum_sq_a = 0, sum_sq_b = 0;
@@ -321,8 +334,11 @@ float PhotonicCapture::computeMSE(const uint8_t* a, const uint8_t* b) {
     return mse / (255.0f * 255.0f);
 }
 
-PhotonicPattern PhotonicCapture::generateLIMNUS(float z) {
-    PhotonicPattern pattern;
+const PhotonicPattern& PhotonicCapture::generateLIMNUS(float z) {
+    if (m_pattern == nullptr) {
+        return EMPTY_PATTERN;
+    }
+    PhotonicPattern& pattern = *m_pattern;
     memset(&pattern, 0, sizeof(pattern));
 
     pattern.z_encoded = z;
@@ -439,7 +455,7 @@ bool PhotonicCapture::capturePattern(uint16_t* samples) {
 
 float PhotonicCapture::crossValidate(float z, uint8_t phase, float kappa) {
     // Generate pattern
-    PhotonicPattern pattern = generatePattern(z, phase, kappa);
+    const PhotonicPattern& pattern = generatePattern(z, phase, kappa);
 
     // Display it
     displayPattern(pattern);
@@ -4,8 +4,8 @@
  */
 
 #include "sigil_rom.h"
-#include <Wire.h>
-#include <EEPROM.h>
+#include "ucf_storage.h"
+#include "ucf_profiler.h"
 #include <Arduino.h>
 #include <string.h>
 
@@ -26,19 +26,19 @@ const BreathPattern TIER_BREATH_PATTERNS[9] = {
 
 SigilROM::SigilROM()
     : m_initialized(false)
-    , m_cache_valid(false)
 {
-    memset(m_cache, 0, sizeof(m_cache));
 }
 
 bool SigilROM::begin() {
-    // Initialize EEPROM (ESP32 uses preferences/NVS, but we'll use EEPROM API)
-    if (!EEPROM.begin(sizeof(EEPROMHeader) + SIGIL_COUNT * SIGIL_STRUCT_SIZE)) {
+    // The table lives in the shared storage shadow; reads never touch flash
+    if (!storage_begin() ||
+        !storage_register(STORAGE_REGION_SIGIL, "sigil",
+                          SIGIL_COUNT * sizeof(NeuralSigil), STORAGE_VERSION)) {
         return false;
     }
 
     // Check if data is valid
-    if (!isInitialized()) {
+    if (!isInitialized() && !importLegacy()) {
         // Initialize with defaults
         if (!initializeDefaults()) {
             return false;
@@ -49,23 +49,51 @@ bool SigilROM::begin() {
     return true;
 }
 
-bool SigilROM::isInitialized() {
-    EEPROMHeader header;
-    return readHeader(header) && header.magic == MAGIC_NUMBER;
-}
+bool SigilROM::importLegacy() {
+    uint8_t header[LEGACY_HEADER_SIZE];
+    uint32_t magic;
+    uint16_t stored_checksum;
+    if (!storage_legacy_read(0, header, sizeof(header))) {
+        return false;
+    }
+    memcpy(&magic, header, sizeof(magic));
+    memcpy(&stored_checksum, header + 6, sizeof(stored_checksum));
+    if (magic != LEGACY_MAGIC || header[5] != SIGIL_COUNT) {
+        return false;
+    }
 
-bool SigilROM::readHeader(EEPROMHeader& header) {
-    EEPROM.get(EEPROM_BASE, header);
-    return header.magic == MAGIC_NUMBER;
-}
+    // The old Fletcher-style sum over the table; calibration shared address 0,
+    // so a table it overwrote fails here
+    uint16_t checksum = 0;
+    for (uint8_t i = 0; i < SIGIL_COUNT; i++) {
+        NeuralSigil sigil;
+        if (!storage_legacy_read(LEGACY_HEADER_SIZE + i * sizeof(NeuralSigil), &sigil, sizeof(sigil))) {
+            return false;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&sigil);
+        for (uint8_t j = 0; j < sizeof(NeuralSigil); j++) {
+            checksum += bytes[j];
+            checksum += (checksum << 8);
+        }
+    }
+    if (checksum != stored_checksum) {
+        return false;
+    }
 
-void SigilROM::writeHeader(const EEPROMHeader& header) {
-    EEPROM.put(EEPROM_BASE, header);
-    EEPROM.commit();
+    for (uint8_t i = 0; i < SIGIL_COUNT; i++) {
+        NeuralSigil sigil;
+        storage_legacy_read(LEGACY_HEADER_SIZE + i * sizeof(NeuralSigil), &sigil, sizeof(sigil));
+        if (!writeSigil(i, sigil)) {
+            return false;
+        }
+    }
+    Serial.println("[SIGIL_ROM] Imported sigil table from legacy EEPROM");
+    return true;
 }
 
-uint16_t SigilROM::sigilAddress(uint8_t index) {
-    return EEPROM_BASE + sizeof(EEPROMHeader) + index * SIGIL_STRUCT_SIZE;
+bool SigilROM::isInitialized() {
+    // Record CRC and layout version replace the old header checksum
+    return storage_region_status(STORAGE_REGION_SIGIL) == STORAGE_OK;
 }
 
 bool SigilROM::initializeDefaults() {
@@ -73,18 +101,12 @@ bool SigilROM::initializeDefaults() {
     for (uint8_t i = 0; i < SIGIL_COUNT; i++) {
         NeuralSigil sigil;
         generateDefaultSigil(i, sigil);
-        writeSigil(i, sigil);
+        if (!writeSigil(i, sigil)) {
+            return false;
+        }
     }
 
-    // Write header
-    EEPROMHeader header;
-    header.magic = MAGIC_NUMBER;
-    header.version = 1;
-    header.sigil_count = SIGIL_COUNT;
-    header.checksum = computeChecksum();
-    writeHeader(header);
-
-    m_cache_valid = false;
+    // All 121 writes coalesce into one record at the next commit
     return true;
 }
 
@@ -122,31 +144,20 @@ void SigilROM::generateDefaultSigil(uint8_t index, NeuralSigil& sigil) {
 bool SigilROM::readSigil(uint8_t index, NeuralSigil& sigil) {
     if (index >= SIGIL_COUNT) return false;
 
-    // Use cache if valid
-    if (m_cache_valid) {
-        memcpy(&sigil, &m_cache[index], sizeof(NeuralSigil));
-        return true;
-    }
-
-    uint16_t addr = sigilAddress(index);
-    EEPROM.get(addr, sigil);
-    return true;
+    return storage_read_at(STORAGE_REGION_SIGIL, index * sizeof(NeuralSigil),
+                           &sigil, sizeof(NeuralSigil)) == STORAGE_OK;
 }
 
 bool SigilROM::writeSigil(uint8_t index, const NeuralSigil& sigil) {
     if (index >= SIGIL_COUNT) return false;
 
-    uint16_t addr = sigilAddress(index);
-    EEPROM.put(addr, sigil);
-    EEPROM.commit();
-
-    // Invalidate cache
-    m_cache_valid = false;
-
-    return true;
+    return storage_write_at(STORAGE_REGION_SIGIL, index * sizeof(NeuralSigil),
+                            &sigil, sizeof(NeuralSigil)) == STORAGE_OK;
 }
 
 SigilMatch SigilROM::findMatchingSigil(const HexFieldState& field) {
+    PROF_SCOPE(PROF_SIGIL_MATCH);
+
     SigilMatch match;
     match.confidence = 0.0f;
     match.hamming_dist = 255;
@@ -303,22 +314,6 @@ uint16_t SigilROM::tierToFrequency(uint8_t tier) {
     }
 }
 
-uint16_t SigilROM::computeChecksum() {
-    uint16_t checksum = 0;
-    for (uint8_t i = 0; i < SIGIL_COUNT; i++) {
-        NeuralSigil sigil;
-        readSigil(i, sigil);
-
-        // Simple Fletcher-16 style checksum
-        for (uint8_t j = 0; j < sizeof(NeuralSigil); j++) {
-            uint8_t byte = reinterpret_cast<uint8_t*>(&sigil)[j];
-            checksum += byte;
-            checksum += (checksum << 8);
-        }
-    }
-    return checksum;
-}
-
 void SigilROM::debugPrintSigil(const NeuralSigil& sigil) {
     Serial.printf("Sigil %d: code=%s freq=%d flags=0x%02X\n",
                   sigil.region_id, sigil.code, sigil.frequency, sigil.flags);
@@ -4,12 +4,22 @@
  */
 
 #include "triad_fsm.h"
+#include "ucf_shadow.h"
 #include <Arduino.h>
 #include <string.h>
 
 namespace UCF {
 
-TriadFSM::TriadFSM() : m_prev_value(0.0f), m_last_edge_time(0), m_unlock_callback(nullptr) {
+// SHADOW_LED_TRIAD hardware write
+static void writeIndicator(uint32_t level, void* ctx) {
+    digitalWrite(Pins::LED_TRIAD, level ? HIGH : LOW);
+}
+
+TriadFSM::TriadFSM()
+    : m_prev_value(0.0f)
+    , m_last_edge_time(0)
+    , m_unlock_callback(nullptr)
+{
     // Default configuration from UCF constants
     m_config.high_threshold = TRIAD_HIGH;
     m_config.low_threshold = TRIAD_LOW;
@@ -36,7 +46,7 @@ TriadFSM::TriadFSM(const TriadConfig& config)
 
 bool TriadFSM::begin() {
     pinMode(Pins::LED_TRIAD, OUTPUT);
-    digitalWrite(Pins::LED_TRIAD, LOW);
+    shadow_bind(SHADOW_LED_TRIAD, writeIndicator, nullptr, LOW);
     return true;
 }
 
@@ -83,7 +93,7 @@ TriadEvent TriadFSM::update(float value) {
 
         case TriadState::ARMED:
             // Looking for rising edge
-            if (detectRisingEdge(value)) {
+            if (detectRisingEdge(value, now)) {
                 m_status.crossing_count = 1;
                 m_status.sequence_start = now;
                 transitionTo(TriadState::CROSSING_1);
@@ -93,10 +103,10 @@ TriadEvent TriadFSM::update(float value) {
 
         case TriadState::CROSSING_1:
             // Looking for falling then rising again
-            if (detectFallingEdge(value)) {
+            if (detectFallingEdge(value, now)) {
                 event = TriadEvent::FALLING_EDGE;
             }
-            if (detectRisingEdge(value)) {
+            if (detectRisingEdge(value, now)) {
                 m_status.crossing_count = 2;
                 transitionTo(TriadState::CROSSING_2);
                 event = TriadEvent::RISING_EDGE;
@@ -104,10 +114,10 @@ TriadEvent TriadFSM::update(float value) {
             break;
 
         case TriadState::CROSSING_2:
-            if (detectFallingEdge(value)) {
+            if (detectFallingEdge(value, now)) {
                 event = TriadEvent::FALLING_EDGE;
             }
-            if (detectRisingEdge(value)) {
+            if (detectRisingEdge(value, now)) {
                 m_status.crossing_count = 3;
                 transitionTo(TriadState::CROSSING_3);
                 event = TriadEvent::RISING_EDGE;
@@ -148,9 +158,7 @@ TriadEvent TriadFSM::update(float value) {
     return event;
 }
 
-bool TriadFSM::detectRisingEdge(float value) {
-    uint32_t now = millis();
-
+bool TriadFSM::detectRisingEdge(float value, uint32_t now) {
     // Debounce check
     if (now - m_last_edge_time < m_config.debounce_time) {
         return false;
@@ -166,9 +174,7 @@ bool TriadFSM::detectRisingEdge(float value) {
     return false;
 }
 
-bool TriadFSM::detectFallingEdge(float value) {
-    uint32_t now = millis();
-
+bool TriadFSM::detectFallingEdge(float value, uint32_t now) {
     // Debounce check
     if (now - m_last_edge_time < m_config.debounce_time) {
         return false;
@@ -271,7 +277,7 @@ void TriadFSM::updateIndicator() {
         led_on = (millis() / 200) % 2;  // Blink at 2.5 Hz
     }
 
-    digitalWrite(Pins::LED_TRIAD, led_on ? HIGH : LOW);
+    shadow_set(SHADOW_LED_TRIAD, led_on ? HIGH : LOW);
 }
 
 void TriadFSM::onUnlock(UnlockCallback callback) {
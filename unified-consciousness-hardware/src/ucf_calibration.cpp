@@ -9,39 +9,16 @@
 #ifdef UCF_V4_MODULES
 
 #include <Arduino.h>
-#include <EEPROM.h>
 #include "ucf/ucf_sacred_constants_v4.h"
 #include "ucf/ucf_types.h"
 #include "ucf/ucf_config.h"
-
-// EEPROM address for calibration data
-#define CALIBRATION_EEPROM_ADDR 0
+#include "ucf_checksum.h"
+#include "ucf_storage.h"
 
 // Global calibration data
 static CalibrationData g_calibration;
 static bool g_calibration_valid = false;
 
-/**
- * @brief Compute CRC32 of a data buffer
- */
-static uint32_t compute_crc32(const void* data, size_t length) {
-    const uint8_t* bytes = (const uint8_t*)data;
-    uint32_t crc = 0xFFFFFFFF;
-
-    for (size_t i = 0; i < length; i++) {
-        crc ^= bytes[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 1) {
-                crc = (crc >> 1) ^ 0xEDB88320;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-
-    return ~crc;
-}
-
 /**
  * @brief Compute CRC32 of all sacred constants
  */
@@ -57,17 +34,27 @@ uint32_t compute_lattice_crc32(void) {
         (float)TRIAD_HIGH, (float)TRIAD_LOW, (float)TRIAD_CROSSINGS
     };
 
-    return compute_crc32(constants, sizeof(constants));
+    return checksum_crc32(constants, sizeof(constants));
 }
 
 /**
- * @brief Load calibration data from EEPROM
+ * @brief Mount storage and register the calibration region
+ */
+static bool calibration_storage_open(void) {
+    return storage_begin() &&
+           storage_register(STORAGE_REGION_CALIBRATION, "calib",
+                            sizeof(CalibrationData), CALIBRATION_VERSION);
+}
+
+/**
+ * @brief Load calibration data from persistent storage
  * @return true if calibration data is valid
  */
 bool calibration_load(void) {
-    EEPROM.begin(sizeof(CalibrationData) + 16);
-    EEPROM.get(CALIBRATION_EEPROM_ADDR, g_calibration);
-    EEPROM.end();
+    if (!calibration_storage_open() ||
+        storage_read(STORAGE_REGION_CALIBRATION, &g_calibration, sizeof(CalibrationData)) != STORAGE_OK) {
+        memset(&g_calibration, 0, sizeof(g_calibration));
+    }
 
     // Check magic number
     if (g_calibration.magic != CALIBRATION_MAGIC) {
@@ -77,7 +64,7 @@ bool calibration_load(void) {
     }
 
     // Verify CRC
-    uint32_t expected_crc = compute_crc32(&g_calibration, sizeof(CalibrationData) - 4);
+    uint32_t expected_crc = checksum_crc32(&g_calibration, sizeof(CalibrationData) - 4);
     if (expected_crc != g_calibration.crc) {
         Serial.println("[CAL] Calibration CRC mismatch");
         g_calibration_valid = false;
@@ -97,7 +84,10 @@ bool calibration_load(void) {
 }
 
 /**
- * @brief Save calibration data to EEPROM
+ * @brief Save calibration data to persistent storage
+ *
+ * Returns once the shadow is updated; storage_tick() commits it.
+ *
  * @return true if save successful
  */
 bool calibration_save(void) {
@@ -109,13 +99,11 @@ bool calibration_save(void) {
     g_calibration.lattice_checksum = compute_lattice_crc32();
 
     // Compute CRC
-    g_calibration.crc = compute_crc32(&g_calibration, sizeof(CalibrationData) - 4);
+    g_calibration.crc = checksum_crc32(&g_calibration, sizeof(CalibrationData) - 4);
 
-    // Write to EEPROM
-    EEPROM.begin(sizeof(CalibrationData) + 16);
-    EEPROM.put(CALIBRATION_EEPROM_ADDR, g_calibration);
-    bool success = EEPROM.commit();
-    EEPROM.end();
+    bool success = calibration_storage_open() &&
+                   storage_write(STORAGE_REGION_CALIBRATION, &g_calibration,
+                                 sizeof(CalibrationData)) == STORAGE_OK;
 
     if (success) {
         Serial.println("[CAL] Calibration saved");
@@ -173,7 +161,7 @@ void calibration_factory(void) {
     Serial.println("  [4/4] Computing lattice checksum...");
     g_calibration.lattice_checksum = compute_lattice_crc32();
 
-    // Save to EEPROM
+    // Save to persistent storage
     calibration_save();
 
     Serial.println("===============================================================");
@@ -0,0 +1,189 @@
+/**
+ * @file ucf_checksum.cpp
+ * @brief UCF Shared Checksum Engine Implementation v4.0.0
+ *
+ * Slicing-by-8: eight 256-entry tables let the loop fold eight input bytes
+ * per iteration with independent lookups, instead of one byte (or one bit)
+ * at a time. Tables are built on first use (8 KB per polynomial) so builds
+ * that only use the ROM CRC-32 carry no table in RAM.
+ *
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_checksum.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM) && !defined(UCF_CHECKSUM_PORTABLE)
+#include <esp_rom_crc.h>
+#define CHECKSUM_USE_ESP_ROM 1
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(UCF_CHECKSUM_PORTABLE)
+#include <nmmintrin.h>
+#define CHECKSUM_USE_SSE42 1
+#endif
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+typedef struct {
+    uint32_t t[8][256];
+} CrcTables;
+
+static CrcTables build_tables(uint32_t poly) {
+    CrcTables tables;
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; bit++) {
+            c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+        }
+        tables.t[0][i] = c;
+    }
+    // t[k][i]: CRC of byte i followed by k zero bytes
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int k = 1; k < 8; k++) {
+            uint32_t prev = tables.t[k - 1][i];
+            tables.t[k][i] = (prev >> 8) ^ tables.t[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+// Function-local statics: built once, thread-safe initialization
+static const CrcTables& crc32_tables(void) {
+    static const CrcTables tables = build_tables(CHECKSUM_CRC32_POLY);
+    return tables;
+}
+
+static const CrcTables& crc32c_tables(void) {
+    static const CrcTables tables = build_tables(CHECKSUM_CRC32C_POLY);
+    return tables;
+}
+
+/**
+ * @brief Slicing-by-8 over pre-inverted CRC state
+ */
+static uint32_t slice8(const CrcTables& tb, uint32_t crc, const uint8_t* p, size_t len) {
+    const uint32_t (*t)[256] = tb.t;
+
+    // Byte steps up to 8-byte alignment
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (len >= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+#endif
+
+    while (len > 0) {
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+    return crc;
+}
+
+#ifdef CHECKSUM_USE_SSE42
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* p, size_t len) {
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        len--;
+    }
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        crc64 = _mm_crc32_u64(crc64, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    while (len >= 4) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        len--;
+    }
+    return crc;
+}
+
+static bool have_sse42(void) {
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#endif
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+uint32_t checksum_crc32_sw_update(uint32_t crc, const void* data, size_t len) {
+    return ~slice8(crc32_tables(), ~crc, (const uint8_t*)data, len);
+}
+
+uint32_t checksum_crc32c_sw_update(uint32_t crc, const void* data, size_t len) {
+    return ~slice8(crc32c_tables(), ~crc, (const uint8_t*)data, len);
+}
+
+uint32_t checksum_crc32_update(uint32_t crc, const void* data, size_t len) {
+#ifdef CHECKSUM_USE_ESP_ROM
+    // ROM routine inverts internally, matching the zlib convention
+    return esp_rom_crc32_le(crc, (const uint8_t*)data, (uint32_t)len);
+#else
+    return checksum_crc32_sw_update(crc, data, len);
+#endif
+}
+
+uint32_t checksum_crc32(const void* data, size_t len) {
+    return checksum_crc32_update(0, data, len);
+}
+
+uint32_t checksum_crc32c_update(uint32_t crc, const void* data, size_t len) {
+#ifdef CHECKSUM_USE_SSE42
+    if (have_sse42()) {
+        return ~crc32c_sse42(~crc, (const uint8_t*)data, len);
+    }
+#endif
+    return checksum_crc32c_sw_update(crc, data, len);
+}
+
+uint32_t checksum_crc32c(const void* data, size_t len) {
+    return checksum_crc32c_update(0, data, len);
+}
+
+const char* checksum_crc32_impl(void) {
+#ifdef CHECKSUM_USE_ESP_ROM
+    return "esp32-rom";
+#else
+    return "slice8";
+#endif
+}
+
+const char* checksum_crc32c_impl(void) {
+#ifdef CHECKSUM_USE_SSE42
+    if (have_sse42()) {
+        return "sse4.2";
+    }
+#endif
+    return "slice8";
+}
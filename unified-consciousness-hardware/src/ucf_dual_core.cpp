@@ -0,0 +1,175 @@
+/**
+ * @file ucf_dual_core.cpp
+ * @brief Cross-core queue, snapshot and partition pass
+ *
+ * Shared indices use the GCC __atomic builtins (acquire/release), which
+ * compile to memw barriers on the Xtensa cores and are understood by
+ * ThreadSanitizer on the host. Item and buffer contents are plain memory,
+ * handed over by those indices.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_dual_core.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline uint32_t load_acquire(const uint32_t* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_release(uint32_t* p, uint32_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline void count(uint32_t* p, uint32_t n) {
+    __atomic_fetch_add(p, n, __ATOMIC_RELAXED);
+}
+
+static inline uint8_t* snapshot_buffer(const CoreSnapshot* s, uint8_t index) {
+    return s->buffer + (size_t)index * s->size;
+}
+
+// ============================================================================
+// QUEUE
+// ============================================================================
+
+bool core_queue_init(CoreQueue* q, void* buffer, uint16_t item_size, uint16_t capacity) {
+    memset(q, 0, sizeof(*q));
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    q->buffer = (uint8_t*)buffer;
+    q->item_size = item_size;
+    q->capacity = capacity;
+    return true;
+}
+
+bool core_queue_push(CoreQueue* q, const void* item) {
+    uint32_t head = q->head;
+    if (head - load_acquire(&q->tail) >= q->capacity) {
+        count(&q->dropped, 1);
+        return false;
+    }
+
+    memcpy(q->buffer + (size_t)(head & (q->capacity - 1)) * q->item_size, item, q->item_size);
+    store_release(&q->head, head + 1);
+    return true;
+}
+
+bool core_queue_pop(CoreQueue* q, void* item) {
+    uint32_t tail = q->tail;
+    if (load_acquire(&q->head) == tail) {
+        return false;
+    }
+
+    memcpy(item, q->buffer + (size_t)(tail & (q->capacity - 1)) * q->item_size, q->item_size);
+    store_release(&q->tail, tail + 1);
+    return true;
+}
+
+uint16_t core_queue_count(const CoreQueue* q) {
+    return (uint16_t)(load_acquire(&q->head) - load_acquire(&q->tail));
+}
+
+uint32_t core_queue_dropped(const CoreQueue* q) {
+    return __atomic_load_n(&q->dropped, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// SNAPSHOT
+// ============================================================================
+
+void core_snapshot_init(CoreSnapshot* s, void* buffer, uint16_t size) {
+    s->buffer = (uint8_t*)buffer;
+    s->size = size;
+    s->write_index = 0;
+    s->read_index = 1;
+    s->spare = 2;
+    s->published = 0;
+    memset(buffer, 0, (size_t)CORE_SNAPSHOT_BUFFERS * size);
+}
+
+void* core_snapshot_begin(CoreSnapshot* s) {
+    return snapshot_buffer(s, s->write_index);
+}
+
+void core_snapshot_publish(CoreSnapshot* s) {
+    // Hand the filled buffer over; whatever was spare becomes the next one
+    uint8_t prev = __atomic_exchange_n(&s->spare, (uint8_t)(s->write_index | CORE_SNAPSHOT_FRESH),
+                                       __ATOMIC_ACQ_REL);
+    s->write_index = prev & ~CORE_SNAPSHOT_FRESH;
+    s->published++;
+}
+
+void core_snapshot_write(CoreSnapshot* s, const void* data) {
+    memcpy(core_snapshot_begin(s), data, s->size);
+    core_snapshot_publish(s);
+}
+
+const void* core_snapshot_read(CoreSnapshot* s, bool* fresh) {
+    bool is_fresh = (__atomic_load_n(&s->spare, __ATOMIC_ACQUIRE) & CORE_SNAPSHOT_FRESH) != 0;
+    if (is_fresh) {
+        uint8_t prev = __atomic_exchange_n(&s->spare, s->read_index, __ATOMIC_ACQ_REL);
+        s->read_index = prev & ~CORE_SNAPSHOT_FRESH;
+    }
+    if (fresh) {
+        *fresh = is_fresh;
+    }
+    return snapshot_buffer(s, s->read_index);
+}
+
+// ============================================================================
+// PARTITION
+// ============================================================================
+
+void core_partition_init(CorePartition* p, Scheduler* rt, Scheduler* io) {
+    memset(p, 0, sizeof(*p));
+    p->sched[CORE_RT] = rt;
+    p->sched[CORE_IO] = io;
+}
+
+uint32_t core_partition_pass(CorePartition* p, CoreRole role) {
+    Scheduler* s = p->sched[role];
+    CoreStats* st = &p->stats[role];
+
+    uint8_t ran = sched_run(s);
+    if (ran > 0) {
+        count(&st->passes, 1);
+        count(&st->runs, ran);
+    }
+
+    uint32_t idle = sched_idle_us(s);
+    if (idle > 0) {
+        count(&st->idle_passes, 1);
+    }
+    return idle;
+}
+
+void core_partition_set_idle(CorePartition* p, CoreRole role, CoreIdleFn fn, void* ctx) {
+    p->idle[role] = fn;
+    p->idle_ctx[role] = ctx;
+}
+
+bool core_partition_idle(CorePartition* p, CoreRole role, uint32_t idle_us) {
+    CoreIdleFn fn = p->idle[role];
+    return fn != NULL && fn(idle_us, p->idle_ctx[role]);
+}
+
+void core_partition_get_stats(const CorePartition* p, CoreRole role, CoreStats* stats) {
+    const CoreStats* st = &p->stats[role];
+    stats->passes = __atomic_load_n(&st->passes, __ATOMIC_RELAXED);
+    stats->runs = __atomic_load_n(&st->runs, __ATOMIC_RELAXED);
+    stats->idle_passes = __atomic_load_n(&st->idle_passes, __ATOMIC_RELAXED);
+}
+
+bool core_partition_running(const CorePartition* p) {
+    return __atomic_load_n(&p->running, __ATOMIC_ACQUIRE) != 0;
+}
+
+const char* core_role_string(CoreRole role) {
+    return role == CORE_RT ? "rt" : "io";
+}
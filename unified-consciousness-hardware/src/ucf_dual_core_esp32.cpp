@@ -0,0 +1,101 @@
+/**
+ * @file ucf_dual_core_esp32.cpp
+ * @brief FreeRTOS backend for the dual-core partition
+ *
+ * The real-time side runs on the APP CPU above loopTask. Its gaps go to
+ * the idle function when one is set (a timed wait, so sub-tick gaps no
+ * longer spin); otherwise it sleeps at least one tick between passes. A
+ * yield would only reach tasks of its own priority, starving IDLE1 (and
+ * its watchdog) and loopTask; the Kuramoto catch-up steps cover the
+ * late release.
+ * The I/O side runs on the PRO CPU below the WiFi and lwIP tasks and
+ * always sleeps at least one tick between passes, so the idle task (and
+ * its watchdog) on that core keeps running.
+ */
+
+// Only compile when UCF_V4_MODULES is defined
+#ifdef UCF_V4_MODULES
+
+#include "ucf_dual_core.h"
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ucf/ucf_config.h"
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define CORE_TICK_US    (portTICK_PERIOD_MS * 1000UL)
+
+static TaskHandle_t g_tasks[CORE_COUNT] = { NULL, NULL };
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void rt_task(void* arg) {
+    CorePartition* p = (CorePartition*)arg;
+
+    while (core_partition_running(p)) {
+        uint32_t idle = core_partition_pass(p, CORE_RT);
+        if (core_partition_idle(p, CORE_RT, idle)) {
+            continue;
+        }
+        TickType_t ticks = idle / CORE_TICK_US;
+        vTaskDelay(ticks > 0 ? ticks : 1);
+    }
+    __atomic_store_n(&g_tasks[CORE_RT], (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+static void io_task(void* arg) {
+    CorePartition* p = (CorePartition*)arg;
+
+    while (core_partition_running(p)) {
+        uint32_t idle = core_partition_pass(p, CORE_IO);
+        if (core_partition_idle(p, CORE_IO, idle)) {
+            continue;
+        }
+        TickType_t ticks = idle / CORE_TICK_US;
+        vTaskDelay(ticks > 0 ? ticks : 1);
+    }
+    __atomic_store_n(&g_tasks[CORE_IO], (TaskHandle_t)NULL, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool core_partition_start(CorePartition* p) {
+    if (__atomic_load_n(&g_tasks[CORE_RT], __ATOMIC_ACQUIRE) != NULL ||
+        __atomic_load_n(&g_tasks[CORE_IO], __ATOMIC_ACQUIRE) != NULL) {
+        return false;
+    }
+
+    __atomic_store_n(&p->running, 1, __ATOMIC_RELEASE);
+
+    if (xTaskCreatePinnedToCore(io_task, "ucf_io", CORE_TASK_STACK, p, CORE_IO_PRIORITY,
+                                &g_tasks[CORE_IO], CORE_IO_CPU) != pdPASS) {
+        g_tasks[CORE_IO] = NULL;
+        __atomic_store_n(&p->running, 0, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(rt_task, "ucf_rt", CORE_TASK_STACK, p, CORE_RT_PRIORITY,
+                                &g_tasks[CORE_RT], CORE_RT_CPU) != pdPASS) {
+        g_tasks[CORE_RT] = NULL;
+        __atomic_store_n(&p->running, 0, __ATOMIC_RELEASE);
+        // The caller reuses the I/O scheduler: let the pass in progress finish
+        while (__atomic_load_n(&g_tasks[CORE_IO], __ATOMIC_ACQUIRE) != NULL) {
+            vTaskDelay(1);
+        }
+        return false;
+    }
+
+    UCF_LOG("Partition: rt on core %d, io on core %d", CORE_RT_CPU, CORE_IO_CPU);
+    return true;
+}
+
+#endif // UCF_V4_MODULES
@@ -0,0 +1,76 @@
+/**
+ * @file ucf_dual_core_thread.cpp
+ * @brief std::thread backend for the dual-core partition
+ *
+ * One thread per side, each running core_partition_pass() and sleeping
+ * for the idle time it reports (or handing it to the side's idle
+ * function), as the pinned tasks do on the device.
+ * Used by tests (under ThreadSanitizer) and host tools.
+ *
+ * Host only (std::thread).
+ */
+
+#ifndef ARDUINO
+
+#include "ucf_dual_core.h"
+#include <chrono>
+#include <thread>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static std::thread g_threads[CORE_COUNT];
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void worker(CorePartition* p, CoreRole role) {
+    while (core_partition_running(p)) {
+        uint32_t idle = core_partition_pass(p, role);
+        if (core_partition_idle(p, role, idle)) {
+            continue;
+        }
+        if (idle == 0) {
+            std::this_thread::yield();
+        } else {
+            if (idle > CORE_MAX_SLEEP_US) {
+                idle = CORE_MAX_SLEEP_US;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(idle));
+        }
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+uint32_t core_thread_clock_us(void) {
+    static const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+bool core_partition_start_threads(CorePartition* p) {
+    if (core_partition_running(p)) {
+        return false;
+    }
+
+    __atomic_store_n(&p->running, 1, __ATOMIC_RELEASE);
+    g_threads[CORE_RT] = std::thread(worker, p, CORE_RT);
+    g_threads[CORE_IO] = std::thread(worker, p, CORE_IO);
+    return true;
+}
+
+void core_partition_stop_threads(CorePartition* p) {
+    __atomic_store_n(&p->running, 0, __ATOMIC_RELEASE);
+    for (int i = 0; i < CORE_COUNT; i++) {
+        if (g_threads[i].joinable()) {
+            g_threads[i].join();
+        }
+    }
+}
+
+#endif // ARDUINO
@@ -0,0 +1,42 @@
+/**
+ * @file ucf_heap.cpp
+ * @brief Heap monitor report
+ *
+ * The counters live in the backend (ucf_heap_esp32.cpp, ucf_heap_host.cpp);
+ * this prints whichever of them the build has.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_heap.h"
+#include <stdio.h>
+
+// ============================================================================
+// REPORT API
+// ============================================================================
+
+void heap_write_text(HeapLineFn fn, void* ctx) {
+    char line[HEAP_LINE_MAX];
+    HeapStats stats;
+    heap_get_stats(&stats);
+
+    if (stats.free_bytes > 0) {
+        snprintf(line, sizeof(line), "Heap (bytes): %lu free, %lu min free, %lu largest block",
+                 (unsigned long)stats.free_bytes, (unsigned long)stats.min_free_bytes,
+                 (unsigned long)stats.largest_block);
+        fn(line, ctx);
+        if (stats.steady) {
+            long drift = (long)stats.free_bytes - (long)stats.steady_free_bytes;
+            snprintf(line, sizeof(line), "  steady state: %lu free at start, %+ld since",
+                     (unsigned long)stats.steady_free_bytes, drift);
+            fn(line, ctx);
+        }
+    }
+
+    if (stats.counted) {
+        snprintf(line, sizeof(line), "Heap allocations: %lu total, %lu (%lu bytes) in steady state%s",
+                 (unsigned long)stats.allocs, (unsigned long)stats.steady_allocs,
+                 (unsigned long)stats.steady_bytes, stats.steady ? "" : " (not reached)");
+        fn(line, ctx);
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file ucf_heap_esp32.cpp
+ * @brief ESP32 heap monitor: heap_caps statistics
+ *
+ * Reads the internal 8-bit heap (where String, new and FreeRTOS objects
+ * land). The allocator keeps the minimum free size itself, so nothing
+ * here runs on the allocation path.
+ */
+
+#if defined(ARDUINO) && !defined(UCF_NATIVE_HAL)
+
+#include "ucf_heap.h"
+#include <esp_heap_caps.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define HEAP_CAPS       MALLOC_CAP_8BIT
+
+static bool g_steady = false;
+static uint32_t g_steady_free = 0;
+
+// ============================================================================
+// HEAP API
+// ============================================================================
+
+void heap_mark_steady(void) {
+    g_steady_free = (uint32_t)heap_caps_get_free_size(HEAP_CAPS);
+    __atomic_store_n(&g_steady, true, __ATOMIC_RELEASE);
+}
+
+void heap_reset_steady(void) {
+    g_steady_free = (uint32_t)heap_caps_get_free_size(HEAP_CAPS);
+}
+
+void heap_get_stats(HeapStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->steady = __atomic_load_n(&g_steady, __ATOMIC_ACQUIRE);
+    stats->free_bytes = (uint32_t)heap_caps_get_free_size(HEAP_CAPS);
+    stats->min_free_bytes = (uint32_t)heap_caps_get_minimum_free_size(HEAP_CAPS);
+    stats->largest_block = (uint32_t)heap_caps_get_largest_free_block(HEAP_CAPS);
+    stats->steady_free_bytes = g_steady_free;
+}
+
+size_t heap_sites(HeapSite* sites, size_t max) {
+    return 0;
+}
+
+#endif // ARDUINO && !UCF_NATIVE_HAL
@@ -0,0 +1,163 @@
+/**
+ * @file ucf_heap_host.cpp
+ * @brief Host heap monitor: counting malloc interposer
+ *
+ * Defines malloc, calloc, realloc and the aligned allocators in the
+ * executable, which takes precedence over the C library's for every
+ * caller, libstdc++'s operator new included. Each forwards to glibc's
+ * __libc_* entry point after counting. free() is not interposed: it has
+ * nothing to count.
+ *
+ * A steady-state allocation also takes its call stack with backtrace()
+ * for the first HEAP_MAX_SITES. backtrace() allocates on its first call,
+ * so heap_mark_steady() primes it, and a thread-local flag keeps the
+ * counter from recursing into itself.
+ *
+ * Host only (glibc). Compiled out under ASan/TSan, whose own interceptors
+ * must keep malloc; heap_get_stats() then reports counted = false.
+ */
+
+#if !defined(ARDUINO) || defined(UCF_NATIVE_HAL)
+
+#include "ucf_heap.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define HEAP_COUNTED 1
+#include <execinfo.h>
+#else
+#define HEAP_COUNTED 0
+#endif
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static bool g_steady = false;
+static uint32_t g_allocs = 0;
+static uint32_t g_steady_allocs = 0;
+static uint32_t g_steady_bytes = 0;
+static uint32_t g_site_count = 0;                  // Slots claimed (may pass HEAP_MAX_SITES)
+static HeapSite g_sites[HEAP_MAX_SITES];
+static uint32_t g_site_ready[HEAP_MAX_SITES];      // Slot written
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+#if HEAP_COUNTED
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void* __libc_memalign(size_t alignment, size_t size);
+
+static thread_local bool t_in_hook = false;
+
+static void note_alloc(size_t size) {
+    __atomic_fetch_add(&g_allocs, 1, __ATOMIC_RELAXED);
+    if (!__atomic_load_n(&g_steady, __ATOMIC_ACQUIRE) || t_in_hook) {
+        return;
+    }
+
+    __atomic_fetch_add(&g_steady_allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_steady_bytes, (uint32_t)size, __ATOMIC_RELAXED);
+
+    uint32_t slot = __atomic_fetch_add(&g_site_count, 1, __ATOMIC_RELAXED);
+    if (slot < HEAP_MAX_SITES) {
+        t_in_hook = true;
+        HeapSite* site = &g_sites[slot];
+        site->bytes = (uint32_t)size;
+        site->depth = (uint8_t)backtrace(site->frames, HEAP_SITE_DEPTH);
+        __atomic_store_n(&g_site_ready[slot], 1, __ATOMIC_RELEASE);
+        t_in_hook = false;
+    }
+}
+
+// ============================================================================
+// INTERPOSED ALLOCATORS
+// ============================================================================
+
+extern "C" void* malloc(size_t size) {
+    note_alloc(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    note_alloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    note_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    note_alloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    note_alloc(size);
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return 22;  // EINVAL
+    }
+    note_alloc(size);
+    void* p = __libc_memalign(alignment, size);
+    if (p == NULL) {
+        return 12;  // ENOMEM
+    }
+    *out = p;
+    return 0;
+}
+
+#endif // HEAP_COUNTED
+
+// ============================================================================
+// HEAP API
+// ============================================================================
+
+void heap_mark_steady(void) {
+#if HEAP_COUNTED
+    // backtrace() loads its unwinder on the first call
+    void* frame;
+    t_in_hook = true;
+    backtrace(&frame, 1);
+    t_in_hook = false;
+#endif
+    __atomic_store_n(&g_steady, true, __ATOMIC_RELEASE);
+}
+
+void heap_reset_steady(void) {
+    __atomic_store_n(&g_steady_allocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_steady_bytes, 0, __ATOMIC_RELAXED);
+    memset(g_site_ready, 0, sizeof(g_site_ready));
+    __atomic_store_n(&g_site_count, 0, __ATOMIC_RELEASE);
+}
+
+void heap_get_stats(HeapStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->counted = HEAP_COUNTED != 0;
+    stats->steady = __atomic_load_n(&g_steady, __ATOMIC_ACQUIRE);
+    stats->allocs = __atomic_load_n(&g_allocs, __ATOMIC_RELAXED);
+    stats->steady_allocs = __atomic_load_n(&g_steady_allocs, __ATOMIC_RELAXED);
+    stats->steady_bytes = __atomic_load_n(&g_steady_bytes, __ATOMIC_RELAXED);
+}
+
+size_t heap_sites(HeapSite* sites, size_t max) {
+    size_t n = 0;
+    for (size_t i = 0; i < HEAP_MAX_SITES && n < max; i++) {
+        if (__atomic_load_n(&g_site_ready[i], __ATOMIC_ACQUIRE)) {
+            sites[n++] = g_sites[i];
+        }
+    }
+    return n;
+}
+
+#endif // host
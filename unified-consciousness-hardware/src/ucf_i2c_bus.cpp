@@ -0,0 +1,382 @@
+/**
+ * @file ucf_i2c_bus.cpp
+ * @brief I2C transfer queue, scheduling, batching and tracing
+ *
+ * The worker keeps its own pending pool, so the only state shared with
+ * the client is the two CoreQueues. It never runs a transaction unless
+ * the completion queue has room for every transfer it will finish, so a
+ * client that dispatches late delays the bus but never loses a result.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_i2c_bus.h"
+#include "ucf_metrics.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline uint32_t now_us(const I2cBus* bus) {
+    return bus->backend.clock_us(bus->backend.ctx);
+}
+
+static inline bool is_read(const I2cTransfer* t) {
+    return t->tx_len == 0 && t->rx_len > 0;
+}
+
+static inline bool is_expired(const I2cTransfer* t, uint32_t now) {
+    return t->deadline_us != 0 && (int32_t)(now - t->deadline_us) > 0;
+}
+
+// true if a should run before b (seq breaks ties, oldest first)
+static bool runs_before(const I2cBus* bus, uint8_t a, uint8_t b) {
+    const I2cTransfer* ta = &bus->pending[a];
+    const I2cTransfer* tb = &bus->pending[b];
+
+    if (ta->priority != tb->priority) {
+        return ta->priority > tb->priority;
+    }
+    if (ta->deadline_us != tb->deadline_us) {
+        if (ta->deadline_us == 0) return false;
+        if (tb->deadline_us == 0) return true;
+        return (int32_t)(ta->deadline_us - tb->deadline_us) < 0;
+    }
+    return (int32_t)(bus->pending_seq[a] - bus->pending_seq[b]) < 0;
+}
+
+static uint16_t completion_room(const I2cBus* bus) {
+    return bus->completions.capacity - core_queue_count(&bus->completions);
+}
+
+static void complete(I2cBus* bus, const I2cTransfer* t, I2cStatus status) {
+    I2cCompletion c;
+    c.done = t->done;
+    c.ctx = t->ctx;
+    c.rx = t->rx;
+    c.rx_len = t->rx_len;
+    c.status = (uint8_t)status;
+    core_queue_push(&bus->completions, &c);    // Room checked by the caller
+}
+
+// Remove the pending transfers whose bit is set in mask
+static void remove_pending(I2cBus* bus, uint32_t mask) {
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < bus->pending_count; i++) {
+        if (mask & (1u << i)) {
+            continue;
+        }
+        if (kept != i) {
+            bus->pending[kept] = bus->pending[i];
+            bus->pending_seq[kept] = bus->pending_seq[i];
+        }
+        kept++;
+    }
+    bus->pending_count = kept;
+}
+
+// Carry out a reset posted by i2c_bus_reset_stats()
+static void apply_reset(I2cBus* bus) {
+    uint32_t requested = __atomic_load_n(&bus->reset_requested, __ATOMIC_ACQUIRE);
+    if (requested == bus->reset_applied) {
+        return;
+    }
+    memset(bus->stats, 0, sizeof(bus->stats));
+    bus->window_busy_us = 0;
+    bus->window_start_us = now_us(bus);
+    bus->reset_applied = requested;
+}
+
+static void take_requests(I2cBus* bus) {
+    while (bus->pending_count < I2C_BUS_MAX_PENDING &&
+           core_queue_pop(&bus->requests, &bus->pending[bus->pending_count])) {
+        bus->pending_seq[bus->pending_count] = bus->next_seq++;
+        bus->pending_count++;
+    }
+}
+
+// Complete expired and invalid transfers without touching the bus
+static uint8_t sweep(I2cBus* bus, uint32_t now) {
+    uint32_t mask = 0;
+    uint8_t swept = 0;
+
+    for (uint8_t i = 0; i < bus->pending_count && completion_room(bus) > 0; i++) {
+        const I2cTransfer* t = &bus->pending[i];
+        I2cStatus status;
+
+        if (t->device >= I2C_DEV_COUNT || bus->devices[t->device].addr == 0) {
+            status = I2C_ERR_DEVICE;
+        } else if (is_expired(t, now)) {
+            status = I2C_EXPIRED;
+            bus->stats[t->device].expired++;
+        } else {
+            continue;
+        }
+        complete(bus, t, status);
+        mask |= 1u << i;
+        swept++;
+    }
+    remove_pending(bus, mask);
+    return swept;
+}
+
+/**
+ * Grow a read into the widest contiguous burst: pending reads on the same
+ * device that start where the burst ends, or end where it starts, join
+ * until the burst would exceed I2C_BUS_MAX_BATCH.
+ */
+static uint32_t gather_batch(const I2cBus* bus, uint8_t first, uint8_t room,
+                             uint16_t* lo_out, uint16_t* hi_out) {
+    const I2cTransfer* head = &bus->pending[first];
+    uint16_t lo = head->reg;
+    uint16_t hi = head->reg + head->rx_len;
+    uint32_t mask = 1u << first;
+    uint8_t members = 1;
+
+    bool grew = bus->devices[head->device].auto_increment;
+    while (grew && members < room) {
+        grew = false;
+        for (uint8_t i = 0; i < bus->pending_count && members < room; i++) {
+            const I2cTransfer* t = &bus->pending[i];
+            if ((mask & (1u << i)) || t->device != head->device || !is_read(t)) {
+                continue;
+            }
+            uint16_t reg = t->reg;
+            uint16_t end = reg + t->rx_len;
+            if (reg == hi && end - lo <= I2C_BUS_MAX_BATCH) {
+                hi = end;
+            } else if (end == lo && hi - reg <= I2C_BUS_MAX_BATCH) {
+                lo = reg;
+            } else {
+                continue;
+            }
+            mask |= 1u << i;
+            members++;
+            grew = true;
+        }
+    }
+
+    *lo_out = lo;
+    *hi_out = hi;
+    return mask;
+}
+
+static void trace(I2cBus* bus, uint32_t start, uint32_t duration, const I2cTransfer* t,
+                  uint8_t reg, uint8_t len, uint8_t merged, I2cStatus status) {
+    I2cTraceEntry* e = &bus->trace[bus->trace_count % I2C_BUS_TRACE_SIZE];
+    e->start_us = start;
+    e->duration_us = duration > 0xFFFF ? 0xFFFF : (uint16_t)duration;
+    e->device = t->device;
+    e->reg = reg;
+    e->len = len;
+    e->merged = merged;
+    e->status = (uint8_t)status;
+    e->write = t->tx_len > 0;
+    bus->trace_count++;
+}
+
+static void account(I2cBus* bus, uint8_t device, uint32_t duration, uint8_t bytes,
+                    uint8_t merged, I2cStatus status) {
+    I2cDeviceStats* s = &bus->stats[device];
+    s->transfers += merged;
+    s->transactions++;
+    s->busy_us += duration;
+    if (duration > s->max_us) {
+        s->max_us = duration;
+    }
+    s->last_status = (uint8_t)status;
+    if (status == I2C_OK) {
+        s->bytes += bytes;
+    } else {
+        s->errors++;
+        metrics_count(METRIC_I2C_ERRORS, 1);
+    }
+    bus->window_busy_us += duration;
+}
+
+// ============================================================================
+// CLIENT API
+// ============================================================================
+
+void i2c_bus_init(I2cBus* bus, const I2cBackend* backend) {
+    memset(bus, 0, sizeof(*bus));
+    bus->backend = *backend;
+    core_queue_init(&bus->requests, bus->request_buffer, sizeof(I2cTransfer),
+                    I2C_BUS_QUEUE_SIZE);
+    core_queue_init(&bus->completions, bus->completion_buffer, sizeof(I2cCompletion),
+                    I2C_BUS_COMPLETION_SIZE);
+    bus->window_start_us = now_us(bus);
+}
+
+bool i2c_bus_add_device(I2cBus* bus, I2cDeviceId id, const char* name,
+                        uint8_t addr, bool auto_increment) {
+    if (id >= I2C_DEV_COUNT) {
+        return false;
+    }
+    bus->devices[id].name = name;
+    bus->devices[id].addr = addr;
+    bus->devices[id].auto_increment = auto_increment;
+    return true;
+}
+
+bool i2c_bus_submit(I2cBus* bus, const I2cTransfer* transfer) {
+    return core_queue_push(&bus->requests, transfer);
+}
+
+bool i2c_bus_read(I2cBus* bus, I2cDeviceId device, uint8_t reg, uint8_t* rx, uint8_t len,
+                  I2cPriority priority, uint32_t deadline_us, I2cDoneFn done, void* ctx) {
+    I2cTransfer t;
+    memset(&t, 0, sizeof(t));
+    t.device = (uint8_t)device;
+    t.reg = reg;
+    t.rx_len = len;
+    t.rx = rx;
+    t.priority = (uint8_t)priority;
+    t.deadline_us = deadline_us;
+    t.done = done;
+    t.ctx = ctx;
+    return i2c_bus_submit(bus, &t);
+}
+
+void i2c_bus_flush(I2cBus* bus) {
+    if (bus->notify != NULL) {
+        bus->notify(bus->notify_ctx);
+    }
+}
+
+uint32_t i2c_bus_now(const I2cBus* bus) {
+    return now_us(bus);
+}
+
+uint16_t i2c_bus_dispatch(I2cBus* bus) {
+    I2cCompletion c;
+    uint16_t n = 0;
+    while (core_queue_pop(&bus->completions, &c)) {
+        if (c.done != NULL) {
+            c.done(c.rx, c.rx_len, (I2cStatus)c.status, c.ctx);
+        }
+        n++;
+    }
+    return n;
+}
+
+// ============================================================================
+// WORKER API
+// ============================================================================
+
+uint8_t i2c_bus_service(I2cBus* bus) {
+    apply_reset(bus);
+    take_requests(bus);
+    if (bus->pending_count == 0) {
+        return 0;
+    }
+
+    uint8_t completed = sweep(bus, now_us(bus));
+    uint16_t room = completion_room(bus);
+    if (bus->pending_count == 0 || room == 0) {
+        return completed;
+    }
+
+    uint8_t first = 0;
+    for (uint8_t i = 1; i < bus->pending_count; i++) {
+        if (runs_before(bus, i, first)) {
+            first = i;
+        }
+    }
+
+    const I2cTransfer* head = &bus->pending[first];
+    const I2cDevice* dev = &bus->devices[head->device];
+    uint32_t mask = 1u << first;
+    uint8_t merged = 1;
+    uint16_t lo = head->reg;
+    uint16_t hi = head->reg + head->rx_len;
+
+    if (is_read(head) && head->rx_len <= I2C_BUS_MAX_BATCH) {
+        mask = gather_batch(bus, first, room > 32 ? 32 : (uint8_t)room, &lo, &hi);
+        merged = (uint8_t)__builtin_popcount(mask);
+    }
+
+    // Run it
+    uint32_t start = now_us(bus);
+    I2cStatus status;
+    uint8_t len;
+    if (merged > 1) {
+        len = (uint8_t)(hi - lo);
+        status = bus->backend.transfer(bus->backend.ctx, dev->addr, (uint8_t)lo,
+                                       NULL, 0, bus->batch, len);
+    } else {
+        len = head->tx_len > 0 ? head->tx_len : head->rx_len;
+        status = bus->backend.transfer(bus->backend.ctx, dev->addr, head->reg,
+                                       head->tx, head->tx_len, head->rx, head->rx_len);
+    }
+    uint32_t duration = now_us(bus) - start;
+
+    trace(bus, start, duration, head, (uint8_t)lo, len, merged, status);
+    account(bus, head->device, duration, len, merged, status);
+
+    // Hand every carried transfer back, splitting a burst
+    for (uint8_t i = 0; i < bus->pending_count; i++) {
+        if (!(mask & (1u << i))) {
+            continue;
+        }
+        const I2cTransfer* t = &bus->pending[i];
+        if (merged > 1 && status == I2C_OK) {
+            memcpy(t->rx, &bus->batch[t->reg - lo], t->rx_len);
+        }
+        complete(bus, t, status);
+    }
+    remove_pending(bus, mask);
+
+    return completed + merged;
+}
+
+uint32_t i2c_bus_service_all(I2cBus* bus) {
+    uint32_t total = 0;
+    uint8_t n;
+    while ((n = i2c_bus_service(bus)) > 0) {
+        total += n;
+    }
+    return total;
+}
+
+// ============================================================================
+// STATISTICS API
+// ============================================================================
+
+const I2cDeviceStats* i2c_bus_get_stats(const I2cBus* bus, I2cDeviceId id) {
+    return id < I2C_DEV_COUNT ? &bus->stats[id] : NULL;
+}
+
+float i2c_bus_utilization(const I2cBus* bus) {
+    uint32_t elapsed = now_us(bus) - bus->window_start_us;
+    if (elapsed == 0) {
+        return 0.0f;
+    }
+    return 100.0f * (float)bus->window_busy_us / (float)elapsed;
+}
+
+void i2c_bus_reset_stats(I2cBus* bus) {
+    __atomic_fetch_add(&bus->reset_requested, 1, __ATOMIC_RELEASE);
+    i2c_bus_flush(bus);
+}
+
+const I2cTraceEntry* i2c_bus_trace(const I2cBus* bus, uint32_t age) {
+    if (age >= bus->trace_count || age >= I2C_BUS_TRACE_SIZE) {
+        return NULL;
+    }
+    return &bus->trace[(bus->trace_count - 1 - age) % I2C_BUS_TRACE_SIZE];
+}
+
+const char* i2c_status_string(I2cStatus status) {
+    switch (status) {
+        case I2C_OK:            return "ok";
+        case I2C_ERR_NACK:      return "nack";
+        case I2C_ERR_SHORT:     return "short";
+        case I2C_ERR_TIMEOUT:   return "timeout";
+        case I2C_ERR_BUS:       return "bus";
+        case I2C_ERR_DEVICE:    return "device";
+        case I2C_EXPIRED:       return "expired";
+        default:                return "unknown";
+    }
+}
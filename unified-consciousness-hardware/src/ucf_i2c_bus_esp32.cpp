@@ -0,0 +1,117 @@
+/**
+ * @file ucf_i2c_bus_esp32.cpp
+ * @brief Wire backend and FreeRTOS worker for the I2C bus manager
+ *
+ * The worker sits on the real-time core one priority above the scheduler
+ * task. Each transaction blocks only the worker: the ESP32 I2C driver
+ * under Wire runs the transfer from its interrupt and wakes the caller at
+ * the end, so the real-time task keeps the CPU (Kuramoto steps included)
+ * while bytes are on the wire. Arduino Wire offers no DMA path; at 400 kHz
+ * the interrupt-driven FIFO is the asynchronous mechanism available.
+ */
+
+// Only compile when UCF_V4_MODULES is defined
+#ifdef UCF_V4_MODULES
+
+#include "ucf_i2c_bus.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ucf/ucf_config.h"
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static TaskHandle_t g_worker = NULL;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Map a Wire.endTransmission() result
+ */
+static I2cStatus wire_status(uint8_t result) {
+    switch (result) {
+        case 0:  return I2C_OK;
+        case 2:                         // Address NACK
+        case 3:  return I2C_ERR_NACK;   // Data NACK
+        case 5:  return I2C_ERR_TIMEOUT;
+        default: return I2C_ERR_BUS;
+    }
+}
+
+static I2cStatus wire_transfer(void* ctx, uint8_t addr, uint8_t reg,
+                               const uint8_t* tx, uint8_t tx_len,
+                               uint8_t* rx, uint8_t rx_len) {
+    Wire.beginTransmission(addr);
+    Wire.write(reg);
+    if (tx_len > 0) {
+        Wire.write(tx, tx_len);
+    }
+
+    // Repeated start before a read
+    I2cStatus status = wire_status(Wire.endTransmission(rx_len == 0));
+    if (status != I2C_OK || rx_len == 0) {
+        return status;
+    }
+
+    if (Wire.requestFrom(addr, rx_len) != rx_len) {
+        return I2C_ERR_SHORT;
+    }
+    for (uint8_t i = 0; i < rx_len; i++) {
+        rx[i] = (uint8_t)Wire.read();
+    }
+    return I2C_OK;
+}
+
+static uint32_t wire_clock(void* ctx) {
+    return micros();
+}
+
+static void wake_worker(void* ctx) {
+    xTaskNotifyGive((TaskHandle_t)ctx);
+}
+
+static void worker_task(void* arg) {
+    I2cBus* bus = (I2cBus*)arg;
+
+    for (;;) {
+        // Sleep until a flush, or a tick if a full completion queue held work back
+        if (i2c_bus_service(bus) == 0) {
+            ulTaskNotifyTake(pdTRUE, bus->pending_count > 0 ? 1 : portMAX_DELAY);
+        }
+    }
+}
+
+// ============================================================================
+// ESP32 BACKEND
+// ============================================================================
+
+void i2c_bus_wire_backend(I2cBackend* backend) {
+    backend->transfer = wire_transfer;
+    backend->clock_us = wire_clock;
+    backend->ctx = NULL;
+}
+
+bool i2c_bus_start(I2cBus* bus) {
+    if (g_worker != NULL) {
+        return true;
+    }
+
+    BaseType_t ok = xTaskCreatePinnedToCore(worker_task, "ucf_i2c", I2C_BUS_TASK_STACK, bus,
+                                            I2C_BUS_TASK_PRIORITY, &g_worker, CORE_RT_CPU);
+    if (ok != pdPASS) {
+        g_worker = NULL;
+        UCF_LOG("I2C worker task failed to start");
+        return false;
+    }
+
+    bus->notify_ctx = g_worker;
+    bus->notify = wake_worker;
+    return true;
+}
+
+#endif // UCF_V4_MODULES
@@ -0,0 +1,94 @@
+/**
+ * @file ucf_i2c_bus_mock.cpp
+ * @brief Simulated I2C bus for host tests
+ *
+ * Devices are 256-byte register files with auto-increment. Each
+ * transaction advances a virtual clock by its length on the wire:
+ * address and register, plus a second address byte after the repeated
+ * start of a read, plus the data.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_i2c_bus.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static I2cMockDevice* find_device(I2cMockBus* mock, uint8_t addr) {
+    for (int i = 0; i < I2C_MOCK_MAX_DEVICES; i++) {
+        if (mock->devices[i].addr == addr && addr != 0) {
+            return &mock->devices[i];
+        }
+    }
+    return NULL;
+}
+
+static I2cStatus mock_transfer(void* ctx, uint8_t addr, uint8_t reg,
+                               const uint8_t* tx, uint8_t tx_len,
+                               uint8_t* rx, uint8_t rx_len) {
+    I2cMockBus* mock = (I2cMockBus*)ctx;
+    mock->transactions++;
+
+    // The address byte goes out even when nobody answers
+    I2cMockDevice* dev = find_device(mock, addr);
+    if (dev == NULL) {
+        mock->now_us += mock->byte_us;
+        return I2C_ERR_NACK;
+    }
+
+    uint32_t bytes = 2 + tx_len + (rx_len > 0 ? 1 + rx_len : 0);
+    mock->now_us += bytes * mock->byte_us;
+
+    if (dev->fail_count > 0) {
+        dev->fail_count--;
+        return (I2cStatus)dev->fail_status;
+    }
+
+    for (uint8_t i = 0; i < tx_len; i++) {
+        dev->regs[(uint8_t)(reg + i)] = tx[i];
+    }
+    for (uint8_t i = 0; i < rx_len; i++) {
+        rx[i] = dev->regs[(uint8_t)(reg + tx_len + i)];
+    }
+    return I2C_OK;
+}
+
+static uint32_t mock_clock(void* ctx) {
+    return ((I2cMockBus*)ctx)->now_us;
+}
+
+// ============================================================================
+// MOCK BACKEND
+// ============================================================================
+
+void i2c_mock_init(I2cMockBus* mock, uint32_t byte_us) {
+    memset(mock, 0, sizeof(*mock));
+    mock->byte_us = byte_us;
+}
+
+uint8_t* i2c_mock_add_device(I2cMockBus* mock, uint8_t addr) {
+    for (int i = 0; i < I2C_MOCK_MAX_DEVICES; i++) {
+        if (mock->devices[i].addr == 0) {
+            mock->devices[i].addr = addr;
+            return mock->devices[i].regs;
+        }
+    }
+    return NULL;
+}
+
+void i2c_mock_fail(I2cMockBus* mock, uint8_t addr, uint8_t count, I2cStatus status) {
+    I2cMockDevice* dev = find_device(mock, addr);
+    if (dev != NULL) {
+        dev->fail_count = count;
+        dev->fail_status = (uint8_t)status;
+    }
+}
+
+void i2c_mock_backend(I2cMockBus* mock, I2cBackend* backend) {
+    backend->transfer = mock_transfer;
+    backend->clock_us = mock_clock;
+    backend->ctx = mock;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file ucf_idle.cpp
+ * @brief Idle governor: gap policy and residency accounting
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_idle.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE DATA
+// ============================================================================
+
+static const char* const MODE_NAMES[IDLE_MODE_COUNT] = { "run", "wait", "sleep" };
+static const char* const WAKE_NAMES[IDLE_WAKE_COUNT] = { "timer", "uart", "touch", "other" };
+
+// ============================================================================
+// IDLE API
+// ============================================================================
+
+void idle_init(IdleGovernor* g, const IdleConfig* config, uint32_t (*clock_us)(void),
+               IdleEnterFn enter, void* ctx) {
+    memset(g, 0, sizeof(*g));
+    g->config = *config;
+    g->clock_us = clock_us;
+    g->enter = enter;
+    g->ctx = ctx;
+    g->stats_start_us = clock_us();
+}
+
+IdleMode idle_plan(const IdleConfig* config, uint32_t idle_us, uint32_t* enter_us) {
+    *enter_us = 0;
+    if (config->sleep_min_us > 0 && idle_us >= config->sleep_min_us &&
+        idle_us > config->sleep_margin_us) {
+        *enter_us = idle_us - config->sleep_margin_us;
+        return IDLE_LIGHT_SLEEP;
+    }
+    if (idle_us >= config->wait_min_us && idle_us > config->wait_margin_us) {
+        *enter_us = idle_us - config->wait_margin_us;
+        return IDLE_WAIT;
+    }
+    return IDLE_RUN;
+}
+
+IdleMode idle_run(IdleGovernor* g, uint32_t idle_us) {
+    if (idle_us == 0) {
+        return IDLE_RUN;
+    }
+
+    uint32_t enter_us;
+    IdleMode mode = idle_plan(&g->config, idle_us, &enter_us);
+    if (mode == IDLE_RUN || g->enter == NULL) {
+        g->stats.entries[IDLE_RUN]++;
+        return IDLE_RUN;
+    }
+
+    uint32_t start = g->clock_us();
+    IdleWake wake = g->enter(mode, enter_us, g->ctx);
+    uint32_t spent = g->clock_us() - start;
+
+    g->stats.entries[mode]++;
+    g->stats.time_us[mode] += spent;
+    g->stats.wakes[wake < IDLE_WAKE_COUNT ? wake : IDLE_WAKE_OTHER]++;
+    if (spent > enter_us && spent - enter_us > g->stats.max_late_us) {
+        g->stats.max_late_us = spent - enter_us;
+    }
+    return mode;
+}
+
+void idle_get_stats(const IdleGovernor* g, IdleStats* stats) {
+    *stats = g->stats;
+    stats->window_us = g->clock_us() - g->stats_start_us;
+}
+
+void idle_reset_stats(IdleGovernor* g) {
+    memset(&g->stats, 0, sizeof(g->stats));
+    g->stats_start_us = g->clock_us();
+}
+
+void idle_write_text(const IdleGovernor* g, IdleLineFn fn, void* ctx) {
+    char line[IDLE_LINE_MAX];
+    IdleStats stats;
+    idle_get_stats(g, &stats);
+    float window = stats.window_us > 0 ? (float)stats.window_us : 1.0f;
+
+    snprintf(line, sizeof(line), "Idle (%.1f s): %lu short gaps awake, wake late max %lu us",
+             stats.window_us / 1000000.0f, (unsigned long)stats.entries[IDLE_RUN],
+             (unsigned long)stats.max_late_us);
+    fn(line, ctx);
+
+    for (int m = IDLE_WAIT; m < IDLE_MODE_COUNT; m++) {
+        snprintf(line, sizeof(line), "  %-6s %8lu entries %9lu us %5.1f%%",
+                 MODE_NAMES[m], (unsigned long)stats.entries[m], (unsigned long)stats.time_us[m],
+                 100.0f * (float)stats.time_us[m] / window);
+        fn(line, ctx);
+    }
+
+    int len = snprintf(line, sizeof(line), "  woken by");
+    for (int w = 0; w < IDLE_WAKE_COUNT && len < (int)sizeof(line); w++) {
+        len += snprintf(line + len, sizeof(line) - len, " %s=%lu",
+                        WAKE_NAMES[w], (unsigned long)stats.wakes[w]);
+    }
+    fn(line, ctx);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file ucf_idle_esp32.cpp
+ * @brief ESP32 idle backend: timed task waits and light sleep
+ *
+ * IDLE_WAIT arms a one-shot esp_timer and blocks the calling task on its
+ * notification. The core then runs its FreeRTOS idle task, which halts the
+ * CPU (waiti) until the next interrupt, so the wait costs no cycles and
+ * ends within the timer dispatch latency of the release.
+ *
+ * IDLE_LIGHT_SLEEP gates the clocks of the whole chip until the timer, a
+ * UART0 RX edge (a console character; the first one is lost) or the MPR121
+ * IRQ (UCF_TOUCH_IRQ_PIN). A sleep is skipped while the UART still has
+ * bytes to send, which light sleep would garble.
+ *
+ * The native HAL provides esp_timer, esp_sleep and the UART driver calls,
+ * so host builds run this file unchanged.
+ */
+
+#ifdef ARDUINO
+
+#include "ucf_idle.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#if UCF_TOUCH_IRQ_PIN >= 0
+#include <driver/gpio.h>
+#endif
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define IDLE_UART               UART_NUM_0
+#define IDLE_UART_WAKE_EDGES    3           // RX edges that wake the chip
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void on_timer(void* arg) {
+    IdleEsp32* e = (IdleEsp32*)arg;
+    TaskHandle_t task = (TaskHandle_t)__atomic_load_n(&e->task, __ATOMIC_ACQUIRE);
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static IdleWake wait(IdleEsp32* e, uint32_t us) {
+    esp_timer_handle_t timer = (esp_timer_handle_t)e->timer;
+    __atomic_store_n(&e->task, (void*)xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+    if (esp_timer_start_once(timer, us) != ESP_OK) {
+        __atomic_store_n(&e->task, (void*)NULL, __ATOMIC_RELEASE);
+        return IDLE_WAKE_OTHER;
+    }
+
+    // The timer bounds the wait; the tick timeout only guards against a lost one
+    ulTaskNotifyTake(pdTRUE, us / 1000 / portTICK_PERIOD_MS + 2);
+
+    // A timer still armed means something else notified the task
+    bool early = esp_timer_stop(timer) == ESP_OK;
+    __atomic_store_n(&e->task, (void*)NULL, __ATOMIC_RELEASE);
+    ulTaskNotifyTake(pdTRUE, 0);
+    return early ? IDLE_WAKE_OTHER : IDLE_WAKE_TIMER;
+}
+
+static IdleWake light_sleep(IdleEsp32* e, uint32_t us) {
+    if (uart_wait_tx_done(IDLE_UART, 0) != ESP_OK) {
+        return wait(e, us);
+    }
+
+    esp_sleep_enable_timer_wakeup(us);
+    esp_light_sleep_start();
+
+    switch (esp_sleep_get_wakeup_cause()) {
+        case ESP_SLEEP_WAKEUP_TIMER:
+            return IDLE_WAKE_TIMER;
+        case ESP_SLEEP_WAKEUP_UART:
+            return IDLE_WAKE_UART;
+        case ESP_SLEEP_WAKEUP_GPIO:
+            return IDLE_WAKE_TOUCH;
+        default:
+            return IDLE_WAKE_OTHER;
+    }
+}
+
+// ============================================================================
+// ESP32 BACKEND
+// ============================================================================
+
+bool idle_esp32_begin(IdleEsp32* e) {
+    e->task = NULL;
+    e->timer = NULL;
+
+    esp_timer_create_args_t args = {};
+    args.callback = on_timer;
+    args.arg = e;
+    args.name = "ucf_idle";
+    esp_timer_handle_t timer;
+    if (esp_timer_create(&args, &timer) != ESP_OK) {
+        return false;
+    }
+    e->timer = timer;
+
+    // Light sleep wake sources besides the timer (kept across sleeps)
+    uart_set_wakeup_threshold(IDLE_UART, IDLE_UART_WAKE_EDGES);
+    esp_sleep_enable_uart_wakeup(IDLE_UART);
+#if UCF_TOUCH_IRQ_PIN >= 0
+    gpio_wakeup_enable((gpio_num_t)UCF_TOUCH_IRQ_PIN, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+#endif
+    return true;
+}
+
+IdleWake idle_esp32_enter(IdleMode mode, uint32_t us, void* ctx) {
+    IdleEsp32* e = (IdleEsp32*)ctx;
+    if (e->timer == NULL) {
+        return IDLE_WAKE_OTHER;
+    }
+    return mode == IDLE_LIGHT_SLEEP ? light_sleep(e, us) : wait(e, us);
+}
+
+#endif // ARDUINO
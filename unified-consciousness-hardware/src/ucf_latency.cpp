@@ -0,0 +1,432 @@
+/**
+ * @file ucf_latency.cpp
+ * @brief Touch frame tracking, hop histograms and export
+ *
+ * The open frame lives in one word: its ID in the upper half, the stamped
+ * hops and LAT_CLOSED in the lower half. A stage writes its stamp and
+ * then sets its bit with a compare-and-swap, which fails if the frame was
+ * closed or replaced meanwhile. The readField() caller closes a frame by
+ * setting LAT_CLOSED, records it and frees the word; nothing else writes
+ * the histograms, so they need no lock, only relaxed atomics for readers
+ * on the other core.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_latency.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define LAT_CLOSED          0x8000u     // Frame word: no more stamps
+#define LAT_MASK_BITS       0xFFFFu
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[PROF_BUCKETS];
+} LatDist;
+
+static const char* const HOP_NAMES[LAT_HOP_COUNT] = {
+    "touch",
+    "mpr121",
+    "field",
+    "phase",
+    "emanation",
+    "led",
+    "audio",
+};
+
+static LatFrameFn g_frame_fn = NULL;
+static void* g_frame_ctx = NULL;
+
+#if UCF_PROFILE
+static LatClockFn g_clock = NULL;
+static uint32_t g_word = 0;                     // id << 16 | mask (0: no frame)
+static uint32_t g_stamps[LAT_HOP_COUNT];
+static uint32_t g_touch_us = 0;                 // lat_touch() waiting for a frame
+static uint32_t g_touch_pending = 0;
+static uint32_t g_mpr121_us = 0;                // Latest MPR121 read
+static uint32_t g_mpr121_seen = 0;
+static uint16_t g_next_id = 0;
+static bool g_touched = false;                  // Last lat_field() state
+
+static LatDist g_hops[LAT_HOP_COUNT];
+static LatDist g_total;
+static LatStats g_stats;
+static LatFrame g_ring[LAT_RING_FRAMES];
+static uint32_t g_ring_count = 0;               // Frames ever added (mod 2^32)
+#endif
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static int first_hop(uint16_t mask) {
+    return mask ? __builtin_ctz(mask) : -1;
+}
+
+static int last_hop(uint16_t mask) {
+    return mask ? 31 - __builtin_clz(mask) : -1;
+}
+
+#if UCF_PROFILE
+
+static uint32_t load_relaxed(const uint32_t* p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static void add_relaxed(uint32_t* p, uint32_t n) {
+    __atomic_fetch_add(p, n, __ATOMIC_RELAXED);
+}
+
+static void dist_add(LatDist* d, uint32_t us) {
+    add_relaxed(&d->count, 1);
+    if (us > load_relaxed(&d->max_us)) {
+        __atomic_store_n(&d->max_us, us, __ATOMIC_RELAXED);
+    }
+    add_relaxed(&d->buckets[prof_bucket_index(us)], 1);
+}
+
+static uint32_t dist_percentile(const LatDist* d, uint32_t count, float percent) {
+    uint32_t max_us = load_relaxed(&d->max_us);
+    uint32_t rank = (uint32_t)(percent / 100.0f * count + 0.999f);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint32_t seen = 0;
+    for (int b = 0; b < PROF_BUCKETS; b++) {
+        seen += load_relaxed(&d->buckets[b]);
+        if (seen >= rank) {
+            // The bucket bound can overshoot the largest sample in it
+            uint32_t upper = prof_bucket_upper((uint8_t)b);
+            return upper < max_us ? upper : max_us;
+        }
+    }
+    return max_us;
+}
+
+static bool dist_get(const LatDist* d, LatSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    uint32_t count = load_relaxed(&d->count);
+    if (count == 0) {
+        return false;
+    }
+    summary->count = count;
+    summary->p50_us = dist_percentile(d, count, 50.0f);
+    summary->p99_us = dist_percentile(d, count, 99.0f);
+    summary->max_us = load_relaxed(&d->max_us);
+    return true;
+}
+
+/**
+ * @brief Add a closed frame to the histograms and the ring
+ */
+static void record(const LatFrame* frame) {
+    int prev = first_hop(frame->mask);
+    for (int h = prev + 1; h < LAT_HOP_COUNT; h++) {
+        if (frame->mask & LAT_HOP_BIT(h)) {
+            dist_add(&g_hops[h], frame->stamps_us[h] - frame->stamps_us[prev]);
+            prev = h;
+        }
+    }
+
+    if (frame->mask & LAT_OUTPUT_BITS) {
+        int first = first_hop(frame->mask);
+        dist_add(&g_total, frame->stamps_us[last_hop(frame->mask)] - frame->stamps_us[first]);
+        add_relaxed(&g_stats.complete, 1);
+    } else {
+        add_relaxed(&g_stats.incomplete, 1);
+    }
+
+    g_ring[g_ring_count % LAT_RING_FRAMES] = *frame;
+    __atomic_store_n(&g_ring_count, g_ring_count + 1, __ATOMIC_RELEASE);
+
+    if (g_frame_fn != NULL) {
+        g_frame_fn(frame, g_frame_ctx);
+    }
+}
+
+/**
+ * @brief Close the open frame, record it and free the word
+ */
+static void close_frame(void) {
+    uint32_t word = __atomic_fetch_or(&g_word, LAT_CLOSED, __ATOMIC_ACQUIRE);
+
+    LatFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.id = (uint16_t)(word >> 16);
+    frame.mask = (uint16_t)(word & LAT_MASK_BITS & ~LAT_CLOSED);
+    for (int h = 0; h < LAT_HOP_COUNT; h++) {
+        if (frame.mask & LAT_HOP_BIT(h)) {
+            frame.stamps_us[h] = g_stamps[h];
+        }
+    }
+    record(&frame);
+
+    __atomic_store_n(&g_word, word & ~LAT_MASK_BITS, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Open a frame at the field stamp, with the touch and read before it
+ */
+static void open_frame(uint32_t now) {
+    uint16_t mask = LAT_HOP_BIT(LAT_FIELD);
+    g_stamps[LAT_FIELD] = now;
+
+    uint32_t read_us = __atomic_load_n(&g_mpr121_us, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&g_mpr121_seen, __ATOMIC_ACQUIRE) && now - read_us < LAT_TIMEOUT_US) {
+        g_stamps[LAT_MPR121] = read_us;
+        mask |= LAT_HOP_BIT(LAT_MPR121);
+    }
+    if (__atomic_exchange_n(&g_touch_pending, 0, __ATOMIC_ACQUIRE)) {
+        uint32_t touch_us = __atomic_load_n(&g_touch_us, __ATOMIC_RELAXED);
+        if (now - touch_us < LAT_TIMEOUT_US) {
+            g_stamps[LAT_TOUCH] = touch_us;
+            mask |= LAT_HOP_BIT(LAT_TOUCH);
+        }
+    }
+
+    if (++g_next_id == 0) {
+        g_next_id = 1;
+    }
+    __atomic_store_n(&g_word, ((uint32_t)g_next_id << 16) | mask, __ATOMIC_RELEASE);
+}
+
+#endif // UCF_PROFILE
+
+// ============================================================================
+// TRACE API
+// ============================================================================
+
+void lat_on_frame(LatFrameFn fn, void* ctx) {
+    g_frame_fn = fn;
+    g_frame_ctx = ctx;
+}
+
+const char* lat_hop_name(LatHop hop) {
+    return hop < LAT_HOP_COUNT ? HOP_NAMES[hop] : "unknown";
+}
+
+#if UCF_PROFILE
+
+void lat_init(LatClockFn clock) {
+    __atomic_store_n(&g_clock, NULL, __ATOMIC_RELEASE);
+    g_word = 0;
+    g_touch_pending = 0;
+    g_mpr121_seen = 0;
+    g_next_id = 0;
+    g_touched = false;
+    lat_reset();
+    __atomic_store_n(&g_clock, clock, __ATOMIC_RELEASE);
+}
+
+void lat_touch(uint32_t touch_us) {
+    __atomic_store_n(&g_touch_us, touch_us, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_touch_pending, 1, __ATOMIC_RELEASE);
+}
+
+void lat_mark(LatHop hop) {
+    LatClockFn clock = __atomic_load_n(&g_clock, __ATOMIC_ACQUIRE);
+    if (clock == NULL || hop >= LAT_HOP_COUNT) {
+        return;
+    }
+    uint32_t now = clock();
+
+    if (hop == LAT_MPR121) {
+        __atomic_store_n(&g_mpr121_us, now, __ATOMIC_RELAXED);
+        __atomic_store_n(&g_mpr121_seen, 1, __ATOMIC_RELEASE);
+        return;
+    }
+
+    uint32_t word = __atomic_load_n(&g_word, __ATOMIC_ACQUIRE);
+    uint32_t id = word >> 16;
+    for (;;) {
+        uint16_t mask = (uint16_t)(word & LAT_MASK_BITS);
+        if ((word >> 16) != id || !(mask & LAT_HOP_BIT(LAT_FIELD)) ||
+            (mask & (LAT_CLOSED | LAT_OUTPUT_BITS)) || last_hop(mask) >= (int)hop) {
+            return;
+        }
+        g_stamps[hop] = now;
+        if (__atomic_compare_exchange_n(&g_word, &word, word | LAT_HOP_BIT(hop), false,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
+}
+
+void lat_field(bool touched) {
+    LatClockFn clock = __atomic_load_n(&g_clock, __ATOMIC_ACQUIRE);
+    if (clock == NULL) {
+        return;
+    }
+    uint32_t now = clock();
+
+    uint32_t word = __atomic_load_n(&g_word, __ATOMIC_ACQUIRE);
+    bool onset = touched && !g_touched;
+    g_touched = touched;
+
+    if (word & LAT_MASK_BITS) {
+        bool done = (word & LAT_OUTPUT_BITS) != 0;
+        bool stale = now - g_stamps[LAT_FIELD] >= LAT_TIMEOUT_US;
+        if (done || stale || onset) {
+            close_frame();
+        }
+    }
+
+    if (onset) {
+        open_frame(now);
+    }
+}
+
+// ============================================================================
+// READ API
+// ============================================================================
+
+bool lat_get(LatHop hop, LatSummary* summary) {
+    if (hop >= LAT_HOP_COUNT) {
+        memset(summary, 0, sizeof(*summary));
+        return false;
+    }
+    return dist_get(&g_hops[hop], summary);
+}
+
+bool lat_get_total(LatSummary* summary) {
+    return dist_get(&g_total, summary);
+}
+
+void lat_get_stats(LatStats* stats) {
+    stats->complete = load_relaxed(&g_stats.complete);
+    stats->incomplete = load_relaxed(&g_stats.incomplete);
+}
+
+size_t lat_recent(LatFrame* frames, size_t max) {
+    uint32_t end = __atomic_load_n(&g_ring_count, __ATOMIC_ACQUIRE);
+    size_t n = end < LAT_RING_FRAMES ? end : LAT_RING_FRAMES;
+    if (n > max) {
+        n = max;
+    }
+    for (size_t i = 0; i < n; i++) {
+        frames[i] = g_ring[(end - n + i) % LAT_RING_FRAMES];
+    }
+    return n;
+}
+
+void lat_reset(void) {
+    memset(g_hops, 0, sizeof(g_hops));
+    memset(&g_total, 0, sizeof(g_total));
+    memset(&g_stats, 0, sizeof(g_stats));
+    __atomic_store_n(&g_ring_count, 0, __ATOMIC_RELEASE);
+}
+
+#else // !UCF_PROFILE
+
+void lat_init(LatClockFn clock) {
+}
+
+void lat_touch(uint32_t touch_us) {
+}
+
+void lat_mark(LatHop hop) {
+}
+
+void lat_field(bool touched) {
+}
+
+bool lat_get(LatHop hop, LatSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    return false;
+}
+
+bool lat_get_total(LatSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    return false;
+}
+
+void lat_get_stats(LatStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+size_t lat_recent(LatFrame* frames, size_t max) {
+    return 0;
+}
+
+void lat_reset(void) {
+}
+
+#endif // UCF_PROFILE
+
+// ============================================================================
+// EXPORT API
+// ============================================================================
+
+void lat_write_text(LatLineFn fn, void* ctx) {
+    char line[LAT_LINE_MAX];
+    LatStats stats;
+    LatSummary s;
+
+    lat_get_stats(&stats);
+    snprintf(line, sizeof(line), "Touch latency (us): %lu frames, %lu incomplete",
+             (unsigned long)stats.complete, (unsigned long)stats.incomplete);
+    fn(line, ctx);
+
+    for (int h = 0; h < LAT_HOP_COUNT; h++) {
+        if (lat_get((LatHop)h, &s)) {
+            snprintf(line, sizeof(line), "  %-10s n=%lu p50=%lu p99=%lu max=%lu",
+                     HOP_NAMES[h], (unsigned long)s.count, (unsigned long)s.p50_us,
+                     (unsigned long)s.p99_us, (unsigned long)s.max_us);
+            fn(line, ctx);
+        }
+    }
+    if (lat_get_total(&s)) {
+        snprintf(line, sizeof(line), "  %-10s n=%lu p50=%lu p99=%lu max=%lu", "total",
+                 (unsigned long)s.count, (unsigned long)s.p50_us, (unsigned long)s.p99_us,
+                 (unsigned long)s.max_us);
+        fn(line, ctx);
+    }
+}
+
+void lat_write_chrome(const LatFrame* frames, size_t count, LatLineFn fn, void* ctx) {
+    char line[LAT_LINE_MAX];
+    bool first_event = true;
+
+    fn("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", ctx);
+    for (size_t i = 0; i < count; i++) {
+        const LatFrame* f = &frames[i];
+        int prev = first_hop(f->mask);
+        if (prev < 0) {
+            continue;
+        }
+
+        if (f->mask & LAT_OUTPUT_BITS) {
+            int out = last_hop(f->mask);
+            snprintf(line, sizeof(line),
+                     "%s{\"name\":\"touch_to_output\",\"cat\":\"touch\",\"ph\":\"X\",\"pid\":1,"
+                     "\"tid\":%u,\"ts\":%lu,\"dur\":%lu,\"args\":{\"output\":\"%s\"}}",
+                     first_event ? "" : ",", f->id, (unsigned long)f->stamps_us[prev],
+                     (unsigned long)(f->stamps_us[out] - f->stamps_us[prev]), HOP_NAMES[out]);
+            fn(line, ctx);
+            first_event = false;
+        }
+
+        for (int h = prev + 1; h < LAT_HOP_COUNT; h++) {
+            if (!(f->mask & LAT_HOP_BIT(h))) {
+                continue;
+            }
+            snprintf(line, sizeof(line),
+                     "%s{\"name\":\"%s\",\"cat\":\"hop\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%lu,\"dur\":%lu,\"args\":{\"from\":\"%s\"}}",
+                     first_event ? "" : ",", HOP_NAMES[h], f->id,
+                     (unsigned long)f->stamps_us[prev],
+                     (unsigned long)(f->stamps_us[h] - f->stamps_us[prev]), HOP_NAMES[prev]);
+            fn(line, ctx);
+            first_event = false;
+            prev = h;
+        }
+    }
+    fn("]}", ctx);
+}
@@ -9,6 +9,8 @@
 #ifdef UCF_V4_MODULES
 
 #include "ucf_leds.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
 #include <Arduino.h>
 #include <Adafruit_NeoPixel.h>
 #include <math.h>
@@ -290,12 +292,19 @@ bool leds_init(void) {
 }
 
 void leds_update(float z, ConsciousnessPhase phase) {
+    PROF_SCOPE(PROF_LEDS_UPDATE);
+
     if (!g_leds.initialized || !g_leds.enabled) return;
 
     uint32_t now = millis();
     float dt = (now - g_leds.last_update_ms) / 1000.0f;
     g_leds.last_update_ms = now;
 
+    // A new z or phase is the touch reaching the LED stage
+    if (z != g_leds.current_z || phase != g_leds.current_phase) {
+        LAT_MARK(LAT_EMANATION);
+    }
+
     // Update state
     g_leds.current_z = z;
     g_leds.current_phase = phase;
@@ -377,6 +386,7 @@ void leds_update(float z, ConsciousnessPhase phase) {
     // Write to hardware
     write_to_strip();
     g_strip.show();
+    LAT_MARK(LAT_LED);
 
     g_leds.frame_count++;
 }
@@ -0,0 +1,217 @@
+/**
+ * @file ucf_log.cpp
+ * @brief Deferred logger: record ring and formatter
+ *
+ * The ring is a bounded multi-producer queue with a sequence number per
+ * slot. A producer claims the slot at head with a compare-and-swap when
+ * its sequence says the drain has freed it, fills it, then publishes it
+ * by advancing the sequence; a producer preempted mid-record only holds
+ * up the drain, never another producer. The single consumer needs no
+ * compare-and-swap.
+ *
+ * log_format() walks the format itself and hands each conversion to
+ * snprintf() with its stored argument, since a va_list cannot be built
+ * from stored words. Length modifiers are dropped: every argument is
+ * already 32 bits.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static_assert((UCF_LOG_RECORDS & (UCF_LOG_RECORDS - 1)) == 0, "UCF_LOG_RECORDS must be a power of two");
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define LOG_MASK        (UCF_LOG_RECORDS - 1)
+
+static LogRecord g_ring[UCF_LOG_RECORDS];
+static uint32_t g_seq[UCF_LOG_RECORDS];     // Slot free for pos when == pos, full when == pos + 1
+static uint32_t g_head = 0;                 // Next slot to claim (producers)
+static uint32_t g_tail = 0;                 // Next slot to drain (consumer)
+static uint32_t g_written = 0;
+static uint32_t g_dropped = 0;
+
+static const char* const CATEGORY_PREFIX[LOG_CAT_COUNT] = {
+    "[UCF] ",
+    "[LAT] ",
+    "[KUR] ",
+    "[TRI] ",
+    "[DBG] ",
+    "",
+    "",
+};
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static bool is_flag(char c) {
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+}
+
+static bool is_length(char c) {
+    return c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L';
+}
+
+/**
+ * @brief Format one conversion; spec holds '%', flags, width and precision
+ */
+static int format_arg(char* out, size_t capacity, char* spec, size_t n, char conv, LogArg arg) {
+    spec[n++] = conv;
+    spec[n] = '\0';
+    switch (conv) {
+        case 'd': case 'i':
+            return snprintf(out, capacity, spec, (int)arg.i);
+        case 'u': case 'x': case 'X': case 'o':
+            return snprintf(out, capacity, spec, (unsigned)arg.u);
+        case 'c':
+            return snprintf(out, capacity, spec, (int)arg.i);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            return snprintf(out, capacity, spec, (double)arg.f);
+        case 's':
+            return snprintf(out, capacity, spec, arg.s != NULL ? arg.s : "(null)");
+        case 'p':
+            return snprintf(out, capacity, spec, arg.p);
+        default:
+            return 0;
+    }
+}
+
+// ============================================================================
+// LOG API
+// ============================================================================
+
+void log_init(void) {
+    for (uint32_t i = 0; i < UCF_LOG_RECORDS; i++) {
+        g_seq[i] = i;
+    }
+    g_head = 0;
+    g_tail = 0;
+    g_written = 0;
+    g_dropped = 0;
+}
+
+bool log_push(const LogSite* site, const LogArg* args, uint8_t argc) {
+    uint32_t pos = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&g_seq[pos & LOG_MASK], __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&g_head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&g_dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            pos = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+        }
+    }
+
+    LogRecord* record = &g_ring[pos & LOG_MASK];
+    if (argc > LOG_MAX_ARGS) {
+        argc = LOG_MAX_ARGS;
+    }
+    record->site = site;
+    record->argc = argc;
+    memcpy(record->args, args, argc * sizeof(LogArg));
+    __atomic_store_n(&g_seq[pos & LOG_MASK], pos + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&g_written, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+bool log_pop(LogRecord* record) {
+    uint32_t pos = g_tail;
+    uint32_t seq = __atomic_load_n(&g_seq[pos & LOG_MASK], __ATOMIC_ACQUIRE);
+    if (seq != pos + 1) {
+        return false;
+    }
+
+    *record = g_ring[pos & LOG_MASK];
+    __atomic_store_n(&g_seq[pos & LOG_MASK], pos + UCF_LOG_RECORDS, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_tail, pos + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+size_t log_format(const LogRecord* record, char* out, size_t capacity) {
+    if (capacity == 0) {
+        return 0;
+    }
+    const LogSite* site = record->site;
+    size_t len = 0;
+    uint8_t next = 0;
+
+    const char* prefix = site->category < LOG_CAT_COUNT ? CATEGORY_PREFIX[site->category] : "";
+    while (*prefix != '\0' && len + 1 < capacity) {
+        out[len++] = *prefix++;
+    }
+
+    const char* f = site->format;
+    while (*f != '\0' && len + 1 < capacity) {
+        if (*f != '%') {
+            out[len++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[len++] = '%';
+            f += 2;
+            continue;
+        }
+
+        char spec[16];
+        size_t n = 0;
+        spec[n++] = *f++;
+        while (is_flag(*f) && n < sizeof(spec) - 2) {
+            spec[n++] = *f++;
+        }
+        while (((*f >= '0' && *f <= '9') || *f == '.') && n < sizeof(spec) - 2) {
+            spec[n++] = *f++;
+        }
+        while (is_length(*f)) {
+            f++;
+        }
+        char conv = *f;
+        if (conv == '\0') {
+            break;
+        }
+        f++;
+
+        LogArg arg;
+        arg.u = 0;
+        if (next < record->argc) {
+            arg = record->args[next++];
+        }
+        int written = format_arg(out + len, capacity - len, spec, n, conv, arg);
+        if (written > 0) {
+            len += (size_t)written < capacity - len ? (size_t)written : capacity - len - 1;
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
+
+size_t log_drain(LogLineFn fn, void* ctx, size_t max) {
+    char line[LOG_LINE_MAX];
+    LogRecord record;
+    size_t count = 0;
+    while (count < max && log_pop(&record)) {
+        log_format(&record, line, sizeof(line));
+        fn(line, ctx);
+        count++;
+    }
+    return count;
+}
+
+void log_get_stats(LogStats* stats) {
+    uint32_t head = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&g_tail, __ATOMIC_RELAXED);
+    stats->written = __atomic_load_n(&g_written, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&g_dropped, __ATOMIC_RELAXED);
+    stats->pending = head - tail;
+}
@@ -11,7 +11,9 @@
 #include "ucf_magnetometer.h"
 #include <Arduino.h>
 #include <Wire.h>
-#include <EEPROM.h>
+#include "ucf_storage.h"
+#include "ucf_metrics.h"
+#include "ucf_trace.h"
 #include <math.h>
 #include "ucf/ucf_config.h"
 
@@ -42,8 +44,9 @@ static uint32_t g_cal_samples = 0;
 // Smoothed heading for filtering
 static float g_heading_smoothed = 0.0f;
 
-// EEPROM address for magnetometer calibration
-#define MAG_EEPROM_ADDR     256
+// Storage layout version of MagnetometerCalibration
+#define MAG_STORAGE_VERSION     1
+#define MAG_LEGACY_ADDR         256     // Older firmware's EEPROM address
 
 // ============================================================================
 // PRIVATE FUNCTIONS
@@ -56,7 +59,11 @@ static bool write_register(uint8_t reg, uint8_t value) {
     Wire.beginTransmission(HMC5883L_I2C_ADDR);
     Wire.write(reg);
     Wire.write(value);
-    return (Wire.endTransmission() == 0);
+    if (Wire.endTransmission() != 0) {
+        metrics_count(METRIC_I2C_ERRORS, 1);
+        return false;
+    }
+    return true;
 }
 
 /**
@@ -66,11 +73,13 @@ static bool read_registers(uint8_t reg, uint8_t* buffer, uint8_t length) {
     Wire.beginTransmission(HMC5883L_I2C_ADDR);
     Wire.write(reg);
     if (Wire.endTransmission() != 0) {
+        metrics_count(METRIC_I2C_ERRORS, 1);
         return false;
     }
 
     Wire.requestFrom((uint8_t)HMC5883L_I2C_ADDR, length);
     if (Wire.available() != length) {
+        metrics_count(METRIC_I2C_ERRORS, 1);
         return false;
     }
 
@@ -176,7 +185,7 @@ bool magnetometer_init(void) {
         return false;
     }
 
-    // Try to load calibration from EEPROM
+    // Try to load calibration from persistent storage
     magnetometer_load_calibration();
 
     g_mag.initialized = true;
@@ -191,8 +200,20 @@ MagnetometerData magnetometer_read(void) {
         return g_mag.data;
     }
 
-    // Read raw data
-    MagnetometerRaw raw = magnetometer_read_raw();
+    return magnetometer_process(magnetometer_read_raw());
+}
+
+MagnetometerData magnetometer_process(MagnetometerRaw raw) {
+    if (!g_mag.initialized) {
+        g_mag.data.valid = false;
+        return g_mag.data;
+    }
+
+    int16_t xyz[3] = { raw.x, raw.y, raw.z };
+    TRACE_MAG(millis(), xyz);
+    raw.x = xyz[0];
+    raw.y = xyz[1];
+    raw.z = xyz[2];
     g_mag.raw = raw;
 
     // Apply calibration
@@ -241,11 +262,17 @@ bool magnetometer_data_ready(void) {
 MagnetometerRaw magnetometer_read_raw(void) {
     MagnetometerRaw raw = {0, 0, 0};
 
-    uint8_t data[6];
-    if (!read_registers(HMC5883L_REG_DATA_X_H, data, 6)) {
+    uint8_t data[HMC5883L_DATA_BYTES];
+    if (!read_registers(HMC5883L_REG_DATA_X_H, data, HMC5883L_DATA_BYTES)) {
         return raw;
     }
 
+    return magnetometer_decode_raw(data);
+}
+
+MagnetometerRaw magnetometer_decode_raw(const uint8_t* data) {
+    MagnetometerRaw raw;
+
     // HMC5883L data order is X, Z, Y (not X, Y, Z!)
     raw.x = (int16_t)((data[0] << 8) | data[1]);
     raw.z = (int16_t)((data[2] << 8) | data[3]);
@@ -346,17 +373,43 @@ void magnetometer_set_declination(float declination) {
     g_mag.calibration.declination = declination;
 }
 
+/**
+ * @brief Mount storage and register the magnetometer region
+ */
+static bool mag_storage_open(void) {
+    return storage_begin() &&
+           storage_register(STORAGE_REGION_MAGNETOMETER, "mag",
+                            sizeof(MagnetometerCalibration), MAG_STORAGE_VERSION);
+}
+
+static bool mag_calibration_plausible(const MagnetometerCalibration* cal) {
+    return cal->calibrated && abs(cal->scale_x) > 100 && abs(cal->scale_x) < 10000;
+}
+
 bool magnetometer_load_calibration(void) {
     MagnetometerCalibration cal;
 
-    EEPROM.begin(512);
-    EEPROM.get(MAG_EEPROM_ADDR, cal);
-    EEPROM.end();
+    if (!mag_storage_open()) {
+        return false;
+    }
+
+    StorageStatus status = storage_read(STORAGE_REGION_MAGNETOMETER, &cal, sizeof(cal));
+    if (status == STORAGE_ERR_NOT_FOUND &&
+        storage_legacy_read(MAG_LEGACY_ADDR, &cal, sizeof(cal)) && mag_calibration_plausible(&cal)) {
+        // Once, on the boot that replaced the fixed EEPROM layout
+        g_mag.calibration = cal;
+        Serial.println("[MAG] Imported calibration from legacy EEPROM");
+        storage_write(STORAGE_REGION_MAGNETOMETER, &cal, sizeof(cal));
+        return true;
+    }
+    if (status != STORAGE_OK) {
+        return false;
+    }
 
     // Simple validity check
-    if (cal.calibrated && abs(cal.scale_x) > 100 && abs(cal.scale_x) < 10000) {
+    if (mag_calibration_plausible(&cal)) {
         g_mag.calibration = cal;
-        Serial.println("[MAG] Loaded calibration from EEPROM");
+        Serial.println("[MAG] Loaded calibration from storage");
         return true;
     }
 
@@ -364,13 +417,13 @@ bool magnetometer_load_calibration(void) {
 }
 
 bool magnetometer_save_calibration(void) {
-    EEPROM.begin(512);
-    EEPROM.put(MAG_EEPROM_ADDR, g_mag.calibration);
-    bool success = EEPROM.commit();
-    EEPROM.end();
+    // Committed by storage_tick() after the coalescing window
+    bool success = mag_storage_open() &&
+                   storage_write(STORAGE_REGION_MAGNETOMETER, &g_mag.calibration,
+                                 sizeof(MagnetometerCalibration)) == STORAGE_OK;
 
     if (success) {
-        Serial.println("[MAG] Calibration saved to EEPROM");
+        Serial.println("[MAG] Calibration saved to storage");
     }
 
     return success;
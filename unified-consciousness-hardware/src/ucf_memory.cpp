@@ -0,0 +1,125 @@
+/**
+ * @file ucf_memory.cpp
+ * @brief Module arena and memory report
+ *
+ * The arena is a bump allocator over one static array: a block is the
+ * next MEM_ROUND(bytes) of it, and mem_release() moves the end back. The
+ * block table is kept in offset order, so a release also drops every
+ * block at or past the mark.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_memory.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static uint8_t g_arena[UCF_ARENA_BYTES] __attribute__((aligned(MEM_ALIGN)));
+static uint32_t g_used = 0;
+static uint32_t g_peak = 0;
+static uint32_t g_refused = 0;
+static MemBlock g_blocks[MEM_MAX_BLOCKS];
+static uint8_t g_block_count = 0;
+
+static const MemStaticEntry* g_static = NULL;
+static size_t g_static_count = 0;
+
+// ============================================================================
+// ARENA API
+// ============================================================================
+
+void mem_init(void) {
+    g_used = 0;
+    g_peak = 0;
+    g_refused = 0;
+    g_block_count = 0;
+}
+
+void* mem_alloc(const char* owner, size_t bytes) {
+    size_t rounded = MEM_ROUND(bytes);
+    if (bytes == 0 || rounded > UCF_ARENA_BYTES - g_used || g_block_count == MEM_MAX_BLOCKS) {
+        g_refused += (uint32_t)bytes;
+        return NULL;
+    }
+
+    MemBlock* block = &g_blocks[g_block_count++];
+    block->owner = owner;
+    block->offset = g_used;
+    block->bytes = (uint32_t)bytes;
+
+    void* p = &g_arena[g_used];
+    memset(p, 0, rounded);
+    g_used += (uint32_t)rounded;
+    if (g_used > g_peak) {
+        g_peak = g_used;
+    }
+    return p;
+}
+
+uint32_t mem_mark(void) {
+    return g_used;
+}
+
+void mem_release(uint32_t mark) {
+    if (mark >= g_used) {
+        return;
+    }
+    while (g_block_count > 0 && g_blocks[g_block_count - 1].offset >= mark) {
+        g_block_count--;
+    }
+    g_used = mark;
+}
+
+void mem_get_stats(MemStats* stats) {
+    stats->capacity = UCF_ARENA_BYTES;
+    stats->used = g_used;
+    stats->peak = g_peak;
+    stats->refused = g_refused;
+    stats->blocks = g_block_count;
+}
+
+size_t mem_blocks(MemBlock* blocks, size_t max) {
+    size_t n = g_block_count < max ? g_block_count : max;
+    memcpy(blocks, g_blocks, n * sizeof(MemBlock));
+    return n;
+}
+
+// ============================================================================
+// REPORT API
+// ============================================================================
+
+void mem_set_static(const MemStaticEntry* table, size_t count) {
+    g_static = table;
+    g_static_count = count;
+}
+
+void mem_write_text(MemLineFn fn, void* ctx) {
+    char line[MEM_LINE_MAX];
+    uint32_t total = 0;
+
+    fn("Static modules (bytes):", ctx);
+    for (size_t i = 0; i < g_static_count; i++) {
+        snprintf(line, sizeof(line), "  %-20s %6lu", g_static[i].name,
+                 (unsigned long)g_static[i].bytes);
+        fn(line, ctx);
+        total += g_static[i].bytes;
+    }
+    snprintf(line, sizeof(line), "  %-20s %6lu", "total", (unsigned long)total);
+    fn(line, ctx);
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    snprintf(line, sizeof(line), "Arena (bytes): %lu used, %lu peak of %lu, %lu refused",
+             (unsigned long)stats.used, (unsigned long)stats.peak,
+             (unsigned long)stats.capacity, (unsigned long)stats.refused);
+    fn(line, ctx);
+    for (uint8_t i = 0; i < g_block_count; i++) {
+        snprintf(line, sizeof(line), "  %-20s %6lu @ %lu", g_blocks[i].owner,
+                 (unsigned long)g_blocks[i].bytes, (unsigned long)g_blocks[i].offset);
+        fn(line, ctx);
+    }
+}
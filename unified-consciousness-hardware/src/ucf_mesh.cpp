@@ -0,0 +1,268 @@
+/**
+ * @file ucf_mesh.cpp
+ * @brief Kuramoto mesh: summary packets, peers and the combined field
+ *
+ * Packet layout (little-endian):
+ *
+ *   0  magic      MESH_MAGIC
+ *   1  node
+ *   2  seq        uint16
+ *   4  r          uint16, r * 65535
+ *   6  psi        uint16, psi / 2 PI * 65536
+ *   8  freq       int16, centihertz
+ *  10  sent_us    uint32
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_mesh.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+#define MESH_TWO_PI     6.28318530718f
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t* p) {
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static float wrap_phase(float psi) {
+    psi = fmodf(psi, MESH_TWO_PI);
+    return psi < 0.0f ? psi + MESH_TWO_PI : psi;
+}
+
+static bool is_fresh(const MeshPeer* peer, uint32_t now_us) {
+    return peer->active && now_us - peer->rx_us <= MESH_PEER_TIMEOUT_US;
+}
+
+/**
+ * @brief Slot for a node: its own, a free one, or the one of a silent peer
+ */
+static MeshPeer* find_peer(Mesh* m, uint8_t node, uint32_t now_us) {
+    MeshPeer* spare = NULL;
+    for (int i = 0; i < MESH_MAX_PEERS; i++) {
+        MeshPeer* peer = &m->peers[i];
+        if (peer->active && peer->last.node == node) {
+            return peer;
+        }
+        if (spare == NULL && !is_fresh(peer, now_us)) {
+            spare = peer;
+        }
+    }
+    if (spare != NULL) {
+        memset(spare, 0, sizeof(*spare));
+    }
+    return spare;
+}
+
+static bool accept(Mesh* m, MeshPeer* peer, const MeshSummary* s, uint32_t now_us) {
+    int32_t sample = (int32_t)(now_us - s->sent_us);
+
+    // A peer back after a silence (e.g. rebooted) starts over
+    bool known = peer->active && now_us - peer->rx_us <= MESH_PEER_TIMEOUT_US;
+    if (known) {
+        uint16_t gap = (uint16_t)(s->seq - peer->last.seq);
+        if (gap == 0 || gap >= 0x8000) {
+            m->stats.rejected++;        // Duplicate or older than the last one
+            return false;
+        }
+        peer->lost += gap - 1u;
+        m->stats.lost += gap - 1u;
+
+        // Shortest delay so far, creeping up so the offset follows drift
+        int32_t crept = peer->offset_us + MESH_OFFSET_CREEP_US;
+        peer->offset_us = sample < crept ? sample : crept;
+    } else {
+        uint32_t packets = peer->active ? peer->packets : 0;
+        uint32_t lost = peer->active ? peer->lost : 0;
+        memset(peer, 0, sizeof(*peer));
+        peer->packets = packets;
+        peer->lost = lost;
+        peer->active = true;
+        peer->offset_us = sample;
+    }
+
+    peer->last = *s;
+    peer->rx_us = now_us;
+    peer->held_us = s->sent_us + (uint32_t)peer->offset_us - MESH_LINK_LATENCY_US;
+    peer->packets++;
+    m->stats.received++;
+    return true;
+}
+
+// ============================================================================
+// PACKET API
+// ============================================================================
+
+void mesh_encode(const MeshSummary* summary, uint8_t* out) {
+    float r = summary->r < 0.0f ? 0.0f : (summary->r > 1.0f ? 1.0f : summary->r);
+    float psi = wrap_phase(summary->psi);
+    float centi = summary->freq_hz * 100.0f;
+    centi = centi > 32767.0f ? 32767.0f : (centi < -32768.0f ? -32768.0f : centi);
+
+    out[0] = MESH_MAGIC;
+    out[1] = summary->node;
+    put16(out + 2, summary->seq);
+    put16(out + 4, (uint16_t)lroundf(r * 65535.0f));
+    put16(out + 6, (uint16_t)((uint32_t)lroundf(psi / MESH_TWO_PI * 65536.0f) & 0xFFFF));
+    put16(out + 8, (uint16_t)(int16_t)lroundf(centi));
+    put32(out + 10, summary->sent_us);
+}
+
+bool mesh_decode(const uint8_t* data, uint8_t len, MeshSummary* summary) {
+    if (len != MESH_PACKET_BYTES || data[0] != MESH_MAGIC) {
+        return false;
+    }
+    summary->node = data[1];
+    summary->seq = get16(data + 2);
+    summary->r = get16(data + 4) / 65535.0f;
+    summary->psi = get16(data + 6) * (MESH_TWO_PI / 65536.0f);
+    summary->freq_hz = (int16_t)get16(data + 8) / 100.0f;
+    summary->sent_us = get32(data + 10);
+    return summary->node != MESH_NODE_NONE;
+}
+
+// ============================================================================
+// MESH API
+// ============================================================================
+
+void mesh_init(Mesh* m, const MeshBackend* backend, uint8_t node) {
+    memset(m, 0, sizeof(*m));
+    m->backend = *backend;
+    m->node = node;
+}
+
+bool mesh_broadcast(Mesh* m, float r, float psi, float freq_hz, uint32_t held_us) {
+    MeshSummary s = { m->node, m->seq++, r, psi, freq_hz, held_us };
+    uint8_t packet[MESH_PACKET_BYTES];
+    mesh_encode(&s, packet);
+
+    if (m->backend.send == NULL || !m->backend.send(m->backend.ctx, packet, sizeof(packet))) {
+        m->stats.send_errors++;
+        return false;
+    }
+    m->stats.sent++;
+    return true;
+}
+
+uint8_t mesh_poll(Mesh* m, uint32_t now_us) {
+    if (m->backend.recv == NULL) {
+        return 0;
+    }
+
+    uint8_t accepted = 0;
+    uint8_t packet[MESH_PACKET_BYTES + 1];      // Longer packets show up as such
+    for (int i = 0; i < MESH_POLL_MAX; i++) {
+        uint32_t rx_us = now_us;
+        uint8_t len = m->backend.recv(m->backend.ctx, packet, sizeof(packet), &rx_us);
+        if (len == 0) {
+            break;
+        }
+
+        MeshSummary s;
+        if (!mesh_decode(packet, len, &s) || s.node == m->node) {
+            m->stats.rejected++;
+            continue;
+        }
+
+        MeshPeer* peer = find_peer(m, s.node, rx_us);
+        if (peer == NULL) {
+            m->stats.no_slot++;
+            continue;
+        }
+
+        if (accept(m, peer, &s, rx_us)) {
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+float mesh_peer_phase(const MeshPeer* peer, uint32_t now_us) {
+    float age_s = (int32_t)(now_us - peer->held_us) / 1000000.0f;
+    return wrap_phase(peer->last.psi + MESH_TWO_PI * peer->last.freq_hz * age_s);
+}
+
+bool mesh_field(const Mesh* m, uint32_t now_us, MeshField* field) {
+    memset(field, 0, sizeof(*field));
+    field->at_us = now_us;
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float weight = 0.0f;
+    float weighted_freq = 0.0f;
+    float freq = 0.0f;
+    for (int i = 0; i < MESH_MAX_PEERS; i++) {
+        const MeshPeer* peer = &m->peers[i];
+        if (!is_fresh(peer, now_us)) {
+            continue;
+        }
+        float phase = mesh_peer_phase(peer, now_us);
+        x += peer->last.r * cosf(phase);
+        y += peer->last.r * sinf(phase);
+        weight += peer->last.r;
+        weighted_freq += peer->last.r * peer->last.freq_hz;
+        freq += peer->last.freq_hz;
+        field->peers++;
+    }
+    if (field->peers == 0) {
+        return false;
+    }
+
+    field->r = sqrtf(x * x + y * y) / field->peers;
+    field->psi = wrap_phase(atan2f(y, x));
+    field->freq_hz = weight > 0.0f ? weighted_freq / weight : freq / field->peers;
+    return true;
+}
+
+void mesh_get_stats(const Mesh* m, MeshStats* stats) {
+    *stats = m->stats;
+}
+
+void mesh_write_text(const Mesh* m, uint32_t now_us, MeshLineFn fn, void* ctx) {
+    char line[MESH_LINE_MAX];
+    snprintf(line, sizeof(line), "Mesh node %u: sent %lu (%lu failed), received %lu, rejected %lu, lost %lu",
+             m->node, (unsigned long)m->stats.sent, (unsigned long)m->stats.send_errors,
+             (unsigned long)m->stats.received, (unsigned long)m->stats.rejected,
+             (unsigned long)m->stats.lost);
+    fn(line, ctx);
+
+    for (int i = 0; i < MESH_MAX_PEERS; i++) {
+        const MeshPeer* peer = &m->peers[i];
+        if (!peer->active) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "  node %3u r=%.3f psi=%.2f f=%.2f Hz age %lu ms offset %ld us%s",
+                 peer->last.node, peer->last.r, mesh_peer_phase(peer, now_us), peer->last.freq_hz,
+                 (unsigned long)((now_us - peer->rx_us) / 1000), (long)peer->offset_us,
+                 is_fresh(peer, now_us) ? "" : " (silent)");
+        fn(line, ctx);
+    }
+
+    MeshField field;
+    if (mesh_field(m, now_us, &field)) {
+        snprintf(line, sizeof(line), "  field r=%.3f psi=%.2f f=%.2f Hz from %u peers",
+                 field.r, field.psi, field.freq_hz, field.peers);
+    } else {
+        snprintf(line, sizeof(line), "  no peers heard");
+    }
+    fn(line, ctx);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ucf_mesh_esp32.cpp
+ * @brief ESP-NOW backend for the Kuramoto mesh
+ *
+ * Summaries go to the broadcast address, so every device on the channel
+ * hears every other without pairing; ESP-NOW broadcasts are not
+ * acknowledged or retried, which suits a stream where only the newest
+ * summary matters. The receive callback runs in the WiFi task (PRO CPU),
+ * stamps each packet with its arrival time and hands it to the mesh task
+ * through a CoreQueue; a full queue drops the packet and the sequence gap
+ * shows it as lost.
+ *
+ * WiFi stays on the channel it has (1 when not associated). Devices that
+ * also join an access point must all use that AP's channel.
+ *
+ * The native HAL carries ESP-NOW over UDP on the loopback interface
+ * (--mesh-node), so host builds run this file unchanged.
+ */
+
+// Only compile when UCF_V4_MODULES is defined
+#ifdef UCF_V4_MODULES
+
+#include "ucf_mesh.h"
+#include "ucf_dual_core.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define MESH_RX_QUEUE           16          // Packets between mesh_poll() calls
+
+typedef struct {
+    uint32_t rx_us;                         // micros() in the receive callback
+    uint8_t len;
+    uint8_t data[MESH_PACKET_BYTES + 1];    // One spare byte marks longer packets
+} MeshRxItem;
+
+static const uint8_t BROADCAST_MAC[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static MeshRxItem g_rx_items[MESH_RX_QUEUE];
+static CoreQueue g_rx;                      // WiFi task -> mesh task
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void on_receive(const uint8_t* mac, const uint8_t* data, int len) {
+    MeshRxItem item;
+    item.rx_us = micros();
+    item.len = (uint8_t)(len < (int)sizeof(item.data) ? len : sizeof(item.data));
+    memcpy(item.data, data, item.len);
+    core_queue_push(&g_rx, &item);
+}
+
+static bool espnow_send(void* ctx, const uint8_t* data, uint8_t len) {
+    return esp_now_send(BROADCAST_MAC, data, len) == ESP_OK;
+}
+
+static uint8_t espnow_recv(void* ctx, uint8_t* data, uint8_t max, uint32_t* rx_us) {
+    MeshRxItem item;
+    if (!core_queue_pop(&g_rx, &item)) {
+        return 0;
+    }
+    uint8_t len = item.len < max ? item.len : max;
+    memcpy(data, item.data, len);
+    *rx_us = item.rx_us;
+    return len;
+}
+
+// ============================================================================
+// ESP32 BACKEND
+// ============================================================================
+
+bool mesh_espnow_backend(MeshBackend* backend, uint8_t* node) {
+    core_queue_init(&g_rx, g_rx_items, sizeof(MeshRxItem), MESH_RX_QUEUE);
+
+    if (WiFi.getMode() == WIFI_OFF) {
+        WiFi.mode(WIFI_STA);
+    }
+    if (esp_now_init() != ESP_OK) {
+        return false;
+    }
+
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, BROADCAST_MAC, ESP_NOW_ETH_ALEN);
+    peer.channel = 0;                       // Current channel
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+    if (esp_now_add_peer(&peer) != ESP_OK || esp_now_register_recv_cb(on_receive) != ESP_OK) {
+        esp_now_deinit();
+        return false;
+    }
+
+    uint8_t mac[ESP_NOW_ETH_ALEN];
+    esp_wifi_get_mac(WIFI_IF_STA, mac);
+    *node = mac[ESP_NOW_ETH_ALEN - 1] != MESH_NODE_NONE ? mac[ESP_NOW_ETH_ALEN - 1] : 0;
+
+    backend->send = espnow_send;
+    backend->recv = espnow_recv;
+    backend->ctx = NULL;
+    return true;
+}
+
+#endif // UCF_V4_MODULES
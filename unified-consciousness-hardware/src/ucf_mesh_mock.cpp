@@ -0,0 +1,82 @@
+/**
+ * @file ucf_mesh_mock.cpp
+ * @brief In-process broadcast medium for host tests
+ *
+ * Every packet sent by one node lands in the inbox of each other node and
+ * becomes readable once the hub clock passes its delivery time. A full
+ * inbox loses the packet, as a busy receiver would.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_mesh.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static bool mock_send(void* ctx, const uint8_t* data, uint8_t len) {
+    MeshMockPort* port = (MeshMockPort*)ctx;
+    MeshMockHub* hub = port->hub;
+    if (len > MESH_PACKET_BYTES) {
+        return false;
+    }
+
+    hub->sent++;
+    port->sent++;
+    if (hub->drop_every > 0 && hub->sent % hub->drop_every == 0) {
+        return true;                    // Lost on the air
+    }
+
+    uint32_t due = hub->now_us + hub->delay_us + ((port->sent & 1) ? hub->jitter_us : 0);
+    for (uint8_t i = 0; i < hub->nodes; i++) {
+        MeshMockInbox* inbox = &hub->inbox[i];
+        if (i == port->index || inbox->count == MESH_MOCK_QUEUE) {
+            continue;
+        }
+        uint8_t slot = (uint8_t)((inbox->head + inbox->count) % MESH_MOCK_QUEUE);
+        memcpy(inbox->data[slot], data, len);
+        inbox->len[slot] = len;
+        inbox->due_us[slot] = due;
+        inbox->count++;
+    }
+    return true;
+}
+
+static uint8_t mock_recv(void* ctx, uint8_t* data, uint8_t max, uint32_t* rx_us) {
+    MeshMockPort* port = (MeshMockPort*)ctx;
+    MeshMockHub* hub = port->hub;
+    MeshMockInbox* inbox = &hub->inbox[port->index];
+
+    // In order of sending: a jittered packet holds back the ones behind it
+    if (inbox->count == 0 || (int32_t)(hub->now_us - inbox->due_us[inbox->head]) < 0) {
+        return 0;
+    }
+
+    uint8_t len = inbox->len[inbox->head] < max ? inbox->len[inbox->head] : max;
+    memcpy(data, inbox->data[inbox->head], len);
+    *rx_us = inbox->due_us[inbox->head];
+    inbox->head = (uint8_t)((inbox->head + 1) % MESH_MOCK_QUEUE);
+    inbox->count--;
+    return len;
+}
+
+// ============================================================================
+// MOCK API
+// ============================================================================
+
+void mesh_mock_init(MeshMockHub* hub, uint8_t nodes, uint32_t delay_us) {
+    memset(hub, 0, sizeof(*hub));
+    hub->nodes = nodes < MESH_MOCK_MAX_NODES ? nodes : MESH_MOCK_MAX_NODES;
+    hub->delay_us = delay_us;
+}
+
+void mesh_mock_backend(MeshMockHub* hub, uint8_t index, MeshMockPort* port, MeshBackend* backend) {
+    port->hub = hub;
+    port->index = index;
+    port->sent = 0;
+    backend->send = mock_send;
+    backend->recv = mock_recv;
+    backend->ctx = port;
+}
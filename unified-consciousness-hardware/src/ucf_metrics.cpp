@@ -0,0 +1,275 @@
+/**
+ * @file ucf_metrics.cpp
+ * @brief Metrics storage and export
+ *
+ * Counters and gauges share one word per metric (gauges hold float bits);
+ * histograms have their own slots. All updates are relaxed __atomic
+ * operations on 32-bit words, which are lock-free on the Xtensa cores.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// REGISTRY
+// ============================================================================
+
+static const char* const METRIC_NAMES[METRIC_COUNT] = {
+    // Counters
+    "i2c_errors",
+    "sensor_errors",
+    "validation_errors",
+    "triad_unlocks",
+    "k_formations",
+    "sync_events",
+    "frames_dropped",
+    "events_dropped",
+    "session_dropped",
+    "log_dropped",
+    "output_writes",
+    "output_writes_avoided",
+    "kuramoto_overruns",
+    "kuramoto_steps_dropped",
+    "mesh_lost",
+    "kuramoto_misses",
+
+    // Gauges
+    "loop_rate_hz",
+    "sensor_rate_hz",
+    "order_param",
+    "ota_bytes",
+    "heap_free",
+    "heap_min_free",
+    "mesh_peers",
+
+    // Histograms
+    "sensor_read_us",
+};
+
+static uint32_t g_values[METRIC_FIRST_HISTOGRAM];
+static MetricHistogram g_histograms[METRICS_HISTOGRAM_COUNT];
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline uint32_t load(const uint32_t* p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static inline void add(uint32_t* p, uint32_t n) {
+    __atomic_fetch_add(p, n, __ATOMIC_RELAXED);
+}
+
+static size_t put_varint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static void put_u32(uint8_t* out, uint32_t v) {
+    out[0] = v & 0xFF;
+    out[1] = (v >> 8) & 0xFF;
+    out[2] = (v >> 16) & 0xFF;
+    out[3] = (v >> 24) & 0xFF;
+}
+
+// Worst-case encoded size of one metric
+static size_t max_size(MetricType type) {
+    switch (type) {
+        case METRIC_TYPE_COUNTER: return 5;
+        case METRIC_TYPE_GAUGE: return 4;
+        default: return 5 * (2 + METRICS_HIST_BUCKETS);
+    }
+}
+
+// ============================================================================
+// UPDATE API
+// ============================================================================
+
+void metrics_init(void) {
+    memset(g_values, 0, sizeof(g_values));
+    memset(g_histograms, 0, sizeof(g_histograms));
+}
+
+void metrics_count(MetricId id, uint32_t n) {
+    if (metrics_type(id) == METRIC_TYPE_COUNTER) {
+        add(&g_values[id], n);
+    }
+}
+
+void metrics_set_total(MetricId id, uint32_t total) {
+    if (metrics_type(id) == METRIC_TYPE_COUNTER) {
+        __atomic_store_n(&g_values[id], total, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_set(MetricId id, float value) {
+    if (metrics_type(id) == METRIC_TYPE_GAUGE) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        __atomic_store_n(&g_values[id], bits, __ATOMIC_RELAXED);
+    }
+}
+
+void metrics_observe(MetricId id, uint32_t value) {
+    if (metrics_type(id) != METRIC_TYPE_HISTOGRAM || id >= METRIC_COUNT) {
+        return;
+    }
+    MetricHistogram* h = &g_histograms[id - METRIC_FIRST_HISTOGRAM];
+    add(&h->buckets[metrics_bucket_index(value)], 1);
+    add(&h->sum, value);
+    add(&h->count, 1);
+}
+
+// ============================================================================
+// READ API
+// ============================================================================
+
+MetricType metrics_type(MetricId id) {
+    if (id < METRIC_FIRST_GAUGE) return METRIC_TYPE_COUNTER;
+    if (id < METRIC_FIRST_HISTOGRAM) return METRIC_TYPE_GAUGE;
+    return METRIC_TYPE_HISTOGRAM;
+}
+
+const char* metrics_name(MetricId id) {
+    return id < METRIC_COUNT ? METRIC_NAMES[id] : "unknown";
+}
+
+uint32_t metrics_counter(MetricId id) {
+    if (metrics_type(id) != METRIC_TYPE_COUNTER) {
+        return 0;
+    }
+    return load(&g_values[id]);
+}
+
+float metrics_gauge(MetricId id) {
+    if (metrics_type(id) != METRIC_TYPE_GAUGE) {
+        return 0.0f;
+    }
+    uint32_t bits = load(&g_values[id]);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool metrics_histogram(MetricId id, MetricHistogram* out) {
+    if (metrics_type(id) != METRIC_TYPE_HISTOGRAM || id >= METRIC_COUNT) {
+        return false;
+    }
+    const MetricHistogram* h = &g_histograms[id - METRIC_FIRST_HISTOGRAM];
+    out->count = load(&h->count);
+    out->sum = load(&h->sum);
+    for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        out->buckets[b] = load(&h->buckets[b]);
+    }
+    return true;
+}
+
+uint8_t metrics_bucket_index(uint32_t value) {
+    if (value == 0) {
+        return 0;
+    }
+    uint32_t bits = 32 - __builtin_clz(value);
+    return bits < METRICS_HIST_BUCKETS ? (uint8_t)bits : METRICS_HIST_BUCKETS - 1;
+}
+
+uint32_t metrics_bucket_upper(uint8_t bucket) {
+    if (bucket >= METRICS_HIST_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    return (1u << bucket) - 1;
+}
+
+// ============================================================================
+// EXPORT API
+// ============================================================================
+
+size_t metrics_encode(uint8_t* buffer, size_t capacity, uint32_t uptime_ms) {
+    if (capacity < METRICS_HEADER_SIZE) {
+        return 0;
+    }
+
+    buffer[0] = METRICS_FORMAT_VERSION;
+    buffer[1] = METRIC_COUNT;
+    put_u32(&buffer[2], uptime_ms);
+    size_t n = METRICS_HEADER_SIZE;
+
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        MetricId id = (MetricId)i;
+        MetricType type = metrics_type(id);
+        if (n + max_size(type) > capacity) {
+            return 0;
+        }
+
+        if (type == METRIC_TYPE_COUNTER) {
+            n += put_varint(&buffer[n], metrics_counter(id));
+        } else if (type == METRIC_TYPE_GAUGE) {
+            put_u32(&buffer[n], load(&g_values[id]));
+            n += 4;
+        } else {
+            MetricHistogram h;
+            metrics_histogram(id, &h);
+            n += put_varint(&buffer[n], h.count);
+            n += put_varint(&buffer[n], h.sum);
+            for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+                n += put_varint(&buffer[n], h.buckets[b]);
+            }
+        }
+    }
+    return n;
+}
+
+void metrics_write_text(MetricsLineFn fn, void* ctx) {
+    char line[METRICS_LINE_MAX];
+
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        MetricId id = (MetricId)i;
+        const char* name = METRIC_NAMES[i];
+
+        switch (metrics_type(id)) {
+            case METRIC_TYPE_COUNTER:
+                snprintf(line, sizeof(line), "%s %lu", name, (unsigned long)metrics_counter(id));
+                fn(line, ctx);
+                break;
+
+            case METRIC_TYPE_GAUGE:
+                snprintf(line, sizeof(line), "%s %.3f", name, (double)metrics_gauge(id));
+                fn(line, ctx);
+                break;
+
+            case METRIC_TYPE_HISTOGRAM: {
+                MetricHistogram h;
+                metrics_histogram(id, &h);
+                snprintf(line, sizeof(line), "%s_count %lu", name, (unsigned long)h.count);
+                fn(line, ctx);
+                snprintf(line, sizeof(line), "%s_sum %lu", name, (unsigned long)h.sum);
+                fn(line, ctx);
+
+                // Cumulative buckets up to the last non-empty one, then +Inf
+                int last = -1;
+                for (int b = 0; b < METRICS_HIST_BUCKETS - 1; b++) {
+                    if (h.buckets[b] > 0) last = b;
+                }
+                uint32_t total = 0;
+                for (int b = 0; b <= last; b++) {
+                    total += h.buckets[b];
+                    snprintf(line, sizeof(line), "%s_bucket{le=\"%lu\"} %lu", name,
+                             (unsigned long)metrics_bucket_upper((uint8_t)b), (unsigned long)total);
+                    fn(line, ctx);
+                }
+                snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %lu", name,
+                         (unsigned long)h.count);
+                fn(line, ctx);
+                break;
+            }
+        }
+    }
+}
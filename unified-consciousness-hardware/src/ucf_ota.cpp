@@ -9,15 +9,21 @@
 #ifdef UCF_V4_MODULES
 
 #include "ucf_ota.h"
+#include "ucf_ota_verify.h"
+#include "ucf_ota_delta.h"
+#include "ucf_ota_task.h"
+#include "ucf_checksum.h"
 #include <Arduino.h>
 #include <ArduinoOTA.h>
 #include <Update.h>
-#include <EEPROM.h>
 #include <esp_ota_ops.h>
 #include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <string.h>
 #include "ucf/ucf_config.h"
 #include "ucf/ucf_types.h"
+#include "ucf_storage.h"
 
 // ============================================================================
 // PRIVATE STATE
@@ -31,14 +37,97 @@ static bool g_initialized = false;
 static bool g_enabled = true;
 static bool g_update_in_progress = false;
 
-// Calibration backup storage
-#define CALIBRATION_BACKUP_ADDR     512
+// Streaming verifier, fed as image bytes arrive
+static OTAStreamVerifier g_verifier;
+static LatticeValidation g_last_validation;
+
+// Flash read-back chunk for ArduinoOTA images (no access to the byte stream)
+#define OTA_READBACK_CHUNK          1024
+
+// Delta update: patch decoder reading the running partition
+static OTADeltaDecoder g_delta;
+static bool g_delta_active = false;
+
+// Background transfer task (protocol core, below the control loop)
+#define OTA_BG_TASK_STACK           8192
+#define OTA_BG_TASK_PRIORITY        1
+#define OTA_BG_TASK_CORE            0       // loop() runs on core 1
+#define OTA_BG_MAX_SLEEP_MS         20      // Keeps ArduinoOTA responsive
+#define OTA_BG_PAUSE_POLL_MS        10
+
+static OTATask g_task;
+static TaskHandle_t g_bg_task = NULL;
+static OTATransport g_bg_transport;
+static OTATaskConfig g_bg_pending_config;
+static uint32_t g_bg_config_seq = 0;        // Odd while the loop writes the pending config
+static uint32_t g_bg_config_applied = 0;    // Task-owned: last sequence applied
+static volatile bool g_bg_start_requested = false;
+static volatile bool g_bg_abort_requested = false;
+static volatile bool g_bg_paused = false;   // Requested; the task applies it
+
+// Calibration backup (OTA storage region)
+#define OTA_RESTORE_FLAG            0xCA
+#define OTA_STORAGE_VERSION         1
+
+// Older firmware: calibration at EEPROM 0; after an OTA update, its backup
+// at 512 with the restore flag at 511
+#define OTA_LEGACY_CALIBRATION_ADDR  0
+#define OTA_LEGACY_BACKUP_ADDR       512
+#define OTA_LEGACY_RESTORE_FLAG_ADDR 511
+
+typedef struct {
+    uint8_t restore_flag;           // OTA_RESTORE_FLAG: restore backup after reboot
+    CalibrationData calibration;
+} OTAPersistData;
+
 static bool g_calibration_backed_up = false;
 
 // ============================================================================
 // PRIVATE FUNCTIONS
 // ============================================================================
 
+/**
+ * @brief Mount storage and register the regions OTA touches
+ */
+static bool ota_storage_open(void) {
+    return storage_begin() &&
+           storage_register(STORAGE_REGION_OTA, "ota", sizeof(OTAPersistData), OTA_STORAGE_VERSION) &&
+           storage_register(STORAGE_REGION_CALIBRATION, "calib", sizeof(CalibrationData),
+                            CALIBRATION_VERSION);
+}
+
+/**
+ * @brief Import calibration written by older firmware at fixed EEPROM addresses
+ *
+ * Runs when the store has no calibration yet; a pending legacy OTA restore
+ * takes the backup copy.
+ * @return true if a valid record was found and stored
+ */
+static bool ota_import_legacy_calibration(void) {
+    uint8_t flag = 0;
+    bool restore = storage_legacy_read(OTA_LEGACY_RESTORE_FLAG_ADDR, &flag, 1) &&
+                   flag == OTA_RESTORE_FLAG;
+    uint16_t addr = restore ? OTA_LEGACY_BACKUP_ADDR : OTA_LEGACY_CALIBRATION_ADDR;
+
+    CalibrationData cal;
+    if (!storage_legacy_read(addr, &cal, sizeof(cal)) || cal.magic != CALIBRATION_MAGIC ||
+        checksum_crc32(&cal, sizeof(CalibrationData) - 4) != cal.crc) {
+        return false;
+    }
+
+    Serial.printf("[OTA] Imported calibration from legacy EEPROM%s\n", restore ? " (OTA backup)" : "");
+    return storage_write(STORAGE_REGION_CALIBRATION, &cal, sizeof(cal)) == STORAGE_OK;
+}
+
+/**
+ * @brief Commit pending storage writes, then reboot
+ */
+static void storage_safe_restart(uint32_t delay_ms) {
+    storage_flush();
+    delay(delay_ms);
+    ESP.restart();
+}
+
 /**
  * @brief Reset progress structure
  */
@@ -82,13 +171,8 @@ static void set_error(OTAStatus status, const char* message) {
  * @brief Arduino OTA callbacks
  */
 static void on_ota_start(void) {
-    String type;
-    if (ArduinoOTA.getCommand() == U_FLASH) {
-        type = "firmware";
-    } else {
-        type = "filesystem";
-    }
-    Serial.printf("[OTA] Start updating %s\n", type.c_str());
+    const char* type = (ArduinoOTA.getCommand() == U_FLASH) ? "firmware" : "filesystem";
+    Serial.printf("[OTA] Start updating %s\n", type);
 
     reset_progress();
     g_progress.status = OTA_STATUS_DOWNLOADING;
@@ -101,31 +185,203 @@ static void on_ota_start(void) {
     }
 }
 
-static void on_ota_end(void) {
-    Serial.println("\n[OTA] Download complete, validating...");
-    g_progress.status = OTA_STATUS_VALIDATING;
+/**
+ * @brief Record verifier verdict and notify validation callback
+ * @return true if the image may be booted
+ */
+static bool accept_verified_image(OTAVerifyStatus status) {
+    ota_verify_get_validation(&g_verifier, &g_last_validation);
+    g_last_validation.lattice_checksum = ota_compute_lattice_checksum();
+
+    Serial.printf("[OTA] Verifier: %s (crc32=0x%08X)\n",
+                  ota_verify_status_string(status), g_last_validation.firmware_checksum);
 
-    // Perform lattice validation on new firmware
-    // Note: In Arduino OTA, we can't easily validate before applying
-    // This would need custom OTA implementation for full validation
+    if (status == OTA_VERIFY_ERR_LATTICE) {
+        if (g_config.strict_lattice_check) {
+            set_error(OTA_STATUS_ERROR_LATTICE, "Lattice signature missing");
+            return false;
+        }
+    } else if (status != OTA_VERIFY_ACCEPTED) {
+        set_error(OTA_STATUS_ERROR_CHECKSUM, ota_verify_status_string(status));
+        return false;
+    }
 
+    if (g_validation_callback && !g_validation_callback(&g_last_validation)) {
+        set_error(OTA_STATUS_ERROR_LATTICE, "Validation rejected");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Verify an image ArduinoOTA has already written to flash
+ *
+ * ArduinoOTA does not expose the byte stream, so its images are read back
+ * once through the streaming verifier. Transports that use
+ * ota_stream_write() are verified inline and never take this path.
+ */
+static OTAVerifyStatus verify_written_partition(uint32_t size) {
+    const esp_partition_t* partition = esp_ota_get_next_update_partition(NULL);
+    ota_verify_init(&g_verifier, size, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    if (!partition) {
+        return OTA_VERIFY_ERR_SIZE;
+    }
+
+    uint8_t buffer[OTA_READBACK_CHUNK];
+    OTAVerifyStatus status = OTA_VERIFY_PENDING;
+
+    for (uint32_t offset = 0; offset < size && status == OTA_VERIFY_PENDING; offset += OTA_READBACK_CHUNK) {
+        uint32_t n = (size - offset < OTA_READBACK_CHUNK) ? size - offset : OTA_READBACK_CHUNK;
+        if (esp_partition_read(partition, offset, buffer, n) != ESP_OK) {
+            return OTA_VERIFY_ERR_SIZE;
+        }
+        status = ota_verify_update(&g_verifier, buffer, n);
+    }
+
+    return ota_verify_finish(&g_verifier);
+}
+
+/**
+ * @brief Set post-reboot calibration restore flag and reboot if configured
+ */
+static void finish_successful_update(void) {
     g_progress.status = OTA_STATUS_SUCCESS;
     g_update_in_progress = false;
 
     // Restore calibration after reboot (via flag)
-    if (g_config.preserve_calibration && g_calibration_backed_up) {
-        // Set flag for post-reboot restoration
-        EEPROM.begin(1024);
-        EEPROM.write(511, 0xCA);  // Calibration restore flag
-        EEPROM.commit();
-        EEPROM.end();
+    if (g_config.preserve_calibration && g_calibration_backed_up && ota_storage_open()) {
+        uint8_t flag = OTA_RESTORE_FLAG;
+        storage_write_at(STORAGE_REGION_OTA, offsetof(OTAPersistData, restore_flag), &flag, 1);
     }
+    storage_flush();
 
     Serial.println("[OTA] Update successful, rebooting...");
+
+    if (g_config.auto_reboot) {
+        storage_safe_restart(100);
+    }
+}
+
+static void on_ota_end(void) {
+    Serial.println("\n[OTA] Download complete, validating...");
+    g_progress.status = OTA_STATUS_VALIDATING;
+
+    // Update.end() has already marked the new partition bootable
+    OTAVerifyStatus status = verify_written_partition(g_progress.total_bytes);
+
+    if (!accept_verified_image(status)) {
+        // Keep booting the running image
+        esp_ota_set_boot_partition(esp_ota_get_running_partition());
+        g_update_in_progress = false;
+        Serial.println("[OTA] Update rejected, keeping current firmware");
+        return;
+    }
+
+    finish_successful_update();
+}
+
+/**
+ * @brief Delta patch header received: check the base image, open the update
+ *
+ * The patch only reproduces the new image when applied to the exact build
+ * it was generated from, so the running image is hashed once up front
+ * instead of discovering a mismatch after the whole transfer.
+ */
+static bool delta_begin(const OTADeltaHeader* header, void* ctx) {
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    if (!running || header->old_size > running->size) {
+        set_error(OTA_STATUS_ERROR_SIZE, "Delta base size mismatch");
+        return false;
+    }
+
+    OTASha256 sha;
+    uint8_t buffer[OTA_READBACK_CHUNK];
+    uint8_t digest[OTA_SHA256_SIZE];
+
+    ota_sha256_init(&sha);
+    for (uint32_t offset = 0; offset < header->old_size; offset += OTA_READBACK_CHUNK) {
+        uint32_t n = (header->old_size - offset < OTA_READBACK_CHUNK) ? header->old_size - offset : OTA_READBACK_CHUNK;
+        if (esp_partition_read(running, offset, buffer, n) != ESP_OK) {
+            set_error(OTA_STATUS_ERROR_FLASH, "Delta base read failed");
+            return false;
+        }
+        ota_sha256_update(&sha, buffer, n);
+    }
+    ota_sha256_final(&sha, digest);
+
+    if (memcmp(digest, header->old_sha256, OTA_SHA256_SIZE) != 0) {
+        set_error(OTA_STATUS_ERROR_CHECKSUM, "Delta base mismatch");
+        return false;
+    }
+
+    Serial.printf("[OTA] Delta %u -> %u bytes\n", header->old_size, header->new_size);
+    return ota_stream_begin(header->new_size, header->new_sha256);
+}
+
+static bool delta_read_old(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    return esp_partition_read(esp_ota_get_running_partition(), offset, buf, len) == ESP_OK;
+}
+
+/**
+ * @brief Reconstructed bytes go through the normal verified stream path
+ */
+static bool delta_write_new(const uint8_t* data, size_t len, void* ctx) {
+    OTAStatus status = ota_stream_write(data, len);
+    return status == OTA_STATUS_DOWNLOADING || status == OTA_STATUS_APPLYING;
+}
+
+/**
+ * @brief Abandon a delta update after a decoder error
+ */
+static OTAStatus fail_delta(OTADeltaStatus status) {
+    g_delta_active = false;
+
+    if (g_update_in_progress) {
+        Update.abort();
+        g_update_in_progress = false;
+    }
+
+    // Base and sink failures have already recorded a more specific error
+    if (g_progress.status < OTA_STATUS_ERROR_NETWORK) {
+        set_error(status == OTA_DELTA_ERR_READ ? OTA_STATUS_ERROR_FLASH : OTA_STATUS_ERROR_CHECKSUM,
+                  ota_delta_status_string(status));
+    }
+
+    Serial.printf("[OTA] Delta failed: %s\n", ota_delta_status_string(status));
+    return g_progress.status;
+}
+
+/**
+ * @brief Apply the background budget to an ArduinoOTA transfer
+ *
+ * ArduinoOTA pushes the whole image from inside ArduinoOTA.handle(), calling
+ * on_ota_progress() after every chunk it writes. When that runs on the
+ * background task, sleeping here paces the transfer (TCP flow control holds
+ * the sender back) and implements pause. Pauses longer than the sender's
+ * own timeout abort the transfer; pull transports can pause indefinitely.
+ */
+static void pace_inline_transfer(uint32_t received) {
+    if (g_bg_task == NULL || xTaskGetCurrentTaskHandle() != g_bg_task) {
+        return;
+    }
+
+    while (g_bg_paused) {
+        vTaskDelay(pdMS_TO_TICKS(OTA_BG_PAUSE_POLL_MS));
+    }
+
+    uint32_t bps = g_task.config.bytes_per_sec;
+    uint32_t elapsed_ms = millis() - g_progress.start_time_ms;
+    uint32_t due_ms = bps ? (uint32_t)((uint64_t)received * 1000 / bps) : 0;
+
+    // Always yield at least one tick so the protocol core keeps its idle time
+    vTaskDelay(due_ms > elapsed_ms ? pdMS_TO_TICKS(due_ms - elapsed_ms) : 1);
 }
 
 static void on_ota_progress(unsigned int progress, unsigned int total) {
     update_progress(OTA_STATUS_DOWNLOADING, progress, total);
+    pace_inline_transfer(progress);
 
     static uint8_t last_percent = 0;
     uint8_t percent = (progress * 100) / total;
@@ -135,6 +391,101 @@ static void on_ota_progress(unsigned int progress, unsigned int total) {
     }
 }
 
+/**
+ * @brief Sink for background transfers: the verified stream or patch path
+ */
+static bool bg_sink_begin(const OTATransferInfo* info, void* ctx) {
+    if (info->is_delta) {
+        return ota_patch_begin();
+    }
+    return ota_stream_begin(info->size, info->has_sha256 ? info->sha256 : NULL);
+}
+
+static OTAStatus bg_sink_write(const uint8_t* data, size_t len, void* ctx) {
+    if (!g_task.info.is_delta) {
+        return ota_stream_write(data, len);
+    }
+
+    // Still inside the patch header: nothing has reached flash yet
+    OTAStatus status = ota_patch_write(data, len);
+    return (status == OTA_STATUS_CHECKING) ? OTA_STATUS_DOWNLOADING : status;
+}
+
+static OTAStatus bg_sink_end(void* ctx) {
+    return g_task.info.is_delta ? ota_patch_end() : ota_stream_end();
+}
+
+static uint32_t bg_clock_us(void) {
+    return micros();
+}
+
+/**
+ * @brief Take the config written by ota_background_set_config(), if new
+ *
+ * The loop may be rewriting it while we copy; a changed or odd sequence
+ * means the copy is torn and is taken again on the next pass.
+ */
+static bool take_pending_config(OTATaskConfig* config) {
+    uint32_t seq = __atomic_load_n(&g_bg_config_seq, __ATOMIC_ACQUIRE);
+    if (seq == g_bg_config_applied || (seq & 1)) {
+        return false;
+    }
+    *config = g_bg_pending_config;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&g_bg_config_seq, __ATOMIC_RELAXED) != seq) {
+        return false;
+    }
+    g_bg_config_applied = seq;
+    return true;
+}
+
+/**
+ * @brief Background task body
+ *
+ * Requests from the control loop are applied here so that the transfer
+ * state is only ever modified by this task.
+ */
+static void background_task(void* arg) {
+    static const OTASink sink = { bg_sink_begin, bg_sink_write, bg_sink_end, NULL };
+
+    for (;;) {
+        if (g_bg_abort_requested) {
+            g_bg_abort_requested = false;
+            ota_task_abort(&g_task);
+            ota_abort();
+        }
+
+        OTATaskConfig config;
+        if (take_pending_config(&config)) {
+            ota_task_set_config(&g_task, &config);
+        }
+
+        if (g_bg_start_requested) {
+            g_bg_start_requested = false;
+            if (!ota_task_start(&g_task, &g_bg_transport, &sink)) {
+                Serial.printf("[OTA] Background start failed: %s\n", ota_status_string(g_task.result));
+            }
+        }
+
+        // Both are no-ops once the transfer has finished
+        if (g_bg_paused) {
+            ota_task_pause(&g_task);
+        } else {
+            ota_task_resume(&g_task);
+        }
+
+        if (g_initialized && g_enabled) {
+            ArduinoOTA.handle();
+        }
+
+        uint32_t wait_ms = ota_task_step(&g_task) / 1000;
+        if (wait_ms > OTA_BG_MAX_SLEEP_MS) {
+            wait_ms = OTA_BG_MAX_SLEEP_MS;
+        }
+        vTaskDelay(wait_ms > 0 ? pdMS_TO_TICKS(wait_ms) : 1);
+    }
+}
+
 static void on_ota_error(ota_error_t error) {
     g_update_in_progress = false;
 
@@ -205,20 +556,28 @@ bool ota_init(const OTAConfig* config) {
     ArduinoOTA.onProgress(on_ota_progress);
     ArduinoOTA.onError(on_ota_error);
 
+    // Reboot is deferred until the image has passed verification
+    ArduinoOTA.setRebootOnSuccess(false);
+
     ArduinoOTA.begin();
 
     // Check for calibration restore flag
-    EEPROM.begin(1024);
-    uint8_t restore_flag = EEPROM.read(511);
-    if (restore_flag == 0xCA) {
-        EEPROM.write(511, 0x00);  // Clear flag
-        EEPROM.commit();
-        EEPROM.end();
+    uint8_t restore_flag = 0;
+    if (ota_storage_open() &&
+        storage_read_at(STORAGE_REGION_OTA, offsetof(OTAPersistData, restore_flag),
+                        &restore_flag, 1) == STORAGE_OK &&
+        restore_flag == OTA_RESTORE_FLAG) {
+        restore_flag = 0;  // Clear flag
+        storage_write_at(STORAGE_REGION_OTA, offsetof(OTAPersistData, restore_flag), &restore_flag, 1);
 
         // Restore calibration
         ota_restore_calibration();
-    } else {
-        EEPROM.end();
+    }
+
+    CalibrationData cal;
+    if (ota_storage_open() &&
+        storage_read(STORAGE_REGION_CALIBRATION, &cal, sizeof(cal)) == STORAGE_ERR_NOT_FOUND) {
+        ota_import_legacy_calibration();
     }
 
     g_initialized = true;
@@ -254,6 +613,148 @@ OTAStatus ota_process(void) {
     return g_progress.status;
 }
 
+bool ota_stream_begin(uint32_t size, const uint8_t* expected_sha256) {
+    if (!g_enabled || g_update_in_progress) {
+        return false;
+    }
+
+    if (size == 0 || size > OTA_MAX_FIRMWARE_SIZE) {
+        set_error(OTA_STATUS_ERROR_SIZE, "Image size out of range");
+        return false;
+    }
+
+    if (!Update.begin(size, U_FLASH)) {
+        set_error(OTA_STATUS_ERROR_FLASH, "Begin failed");
+        return false;
+    }
+
+    ota_verify_init(&g_verifier, size, OTA_VERIFY_FLAG_ESP_IMAGE);
+    if (expected_sha256) {
+        ota_verify_set_expected_sha256(&g_verifier, expected_sha256);
+    }
+
+    reset_progress();
+    g_progress.start_time_ms = millis();
+    g_update_in_progress = true;
+    update_progress(OTA_STATUS_DOWNLOADING, 0, size);
+
+    if (g_config.preserve_calibration) {
+        ota_backup_calibration();
+    }
+
+    return true;
+}
+
+OTAStatus ota_stream_write(const uint8_t* data, size_t len) {
+    if (!g_update_in_progress) {
+        return g_progress.status;
+    }
+
+    // Verify first: a rejected chunk never reaches flash
+    OTAVerifyStatus verdict = ota_verify_update(&g_verifier, data, len);
+    if (verdict == OTA_VERIFY_ERR_SIZE || verdict == OTA_VERIFY_ERR_HEADER) {
+        Update.abort();
+        g_update_in_progress = false;
+        set_error(verdict == OTA_VERIFY_ERR_SIZE ? OTA_STATUS_ERROR_SIZE : OTA_STATUS_ERROR_CHECKSUM,
+                  ota_verify_status_string(verdict));
+        return g_progress.status;
+    }
+
+    if (Update.write((uint8_t*)data, len) != len) {
+        Update.abort();
+        g_update_in_progress = false;
+        set_error(OTA_STATUS_ERROR_FLASH, "Write failed");
+        return g_progress.status;
+    }
+
+    update_progress(OTA_STATUS_DOWNLOADING, g_verifier.received, g_progress.total_bytes);
+
+    if (verdict == OTA_VERIFY_PENDING) {
+        return g_progress.status;
+    }
+
+    // Last byte arrived: the verdict decides whether the image becomes bootable
+    g_progress.status = OTA_STATUS_VALIDATING;
+    if (!accept_verified_image(verdict)) {
+        Update.abort();
+        g_update_in_progress = false;
+        return g_progress.status;
+    }
+
+    if (!Update.end(true)) {
+        g_update_in_progress = false;
+        set_error(OTA_STATUS_ERROR_FLASH, "End failed");
+        return g_progress.status;
+    }
+
+    g_progress.status = OTA_STATUS_APPLYING;
+    return g_progress.status;
+}
+
+OTAStatus ota_stream_end(void) {
+    if (!g_update_in_progress) {
+        return g_progress.status;
+    }
+
+    if (g_progress.status == OTA_STATUS_APPLYING) {
+        finish_successful_update();
+        return g_progress.status;
+    }
+
+    // Stream closed before the announced size was reached
+    Update.abort();
+    g_update_in_progress = false;
+    set_error(OTA_STATUS_ERROR_SIZE, "Image truncated");
+    return g_progress.status;
+}
+
+bool ota_patch_begin(void) {
+    if (!g_enabled || g_update_in_progress || g_delta_active) {
+        return false;
+    }
+
+    static const OTADeltaIO io = { delta_begin, delta_read_old, delta_write_new, NULL };
+    ota_delta_init(&g_delta, &io);
+
+    reset_progress();
+    g_progress.status = OTA_STATUS_CHECKING;
+    g_progress.start_time_ms = millis();
+    g_delta_active = true;
+
+    return true;
+}
+
+OTAStatus ota_patch_write(const uint8_t* data, size_t len) {
+    if (!g_delta_active) {
+        return g_progress.status;
+    }
+
+    OTADeltaStatus status = ota_delta_update(&g_delta, data, len);
+    if (status != OTA_DELTA_PENDING && status != OTA_DELTA_DONE) {
+        return fail_delta(status);
+    }
+
+    return g_progress.status;
+}
+
+OTAStatus ota_patch_end(void) {
+    if (!g_delta_active) {
+        return g_progress.status;
+    }
+
+    OTADeltaStatus status = ota_delta_finish(&g_delta);
+    if (status != OTA_DELTA_DONE) {
+        return fail_delta(status);
+    }
+
+    g_delta_active = false;
+    return ota_stream_end();
+}
+
+const LatticeValidation* ota_get_last_validation(void) {
+    return &g_last_validation;
+}
+
 LatticeValidation ota_validate_firmware(void) {
     LatticeValidation validation;
     memset(&validation, 0, sizeof(validation));
@@ -310,14 +811,15 @@ bool ota_apply_update(void) {
     g_progress.status = OTA_STATUS_APPLYING;
 
     if (g_config.auto_reboot) {
-        delay(500);
-        ESP.restart();
+        storage_safe_restart(500);
     }
 
     return true;
 }
 
 void ota_abort(void) {
+    g_delta_active = false;
+
     if (g_update_in_progress) {
         Update.abort();
         g_update_in_progress = false;
@@ -346,29 +848,93 @@ bool ota_is_enabled(void) {
 }
 
 void ota_handle(void) {
-    if (g_initialized && g_enabled) {
+    // The background task owns ArduinoOTA once started
+    if (g_bg_task == NULL && g_initialized && g_enabled) {
         ArduinoOTA.handle();
     }
 }
 
+// ============================================================================
+// BACKGROUND TRANSFER
+// ============================================================================
+
+bool ota_background_init(const OTATaskConfig* config) {
+    if (g_bg_task != NULL) {
+        return true;
+    }
+
+    ota_task_init(&g_task, config, bg_clock_us);
+
+    BaseType_t created = xTaskCreatePinnedToCore(background_task, "ucf_ota", OTA_BG_TASK_STACK,
+                                                 NULL, OTA_BG_TASK_PRIORITY, &g_bg_task,
+                                                 OTA_BG_TASK_CORE);
+    if (created != pdPASS) {
+        g_bg_task = NULL;
+        return false;
+    }
+
+    UCF_LOG("OTA background task on core %d", OTA_BG_TASK_CORE);
+    return true;
+}
+
+bool ota_background_start(const OTATransport* transport) {
+    if (g_bg_task == NULL || g_bg_start_requested || ota_background_busy()) {
+        return false;
+    }
+
+    g_bg_transport = *transport;
+    g_bg_start_requested = true;
+    return true;
+}
+
+bool ota_background_busy(void) {
+    OTATaskState state = ota_task_get_state(&g_task);
+    return state == OTA_TASK_RUNNING || state == OTA_TASK_PAUSED || g_update_in_progress;
+}
+
+void ota_background_pause(void) {
+    g_bg_paused = true;
+}
+
+void ota_background_resume(void) {
+    g_bg_paused = false;
+}
+
+bool ota_background_is_paused(void) {
+    return g_bg_paused;
+}
+
+void ota_background_abort(void) {
+    g_bg_paused = false;
+    g_bg_abort_requested = true;
+}
+
+void ota_background_set_config(const OTATaskConfig* config) {
+    __atomic_add_fetch(&g_bg_config_seq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    g_bg_pending_config = *config;
+    __atomic_add_fetch(&g_bg_config_seq, 1, __ATOMIC_RELEASE);
+}
+
+const OTATaskStats* ota_background_get_stats(void) {
+    return &g_task.stats;
+}
+
 // ============================================================================
 // LATTICE VALIDATION FUNCTIONS
 // ============================================================================
 
 LatticeValidation ota_validate_lattice(const uint8_t* firmware_start, uint32_t firmware_size) {
     LatticeValidation validation;
-    memset(&validation, 0, sizeof(validation));
-
-    // Search for lattice signature in firmware
-    uint32_t sig_offset;
-    if (!ota_find_lattice_signature(firmware_start, firmware_size, &sig_offset)) {
-        return validation;  // Invalid - no signature found
-    }
 
-    // Validate individual constants (would need to know exact offsets)
-    // This is a simplified implementation
+    // Same single-pass matcher used during download
+    OTAStreamVerifier verifier;
+    ota_verify_init(&verifier, firmware_size, 0);
+    ota_verify_update(&verifier, firmware_start, firmware_size);
+    ota_verify_finish(&verifier);
 
-    validation.valid = true;  // Placeholder
+    ota_verify_get_validation(&verifier, &validation);
+    validation.lattice_checksum = ota_compute_lattice_checksum();
     return validation;
 }
 
@@ -383,23 +949,7 @@ uint32_t ota_compute_lattice_checksum(void) {
         (float)LAMBDA_R_SQ, (float)LAMBDA_A_SQ
     };
 
-    // Simple checksum
-    uint32_t checksum = 0xFFFFFFFF;
-    uint8_t* bytes = (uint8_t*)constants;
-    size_t len = sizeof(constants);
-
-    for (size_t i = 0; i < len; i++) {
-        checksum ^= bytes[i];
-        for (int j = 0; j < 8; j++) {
-            if (checksum & 1) {
-                checksum = (checksum >> 1) ^ 0xEDB88320;
-            } else {
-                checksum >>= 1;
-            }
-        }
-    }
-
-    return ~checksum;
+    return checksum_crc32(constants, sizeof(constants));
 }
 
 bool ota_find_lattice_signature(const uint8_t* firmware_start, uint32_t firmware_size,
@@ -407,7 +957,7 @@ bool ota_find_lattice_signature(const uint8_t* firmware_start, uint32_t firmware
     // Search for "RRRR" magic
     const uint8_t magic[4] = {'R', 'R', 'R', 'R'};
 
-    for (uint32_t i = 0; i < firmware_size - 4; i++) {
+    for (uint32_t i = 0; i + 4 <= firmware_size; i++) {
         if (memcmp(firmware_start + i, magic, 4) == 0) {
             *signature_offset = i;
             return true;
@@ -434,16 +984,19 @@ float ota_validate_z_critical(const uint8_t* firmware_start, uint32_t offset) {
 // ============================================================================
 
 bool ota_backup_calibration(void) {
-    CalibrationData cal;
+    OTAPersistData persist;
 
     // Read current calibration
-    EEPROM.begin(1024);
-    EEPROM.get(0, cal);
+    if (!ota_storage_open() ||
+        storage_read(STORAGE_REGION_CALIBRATION, &persist.calibration,
+                     sizeof(CalibrationData)) != STORAGE_OK) {
+        Serial.println("[OTA] No calibration to back up");
+        return false;
+    }
 
-    // Write to backup location
-    EEPROM.put(CALIBRATION_BACKUP_ADDR, cal);
-    bool success = EEPROM.commit();
-    EEPROM.end();
+    // Backup region is committed with the next flush (before any reboot)
+    persist.restore_flag = 0;
+    bool success = storage_write(STORAGE_REGION_OTA, &persist, sizeof(persist)) == STORAGE_OK;
 
     if (success) {
         g_calibration_backed_up = true;
@@ -454,22 +1007,19 @@ bool ota_backup_calibration(void) {
 }
 
 bool ota_restore_calibration(void) {
-    CalibrationData cal;
-
-    EEPROM.begin(1024);
-    EEPROM.get(CALIBRATION_BACKUP_ADDR, cal);
+    OTAPersistData persist;
 
     // Verify magic
-    if (cal.magic != CALIBRATION_MAGIC) {
-        EEPROM.end();
+    if (!ota_storage_open() ||
+        storage_read(STORAGE_REGION_OTA, &persist, sizeof(persist)) != STORAGE_OK ||
+        persist.calibration.magic != CALIBRATION_MAGIC) {
         Serial.println("[OTA] No valid calibration backup found");
         return false;
     }
 
     // Restore to main location
-    EEPROM.put(0, cal);
-    bool success = EEPROM.commit();
-    EEPROM.end();
+    bool success = storage_write(STORAGE_REGION_CALIBRATION, &persist.calibration,
+                                 sizeof(CalibrationData)) == STORAGE_OK;
 
     if (success) {
         Serial.println("[OTA] Calibration restored");
@@ -479,13 +1029,11 @@ bool ota_restore_calibration(void) {
 }
 
 bool ota_has_calibration_backup(void) {
-    CalibrationData cal;
+    OTAPersistData persist;
 
-    EEPROM.begin(1024);
-    EEPROM.get(CALIBRATION_BACKUP_ADDR, cal);
-    EEPROM.end();
-
-    return (cal.magic == CALIBRATION_MAGIC);
+    return ota_storage_open() &&
+           storage_read(STORAGE_REGION_OTA, &persist, sizeof(persist)) == STORAGE_OK &&
+           persist.calibration.magic == CALIBRATION_MAGIC;
 }
 
 // ============================================================================
@@ -527,8 +1075,7 @@ void ota_get_partition_info(char* label, uint32_t* size) {
 
 void ota_reboot(void) {
     Serial.println("[OTA] Rebooting...");
-    delay(100);
-    ESP.restart();
+    storage_safe_restart(100);
 }
 
 #endif // UCF_V4_MODULES
@@ -0,0 +1,338 @@
+/**
+ * @file ucf_ota_delta.cpp
+ * @brief UCF Delta OTA Patch Decoder Implementation v4.0.0
+ *
+ * Push parser for UCFD patches with a fixed-size output block.
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_ota_delta.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE DEFINITIONS
+// ============================================================================
+
+// Parser states
+enum {
+    DELTA_STATE_HEADER = 0,
+    DELTA_STATE_OPCODE,
+    DELTA_STATE_VARINT,
+    DELTA_STATE_DATA,
+    DELTA_STATE_END
+};
+
+#define VARINT_MAX_SHIFT    28      // 5 bytes cover uint32_t
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void write_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline OTADeltaStatus fail(OTADeltaDecoder* d, OTADeltaStatus status) {
+    d->status = status;
+    return status;
+}
+
+/**
+ * @brief Hand the output block to the sink
+ */
+static bool flush_block(OTADeltaDecoder* d) {
+    if (d->block_len == 0) {
+        return true;
+    }
+    if (!d->io.write_new(d->block, d->block_len, d->io.ctx)) {
+        return false;
+    }
+    d->block_len = 0;
+    return true;
+}
+
+/**
+ * @brief Reserve up to len bytes of output block space
+ * @return Bytes available (0 on error, status set)
+ */
+static uint32_t reserve(OTADeltaDecoder* d, uint32_t len) {
+    if (d->block_len == OTA_DELTA_BLOCK_SIZE && !flush_block(d)) {
+        fail(d, OTA_DELTA_ERR_WRITE);
+        return 0;
+    }
+
+    uint32_t space = OTA_DELTA_BLOCK_SIZE - d->block_len;
+    uint32_t n = (len < space) ? len : space;
+
+    if (d->new_pos + n > d->header.new_size) {
+        fail(d, OTA_DELTA_ERR_RANGE);
+        return 0;
+    }
+    return n;
+}
+
+/**
+ * @brief Append n old-image bytes at the cursor to the output block
+ */
+static bool load_old(OTADeltaDecoder* d, uint32_t n) {
+    if (d->old_pos + n > d->header.old_size || d->old_pos + n < d->old_pos) {
+        fail(d, OTA_DELTA_ERR_RANGE);
+        return false;
+    }
+    if (!d->io.read_old(d->old_pos, d->block + d->block_len, n, d->io.ctx)) {
+        fail(d, OTA_DELTA_ERR_READ);
+        return false;
+    }
+    d->old_pos += n;
+    return true;
+}
+
+/**
+ * @brief Execute COPY entirely from the old image
+ */
+static bool run_copy(OTADeltaDecoder* d, uint32_t len) {
+    while (len > 0) {
+        uint32_t n = reserve(d, len);
+        if (n == 0 || !load_old(d, n)) {
+            return false;
+        }
+        d->block_len += n;
+        d->new_pos += n;
+        len -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Apply an operation whose arguments are complete
+ */
+static bool start_op(OTADeltaDecoder* d, uint32_t arg) {
+    switch (d->opcode) {
+        case OTA_DELTA_OP_COPY:
+            if (!run_copy(d, arg)) {
+                return false;
+            }
+            d->state = DELTA_STATE_OPCODE;
+            return true;
+
+        case OTA_DELTA_OP_ADD:
+        case OTA_DELTA_OP_INSERT:
+            d->remaining = arg;
+            d->state = (arg > 0) ? DELTA_STATE_DATA : DELTA_STATE_OPCODE;
+            return true;
+
+        case OTA_DELTA_OP_SEEK: {
+            // Zigzag decode
+            int32_t delta = (int32_t)(arg >> 1) ^ -(int32_t)(arg & 1);
+            int64_t pos = (int64_t)d->old_pos + delta;
+            if (pos < 0 || pos > (int64_t)d->header.old_size) {
+                fail(d, OTA_DELTA_ERR_RANGE);
+                return false;
+            }
+            d->old_pos = (uint32_t)pos;
+            d->state = DELTA_STATE_OPCODE;
+            return true;
+        }
+    }
+
+    fail(d, OTA_DELTA_ERR_FORMAT);
+    return false;
+}
+
+/**
+ * @brief Consume ADD/INSERT payload bytes
+ * @return Bytes consumed (0 on error)
+ */
+static size_t consume_data(OTADeltaDecoder* d, const uint8_t* data, size_t len) {
+    size_t consumed = 0;
+
+    while (consumed < len && d->remaining > 0) {
+        uint32_t want = d->remaining;
+        if (want > len - consumed) {
+            want = (uint32_t)(len - consumed);
+        }
+
+        uint32_t n = reserve(d, want);
+        if (n == 0) {
+            return 0;
+        }
+
+        uint8_t* out = d->block + d->block_len;
+        if (d->opcode == OTA_DELTA_OP_ADD) {
+            if (!load_old(d, n)) {
+                return 0;
+            }
+            for (uint32_t i = 0; i < n; i++) {
+                out[i] = (uint8_t)(out[i] + data[consumed + i]);
+            }
+        } else {
+            memcpy(out, data + consumed, n);
+        }
+
+        d->block_len += n;
+        d->new_pos += n;
+        d->remaining -= n;
+        consumed += n;
+    }
+
+    if (d->remaining == 0) {
+        d->state = DELTA_STATE_OPCODE;
+    }
+    return consumed;
+}
+
+/**
+ * @brief Handle END: flush and check the reconstructed size
+ */
+static OTADeltaStatus finish_patch(OTADeltaDecoder* d) {
+    if (!flush_block(d)) {
+        return fail(d, OTA_DELTA_ERR_WRITE);
+    }
+    if (d->new_pos != d->header.new_size) {
+        return fail(d, OTA_DELTA_ERR_RANGE);
+    }
+    d->state = DELTA_STATE_END;
+    d->status = OTA_DELTA_DONE;
+    return d->status;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void ota_delta_init(OTADeltaDecoder* d, const OTADeltaIO* io) {
+    memset(d, 0, sizeof(*d));
+    d->io = *io;
+    d->state = DELTA_STATE_HEADER;
+    d->status = OTA_DELTA_PENDING;
+}
+
+OTADeltaStatus ota_delta_update(OTADeltaDecoder* d, const uint8_t* data, size_t len) {
+    size_t i = 0;
+
+    if (d->status != OTA_DELTA_PENDING) {
+        // Anything after END is a malformed patch
+        return (d->status == OTA_DELTA_DONE && len > 0) ? fail(d, OTA_DELTA_ERR_FORMAT) : d->status;
+    }
+
+    d->patch_bytes += (uint32_t)len;
+
+    while (i < len) {
+        switch (d->state) {
+            case DELTA_STATE_HEADER: {
+                size_t n = OTA_DELTA_HEADER_SIZE - d->header_len;
+                if (n > len - i) {
+                    n = len - i;
+                }
+                memcpy(d->header_buf + d->header_len, data + i, n);
+                d->header_len += (uint8_t)n;
+                i += n;
+
+                if (d->header_len == OTA_DELTA_HEADER_SIZE) {
+                    if (!ota_delta_decode_header(d->header_buf, &d->header)) {
+                        return fail(d, OTA_DELTA_ERR_HEADER);
+                    }
+                    if (d->io.begin && !d->io.begin(&d->header, d->io.ctx)) {
+                        return fail(d, OTA_DELTA_ERR_BASE);
+                    }
+                    d->state = DELTA_STATE_OPCODE;
+                }
+                break;
+            }
+
+            case DELTA_STATE_OPCODE:
+                d->opcode = data[i++];
+                if (d->opcode == OTA_DELTA_OP_END) {
+                    if (finish_patch(d) == OTA_DELTA_DONE && i < len) {
+                        return fail(d, OTA_DELTA_ERR_FORMAT);
+                    }
+                    return d->status;
+                }
+                if (d->opcode > OTA_DELTA_OP_SEEK) {
+                    return fail(d, OTA_DELTA_ERR_FORMAT);
+                }
+                d->varint = 0;
+                d->varint_shift = 0;
+                d->state = DELTA_STATE_VARINT;
+                break;
+
+            case DELTA_STATE_VARINT: {
+                uint8_t b = data[i++];
+                if (d->varint_shift > VARINT_MAX_SHIFT ||
+                    (d->varint_shift == VARINT_MAX_SHIFT && (b & 0xF0))) {
+                    return fail(d, OTA_DELTA_ERR_FORMAT);
+                }
+                d->varint |= (uint32_t)(b & 0x7F) << d->varint_shift;
+                d->varint_shift += 7;
+                if ((b & 0x80) == 0 && !start_op(d, d->varint)) {
+                    return d->status;
+                }
+                break;
+            }
+
+            case DELTA_STATE_DATA: {
+                size_t n = consume_data(d, data + i, len - i);
+                if (n == 0) {
+                    return d->status;
+                }
+                i += n;
+                break;
+            }
+        }
+    }
+
+    return d->status;
+}
+
+OTADeltaStatus ota_delta_finish(OTADeltaDecoder* d) {
+    if (d->status == OTA_DELTA_PENDING) {
+        return fail(d, OTA_DELTA_ERR_TRUNCATED);
+    }
+    return d->status;
+}
+
+void ota_delta_encode_header(const OTADeltaHeader* header, uint8_t* out) {
+    write_le32(out, header->magic);
+    out[4] = (uint8_t)header->version;
+    out[5] = (uint8_t)(header->version >> 8);
+    out[6] = (uint8_t)header->flags;
+    out[7] = (uint8_t)(header->flags >> 8);
+    write_le32(out + 8, header->old_size);
+    write_le32(out + 12, header->new_size);
+    memcpy(out + 16, header->old_sha256, OTA_DELTA_DIGEST_SIZE);
+    memcpy(out + 48, header->new_sha256, OTA_DELTA_DIGEST_SIZE);
+}
+
+bool ota_delta_decode_header(const uint8_t* in, OTADeltaHeader* header) {
+    header->magic = read_le32(in);
+    header->version = (uint16_t)(in[4] | (in[5] << 8));
+    header->flags = (uint16_t)(in[6] | (in[7] << 8));
+    header->old_size = read_le32(in + 8);
+    header->new_size = read_le32(in + 12);
+    memcpy(header->old_sha256, in + 16, OTA_DELTA_DIGEST_SIZE);
+    memcpy(header->new_sha256, in + 48, OTA_DELTA_DIGEST_SIZE);
+
+    return header->magic == OTA_DELTA_MAGIC && header->version == OTA_DELTA_VERSION;
+}
+
+const char* ota_delta_status_string(OTADeltaStatus status) {
+    switch (status) {
+        case OTA_DELTA_PENDING:       return "Pending";
+        case OTA_DELTA_DONE:          return "Done";
+        case OTA_DELTA_ERR_HEADER:    return "Bad patch header";
+        case OTA_DELTA_ERR_BASE:      return "Base image mismatch";
+        case OTA_DELTA_ERR_FORMAT:    return "Malformed patch";
+        case OTA_DELTA_ERR_RANGE:     return "Patch out of range";
+        case OTA_DELTA_ERR_READ:      return "Base read failed";
+        case OTA_DELTA_ERR_WRITE:     return "Output write failed";
+        case OTA_DELTA_ERR_TRUNCATED: return "Patch truncated";
+        default:                      return "Unknown";
+    }
+}
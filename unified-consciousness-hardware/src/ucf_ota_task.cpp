@@ -0,0 +1,274 @@
+/**
+ * @file ucf_ota_task.cpp
+ * @brief UCF Background OTA Transfer Scheduler Implementation v4.0.0
+ *
+ * Budgeted, pausable transfer slices between a transport and a sink.
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_ota_task.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline bool time_reached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * @brief Clamp a configuration to valid ranges
+ */
+static void sanitize_config(OTATaskConfig* c) {
+    if (c->chunk_size == 0 || c->chunk_size > OTA_TASK_MAX_CHUNK) {
+        c->chunk_size = OTA_TASK_MAX_CHUNK;
+    }
+    if (c->duty_percent == 0 || c->duty_percent > 100) {
+        c->duty_percent = 100;
+    }
+    if (c->slice_us == 0) {
+        c->slice_us = OTA_TASK_DEFAULT_SLICE_US;
+    }
+}
+
+/**
+ * @brief Credit the token bucket for time elapsed since the last refill
+ *
+ * The bucket holds at most one chunk, so a transfer that was starved or
+ * paused cannot burst past its budget afterwards.
+ */
+static void refill_tokens(OTATask* t, uint32_t now) {
+    if (t->config.bytes_per_sec == 0) {
+        t->tokens = t->config.chunk_size;
+        return;
+    }
+
+    uint64_t elapsed = (uint32_t)(now - t->last_refill_us);
+    uint64_t credit = elapsed * t->config.bytes_per_sec / 1000000ull;
+    if (credit == 0) {
+        return;
+    }
+
+    t->last_refill_us += (uint32_t)(credit * 1000000ull / t->config.bytes_per_sec);
+    t->tokens = (credit + t->tokens > t->config.chunk_size) ? t->config.chunk_size
+                                                           : t->tokens + (uint32_t)credit;
+    if (t->tokens == t->config.chunk_size) {
+        t->last_refill_us = now;
+    }
+}
+
+/**
+ * @brief Time until the bucket holds a full chunk
+ */
+static uint32_t token_wait_us(const OTATask* t) {
+    if (t->config.bytes_per_sec == 0 || t->tokens >= t->config.chunk_size) {
+        return 0;
+    }
+    uint64_t missing = t->config.chunk_size - t->tokens;
+    return (uint32_t)((missing * 1000000ull + t->config.bytes_per_sec - 1) / t->config.bytes_per_sec);
+}
+
+/**
+ * @brief Close the transport and record the outcome
+ */
+static void finish(OTATask* t, OTATaskState state, OTAStatus result) {
+    if (t->transport.close) {
+        t->transport.close(t->transport.ctx);
+    }
+    t->result = result;
+    t->state = state;
+}
+
+/**
+ * @brief Transport reached end of stream: let the sink decide
+ */
+static void finish_stream(OTATask* t) {
+    OTAStatus status = t->sink.end(t->sink.ctx);
+    bool ok = (status == OTA_STATUS_SUCCESS || status == OTA_STATUS_APPLYING);
+    finish(t, ok ? OTA_TASK_DONE : OTA_TASK_FAILED, status);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void ota_task_default_config(OTATaskConfig* config) {
+    config->chunk_size = OTA_TASK_DEFAULT_CHUNK;
+    config->bytes_per_sec = OTA_TASK_DEFAULT_BPS;
+    config->slice_us = OTA_TASK_DEFAULT_SLICE_US;
+    config->duty_percent = OTA_TASK_DEFAULT_DUTY;
+}
+
+void ota_task_init(OTATask* t, const OTATaskConfig* config, uint32_t (*clock_us)(void)) {
+    memset(t, 0, sizeof(*t));
+    if (config) {
+        t->config = *config;
+    } else {
+        ota_task_default_config(&t->config);
+    }
+    sanitize_config(&t->config);
+    t->clock_us = clock_us;
+    t->state = OTA_TASK_IDLE;
+    t->result = OTA_STATUS_IDLE;
+}
+
+void ota_task_set_config(OTATask* t, const OTATaskConfig* config) {
+    t->config = *config;
+    sanitize_config(&t->config);
+    if (t->tokens > t->config.chunk_size) {
+        t->tokens = t->config.chunk_size;
+    }
+}
+
+bool ota_task_start(OTATask* t, const OTATransport* transport, const OTASink* sink) {
+    if (t->state == OTA_TASK_RUNNING || t->state == OTA_TASK_PAUSED) {
+        return false;
+    }
+
+    t->transport = *transport;
+    t->sink = *sink;
+    memset(&t->info, 0, sizeof(t->info));
+    memset(&t->stats, 0, sizeof(t->stats));
+
+    if (!t->transport.open(&t->info, t->transport.ctx)) {
+        t->result = OTA_STATUS_ERROR_NETWORK;
+        t->state = OTA_TASK_FAILED;
+        return false;
+    }
+
+    if (!t->sink.begin(&t->info, t->sink.ctx)) {
+        finish(t, OTA_TASK_FAILED, OTA_STATUS_ERROR_FLASH);
+        return false;
+    }
+
+    uint32_t now = t->clock_us();
+    t->tokens = 0;
+    t->last_refill_us = now;
+    t->next_run_us = now;
+    t->result = OTA_STATUS_DOWNLOADING;
+    t->state = OTA_TASK_RUNNING;
+    return true;
+}
+
+uint32_t ota_task_step(OTATask* t) {
+    if (t->state != OTA_TASK_RUNNING) {
+        return OTA_TASK_POLL_US;
+    }
+
+    uint32_t start = t->clock_us();
+    if (!time_reached(start, t->next_run_us)) {
+        return t->next_run_us - start;
+    }
+
+    refill_tokens(t, start);
+
+    bool starved = false;
+    bool worked = false;
+    uint32_t now = start;
+
+    while (t->state == OTA_TASK_RUNNING && now - start < t->config.slice_us) {
+        uint32_t want = t->config.chunk_size;
+        if (t->config.bytes_per_sec > 0 && t->tokens < want) {
+            want = t->tokens;
+        }
+        if (want == 0) {
+            break;
+        }
+
+        int32_t n = t->transport.read(t->buffer, want, t->transport.ctx);
+        if (n == OTA_TRANSPORT_WOULD_BLOCK) {
+            starved = true;
+            break;
+        }
+        if (n == OTA_TRANSPORT_EOF) {
+            finish_stream(t);
+            break;
+        }
+        if (n < 0 || (uint32_t)n > want) {
+            t->sink.end(t->sink.ctx);
+            finish(t, OTA_TASK_FAILED, OTA_STATUS_ERROR_NETWORK);
+            break;
+        }
+
+        worked = true;
+        if (t->config.bytes_per_sec > 0) {
+            t->tokens -= (uint32_t)n;
+        }
+        t->stats.bytes += (uint32_t)n;
+
+        OTAStatus status = t->sink.write(t->buffer, (size_t)n, t->sink.ctx);
+        if (status != OTA_STATUS_DOWNLOADING && status != OTA_STATUS_APPLYING) {
+            finish(t, OTA_TASK_FAILED, status);
+            break;
+        }
+        t->result = status;
+
+        now = t->clock_us();
+    }
+
+    now = t->clock_us();
+    uint32_t busy = now - start;
+
+    if (worked) {
+        t->stats.slices++;
+        t->stats.busy_us += busy;
+        if (busy > t->stats.max_slice_us) {
+            t->stats.max_slice_us = busy;
+        }
+    }
+
+    if (t->state != OTA_TASK_RUNNING) {
+        return (t->state == OTA_TASK_PAUSED) ? OTA_TASK_POLL_US : 0;
+    }
+
+    // CPU share: a slice of b us is followed by b * (100 - d) / d us of rest
+    uint32_t rest = (uint32_t)((uint64_t)busy * (100 - t->config.duty_percent) / t->config.duty_percent);
+    uint32_t wait = token_wait_us(t);
+    if (starved) {
+        t->stats.starved++;
+        wait = OTA_TASK_STARVED_US;
+    }
+    if (rest > wait) {
+        wait = rest;
+    }
+
+    t->next_run_us = now + wait;
+    return wait;
+}
+
+void ota_task_pause(OTATask* t) {
+    if (t->state == OTA_TASK_RUNNING) {
+        t->state = OTA_TASK_PAUSED;
+    }
+}
+
+void ota_task_resume(OTATask* t) {
+    if (t->state == OTA_TASK_PAUSED) {
+        // No credit for the paused interval
+        t->last_refill_us = t->clock_us();
+        t->next_run_us = t->last_refill_us;
+        t->state = OTA_TASK_RUNNING;
+    }
+}
+
+void ota_task_abort(OTATask* t) {
+    if (t->state == OTA_TASK_RUNNING || t->state == OTA_TASK_PAUSED) {
+        finish(t, OTA_TASK_FAILED, OTA_STATUS_ERROR_NETWORK);
+    }
+}
+
+OTATaskState ota_task_get_state(const OTATask* t) {
+    return (OTATaskState)t->state;
+}
+
+const char* ota_task_state_string(OTATaskState state) {
+    switch (state) {
+        case OTA_TASK_IDLE:    return "Idle";
+        case OTA_TASK_RUNNING: return "Running";
+        case OTA_TASK_PAUSED:  return "Paused";
+        case OTA_TASK_DONE:    return "Done";
+        case OTA_TASK_FAILED:  return "Failed";
+        default:               return "Unknown";
+    }
+}
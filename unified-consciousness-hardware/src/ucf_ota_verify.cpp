@@ -0,0 +1,374 @@
+/**
+ * @file ucf_ota_verify.cpp
+ * @brief UCF Streaming OTA Image Verifier Implementation v4.0.0
+ *
+ * Single-pass verification of firmware images during download.
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_ota_verify.h"
+#include "ucf_checksum.h"
+#include <string.h>
+
+// ============================================================================
+// EMBEDDED LATTICE SIGNATURE
+// ============================================================================
+
+#define OTA_SIGNATURE_VERSION   1
+
+/**
+ * Signature block searched for by ota_verify_update() in incoming images.
+ * Marked used so the linker keeps it even though nothing references it.
+ */
+__attribute__((used))
+static const OTALatticeSignature g_lattice_signature = {
+    LATTICE_SIGNATURE_MAGIC,
+    OTA_SIGNATURE_VERSION,
+    LATTICE_EXPECTED_PHI_INV,
+    LATTICE_EXPECTED_Z_CRITICAL,
+    LATTICE_EXPECTED_EULER_INV,
+    LATTICE_EXPECTED_PI_INV,
+    LATTICE_EXPECTED_SQRT2_INV
+};
+
+// Pattern slots (bit index in found_mask)
+enum {
+    PATTERN_MAGIC = 0,
+    PATTERN_PHI_INV,
+    PATTERN_Z_CRITICAL,
+    PATTERN_EULER_INV,
+    PATTERN_PI_INV,
+    PATTERN_SQRT2_INV
+};
+
+// ============================================================================
+// SHA-256
+// ============================================================================
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr32(uint32_t x, uint8_t n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+/**
+ * @brief Compress one 64-byte block into the hash state
+ */
+static void sha256_transform(uint32_t* state, const uint8_t* block) {
+    uint32_t w[64];
+
+    for (uint8_t i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) |
+               ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) |
+               ((uint32_t)block[i * 4 + 3]);
+    }
+
+    for (uint8_t i = 16; i < 64; i++) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (uint8_t i = 0; i < 64; i++) {
+        uint32_t S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + S1 + ch + SHA256_K[i] + w[i];
+        uint32_t S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void ota_sha256_init(OTASha256* ctx) {
+    static const uint32_t H0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, H0, sizeof(H0));
+    ctx->bit_count = 0;
+    ctx->buffer_len = 0;
+}
+
+void ota_sha256_update(OTASha256* ctx, const uint8_t* data, size_t len) {
+    ctx->bit_count += (uint64_t)len * 8;
+
+    // Top up a partial block first
+    if (ctx->buffer_len > 0) {
+        size_t take = 64 - ctx->buffer_len;
+        if (take > len) take = len;
+        memcpy(ctx->buffer + ctx->buffer_len, data, take);
+        ctx->buffer_len += take;
+        data += take;
+        len -= take;
+
+        if (ctx->buffer_len < 64) return;
+        sha256_transform(ctx->state, ctx->buffer);
+        ctx->buffer_len = 0;
+    }
+
+    // Whole blocks straight from the caller's buffer
+    while (len >= 64) {
+        sha256_transform(ctx->state, data);
+        data += 64;
+        len -= 64;
+    }
+
+    if (len > 0) {
+        memcpy(ctx->buffer, data, len);
+        ctx->buffer_len = (uint8_t)len;
+    }
+}
+
+void ota_sha256_final(OTASha256* ctx, uint8_t* digest) {
+    uint64_t bits = ctx->bit_count;
+
+    ctx->buffer[ctx->buffer_len++] = 0x80;
+    if (ctx->buffer_len > 56) {
+        memset(ctx->buffer + ctx->buffer_len, 0, 64 - ctx->buffer_len);
+        sha256_transform(ctx->state, ctx->buffer);
+        ctx->buffer_len = 0;
+    }
+    memset(ctx->buffer + ctx->buffer_len, 0, 56 - ctx->buffer_len);
+
+    for (uint8_t i = 0; i < 8; i++) {
+        ctx->buffer[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+    sha256_transform(ctx->state, ctx->buffer);
+
+    for (uint8_t i = 0; i < 8; i++) {
+        digest[i * 4]     = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)(ctx->state[i]);
+    }
+}
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Register one pattern with the rolling matcher
+ */
+static void add_pattern(OTAStreamVerifier* v, uint8_t slot, const void* bytes, uint8_t length) {
+    uint64_t value = 0;
+    memcpy(&value, bytes, length);   // Little-endian on ESP32 and x86 hosts
+
+    v->patterns[slot] = value;
+    v->pattern_bytes[slot] = length;
+
+    uint8_t last = ((const uint8_t*)bytes)[length - 1];
+    v->last_byte_filter[last >> 5] |= (1u << (last & 31));
+}
+
+/**
+ * @brief Advance the rolling matcher by one byte
+ *
+ * Only bytes that can terminate a pattern trigger the (cheap) window
+ * comparisons, so the common path is one shift and one bit test.
+ */
+static inline void match_byte(OTAStreamVerifier* v, uint8_t byte) {
+    v->window = (v->window >> 8) | ((uint64_t)byte << 56);
+
+    if (!(v->last_byte_filter[byte >> 5] & (1u << (byte & 31)))) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < OTA_VERIFY_PATTERN_COUNT; i++) {
+        uint8_t n = v->pattern_bytes[i];
+        if (v->received + 1 < n) continue;
+
+        if ((v->window >> (64 - 8 * n)) == v->patterns[i]) {
+            if (i == PATTERN_MAGIC && !(v->found_mask & (1u << PATTERN_MAGIC))) {
+                v->signature_offset = v->received + 1 - n;
+            }
+            v->found_mask |= (uint8_t)(1u << i);
+        }
+    }
+}
+
+/**
+ * @brief Push a chunk through the digest delay line
+ *
+ * The most recent 32 bytes are held back so that an appended SHA-256 is
+ * never hashed into itself. Everything older is hashed in bulk.
+ */
+static void hash_chunk(OTAStreamVerifier* v, const uint8_t* data, size_t len) {
+    size_t total = v->tail_len + len;
+    size_t excess = (total > OTA_SHA256_SIZE) ? total - OTA_SHA256_SIZE : 0;
+
+    // Oldest bytes leave the delay line first
+    size_t from_tail = (excess < v->tail_len) ? excess : v->tail_len;
+    size_t from_data = excess - from_tail;
+
+    ota_sha256_update(&v->sha, v->tail, from_tail);
+    ota_sha256_update(&v->sha, data, from_data);
+
+    memmove(v->tail, v->tail + from_tail, v->tail_len - from_tail);
+    v->tail_len -= (uint8_t)from_tail;
+    memcpy(v->tail + v->tail_len, data + from_data, len - from_data);
+    v->tail_len += (uint8_t)(len - from_data);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void ota_verify_init(OTAStreamVerifier* v, uint32_t expected_size, uint8_t flags) {
+    memset(v, 0, sizeof(*v));
+    v->expected_size = expected_size;
+    v->flags = flags;
+    v->status = OTA_VERIFY_PENDING;
+
+    uint32_t magic = LATTICE_SIGNATURE_MAGIC;
+    add_pattern(v, PATTERN_MAGIC, &magic, sizeof(magic));
+    add_pattern(v, PATTERN_PHI_INV, &g_lattice_signature.phi_inv, sizeof(double));
+    add_pattern(v, PATTERN_Z_CRITICAL, &g_lattice_signature.z_critical, sizeof(double));
+    add_pattern(v, PATTERN_EULER_INV, &g_lattice_signature.euler_inv, sizeof(double));
+    add_pattern(v, PATTERN_PI_INV, &g_lattice_signature.pi_inv, sizeof(double));
+    add_pattern(v, PATTERN_SQRT2_INV, &g_lattice_signature.sqrt2_inv, sizeof(double));
+
+    ota_sha256_init(&v->sha);
+    v->crc32 = 0;
+}
+
+void ota_verify_set_expected_sha256(OTAStreamVerifier* v, const uint8_t* digest) {
+    memcpy(v->expected_sha256, digest, OTA_SHA256_SIZE);
+    v->has_expected_sha256 = true;
+}
+
+OTAVerifyStatus ota_verify_update(OTAStreamVerifier* v, const uint8_t* data, size_t len) {
+    if (v->status != OTA_VERIFY_PENDING) {
+        return v->status;
+    }
+
+    if (v->expected_size > 0 && v->received + len > v->expected_size) {
+        v->status = OTA_VERIFY_ERR_SIZE;
+        return v->status;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t byte = data[i];
+
+        // Header checks happen inline as the bytes stream past
+        if (v->flags & OTA_VERIFY_FLAG_ESP_IMAGE) {
+            if (v->received == 0 && byte != OTA_ESP_IMAGE_MAGIC) {
+                v->status = OTA_VERIFY_ERR_HEADER;
+                return v->status;
+            }
+            if (v->received == OTA_ESP_HASH_APPENDED_OFFSET) {
+                v->hash_appended = (byte == 1);
+            }
+        }
+
+        match_byte(v, byte);
+        v->received++;
+    }
+
+    v->crc32 = checksum_crc32_update(v->crc32, data, len);
+    hash_chunk(v, data, len);
+
+    if (v->expected_size > 0 && v->received == v->expected_size) {
+        return ota_verify_finish(v);
+    }
+
+    return v->status;
+}
+
+OTAVerifyStatus ota_verify_finish(OTAStreamVerifier* v) {
+    if (v->status != OTA_VERIFY_PENDING) {
+        return v->status;
+    }
+
+    if (v->received == 0 ||
+        (v->expected_size > 0 && v->received != v->expected_size)) {
+        v->status = OTA_VERIFY_ERR_SIZE;
+        return v->status;
+    }
+
+    const uint8_t* tail = v->tail;
+    uint8_t digest[OTA_SHA256_SIZE];
+    bool digest_ok;
+
+    if (v->has_expected_sha256) {
+        // External digest covers the whole image, including the tail
+        ota_sha256_update(&v->sha, tail, v->tail_len);
+        ota_sha256_final(&v->sha, digest);
+        digest_ok = (memcmp(digest, v->expected_sha256, OTA_SHA256_SIZE) == 0);
+    } else if (v->hash_appended && v->tail_len == OTA_SHA256_SIZE) {
+        // ESP-IDF appended digest covers everything before the tail
+        ota_sha256_final(&v->sha, digest);
+        digest_ok = (memcmp(digest, tail, OTA_SHA256_SIZE) == 0);
+    } else {
+        digest_ok = !(v->flags & OTA_VERIFY_FLAG_REQUIRE_SHA);
+    }
+
+    if (!digest_ok) {
+        v->status = OTA_VERIFY_ERR_DIGEST;
+    } else if (v->found_mask != OTA_VERIFY_ALL_PATTERNS) {
+        v->status = OTA_VERIFY_ERR_LATTICE;
+    } else {
+        v->status = OTA_VERIFY_ACCEPTED;
+    }
+
+    return v->status;
+}
+
+void ota_verify_get_validation(const OTAStreamVerifier* v, LatticeValidation* out) {
+    memset(out, 0, sizeof(*out));
+
+    out->phi_inv_valid = (v->found_mask & (1u << PATTERN_PHI_INV)) != 0;
+    out->phi_valid = out->phi_inv_valid;
+    out->z_critical_valid = (v->found_mask & (1u << PATTERN_Z_CRITICAL)) != 0;
+    out->euler_inv_valid = (v->found_mask & (1u << PATTERN_EULER_INV)) != 0;
+    out->pi_inv_valid = (v->found_mask & (1u << PATTERN_PI_INV)) != 0;
+    out->sqrt2_inv_valid = (v->found_mask & (1u << PATTERN_SQRT2_INV)) != 0;
+
+    // Exact bit patterns are matched, so a found constant has zero error
+    out->phi_error = out->phi_inv_valid ? 0.0f : 1.0f;
+    out->z_critical_error = out->z_critical_valid ? 0.0f : 1.0f;
+
+    out->firmware_checksum = v->crc32;
+    out->valid = (v->status == OTA_VERIFY_ACCEPTED);
+}
+
+const char* ota_verify_status_string(OTAVerifyStatus status) {
+    switch (status) {
+        case OTA_VERIFY_PENDING:     return "Pending";
+        case OTA_VERIFY_ACCEPTED:    return "Accepted";
+        case OTA_VERIFY_ERR_SIZE:    return "Size Error";
+        case OTA_VERIFY_ERR_HEADER:  return "Header Error";
+        case OTA_VERIFY_ERR_DIGEST:  return "Digest Error";
+        case OTA_VERIFY_ERR_LATTICE: return "Lattice Error";
+        default:                     return "Unknown";
+    }
+}
+
+const OTALatticeSignature* ota_verify_get_signature(void) {
+    return &g_lattice_signature;
+}
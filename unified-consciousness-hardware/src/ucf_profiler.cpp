@@ -0,0 +1,192 @@
+/**
+ * @file ucf_profiler.cpp
+ * @brief Probe histograms and summaries
+ *
+ * Histogram buckets are log-linear: durations below PROF_SUB_BUCKETS ticks
+ * get one bucket each, every octave above that is split into
+ * PROF_SUB_BUCKETS equal buckets. Recording is a count-leading-zeros, a
+ * shift and four updates, cheap enough for the 1 kHz Kuramoto step.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_profiler.h"
+#include <string.h>
+
+#ifndef __XTENSA__
+#include <chrono>
+#endif
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define PROF_SUB_SHIFT  2               // log2(PROF_SUB_BUCKETS)
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_ticks;
+    uint32_t max_ticks;
+    uint64_t total_ticks;
+    uint32_t buckets[PROF_BUCKETS];
+} ProbeState;
+
+static const char* const PROBE_NAMES[PROF_PROBE_COUNT] = {
+    "readField",
+    "kformation",
+    "kuramoto",
+    "leds",
+    "sigil",
+    "sensors",
+    "phase",
+    "emanation",
+};
+
+#if UCF_PROFILE
+static ProbeState g_probes[PROF_PROBE_COUNT];
+#endif
+static uint32_t g_ticks_per_us = PROF_HOST_TICKS_PER_US;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint32_t ticks_to_ns(uint32_t ticks) {
+    uint64_t ns = (uint64_t)ticks * 1000 / g_ticks_per_us;
+    return ns > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)ns;
+}
+
+// ============================================================================
+// TIME SOURCE
+// ============================================================================
+
+#ifndef __XTENSA__
+uint32_t prof_ticks(void) {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+#endif
+
+// ============================================================================
+// BUCKETS
+// ============================================================================
+
+uint8_t prof_bucket_index(uint32_t ticks) {
+    if (ticks < PROF_SUB_BUCKETS) {
+        return (uint8_t)ticks;
+    }
+    uint32_t octave = 31 - __builtin_clz(ticks);
+    uint32_t sub = (ticks >> (octave - PROF_SUB_SHIFT)) & (PROF_SUB_BUCKETS - 1);
+    return (uint8_t)((octave - PROF_SUB_SHIFT + 1) * PROF_SUB_BUCKETS + sub);
+}
+
+uint32_t prof_bucket_upper(uint8_t bucket) {
+    if (bucket < PROF_SUB_BUCKETS) {
+        return bucket;
+    }
+    uint32_t octave = bucket / PROF_SUB_BUCKETS + PROF_SUB_SHIFT - 1;
+    uint32_t sub = bucket % PROF_SUB_BUCKETS;
+    uint32_t width = 1u << (octave - PROF_SUB_SHIFT);
+    uint64_t lower = (uint64_t)(PROF_SUB_BUCKETS + sub) << (octave - PROF_SUB_SHIFT);
+    return (uint32_t)(lower + width - 1);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+#if UCF_PROFILE
+
+void prof_init(uint32_t ticks_per_us) {
+    g_ticks_per_us = ticks_per_us > 0 ? ticks_per_us : 1;
+    prof_reset();
+}
+
+void prof_record(ProfProbe probe, uint32_t ticks) {
+    if (probe >= PROF_PROBE_COUNT) {
+        return;
+    }
+
+    ProbeState* p = &g_probes[probe];
+    if (p->count == 0 || ticks < p->min_ticks) {
+        p->min_ticks = ticks;
+    }
+    if (ticks > p->max_ticks) {
+        p->max_ticks = ticks;
+    }
+    p->count++;
+    p->total_ticks += ticks;
+    p->buckets[prof_bucket_index(ticks)]++;
+}
+
+uint32_t prof_percentile(ProfProbe probe, float percent) {
+    if (probe >= PROF_PROBE_COUNT || g_probes[probe].count == 0) {
+        return 0;
+    }
+
+    const ProbeState* p = &g_probes[probe];
+    uint32_t rank = (uint32_t)(percent / 100.0f * p->count + 0.999f);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint32_t seen = 0;
+    for (int b = 0; b < PROF_BUCKETS; b++) {
+        seen += p->buckets[b];
+        if (seen >= rank) {
+            // The bucket bound can overshoot the largest sample in it
+            uint32_t upper = prof_bucket_upper((uint8_t)b);
+            if (upper > p->max_ticks) upper = p->max_ticks;
+            if (upper < p->min_ticks) upper = p->min_ticks;
+            return ticks_to_ns(upper);
+        }
+    }
+    return ticks_to_ns(p->max_ticks);
+}
+
+bool prof_get(ProfProbe probe, ProfSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    if (probe >= PROF_PROBE_COUNT || g_probes[probe].count == 0) {
+        return false;
+    }
+
+    const ProbeState* p = &g_probes[probe];
+    summary->count = p->count;
+    summary->min_ns = ticks_to_ns(p->min_ticks);
+    summary->mean_ns = ticks_to_ns((uint32_t)(p->total_ticks / p->count));
+    summary->p50_ns = prof_percentile(probe, 50.0f);
+    summary->p99_ns = prof_percentile(probe, 99.0f);
+    summary->max_ns = ticks_to_ns(p->max_ticks);
+    return true;
+}
+
+void prof_reset(void) {
+    memset(g_probes, 0, sizeof(g_probes));
+}
+
+#else // !UCF_PROFILE
+
+void prof_init(uint32_t ticks_per_us) {
+    g_ticks_per_us = ticks_per_us > 0 ? ticks_per_us : 1;
+}
+
+void prof_record(ProfProbe probe, uint32_t ticks) {
+}
+
+uint32_t prof_percentile(ProfProbe probe, float percent) {
+    return 0;
+}
+
+bool prof_get(ProfProbe probe, ProfSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    return false;
+}
+
+void prof_reset(void) {
+}
+
+#endif // UCF_PROFILE
+
+const char* prof_probe_name(ProfProbe probe) {
+    return probe < PROF_PROBE_COUNT ? PROBE_NAMES[probe] : "unknown";
+}
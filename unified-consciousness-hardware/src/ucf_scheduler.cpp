@@ -0,0 +1,236 @@
+/**
+ * @file ucf_scheduler.cpp
+ * @brief Cooperative loop scheduler
+ *
+ * Times are uint32_t microseconds and compared as signed differences, so
+ * the 71-minute wrap of micros() is harmless.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_scheduler.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static uint32_t g_virtual_now = 0;
+static SchedHookFn g_hook = NULL;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline int32_t time_diff(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b);
+}
+
+static inline uint32_t task_deadline(const SchedTask* t) {
+    uint32_t rel = t->config.deadline_us ? t->config.deadline_us : t->config.period_us;
+    return t->release_us + rel;
+}
+
+/**
+ * @brief Pick the most urgent due task
+ * @return Task index, or -1 if none is due
+ */
+static int pick_task(const Scheduler* s, uint32_t now) {
+    int best = -1;
+    for (uint8_t i = 0; i < s->count; i++) {
+        const SchedTask* t = &s->tasks[i];
+        if (!t->enabled || time_diff(now, t->release_us) < 0) {
+            continue;
+        }
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+        const SchedTask* b = &s->tasks[best];
+        if (t->config.priority > b->config.priority ||
+            (t->config.priority == b->config.priority &&
+             time_diff(task_deadline(t), task_deadline(b)) < 0)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Record one run and move the task to its next release
+ */
+static void account_run(Scheduler* s, SchedTask* t, uint32_t start, uint32_t end) {
+    SchedTaskStats* st = &t->stats;
+    uint32_t exec = end - start;
+    uint32_t jitter = (uint32_t)time_diff(start, t->release_us);
+
+    st->runs++;
+    st->total_exec_us += exec;
+    st->total_jitter_us += jitter;
+    if (exec > st->max_exec_us) st->max_exec_us = exec;
+    if (jitter > st->max_jitter_us) st->max_jitter_us = jitter;
+    if (t->config.budget_us && exec > t->config.budget_us) st->overruns++;
+    if (time_diff(end, task_deadline(t)) > 0) st->misses++;
+
+    s->busy_us += exec;
+    s->dispatches++;
+
+    // Next release on the fixed grid; drop what the catch-up cap does not keep
+    uint32_t period = t->config.period_us;
+    t->release_us += period;
+    int32_t behind = time_diff(end, t->release_us);
+    if (behind >= 0) {
+        uint32_t overdue = (uint32_t)behind / period + 1;
+        if (overdue > t->config.max_catchup) {
+            uint32_t drop = overdue - t->config.max_catchup;
+            st->skipped += drop;
+            t->release_us += drop * period;
+        }
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void sched_init(Scheduler* s, uint32_t (*clock_us)(void)) {
+    memset(s, 0, sizeof(*s));
+    s->clock_us = clock_us;
+    s->stats_start_us = clock_us();
+}
+
+int sched_add(Scheduler* s, const SchedTaskConfig* config) {
+    if (s->count >= SCHED_MAX_TASKS || !config || !config->fn || config->period_us == 0) {
+        return -1;
+    }
+
+    SchedTask* t = &s->tasks[s->count];
+    memset(t, 0, sizeof(*t));
+    t->config = *config;
+    t->release_us = s->clock_us() + config->offset_us;
+    t->enabled = true;
+    return s->count++;
+}
+
+void sched_enable(Scheduler* s, int id, bool enabled) {
+    if (id < 0 || id >= s->count) {
+        return;
+    }
+    SchedTask* t = &s->tasks[id];
+    if (enabled && !t->enabled) {
+        t->release_us = s->clock_us();
+    }
+    t->enabled = enabled;
+}
+
+void sched_set_period(Scheduler* s, int id, uint32_t period_us) {
+    if (id >= 0 && id < s->count && period_us > 0) {
+        s->tasks[id].config.period_us = period_us;
+    }
+}
+
+uint8_t sched_run(Scheduler* s) {
+    uint8_t ran = 0;
+
+    // Re-pick after every run: a 1 kHz task released meanwhile goes next
+    while (ran < SCHED_MAX_DISPATCH) {
+        uint32_t start = s->clock_us();
+        int i = pick_task(s, start);
+        if (i < 0) {
+            break;
+        }
+
+        SchedTask* t = &s->tasks[i];
+        if (g_hook) {
+            g_hook(s, t, SCHED_HOOK_BEGIN);
+        }
+        t->config.fn(start, t->config.ctx);
+        account_run(s, t, start, s->clock_us());
+        if (g_hook) {
+            g_hook(s, t, SCHED_HOOK_END);
+        }
+        ran++;
+    }
+
+    if (g_hook) {
+        g_hook(s, NULL, SCHED_HOOK_PASS);
+    }
+    return ran;
+}
+
+uint32_t sched_idle_us(const Scheduler* s) {
+    uint32_t now = s->clock_us();
+    bool any = false;
+    int32_t idle = 0;
+
+    for (uint8_t i = 0; i < s->count; i++) {
+        const SchedTask* t = &s->tasks[i];
+        if (!t->enabled) {
+            continue;
+        }
+        int32_t until = time_diff(t->release_us, now);
+        if (!any || until < idle) {
+            idle = until;
+            any = true;
+        }
+    }
+    return (any && idle > 0) ? (uint32_t)idle : 0;
+}
+
+const SchedTask* sched_get_task(const Scheduler* s, int id) {
+    return (id >= 0 && id < s->count) ? &s->tasks[id] : NULL;
+}
+
+float sched_load_percent(const Scheduler* s) {
+    uint32_t elapsed = s->clock_us() - s->stats_start_us;
+    return elapsed ? 100.0f * (float)s->busy_us / (float)elapsed : 0.0f;
+}
+
+void sched_reset_stats(Scheduler* s) {
+    for (uint8_t i = 0; i < s->count; i++) {
+        memset(&s->tasks[i].stats, 0, sizeof(SchedTaskStats));
+    }
+    s->busy_us = 0;
+    s->dispatches = 0;
+    s->stats_start_us = s->clock_us();
+}
+
+void sched_set_hook(SchedHookFn hook) {
+    g_hook = hook;
+}
+
+// ============================================================================
+// VIRTUAL TIME
+// ============================================================================
+
+uint32_t sched_virtual_clock(void) {
+    return g_virtual_now;
+}
+
+void sched_virtual_set(uint32_t now_us) {
+    g_virtual_now = now_us;
+}
+
+void sched_virtual_advance(uint32_t us) {
+    g_virtual_now += us;
+}
+
+uint32_t sched_run_virtual(Scheduler* s, uint32_t duration_us) {
+    uint32_t end = g_virtual_now + duration_us;
+    uint32_t runs = 0;
+
+    while (time_diff(g_virtual_now, end) < 0) {
+        uint8_t ran = sched_run(s);
+        runs += ran;
+        if (ran == 0) {
+            uint32_t idle = sched_idle_us(s);
+            if (idle == 0 || time_diff(end, g_virtual_now + idle) < 0) {
+                // Nothing enabled, or the next release is past the end
+                g_virtual_now = end;
+            } else {
+                g_virtual_now += idle;
+            }
+        }
+    }
+    return runs;
+}
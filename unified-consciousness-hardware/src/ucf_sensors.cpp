@@ -10,10 +10,14 @@
 
 #include "ucf_sensors.h"
 #include "ucf_magnetometer.h"
+#include "ucf_profiler.h"
+#include "ucf_latency.h"
+#include "ucf_trace.h"
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_MPR121.h>
 #include <math.h>
+#include <string.h>
 #include "ucf/ucf_config.h"
 
 // ============================================================================
@@ -37,6 +41,16 @@ static float g_z_smooth_alpha = SENSOR_Z_SMOOTH_ALPHA;
 // Threshold
 static float g_threshold = SENSOR_DEFAULT_THRESHOLD;
 
+// Bus manager frame (NULL bus = blocking Wire reads)
+static I2cBus* g_bus = NULL;
+static uint8_t g_frame_rx[SENSOR_HEX_COUNT][2];     // Filtered data, LSB first
+static uint8_t g_frame_mag_rx[HMC5883L_DATA_BYTES];
+static uint16_t g_frame_raw[SENSOR_HEX_COUNT];      // Last complete frame
+static uint8_t g_frame_outstanding = 0;
+static uint8_t g_frame_errors = 0;
+static bool g_frame_mag_ok = false;
+static bool g_frame_fresh = false;
+
 // Update timing
 static uint32_t g_last_update = 0;
 static uint32_t g_update_count_window = 0;
@@ -64,15 +78,22 @@ static const float HEX_POSITIONS[SENSOR_HEX_COUNT][2] = {
  * @brief Read raw values from MPR121 controllers
  */
 static void read_mpr121_raw(uint16_t* data) {
-    // Read from first controller (sensors 0-11)
-    for (uint8_t i = 0; i < 12; i++) {
-        data[i] = g_mpr121_a.filteredData(i);
-    }
+    if (g_bus != NULL) {
+        memcpy(data, g_frame_raw, sizeof(g_frame_raw));
+    } else {
+        // Read from first controller (sensors 0-11)
+        for (uint8_t i = 0; i < 12; i++) {
+            data[i] = g_mpr121_a.filteredData(i);
+        }
 
-    // Read from second controller (sensors 12-18)
-    for (uint8_t i = 0; i < 7; i++) {
-        data[12 + i] = g_mpr121_b.filteredData(i);
+        // Read from second controller (sensors 12-18)
+        for (uint8_t i = 0; i < 7; i++) {
+            data[12 + i] = g_mpr121_b.filteredData(i);
+        }
+        LAT_MARK(LAT_MPR121);
     }
+
+    TRACE_TOUCH(millis(), data);
 }
 
 /**
@@ -164,9 +185,7 @@ static void update_hex_grid(void) {
 /**
  * @brief Update magnetic field readings
  */
-static void update_magnetometer(void) {
-    MagnetometerData mag_data = magnetometer_read();
-
+static void update_magnetometer(MagnetometerData mag_data) {
     g_sensors.mag.x = mag_data.x;
     g_sensors.mag.y = mag_data.y;
     g_sensors.mag.z = mag_data.z;
@@ -177,6 +196,90 @@ static void update_magnetometer(void) {
     g_sensors.mag.timestamp = millis();
 }
 
+/**
+ * @brief Decode a completed bus frame
+ */
+static void finish_frame(void) {
+    if (g_frame_errors == 0) {
+        for (uint8_t i = 0; i < SENSOR_HEX_COUNT; i++) {
+            g_frame_raw[i] = (uint16_t)(g_frame_rx[i][0] | (g_frame_rx[i][1] << 8));
+        }
+        g_frame_fresh = true;
+        LAT_MARK(LAT_MPR121);
+    } else {
+        g_sensors.error_count++;
+    }
+
+    if (g_frame_mag_ok) {
+        update_magnetometer(magnetometer_process(magnetometer_decode_raw(g_frame_mag_rx)));
+    }
+}
+
+/**
+ * @brief Bus completion for one read of the frame (slot SENSOR_HEX_COUNT = magnetometer)
+ */
+static void on_frame_read(uint8_t* rx, uint8_t rx_len, I2cStatus status, void* ctx) {
+    uintptr_t slot = (uintptr_t)ctx;
+
+    if (slot == SENSOR_HEX_COUNT) {
+        g_frame_mag_ok = (status == I2C_OK);
+    } else if (status != I2C_OK) {
+        g_frame_errors++;
+    }
+
+    if (--g_frame_outstanding == 0) {
+        finish_frame();
+    }
+}
+
+/**
+ * @brief Queue the next frame's reads
+ *
+ * One read per electrode, as the Adafruit driver issues them; the bus
+ * merges each controller's into a single burst. Reads still waiting at
+ * the next update's deadline are dropped rather than delivered stale.
+ */
+static void submit_frame(void) {
+    uint32_t deadline = i2c_bus_now(g_bus) + SENSOR_BUS_DEADLINE_US;
+
+    g_frame_errors = 0;
+    g_frame_mag_ok = false;
+    g_frame_outstanding = 0;
+
+    for (uint8_t i = 0; i < SENSOR_HEX_COUNT; i++) {
+        I2cDeviceId dev = i < 12 ? I2C_DEV_MPR121_A : I2C_DEV_MPR121_B;
+        uint8_t channel = i < 12 ? i : i - 12;
+        if (i2c_bus_read(g_bus, dev, (uint8_t)(MPR121_FILTDATA_0L + 2 * channel), g_frame_rx[i], 2,
+                         I2C_PRIO_HIGH, deadline, on_frame_read, (void*)(uintptr_t)i)) {
+            g_frame_outstanding++;
+        } else {
+            g_frame_errors++;
+        }
+    }
+
+    if (magnetometer_is_healthy() &&
+        i2c_bus_read(g_bus, I2C_DEV_HMC5883L, HMC5883L_REG_DATA_X_H, g_frame_mag_rx,
+                     HMC5883L_DATA_BYTES, I2C_PRIO_NORMAL, deadline, on_frame_read,
+                     (void*)(uintptr_t)SENSOR_HEX_COUNT)) {
+        g_frame_outstanding++;
+    }
+
+    if (g_frame_outstanding == 0) {
+        g_sensors.error_count++;
+    }
+    i2c_bus_flush(g_bus);
+}
+
+/**
+ * @brief Collect the frame queued last time, then queue the next
+ */
+static void pump_frame(void) {
+    i2c_bus_dispatch(g_bus);
+    if (g_frame_outstanding == 0) {
+        submit_frame();
+    }
+}
+
 /**
  * @brief Compute helix coordinates from sensor data
  */
@@ -262,16 +365,26 @@ SensorStatus sensors_init(void) {
 }
 
 const SensorSystemState* sensors_update(void) {
+    PROF_SCOPE(PROF_SENSORS_UPDATE);
+
     if (!g_sensors.initialized) {
         return &g_sensors;
     }
 
-    // Update hex grid
-    update_hex_grid();
+    if (g_bus != NULL) {
+        pump_frame();
+        if (g_frame_fresh) {
+            g_frame_fresh = false;
+            update_hex_grid();
+        }
+    } else {
+        // Update hex grid
+        update_hex_grid();
 
-    // Update magnetometer
-    if (magnetometer_is_healthy()) {
-        update_magnetometer();
+        // Update magnetometer
+        if (magnetometer_is_healthy()) {
+            update_magnetometer(magnetometer_read());
+        }
     }
 
     // Compute helix coordinates
@@ -293,6 +406,16 @@ const SensorSystemState* sensors_update(void) {
     return &g_sensors;
 }
 
+void sensors_attach_bus(I2cBus* bus) {
+    // Seed the frame with a blocking read while Wire is still ours
+    if (bus != NULL && g_bus == NULL && g_sensors.initialized) {
+        read_mpr121_raw(g_frame_raw);
+    }
+    g_bus = bus;
+    g_frame_outstanding = 0;
+    g_frame_fresh = false;
+}
+
 const HexGridState* sensors_get_hex_state(void) {
     return &g_sensors.hex;
 }
@@ -321,6 +444,9 @@ void sensors_calibrate_hex(uint16_t samples) {
     // Collect samples
     for (uint16_t s = 0; s < samples; s++) {
         uint16_t data[SENSOR_HEX_COUNT];
+        if (g_bus != NULL) {
+            pump_frame();
+        }
         read_mpr121_raw(data);
 
         for (uint8_t i = 0; i < SENSOR_HEX_COUNT; i++) {
@@ -339,6 +465,33 @@ void sensors_calibrate_hex(uint16_t samples) {
     Serial.println("[SENSORS] Hex grid calibration complete");
 }
 
+void sensors_set_baselines(const uint16_t* baselines) {
+    memcpy(g_baselines, baselines, sizeof(g_baselines));
+    g_calibrated = true;
+}
+
+bool sensors_get_baselines(uint16_t* baselines) {
+    memcpy(baselines, g_baselines, sizeof(g_baselines));
+    return g_calibrated;
+}
+
+void sensors_get_raw(uint16_t* raw) {
+    for (uint8_t i = 0; i < SENSOR_HEX_COUNT; i++) {
+        raw[i] = g_sensors.hex.sensors[i].raw;
+    }
+}
+
+float sensors_get_z_smoothed(void) {
+    return g_z_smoothed;
+}
+
+void sensors_set_z_smoothed(float z) {
+    if (z < 0.0f) z = 0.0f;
+    if (z > 1.0f) z = 1.0f;
+    g_z_smoothed = z;
+    g_sensors.hex.z = z;
+}
+
 void sensors_calibrate_mag_start(void) {
     magnetometer_calibrate_start();
 }
@@ -383,9 +536,15 @@ uint8_t sensors_get_active_count(void) {
 bool sensors_is_healthy(void) {
     if (!g_sensors.initialized) return false;
 
-    // Check MPR121 health
-    uint16_t test_a = g_mpr121_a.filteredData(0);
-    uint16_t test_b = g_mpr121_b.filteredData(0);
+    // Check MPR121 health (latest bus frame, or a direct read)
+    uint16_t test_a, test_b;
+    if (g_bus != NULL) {
+        test_a = g_frame_raw[0];
+        test_b = g_frame_raw[12];
+    } else {
+        test_a = g_mpr121_a.filteredData(0);
+        test_b = g_mpr121_b.filteredData(0);
+    }
 
     if (test_a == 0 || test_a > 1000) {
         g_sensors.status = SENSORS_ERR_MPR121_A;
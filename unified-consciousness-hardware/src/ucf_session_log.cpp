@@ -0,0 +1,823 @@
+/**
+ * @file ucf_session_log.cpp
+ * @brief UCF Session Recorder Implementation v4.0.0
+ *
+ * Block header (little-endian):
+ *   magic(4) seq(4) session(2) flags(2) raw_len(2) packed_len(2)
+ *   t0_ms(4) crc32(4)
+ *   The CRC covers the first 20 header bytes and the packed payload.
+ *
+ * Record encoding (inside a block, before compression):
+ *   type(1) dt(varint, ms since the previous record or t0) payload
+ *   START       -
+ *   FRAME       zigzag varint deltas of z, r, kappa, eta, active_sensors
+ *               (fixed point, against the previous frame in the block)
+ *   PHASE       from(1) to(1) zigzag varint z
+ *   TRIAD       state(1) crossings(1)
+ *   KFORMATION  active(1) R(1) zigzag varint kappa, eta
+ *
+ * Compression is a byte-oriented LZ77 (LZ4 block layout: token with
+ * literal/match length nibbles, literals, 16-bit offset), chosen for a
+ * small encoder table and a decoder that needs no extra memory.
+ *
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_session_log.h"
+#include "ucf_checksum.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define LOG_MAX_RECORD          32      // Largest encoded record
+#define LOG_FIELD_COUNT         5       // Delta-coded frame fields
+#define LZ_MIN_MATCH            4
+#define LZ_HASH_BITS            10
+#define LZ_LAST_LITERALS        5       // Matches stop this far from the end
+
+static StorageBackend g_backend;
+static bool g_mounted = false;
+
+// Open block (records being appended)
+static uint8_t g_block[SESSION_LOG_BLOCK_SIZE];
+static uint16_t g_block_len = 0;
+static uint32_t g_block_t0 = 0;
+static uint32_t g_block_prev_ms = 0;
+static int32_t g_block_q[LOG_FIELD_COUNT];
+
+// Sealed block (header + packed payload) being written out
+static uint8_t g_out[SESSION_LOG_HEADER_SIZE + SESSION_LOG_BLOCK_SIZE];
+static uint16_t g_out_len = 0;
+static uint16_t g_out_pos = 0;
+static uint32_t g_write_addr = 0;
+static bool g_need_erase = false;
+static uint32_t g_last_op_ms = 0;
+static bool g_op_stamped = false;
+
+// Change detection and decimation
+static SessionFrame g_last;
+static bool g_have_last = false;
+static uint32_t g_last_frame_ms = 0;
+static bool g_frame_stamped = false;
+
+static uint16_t g_lz_hash[1 << LZ_HASH_BITS];
+static SessionLogStats g_stats;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static inline uint32_t align4(uint32_t n) {
+    return (n + 3) & ~3u;
+}
+
+static inline int32_t quantize(float v) {
+    float scaled = v * SESSION_LOG_VALUE_SCALE;
+    return (int32_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+static inline float dequantize(int32_t q) {
+    return (float)q / SESSION_LOG_VALUE_SCALE;
+}
+
+static size_t put_varint(uint8_t* p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t put_zigzag(uint8_t* p, int32_t v) {
+    return put_varint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static bool get_varint(const uint8_t* p, size_t len, size_t* pos, uint32_t* out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && *pos < len; shift += 7) {
+        uint8_t b = p[(*pos)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_zigzag(const uint8_t* p, size_t len, size_t* pos, int32_t* out) {
+    uint32_t v;
+    if (!get_varint(p, len, pos, &v)) {
+        return false;
+    }
+    *out = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// LZ block codec
+// ----------------------------------------------------------------------------
+
+static size_t lz_put_length(uint8_t* dst, size_t op, size_t cap, size_t len) {
+    while (len >= 255) {
+        if (op >= cap) return 0;
+        dst[op++] = 255;
+        len -= 255;
+    }
+    if (op >= cap) return 0;
+    dst[op++] = (uint8_t)len;
+    return op;
+}
+
+/**
+ * @brief Emit one sequence: literals, then an optional match
+ * @return New output position, 0 if it does not fit
+ */
+static size_t lz_put_sequence(uint8_t* dst, size_t op, size_t cap,
+                              const uint8_t* lit, size_t lit_len,
+                              size_t offset, size_t match_len) {
+    size_t m = match_len ? match_len - LZ_MIN_MATCH : 0;
+    if (op >= cap) return 0;
+    size_t token = op++;
+    dst[token] = (uint8_t)(((lit_len < 15 ? lit_len : 15) << 4) | (m < 15 ? m : 15));
+
+    if (lit_len >= 15 && (op = lz_put_length(dst, op, cap, lit_len - 15)) == 0) return 0;
+    if (op + lit_len > cap) return 0;
+    memcpy(dst + op, lit, lit_len);
+    op += lit_len;
+
+    if (match_len) {
+        if (op + 2 > cap) return 0;
+        put_u16(dst + op, (uint16_t)offset);
+        op += 2;
+        if (m >= 15 && (op = lz_put_length(dst, op, cap, m - 15)) == 0) return 0;
+    }
+    return op;
+}
+
+/**
+ * @brief Compress a block
+ * @return Compressed size, 0 if it would not fit in cap
+ */
+static size_t lz_compress(const uint8_t* src, size_t len, uint8_t* dst, size_t cap) {
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+
+    // Positions are stored +1 so a zeroed table means "empty"
+    memset(g_lz_hash, 0, sizeof(g_lz_hash));
+
+    while (ip + LZ_MIN_MATCH + LZ_LAST_LITERALS <= len) {
+        uint32_t seq;
+        memcpy(&seq, src + ip, 4);
+        uint32_t h = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t cand = g_lz_hash[h];
+        g_lz_hash[h] = (uint16_t)(ip + 1);
+
+        uint32_t ref_seq = ~seq;
+        if (cand != 0) {
+            memcpy(&ref_seq, src + cand - 1, 4);
+        }
+        if (ref_seq != seq) {
+            ip++;
+            continue;
+        }
+
+        size_t ref = cand - 1;
+        size_t match_len = LZ_MIN_MATCH;
+        while (ip + match_len < len - LZ_LAST_LITERALS && src[ref + match_len] == src[ip + match_len]) {
+            match_len++;
+        }
+
+        op = lz_put_sequence(dst, op, cap, src + anchor, ip - anchor, ip - ref, match_len);
+        if (op == 0) return 0;
+        ip += match_len;
+        anchor = ip;
+    }
+
+    return lz_put_sequence(dst, op, cap, src + anchor, len - anchor, 0, 0);
+}
+
+static bool lz_get_length(const uint8_t* src, size_t len, size_t* ip, size_t* value) {
+    uint8_t b;
+    do {
+        if (*ip >= len) return false;
+        b = src[(*ip)++];
+        *value += b;
+    } while (b == 255);
+    return true;
+}
+
+/**
+ * @brief Decompress a block (bounds-checked against both buffers)
+ * @return Decompressed size, 0 on malformed input
+ */
+static size_t lz_decompress(const uint8_t* src, size_t len, uint8_t* dst, size_t cap) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < len) {
+        uint8_t token = src[ip++];
+
+        size_t lit_len = token >> 4;
+        if (lit_len == 15 && !lz_get_length(src, len, &ip, &lit_len)) return 0;
+        if (ip + lit_len > len || op + lit_len > cap) return 0;
+        memcpy(dst + op, src + ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == len) {
+            break;  // Final sequence carries literals only
+        }
+
+        if (ip + 2 > len) return 0;
+        size_t offset = get_u16(src + ip);
+        ip += 2;
+        size_t match_len = token & 0x0F;
+        if (match_len == 15 && !lz_get_length(src, len, &ip, &match_len)) return 0;
+        match_len += LZ_MIN_MATCH;
+        if (offset == 0 || offset > op || op + match_len > cap) return 0;
+
+        // Byte copy: matches may overlap their own output
+        for (size_t i = 0; i < match_len; i++, op++) {
+            dst[op] = dst[op - offset];
+        }
+    }
+    return op;
+}
+
+// ----------------------------------------------------------------------------
+// Block headers
+// ----------------------------------------------------------------------------
+
+static bool header_plausible(const uint8_t* h, uint32_t sector_size) {
+    uint16_t raw_len = get_u16(h + 12);
+    uint16_t packed_len = get_u16(h + 14);
+    return get_u32(h) == SESSION_LOG_MAGIC &&
+           raw_len > 0 && raw_len <= SESSION_LOG_BLOCK_SIZE &&
+           packed_len > 0 && packed_len <= SESSION_LOG_BLOCK_SIZE &&
+           (uint32_t)(SESSION_LOG_HEADER_SIZE + packed_len) <= sector_size;
+}
+
+static inline uint32_t header_crc(const uint8_t* h, const uint8_t* payload, uint16_t packed_len) {
+    uint32_t crc = checksum_crc32(h, SESSION_LOG_HEADER_SIZE - 4);
+    return checksum_crc32_update(crc, payload, packed_len);
+}
+
+/**
+ * @brief Read and verify the block at addr into buf (header + payload)
+ */
+static bool read_block(const StorageBackend* b, uint32_t addr, uint8_t* buf) {
+    if (!b->read(addr, buf, SESSION_LOG_HEADER_SIZE, b->ctx) ||
+        !header_plausible(buf, b->sector_size)) {
+        return false;
+    }
+    uint16_t packed_len = get_u16(buf + 14);
+    return b->read(addr + SESSION_LOG_HEADER_SIZE, buf + SESSION_LOG_HEADER_SIZE, packed_len, b->ctx) &&
+           header_crc(buf, buf + SESSION_LOG_HEADER_SIZE, packed_len) == get_u32(buf + 20);
+}
+
+// ----------------------------------------------------------------------------
+// Writer
+// ----------------------------------------------------------------------------
+
+static void start_next_sector(void) {
+    uint32_t sector = g_write_addr / g_backend.sector_size + 1;
+    g_write_addr = (sector % g_backend.sector_count) * g_backend.sector_size;
+    g_need_erase = true;
+}
+
+/**
+ * @brief Compress the open block into the output buffer
+ * @return false if the previous block is still being written
+ */
+static bool seal_block(void) {
+    if (g_block_len == 0) {
+        return true;
+    }
+    if (g_out_len != 0) {
+        return false;
+    }
+
+    uint8_t* payload = g_out + SESSION_LOG_HEADER_SIZE;
+    uint16_t flags = 0;
+    size_t packed_len = lz_compress(g_block, g_block_len, payload, g_block_len - 1);
+    if (packed_len == 0) {
+        memcpy(payload, g_block, g_block_len);
+        packed_len = g_block_len;
+        flags |= SESSION_LOG_FLAG_STORED;
+    }
+
+    put_u32(g_out, SESSION_LOG_MAGIC);
+    put_u32(g_out + 4, g_stats.next_seq++);
+    put_u16(g_out + 8, g_stats.session);
+    put_u16(g_out + 10, flags);
+    put_u16(g_out + 12, g_block_len);
+    put_u16(g_out + 14, (uint16_t)packed_len);
+    put_u32(g_out + 16, g_block_t0);
+    put_u32(g_out + 20, header_crc(g_out, payload, (uint16_t)packed_len));
+
+    g_out_len = (uint16_t)(SESSION_LOG_HEADER_SIZE + packed_len);
+    g_out_pos = 0;
+    g_stats.blocks++;
+    g_stats.raw_bytes += g_block_len;
+    g_block_len = 0;
+    return true;
+}
+
+/**
+ * @brief Perform one flash operation for the sealed block
+ */
+static void write_step(void) {
+    // Blocks never span sectors
+    if (g_out_pos == 0 && g_write_addr % g_backend.sector_size + g_out_len > g_backend.sector_size) {
+        start_next_sector();
+    }
+
+    if (g_need_erase) {
+        uint16_t sector = (uint16_t)(g_write_addr / g_backend.sector_size);
+        if (g_backend.erase(sector, g_backend.ctx)) {
+            g_need_erase = false;
+            g_stats.erases++;
+        } else {
+            g_stats.write_errors++;
+            g_out_len = 0;
+        }
+        return;
+    }
+
+    // One page at most, never crossing a page boundary
+    uint32_t addr = g_write_addr + g_out_pos;
+    uint32_t chunk = SESSION_LOG_PAGE_SIZE - addr % SESSION_LOG_PAGE_SIZE;
+    if (chunk > (uint32_t)(g_out_len - g_out_pos)) {
+        chunk = g_out_len - g_out_pos;
+    }
+
+    if (!g_backend.write(addr, g_out + g_out_pos, chunk, g_backend.ctx)) {
+        // Contents of this sector are now unknown; abandon the block
+        g_stats.write_errors++;
+        g_out_len = 0;
+        start_next_sector();
+        return;
+    }
+    g_out_pos += chunk;
+    g_stats.flash_bytes += chunk;
+
+    if (g_out_pos == g_out_len) {
+        if (g_backend.sync) {
+            g_backend.sync(g_backend.ctx);
+        }
+        g_write_addr += align4(g_out_len);
+        g_out_len = 0;
+        g_out_pos = 0;
+        if (g_write_addr % g_backend.sector_size == 0) {
+            g_write_addr -= g_backend.sector_size;
+            start_next_sector();
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Record encoding
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Append an encoded record (type and time are added here)
+ * @return false if the record was dropped
+ */
+static bool append_record(uint32_t now_ms, uint8_t type, const uint8_t* payload, size_t len) {
+    if (g_block_len + LOG_MAX_RECORD > SESSION_LOG_BLOCK_SIZE && !seal_block()) {
+        g_stats.dropped++;
+        return false;
+    }
+
+    if (g_block_len == 0) {
+        g_block_t0 = now_ms;
+        g_block_prev_ms = now_ms;
+        memset(g_block_q, 0, sizeof(g_block_q));
+    }
+
+    uint32_t dt = (int32_t)(now_ms - g_block_prev_ms) > 0 ? now_ms - g_block_prev_ms : 0;
+    g_block_prev_ms += dt;
+
+    g_block[g_block_len++] = type;
+    g_block_len += (uint16_t)put_varint(g_block + g_block_len, dt);
+    if (len > 0) {
+        memcpy(g_block + g_block_len, payload, len);
+        g_block_len += (uint16_t)len;
+    }
+    g_stats.records++;
+    return true;
+}
+
+static void log_frame(uint32_t now_ms, const SessionFrame* f) {
+    uint8_t buf[LOG_MAX_RECORD];
+    size_t n = 0;
+
+    // Delta base is reset when a new block opens
+    if (g_block_len + LOG_MAX_RECORD > SESSION_LOG_BLOCK_SIZE) {
+        seal_block();
+    }
+    if (g_block_len == 0) {
+        memset(g_block_q, 0, sizeof(g_block_q));
+    }
+
+    int32_t q[LOG_FIELD_COUNT] = {
+        quantize(f->z), quantize(f->r), quantize(f->kappa), quantize(f->eta),
+        (int32_t)f->active_sensors
+    };
+    for (int i = 0; i < LOG_FIELD_COUNT; i++) {
+        n += put_zigzag(buf + n, q[i] - g_block_q[i]);
+    }
+    if (append_record(now_ms, SESSION_REC_FRAME, buf, n)) {
+        memcpy(g_block_q, q, sizeof(q));
+    }
+}
+
+static void log_phase(uint32_t now_ms, uint8_t from, const SessionFrame* f) {
+    uint8_t buf[LOG_MAX_RECORD];
+    size_t n = 0;
+    buf[n++] = from;
+    buf[n++] = f->phase;
+    n += put_zigzag(buf + n, quantize(f->z));
+    append_record(now_ms, SESSION_REC_PHASE, buf, n);
+}
+
+static void log_triad(uint32_t now_ms, const SessionFrame* f) {
+    uint8_t buf[2] = { f->triad_state, f->triad_crossings };
+    append_record(now_ms, SESSION_REC_TRIAD, buf, sizeof(buf));
+}
+
+static void log_kformation(uint32_t now_ms, const SessionFrame* f) {
+    uint8_t buf[LOG_MAX_RECORD];
+    size_t n = 0;
+    buf[n++] = f->k_formation ? 1 : 0;
+    buf[n++] = f->active_sensors;
+    n += put_zigzag(buf + n, quantize(f->kappa));
+    n += put_zigzag(buf + n, quantize(f->eta));
+    append_record(now_ms, SESSION_REC_KFORMATION, buf, n);
+}
+
+// ----------------------------------------------------------------------------
+// Reader
+// ----------------------------------------------------------------------------
+
+static bool reader_load_block(SessionLogReader* r) {
+    const StorageBackend* b = &r->backend;
+
+    while (r->sector_index < r->sector_count) {
+        uint32_t base = (uint32_t)r->order[r->sector_index] * b->sector_size;
+        uint8_t header[SESSION_LOG_HEADER_SIZE];
+
+        if (r->offset + SESSION_LOG_HEADER_SIZE > b->sector_size ||
+            !b->read(base + r->offset, header, sizeof(header), b->ctx) ||
+            !header_plausible(header, b->sector_size)) {
+            r->sector_index++;
+            r->offset = 0;
+            continue;
+        }
+
+        uint16_t raw_len = get_u16(header + 12);
+        uint16_t packed_len = get_u16(header + 14);
+        if (!b->read(base + r->offset + SESSION_LOG_HEADER_SIZE, r->packed, packed_len, b->ctx) ||
+            header_crc(header, r->packed, packed_len) != get_u32(header + 20)) {
+            // Lengths past a bad block cannot be trusted
+            r->corrupt++;
+            r->sector_index++;
+            r->offset = 0;
+            continue;
+        }
+        r->offset += align4(SESSION_LOG_HEADER_SIZE + packed_len);
+
+        size_t n;
+        if (get_u16(header + 10) & SESSION_LOG_FLAG_STORED) {
+            memcpy(r->block, r->packed, packed_len);
+            n = packed_len;
+        } else {
+            n = lz_decompress(r->packed, packed_len, r->block, sizeof(r->block));
+        }
+        if (n != raw_len) {
+            r->corrupt++;
+            continue;
+        }
+
+        uint16_t session = get_u16(header + 8);
+        if (session != r->session) {
+            memset(&r->state, 0, sizeof(r->state));
+            r->session = session;
+        }
+        r->seq = get_u32(header + 4);
+        r->time_ms = get_u32(header + 16);
+        r->block_len = raw_len;
+        r->block_pos = 0;
+        memset(r->q, 0, sizeof(r->q));
+        r->blocks++;
+        return true;
+    }
+    return false;
+}
+
+static bool reader_decode(SessionLogReader* r, SessionLogRecord* rec) {
+    const uint8_t* p = r->block;
+    size_t len = r->block_len;
+    size_t pos = r->block_pos;
+    uint32_t dt;
+    int32_t v;
+
+    uint8_t type = p[pos++];
+    if (!get_varint(p, len, &pos, &dt)) {
+        return false;
+    }
+    r->time_ms += dt;
+    rec->phase_from = r->state.phase;
+
+    switch (type) {
+        case SESSION_REC_START:
+            break;
+
+        case SESSION_REC_FRAME:
+            for (int i = 0; i < LOG_FIELD_COUNT; i++) {
+                if (!get_zigzag(p, len, &pos, &v)) return false;
+                r->q[i] += v;
+            }
+            r->state.z = dequantize(r->q[0]);
+            r->state.r = dequantize(r->q[1]);
+            r->state.kappa = dequantize(r->q[2]);
+            r->state.eta = dequantize(r->q[3]);
+            r->state.active_sensors = (uint8_t)r->q[4];
+            break;
+
+        case SESSION_REC_PHASE:
+            if (pos + 2 > len) return false;
+            rec->phase_from = p[pos++];
+            r->state.phase = p[pos++];
+            if (!get_zigzag(p, len, &pos, &v)) return false;
+            r->state.z = dequantize(v);
+            break;
+
+        case SESSION_REC_TRIAD:
+            if (pos + 2 > len) return false;
+            r->state.triad_state = p[pos++];
+            r->state.triad_crossings = p[pos++];
+            break;
+
+        case SESSION_REC_KFORMATION:
+            if (pos + 2 > len) return false;
+            r->state.k_formation = p[pos++] != 0;
+            r->state.active_sensors = p[pos++];
+            if (!get_zigzag(p, len, &pos, &v)) return false;
+            r->state.kappa = dequantize(v);
+            if (!get_zigzag(p, len, &pos, &v)) return false;
+            r->state.eta = dequantize(v);
+            break;
+
+        default:
+            return false;
+    }
+
+    r->block_pos = (uint16_t)pos;
+    rec->type = type;
+    rec->session = r->session;
+    rec->seq = r->seq;
+    rec->time_ms = r->time_ms;
+    rec->state = r->state;
+    return true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool session_log_init(const StorageBackend* backend) {
+    g_mounted = false;
+    if (!backend || !backend->read || !backend->write || !backend->erase ||
+        backend->sector_size < SESSION_LOG_HEADER_SIZE + SESSION_LOG_BLOCK_SIZE ||
+        backend->sector_count < 2 || backend->sector_count > SESSION_LOG_MAX_SECTORS) {
+        return false;
+    }
+
+    g_backend = *backend;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_block_len = 0;
+    g_out_len = 0;
+    g_out_pos = 0;
+    g_op_stamped = false;
+    g_have_last = false;
+    g_frame_stamped = false;
+
+    // Newest sector: highest first-block sequence
+    int32_t newest = -1;
+    uint32_t newest_seq = 0;
+    uint32_t max_seq = 0;
+    uint16_t max_session = 0;
+    for (uint16_t s = 0; s < g_backend.sector_count; s++) {
+        uint8_t header[SESSION_LOG_HEADER_SIZE];
+        if (!g_backend.read(s * g_backend.sector_size, header, sizeof(header), g_backend.ctx)) {
+            return false;
+        }
+        if (header_plausible(header, g_backend.sector_size) &&
+            (newest < 0 || get_u32(header + 4) > newest_seq)) {
+            newest = s;
+            newest_seq = get_u32(header + 4);
+            max_seq = newest_seq;
+            max_session = get_u16(header + 8);
+        }
+    }
+
+    if (newest < 0) {
+        g_write_addr = 0;
+        g_need_erase = true;
+    } else {
+        // Walk the valid blocks of the newest sector
+        uint32_t base = (uint32_t)newest * g_backend.sector_size;
+        uint32_t offset = 0;
+        while (offset + SESSION_LOG_HEADER_SIZE <= g_backend.sector_size &&
+               read_block(&g_backend, base + offset, g_out)) {
+            max_seq = get_u32(g_out + 4);
+            max_session = get_u16(g_out + 8);
+            offset += align4(SESSION_LOG_HEADER_SIZE + get_u16(g_out + 14));
+        }
+
+        // Resume there only if the rest of the sector is still erased
+        bool erased = true;
+        for (uint32_t off = offset; erased && off < g_backend.sector_size; off += SESSION_LOG_PAGE_SIZE) {
+            uint32_t n = g_backend.sector_size - off < SESSION_LOG_PAGE_SIZE ?
+                         g_backend.sector_size - off : SESSION_LOG_PAGE_SIZE;
+            if (!g_backend.read(base + off, g_out, n, g_backend.ctx)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < n; i++) {
+                if (g_out[i] != 0xFF) {
+                    erased = false;
+                    break;
+                }
+            }
+        }
+
+        g_write_addr = base + offset;
+        g_need_erase = false;
+        if (!erased || offset >= g_backend.sector_size) {
+            g_write_addr = base;
+            start_next_sector();
+        }
+    }
+
+    g_stats.next_seq = max_seq + 1;
+    g_stats.session = (uint16_t)(max_session + 1);
+    if (g_stats.session == 0) {
+        g_stats.session = 1;
+    }
+    g_mounted = true;
+    return true;
+}
+
+void session_log_frame(uint32_t now_ms, const SessionFrame* frame) {
+    if (!g_mounted || !frame) {
+        return;
+    }
+
+    if (!g_have_last) {
+        append_record(now_ms, SESSION_REC_START, NULL, 0);
+        log_phase(now_ms, frame->phase, frame);
+        log_triad(now_ms, frame);
+        log_kformation(now_ms, frame);
+    } else {
+        if (frame->phase != g_last.phase) {
+            log_phase(now_ms, g_last.phase, frame);
+        }
+        if (frame->triad_state != g_last.triad_state ||
+            frame->triad_crossings != g_last.triad_crossings) {
+            log_triad(now_ms, frame);
+        }
+        if (frame->k_formation != g_last.k_formation) {
+            log_kformation(now_ms, frame);
+        }
+    }
+    g_last = *frame;
+    g_have_last = true;
+
+    if (g_frame_stamped && now_ms - g_last_frame_ms < SESSION_LOG_FRAME_INTERVAL_MS) {
+        g_stats.frames_skipped++;
+        return;
+    }
+    g_last_frame_ms = now_ms;
+    g_frame_stamped = true;
+    log_frame(now_ms, frame);
+}
+
+void session_log_tick(uint32_t now_ms) {
+    if (!g_mounted) {
+        return;
+    }
+
+    if (g_block_len > 0 && now_ms - g_block_t0 >= SESSION_LOG_SEAL_MS) {
+        seal_block();
+    }
+    if (g_out_len == 0) {
+        return;
+    }
+    if (g_op_stamped && now_ms - g_last_op_ms < SESSION_LOG_OP_INTERVAL_MS) {
+        return;
+    }
+    g_last_op_ms = now_ms;
+    g_op_stamped = true;
+    write_step();
+}
+
+bool session_log_flush(void) {
+    if (!g_mounted) {
+        return false;
+    }
+
+    uint32_t errors = g_stats.write_errors;
+    for (int pass = 0; pass < 2; pass++) {
+        while (g_out_len != 0) {
+            write_step();
+        }
+        seal_block();
+    }
+    return g_stats.write_errors == errors && g_block_len == 0;
+}
+
+const SessionLogStats* session_log_get_stats(void) {
+    return &g_stats;
+}
+
+bool session_log_reader_open(SessionLogReader* reader, const StorageBackend* backend) {
+    memset(reader, 0, sizeof(*reader));
+    if (!backend || !backend->read || backend->sector_count > SESSION_LOG_MAX_SECTORS ||
+        backend->sector_size < SESSION_LOG_HEADER_SIZE) {
+        return false;
+    }
+    reader->backend = *backend;
+
+    // Insertion sort of sectors by first block sequence
+    uint32_t seqs[SESSION_LOG_MAX_SECTORS];
+    for (uint16_t s = 0; s < backend->sector_count; s++) {
+        uint8_t header[SESSION_LOG_HEADER_SIZE];
+        if (!backend->read(s * backend->sector_size, header, sizeof(header), backend->ctx) ||
+            !header_plausible(header, backend->sector_size)) {
+            continue;
+        }
+        uint32_t seq = get_u32(header + 4);
+        uint16_t i = reader->sector_count++;
+        while (i > 0 && seqs[i - 1] > seq) {
+            seqs[i] = seqs[i - 1];
+            reader->order[i] = reader->order[i - 1];
+            i--;
+        }
+        seqs[i] = seq;
+        reader->order[i] = s;
+    }
+    return reader->sector_count > 0;
+}
+
+bool session_log_reader_next(SessionLogReader* reader, SessionLogRecord* record) {
+    while (true) {
+        if (reader->block_pos >= reader->block_len) {
+            if (!reader_load_block(reader)) {
+                return false;
+            }
+            continue;
+        }
+        if (reader_decode(reader, record)) {
+            return true;
+        }
+        // Rest of a block after an undecodable record is lost
+        reader->corrupt++;
+        reader->block_pos = reader->block_len;
+    }
+}
+
+const char* session_log_type_string(uint8_t type) {
+    switch (type) {
+        case SESSION_REC_START:      return "START";
+        case SESSION_REC_FRAME:      return "FRAME";
+        case SESSION_REC_PHASE:      return "PHASE";
+        case SESSION_REC_TRIAD:      return "TRIAD";
+        case SESSION_REC_KFORMATION: return "KFORMATION";
+        default:                     return "UNKNOWN";
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file ucf_session_log_esp32.cpp
+ * @brief ESP32 backend for the session recorder
+ *
+ * The "ucflog" data partition (partitions_ucf.csv), written directly with
+ * esp_partition_*. There is no fallback: on stock partition tables the
+ * recorder stays disabled and session_log_*() calls are no-ops.
+ */
+
+#include "ucf_session_log.h"
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define SESSION_LOG_PARTITION_LABEL "ucflog"
+#define SESSION_LOG_FLASH_SECTOR    4096
+
+static const esp_partition_t* g_partition = NULL;
+static StorageBackend g_device_backend;
+static bool g_started = false;
+
+// ============================================================================
+// PARTITION BACKEND
+// ============================================================================
+
+static bool partition_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    return esp_partition_read(g_partition, addr, buf, len) == ESP_OK;
+}
+
+static bool partition_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    return esp_partition_write(g_partition, addr, data, len) == ESP_OK;
+}
+
+static bool partition_erase(uint16_t sector, void* ctx) {
+    return esp_partition_erase_range(g_partition, (size_t)sector * SESSION_LOG_FLASH_SECTOR,
+                                     SESSION_LOG_FLASH_SECTOR) == ESP_OK;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool session_log_begin(void) {
+    if (g_started) {
+        return true;
+    }
+
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           SESSION_LOG_PARTITION_LABEL);
+    if (!g_partition) {
+        Serial.println("[LOG] No " SESSION_LOG_PARTITION_LABEL " partition, session log disabled");
+        return false;
+    }
+
+    memset(&g_device_backend, 0, sizeof(g_device_backend));
+    g_device_backend.sector_size = SESSION_LOG_FLASH_SECTOR;
+    g_device_backend.sector_count = (uint16_t)(g_partition->size / SESSION_LOG_FLASH_SECTOR);
+    g_device_backend.read = partition_read;
+    g_device_backend.write = partition_write;
+    g_device_backend.erase = partition_erase;
+
+    if (!session_log_init(&g_device_backend)) {
+        Serial.println("[LOG] Mount failed");
+        return false;
+    }
+
+    const SessionLogStats* stats = session_log_get_stats();
+    Serial.printf("[LOG] Session %u, %u x %u bytes, next block %u\n",
+                  stats->session, g_device_backend.sector_count,
+                  g_device_backend.sector_size, stats->next_seq);
+    g_started = true;
+    return true;
+}
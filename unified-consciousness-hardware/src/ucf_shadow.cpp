@@ -0,0 +1,105 @@
+/**
+ * @file ucf_shadow.cpp
+ * @brief Output shadow registers and per-tick flush
+ *
+ * Each output holds two words: the value last requested (any task, relaxed
+ * atomic store) and the value last written to the hardware (the owning
+ * task only; SHADOW_UNKNOWN after shadow_invalidate()). A flush
+ * compares the two, so it needs no dirty flags and a set racing a flush is
+ * simply picked up by the next one.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_shadow.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+typedef struct {
+    ShadowWriteFn fn;
+    void* ctx;
+    uint32_t requested;
+    uint32_t written;
+} ShadowReg;
+
+static ShadowReg g_regs[SHADOW_COUNT];
+static uint32_t g_requested = 0;
+static uint32_t g_written = 0;
+
+// ============================================================================
+// SHADOW API
+// ============================================================================
+
+void shadow_init(void) {
+    memset(g_regs, 0, sizeof(g_regs));
+    for (int i = 0; i < SHADOW_COUNT; i++) {
+        g_regs[i].requested = SHADOW_UNKNOWN;
+        g_regs[i].written = SHADOW_UNKNOWN;
+    }
+    g_requested = 0;
+    g_written = 0;
+}
+
+void shadow_bind(ShadowId id, ShadowWriteFn fn, void* ctx, uint32_t initial) {
+    if ((unsigned)id >= SHADOW_COUNT) {
+        return;
+    }
+    ShadowReg* reg = &g_regs[id];
+    reg->fn = fn;
+    reg->ctx = ctx;
+    reg->requested = initial;
+    reg->written = SHADOW_UNKNOWN;
+    if (initial != SHADOW_UNKNOWN && fn != NULL) {
+        fn(initial, ctx);
+        reg->written = initial;
+    }
+}
+
+void shadow_set(ShadowId id, uint32_t value) {
+    if ((unsigned)id >= SHADOW_COUNT || value == SHADOW_UNKNOWN) {
+        return;
+    }
+    __atomic_store_n(&g_regs[id].requested, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_requested, 1, __ATOMIC_RELAXED);
+}
+
+uint32_t shadow_get(ShadowId id) {
+    if ((unsigned)id >= SHADOW_COUNT) {
+        return SHADOW_UNKNOWN;
+    }
+    return __atomic_load_n(&g_regs[id].requested, __ATOMIC_RELAXED);
+}
+
+void shadow_invalidate(ShadowId id) {
+    if ((unsigned)id >= SHADOW_COUNT) {
+        return;
+    }
+    g_regs[id].written = SHADOW_UNKNOWN;
+}
+
+size_t shadow_flush(void) {
+    size_t count = 0;
+    for (int i = 0; i < SHADOW_COUNT; i++) {
+        ShadowReg* reg = &g_regs[i];
+        uint32_t value = __atomic_load_n(&reg->requested, __ATOMIC_RELAXED);
+        if (reg->fn == NULL || value == SHADOW_UNKNOWN || value == reg->written) {
+            continue;
+        }
+        reg->fn(value, reg->ctx);
+        reg->written = value;
+        count++;
+    }
+    if (count > 0) {
+        __atomic_fetch_add(&g_written, (uint32_t)count, __ATOMIC_RELAXED);
+    }
+    return count;
+}
+
+void shadow_get_stats(ShadowStats* stats) {
+    stats->requested = __atomic_load_n(&g_requested, __ATOMIC_RELAXED);
+    stats->written = __atomic_load_n(&g_written, __ATOMIC_RELAXED);
+    stats->avoided = stats->requested > stats->written ? stats->requested - stats->written : 0;
+}
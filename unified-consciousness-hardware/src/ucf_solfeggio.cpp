@@ -10,6 +10,7 @@
 #ifdef UCF_V4_MODULES
 
 #include "ucf_solfeggio.h"
+#include "ucf_latency.h"
 #include <Arduino.h>
 #include <math.h>
 #include "ucf/ucf_config.h"
@@ -220,6 +221,7 @@ void solfeggio_update_from_z(float z) {
         g_solfeggio.config.frequency = solfeggio_tier_to_frequency(tier);
         g_solfeggio.phase_increment = (float)g_solfeggio.config.frequency /
                                        SOLFEGGIO_SAMPLE_RATE;
+        LAT_MARK(LAT_AUDIO);
 
         UCF_LOG("Solfeggio tier %d, freq %d Hz", tier, g_solfeggio.config.frequency);
     }
@@ -0,0 +1,728 @@
+/**
+ * @file ucf_storage.cpp
+ * @brief UCF Persistent Storage Manager Implementation v4.0.0
+ *
+ * Sector layout:
+ *   [0..16)  header: magic, generation, erase count, CRC32 of the first 12 bytes
+ *   [16..)   records, 4-byte aligned, until the first erased (0xFF) header
+ *
+ * Record layout (little-endian):
+ *   id(1) reserved(1) version(2) length(2) ~length(2) crc32(4) payload(length)
+ *   The CRC covers the first 8 header bytes and the payload.
+ *
+ * The active sector is the valid one with the highest generation; within
+ * it, the last record of a region wins. Compaction copies the live record
+ * of every region into the next sector and writes that sector's magic
+ * last, so an interrupted compaction leaves the old sector in force.
+ *
+ * Erasing a sector programs the rest of its next header straight away
+ * (generation, erase count and CRC, magic still 0xFF). A sector erased
+ * ahead of time by storage_tick() keeps its erase count across a reboot
+ * that way, and cannot be taken for the active one.
+ *
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_storage.h"
+#include "ucf_checksum.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define STORAGE_ID_ERASED       0xFF
+#define STORAGE_COPY_CHUNK      64
+
+// Region flags
+#define REGION_REGISTERED       0x01
+#define REGION_VALID            0x02    // Shadow holds data of the registered version
+#define REGION_DIRTY            0x04
+#define REGION_STALE            0x08    // Stored record has another version
+
+typedef struct {
+    uint8_t id;
+    uint8_t flags;
+    const char* name;
+    uint16_t version;
+    uint16_t size;
+    uint16_t shadow_offset;
+
+    // Live record in the active sector (rec_addr 0 = none)
+    uint32_t rec_addr;
+    uint16_t rec_version;
+    uint16_t rec_length;
+} StorageRegion;
+
+static StorageBackend g_backend;
+static bool g_mounted = false;
+
+static StorageRegion g_regions[STORAGE_MAX_REGIONS];
+static uint8_t g_region_count = 0;
+
+static uint8_t g_shadow[STORAGE_SHADOW_SIZE];
+static uint16_t g_shadow_used = 0;
+
+static uint16_t g_active_sector = 0;
+static uint32_t g_write_pos = 0;
+static uint32_t g_generation = 0;
+static uint32_t g_active_erase_count = 0;
+static bool g_next_erased = false;
+static uint32_t g_next_erase_count = 0;
+
+static bool g_dirty = false;
+static bool g_dirty_stamped = false;
+static uint32_t g_dirty_since_ms = 0;
+
+static StorageStats g_stats;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static inline uint32_t align4(uint32_t n) {
+    return (n + 3) & ~3u;
+}
+
+static inline void lock(void) {
+    if (g_backend.lock) {
+        g_backend.lock(g_backend.ctx);
+    }
+}
+
+static inline void unlock(void) {
+    if (g_backend.unlock) {
+        g_backend.unlock(g_backend.ctx);
+    }
+}
+
+static inline uint32_t sector_base(uint16_t sector) {
+    return (uint32_t)sector * g_backend.sector_size;
+}
+
+static StorageRegion* find_region(uint8_t id) {
+    for (uint8_t i = 0; i < g_region_count; i++) {
+        if (g_regions[i].id == id) {
+            return &g_regions[i];
+        }
+    }
+    return NULL;
+}
+
+static StorageRegion* find_or_add_region(uint8_t id) {
+    StorageRegion* r = find_region(id);
+    if (r || g_region_count == STORAGE_MAX_REGIONS) {
+        return r;
+    }
+    r = &g_regions[g_region_count++];
+    memset(r, 0, sizeof(*r));
+    r->id = id;
+    return r;
+}
+
+static bool erase_sector(uint16_t sector) {
+    if (!g_backend.erase(sector, g_backend.ctx)) {
+        return false;
+    }
+    g_stats.erases++;
+    return true;
+}
+
+/**
+ * @brief Read a sector header
+ * @return true if the header is valid
+ */
+static bool read_sector_header(uint16_t sector, uint32_t* generation, uint32_t* erase_count) {
+    uint8_t h[STORAGE_SECTOR_HEADER_SIZE];
+    if (!g_backend.read(sector_base(sector), h, sizeof(h), g_backend.ctx)) {
+        return false;
+    }
+    if (get_u32(h) != STORAGE_SECTOR_MAGIC || get_u32(h + 12) != checksum_crc32(h, 12)) {
+        return false;
+    }
+    *generation = get_u32(h + 4);
+    *erase_count = get_u32(h + 8);
+    return true;
+}
+
+/**
+ * @brief Read a sector's erase count from its header, complete or prepared
+ * @return false if the sector has neither (never used, or a torn header)
+ */
+static bool read_erase_count(uint16_t sector, uint32_t* erase_count) {
+    uint8_t h[STORAGE_SECTOR_HEADER_SIZE];
+    if (!g_backend.read(sector_base(sector), h, sizeof(h), g_backend.ctx)) {
+        return false;
+    }
+    uint32_t magic = get_u32(h);
+    if (magic == 0xFFFFFFFF) {
+        put_u32(h, STORAGE_SECTOR_MAGIC);  // Prepared: the CRC already covers it
+    } else if (magic != STORAGE_SECTOR_MAGIC) {
+        return false;
+    }
+    if (get_u32(h + 12) != checksum_crc32(h, 12)) {
+        return false;
+    }
+    *erase_count = get_u32(h + 8);
+    return true;
+}
+
+static void encode_sector_header(uint8_t* h, uint32_t generation, uint32_t erase_count) {
+    put_u32(h, STORAGE_SECTOR_MAGIC);
+    put_u32(h + 4, generation);
+    put_u32(h + 8, erase_count);
+    put_u32(h + 12, checksum_crc32(h, 12));
+}
+
+static bool write_sector_header(uint16_t sector, uint32_t generation, uint32_t erase_count) {
+    uint8_t h[STORAGE_SECTOR_HEADER_SIZE];
+    encode_sector_header(h, generation, erase_count);
+    return g_backend.write(sector_base(sector), h, sizeof(h), g_backend.ctx);
+}
+
+/**
+ * @brief Build a record header for a payload
+ */
+static void encode_record_header(uint8_t* h, uint8_t id, uint16_t version,
+                                 const uint8_t* payload, uint16_t length) {
+    h[0] = id;
+    h[1] = 0;
+    put_u16(h + 2, version);
+    put_u16(h + 4, length);
+    put_u16(h + 6, (uint16_t)~length);
+    put_u32(h + 8, checksum_crc32_update(checksum_crc32(h, 8), payload, length));
+}
+
+/**
+ * @brief Append a region's shadow contents at 'addr' in the active sector
+ */
+static bool write_record(uint32_t addr, const StorageRegion* r) {
+    const uint8_t* payload = g_shadow + r->shadow_offset;
+    uint8_t h[STORAGE_RECORD_HEADER_SIZE];
+    encode_record_header(h, r->id, r->version, payload, r->size);
+
+    if (!g_backend.write(addr, h, sizeof(h), g_backend.ctx) ||
+        !g_backend.write(addr + sizeof(h), payload, r->size, g_backend.ctx)) {
+        return false;
+    }
+    g_stats.records++;
+    g_stats.bytes += sizeof(h) + r->size;
+    return true;
+}
+
+/**
+ * @brief Copy a record verbatim (regions this firmware has not registered)
+ */
+static bool copy_record(uint32_t src, uint32_t dst, uint32_t len) {
+    uint8_t buf[STORAGE_COPY_CHUNK];
+    for (uint32_t off = 0; off < len; off += sizeof(buf)) {
+        uint32_t n = (len - off < sizeof(buf)) ? len - off : sizeof(buf);
+        if (!g_backend.read(src + off, buf, n, g_backend.ctx) ||
+            !g_backend.write(dst + off, buf, n, g_backend.ctx)) {
+            return false;
+        }
+    }
+    g_stats.records++;
+    g_stats.bytes += len;
+    return true;
+}
+
+/**
+ * @brief Load a region's stored record into its shadow slot
+ */
+static bool load_region(StorageRegion* r) {
+    uint8_t* slot = g_shadow + r->shadow_offset;
+    memset(slot, 0, r->size);
+    r->flags &= ~(REGION_VALID | REGION_STALE);
+
+    if (r->rec_addr == 0) {
+        return true;
+    }
+    if (r->rec_version != r->version || r->rec_length > r->size) {
+        r->flags |= REGION_STALE;
+        return true;
+    }
+    if (!g_backend.read(r->rec_addr + STORAGE_RECORD_HEADER_SIZE, slot, r->rec_length, g_backend.ctx)) {
+        return false;
+    }
+    r->flags |= REGION_VALID;
+    return true;
+}
+
+/**
+ * @brief Index the records of the active sector
+ *
+ * A record that fails validation ends the scan; the rest of the sector is
+ * treated as used so the next commit compacts into a fresh sector.
+ */
+static bool scan_active_sector(void) {
+    uint32_t base = sector_base(g_active_sector);
+    uint32_t pos = STORAGE_SECTOR_HEADER_SIZE;
+    uint8_t h[STORAGE_RECORD_HEADER_SIZE];
+    static const uint8_t erased[STORAGE_RECORD_HEADER_SIZE] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+
+    while (pos + STORAGE_RECORD_HEADER_SIZE <= g_backend.sector_size) {
+        if (!g_backend.read(base + pos, h, sizeof(h), g_backend.ctx)) {
+            return false;
+        }
+        if (memcmp(h, erased, sizeof(h)) == 0) {
+            break;
+        }
+
+        uint16_t length = get_u16(h + 4);
+        bool valid = h[0] != STORAGE_ID_ERASED &&
+                     get_u16(h + 6) == (uint16_t)~length &&
+                     pos + STORAGE_RECORD_HEADER_SIZE + length <= g_backend.sector_size;
+
+        // Verify the CRC over header and payload
+        uint32_t crc = checksum_crc32(h, 8);
+        uint8_t buf[STORAGE_COPY_CHUNK];
+        for (uint32_t off = 0; valid && off < length; off += sizeof(buf)) {
+            uint32_t n = (length - off < sizeof(buf)) ? length - off : sizeof(buf);
+            if (!g_backend.read(base + pos + STORAGE_RECORD_HEADER_SIZE + off, buf, n, g_backend.ctx)) {
+                return false;
+            }
+            crc = checksum_crc32_update(crc, buf, n);
+        }
+
+        if (!valid || crc != get_u32(h + 8)) {
+            g_stats.corrupt++;
+            pos = g_backend.sector_size;
+            break;
+        }
+
+        StorageRegion* r = find_or_add_region(h[0]);
+        if (r) {
+            r->rec_addr = base + pos;
+            r->rec_version = get_u16(h + 2);
+            r->rec_length = length;
+        }
+        pos += align4(STORAGE_RECORD_HEADER_SIZE + length);
+    }
+
+    g_write_pos = (pos > g_backend.sector_size) ? g_backend.sector_size : pos;
+    return true;
+}
+
+/**
+ * @brief Erase sector 0 and make it the only valid sector
+ */
+static bool format(void) {
+    for (uint16_t s = 0; s < g_backend.sector_count; s++) {
+        if (!erase_sector(s)) {
+            return false;
+        }
+    }
+    g_active_sector = 0;
+    g_generation = 1;
+    g_active_erase_count = 1;
+    g_write_pos = STORAGE_SECTOR_HEADER_SIZE;
+    if (!write_sector_header(0, g_generation, g_active_erase_count)) {
+        return false;
+    }
+    return !g_backend.sync || g_backend.sync(g_backend.ctx);
+}
+
+/**
+ * @brief Erase a sector and record its next header but the magic
+ * @param generation Generation the sector will hold once compacted into
+ * @return New erase count, 0 on failure
+ */
+static uint32_t prepare_sector(uint16_t sector, uint32_t generation) {
+    uint32_t erase_count;
+    if (!read_erase_count(sector, &erase_count)) {
+        // Never used, or torn
+        erase_count = 0;
+    }
+    erase_count++;
+
+    uint8_t h[STORAGE_SECTOR_HEADER_SIZE];
+    encode_sector_header(h, generation, erase_count);
+    if (!erase_sector(sector) ||
+        !g_backend.write(sector_base(sector) + 4, h + 4, sizeof(h) - 4, g_backend.ctx)) {
+        return 0;
+    }
+    return erase_count;
+}
+
+/**
+ * @brief Move every live record into the next sector
+ *
+ * Dirty and valid registered regions are written from the shadow; records
+ * of unregistered regions are copied from flash; records of a different
+ * version than the registered one are dropped.
+ */
+static StorageStatus compact(void) {
+    uint16_t target = (uint16_t)((g_active_sector + 1) % g_backend.sector_count);
+    uint32_t target_base = sector_base(target);
+
+    uint32_t erase_count = g_next_erase_count;
+    if (!g_next_erased) {
+        erase_count = prepare_sector(target, g_generation + 1);
+        if (!erase_count) {
+            return STORAGE_ERR_IO;
+        }
+    }
+    g_next_erased = false;
+
+    uint32_t new_addr[STORAGE_MAX_REGIONS];
+    uint32_t pos = STORAGE_SECTOR_HEADER_SIZE;
+
+    for (uint8_t i = 0; i < g_region_count; i++) {
+        StorageRegion* r = &g_regions[i];
+        new_addr[i] = 0;
+
+        bool from_shadow = (r->flags & REGION_REGISTERED) && (r->flags & (REGION_VALID | REGION_DIRTY));
+        bool from_flash = !(r->flags & REGION_REGISTERED) && r->rec_addr != 0;
+        if (!from_shadow && !from_flash) {
+            continue;
+        }
+
+        uint32_t len = STORAGE_RECORD_HEADER_SIZE + (from_shadow ? r->size : r->rec_length);
+        if (pos + len > g_backend.sector_size) {
+            return STORAGE_ERR_FULL;
+        }
+
+        bool ok = from_shadow ? write_record(target_base + pos, r)
+                              : copy_record(r->rec_addr, target_base + pos, len);
+        if (!ok) {
+            return STORAGE_ERR_IO;
+        }
+        new_addr[i] = target_base + pos;
+        pos += align4(len);
+    }
+
+    // Magic last: until it is written the old sector stays authoritative
+    uint8_t magic[4];
+    put_u32(magic, STORAGE_SECTOR_MAGIC);
+    if (!g_backend.write(target_base, magic, sizeof(magic), g_backend.ctx) ||
+        (g_backend.sync && !g_backend.sync(g_backend.ctx))) {
+        return STORAGE_ERR_IO;
+    }
+
+    for (uint8_t i = 0; i < g_region_count; i++) {
+        StorageRegion* r = &g_regions[i];
+        r->rec_addr = new_addr[i];
+        if (r->flags & REGION_REGISTERED) {
+            r->rec_version = r->version;
+            r->rec_length = r->size;
+            r->flags &= ~(REGION_DIRTY | REGION_STALE);
+        }
+    }
+
+    g_active_sector = target;
+    g_generation++;
+    g_active_erase_count = erase_count;
+    g_write_pos = pos;
+    g_stats.compactions++;
+    g_stats.generation = g_generation;
+    if (erase_count > g_stats.max_erase_count) {
+        g_stats.max_erase_count = erase_count;
+    }
+    return STORAGE_OK;
+}
+
+static bool register_locked(uint8_t id, const char* name, uint16_t size, uint16_t version) {
+    if (!g_mounted || id == STORAGE_ID_ERASED || size == 0) {
+        return false;
+    }
+
+    StorageRegion* r = find_or_add_region(id);
+    if (!r) {
+        return false;
+    }
+    if (r->flags & REGION_REGISTERED) {
+        return r->size == size && r->version == version;
+    }
+    if (g_shadow_used + size > STORAGE_SHADOW_SIZE) {
+        return false;
+    }
+
+    r->name = name;
+    r->size = size;
+    r->version = version;
+    r->shadow_offset = g_shadow_used;
+    if (!load_region(r)) {
+        return false;
+    }
+
+    g_shadow_used += size;
+    r->flags |= REGION_REGISTERED;
+    return true;
+}
+
+static StorageStatus region_status_locked(uint8_t id) {
+    if (!g_mounted) {
+        return STORAGE_ERR_NOT_READY;
+    }
+    StorageRegion* r = find_region(id);
+    if (!r || !(r->flags & REGION_REGISTERED)) {
+        return STORAGE_ERR_PARAM;
+    }
+    if (r->flags & REGION_VALID) {
+        return STORAGE_OK;
+    }
+    return (r->flags & REGION_STALE) ? STORAGE_ERR_VERSION : STORAGE_ERR_NOT_FOUND;
+}
+
+static StorageStatus read_locked(uint8_t id, uint16_t offset, void* buf, uint16_t len) {
+    StorageStatus status = region_status_locked(id);
+    if (status != STORAGE_OK) {
+        return status;
+    }
+    StorageRegion* r = find_region(id);
+    if ((uint32_t)offset + len > r->size) {
+        return STORAGE_ERR_PARAM;
+    }
+    memcpy(buf, g_shadow + r->shadow_offset + offset, len);
+    return STORAGE_OK;
+}
+
+static StorageStatus write_locked(uint8_t id, uint16_t offset, const void* data, uint16_t len) {
+    if (!g_mounted) {
+        return STORAGE_ERR_NOT_READY;
+    }
+    StorageRegion* r = find_region(id);
+    if (!r || !(r->flags & REGION_REGISTERED) || (uint32_t)offset + len > r->size) {
+        return STORAGE_ERR_PARAM;
+    }
+
+    uint8_t* dst = g_shadow + r->shadow_offset + offset;
+    if ((r->flags & REGION_VALID) && memcmp(dst, data, len) == 0) {
+        g_stats.unchanged++;
+        return STORAGE_OK;
+    }
+
+    memcpy(dst, data, len);
+    r->flags = (uint8_t)((r->flags | REGION_VALID | REGION_DIRTY) & ~REGION_STALE);
+
+    if (g_dirty) {
+        g_stats.coalesced++;
+    } else {
+        g_dirty = true;
+        g_dirty_stamped = false;
+    }
+    return STORAGE_OK;
+}
+
+static StorageStatus flush_locked(void) {
+    if (!g_mounted) {
+        return STORAGE_ERR_NOT_READY;
+    }
+    if (!g_dirty) {
+        return STORAGE_OK;
+    }
+
+    for (uint8_t i = 0; i < g_region_count; i++) {
+        StorageRegion* r = &g_regions[i];
+        if (!(r->flags & REGION_DIRTY)) {
+            continue;
+        }
+
+        uint32_t len = align4(STORAGE_RECORD_HEADER_SIZE + r->size);
+        if (g_write_pos + len > g_backend.sector_size) {
+            // Compaction writes every remaining dirty region as well
+            StorageStatus status = compact();
+            if (status != STORAGE_OK) {
+                return status;
+            }
+            break;
+        }
+
+        uint32_t addr = sector_base(g_active_sector) + g_write_pos;
+        if (!write_record(addr, r)) {
+            // Partially programmed space cannot be reused
+            g_write_pos = g_backend.sector_size;
+            return STORAGE_ERR_IO;
+        }
+        g_write_pos += len;
+        r->rec_addr = addr;
+        r->rec_version = r->version;
+        r->rec_length = r->size;
+        r->flags &= ~REGION_DIRTY;
+    }
+
+    if (g_backend.sync && !g_backend.sync(g_backend.ctx)) {
+        return STORAGE_ERR_IO;
+    }
+
+    g_dirty = false;
+    g_stats.commits++;
+    return STORAGE_OK;
+}
+
+static void tick_locked(uint32_t now_ms) {
+    if (!g_mounted) {
+        return;
+    }
+
+    if (g_dirty) {
+        if (!g_dirty_stamped) {
+            g_dirty_stamped = true;
+            g_dirty_since_ms = now_ms;
+        } else if (now_ms - g_dirty_since_ms >= STORAGE_COMMIT_DELAY_MS) {
+            // On failure, retry after another window
+            if (flush_locked() != STORAGE_OK) {
+                g_dirty_since_ms = now_ms;
+            }
+        }
+        return;
+    }
+
+    // Idle and past half the sector: prepare the compaction target
+    if (!g_next_erased && g_write_pos > g_backend.sector_size / 2) {
+        uint16_t next = (uint16_t)((g_active_sector + 1) % g_backend.sector_count);
+        g_next_erase_count = prepare_sector(next, g_generation + 1);
+        g_next_erased = g_next_erase_count != 0;
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool storage_init(const StorageBackend* backend) {
+    g_mounted = false;
+    g_backend = *backend;
+    memset(g_regions, 0, sizeof(g_regions));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_region_count = 0;
+    g_shadow_used = 0;
+    g_next_erased = false;
+    g_dirty = false;
+    g_dirty_stamped = false;
+
+    if (g_backend.sector_count < STORAGE_MIN_SECTORS ||
+        g_backend.sector_size < STORAGE_SECTOR_HEADER_SIZE + STORAGE_RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    // Active sector: valid header with the highest generation
+    bool found = false;
+    for (uint16_t s = 0; s < g_backend.sector_count; s++) {
+        uint32_t gen, erase_count;
+        if (read_erase_count(s, &erase_count) && erase_count > g_stats.max_erase_count) {
+            g_stats.max_erase_count = erase_count;
+        }
+        if (!read_sector_header(s, &gen, &erase_count)) {
+            continue;
+        }
+        if (!found || (int32_t)(gen - g_generation) > 0) {
+            found = true;
+            g_active_sector = s;
+            g_generation = gen;
+            g_active_erase_count = erase_count;
+        }
+    }
+
+    if (found) {
+        if (!scan_active_sector()) {
+            return false;
+        }
+    } else {
+        if (g_backend.before_format) {
+            g_backend.before_format(g_backend.ctx);
+        }
+        if (!format()) {
+            return false;
+        }
+    }
+
+    g_stats.generation = g_generation;
+    g_mounted = true;
+    return true;
+}
+
+bool storage_register(uint8_t id, const char* name, uint16_t size, uint16_t version) {
+    lock();
+    bool ok = register_locked(id, name, size, version);
+    unlock();
+    return ok;
+}
+
+StorageStatus storage_region_status(uint8_t id) {
+    lock();
+    StorageStatus status = region_status_locked(id);
+    unlock();
+    return status;
+}
+
+StorageStatus storage_read_at(uint8_t id, uint16_t offset, void* buf, uint16_t len) {
+    lock();
+    StorageStatus status = read_locked(id, offset, buf, len);
+    unlock();
+    return status;
+}
+
+StorageStatus storage_write_at(uint8_t id, uint16_t offset, const void* data, uint16_t len) {
+    lock();
+    StorageStatus status = write_locked(id, offset, data, len);
+    unlock();
+    return status;
+}
+
+StorageStatus storage_read(uint8_t id, void* buf, uint16_t len) {
+    return storage_read_at(id, 0, buf, len);
+}
+
+StorageStatus storage_write(uint8_t id, const void* data, uint16_t len) {
+    return storage_write_at(id, 0, data, len);
+}
+
+bool storage_pending(void) {
+    return g_dirty;
+}
+
+StorageStatus storage_flush(void) {
+    lock();
+    StorageStatus status = flush_locked();
+    unlock();
+    return status;
+}
+
+void storage_tick(uint32_t now_ms) {
+    lock();
+    tick_locked(now_ms);
+    unlock();
+}
+
+const StorageStats* storage_get_stats(void) {
+    return &g_stats;
+}
+
+uint32_t storage_get_used(void) {
+    return g_mounted ? g_write_pos : 0;
+}
+
+const char* storage_status_string(StorageStatus status) {
+    switch (status) {
+        case STORAGE_OK:            return "OK";
+        case STORAGE_ERR_NOT_READY: return "Not mounted";
+        case STORAGE_ERR_PARAM:     return "Bad region or range";
+        case STORAGE_ERR_NOT_FOUND: return "Not found";
+        case STORAGE_ERR_VERSION:   return "Version mismatch";
+        case STORAGE_ERR_FULL:      return "Storage full";
+        case STORAGE_ERR_IO:        return "I/O error";
+        default:                    return "Unknown";
+    }
+}
@@ -0,0 +1,192 @@
+/**
+ * @file ucf_storage_esp32.cpp
+ * @brief ESP32 backends for the persistent storage manager
+ *
+ * Preferred: the "ucfstore" data partition (partitions_ucf.csv), written
+ * directly with esp_partition_* so records are appended without rewriting
+ * the sector and compaction rotates through all of its 4 KB sectors.
+ *
+ * Fallback (stock partition tables): one EEPROM library buffer opened once
+ * at STORAGE_EEPROM_SIZE. EEPROM.commit() rewrites the whole buffer, so
+ * this only saves the repeated begin()/end() shadow copies.
+ *
+ * Older firmware kept its settings at fixed EEPROM addresses. When the
+ * store is formatted for the first time, those bytes are copied aside
+ * first (the fallback is about to erase them); each module imports its
+ * own legacy layout from the copy through storage_legacy_read().
+ */
+
+#include "ucf_storage.h"
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define STORAGE_PARTITION_LABEL     "ucfstore"
+#define STORAGE_FLASH_SECTOR        4096
+#define STORAGE_EEPROM_SIZE         4096
+#define STORAGE_EEPROM_SECTOR       2048
+#define STORAGE_LEGACY_SIZE         1280    // Covers the largest old layout (sigil table)
+
+static const esp_partition_t* g_partition = NULL;
+static SemaphoreHandle_t g_mutex = NULL;
+static StorageBackend g_device_backend;
+static bool g_started = false;
+
+static uint8_t g_legacy[STORAGE_LEGACY_SIZE];
+static bool g_legacy_valid = false;     // g_legacy holds pre-storage EEPROM bytes
+
+// ============================================================================
+// LOCKING (loop() and the OTA task both save settings)
+// ============================================================================
+
+static void storage_lock(void* ctx) {
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+}
+
+static void storage_unlock(void* ctx) {
+    xSemaphoreGive(g_mutex);
+}
+
+// ============================================================================
+// PARTITION BACKEND
+// ============================================================================
+
+static bool partition_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    return esp_partition_read(g_partition, addr, buf, len) == ESP_OK;
+}
+
+static bool partition_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    return esp_partition_write(g_partition, addr, data, len) == ESP_OK;
+}
+
+static bool partition_erase(uint16_t sector, void* ctx) {
+    return esp_partition_erase_range(g_partition, (size_t)sector * STORAGE_FLASH_SECTOR,
+                                     STORAGE_FLASH_SECTOR) == ESP_OK;
+}
+
+// ============================================================================
+// EEPROM FALLBACK BACKEND
+// ============================================================================
+
+static bool eeprom_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    memcpy(buf, EEPROM.getDataPtr() + addr, len);
+    return true;
+}
+
+static bool eeprom_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    // Same bit semantics as flash, so both backends behave identically
+    uint8_t* dst = EEPROM.getDataPtr() + addr;
+    const uint8_t* src = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        dst[i] &= src[i];
+    }
+    return true;
+}
+
+static bool eeprom_erase(uint16_t sector, void* ctx) {
+    memset(EEPROM.getDataPtr() + (size_t)sector * STORAGE_EEPROM_SECTOR, 0xFF, STORAGE_EEPROM_SECTOR);
+    return true;
+}
+
+static bool eeprom_sync(void* ctx) {
+    return EEPROM.commit();
+}
+
+// ============================================================================
+// LEGACY EEPROM IMPORT
+// ============================================================================
+
+static void save_legacy_eeprom(void* ctx) {
+    // The fallback buffer is already open; the partition leaves EEPROM alone
+    bool opened = false;
+    if (g_partition != NULL) {
+        opened = EEPROM.begin(STORAGE_LEGACY_SIZE);
+        if (!opened) {
+            return;
+        }
+    }
+
+    size_t len = EEPROM.length() < STORAGE_LEGACY_SIZE ? EEPROM.length() : STORAGE_LEGACY_SIZE;
+    memset(g_legacy, 0xFF, sizeof(g_legacy));
+    memcpy(g_legacy, EEPROM.getDataPtr(), len);
+    if (opened) {
+        EEPROM.end();
+    }
+
+    for (size_t i = 0; i < len && !g_legacy_valid; i++) {
+        g_legacy_valid = g_legacy[i] != 0xFF && g_legacy[i] != 0x00;
+    }
+    if (g_legacy_valid) {
+        Serial.println("[STO] New store: importing legacy EEPROM settings; others are discarded");
+    }
+}
+
+bool storage_legacy_read(uint16_t addr, void* buf, uint16_t len) {
+    if (!g_legacy_valid || (uint32_t)addr + len > STORAGE_LEGACY_SIZE) {
+        return false;
+    }
+    memcpy(buf, g_legacy + addr, len);
+    return true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool storage_begin(void) {
+    if (g_started) {
+        return true;
+    }
+
+    memset(&g_device_backend, 0, sizeof(g_device_backend));
+    g_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                           STORAGE_PARTITION_LABEL);
+
+    if (g_partition && g_partition->size / STORAGE_FLASH_SECTOR >= STORAGE_MIN_SECTORS) {
+        g_device_backend.sector_size = STORAGE_FLASH_SECTOR;
+        g_device_backend.sector_count = (uint16_t)(g_partition->size / STORAGE_FLASH_SECTOR);
+        g_device_backend.read = partition_read;
+        g_device_backend.write = partition_write;
+        g_device_backend.erase = partition_erase;
+    } else {
+        g_partition = NULL;
+        if (!EEPROM.begin(STORAGE_EEPROM_SIZE)) {
+            Serial.println("[STO] EEPROM unavailable");
+            return false;
+        }
+        g_device_backend.sector_size = STORAGE_EEPROM_SECTOR;
+        g_device_backend.sector_count = STORAGE_EEPROM_SIZE / STORAGE_EEPROM_SECTOR;
+        g_device_backend.read = eeprom_read;
+        g_device_backend.write = eeprom_write;
+        g_device_backend.erase = eeprom_erase;
+        g_device_backend.sync = eeprom_sync;
+    }
+
+    g_device_backend.before_format = save_legacy_eeprom;
+
+    g_mutex = xSemaphoreCreateMutex();
+    if (g_mutex) {
+        g_device_backend.lock = storage_lock;
+        g_device_backend.unlock = storage_unlock;
+    }
+
+    if (!storage_init(&g_device_backend)) {
+        Serial.println("[STO] Mount failed");
+        return false;
+    }
+
+    const StorageStats* stats = storage_get_stats();
+    Serial.printf("[STO] Mounted %s: %u x %u bytes, generation %u, %u bytes used\n",
+                  g_partition ? STORAGE_PARTITION_LABEL : "EEPROM",
+                  g_device_backend.sector_count, g_device_backend.sector_size,
+                  stats->generation, storage_get_used());
+    g_started = true;
+    return true;
+}
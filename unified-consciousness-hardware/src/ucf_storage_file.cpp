@@ -0,0 +1,110 @@
+/**
+ * @file ucf_storage_file.cpp
+ * @brief File-backed storage for host tests and tools
+ *
+ * Emulates NOR flash in a regular file: erase fills a sector with 0xFF and
+ * writes can only clear bits, so programming over used space corrupts data
+ * exactly as it would on the device.
+ *
+ * Platform independent (stdio only).
+ */
+
+#include "ucf_storage.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static bool file_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    StorageFile* sf = (StorageFile*)ctx;
+    return fseek(sf->file, (long)addr, SEEK_SET) == 0 &&
+           fread(buf, 1, len, sf->file) == len;
+}
+
+static bool file_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    StorageFile* sf = (StorageFile*)ctx;
+    const uint8_t* src = (const uint8_t*)data;
+    uint8_t buf[64];
+
+    for (size_t off = 0; off < len; off += sizeof(buf)) {
+        size_t n = (len - off < sizeof(buf)) ? len - off : sizeof(buf);
+        if (!file_read(addr + (uint32_t)off, buf, n, ctx)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++) {
+            buf[i] &= src[off + i];
+        }
+        if (fseek(sf->file, (long)(addr + off), SEEK_SET) != 0 ||
+            fwrite(buf, 1, n, sf->file) != n) {
+            return false;
+        }
+    }
+    return fflush(sf->file) == 0;
+}
+
+static bool file_erase(uint16_t sector, void* ctx) {
+    StorageFile* sf = (StorageFile*)ctx;
+    uint8_t buf[256];
+    memset(buf, 0xFF, sizeof(buf));
+
+    if (sector >= sf->sector_count ||
+        fseek(sf->file, (long)sector * (long)sf->sector_size, SEEK_SET) != 0) {
+        return false;
+    }
+    for (uint32_t off = 0; off < sf->sector_size; off += sizeof(buf)) {
+        size_t n = (sf->sector_size - off < sizeof(buf)) ? sf->sector_size - off : sizeof(buf);
+        if (fwrite(buf, 1, n, sf->file) != n) {
+            return false;
+        }
+    }
+    return fflush(sf->file) == 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool storage_file_open(StorageFile* sf, const char* path, uint32_t sector_size,
+                       uint16_t sector_count, StorageBackend* backend) {
+    memset(sf, 0, sizeof(*sf));
+    sf->sector_size = sector_size;
+    sf->sector_count = sector_count;
+
+    sf->file = fopen(path, "r+b");
+    if (!sf->file) {
+        sf->file = fopen(path, "w+b");
+    }
+    if (!sf->file) {
+        return false;
+    }
+
+    // Extend a new or short file with erased sectors
+    fseek(sf->file, 0, SEEK_END);
+    long size = ftell(sf->file);
+    for (uint16_t s = 0; s < sector_count; s++) {
+        if ((long)(s + 1) * (long)sector_size > size && !file_erase(s, sf)) {
+            storage_file_close(sf);
+            return false;
+        }
+    }
+
+    backend->sector_size = sector_size;
+    backend->sector_count = sector_count;
+    backend->read = file_read;
+    backend->write = file_write;
+    backend->erase = file_erase;
+    backend->sync = NULL;
+    backend->lock = NULL;
+    backend->unlock = NULL;
+    backend->before_format = NULL;
+    backend->ctx = sf;
+    return true;
+}
+
+void storage_file_close(StorageFile* sf) {
+    if (sf->file) {
+        fclose(sf->file);
+        sf->file = NULL;
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ucf_timestep.cpp
+ * @brief Fixed-step accumulator with a catch-up cap
+ *
+ * Totals are written with relaxed atomic stores so another core can read
+ * them while the owner advances.
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_timestep.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline void count(uint32_t* p, uint32_t n) {
+    __atomic_store_n(p, *p + n, __ATOMIC_RELAXED);
+}
+
+// ============================================================================
+// TIMESTEP API
+// ============================================================================
+
+void timestep_init(Timestep* t, uint32_t step_us, uint8_t max_steps, uint32_t now_us) {
+    memset(t, 0, sizeof(*t));
+    t->step_us = step_us > 0 ? step_us : 1;
+    t->max_steps = max_steps > 0 ? max_steps : 1;
+    t->last_us = now_us;
+    t->accum_us = t->step_us / 2;
+}
+
+uint8_t timestep_advance(Timestep* t, uint32_t now_us) {
+    uint32_t elapsed = now_us - t->last_us;
+    t->last_us = now_us;
+
+    // Whole steps due; 64 bits so a long stall cannot wrap the sum
+    uint64_t pending = (uint64_t)t->accum_us + elapsed;
+    uint64_t due = pending / t->step_us;
+    t->accum_us = (uint32_t)(pending % t->step_us);
+
+    uint32_t steps = (uint32_t)due;
+    if (due > t->max_steps) {
+        uint64_t dropped = due - t->max_steps;
+        count(&t->stats.overruns, 1);
+        count(&t->stats.dropped_steps, dropped > UINT32_MAX ? UINT32_MAX : (uint32_t)dropped);
+        steps = t->max_steps;
+    }
+
+    count(&t->stats.steps, steps);
+    if (steps > t->stats.max_steps) {
+        __atomic_store_n(&t->stats.max_steps, steps, __ATOMIC_RELAXED);
+    }
+    return (uint8_t)steps;
+}
+
+float timestep_dt(const Timestep* t) {
+    return t->step_us / 1000000.0f;
+}
+
+uint32_t timestep_age_us(const Timestep* t, uint8_t steps, uint8_t i) {
+    uint8_t later = (i < steps) ? (uint8_t)(steps - 1 - i) : 0;
+    return t->accum_us + (uint32_t)later * t->step_us;
+}
+
+void timestep_get_stats(const Timestep* t, TimestepStats* stats) {
+    stats->steps = __atomic_load_n(&t->stats.steps, __ATOMIC_RELAXED);
+    stats->overruns = __atomic_load_n(&t->stats.overruns, __ATOMIC_RELAXED);
+    stats->dropped_steps = __atomic_load_n(&t->stats.dropped_steps, __ATOMIC_RELAXED);
+    stats->max_steps = __atomic_load_n(&t->stats.max_steps, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,469 @@
+/**
+ * @file ucf_trace.cpp
+ * @brief UCF Sensor Trace Implementation v4.0.0
+ *
+ * File header (little-endian):
+ *   magic(4) version(2) header_size(2) chunk_size(4) start_ms(4)
+ *   hex_count(1) reserved(15)
+ *
+ * Chunk header:
+ *   magic(4) seq(4) first_ms(4) length(2) records(2) crc32(4)
+ *   The CRC covers the first 16 header bytes and the payload.
+ *
+ * Record payloads:
+ *   TOUCH    19 x uint16 filtered data
+ *   MAG      int16 x, y, z
+ *   COMMAND  command(1) frame(4)
+ *
+ * The open chunk and the sealed ones share one pool: slots tail..head-1
+ * are sealed, slot head is open. Hooks on either core append under a
+ * spinlock held for one record copy; trace_tick() is the only consumer.
+ *
+ * Platform independent: compiled for both ESP32 and native builds.
+ */
+
+#include "ucf_trace.h"
+#include "ucf_checksum.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+#define TRACE_POOL_CHUNKS       (TRACE_RING_CHUNKS + 1)
+#define TRACE_TOUCH_PAYLOAD     (TRACE_HEX_COUNT * 2)
+#define TRACE_MAG_PAYLOAD       6
+#define TRACE_COMMAND_PAYLOAD   5
+#define TRACE_MIN_CHUNK_SIZE    64
+
+static uint8_t g_pool[TRACE_POOL_CHUNKS][TRACE_CHUNK_SIZE];
+static uint32_t g_head = 0;             // Open slot (producers, under g_lock)
+static uint32_t g_tail = 0;             // Oldest sealed slot (trace_tick())
+static uint32_t g_open_len = TRACE_CHUNK_HEADER_SIZE;
+static uint16_t g_open_records = 0;
+static uint32_t g_open_first_ms = 0;
+static uint32_t g_chunk_seq = 0;
+static uint32_t g_recorded_frames = 0;
+static bool g_lock = false;
+
+static TraceWriteFn g_write = NULL;
+static void* g_write_ctx = NULL;
+
+// Replay cursors, one per record type
+static TraceReader g_replay_touch;
+static TraceReader g_replay_mag;
+static TraceReader g_replay_command;
+static TraceRecord g_pending_command;
+static bool g_have_pending = false;
+
+static TraceStats g_stats;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static inline void lock(void) {
+    while (__atomic_test_and_set(&g_lock, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static inline void unlock(void) {
+    __atomic_clear(&g_lock, __ATOMIC_RELEASE);
+}
+
+static inline bool recording(void) {
+    return (__atomic_load_n(&g_stats.mode, __ATOMIC_ACQUIRE) & TRACE_MODE_RECORD) != 0;
+}
+
+static inline bool replaying(void) {
+    return (__atomic_load_n(&g_stats.mode, __ATOMIC_ACQUIRE) & TRACE_MODE_REPLAY) != 0;
+}
+
+/**
+ * @brief Close the open chunk and move it to the ring (caller holds g_lock)
+ */
+static void seal_locked(void) {
+    if (g_open_records == 0) {
+        return;
+    }
+
+    uint8_t* chunk = g_pool[g_head % TRACE_POOL_CHUNKS];
+    put_u32(chunk, TRACE_CHUNK_MAGIC);
+    put_u32(chunk + 4, g_chunk_seq);
+    put_u32(chunk + 8, g_open_first_ms);
+    put_u16(chunk + 12, (uint16_t)(g_open_len - TRACE_CHUNK_HEADER_SIZE));
+    put_u16(chunk + 14, g_open_records);
+    uint32_t crc = checksum_crc32_update(0, chunk, 16);
+    crc = checksum_crc32_update(crc, chunk + TRACE_CHUNK_HEADER_SIZE,
+                                g_open_len - TRACE_CHUNK_HEADER_SIZE);
+    put_u32(chunk + 16, crc);
+    memset(chunk + g_open_len, 0, TRACE_CHUNK_SIZE - g_open_len);
+
+    g_chunk_seq++;
+    if (g_head + 1 - __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE) > TRACE_RING_CHUNKS) {
+        g_stats.dropped_chunks++;       // Ring full: reuse the slot
+    } else {
+        __atomic_store_n(&g_head, g_head + 1, __ATOMIC_RELEASE);
+    }
+    g_open_len = TRACE_CHUNK_HEADER_SIZE;
+    g_open_records = 0;
+}
+
+/**
+ * @brief Append one record to the open chunk
+ */
+static void append(uint8_t type, uint32_t now_ms, const uint8_t* payload, uint8_t len) {
+    lock();
+    if (!recording()) {
+        unlock();
+        return;
+    }
+    if (g_open_len + TRACE_RECORD_HEADER_SIZE + len > TRACE_CHUNK_SIZE) {
+        seal_locked();
+    }
+    if (g_open_records == 0) {
+        g_open_first_ms = now_ms;
+    }
+
+    uint8_t* p = g_pool[g_head % TRACE_POOL_CHUNKS] + g_open_len;
+    p[0] = type;
+    p[1] = len;
+    put_u32(p + 2, now_ms);
+    memcpy(p + TRACE_RECORD_HEADER_SIZE, payload, len);
+    g_open_len += TRACE_RECORD_HEADER_SIZE + len;
+    g_open_records++;
+    g_stats.records++;
+    if (type == TRACE_REC_TOUCH) {
+        g_recorded_frames++;
+    }
+    unlock();
+}
+
+/**
+ * @brief Validate chunk reader->chunk and position at its first record
+ */
+static bool enter_chunk(TraceReader* reader) {
+    const uint8_t* chunk = reader->data + TRACE_FILE_HEADER_SIZE +
+                           (size_t)reader->chunk * reader->chunk_size;
+    uint32_t length = get_u16(chunk + 12);
+
+    if (get_u32(chunk) != TRACE_CHUNK_MAGIC ||
+        length > reader->chunk_size - TRACE_CHUNK_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t crc = checksum_crc32_update(0, chunk, 16);
+    crc = checksum_crc32_update(crc, chunk + TRACE_CHUNK_HEADER_SIZE, length);
+    if (crc != get_u32(chunk + 16)) {
+        return false;
+    }
+
+    reader->pos = TRACE_CHUNK_HEADER_SIZE;
+    reader->end = TRACE_CHUNK_HEADER_SIZE + length;
+    return true;
+}
+
+static bool decode(uint8_t type, const uint8_t* p, uint8_t len, TraceRecord* record) {
+    switch (type) {
+        case TRACE_REC_TOUCH:
+            if (len != TRACE_TOUCH_PAYLOAD) return false;
+            for (uint8_t i = 0; i < TRACE_HEX_COUNT; i++) {
+                record->touch[i] = get_u16(p + 2 * i);
+            }
+            return true;
+
+        case TRACE_REC_MAG:
+            if (len != TRACE_MAG_PAYLOAD) return false;
+            for (uint8_t i = 0; i < 3; i++) {
+                record->mag[i] = (int16_t)get_u16(p + 2 * i);
+            }
+            return true;
+
+        case TRACE_REC_COMMAND:
+            if (len != TRACE_COMMAND_PAYLOAD) return false;
+            record->command = p[0];
+            record->frame = get_u32(p + 1);
+            return true;
+
+        default:
+            return true;                // Unknown types are skipped by length
+    }
+}
+
+static bool next_of_type(TraceReader* reader, uint8_t type, TraceRecord* record) {
+    while (trace_reader_next(reader, record)) {
+        if (record->type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+bool trace_record_begin(TraceWriteFn write, void* ctx, uint32_t now_ms) {
+    trace_record_end();
+
+    uint8_t header[TRACE_FILE_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    put_u32(header, TRACE_MAGIC);
+    put_u16(header + 4, TRACE_VERSION);
+    put_u16(header + 6, TRACE_FILE_HEADER_SIZE);
+    put_u32(header + 8, TRACE_CHUNK_SIZE);
+    put_u32(header + 12, now_ms);
+    header[16] = TRACE_HEX_COUNT;
+    if (!write(header, sizeof(header), ctx)) {
+        g_stats.write_errors++;
+        return false;
+    }
+
+    lock();
+    g_write = write;
+    g_write_ctx = ctx;
+    g_head = 0;
+    g_tail = 0;
+    g_open_len = TRACE_CHUNK_HEADER_SIZE;
+    g_open_records = 0;
+    g_chunk_seq = 0;
+    g_recorded_frames = 0;
+    g_stats.records = 0;
+    g_stats.chunks = 0;
+    g_stats.dropped_chunks = 0;
+    g_stats.write_errors = 0;
+    g_stats.bytes = sizeof(header);
+    __atomic_or_fetch(&g_stats.mode, (uint8_t)TRACE_MODE_RECORD, __ATOMIC_RELEASE);
+    unlock();
+    return true;
+}
+
+void trace_record_end(void) {
+    if (!recording()) {
+        return;
+    }
+    lock();
+    seal_locked();
+    unlock();
+    trace_tick();
+
+    lock();
+    __atomic_and_fetch(&g_stats.mode, (uint8_t)~TRACE_MODE_RECORD, __ATOMIC_RELEASE);
+    g_write = NULL;
+    unlock();
+}
+
+void trace_tick(void) {
+    if (g_write == NULL) {
+        return;
+    }
+    while (g_tail != __atomic_load_n(&g_head, __ATOMIC_ACQUIRE)) {
+        if (g_write(g_pool[g_tail % TRACE_POOL_CHUNKS], TRACE_CHUNK_SIZE, g_write_ctx)) {
+            g_stats.chunks++;
+            g_stats.bytes += TRACE_CHUNK_SIZE;
+        } else {
+            g_stats.write_errors++;
+        }
+        __atomic_store_n(&g_tail, g_tail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+
+bool trace_replay_begin(const uint8_t* data, size_t size) {
+    trace_replay_end();
+
+    if (!trace_reader_open(&g_replay_touch, data, size)) {
+        return false;
+    }
+    g_replay_mag = g_replay_touch;
+    g_replay_command = g_replay_touch;
+    g_have_pending = false;
+    g_stats.replay_frames = 0;
+    g_stats.replay_mags = 0;
+    g_stats.replay_commands = 0;
+    g_stats.replay_done = false;
+    __atomic_or_fetch(&g_stats.mode, (uint8_t)TRACE_MODE_REPLAY, __ATOMIC_RELEASE);
+    return true;
+}
+
+void trace_replay_end(void) {
+    __atomic_and_fetch(&g_stats.mode, (uint8_t)~TRACE_MODE_REPLAY, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// INPUT HOOKS
+// ============================================================================
+
+void trace_touch(uint32_t now_ms, uint16_t* raw) {
+    if (replaying()) {
+        TraceRecord rec;
+        if (next_of_type(&g_replay_touch, TRACE_REC_TOUCH, &rec)) {
+            memcpy(raw, rec.touch, sizeof(rec.touch));
+            __atomic_store_n(&g_stats.replay_frames, g_stats.replay_frames + 1, __ATOMIC_RELEASE);
+        } else {
+            g_stats.replay_done = true;
+        }
+    }
+
+    if (recording()) {
+        uint8_t payload[TRACE_TOUCH_PAYLOAD];
+        for (uint8_t i = 0; i < TRACE_HEX_COUNT; i++) {
+            put_u16(payload + 2 * i, raw[i]);
+        }
+        append(TRACE_REC_TOUCH, now_ms, payload, sizeof(payload));
+    }
+}
+
+void trace_mag(uint32_t now_ms, int16_t* xyz) {
+    if (replaying()) {
+        TraceRecord rec;
+        if (next_of_type(&g_replay_mag, TRACE_REC_MAG, &rec)) {
+            memcpy(xyz, rec.mag, sizeof(rec.mag));
+            g_stats.replay_mags++;
+        }
+    }
+
+    if (recording()) {
+        uint8_t payload[TRACE_MAG_PAYLOAD];
+        for (uint8_t i = 0; i < 3; i++) {
+            put_u16(payload + 2 * i, (uint16_t)xyz[i]);
+        }
+        append(TRACE_REC_MAG, now_ms, payload, sizeof(payload));
+    }
+}
+
+int trace_command(uint32_t now_ms, int live) {
+    int cmd = live;
+
+    if (replaying()) {
+        if (!g_have_pending) {
+            g_have_pending = next_of_type(&g_replay_command, TRACE_REC_COMMAND, &g_pending_command);
+        }
+        if (g_have_pending &&
+            g_pending_command.frame <= __atomic_load_n(&g_stats.replay_frames, __ATOMIC_ACQUIRE)) {
+            // A live key read in the same poll is dropped
+            cmd = g_pending_command.command;
+            g_have_pending = false;
+            g_stats.replay_commands++;
+        }
+    }
+
+    if (cmd >= 0 && recording()) {
+        uint8_t payload[TRACE_COMMAND_PAYLOAD];
+        payload[0] = (uint8_t)cmd;
+        lock();
+        put_u32(payload + 1, g_recorded_frames);
+        unlock();
+        append(TRACE_REC_COMMAND, now_ms, payload, sizeof(payload));
+    }
+    return cmd;
+}
+
+const TraceStats* trace_get_stats(void) {
+    return &g_stats;
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+bool trace_reader_open(TraceReader* reader, const uint8_t* data, size_t size) {
+    memset(reader, 0, sizeof(*reader));
+    if (data == NULL || size < TRACE_FILE_HEADER_SIZE ||
+        get_u32(data) != TRACE_MAGIC || get_u16(data + 4) != TRACE_VERSION ||
+        get_u16(data + 6) != TRACE_FILE_HEADER_SIZE || data[16] != TRACE_HEX_COUNT) {
+        return false;
+    }
+
+    uint32_t chunk_size = get_u32(data + 8);
+    if (chunk_size < TRACE_MIN_CHUNK_SIZE || chunk_size > 0xFFFF + TRACE_CHUNK_HEADER_SIZE) {
+        return false;
+    }
+
+    reader->data = data;
+    reader->size = size;
+    reader->chunk_size = chunk_size;
+    reader->chunk_count = (uint32_t)((size - TRACE_FILE_HEADER_SIZE) / chunk_size);
+    reader->start_ms = get_u32(data + 12);
+    return true;
+}
+
+void trace_reader_seek(TraceReader* reader, uint32_t time_ms) {
+    // Last chunk whose first record is at or before time_ms
+    uint32_t lo = 0;
+    uint32_t hi = reader->chunk_count;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        const uint8_t* chunk = reader->data + TRACE_FILE_HEADER_SIZE +
+                               (size_t)mid * reader->chunk_size;
+        if (get_u32(chunk + 8) <= time_ms) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    reader->chunk = lo;
+    reader->pos = 0;
+    reader->end = 0;
+}
+
+bool trace_reader_next(TraceReader* reader, TraceRecord* record) {
+    while (reader->chunk < reader->chunk_count) {
+        if (reader->end == 0 && !enter_chunk(reader)) {
+            reader->corrupt++;
+            reader->chunk++;
+            continue;
+        }
+
+        const uint8_t* chunk = reader->data + TRACE_FILE_HEADER_SIZE +
+                               (size_t)reader->chunk * reader->chunk_size;
+        if (reader->pos + TRACE_RECORD_HEADER_SIZE <= reader->end) {
+            const uint8_t* p = chunk + reader->pos;
+            uint8_t len = p[1];
+            if (reader->pos + TRACE_RECORD_HEADER_SIZE + len <= reader->end) {
+                reader->pos += TRACE_RECORD_HEADER_SIZE + len;
+                record->type = p[0];
+                record->time_ms = get_u32(p + 2);
+                if (decode(p[0], p + TRACE_RECORD_HEADER_SIZE, len, record)) {
+                    return true;
+                }
+            }
+            // Malformed record: the CRC passed, so the writer was wrong; skip the chunk
+            reader->corrupt++;
+        }
+
+        reader->chunk++;
+        reader->pos = 0;
+        reader->end = 0;
+    }
+    return false;
+}
+
+const char* trace_type_string(uint8_t type) {
+    switch (type) {
+        case TRACE_REC_TOUCH:   return "TOUCH";
+        case TRACE_REC_MAG:     return "MAG";
+        case TRACE_REC_COMMAND: return "COMMAND";
+        default:                return "UNKNOWN";
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file ucf_warm_start.cpp
+ * @brief Warm-start snapshot and background baseline check
+ *
+ * Platform independent (no Arduino dependencies).
+ */
+
+#include "ucf_warm_start.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static bool snapshot_region_open(void) {
+    return storage_register(STORAGE_REGION_SNAPSHOT, "snapshot",
+                            sizeof(WarmSnapshot), WARM_SNAPSHOT_VERSION);
+}
+
+static void window_reset(BaselineCheck* check) {
+    memset(check->accum, 0, sizeof(check->accum));
+    memset(check->max, 0, sizeof(check->max));
+    memset(check->min, 0xFF, sizeof(check->min));
+    check->samples = 0;
+}
+
+/**
+ * @brief Close a full window: discard it if noisy, otherwise decide
+ */
+static WarmCheckState window_close(BaselineCheck* check) {
+    for (uint8_t i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        if (check->max[i] - check->min[i] > WARM_CHECK_NOISE) {
+            // Touched or settling: try again unless it never calms down
+            window_reset(check);
+            if (++check->windows >= WARM_CHECK_MAX_WINDOWS) {
+                check->state = WARM_CHECK_GAVE_UP;
+            }
+            return check->state;
+        }
+    }
+
+    check->agree = 0;
+    for (uint8_t i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        check->result[i] = (uint16_t)((check->accum[i] + check->samples / 2) / check->samples);
+        int32_t diff = (int32_t)check->result[i] - (int32_t)check->expected[i];
+        if (check->have_expected && diff <= WARM_CHECK_TOLERANCE && diff >= -WARM_CHECK_TOLERANCE) {
+            check->agree++;
+        }
+    }
+
+    check->state = (check->have_expected && check->agree >= WARM_CHECK_MIN_AGREE)
+                       ? WARM_CHECK_CONFIRMED
+                       : WARM_CHECK_REPLACED;
+    return check->state;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool warm_start_load(WarmSnapshot* snapshot) {
+    if (!snapshot_region_open() ||
+        storage_read(STORAGE_REGION_SNAPSHOT, snapshot, sizeof(WarmSnapshot)) != STORAGE_OK) {
+        return false;
+    }
+
+    // A snapshot taken before calibration finished has no usable baselines
+    for (uint8_t i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        if (snapshot->hex_baselines[i] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool warm_start_save(const WarmSnapshot* snapshot) {
+    return snapshot_region_open() &&
+           storage_write(STORAGE_REGION_SNAPSHOT, snapshot, sizeof(WarmSnapshot)) == STORAGE_OK;
+}
+
+void baseline_check_begin(BaselineCheck* check, const uint16_t* expected) {
+    memset(check, 0, sizeof(*check));
+    check->have_expected = (expected != NULL);
+    if (expected) {
+        memcpy(check->expected, expected, sizeof(check->expected));
+    }
+    window_reset(check);
+    check->state = WARM_CHECK_COLLECTING;
+}
+
+WarmCheckState baseline_check_add(BaselineCheck* check, const uint16_t* raw) {
+    if (check->state != WARM_CHECK_COLLECTING) {
+        return check->state;
+    }
+
+    for (uint8_t i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        check->accum[i] += raw[i];
+        if (raw[i] < check->min[i]) check->min[i] = raw[i];
+        if (raw[i] > check->max[i]) check->max[i] = raw[i];
+    }
+
+    if (++check->samples < WARM_CHECK_SAMPLES) {
+        return check->state;
+    }
+    return window_close(check);
+}
+
+bool baseline_check_active(const BaselineCheck* check) {
+    return check->state == WARM_CHECK_COLLECTING;
+}
+
+const char* baseline_check_state_string(WarmCheckState state) {
+    switch (state) {
+        case WARM_CHECK_IDLE:       return "IDLE";
+        case WARM_CHECK_COLLECTING: return "COLLECTING";
+        case WARM_CHECK_CONFIRMED:  return "CONFIRMED";
+        case WARM_CHECK_REPLACED:   return "REPLACED";
+        case WARM_CHECK_GAVE_UP:    return "GAVE_UP";
+        default:                    return "UNKNOWN";
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_checksum.cpp
+ * @brief Unit tests for the shared checksum engine
+ *
+ * Tests validate:
+ * - Standard check values for CRC-32 and CRC-32C
+ * - Agreement with a bitwise reference over many lengths and alignments
+ * - Incremental updates equal one-shot results for every split point
+ * - Accelerated and table paths agree
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_checksum.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define BUFFER_SIZE     1100
+
+static uint8_t g_buffer[BUFFER_SIZE + 8];
+
+/**
+ * @brief Bit-at-a-time reference (the pre-table implementation)
+ */
+static uint32_t reference_crc(uint32_t poly, const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// CHECK VALUE TESTS
+// ============================================================================
+
+void test_crc32_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, checksum_crc32("123456789", 9));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, checksum_crc32_sw_update(0, "123456789", 9));
+}
+
+void test_crc32c_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, checksum_crc32c("123456789", 9));
+    TEST_ASSERT_EQUAL_HEX32(0xE3069283, checksum_crc32c_sw_update(0, "123456789", 9));
+}
+
+void test_empty_input(void) {
+    TEST_ASSERT_EQUAL_HEX32(0, checksum_crc32(NULL, 0));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, checksum_crc32_update(0x12345678, g_buffer, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, checksum_crc32c(NULL, 0));
+}
+
+// ============================================================================
+// REFERENCE AGREEMENT TESTS
+// ============================================================================
+
+void test_matches_reference_all_lengths_and_alignments(void) {
+    const size_t lengths[] = {1, 2, 3, 7, 8, 9, 15, 16, 17, 63, 64, 65, 255, 1024, BUFFER_SIZE};
+
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            const uint8_t* p = g_buffer + offset;
+            size_t n = lengths[i];
+            TEST_ASSERT_EQUAL_HEX32(reference_crc(CHECKSUM_CRC32_POLY, p, n), checksum_crc32(p, n));
+            TEST_ASSERT_EQUAL_HEX32(reference_crc(CHECKSUM_CRC32C_POLY, p, n), checksum_crc32c(p, n));
+        }
+    }
+}
+
+void test_accelerated_matches_tables(void) {
+    for (size_t n = 0; n <= 300; n += 13) {
+        TEST_ASSERT_EQUAL_HEX32(checksum_crc32c_sw_update(0, g_buffer + 1, n),
+                                checksum_crc32c_update(0, g_buffer + 1, n));
+        TEST_ASSERT_EQUAL_HEX32(checksum_crc32_sw_update(0, g_buffer + 3, n),
+                                checksum_crc32_update(0, g_buffer + 3, n));
+    }
+}
+
+// ============================================================================
+// INCREMENTAL TESTS
+// ============================================================================
+
+void test_incremental_equals_one_shot(void) {
+    const size_t len = 300;
+    uint32_t crc32 = checksum_crc32(g_buffer, len);
+    uint32_t crc32c = checksum_crc32c(g_buffer, len);
+
+    for (size_t split = 0; split <= len; split++) {
+        uint32_t a = checksum_crc32_update(0, g_buffer, split);
+        a = checksum_crc32_update(a, g_buffer + split, len - split);
+        TEST_ASSERT_EQUAL_HEX32(crc32, a);
+
+        uint32_t c = checksum_crc32c_update(0, g_buffer, split);
+        c = checksum_crc32c_update(c, g_buffer + split, len - split);
+        TEST_ASSERT_EQUAL_HEX32(crc32c, c);
+    }
+}
+
+void test_byte_by_byte_updates(void) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < BUFFER_SIZE; i++) {
+        crc = checksum_crc32_update(crc, g_buffer + i, 1);
+    }
+    TEST_ASSERT_EQUAL_HEX32(checksum_crc32(g_buffer, BUFFER_SIZE), crc);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    for (size_t i = 0; i < sizeof(g_buffer); i++) {
+        g_buffer[i] = (uint8_t)(i * 167 + (i >> 3) + 11);
+    }
+}
+
+void tearDown(void) {
+    // Called after each test
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Check values
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_crc32c_check_value);
+    RUN_TEST(test_empty_input);
+
+    // Reference agreement
+    RUN_TEST(test_matches_reference_all_lengths_and_alignments);
+    RUN_TEST(test_accelerated_matches_tables);
+
+    // Incremental
+    RUN_TEST(test_incremental_equals_one_shot);
+    RUN_TEST(test_byte_by_byte_updates);
+
+    return UNITY_END();
+}
@@ -0,0 +1,318 @@
+/**
+ * @file test_dual_core.cpp
+ * @brief Unit tests for the cross-core queue, snapshot and partition
+ *
+ * Single-threaded tests pin down the semantics; threaded tests run a real
+ * producer and consumer on two std::threads and are meant to be built with
+ * -fsanitize=thread (see ucf_dual_core.h). Worker threads only count
+ * errors; assertions run on the test thread after joining.
+ *
+ * Tests validate:
+ * - Queue order, capacity, drops and index wrap
+ * - Snapshot freshness, latest-wins and reader stability
+ * - Lossless, ordered transfer and torn-free snapshots across threads
+ * - Two schedulers on the thread backend exchanging data
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "ucf_dual_core.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define QUEUE_CAPACITY  16
+#define STRESS_ITEMS    200000
+#define SNAPSHOT_WORDS  16
+#define SNAPSHOT_READS  10000           // Reads made while the writer publishes
+
+typedef struct {
+    uint32_t seq;
+    uint32_t words[SNAPSHOT_WORDS];     // All equal to seq
+} TestState;
+
+static CoreQueue g_queue;
+static uint32_t g_queue_buffer[QUEUE_CAPACITY];
+
+static CoreSnapshot g_snapshot;
+static TestState g_snapshot_buffer[CORE_SNAPSHOT_BUFFERS];
+
+static void fill_state(TestState* s, uint32_t seq) {
+    s->seq = seq;
+    for (int i = 0; i < SNAPSHOT_WORDS; i++) {
+        s->words[i] = seq;
+    }
+}
+
+static bool state_consistent(const TestState* s) {
+    for (int i = 0; i < SNAPSHOT_WORDS; i++) {
+        if (s->words[i] != s->seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// QUEUE TESTS
+// ============================================================================
+
+void test_queue_fifo_order(void) {
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(core_queue_push(&g_queue, &i));
+    }
+    TEST_ASSERT_EQUAL(5, core_queue_count(&g_queue));
+
+    uint32_t v;
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(core_queue_pop(&g_queue, &v));
+        TEST_ASSERT_EQUAL(i, v);
+    }
+    TEST_ASSERT_FALSE(core_queue_pop(&g_queue, &v));
+}
+
+void test_queue_full_refuses_and_counts(void) {
+    uint32_t v = 0;
+    for (int i = 0; i < QUEUE_CAPACITY; i++) {
+        TEST_ASSERT_TRUE(core_queue_push(&g_queue, &v));
+    }
+    TEST_ASSERT_FALSE(core_queue_push(&g_queue, &v));
+    TEST_ASSERT_FALSE(core_queue_push(&g_queue, &v));
+    TEST_ASSERT_EQUAL(2, core_queue_dropped(&g_queue));
+    TEST_ASSERT_EQUAL(QUEUE_CAPACITY, core_queue_count(&g_queue));
+
+    // One slot freed, one push accepted
+    TEST_ASSERT_TRUE(core_queue_pop(&g_queue, &v));
+    TEST_ASSERT_TRUE(core_queue_push(&g_queue, &v));
+}
+
+void test_queue_indices_wrap(void) {
+    // Start just below the 32-bit wrap of the free-running indices
+    g_queue.head = g_queue.tail = 0xFFFFFFF8u;
+
+    uint32_t v;
+    for (uint32_t i = 0; i < 40; i++) {
+        TEST_ASSERT_TRUE(core_queue_push(&g_queue, &i));
+        TEST_ASSERT_EQUAL(1, core_queue_count(&g_queue));
+        TEST_ASSERT_TRUE(core_queue_pop(&g_queue, &v));
+        TEST_ASSERT_EQUAL(i, v);
+    }
+}
+
+void test_queue_rejects_bad_capacity(void) {
+    CoreQueue q;
+    uint32_t buf[12];
+    TEST_ASSERT_FALSE(core_queue_init(&q, buf, sizeof(uint32_t), 12));
+    TEST_ASSERT_FALSE(core_queue_init(&q, buf, sizeof(uint32_t), 0));
+}
+
+// ============================================================================
+// SNAPSHOT TESTS
+// ============================================================================
+
+void test_snapshot_empty_until_published(void) {
+    bool fresh = true;
+    const TestState* s = (const TestState*)core_snapshot_read(&g_snapshot, &fresh);
+    TEST_ASSERT_FALSE(fresh);
+    TEST_ASSERT_EQUAL(0, s->seq);
+}
+
+void test_snapshot_latest_wins(void) {
+    TestState s;
+    for (uint32_t i = 1; i <= 3; i++) {
+        fill_state(&s, i);
+        core_snapshot_write(&g_snapshot, &s);
+    }
+
+    bool fresh = false;
+    const TestState* r = (const TestState*)core_snapshot_read(&g_snapshot, &fresh);
+    TEST_ASSERT_TRUE(fresh);
+    TEST_ASSERT_EQUAL(3, r->seq);
+
+    // Nothing new: same copy, not fresh
+    r = (const TestState*)core_snapshot_read(&g_snapshot, &fresh);
+    TEST_ASSERT_FALSE(fresh);
+    TEST_ASSERT_EQUAL(3, r->seq);
+}
+
+void test_snapshot_reader_copy_is_stable(void) {
+    TestState s;
+    fill_state(&s, 7);
+    core_snapshot_write(&g_snapshot, &s);
+    const TestState* r = (const TestState*)core_snapshot_read(&g_snapshot, NULL);
+
+    // The writer keeps publishing into the other two buffers
+    for (uint32_t i = 8; i < 20; i++) {
+        TestState* w = (TestState*)core_snapshot_begin(&g_snapshot);
+        TEST_ASSERT_TRUE(w != r);
+        fill_state(w, i);
+        core_snapshot_publish(&g_snapshot);
+    }
+    TEST_ASSERT_EQUAL(7, r->seq);
+    TEST_ASSERT_TRUE(state_consistent(r));
+
+    r = (const TestState*)core_snapshot_read(&g_snapshot, NULL);
+    TEST_ASSERT_EQUAL(19, r->seq);
+}
+
+// ============================================================================
+// THREADED TESTS
+// ============================================================================
+
+void test_queue_across_threads_is_lossless_and_ordered(void) {
+    uint32_t errors = 0, received = 0;
+
+    std::thread consumer([&]() {
+        uint32_t expect = 0, v;
+        while (expect < STRESS_ITEMS) {
+            if (core_queue_pop(&g_queue, &v)) {
+                if (v != expect) errors++;
+                expect++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        received = expect;
+    });
+
+    for (uint32_t i = 0; i < STRESS_ITEMS; i++) {
+        while (!core_queue_push(&g_queue, &i)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    TEST_ASSERT_EQUAL(STRESS_ITEMS, received);
+    TEST_ASSERT_EQUAL(0, errors);
+}
+
+void test_snapshot_across_threads_never_torn(void) {
+    uint32_t torn = 0, backwards = 0, reads = 0;
+    uint8_t started = 0, done = 0;
+
+    std::thread reader([&]() {
+        uint32_t last = 0;
+        __atomic_store_n(&started, 1, __ATOMIC_RELEASE);
+        while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+            const TestState* s = (const TestState*)core_snapshot_read(&g_snapshot, NULL);
+            if (!state_consistent(s)) torn++;
+            if (s->seq < last) backwards++;
+            last = s->seq;
+            __atomic_store_n(&reads, reads + 1, __ATOMIC_RELEASE);
+        }
+    });
+
+    // Publish until the reader has overlapped the writer for long enough
+    while (!__atomic_load_n(&started, __ATOMIC_ACQUIRE)) {
+        std::this_thread::yield();
+    }
+    for (uint32_t i = 1;
+         i <= STRESS_ITEMS / 4 || __atomic_load_n(&reads, __ATOMIC_ACQUIRE) < SNAPSHOT_READS;
+         i++) {
+        fill_state((TestState*)core_snapshot_begin(&g_snapshot), i);
+        core_snapshot_publish(&g_snapshot);
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    reader.join();
+
+    TEST_ASSERT_GREATER_OR_EQUAL(SNAPSHOT_READS, reads);
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_EQUAL(0, backwards);
+}
+
+// ============================================================================
+// PARTITION TESTS
+// ============================================================================
+
+// Real-time side: counts ticks, queues each one and publishes its state
+static uint32_t g_rt_ticks;
+static void rt_tick(uint32_t now_us, void* ctx) {
+    g_rt_ticks++;
+    core_queue_push(&g_queue, &g_rt_ticks);
+    TestState* s = (TestState*)core_snapshot_begin(&g_snapshot);
+    fill_state(s, g_rt_ticks);
+    core_snapshot_publish(&g_snapshot);
+}
+
+// I/O side: drains the queue and checks the snapshot
+static uint32_t g_io_received, g_io_errors, g_io_last_seq;
+static void io_drain(uint32_t now_us, void* ctx) {
+    uint32_t v;
+    while (core_queue_pop(&g_queue, &v)) {
+        if (v != g_io_received + 1) g_io_errors++;
+        g_io_received = v;
+    }
+    const TestState* s = (const TestState*)core_snapshot_read(&g_snapshot, NULL);
+    if (!state_consistent(s) || s->seq < g_io_last_seq) g_io_errors++;
+    g_io_last_seq = s->seq;
+}
+
+void test_partition_runs_both_sides_on_threads(void) {
+    static Scheduler rt, io;
+    CorePartition p;
+    uint32_t big_buffer[256];
+    core_queue_init(&g_queue, big_buffer, sizeof(uint32_t), 256);
+    g_rt_ticks = g_io_received = g_io_errors = g_io_last_seq = 0;
+
+    sched_init(&rt, core_thread_clock_us);
+    sched_init(&io, core_thread_clock_us);
+    SchedTaskConfig tick = { "tick", rt_tick, NULL, 1000, 0, 0, 0, 1, 0 };
+    SchedTaskConfig drain = { "drain", io_drain, NULL, 5000, 0, 0, 0, 1, 0 };
+    sched_add(&rt, &tick);
+    sched_add(&io, &drain);
+
+    core_partition_init(&p, &rt, &io);
+    TEST_ASSERT_TRUE(core_partition_start_threads(&p));
+    TEST_ASSERT_FALSE(core_partition_start_threads(&p));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    core_partition_stop_threads(&p);
+
+    // Anything still queued at the stop is drained here
+    io_drain(0, NULL);
+
+    CoreStats rt_stats, io_stats;
+    core_partition_get_stats(&p, CORE_RT, &rt_stats);
+    core_partition_get_stats(&p, CORE_IO, &io_stats);
+    TEST_ASSERT_GREATER_THAN(10, rt_stats.runs);
+    TEST_ASSERT_GREATER_THAN(2, io_stats.runs);
+    TEST_ASSERT_EQUAL(0, core_queue_dropped(&g_queue));
+    TEST_ASSERT_EQUAL(g_rt_ticks, g_io_received);
+    TEST_ASSERT_EQUAL(0, g_io_errors);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    core_queue_init(&g_queue, g_queue_buffer, sizeof(uint32_t), QUEUE_CAPACITY);
+    core_snapshot_init(&g_snapshot, g_snapshot_buffer, sizeof(TestState));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Queue
+    RUN_TEST(test_queue_fifo_order);
+    RUN_TEST(test_queue_full_refuses_and_counts);
+    RUN_TEST(test_queue_indices_wrap);
+    RUN_TEST(test_queue_rejects_bad_capacity);
+
+    // Snapshot
+    RUN_TEST(test_snapshot_empty_until_published);
+    RUN_TEST(test_snapshot_latest_wins);
+    RUN_TEST(test_snapshot_reader_copy_is_stable);
+
+    // Threads
+    RUN_TEST(test_queue_across_threads_is_lossless_and_ordered);
+    RUN_TEST(test_snapshot_across_threads_never_torn);
+    RUN_TEST(test_partition_runs_both_sides_on_threads);
+
+    return UNITY_END();
+}
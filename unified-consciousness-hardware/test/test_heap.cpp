@@ -0,0 +1,185 @@
+/**
+ * @file test_heap.cpp
+ * @brief Unit tests for the heap monitor (host interposer)
+ *
+ * Tests validate:
+ * - malloc, calloc, realloc and operator new are counted
+ * - Only allocations after heap_mark_steady() are steady-state ones
+ * - The first call stacks are kept, the rest only counted
+ * - Report writers run without allocating
+ */
+
+#include <unity.h>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+#include "ucf_heap.h"
+#include "ucf_memory.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static char g_text[1024];
+static size_t g_text_len = 0;
+
+// Keeps lines without allocating, so report writers can be checked
+static void append_line(const char* line, void* ctx) {
+    size_t len = strlen(line);
+    if (g_text_len + len + 2 <= sizeof(g_text)) {
+        memcpy(g_text + g_text_len, line, len);
+        g_text_len += len;
+        g_text[g_text_len++] = '\n';
+        g_text[g_text_len] = '\0';
+    }
+}
+
+// volatile: the compiler may drop a malloc/free pair it can see through
+static void allocate_and_free(size_t bytes) {
+    void* volatile p = malloc(bytes);
+    free(p);
+}
+
+static uint32_t steady_allocs(void) {
+    HeapStats stats;
+    heap_get_stats(&stats);
+    return stats.steady_allocs;
+}
+
+// ============================================================================
+// START-UP TESTS (run before heap_mark_steady)
+// ============================================================================
+
+void test_counted_before_steady(void) {
+    HeapStats before, after;
+    heap_get_stats(&before);
+    TEST_ASSERT_TRUE(before.counted);
+    TEST_ASSERT_FALSE(before.steady);
+
+    allocate_and_free(32);
+    heap_get_stats(&after);
+    TEST_ASSERT_EQUAL(before.allocs + 1, after.allocs);
+    TEST_ASSERT_EQUAL(0, after.steady_allocs);
+}
+
+void test_report_before_steady(void) {
+    heap_write_text(append_line, NULL);
+    TEST_ASSERT_TRUE(strstr(g_text, "in steady state (not reached)") != NULL);
+}
+
+// ============================================================================
+// STEADY-STATE TESTS
+// ============================================================================
+
+void test_mark_steady(void) {
+    heap_mark_steady();
+    HeapStats stats;
+    heap_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.steady);
+    TEST_ASSERT_EQUAL(0, stats.steady_allocs);
+}
+
+void test_malloc_counted(void) {
+    allocate_and_free(40);
+    void* volatile p = calloc(4, 10);
+    p = realloc(p, 100);
+    free(p);
+
+    HeapStats stats;
+    heap_get_stats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.steady_allocs);
+    TEST_ASSERT_EQUAL(40 + 40 + 100, stats.steady_bytes);
+}
+
+void test_new_counted(void) {
+    int* volatile p = new int[16];
+    delete[] p;
+    TEST_ASSERT_EQUAL(1, steady_allocs());
+
+    // Past the small-string buffer std::string (and the HAL's String) allocates
+    std::string s(64, 'x');
+    TEST_ASSERT_EQUAL(2, steady_allocs());
+}
+
+void test_sites_recorded(void) {
+    allocate_and_free(24);
+
+    HeapSite sites[HEAP_MAX_SITES];
+    TEST_ASSERT_EQUAL(1, heap_sites(sites, HEAP_MAX_SITES));
+    TEST_ASSERT_EQUAL(24, sites[0].bytes);
+    TEST_ASSERT_TRUE(sites[0].depth > 1);
+    TEST_ASSERT_TRUE(sites[0].depth <= HEAP_SITE_DEPTH);
+}
+
+void test_sites_limited(void) {
+    for (int i = 0; i < HEAP_MAX_SITES + 3; i++) {
+        allocate_and_free(8 + i);
+    }
+
+    HeapSite sites[HEAP_MAX_SITES + 3];
+    TEST_ASSERT_EQUAL(HEAP_MAX_SITES, heap_sites(sites, HEAP_MAX_SITES + 3));
+    TEST_ASSERT_EQUAL(8, sites[0].bytes);
+    TEST_ASSERT_EQUAL(HEAP_MAX_SITES + 3, steady_allocs());
+}
+
+void test_reset_clears(void) {
+    allocate_and_free(16);
+    heap_reset_steady();
+
+    HeapSite sites[HEAP_MAX_SITES];
+    HeapStats stats;
+    heap_get_stats(&stats);
+    TEST_ASSERT_TRUE(stats.steady);
+    TEST_ASSERT_EQUAL(0, stats.steady_allocs);
+    TEST_ASSERT_EQUAL(0, stats.steady_bytes);
+    TEST_ASSERT_EQUAL(0, heap_sites(sites, HEAP_MAX_SITES));
+}
+
+void test_report_steady(void) {
+    allocate_and_free(10);
+    heap_write_text(append_line, NULL);
+    TEST_ASSERT_TRUE(strstr(g_text, ", 1 (10 bytes) in steady state\n") != NULL);
+}
+
+void test_report_writers_do_not_allocate(void) {
+    mem_init();
+    mem_alloc("history", 256);
+    mem_write_text(append_line, NULL);
+    heap_write_text(append_line, NULL);
+
+    TEST_ASSERT_TRUE(g_text_len > 0);
+    TEST_ASSERT_EQUAL(0, steady_allocs());
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    g_text_len = 0;
+    g_text[0] = '\0';
+    heap_reset_steady();
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Start-up (order matters: marking steady cannot be undone)
+    RUN_TEST(test_counted_before_steady);
+    RUN_TEST(test_report_before_steady);
+
+    // Steady state
+    RUN_TEST(test_mark_steady);
+    RUN_TEST(test_malloc_counted);
+    RUN_TEST(test_new_counted);
+    RUN_TEST(test_sites_recorded);
+    RUN_TEST(test_sites_limited);
+    RUN_TEST(test_reset_clears);
+    RUN_TEST(test_report_steady);
+    RUN_TEST(test_report_writers_do_not_allocate);
+
+    return UNITY_END();
+}
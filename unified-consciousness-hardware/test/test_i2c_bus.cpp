@@ -0,0 +1,428 @@
+/**
+ * @file test_i2c_bus.cpp
+ * @brief Unit tests for the I2C bus manager
+ *
+ * Tests validate:
+ * - Register reads and writes through the mock bus and its virtual clock
+ * - Priority, deadline and FIFO ordering; expiry without bus time
+ * - Merging of contiguous reads into one burst and splitting the results
+ * - No merging across devices, gaps, writes or the batch limit
+ * - Error status, per-device statistics, trace ring and utilization
+ * - Queue limits and completion back-pressure
+ * - Submit/dispatch and service on two threads, with a client-side reset
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ucf_i2c_bus.h"
+#include "ucf_metrics.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define ADDR_A      0x5A
+#define ADDR_B      0x5B
+#define ADDR_MAG    0x1E
+#define BYTE_US     23              // ~400 kHz
+
+static I2cMockBus g_mock;
+static I2cBus g_bus;
+static uint8_t* g_regs_a;
+static uint8_t* g_regs_b;
+
+struct Done {
+    int tag;
+    I2cStatus status;
+};
+
+static std::vector<Done> g_done;
+
+static void record_done(uint8_t* rx, uint8_t rx_len, I2cStatus status, void* ctx) {
+    g_done.push_back({ (int)(intptr_t)ctx, status });
+}
+
+static bool read(I2cDeviceId dev, uint8_t reg, uint8_t* rx, uint8_t len, int tag,
+                 I2cPriority prio = I2C_PRIO_NORMAL, uint32_t deadline = 0) {
+    return i2c_bus_read(&g_bus, dev, reg, rx, len, prio, deadline, record_done,
+                        (void*)(intptr_t)tag);
+}
+
+// ============================================================================
+// TRANSFER TESTS
+// ============================================================================
+
+void test_read_returns_registers(void) {
+    g_regs_a[0x04] = 0x34;
+    g_regs_a[0x05] = 0x12;
+
+    uint8_t rx[2] = { 0 };
+    TEST_ASSERT_TRUE(read(I2C_DEV_MPR121_A, 0x04, rx, 2, 1));
+    TEST_ASSERT_EQUAL(1, i2c_bus_service_all(&g_bus));
+    TEST_ASSERT_EQUAL(1, i2c_bus_dispatch(&g_bus));
+
+    TEST_ASSERT_EQUAL(1, g_done.size());
+    TEST_ASSERT_EQUAL(I2C_OK, g_done[0].status);
+    TEST_ASSERT_EQUAL_HEX8(0x34, rx[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, rx[1]);
+    // Address, register, address, two data bytes
+    TEST_ASSERT_EQUAL(5 * BYTE_US, g_mock.now_us);
+}
+
+void test_write_updates_registers(void) {
+    I2cTransfer t;
+    memset(&t, 0, sizeof(t));
+    t.device = I2C_DEV_MPR121_B;
+    t.reg = 0x5E;
+    t.tx_len = 1;
+    t.tx[0] = 0x8C;
+    TEST_ASSERT_TRUE(i2c_bus_submit(&g_bus, &t));
+    i2c_bus_service_all(&g_bus);
+    i2c_bus_dispatch(&g_bus);
+
+    TEST_ASSERT_EQUAL_HEX8(0x8C, g_regs_b[0x5E]);
+    TEST_ASSERT_EQUAL(1, i2c_bus_trace(&g_bus, 0)->write);
+}
+
+// ============================================================================
+// ORDERING TESTS
+// ============================================================================
+
+void test_priority_then_deadline_then_fifo(void) {
+    uint8_t rx[6][1];
+    read(I2C_DEV_HMC5883L, 0x00, rx[0], 1, 0, I2C_PRIO_LOW);
+    read(I2C_DEV_HMC5883L, 0x02, rx[1], 1, 1, I2C_PRIO_NORMAL);
+    read(I2C_DEV_HMC5883L, 0x04, rx[2], 1, 2, I2C_PRIO_NORMAL, 9000);
+    read(I2C_DEV_HMC5883L, 0x06, rx[3], 1, 3, I2C_PRIO_HIGH);
+    read(I2C_DEV_HMC5883L, 0x08, rx[4], 1, 4, I2C_PRIO_NORMAL, 5000);
+    read(I2C_DEV_HMC5883L, 0x0A, rx[5], 1, 5, I2C_PRIO_NORMAL);
+
+    i2c_bus_service_all(&g_bus);
+    i2c_bus_dispatch(&g_bus);
+
+    const int expected[] = { 3, 4, 2, 1, 5, 0 };
+    TEST_ASSERT_EQUAL(6, g_done.size());
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL(expected[i], g_done[i].tag);
+    }
+}
+
+void test_expired_transfer_skips_bus(void) {
+    g_mock.now_us = 1000;
+    uint8_t rx[2];
+    read(I2C_DEV_MPR121_A, 0x00, rx, 1, 1, I2C_PRIO_NORMAL, 999);
+    read(I2C_DEV_MPR121_A, 0x10, rx + 1, 1, 2, I2C_PRIO_NORMAL, 5000);
+
+    i2c_bus_service_all(&g_bus);
+    i2c_bus_dispatch(&g_bus);
+
+    TEST_ASSERT_EQUAL(2, g_done.size());
+    TEST_ASSERT_EQUAL(1, g_done[0].tag);
+    TEST_ASSERT_EQUAL(I2C_EXPIRED, g_done[0].status);
+    TEST_ASSERT_EQUAL(I2C_OK, g_done[1].status);
+    TEST_ASSERT_EQUAL(1, g_mock.transactions);
+    TEST_ASSERT_EQUAL(1, i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A)->expired);
+}
+
+void test_unknown_device_fails_without_bus(void) {
+    I2cTransfer t;
+    memset(&t, 0, sizeof(t));
+    t.device = I2C_DEV_COUNT;
+    t.rx_len = 1;
+    t.done = record_done;
+    i2c_bus_submit(&g_bus, &t);
+    i2c_bus_service_all(&g_bus);
+    i2c_bus_dispatch(&g_bus);
+
+    TEST_ASSERT_EQUAL(I2C_ERR_DEVICE, g_done[0].status);
+    TEST_ASSERT_EQUAL(0, g_mock.transactions);
+}
+
+// ============================================================================
+// BATCHING TESTS
+// ============================================================================
+
+void test_electrode_reads_merge_into_one_burst(void) {
+    for (int i = 0; i < 24; i++) {
+        g_regs_a[0x04 + i] = (uint8_t)(i + 1);
+    }
+
+    // Out of order, as separate clients might submit them
+    uint8_t rx[12][2];
+    for (int k = 0; k < 12; k++) {
+        int e = (k * 5) % 12;
+        read(I2C_DEV_MPR121_A, (uint8_t)(0x04 + 2 * e), rx[e], 2, e, I2C_PRIO_HIGH);
+    }
+
+    TEST_ASSERT_EQUAL(12, i2c_bus_service(&g_bus));
+    TEST_ASSERT_EQUAL(1, g_mock.transactions);
+    TEST_ASSERT_EQUAL(12, i2c_bus_dispatch(&g_bus));
+
+    for (int e = 0; e < 12; e++) {
+        TEST_ASSERT_EQUAL(2 * e + 1, rx[e][0]);
+        TEST_ASSERT_EQUAL(2 * e + 2, rx[e][1]);
+    }
+    const I2cTraceEntry* t = i2c_bus_trace(&g_bus, 0);
+    TEST_ASSERT_EQUAL(0x04, t->reg);
+    TEST_ASSERT_EQUAL(24, t->len);
+    TEST_ASSERT_EQUAL(12, t->merged);
+    TEST_ASSERT_EQUAL(27 * BYTE_US, t->duration_us);
+
+    const I2cDeviceStats* s = i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A);
+    TEST_ASSERT_EQUAL(12, s->transfers);
+    TEST_ASSERT_EQUAL(1, s->transactions);
+    TEST_ASSERT_EQUAL(24, s->bytes);
+}
+
+void test_no_merge_across_devices_or_gaps(void) {
+    uint8_t rx[4][2];
+    read(I2C_DEV_MPR121_A, 0x04, rx[0], 2, 0);
+    read(I2C_DEV_MPR121_B, 0x06, rx[1], 2, 1);     // Other device
+    read(I2C_DEV_MPR121_A, 0x07, rx[2], 2, 2);     // Gap of one register
+    read(I2C_DEV_HMC5883L, 0x03, rx[3], 2, 3);
+
+    TEST_ASSERT_EQUAL(4, i2c_bus_service_all(&g_bus));
+    TEST_ASSERT_EQUAL(4, g_mock.transactions);
+}
+
+void test_no_merge_without_auto_increment(void) {
+    i2c_bus_add_device(&g_bus, I2C_DEV_HMC5883L, "hmc5883l", ADDR_MAG, false);
+    uint8_t rx[2];
+    read(I2C_DEV_HMC5883L, 0x03, rx, 1, 0);
+    read(I2C_DEV_HMC5883L, 0x04, rx + 1, 1, 1);
+
+    i2c_bus_service_all(&g_bus);
+    TEST_ASSERT_EQUAL(2, g_mock.transactions);
+}
+
+void test_burst_respects_batch_limit(void) {
+    uint8_t rx[20][2];
+    for (int i = 0; i < 20; i++) {
+        read(I2C_DEV_MPR121_A, (uint8_t)(2 * i), rx[i], 2, i);
+    }
+
+    TEST_ASSERT_EQUAL(20, i2c_bus_service_all(&g_bus));
+    TEST_ASSERT_EQUAL(2, g_mock.transactions);
+    TEST_ASSERT_EQUAL(I2C_BUS_MAX_BATCH, i2c_bus_trace(&g_bus, 1)->len);
+    TEST_ASSERT_EQUAL(40 - I2C_BUS_MAX_BATCH, i2c_bus_trace(&g_bus, 0)->len);
+}
+
+void test_failed_burst_fails_every_member(void) {
+    i2c_mock_fail(&g_mock, ADDR_B, 1, I2C_ERR_NACK);
+    uint8_t rx[3][2];
+    for (int i = 0; i < 3; i++) {
+        read(I2C_DEV_MPR121_B, (uint8_t)(0x04 + 2 * i), rx[i], 2, i);
+    }
+    i2c_bus_service_all(&g_bus);
+    i2c_bus_dispatch(&g_bus);
+
+    TEST_ASSERT_EQUAL(3, g_done.size());
+    for (const Done& d : g_done) {
+        TEST_ASSERT_EQUAL(I2C_ERR_NACK, d.status);
+    }
+}
+
+// ============================================================================
+// TRACE TESTS
+// ============================================================================
+
+void test_errors_counted_and_traced(void) {
+    i2c_mock_fail(&g_mock, ADDR_MAG, 2, I2C_ERR_TIMEOUT);
+    uint8_t rx[6];
+    for (int i = 0; i < 3; i++) {
+        read(I2C_DEV_HMC5883L, 0x03, rx, 6, i);
+        i2c_bus_service_all(&g_bus);
+    }
+
+    const I2cDeviceStats* s = i2c_bus_get_stats(&g_bus, I2C_DEV_HMC5883L);
+    TEST_ASSERT_EQUAL(3, s->transactions);
+    TEST_ASSERT_EQUAL(2, s->errors);
+    TEST_ASSERT_EQUAL(6, s->bytes);
+    TEST_ASSERT_EQUAL(I2C_OK, s->last_status);
+    TEST_ASSERT_EQUAL(2, metrics_counter(METRIC_I2C_ERRORS));
+
+    TEST_ASSERT_EQUAL(I2C_OK, i2c_bus_trace(&g_bus, 0)->status);
+    TEST_ASSERT_EQUAL(I2C_ERR_TIMEOUT, i2c_bus_trace(&g_bus, 1)->status);
+    TEST_ASSERT_NULL(i2c_bus_trace(&g_bus, 3));
+    TEST_ASSERT_EQUAL_STRING("timeout", i2c_status_string(I2C_ERR_TIMEOUT));
+}
+
+void test_trace_ring_keeps_latest(void) {
+    uint8_t rx;
+    for (int i = 0; i < I2C_BUS_TRACE_SIZE + 5; i++) {
+        read(I2C_DEV_MPR121_A, (uint8_t)i, &rx, 1, i);
+        i2c_bus_service_all(&g_bus);
+    }
+    TEST_ASSERT_EQUAL(I2C_BUS_TRACE_SIZE + 4, i2c_bus_trace(&g_bus, 0)->reg);
+    TEST_ASSERT_EQUAL(5, i2c_bus_trace(&g_bus, I2C_BUS_TRACE_SIZE - 1)->reg);
+    TEST_ASSERT_NULL(i2c_bus_trace(&g_bus, I2C_BUS_TRACE_SIZE));
+}
+
+void test_utilization(void) {
+    uint8_t rx[24];
+    read(I2C_DEV_MPR121_A, 0x04, rx, 24, 0);
+    i2c_bus_service_all(&g_bus);
+    uint32_t busy = g_mock.now_us;
+
+    g_mock.now_us += busy;          // Idle for as long again
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, i2c_bus_utilization(&g_bus));
+    TEST_ASSERT_EQUAL(busy, i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A)->max_us);
+
+    // Only posted: the worker clears the counters on its next service
+    i2c_bus_reset_stats(&g_bus);
+    TEST_ASSERT_EQUAL(1, i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A)->transactions);
+    i2c_bus_service(&g_bus);
+    TEST_ASSERT_EQUAL(0, i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A)->transactions);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, i2c_bus_utilization(&g_bus));
+    TEST_ASSERT_NOT_NULL(i2c_bus_trace(&g_bus, 0));
+}
+
+// ============================================================================
+// QUEUE TESTS
+// ============================================================================
+
+void test_submit_refused_when_queue_full(void) {
+    uint8_t rx;
+    for (int i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(read(I2C_DEV_MPR121_A, 0, &rx, 1, i));
+    }
+    TEST_ASSERT_FALSE(read(I2C_DEV_MPR121_A, 0, &rx, 1, 99));
+}
+
+void test_completion_backpressure_loses_nothing(void) {
+    // Fill the completion queue without dispatching, then keep submitting
+    uint8_t rx;
+    int submitted = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < I2C_BUS_QUEUE_SIZE; i++) {
+            if (read(I2C_DEV_MPR121_B, 0, &rx, 1, submitted)) {
+                submitted++;
+            }
+        }
+        i2c_bus_service_all(&g_bus);
+    }
+    TEST_ASSERT_EQUAL(I2C_BUS_COMPLETION_SIZE, g_mock.transactions);
+
+    // Dispatching lets the rest through
+    while (g_done.size() < (size_t)submitted) {
+        i2c_bus_dispatch(&g_bus);
+        i2c_bus_service_all(&g_bus);
+    }
+    for (int i = 0; i < submitted; i++) {
+        TEST_ASSERT_EQUAL(i, g_done[i].tag);
+    }
+}
+
+// ============================================================================
+// THREADING TESTS
+// ============================================================================
+
+static std::atomic<uint32_t> g_wakeups(0);
+
+static void count_wakeup(void* ctx) {
+    g_wakeups.fetch_add(1, std::memory_order_relaxed);
+}
+
+void test_client_and_worker_threads(void) {
+    g_bus.notify = count_wakeup;
+    std::atomic<bool> stop(false);
+    std::thread worker([&]() {
+        while (!stop.load()) {
+            if (i2c_bus_service(&g_bus) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        i2c_bus_service_all(&g_bus);
+    });
+
+    const int frames = 2000;
+    static uint8_t rx[12][2];
+    int done = 0;
+    for (int f = 0; f < frames; f++) {
+        if (f == frames / 2) {
+            i2c_bus_reset_stats(&g_bus);
+        }
+        for (int e = 0; e < 12; e++) {
+            while (!read(I2C_DEV_MPR121_A, (uint8_t)(0x04 + 2 * e), rx[e], 2, e, I2C_PRIO_HIGH)) {
+                done += i2c_bus_dispatch(&g_bus);
+            }
+        }
+        i2c_bus_flush(&g_bus);
+        // One frame in flight at a time: the buffers are reused
+        while (done < (f + 1) * 12) {
+            done += i2c_bus_dispatch(&g_bus);
+        }
+    }
+    stop.store(true);
+    worker.join();
+
+    TEST_ASSERT_EQUAL(frames * 12, done);
+    TEST_ASSERT_EQUAL(frames + 1, g_wakeups.load());
+    // The reset lands before the worker's next pass: at most the frame
+    // it races with goes uncounted
+    const I2cDeviceStats* s = i2c_bus_get_stats(&g_bus, I2C_DEV_MPR121_A);
+    TEST_ASSERT_TRUE(s->transfers <= (uint32_t)frames / 2 * 12);
+    TEST_ASSERT_TRUE(s->transfers >= (uint32_t)(frames / 2 - 1) * 12);
+    TEST_ASSERT_TRUE(s->transactions <= s->transfers);
+    g_bus.notify = NULL;
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    metrics_init();
+    i2c_mock_init(&g_mock, BYTE_US);
+    g_regs_a = i2c_mock_add_device(&g_mock, ADDR_A);
+    g_regs_b = i2c_mock_add_device(&g_mock, ADDR_B);
+    i2c_mock_add_device(&g_mock, ADDR_MAG);
+
+    I2cBackend backend;
+    i2c_mock_backend(&g_mock, &backend);
+    i2c_bus_init(&g_bus, &backend);
+    i2c_bus_add_device(&g_bus, I2C_DEV_MPR121_A, "mpr121_a", ADDR_A, true);
+    i2c_bus_add_device(&g_bus, I2C_DEV_MPR121_B, "mpr121_b", ADDR_B, true);
+    i2c_bus_add_device(&g_bus, I2C_DEV_HMC5883L, "hmc5883l", ADDR_MAG, true);
+    g_done.clear();
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Transfers
+    RUN_TEST(test_read_returns_registers);
+    RUN_TEST(test_write_updates_registers);
+
+    // Ordering
+    RUN_TEST(test_priority_then_deadline_then_fifo);
+    RUN_TEST(test_expired_transfer_skips_bus);
+    RUN_TEST(test_unknown_device_fails_without_bus);
+
+    // Batching
+    RUN_TEST(test_electrode_reads_merge_into_one_burst);
+    RUN_TEST(test_no_merge_across_devices_or_gaps);
+    RUN_TEST(test_no_merge_without_auto_increment);
+    RUN_TEST(test_burst_respects_batch_limit);
+    RUN_TEST(test_failed_burst_fails_every_member);
+
+    // Trace
+    RUN_TEST(test_errors_counted_and_traced);
+    RUN_TEST(test_trace_ring_keeps_latest);
+    RUN_TEST(test_utilization);
+
+    // Queues
+    RUN_TEST(test_submit_refused_when_queue_full);
+    RUN_TEST(test_completion_backpressure_loses_nothing);
+
+    // Threading
+    RUN_TEST(test_client_and_worker_threads);
+
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+/**
+ * @file test_idle.cpp
+ * @brief Unit tests for the idle governor
+ *
+ * Tests validate:
+ * - Gap policy: stay awake, timed wait or light sleep, with margins
+ * - Light sleep only when enabled
+ * - Residency: entries, time per mode, wake sources, worst late wake-up
+ * - Reset and text report
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_idle.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static uint32_t g_now_us;
+static uint32_t g_late_us;                  // Added to every wait or sleep
+static IdleWake g_wake;
+static IdleMode g_last_mode;
+static uint32_t g_last_us;
+static int g_enters;
+
+static uint32_t fake_clock(void) {
+    return g_now_us;
+}
+
+static IdleWake fake_enter(IdleMode mode, uint32_t us, void* ctx) {
+    g_last_mode = mode;
+    g_last_us = us;
+    g_enters++;
+    g_now_us += us + g_late_us;
+    return g_wake;
+}
+
+static const IdleConfig WAIT_ONLY = { IDLE_WAIT_MIN_US, IDLE_WAIT_MARGIN_US, 0, 0 };
+static const IdleConfig WITH_SLEEP = {
+    IDLE_WAIT_MIN_US, IDLE_WAIT_MARGIN_US, IDLE_SLEEP_MIN_US, IDLE_SLEEP_MARGIN_US
+};
+
+static char g_text[512];
+
+static void collect_line(const char* line, void* ctx) {
+    strncat(g_text, line, sizeof(g_text) - strlen(g_text) - 2);
+    strcat(g_text, "\n");
+}
+
+// ============================================================================
+// PLAN TESTS
+// ============================================================================
+
+void test_short_gap_stays_awake(void) {
+    uint32_t enter_us;
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_plan(&WITH_SLEEP, 0, &enter_us));
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_plan(&WITH_SLEEP, IDLE_WAIT_MIN_US - 1, &enter_us));
+    TEST_ASSERT_EQUAL(0, enter_us);
+}
+
+void test_wait_ends_a_margin_early(void) {
+    uint32_t enter_us;
+    TEST_ASSERT_EQUAL(IDLE_WAIT, idle_plan(&WITH_SLEEP, IDLE_WAIT_MIN_US, &enter_us));
+    TEST_ASSERT_EQUAL(IDLE_WAIT_MIN_US - IDLE_WAIT_MARGIN_US, enter_us);
+    TEST_ASSERT_EQUAL(IDLE_WAIT, idle_plan(&WITH_SLEEP, 900, &enter_us));
+    TEST_ASSERT_EQUAL(900 - IDLE_WAIT_MARGIN_US, enter_us);
+}
+
+void test_long_gap_sleeps_when_enabled(void) {
+    uint32_t enter_us;
+    TEST_ASSERT_EQUAL(IDLE_LIGHT_SLEEP, idle_plan(&WITH_SLEEP, IDLE_SLEEP_MIN_US, &enter_us));
+    TEST_ASSERT_EQUAL(IDLE_SLEEP_MIN_US - IDLE_SLEEP_MARGIN_US, enter_us);
+
+    TEST_ASSERT_EQUAL(IDLE_WAIT, idle_plan(&WAIT_ONLY, 50000, &enter_us));
+    TEST_ASSERT_EQUAL(50000 - IDLE_WAIT_MARGIN_US, enter_us);
+}
+
+void test_margin_larger_than_gap_stays_awake(void) {
+    IdleConfig config = { 10, 50, 0, 0 };
+    uint32_t enter_us;
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_plan(&config, 40, &enter_us));
+    TEST_ASSERT_EQUAL(IDLE_WAIT, idle_plan(&config, 60, &enter_us));
+    TEST_ASSERT_EQUAL(10, enter_us);
+}
+
+// ============================================================================
+// RUN TESTS
+// ============================================================================
+
+void test_run_calls_backend(void) {
+    IdleGovernor g;
+    idle_init(&g, &WITH_SLEEP, fake_clock, fake_enter, NULL);
+
+    TEST_ASSERT_EQUAL(IDLE_WAIT, idle_run(&g, 1000));
+    TEST_ASSERT_EQUAL(IDLE_WAIT, g_last_mode);
+    TEST_ASSERT_EQUAL(1000 - IDLE_WAIT_MARGIN_US, g_last_us);
+
+    TEST_ASSERT_EQUAL(IDLE_LIGHT_SLEEP, idle_run(&g, 20000));
+    TEST_ASSERT_EQUAL(IDLE_LIGHT_SLEEP, g_last_mode);
+
+    // Work due or a short gap: no backend call
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_run(&g, 0));
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_run(&g, 20));
+    TEST_ASSERT_EQUAL(2, g_enters);
+}
+
+void test_no_backend_stays_awake(void) {
+    IdleGovernor g;
+    idle_init(&g, &WITH_SLEEP, fake_clock, NULL, NULL);
+    TEST_ASSERT_EQUAL(IDLE_RUN, idle_run(&g, 20000));
+
+    IdleStats stats;
+    idle_get_stats(&g, &stats);
+    TEST_ASSERT_EQUAL(1, stats.entries[IDLE_RUN]);
+    TEST_ASSERT_EQUAL(0, stats.entries[IDLE_LIGHT_SLEEP]);
+}
+
+void test_residency_totals(void) {
+    IdleGovernor g;
+    idle_init(&g, &WITH_SLEEP, fake_clock, fake_enter, NULL);
+
+    for (int i = 0; i < 10; i++) {
+        idle_run(&g, 530);                  // 500 us waits
+        g_now_us += 470;                    // Tasks
+    }
+    idle_run(&g, 11000);                    // 10 ms sleep
+    idle_run(&g, 0);                        // Not a gap
+    idle_run(&g, 50);
+
+    IdleStats stats;
+    idle_get_stats(&g, &stats);
+    TEST_ASSERT_EQUAL(1, stats.entries[IDLE_RUN]);
+    TEST_ASSERT_EQUAL(10, stats.entries[IDLE_WAIT]);
+    TEST_ASSERT_EQUAL(1, stats.entries[IDLE_LIGHT_SLEEP]);
+    TEST_ASSERT_EQUAL(5000, stats.time_us[IDLE_WAIT]);
+    TEST_ASSERT_EQUAL(10000, stats.time_us[IDLE_LIGHT_SLEEP]);
+    TEST_ASSERT_EQUAL(11, stats.wakes[IDLE_WAKE_TIMER]);
+    TEST_ASSERT_EQUAL(19700, stats.window_us);
+}
+
+void test_wake_sources_and_lateness(void) {
+    IdleGovernor g;
+    idle_init(&g, &WITH_SLEEP, fake_clock, fake_enter, NULL);
+
+    g_wake = IDLE_WAKE_UART;
+    idle_run(&g, 8000);
+    g_wake = IDLE_WAKE_TOUCH;
+    g_late_us = 40;
+    idle_run(&g, 8000);
+    g_wake = (IdleWake)99;                  // Unknown cause
+    g_late_us = 15;
+    idle_run(&g, 300);
+
+    IdleStats stats;
+    idle_get_stats(&g, &stats);
+    TEST_ASSERT_EQUAL(1, stats.wakes[IDLE_WAKE_UART]);
+    TEST_ASSERT_EQUAL(1, stats.wakes[IDLE_WAKE_TOUCH]);
+    TEST_ASSERT_EQUAL(1, stats.wakes[IDLE_WAKE_OTHER]);
+    TEST_ASSERT_EQUAL(0, stats.wakes[IDLE_WAKE_TIMER]);
+    TEST_ASSERT_EQUAL(40, stats.max_late_us);
+}
+
+// ============================================================================
+// REPORT TESTS
+// ============================================================================
+
+void test_reset_clears_totals(void) {
+    IdleGovernor g;
+    idle_init(&g, &WITH_SLEEP, fake_clock, fake_enter, NULL);
+    g_late_us = 5;
+    idle_run(&g, 1000);
+    idle_run(&g, 10);
+
+    idle_reset_stats(&g);
+    g_now_us += 250;
+
+    IdleStats stats;
+    idle_get_stats(&g, &stats);
+    TEST_ASSERT_EQUAL(250, stats.window_us);
+    TEST_ASSERT_EQUAL(0, stats.entries[IDLE_RUN]);
+    TEST_ASSERT_EQUAL(0, stats.entries[IDLE_WAIT]);
+    TEST_ASSERT_EQUAL(0, stats.time_us[IDLE_WAIT]);
+    TEST_ASSERT_EQUAL(0, stats.wakes[IDLE_WAKE_TIMER]);
+    TEST_ASSERT_EQUAL(0, stats.max_late_us);
+}
+
+void test_text_report(void) {
+    IdleGovernor g;
+    idle_init(&g, &WAIT_ONLY, fake_clock, fake_enter, NULL);
+    for (int i = 0; i < 4; i++) {
+        idle_run(&g, 530);
+        g_now_us += 500;
+    }
+    idle_run(&g, 20);
+
+    idle_write_text(&g, collect_line, NULL);
+    TEST_ASSERT_NOT_NULL(strstr(g_text, "Idle (0.0 s): 1 short gaps awake, wake late max 0 us\n"));
+    TEST_ASSERT_NOT_NULL(strstr(g_text, "  wait          4 entries      2000 us  50.0%\n"));
+    TEST_ASSERT_NOT_NULL(strstr(g_text, "  sleep         0 entries         0 us   0.0%\n"));
+    TEST_ASSERT_NOT_NULL(strstr(g_text, "  woken by timer=4 uart=0 touch=0 other=0\n"));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    g_now_us = 1000000;
+    g_late_us = 0;
+    g_wake = IDLE_WAKE_TIMER;
+    g_last_mode = IDLE_RUN;
+    g_last_us = 0;
+    g_enters = 0;
+    g_text[0] = '\0';
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Plan
+    RUN_TEST(test_short_gap_stays_awake);
+    RUN_TEST(test_wait_ends_a_margin_early);
+    RUN_TEST(test_long_gap_sleeps_when_enabled);
+    RUN_TEST(test_margin_larger_than_gap_stays_awake);
+
+    // Run
+    RUN_TEST(test_run_calls_backend);
+    RUN_TEST(test_no_backend_stays_awake);
+    RUN_TEST(test_residency_totals);
+    RUN_TEST(test_wake_sources_and_lateness);
+
+    // Report
+    RUN_TEST(test_reset_clears_totals);
+    RUN_TEST(test_text_report);
+
+    return UNITY_END();
+}
@@ -0,0 +1,334 @@
+/**
+ * @file test_latency.cpp
+ * @brief Unit tests for the touch latency tracer
+ *
+ * Tests validate:
+ * - A frame opens on touch onset with the touch and MPR121 read before it
+ * - Hops stamp in pipeline order and the frame ends at the first output
+ * - Stale and out-of-order stamps are skipped
+ * - A new touch or the timeout closes a frame incomplete
+ * - Recent-frame ring order and the Chrome trace export
+ */
+
+#include <unity.h>
+#include <string>
+#include "ucf_latency.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static uint32_t g_now_us = 0;
+
+static uint32_t fake_clock(void) {
+    return g_now_us;
+}
+
+static void at(uint32_t us) {
+    g_now_us = us;
+}
+
+static void append_line(const char* line, void* ctx) {
+    std::string* out = (std::string*)ctx;
+    *out += line;
+    *out += "\n";
+}
+
+static size_t count_of(const std::string& s, const char* needle) {
+    size_t n = 0;
+    for (size_t pos = s.find(needle); pos != std::string::npos; pos = s.find(needle, pos + 1)) {
+        n++;
+    }
+    return n;
+}
+
+static uint32_t g_callback_frames = 0;
+
+static void count_frame(const LatFrame* frame, void* ctx) {
+    g_callback_frames++;
+}
+
+/**
+ * @brief Touch at 1 ms, read at 2 ms, field at 3 ms, phase 5, emanation 6, LED 8
+ */
+static void run_full_frame(uint32_t base_us) {
+    at(base_us + 1000); lat_touch(g_now_us);
+    at(base_us + 2000); lat_mark(LAT_MPR121);
+    at(base_us + 3000); lat_field(true);
+    at(base_us + 5000); lat_mark(LAT_PHASE);
+    at(base_us + 6000); lat_mark(LAT_EMANATION);
+    at(base_us + 8000); lat_mark(LAT_LED);
+    at(base_us + 9000); lat_field(true);       // Records the finished frame
+    at(base_us + 9500); lat_field(false);
+}
+
+// ============================================================================
+// FRAME TESTS
+// ============================================================================
+
+void test_no_frame_without_touch(void) {
+    at(1000); lat_mark(LAT_PHASE);
+    at(2000); lat_field(false);
+    at(3000); lat_mark(LAT_LED);
+    at(4000); lat_field(false);
+
+    LatStats stats;
+    LatSummary s;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.complete);
+    TEST_ASSERT_EQUAL(0, stats.incomplete);
+    TEST_ASSERT_FALSE(lat_get_total(&s));
+}
+
+void test_full_frame_hops(void) {
+    run_full_frame(0);
+
+    LatFrame f;
+    TEST_ASSERT_EQUAL(1, lat_recent(&f, 1));
+    TEST_ASSERT_EQUAL(LAT_HOP_BIT(LAT_TOUCH) | LAT_HOP_BIT(LAT_MPR121) | LAT_HOP_BIT(LAT_FIELD) |
+                      LAT_HOP_BIT(LAT_PHASE) | LAT_HOP_BIT(LAT_EMANATION) | LAT_HOP_BIT(LAT_LED),
+                      f.mask);
+    TEST_ASSERT_EQUAL(1000, f.stamps_us[LAT_TOUCH]);
+    TEST_ASSERT_EQUAL(3000, f.stamps_us[LAT_FIELD]);
+    TEST_ASSERT_EQUAL(8000, f.stamps_us[LAT_LED]);
+
+    LatSummary s;
+    TEST_ASSERT_TRUE(lat_get(LAT_MPR121, &s));
+    TEST_ASSERT_EQUAL(1000, s.max_us);
+    TEST_ASSERT_TRUE(lat_get(LAT_PHASE, &s));
+    TEST_ASSERT_EQUAL(2000, s.max_us);
+    TEST_ASSERT_TRUE(lat_get(LAT_LED, &s));
+    TEST_ASSERT_EQUAL(2000, s.max_us);
+    TEST_ASSERT_FALSE(lat_get(LAT_TOUCH, &s));
+    TEST_ASSERT_FALSE(lat_get(LAT_AUDIO, &s));
+
+    TEST_ASSERT_TRUE(lat_get_total(&s));
+    TEST_ASSERT_EQUAL(1, s.count);
+    TEST_ASSERT_EQUAL(7000, s.max_us);
+
+    LatStats stats;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.complete);
+    TEST_ASSERT_EQUAL(0, stats.incomplete);
+}
+
+void test_first_output_ends_frame(void) {
+    at(1000); lat_field(true);
+    at(2000); lat_mark(LAT_AUDIO);
+    at(3000); lat_mark(LAT_LED);                // After the output: not this touch's
+    at(4000); lat_field(true);
+
+    LatFrame f;
+    TEST_ASSERT_EQUAL(1, lat_recent(&f, 1));
+    TEST_ASSERT_EQUAL(LAT_HOP_BIT(LAT_FIELD) | LAT_HOP_BIT(LAT_AUDIO), f.mask);
+
+    LatSummary s;
+    TEST_ASSERT_TRUE(lat_get_total(&s));
+    TEST_ASSERT_EQUAL(1000, s.max_us);
+}
+
+void test_out_of_order_stamp_skipped(void) {
+    at(1000); lat_field(true);
+    at(2000); lat_mark(LAT_EMANATION);
+    at(3000); lat_mark(LAT_PHASE);              // Ran off older data
+    at(4000); lat_mark(LAT_EMANATION);          // Already stamped
+    at(5000); lat_mark(LAT_LED);
+    at(6000); lat_field(true);
+
+    LatFrame f;
+    TEST_ASSERT_EQUAL(1, lat_recent(&f, 1));
+    TEST_ASSERT_EQUAL(LAT_HOP_BIT(LAT_FIELD) | LAT_HOP_BIT(LAT_EMANATION) | LAT_HOP_BIT(LAT_LED),
+                      f.mask);
+    TEST_ASSERT_EQUAL(2000, f.stamps_us[LAT_EMANATION]);
+
+    LatSummary s;
+    TEST_ASSERT_FALSE(lat_get(LAT_PHASE, &s));
+    TEST_ASSERT_TRUE(lat_get(LAT_EMANATION, &s));
+    TEST_ASSERT_EQUAL(1000, s.max_us);
+}
+
+void test_old_read_and_touch_not_taken(void) {
+    at(1000); lat_touch(g_now_us);
+    at(1000); lat_mark(LAT_MPR121);
+    at(1000 + LAT_TIMEOUT_US); lat_field(true);
+
+    at(1000 + LAT_TIMEOUT_US + 500); lat_mark(LAT_LED);
+    at(1000 + LAT_TIMEOUT_US + 600); lat_field(true);
+
+    LatFrame f;
+    TEST_ASSERT_EQUAL(1, lat_recent(&f, 1));
+    TEST_ASSERT_EQUAL(LAT_HOP_BIT(LAT_FIELD) | LAT_HOP_BIT(LAT_LED), f.mask);
+}
+
+void test_held_touch_opens_one_frame(void) {
+    at(1000); lat_field(true);
+    at(2000); lat_mark(LAT_LED);
+    at(3000); lat_field(true);
+    at(4000); lat_mark(LAT_LED);                // Still the first touch
+    at(5000); lat_field(true);
+
+    LatStats stats;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.complete);
+    TEST_ASSERT_EQUAL(0, stats.incomplete);
+}
+
+// ============================================================================
+// INCOMPLETE FRAME TESTS
+// ============================================================================
+
+void test_new_touch_closes_frame_incomplete(void) {
+    at(1000); lat_field(true);
+    at(2000); lat_mark(LAT_PHASE);
+    at(3000); lat_field(false);
+    at(4000); lat_field(true);                  // Second touch before any output
+    at(5000); lat_mark(LAT_LED);
+    at(6000); lat_field(true);
+
+    LatStats stats;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.complete);
+    TEST_ASSERT_EQUAL(1, stats.incomplete);
+
+    LatFrame f[2];
+    TEST_ASSERT_EQUAL(2, lat_recent(f, 2));
+    TEST_ASSERT_EQUAL(LAT_HOP_BIT(LAT_FIELD) | LAT_HOP_BIT(LAT_PHASE), f[0].mask);
+    TEST_ASSERT_EQUAL(f[0].id + 1, f[1].id);
+
+    LatSummary s;
+    TEST_ASSERT_TRUE(lat_get_total(&s));
+    TEST_ASSERT_EQUAL(1, s.count);
+    TEST_ASSERT_EQUAL(1000, s.max_us);
+}
+
+void test_timeout_closes_frame_incomplete(void) {
+    at(1000); lat_field(true);
+    at(2000); lat_mark(LAT_PHASE);
+    at(1000 + LAT_TIMEOUT_US - 1); lat_field(true);
+
+    LatStats stats;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.incomplete);
+
+    at(1000 + LAT_TIMEOUT_US); lat_field(true);
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.incomplete);
+
+    // The closed frame takes no late stamps
+    at(1000 + LAT_TIMEOUT_US + 10); lat_mark(LAT_LED);
+    at(1000 + LAT_TIMEOUT_US + 20); lat_field(true);
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.complete);
+}
+
+// ============================================================================
+// RING AND EXPORT TESTS
+// ============================================================================
+
+void test_recent_ring_keeps_newest(void) {
+    for (uint32_t i = 0; i < LAT_RING_FRAMES + 3; i++) {
+        run_full_frame(i * 100000);
+    }
+
+    LatFrame f[LAT_RING_FRAMES + 3];
+    size_t n = lat_recent(f, LAT_RING_FRAMES + 3);
+    TEST_ASSERT_EQUAL(LAT_RING_FRAMES, n);
+    TEST_ASSERT_EQUAL(4, f[0].id);
+    TEST_ASSERT_EQUAL(LAT_RING_FRAMES + 3, f[n - 1].id);
+    TEST_ASSERT_EQUAL(1, lat_recent(f, 1));
+    TEST_ASSERT_EQUAL(LAT_RING_FRAMES + 3, f[0].id);
+
+    lat_reset();
+    TEST_ASSERT_EQUAL(0, lat_recent(f, LAT_RING_FRAMES));
+}
+
+void test_frame_callback(void) {
+    g_callback_frames = 0;
+    lat_on_frame(count_frame, NULL);
+    lat_init(fake_clock);                       // Callback kept across init
+    run_full_frame(0);
+    run_full_frame(100000);
+    lat_on_frame(NULL, NULL);
+    TEST_ASSERT_EQUAL(2, g_callback_frames);
+}
+
+void test_no_clock_no_frames(void) {
+    lat_init(NULL);
+    run_full_frame(0);
+
+    LatStats stats;
+    lat_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.complete);
+}
+
+void test_chrome_export(void) {
+    run_full_frame(0);
+    LatFrame f[2];
+    f[0] = {};
+    TEST_ASSERT_EQUAL(1, lat_recent(&f[1], 1));
+
+    std::string out;
+    lat_write_chrome(f, 2, append_line, &out);  // Empty frames are skipped
+
+    TEST_ASSERT_EQUAL(0, out.find("{\"displayTimeUnit\""));
+    TEST_ASSERT_EQUAL(out.size() - 3, out.rfind("]}\n"));
+    TEST_ASSERT_EQUAL(1, count_of(out, "\"touch_to_output\""));
+    TEST_ASSERT_EQUAL(6, count_of(out, "\"ph\":\"X\""));     // Total plus five hops
+    TEST_ASSERT_EQUAL(5, count_of(out, "}\n,{"));
+    TEST_ASSERT_TRUE(out.find("\"ts\":1000,\"dur\":7000") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("\"name\":\"led\"") != std::string::npos);
+}
+
+void test_text_export(void) {
+    run_full_frame(0);
+
+    std::string out;
+    lat_write_text(append_line, &out);
+    TEST_ASSERT_TRUE(out.find("1 frames, 0 incomplete") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("total") != std::string::npos);
+    TEST_ASSERT_EQUAL(7, count_of(out, "\n"));  // Header, five hops, total
+}
+
+void test_hop_names(void) {
+    TEST_ASSERT_EQUAL_STRING("mpr121", lat_hop_name(LAT_MPR121));
+    TEST_ASSERT_EQUAL_STRING("audio", lat_hop_name(LAT_AUDIO));
+    TEST_ASSERT_EQUAL_STRING("unknown", lat_hop_name(LAT_HOP_COUNT));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    g_now_us = 0;
+    lat_init(fake_clock);
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Frames
+    RUN_TEST(test_no_frame_without_touch);
+    RUN_TEST(test_full_frame_hops);
+    RUN_TEST(test_first_output_ends_frame);
+    RUN_TEST(test_out_of_order_stamp_skipped);
+    RUN_TEST(test_old_read_and_touch_not_taken);
+    RUN_TEST(test_held_touch_opens_one_frame);
+
+    // Incomplete frames
+    RUN_TEST(test_new_touch_closes_frame_incomplete);
+    RUN_TEST(test_timeout_closes_frame_incomplete);
+
+    // Ring and export
+    RUN_TEST(test_recent_ring_keeps_newest);
+    RUN_TEST(test_frame_callback);
+    RUN_TEST(test_no_clock_no_frames);
+    RUN_TEST(test_chrome_export);
+    RUN_TEST(test_text_export);
+    RUN_TEST(test_hop_names);
+
+    return UNITY_END();
+}
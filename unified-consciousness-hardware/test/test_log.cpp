@@ -0,0 +1,242 @@
+/**
+ * @file test_log.cpp
+ * @brief Unit tests for the deferred logger
+ *
+ * Tests validate:
+ * - Records come out in order with their arguments, prefix first
+ * - Conversions: widths, precision, flags, %s, %c, %x, %%, missing args
+ * - A full ring refuses records and counts them
+ * - Levels and categories are filtered at compile time
+ * - Concurrent producers lose nothing and keep their own order
+ */
+
+// Everything but the debug category (set before the header reads it)
+#define UCF_LOG_CATEGORIES          (~LOG_CAT_BIT(LOG_CAT_DEBUG))
+
+#include <unity.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include <stdio.h>
+#include "ucf_log.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static void append_line(const char* line, void* ctx) {
+    std::string* out = (std::string*)ctx;
+    *out += line;
+    *out += "\n";
+}
+
+static std::string drain_all(void) {
+    std::string out;
+    log_drain(append_line, &out, UCF_LOG_RECORDS);
+    return out;
+}
+
+static uint32_t written(void) {
+    LogStats stats;
+    log_get_stats(&stats);
+    return stats.written;
+}
+
+// ============================================================================
+// FORMAT TESTS
+// ============================================================================
+
+void test_status_line(void) {
+    const char* phase = "PARADOX";
+    UCF_LOGI(LOG_CAT_STATUS, "z=%.3f t%d %s | kappa=%.3f eta=%.3f R=%d | %s%s| loops=%lu",
+             0.8123f, 6, phase, 0.5f, 0.75f, 19, "TRIAD ", "", (unsigned long)4200000);
+    TEST_ASSERT_EQUAL_STRING(
+        "z=0.812 t6 PARADOX | kappa=0.500 eta=0.750 R=19 | TRIAD | loops=4200000\n",
+        drain_all().c_str());
+}
+
+void test_category_prefix(void) {
+    UCF_LOGI(LOG_CAT_UCF, "Sensors initialized");
+    UCF_LOGI(LOG_CAT_KURAMOTO, "R=%.4f", 0.5f);
+    UCF_LOGI(LOG_CAT_EVENT, ">>> SYNCHRONIZED r=%.3f <<<", 0.912f);
+    TEST_ASSERT_EQUAL_STRING("[UCF] Sensors initialized\n[KUR] R=0.5000\n>>> SYNCHRONIZED r=0.912 <<<\n",
+                             drain_all().c_str());
+}
+
+void test_conversions(void) {
+    UCF_LOGI(LOG_CAT_STATUS, "%5d|%-4u|%03x|%X|%c|%%|%+.1f|%8.2e|%s", -42, 7u, 10, 255u, 'k',
+             2.25, 12345.0f, "end");
+    TEST_ASSERT_EQUAL_STRING("  -42|7   |00a|FF|k|%|+2.2|1.23e+04|end\n", drain_all().c_str());
+}
+
+void test_wide_and_missing_args(void) {
+    UCF_LOGI(LOG_CAT_STATUS, "%lu %ld %llu", 4000000000UL, -5L, 7ULL);
+    UCF_LOGI(LOG_CAT_STATUS, "null=%s", (const char*)NULL);
+    TEST_ASSERT_EQUAL_STRING("4000000000 -5 7\nnull=(null)\n", drain_all().c_str());
+
+    // A record built by hand with fewer arguments than conversions
+    static const LogSite site = { "a=%d b=%d", LOG_LEVEL_INFO, LOG_CAT_STATUS };
+    LogArg arg;
+    arg.i = 3;
+    log_push(&site, &arg, 1);
+    TEST_ASSERT_EQUAL_STRING("a=3 b=0\n", drain_all().c_str());
+}
+
+void test_line_truncated(void) {
+    static const LogSite site = { "%s%s%s", LOG_LEVEL_INFO, LOG_CAT_UCF };
+    const char* chunk = "0123456789012345678901234567890123456789012345678901234567890123456789";
+    LogRecord record;
+    record.site = &site;
+    record.argc = 3;
+    record.args[0].s = chunk;
+    record.args[1].s = chunk;
+    record.args[2].s = chunk;
+
+    char line[LOG_LINE_MAX];
+    size_t len = log_format(&record, line, sizeof(line));
+    TEST_ASSERT_EQUAL(LOG_LINE_MAX - 1, len);
+    TEST_ASSERT_EQUAL(LOG_LINE_MAX - 1, strlen(line));
+    TEST_ASSERT_EQUAL(0, strncmp(line, "[UCF] 0123", 10));
+}
+
+// ============================================================================
+// RING TESTS
+// ============================================================================
+
+void test_full_ring_drops(void) {
+    for (int i = 0; i < UCF_LOG_RECORDS + 5; i++) {
+        UCF_LOGI(LOG_CAT_STATUS, "n=%d", i);
+    }
+
+    LogStats stats;
+    log_get_stats(&stats);
+    TEST_ASSERT_EQUAL(UCF_LOG_RECORDS, stats.written);
+    TEST_ASSERT_EQUAL(5, stats.dropped);
+    TEST_ASSERT_EQUAL(UCF_LOG_RECORDS, stats.pending);
+
+    // The oldest are kept; space frees as the drain runs
+    std::string out;
+    TEST_ASSERT_EQUAL(2, log_drain(append_line, &out, 2));
+    TEST_ASSERT_EQUAL_STRING("n=0\nn=1\n", out.c_str());
+    UCF_LOGI(LOG_CAT_STATUS, "late");
+    log_get_stats(&stats);
+    TEST_ASSERT_EQUAL(UCF_LOG_RECORDS - 1, stats.pending);
+}
+
+void test_pop_empty(void) {
+    LogRecord record;
+    TEST_ASSERT_FALSE(log_pop(&record));
+    UCF_LOGI(LOG_CAT_STATUS, "one");
+    TEST_ASSERT_TRUE(log_pop(&record));
+    TEST_ASSERT_EQUAL(0, record.argc);
+    TEST_ASSERT_FALSE(log_pop(&record));
+}
+
+// ============================================================================
+// FILTER TESTS
+// ============================================================================
+
+void test_level_filter(void) {
+    UCF_LOGE(LOG_CAT_UCF, "error");
+    UCF_LOGW(LOG_CAT_UCF, "warn");
+    UCF_LOGI(LOG_CAT_UCF, "info");
+    UCF_LOGD(LOG_CAT_UCF, "debug");
+    UCF_LOGV(LOG_CAT_UCF, "verbose");
+    TEST_ASSERT_EQUAL(3, written());
+    TEST_ASSERT_FALSE(UCF_LOG_ENABLED(LOG_LEVEL_DEBUG, LOG_CAT_UCF));
+}
+
+void test_category_filter(void) {
+    UCF_LOGE(LOG_CAT_DEBUG, "filtered out");
+    UCF_LOGE(LOG_CAT_TRIAD, "kept");
+    TEST_ASSERT_EQUAL(1, written());
+    TEST_ASSERT_EQUAL_STRING("[TRI] kept\n", drain_all().c_str());
+}
+
+// ============================================================================
+// CONCURRENCY TESTS
+// ============================================================================
+
+void test_concurrent_producers(void) {
+    const int PRODUCERS = 4;
+    const int PER_PRODUCER = 5000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                // Retry so every record is eventually stored
+                for (;;) {
+                    static const LogSite site = { "%d %d", LOG_LEVEL_INFO, LOG_CAT_STATUS };
+                    LogArg args[2];
+                    args[0].i = p;
+                    args[1].i = i;
+                    if (log_push(&site, args, 2)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    int next[PRODUCERS] = {0};
+    int received = 0;
+    bool ordered = true;
+    LogRecord record;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!log_pop(&record)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = record.args[0].i;
+        ordered = ordered && record.argc == 2 && p >= 0 && p < PRODUCERS &&
+                  record.args[1].i == next[p];
+        if (p >= 0 && p < PRODUCERS) {
+            next[p]++;
+        }
+        received++;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(PRODUCERS * PER_PRODUCER, written());
+    TEST_ASSERT_FALSE(log_pop(&record));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    log_init();
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Format
+    RUN_TEST(test_status_line);
+    RUN_TEST(test_category_prefix);
+    RUN_TEST(test_conversions);
+    RUN_TEST(test_wide_and_missing_args);
+    RUN_TEST(test_line_truncated);
+
+    // Ring
+    RUN_TEST(test_full_ring_drops);
+    RUN_TEST(test_pop_empty);
+
+    // Filters
+    RUN_TEST(test_level_filter);
+    RUN_TEST(test_category_filter);
+
+    // Concurrency
+    RUN_TEST(test_concurrent_producers);
+
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_memory.cpp
+ * @brief Unit tests for the module arena and memory report
+ *
+ * Tests validate:
+ * - Blocks are aligned, zeroed and recorded in allocation order
+ * - Requests that do not fit are refused and totalled
+ * - Scratch release drops later blocks but keeps the peak
+ * - Text report of the static table and arena blocks
+ */
+
+#include <unity.h>
+#include <string>
+#include <string.h>
+#include "ucf_memory.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static void append_line(const char* line, void* ctx) {
+    std::string* out = (std::string*)ctx;
+    *out += line;
+    *out += "\n";
+}
+
+// ============================================================================
+// ARENA TESTS
+// ============================================================================
+
+void test_round_to_alignment(void) {
+    TEST_ASSERT_EQUAL(0, MEM_ROUND(0));
+    TEST_ASSERT_EQUAL(8, MEM_ROUND(1));
+    TEST_ASSERT_EQUAL(8, MEM_ROUND(8));
+    TEST_ASSERT_EQUAL(168, MEM_ROUND(164));
+}
+
+void test_blocks_aligned_and_zeroed(void) {
+    uint8_t* a = (uint8_t*)mem_alloc("a", 5);
+    TEST_ASSERT_NOT_NULL(a);
+    memset(a, 0xAA, 5);
+    uint8_t* b = (uint8_t*)mem_alloc("b", 16);
+    TEST_ASSERT_NOT_NULL(b);
+
+    TEST_ASSERT_EQUAL(0, (uintptr_t)a % MEM_ALIGN);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)b % MEM_ALIGN);
+    TEST_ASSERT_EQUAL_PTR(a + 8, b);
+    for (int i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL(0, b[i]);
+    }
+
+    MemBlock blocks[4];
+    TEST_ASSERT_EQUAL(2, mem_blocks(blocks, 4));
+    TEST_ASSERT_EQUAL_STRING("a", blocks[0].owner);
+    TEST_ASSERT_EQUAL(5, blocks[0].bytes);
+    TEST_ASSERT_EQUAL(8, blocks[1].offset);
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(UCF_ARENA_BYTES, stats.capacity);
+    TEST_ASSERT_EQUAL(24, stats.used);
+    TEST_ASSERT_EQUAL(24, stats.peak);
+    TEST_ASSERT_EQUAL(2, stats.blocks);
+}
+
+void test_full_arena_refuses(void) {
+    TEST_ASSERT_NOT_NULL(mem_alloc("most", UCF_ARENA_BYTES - 16));
+    TEST_ASSERT_NULL(mem_alloc("big", 17));
+    TEST_ASSERT_NULL(mem_alloc("empty", 0));
+    TEST_ASSERT_NOT_NULL(mem_alloc("rest", 16));
+    TEST_ASSERT_NULL(mem_alloc("one", 1));
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(UCF_ARENA_BYTES, stats.used);
+    TEST_ASSERT_EQUAL(18, stats.refused);
+    TEST_ASSERT_EQUAL(2, stats.blocks);
+}
+
+void test_block_table_limit(void) {
+    for (int i = 0; i < MEM_MAX_BLOCKS; i++) {
+        TEST_ASSERT_NOT_NULL(mem_alloc("block", 8));
+    }
+    TEST_ASSERT_NULL(mem_alloc("extra", 8));
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(MEM_MAX_BLOCKS * 8, stats.used);
+    TEST_ASSERT_EQUAL(8, stats.refused);
+}
+
+void test_release_keeps_peak(void) {
+    void* keep = mem_alloc("keep", 100);
+    uint32_t mark = mem_mark();
+    TEST_ASSERT_EQUAL(104, mark);
+
+    TEST_ASSERT_NOT_NULL(mem_alloc("scratch", 400));
+    TEST_ASSERT_NOT_NULL(mem_alloc("scratch2", 40));
+    mem_release(mark);
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(104, stats.used);
+    TEST_ASSERT_EQUAL(104 + 400 + 40, stats.peak);
+    TEST_ASSERT_EQUAL(1, stats.blocks);
+
+    // The space is reused, zeroed again
+    uint8_t* again = (uint8_t*)mem_alloc("again", 8);
+    TEST_ASSERT_EQUAL_PTR((uint8_t*)keep + 104, again);
+    TEST_ASSERT_EQUAL(0, again[0]);
+
+    mem_release(UCF_ARENA_BYTES);   // Past the end: nothing to give back
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(112, stats.used);
+}
+
+void test_init_empties_arena(void) {
+    mem_alloc("a", 64);
+    mem_alloc("b", UCF_ARENA_BYTES);
+    mem_init();
+
+    MemStats stats;
+    mem_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.used);
+    TEST_ASSERT_EQUAL(0, stats.peak);
+    TEST_ASSERT_EQUAL(0, stats.refused);
+    TEST_ASSERT_EQUAL(0, stats.blocks);
+}
+
+// ============================================================================
+// REPORT TESTS
+// ============================================================================
+
+void test_text_report(void) {
+    static const uint8_t small[12] = {0};
+    static const uint32_t large[100] = {0};
+    static const MemStaticEntry table[] = {
+        MEM_STATIC(small),
+        MEM_STATIC(large),
+    };
+    mem_set_static(table, 2);
+    mem_alloc("history", 3072);
+
+    std::string out;
+    mem_write_text(append_line, &out);
+    TEST_ASSERT_TRUE(out.find("small") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("large                   400") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("total                   412") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("3072 used, 3072 peak") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find("history                3072 @ 0") != std::string::npos);
+
+    mem_set_static(NULL, 0);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    mem_init();
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Arena
+    RUN_TEST(test_round_to_alignment);
+    RUN_TEST(test_blocks_aligned_and_zeroed);
+    RUN_TEST(test_full_arena_refuses);
+    RUN_TEST(test_block_table_limit);
+    RUN_TEST(test_release_keeps_peak);
+    RUN_TEST(test_init_empties_arena);
+
+    // Report
+    RUN_TEST(test_text_report);
+
+    return UNITY_END();
+}
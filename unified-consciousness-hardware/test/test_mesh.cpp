@@ -0,0 +1,427 @@
+/**
+ * @file test_mesh.cpp
+ * @brief Unit tests for the Kuramoto device mesh
+ *
+ * Tests validate:
+ * - Summary packets round-trip; foreign and malformed packets are refused
+ * - Sequence gaps count as lost; duplicates and old packets are rejected
+ * - Latency compensation: peer phases predicted through delay jitter and
+ *   a foreign clock
+ * - The combined field of several peers; silent peers leave it and free
+ *   their slots
+ * - Two ensembles coupled through the in-process hub phase-lock
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include "ucf_mesh.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define TEST_TWO_PI         6.28318530718f
+#define SCRIPT_MAX          32
+
+/**
+ * @brief Backend replaying scripted packets and recording sent ones
+ */
+typedef struct {
+    uint8_t rx[SCRIPT_MAX][MESH_PACKET_BYTES + 1];
+    uint8_t rx_len[SCRIPT_MAX];
+    int rx_count;
+    int rx_next;
+    int sent;
+    bool fail_send;
+} Script;
+
+static Script g_script;
+static Mesh g_mesh;
+static MeshMockHub g_hub;
+static char g_lines[8][MESH_LINE_MAX];
+static int g_line_count;
+
+static bool script_send(void* ctx, const uint8_t* data, uint8_t len) {
+    Script* s = (Script*)ctx;
+    if (s->fail_send) {
+        return false;
+    }
+    s->sent++;
+    return true;
+}
+
+static uint8_t script_recv(void* ctx, uint8_t* data, uint8_t max, uint32_t* rx_us) {
+    Script* s = (Script*)ctx;
+    if (s->rx_next == s->rx_count) {
+        return 0;
+    }
+    uint8_t len = s->rx_len[s->rx_next] < max ? s->rx_len[s->rx_next] : max;
+    memcpy(data, s->rx[s->rx_next++], len);
+    return len;
+}
+
+static void start_scripted(uint8_t node) {
+    MeshBackend backend = { script_send, script_recv, &g_script };
+    mesh_init(&g_mesh, &backend, node);
+}
+
+static void queue_summary(uint8_t node, uint16_t seq, float r, float psi, float freq_hz, uint32_t sent_us) {
+    MeshSummary s = { node, seq, r, psi, freq_hz, sent_us };
+    mesh_encode(&s, g_script.rx[g_script.rx_count]);
+    g_script.rx_len[g_script.rx_count++] = MESH_PACKET_BYTES;
+}
+
+static float phase_error(float a, float b) {
+    float d = fmodf(a - b, TEST_TWO_PI);
+    if (d > TEST_TWO_PI / 2) d -= TEST_TWO_PI;
+    if (d < -TEST_TWO_PI / 2) d += TEST_TWO_PI;
+    return fabsf(d);
+}
+
+static void collect_line(const char* line, void* ctx) {
+    if (g_line_count < 8) {
+        snprintf(g_lines[g_line_count++], MESH_LINE_MAX, "%s", line);
+    }
+}
+
+// ============================================================================
+// PACKET TESTS
+// ============================================================================
+
+void test_packet_round_trip(void) {
+    MeshSummary in = { 7, 51234, 0.8125f, 4.5f, 10.37f, 0xDEADBEEF };
+    uint8_t packet[MESH_PACKET_BYTES];
+    mesh_encode(&in, packet);
+
+    MeshSummary out;
+    TEST_ASSERT_TRUE(mesh_decode(packet, sizeof(packet), &out));
+    TEST_ASSERT_EQUAL(7, out.node);
+    TEST_ASSERT_EQUAL(51234, out.seq);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.8125f, out.r);
+    TEST_ASSERT_FLOAT_WITHIN(0.0002f, 4.5f, out.psi);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 10.37f, out.freq_hz);
+    TEST_ASSERT_EQUAL_HEX32(0xDEADBEEF, out.sent_us);
+}
+
+void test_packet_clamps_and_wraps(void) {
+    MeshSummary in = { 1, 0, 1.5f, -1.0f, -500.0f, 0 };
+    uint8_t packet[MESH_PACKET_BYTES];
+    mesh_encode(&in, packet);
+
+    MeshSummary out;
+    TEST_ASSERT_TRUE(mesh_decode(packet, sizeof(packet), &out));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, out.r);
+    TEST_ASSERT_FLOAT_WITHIN(0.0002f, TEST_TWO_PI - 1.0f, out.psi);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -327.68f, out.freq_hz);
+}
+
+void test_decode_refuses_foreign_packets(void) {
+    MeshSummary in = { 3, 1, 0.5f, 1.0f, 10.0f, 1000 };
+    uint8_t packet[MESH_PACKET_BYTES];
+    MeshSummary out;
+    mesh_encode(&in, packet);
+
+    TEST_ASSERT_FALSE(mesh_decode(packet, MESH_PACKET_BYTES - 1, &out));
+    TEST_ASSERT_FALSE(mesh_decode(packet, MESH_PACKET_BYTES + 1, &out));
+    packet[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(mesh_decode(packet, MESH_PACKET_BYTES, &out));
+
+    in.node = MESH_NODE_NONE;
+    mesh_encode(&in, packet);
+    TEST_ASSERT_FALSE(mesh_decode(packet, MESH_PACKET_BYTES, &out));
+}
+
+// ============================================================================
+// PEER TESTS
+// ============================================================================
+
+void test_poll_rejects_own_and_malformed(void) {
+    start_scripted(1);
+    queue_summary(1, 0, 0.5f, 0.0f, 10.0f, 0);          // Our own, echoed
+    queue_summary(2, 0, 0.5f, 0.0f, 10.0f, 0);
+    g_script.rx_len[g_script.rx_count] = 3;             // Truncated
+    g_script.rx_count++;
+
+    TEST_ASSERT_EQUAL(1, mesh_poll(&g_mesh, 1000));
+    TEST_ASSERT_EQUAL(1, g_mesh.stats.received);
+    TEST_ASSERT_EQUAL(2, g_mesh.stats.rejected);
+}
+
+void test_sequence_gaps_count_as_lost(void) {
+    start_scripted(1);
+    queue_summary(2, 10, 0.5f, 0.0f, 10.0f, 0);
+    queue_summary(2, 11, 0.5f, 0.0f, 10.0f, 20000);
+    queue_summary(2, 14, 0.5f, 0.0f, 10.0f, 80000);     // 12 and 13 lost
+
+    TEST_ASSERT_EQUAL(3, mesh_poll(&g_mesh, 90000));
+    TEST_ASSERT_EQUAL(2, g_mesh.stats.lost);
+    TEST_ASSERT_EQUAL(2, g_mesh.peers[0].lost);
+    TEST_ASSERT_EQUAL(3, g_mesh.peers[0].packets);
+}
+
+void test_duplicates_and_old_packets_rejected(void) {
+    start_scripted(1);
+    queue_summary(2, 65535, 0.5f, 1.0f, 10.0f, 0);
+    queue_summary(2, 0, 0.5f, 2.0f, 10.0f, 20000);      // Wraps: next in order
+    queue_summary(2, 0, 0.5f, 3.0f, 10.0f, 20000);      // Duplicate
+    queue_summary(2, 65535, 0.5f, 4.0f, 10.0f, 0);      // Late
+
+    TEST_ASSERT_EQUAL(2, mesh_poll(&g_mesh, 30000));
+    TEST_ASSERT_EQUAL(2, g_mesh.stats.rejected);
+    TEST_ASSERT_EQUAL(0, g_mesh.stats.lost);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0f, g_mesh.peers[0].last.psi);
+}
+
+void test_offset_keeps_shortest_delay(void) {
+    // Sender clock 5 s ahead; delays 4, 1 and 2.5 ms
+    start_scripted(1);
+    queue_summary(2, 0, 0.5f, 0.0f, 10.0f, 5000000);
+    mesh_poll(&g_mesh, 4000);
+    queue_summary(2, 1, 0.5f, 0.0f, 10.0f, 5020000);
+    mesh_poll(&g_mesh, 21000);
+    queue_summary(2, 2, 0.5f, 0.0f, 10.0f, 5040000);
+    mesh_poll(&g_mesh, 42500);
+
+    // Creeping up by one step since the shortest delay
+    TEST_ASSERT_EQUAL(1000 + MESH_OFFSET_CREEP_US - 5000000, g_mesh.peers[0].offset_us);
+
+    // The summary held at the sender's send time, in our clock
+    TEST_ASSERT_EQUAL(40000 + 1000 + MESH_OFFSET_CREEP_US - MESH_LINK_LATENCY_US,
+                      g_mesh.peers[0].held_us);
+}
+
+void test_latency_compensated_under_jitter(void) {
+    // Sender at 10 Hz on a clock 123 ms behind ours; every other packet 3 ms late
+    MeshMockPort ports[2];
+    MeshBackend backends[2];
+    Mesh sender;
+    mesh_mock_init(&g_hub, 2, MESH_LINK_LATENCY_US);
+    g_hub.jitter_us = 3000;
+    mesh_mock_backend(&g_hub, 0, &ports[0], &backends[0]);
+    mesh_mock_backend(&g_hub, 1, &ports[1], &backends[1]);
+    mesh_init(&sender, &backends[0], 10);
+    mesh_init(&g_mesh, &backends[1], 11);
+
+    const float freq = 10.0f;
+    const uint32_t skew = 123000;
+    float worst = 0.0f;
+    for (uint32_t t = 0; t <= 2000000; t += 1000) {
+        g_hub.now_us = t;
+        float true_psi = fmodf(TEST_TWO_PI * freq * t / 1e6f, TEST_TWO_PI);
+        if (t % MESH_BROADCAST_US == 0) {
+            mesh_broadcast(&sender, 1.0f, true_psi, freq, t - skew);
+        }
+        mesh_poll(&g_mesh, t);
+        if (t >= 100000 && g_mesh.peers[0].active) {
+            float e = phase_error(mesh_peer_phase(&g_mesh.peers[0], t), true_psi);
+            worst = e > worst ? e : worst;
+        }
+    }
+
+    TEST_ASSERT_TRUE(g_mesh.stats.received > 90);
+    // Uncompensated, the late packets would be 3 ms = 0.19 rad behind
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, worst);
+}
+
+// ============================================================================
+// FIELD TESTS
+// ============================================================================
+
+void test_field_combines_peers(void) {
+    start_scripted(1);
+    queue_summary(2, 0, 1.0f, 0.0f, 10.0f, 0);
+    queue_summary(3, 0, 1.0f, TEST_TWO_PI / 4, 12.0f, 0);
+    queue_summary(4, 0, 0.0f, 2.0f, 50.0f, 0);          // Incoherent: no pull, no weight
+    mesh_poll(&g_mesh, MESH_LINK_LATENCY_US);
+
+    // Held 1 ms ago (arrived at MESH_LINK_LATENCY_US): 10 and 12 Hz phases moved on
+    float psi_a = TEST_TWO_PI * 10.0f * 0.001f;
+    float psi_b = TEST_TWO_PI / 4 + TEST_TWO_PI * 12.0f * 0.001f;
+    float x = cosf(psi_a) + cosf(psi_b);
+    float y = sinf(psi_a) + sinf(psi_b);
+
+    MeshField field;
+    TEST_ASSERT_TRUE(mesh_field(&g_mesh, MESH_LINK_LATENCY_US, &field));
+    TEST_ASSERT_EQUAL(3, field.peers);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, sqrtf(x * x + y * y) / 3.0f, field.r);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, atan2f(y, x), field.psi);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 11.0f, field.freq_hz);
+}
+
+void test_field_advances_with_time(void) {
+    start_scripted(1);
+    queue_summary(2, 0, 1.0f, 1.0f, 10.0f, 0);
+    mesh_poll(&g_mesh, MESH_LINK_LATENCY_US);
+
+    MeshField field;
+    mesh_field(&g_mesh, 25000, &field);                 // A quarter cycle later
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f + TEST_TWO_PI / 4, field.psi);
+}
+
+void test_silent_peer_leaves_field(void) {
+    start_scripted(1);
+    queue_summary(2, 0, 1.0f, 0.0f, 10.0f, 0);
+    mesh_poll(&g_mesh, 1000);
+
+    MeshField field;
+    TEST_ASSERT_TRUE(mesh_field(&g_mesh, 1000 + MESH_PEER_TIMEOUT_US, &field));
+    TEST_ASSERT_FALSE(mesh_field(&g_mesh, 1001 + MESH_PEER_TIMEOUT_US, &field));
+    TEST_ASSERT_EQUAL(0, field.peers);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, field.r);
+}
+
+void test_slots_reused_after_silence(void) {
+    start_scripted(1);
+    for (int i = 0; i < MESH_MAX_PEERS + 1; i++) {
+        queue_summary((uint8_t)(10 + i), 0, 1.0f, 0.0f, 10.0f, 0);
+    }
+    mesh_poll(&g_mesh, 1000);
+    TEST_ASSERT_EQUAL(MESH_MAX_PEERS, g_mesh.stats.received);
+    TEST_ASSERT_EQUAL(1, g_mesh.stats.no_slot);
+
+    // All silent: a newcomer takes the first slot
+    queue_summary(99, 0, 1.0f, 0.0f, 10.0f, 400000);
+    mesh_poll(&g_mesh, 400000);
+    TEST_ASSERT_EQUAL(99, g_mesh.peers[0].last.node);
+    TEST_ASSERT_EQUAL(1, g_mesh.peers[0].packets);
+}
+
+void test_returning_peer_starts_over(void) {
+    // Rebooted: sequence from 0 again, a new clock
+    start_scripted(1);
+    queue_summary(2, 500, 1.0f, 0.0f, 10.0f, 9000000);
+    mesh_poll(&g_mesh, 1000);
+    queue_summary(2, 0, 1.0f, 0.0f, 10.0f, 0);
+    mesh_poll(&g_mesh, 1000 + MESH_PEER_TIMEOUT_US + 10000);
+
+    TEST_ASSERT_EQUAL(2, g_mesh.stats.received);
+    TEST_ASSERT_EQUAL(0, g_mesh.stats.rejected);
+    TEST_ASSERT_EQUAL(0, g_mesh.stats.lost);
+    TEST_ASSERT_EQUAL(2, g_mesh.peers[0].packets);
+    TEST_ASSERT_EQUAL(1000 + MESH_PEER_TIMEOUT_US + 10000, g_mesh.peers[0].offset_us);
+}
+
+// ============================================================================
+// NODE TESTS
+// ============================================================================
+
+void test_broadcast_counts_failures(void) {
+    start_scripted(1);
+    TEST_ASSERT_TRUE(mesh_broadcast(&g_mesh, 0.5f, 1.0f, 10.0f, 0));
+    g_script.fail_send = true;
+    TEST_ASSERT_FALSE(mesh_broadcast(&g_mesh, 0.5f, 1.0f, 10.0f, 0));
+
+    TEST_ASSERT_EQUAL(1, g_mesh.stats.sent);
+    TEST_ASSERT_EQUAL(1, g_mesh.stats.send_errors);
+    TEST_ASSERT_EQUAL(2, g_mesh.seq);
+}
+
+void test_ensembles_lock_through_hub(void) {
+    // One oscillator per node, 0.3 Hz apart, pulled by the other's summary
+    MeshMockPort ports[2];
+    MeshBackend backends[2];
+    Mesh nodes[2];
+    mesh_mock_init(&g_hub, 2, MESH_LINK_LATENCY_US);
+    g_hub.jitter_us = 2000;
+    g_hub.drop_every = 7;
+    for (int n = 0; n < 2; n++) {
+        mesh_mock_backend(&g_hub, (uint8_t)n, &ports[n], &backends[n]);
+        mesh_init(&nodes[n], &backends[n], (uint8_t)(20 + n));
+    }
+
+    const float coupling = 0.5f;
+    const float freq[2] = { 10.0f, 10.3f };
+    float phase[2] = { 0.0f, 3.0f };
+    float rate[2] = { freq[0], freq[1] };              // Broadcast as the collective frequency
+    float diff_at_4s = 0.0f;
+    for (uint32_t t = 0; t <= 6000000; t += 1000) {
+        g_hub.now_us = t;
+        for (int n = 0; n < 2; n++) {
+            if (t % MESH_BROADCAST_US == 0) {
+                mesh_broadcast(&nodes[n], 1.0f, phase[n], rate[n], t);
+            }
+            mesh_poll(&nodes[n], t);
+        }
+        for (int n = 0; n < 2; n++) {
+            MeshField field;
+            float pull = 0.0f;
+            if (mesh_field(&nodes[n], t, &field)) {
+                pull = coupling * field.r * sinf(field.psi - phase[n]);
+            }
+            rate[n] = freq[n] + pull;
+            phase[n] = fmodf(phase[n] + TEST_TWO_PI * rate[n] * 0.001f, TEST_TWO_PI);
+        }
+        if (t == 4000000) {
+            diff_at_4s = phase_error(phase[1], phase[0]);
+        }
+    }
+
+    // Locked at sin(diff) = 0.3 / (2 * 0.5)
+    float diff = phase_error(phase[1], phase[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, asinf(0.3f), diff);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, diff_at_4s, diff);
+    TEST_ASSERT_TRUE(nodes[0].stats.lost > 0);
+}
+
+void test_write_text(void) {
+    start_scripted(1);
+    queue_summary(2, 0, 0.9f, 1.0f, 10.0f, 0);
+    mesh_poll(&g_mesh, 1000);
+    mesh_broadcast(&g_mesh, 0.5f, 1.0f, 10.0f, 1000);
+
+    g_line_count = 0;
+    mesh_write_text(&g_mesh, 1000, collect_line, NULL);
+    TEST_ASSERT_EQUAL(3, g_line_count);
+    TEST_ASSERT_NOT_NULL(strstr(g_lines[0], "Mesh node 1: sent 1"));
+    TEST_ASSERT_NOT_NULL(strstr(g_lines[1], "node   2 r=0.900"));
+    TEST_ASSERT_NOT_NULL(strstr(g_lines[2], "from 1 peers"));
+
+    g_line_count = 0;
+    mesh_write_text(&g_mesh, 1000 + 2 * MESH_PEER_TIMEOUT_US, collect_line, NULL);
+    TEST_ASSERT_NOT_NULL(strstr(g_lines[1], "(silent)"));
+    TEST_ASSERT_EQUAL_STRING("  no peers heard", g_lines[2]);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    memset(&g_script, 0, sizeof(g_script));
+    memset(&g_mesh, 0, sizeof(g_mesh));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Packets
+    RUN_TEST(test_packet_round_trip);
+    RUN_TEST(test_packet_clamps_and_wraps);
+    RUN_TEST(test_decode_refuses_foreign_packets);
+
+    // Peers
+    RUN_TEST(test_poll_rejects_own_and_malformed);
+    RUN_TEST(test_sequence_gaps_count_as_lost);
+    RUN_TEST(test_duplicates_and_old_packets_rejected);
+    RUN_TEST(test_offset_keeps_shortest_delay);
+    RUN_TEST(test_latency_compensated_under_jitter);
+
+    // Field
+    RUN_TEST(test_field_combines_peers);
+    RUN_TEST(test_field_advances_with_time);
+    RUN_TEST(test_silent_peer_leaves_field);
+    RUN_TEST(test_slots_reused_after_silence);
+    RUN_TEST(test_returning_peer_starts_over);
+
+    // Node
+    RUN_TEST(test_broadcast_counts_failures);
+    RUN_TEST(test_ensembles_lock_through_hub);
+    RUN_TEST(test_write_text);
+
+    return UNITY_END();
+}
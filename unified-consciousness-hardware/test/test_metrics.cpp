@@ -0,0 +1,266 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for the metrics registry
+ *
+ * Tests validate:
+ * - Registry layout (kinds by range, unique names for every id)
+ * - Counter, gauge and histogram updates, and kind checks
+ * - Lock-free counting from two threads
+ * - Binary encoding (header, varints, float gauges, size bound)
+ * - Text export lines and cumulative buckets
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ucf_metrics.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+static std::vector<std::string> g_lines;
+
+static void collect_line(const char* line, void* ctx) {
+    g_lines.push_back(line);
+}
+
+static bool has_line(const char* line) {
+    for (const std::string& l : g_lines) {
+        if (l == line) return true;
+    }
+    return false;
+}
+
+static uint32_t get_varint(const uint8_t* in, size_t* pos) {
+    uint32_t v = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = in[(*pos)++];
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return v;
+}
+
+// ============================================================================
+// REGISTRY TESTS
+// ============================================================================
+
+void test_kinds_follow_ranges(void) {
+    TEST_ASSERT_EQUAL(METRIC_TYPE_COUNTER, metrics_type(METRIC_I2C_ERRORS));
+    TEST_ASSERT_EQUAL(METRIC_TYPE_COUNTER, metrics_type(METRIC_SESSION_DROPPED));
+    TEST_ASSERT_EQUAL(METRIC_TYPE_GAUGE, metrics_type(METRIC_LOOP_RATE_HZ));
+    TEST_ASSERT_EQUAL(METRIC_TYPE_GAUGE, metrics_type(METRIC_OTA_BYTES));
+    TEST_ASSERT_EQUAL(METRIC_TYPE_HISTOGRAM, metrics_type(METRIC_SENSOR_READ_US));
+}
+
+void test_every_metric_has_unique_name(void) {
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        const char* name = metrics_name((MetricId)i);
+        TEST_ASSERT_NOT_NULL(name);
+        TEST_ASSERT_GREATER_THAN(0, strlen(name));
+        for (int j = 0; j < i; j++) {
+            TEST_ASSERT_TRUE(strcmp(name, metrics_name((MetricId)j)) != 0);
+        }
+    }
+    TEST_ASSERT_EQUAL_STRING("unknown", metrics_name(METRIC_COUNT));
+}
+
+// ============================================================================
+// UPDATE TESTS
+// ============================================================================
+
+void test_counter_adds_and_mirrors(void) {
+    metrics_count(METRIC_I2C_ERRORS, 1);
+    metrics_count(METRIC_I2C_ERRORS, 2);
+    TEST_ASSERT_EQUAL(3, metrics_counter(METRIC_I2C_ERRORS));
+
+    metrics_set_total(METRIC_FRAMES_DROPPED, 41);
+    TEST_ASSERT_EQUAL(41, metrics_counter(METRIC_FRAMES_DROPPED));
+}
+
+void test_gauge_holds_latest(void) {
+    metrics_set(METRIC_ORDER_PARAM, 0.25f);
+    metrics_set(METRIC_ORDER_PARAM, 0.875f);
+    TEST_ASSERT_EQUAL_FLOAT(0.875f, metrics_gauge(METRIC_ORDER_PARAM));
+}
+
+void test_wrong_kind_is_ignored(void) {
+    metrics_count(METRIC_LOOP_RATE_HZ, 5);
+    metrics_set(METRIC_I2C_ERRORS, 9.0f);
+    metrics_observe(METRIC_I2C_ERRORS, 9);
+    metrics_count(METRIC_COUNT, 1);
+    metrics_observe(METRIC_COUNT, 1);
+
+    TEST_ASSERT_EQUAL(0, metrics_counter(METRIC_I2C_ERRORS));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, metrics_gauge(METRIC_LOOP_RATE_HZ));
+    MetricHistogram h;
+    TEST_ASSERT_FALSE(metrics_histogram(METRIC_I2C_ERRORS, &h));
+    TEST_ASSERT_FALSE(metrics_histogram(METRIC_COUNT, &h));
+}
+
+void test_histogram_buckets(void) {
+    TEST_ASSERT_EQUAL(0, metrics_bucket_index(0));
+    TEST_ASSERT_EQUAL(1, metrics_bucket_index(1));
+    TEST_ASSERT_EQUAL(2, metrics_bucket_index(3));
+    TEST_ASSERT_EQUAL(11, metrics_bucket_index(1500));
+    TEST_ASSERT_EQUAL(METRICS_HIST_BUCKETS - 1, metrics_bucket_index(16384));
+    TEST_ASSERT_EQUAL(METRICS_HIST_BUCKETS - 1, metrics_bucket_index(0xFFFFFFFFu));
+
+    for (uint32_t v = 0; v < 20000; v++) {
+        uint8_t b = metrics_bucket_index(v);
+        TEST_ASSERT_TRUE(v <= metrics_bucket_upper(b));
+        if (b > 0) {
+            TEST_ASSERT_TRUE(v > metrics_bucket_upper(b - 1));
+        }
+    }
+}
+
+void test_histogram_observe(void) {
+    metrics_observe(METRIC_SENSOR_READ_US, 1500);
+    metrics_observe(METRIC_SENSOR_READ_US, 1600);
+    metrics_observe(METRIC_SENSOR_READ_US, 3);
+
+    MetricHistogram h;
+    TEST_ASSERT_TRUE(metrics_histogram(METRIC_SENSOR_READ_US, &h));
+    TEST_ASSERT_EQUAL(3, h.count);
+    TEST_ASSERT_EQUAL(3103, h.sum);
+    TEST_ASSERT_EQUAL(2, h.buckets[11]);
+    TEST_ASSERT_EQUAL(1, h.buckets[2]);
+}
+
+void test_counting_from_two_threads(void) {
+    const uint32_t per_thread = 200000;
+    auto work = [&]() {
+        for (uint32_t i = 0; i < per_thread; i++) {
+            metrics_count(METRIC_K_FORMATIONS, 1);
+            metrics_observe(METRIC_SENSOR_READ_US, 7);
+        }
+    };
+    std::thread a(work), b(work);
+    a.join();
+    b.join();
+
+    TEST_ASSERT_EQUAL(2 * per_thread, metrics_counter(METRIC_K_FORMATIONS));
+    MetricHistogram h;
+    metrics_histogram(METRIC_SENSOR_READ_US, &h);
+    TEST_ASSERT_EQUAL(2 * per_thread, h.count);
+    TEST_ASSERT_EQUAL(2 * per_thread, h.buckets[3]);
+}
+
+// ============================================================================
+// EXPORT TESTS
+// ============================================================================
+
+void test_encode_round_trip(void) {
+    metrics_count(METRIC_I2C_ERRORS, 300);
+    metrics_set(METRIC_LOOP_RATE_HZ, 998.5f);
+    metrics_observe(METRIC_SENSOR_READ_US, 1500);
+
+    uint8_t buf[METRICS_MAX_ENCODED];
+    size_t len = metrics_encode(buf, sizeof(buf), 123456);
+    TEST_ASSERT_GREATER_THAN(METRICS_HEADER_SIZE, len);
+
+    TEST_ASSERT_EQUAL(METRICS_FORMAT_VERSION, buf[0]);
+    TEST_ASSERT_EQUAL(METRIC_COUNT, buf[1]);
+    uint32_t uptime = buf[2] | (buf[3] << 8) | (buf[4] << 16) | ((uint32_t)buf[5] << 24);
+    TEST_ASSERT_EQUAL(123456, uptime);
+
+    size_t pos = METRICS_HEADER_SIZE;
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        MetricId id = (MetricId)i;
+        switch (metrics_type(id)) {
+            case METRIC_TYPE_COUNTER:
+                TEST_ASSERT_EQUAL(metrics_counter(id), get_varint(buf, &pos));
+                break;
+            case METRIC_TYPE_GAUGE: {
+                float v;
+                memcpy(&v, &buf[pos], 4);
+                pos += 4;
+                TEST_ASSERT_EQUAL_FLOAT(metrics_gauge(id), v);
+                break;
+            }
+            case METRIC_TYPE_HISTOGRAM:
+                TEST_ASSERT_EQUAL(1, get_varint(buf, &pos));
+                TEST_ASSERT_EQUAL(1500, get_varint(buf, &pos));
+                for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+                    TEST_ASSERT_EQUAL(b == 11 ? 1 : 0, get_varint(buf, &pos));
+                }
+                break;
+        }
+    }
+    TEST_ASSERT_EQUAL(len, pos);
+}
+
+void test_encode_worst_case_fits(void) {
+    for (int i = 0; i < METRIC_FIRST_GAUGE; i++) {
+        metrics_set_total((MetricId)i, 0xFFFFFFFFu);
+    }
+    for (int i = 0; i < 1000; i++) {
+        metrics_observe(METRIC_SENSOR_READ_US, 0x7FFFFFFF);
+    }
+
+    uint8_t buf[METRICS_MAX_ENCODED];
+    TEST_ASSERT_GREATER_THAN(0, metrics_encode(buf, sizeof(buf), 0));
+    TEST_ASSERT_EQUAL(0, metrics_encode(buf, 20, 0));
+    TEST_ASSERT_EQUAL(0, metrics_encode(buf, 3, 0));
+}
+
+void test_text_export(void) {
+    metrics_count(METRIC_TRIAD_UNLOCKS, 2);
+    metrics_set(METRIC_SENSOR_RATE_HZ, 100.0f);
+    metrics_observe(METRIC_SENSOR_READ_US, 1);
+    metrics_observe(METRIC_SENSOR_READ_US, 5);
+
+    metrics_write_text(collect_line, NULL);
+
+    TEST_ASSERT_TRUE(has_line("triad_unlocks 2"));
+    TEST_ASSERT_TRUE(has_line("i2c_errors 0"));
+    TEST_ASSERT_TRUE(has_line("sensor_rate_hz 100.000"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_count 2"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_sum 6"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_bucket{le=\"1\"} 1"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_bucket{le=\"3\"} 1"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_bucket{le=\"7\"} 2"));
+    TEST_ASSERT_TRUE(has_line("sensor_read_us_bucket{le=\"+Inf\"} 2"));
+    TEST_ASSERT_FALSE(has_line("sensor_read_us_bucket{le=\"15\"} 2"));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    metrics_init();
+    g_lines.clear();
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Registry
+    RUN_TEST(test_kinds_follow_ranges);
+    RUN_TEST(test_every_metric_has_unique_name);
+
+    // Updates
+    RUN_TEST(test_counter_adds_and_mirrors);
+    RUN_TEST(test_gauge_holds_latest);
+    RUN_TEST(test_wrong_kind_is_ignored);
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_histogram_observe);
+    RUN_TEST(test_counting_from_two_threads);
+
+    // Export
+    RUN_TEST(test_encode_round_trip);
+    RUN_TEST(test_encode_worst_case_fits);
+    RUN_TEST(test_text_export);
+
+    return UNITY_END();
+}
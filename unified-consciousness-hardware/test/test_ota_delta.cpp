@@ -0,0 +1,305 @@
+/**
+ * @file test_ota_delta.cpp
+ * @brief Unit tests for the delta OTA patch decoder
+ *
+ * Tests validate:
+ * - Header encode/decode round trip
+ * - COPY / ADD / INSERT / SEEK semantics
+ * - Output independent of patch chunking (bounded-RAM streaming)
+ * - Rejection of out-of-range, malformed and truncated patches
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_ota_delta.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define OLD_SIZE    1024
+#define MAX_PATCH   2048
+#define MAX_OUTPUT  2048
+
+static uint8_t g_old[OLD_SIZE];
+static uint8_t g_patch[MAX_PATCH];
+static size_t g_patch_len;
+static uint8_t g_output[MAX_OUTPUT];
+static size_t g_output_len;
+static bool g_begin_called;
+static bool g_accept_base;
+
+static bool test_begin(const OTADeltaHeader* header, void* ctx) {
+    g_begin_called = true;
+    return g_accept_base;
+}
+
+static bool test_read_old(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    memcpy(buf, g_old + offset, len);
+    return true;
+}
+
+static bool test_write_new(const uint8_t* data, size_t len, void* ctx) {
+    if (g_output_len + len > MAX_OUTPUT) return false;
+    memcpy(g_output + g_output_len, data, len);
+    g_output_len += len;
+    return true;
+}
+
+static void patch_byte(uint8_t b) {
+    g_patch[g_patch_len++] = b;
+}
+
+static void patch_op(uint8_t op, uint32_t arg) {
+    patch_byte(op);
+    while (arg >= 0x80) {
+        patch_byte((uint8_t)(arg | 0x80));
+        arg >>= 7;
+    }
+    patch_byte((uint8_t)arg);
+}
+
+static void patch_seek(int32_t delta) {
+    patch_op(OTA_DELTA_OP_SEEK, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+}
+
+static void patch_header(uint32_t new_size) {
+    OTADeltaHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = OTA_DELTA_MAGIC;
+    header.version = OTA_DELTA_VERSION;
+    header.old_size = OLD_SIZE;
+    header.new_size = new_size;
+    g_patch_len = 0;
+    ota_delta_encode_header(&header, g_patch);
+    g_patch_len = OTA_DELTA_HEADER_SIZE;
+}
+
+static OTADeltaStatus apply(size_t chunk) {
+    OTADeltaIO io = { test_begin, test_read_old, test_write_new, NULL };
+    OTADeltaDecoder d;
+    ota_delta_init(&d, &io);
+    g_output_len = 0;
+
+    // Keep feeding after a verdict: trailing bytes must not be ignored
+    for (size_t off = 0; off < g_patch_len; off += chunk) {
+        size_t n = (g_patch_len - off < chunk) ? g_patch_len - off : chunk;
+        ota_delta_update(&d, g_patch + off, n);
+    }
+    return ota_delta_finish(&d);
+}
+
+/**
+ * @brief Patch exercising every operation; expected output in 'expected'
+ *
+ * new = old[0..600) with bytes 100..109 incremented, "HELLO",
+ *       old[900..1024), old[0..300)
+ */
+static size_t build_mixed_patch(uint8_t* expected) {
+    const uint32_t new_size = 600 + 5 + 124 + 300;
+    patch_header(new_size);
+
+    patch_op(OTA_DELTA_OP_COPY, 100);
+    patch_op(OTA_DELTA_OP_ADD, 10);
+    for (int i = 0; i < 10; i++) patch_byte(1);
+    patch_op(OTA_DELTA_OP_COPY, 490);
+    patch_op(OTA_DELTA_OP_INSERT, 5);
+    for (const char* p = "HELLO"; *p; p++) patch_byte((uint8_t)*p);
+    patch_seek(300);
+    patch_op(OTA_DELTA_OP_COPY, 124);
+    patch_seek(-OLD_SIZE);
+    patch_op(OTA_DELTA_OP_COPY, 300);
+    patch_byte(OTA_DELTA_OP_END);
+
+    memcpy(expected, g_old, 600);
+    for (int i = 100; i < 110; i++) expected[i]++;
+    memcpy(expected + 600, "HELLO", 5);
+    memcpy(expected + 605, g_old + 900, 124);
+    memcpy(expected + 729, g_old, 300);
+    return new_size;
+}
+
+// ============================================================================
+// HEADER TESTS
+// ============================================================================
+
+void test_header_round_trip(void) {
+    OTADeltaHeader in, out;
+    uint8_t buf[OTA_DELTA_HEADER_SIZE];
+
+    memset(&in, 0, sizeof(in));
+    in.magic = OTA_DELTA_MAGIC;
+    in.version = OTA_DELTA_VERSION;
+    in.old_size = 0x00012345;
+    in.new_size = 0x000FEDCB;
+    for (int i = 0; i < OTA_DELTA_DIGEST_SIZE; i++) {
+        in.old_sha256[i] = (uint8_t)i;
+        in.new_sha256[i] = (uint8_t)(0xFF - i);
+    }
+
+    ota_delta_encode_header(&in, buf);
+    TEST_ASSERT_TRUE(ota_delta_decode_header(buf, &out));
+    TEST_ASSERT_EQUAL_UINT32(in.old_size, out.old_size);
+    TEST_ASSERT_EQUAL_UINT32(in.new_size, out.new_size);
+    TEST_ASSERT_EQUAL_MEMORY(in.old_sha256, out.old_sha256, OTA_DELTA_DIGEST_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(in.new_sha256, out.new_sha256, OTA_DELTA_DIGEST_SIZE);
+}
+
+void test_bad_magic_rejected(void) {
+    patch_header(16);
+    g_patch[0] ^= 0xFF;
+    patch_byte(OTA_DELTA_OP_END);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_HEADER, apply(64));
+    TEST_ASSERT_FALSE(g_begin_called);
+}
+
+void test_base_rejected_by_callback(void) {
+    patch_header(16);
+    patch_op(OTA_DELTA_OP_COPY, 16);
+    patch_byte(OTA_DELTA_OP_END);
+    g_accept_base = false;
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_BASE, apply(64));
+    TEST_ASSERT_EQUAL(0, g_output_len);
+}
+
+// ============================================================================
+// DECODING TESTS
+// ============================================================================
+
+void test_mixed_operations(void) {
+    static uint8_t expected[MAX_OUTPUT];
+    size_t size = build_mixed_patch(expected);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_DONE, apply(4096));
+    TEST_ASSERT_TRUE(g_begin_called);
+    TEST_ASSERT_EQUAL(size, g_output_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, g_output, size);
+}
+
+void test_output_independent_of_chunking(void) {
+    static uint8_t expected[MAX_OUTPUT];
+    const size_t chunks[] = {1, 2, 3, 7, 80, 81, 255, 256, 257};
+    size_t size = build_mixed_patch(expected);
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        TEST_ASSERT_EQUAL(OTA_DELTA_DONE, apply(chunks[i]));
+        TEST_ASSERT_EQUAL(size, g_output_len);
+        TEST_ASSERT_EQUAL_MEMORY(expected, g_output, size);
+    }
+}
+
+// ============================================================================
+// ERROR TESTS
+// ============================================================================
+
+void test_copy_past_old_image_rejected(void) {
+    patch_header(OLD_SIZE + 1);
+    patch_op(OTA_DELTA_OP_COPY, OLD_SIZE + 1);
+    patch_byte(OTA_DELTA_OP_END);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_RANGE, apply(64));
+}
+
+void test_seek_before_start_rejected(void) {
+    patch_header(16);
+    patch_seek(-1);
+    patch_op(OTA_DELTA_OP_COPY, 16);
+    patch_byte(OTA_DELTA_OP_END);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_RANGE, apply(64));
+}
+
+void test_output_overflow_rejected(void) {
+    patch_header(8);
+    patch_op(OTA_DELTA_OP_INSERT, 9);
+    for (int i = 0; i < 9; i++) patch_byte(0xAA);
+    patch_byte(OTA_DELTA_OP_END);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_RANGE, apply(64));
+}
+
+void test_short_output_rejected(void) {
+    patch_header(32);
+    patch_op(OTA_DELTA_OP_COPY, 16);
+    patch_byte(OTA_DELTA_OP_END);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_RANGE, apply(64));
+}
+
+void test_unknown_opcode_rejected(void) {
+    patch_header(16);
+    patch_op(0x7F, 16);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, apply(64));
+}
+
+void test_oversized_varint_rejected(void) {
+    patch_header(16);
+    patch_byte(OTA_DELTA_OP_COPY);
+    for (int i = 0; i < 6; i++) patch_byte(0xFF);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, apply(64));
+}
+
+void test_data_after_end_rejected(void) {
+    patch_header(16);
+    patch_op(OTA_DELTA_OP_COPY, 16);
+    patch_byte(OTA_DELTA_OP_END);
+    patch_byte(0x00);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, apply(64));
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_FORMAT, apply(1));
+}
+
+void test_truncated_patch_rejected(void) {
+    patch_header(16);
+    patch_op(OTA_DELTA_OP_INSERT, 16);
+    for (int i = 0; i < 10; i++) patch_byte(0x55);
+
+    TEST_ASSERT_EQUAL(OTA_DELTA_ERR_TRUNCATED, apply(64));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    for (int i = 0; i < OLD_SIZE; i++) {
+        g_old[i] = (uint8_t)(i * 31 + 7);
+    }
+    g_patch_len = 0;
+    g_output_len = 0;
+    g_begin_called = false;
+    g_accept_base = true;
+}
+
+void tearDown(void) {
+    // Called after each test
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Header
+    RUN_TEST(test_header_round_trip);
+    RUN_TEST(test_bad_magic_rejected);
+    RUN_TEST(test_base_rejected_by_callback);
+
+    // Decoding
+    RUN_TEST(test_mixed_operations);
+    RUN_TEST(test_output_independent_of_chunking);
+
+    // Errors
+    RUN_TEST(test_copy_past_old_image_rejected);
+    RUN_TEST(test_seek_before_start_rejected);
+    RUN_TEST(test_output_overflow_rejected);
+    RUN_TEST(test_short_output_rejected);
+    RUN_TEST(test_unknown_opcode_rejected);
+    RUN_TEST(test_oversized_varint_rejected);
+    RUN_TEST(test_data_after_end_rejected);
+    RUN_TEST(test_truncated_patch_rejected);
+
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+/**
+ * @file test_ota_stream_verify.cpp
+ * @brief Unit tests for the streaming OTA image verifier
+ *
+ * Tests validate:
+ * - SHA-256 against published test vectors
+ * - Acceptance independent of chunk boundaries
+ * - Early rejection of bad headers and oversize images
+ * - Digest and lattice signature failures
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ucf_ota_verify.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define TEST_IMAGE_SIZE     4096
+#define TEST_SIG_OFFSET     1500
+
+static uint8_t g_image[TEST_IMAGE_SIZE];
+
+/**
+ * @brief Build a synthetic ESP application image
+ *
+ * Layout: ESP header (hash_appended=1), pseudo-random payload with the
+ * lattice signature block embedded, SHA-256 of the preceding bytes.
+ */
+static void build_image(bool with_signature) {
+    srand(1234);
+    for (uint32_t i = 0; i < TEST_IMAGE_SIZE; i++) {
+        g_image[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    g_image[0] = OTA_ESP_IMAGE_MAGIC;
+    g_image[OTA_ESP_HASH_APPENDED_OFFSET] = 1;
+
+    if (with_signature) {
+        memcpy(g_image + TEST_SIG_OFFSET, ota_verify_get_signature(), sizeof(OTALatticeSignature));
+    }
+
+    OTASha256 sha;
+    ota_sha256_init(&sha);
+    ota_sha256_update(&sha, g_image, TEST_IMAGE_SIZE - OTA_SHA256_SIZE);
+    ota_sha256_final(&sha, g_image + TEST_IMAGE_SIZE - OTA_SHA256_SIZE);
+}
+
+/**
+ * @brief Feed the image in chunks of the given size
+ */
+static OTAVerifyStatus feed_image(OTAStreamVerifier* v, size_t chunk) {
+    OTAVerifyStatus status = OTA_VERIFY_PENDING;
+    for (size_t off = 0; off < TEST_IMAGE_SIZE && status == OTA_VERIFY_PENDING; off += chunk) {
+        size_t n = (TEST_IMAGE_SIZE - off < chunk) ? TEST_IMAGE_SIZE - off : chunk;
+        status = ota_verify_update(v, g_image + off, n);
+    }
+    return status;
+}
+
+// ============================================================================
+// SHA-256 TESTS
+// ============================================================================
+
+void test_sha256_abc_vector(void) {
+    static const uint8_t expected[32] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+    OTASha256 sha;
+    uint8_t digest[32];
+
+    ota_sha256_init(&sha);
+    ota_sha256_update(&sha, (const uint8_t*)"abc", 3);
+    ota_sha256_final(&sha, digest);
+
+    TEST_ASSERT_EQUAL_MEMORY(expected, digest, 32);
+}
+
+void test_sha256_two_block_vector(void) {
+    static const char* msg = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    static const uint8_t expected[32] = {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+    };
+    OTASha256 sha;
+    uint8_t digest[32];
+
+    // Feed one byte at a time to exercise the partial-block path
+    ota_sha256_init(&sha);
+    for (size_t i = 0; i < strlen(msg); i++) {
+        ota_sha256_update(&sha, (const uint8_t*)msg + i, 1);
+    }
+    ota_sha256_final(&sha, digest);
+
+    TEST_ASSERT_EQUAL_MEMORY(expected, digest, 32);
+}
+
+// ============================================================================
+// STREAMING VERIFICATION TESTS
+// ============================================================================
+
+void test_valid_image_accepted_for_any_chunking(void) {
+    const size_t chunks[] = {1, 7, 32, 33, 64, 1000, TEST_IMAGE_SIZE};
+    build_image(true);
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        OTAStreamVerifier v;
+        ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE | OTA_VERIFY_FLAG_REQUIRE_SHA);
+        TEST_ASSERT_EQUAL(OTA_VERIFY_ACCEPTED, feed_image(&v, chunks[i]));
+        TEST_ASSERT_EQUAL_UINT32(TEST_SIG_OFFSET, v.signature_offset);
+    }
+}
+
+void test_decision_available_on_last_byte(void) {
+    OTAStreamVerifier v;
+    build_image(true);
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_PENDING, ota_verify_update(&v, g_image, TEST_IMAGE_SIZE - 1));
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ACCEPTED, ota_verify_update(&v, g_image + TEST_IMAGE_SIZE - 1, 1));
+}
+
+void test_unknown_size_requires_finish(void) {
+    OTAStreamVerifier v;
+    build_image(true);
+    ota_verify_init(&v, 0, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_PENDING, feed_image(&v, 256));
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ACCEPTED, ota_verify_finish(&v));
+}
+
+void test_corrupted_payload_rejected(void) {
+    OTAStreamVerifier v;
+    build_image(true);
+    g_image[3000] ^= 0x01;
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_DIGEST, feed_image(&v, 128));
+}
+
+void test_missing_signature_rejected(void) {
+    OTAStreamVerifier v;
+    build_image(false);
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_LATTICE, feed_image(&v, 128));
+}
+
+void test_modified_constant_rejected(void) {
+    OTAStreamVerifier v;
+    OTALatticeSignature sig = *ota_verify_get_signature();
+    sig.z_critical = 0.866;  // Truncated THE LENS
+
+    build_image(false);
+    memcpy(g_image + TEST_SIG_OFFSET, &sig, sizeof(sig));
+
+    OTASha256 sha;
+    ota_sha256_init(&sha);
+    ota_sha256_update(&sha, g_image, TEST_IMAGE_SIZE - OTA_SHA256_SIZE);
+    ota_sha256_final(&sha, g_image + TEST_IMAGE_SIZE - OTA_SHA256_SIZE);
+
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE);
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_LATTICE, feed_image(&v, 128));
+
+    LatticeValidation validation;
+    ota_verify_get_validation(&v, &validation);
+    TEST_ASSERT_FALSE(validation.valid);
+    TEST_ASSERT_FALSE(validation.z_critical_valid);
+    TEST_ASSERT_TRUE(validation.phi_inv_valid);
+}
+
+void test_bad_header_rejected_immediately(void) {
+    OTAStreamVerifier v;
+    build_image(true);
+    g_image[0] = 0x00;
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_HEADER, ota_verify_update(&v, g_image, 16));
+}
+
+void test_oversize_rejected(void) {
+    OTAStreamVerifier v;
+    build_image(true);
+    ota_verify_init(&v, TEST_IMAGE_SIZE - 100, OTA_VERIFY_FLAG_ESP_IMAGE);
+
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_SIZE, feed_image(&v, 512));
+}
+
+void test_external_digest(void) {
+    OTAStreamVerifier v;
+    uint8_t digest[32];
+    build_image(true);
+
+    OTASha256 sha;
+    ota_sha256_init(&sha);
+    ota_sha256_update(&sha, g_image, TEST_IMAGE_SIZE);
+    ota_sha256_final(&sha, digest);
+
+    // Plain image (no ESP header semantics), manifest digest over everything
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_REQUIRE_SHA);
+    ota_verify_set_expected_sha256(&v, digest);
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ACCEPTED, feed_image(&v, 100));
+
+    digest[0] ^= 0xFF;
+    ota_verify_init(&v, TEST_IMAGE_SIZE, OTA_VERIFY_FLAG_REQUIRE_SHA);
+    ota_verify_set_expected_sha256(&v, digest);
+    TEST_ASSERT_EQUAL(OTA_VERIFY_ERR_DIGEST, feed_image(&v, 100));
+}
+
+void test_crc_matches_reference(void) {
+    OTAStreamVerifier v;
+    LatticeValidation validation;
+    static const uint8_t check[] = "123456789";
+
+    ota_verify_init(&v, 0, 0);
+    ota_verify_update(&v, check, 9);
+    ota_verify_finish(&v);
+    ota_verify_get_validation(&v, &validation);
+
+    // Standard CRC-32 check value
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, validation.firmware_checksum);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    // Called before each test
+}
+
+void tearDown(void) {
+    // Called after each test
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // SHA-256
+    RUN_TEST(test_sha256_abc_vector);
+    RUN_TEST(test_sha256_two_block_vector);
+
+    // Streaming verification
+    RUN_TEST(test_valid_image_accepted_for_any_chunking);
+    RUN_TEST(test_decision_available_on_last_byte);
+    RUN_TEST(test_unknown_size_requires_finish);
+    RUN_TEST(test_corrupted_payload_rejected);
+    RUN_TEST(test_missing_signature_rejected);
+    RUN_TEST(test_modified_constant_rejected);
+    RUN_TEST(test_bad_header_rejected_immediately);
+    RUN_TEST(test_oversize_rejected);
+    RUN_TEST(test_external_digest);
+    RUN_TEST(test_crc_matches_reference);
+
+    return UNITY_END();
+}
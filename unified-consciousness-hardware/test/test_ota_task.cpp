@@ -0,0 +1,281 @@
+/**
+ * @file test_ota_task.cpp
+ * @brief Unit tests for the background OTA transfer scheduler
+ *
+ * Tests use an in-memory stand-in transport and a virtual clock in which
+ * every sink write costs a fixed amount of time (simulated flash program).
+ *
+ * Tests validate:
+ * - Complete, byte-exact transfers
+ * - Bandwidth, slice and duty-cycle budgets
+ * - Pause/resume
+ * - Starved transports, sink and transport failures
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_ota_task.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define PAYLOAD_SIZE    8000
+
+static uint32_t g_clock_us;
+static uint32_t g_write_cost_us;
+
+static uint8_t g_payload[PAYLOAD_SIZE];
+static uint32_t g_read_pos;
+static uint32_t g_available;        // Bytes the stand-in "network" has delivered
+static bool g_transport_fail;
+static bool g_transport_closed;
+
+static uint8_t g_received[PAYLOAD_SIZE];
+static uint32_t g_received_len;
+static OTAStatus g_sink_fail_status;
+static uint32_t g_sink_fail_at;
+static bool g_sink_ended;
+
+static OTATask g_task;
+
+static uint32_t virtual_clock(void) {
+    return g_clock_us;
+}
+
+static bool mem_open(OTATransferInfo* info, void* ctx) {
+    info->size = PAYLOAD_SIZE;
+    return true;
+}
+
+static int32_t mem_read(uint8_t* buf, size_t max_len, void* ctx) {
+    if (g_transport_fail) return OTA_TRANSPORT_ERROR;
+    if (g_read_pos == PAYLOAD_SIZE) return OTA_TRANSPORT_EOF;
+
+    uint32_t n = g_available - g_read_pos;
+    if (n > max_len) n = (uint32_t)max_len;
+    memcpy(buf, g_payload + g_read_pos, n);
+    g_read_pos += n;
+    return (int32_t)n;
+}
+
+static void mem_close(void* ctx) {
+    g_transport_closed = true;
+}
+
+static bool sink_begin(const OTATransferInfo* info, void* ctx) {
+    return true;
+}
+
+static OTAStatus sink_write(const uint8_t* data, size_t len, void* ctx) {
+    g_clock_us += g_write_cost_us;
+    if (g_sink_fail_at && g_received_len + len >= g_sink_fail_at) {
+        return g_sink_fail_status;
+    }
+    memcpy(g_received + g_received_len, data, len);
+    g_received_len += (uint32_t)len;
+    return OTA_STATUS_DOWNLOADING;
+}
+
+static OTAStatus sink_end(void* ctx) {
+    g_sink_ended = true;
+    return (g_received_len == PAYLOAD_SIZE) ? OTA_STATUS_APPLYING : OTA_STATUS_ERROR_SIZE;
+}
+
+static const OTATransport g_transport = { mem_open, mem_read, mem_close, NULL };
+static const OTASink g_sink = { sink_begin, sink_write, sink_end, NULL };
+
+static void start(uint16_t chunk, uint32_t bps, uint32_t slice_us, uint8_t duty) {
+    OTATaskConfig config = { chunk, bps, slice_us, duty };
+    ota_task_init(&g_task, &config, virtual_clock);
+    TEST_ASSERT_TRUE(ota_task_start(&g_task, &g_transport, &g_sink));
+}
+
+/**
+ * @brief Drive the task like its RTOS loop would, sleeping as instructed
+ * @return Virtual time taken
+ */
+static uint32_t run_to_completion(uint32_t max_steps) {
+    uint32_t t0 = g_clock_us;
+    for (uint32_t i = 0; i < max_steps && ota_task_get_state(&g_task) == OTA_TASK_RUNNING; i++) {
+        uint32_t wait = ota_task_step(&g_task);
+        g_clock_us += (wait > 0) ? wait : 1;
+    }
+    return g_clock_us - t0;
+}
+
+// ============================================================================
+// TRANSFER TESTS
+// ============================================================================
+
+void test_transfer_completes_exactly(void) {
+    start(512, 0, 1000, 100);
+
+    run_to_completion(10000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL(OTA_STATUS_APPLYING, g_task.result);
+    TEST_ASSERT_EQUAL_UINT32(PAYLOAD_SIZE, g_received_len);
+    TEST_ASSERT_EQUAL_MEMORY(g_payload, g_received, PAYLOAD_SIZE);
+    TEST_ASSERT_TRUE(g_transport_closed);
+}
+
+void test_bandwidth_budget(void) {
+    // 8000 bytes at 16000 B/s must take about half a second
+    start(256, 16000, 1000, 100);
+
+    uint32_t elapsed = run_to_completion(100000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    TEST_ASSERT_UINT32_WITHIN(25000, 500000, elapsed);
+}
+
+void test_slice_budget(void) {
+    // Each write costs 150 us; a 400 us slice fits at most three writes
+    g_write_cost_us = 150;
+    start(128, 0, 400, 100);
+
+    run_to_completion(10000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    TEST_ASSERT_TRUE(g_task.stats.max_slice_us <= 400 + 150);
+}
+
+void test_duty_cycle_budget(void) {
+    g_write_cost_us = 100;
+    start(128, 0, 300, 20);
+
+    uint32_t elapsed = run_to_completion(100000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    // Busy share must not exceed the 20% budget (small allowance for rounding)
+    TEST_ASSERT_TRUE(g_task.stats.busy_us * 100 <= (uint64_t)elapsed * 21);
+}
+
+// ============================================================================
+// PAUSE / RESUME TESTS
+// ============================================================================
+
+void test_pause_and_resume(void) {
+    g_write_cost_us = 200;
+    start(512, 0, 600, 100);
+    ota_task_step(&g_task);
+    uint32_t before = g_received_len;
+    TEST_ASSERT_TRUE(before > 0 && before < PAYLOAD_SIZE);
+
+    ota_task_pause(&g_task);
+    for (int i = 0; i < 50; i++) {
+        TEST_ASSERT_EQUAL_UINT32(OTA_TASK_POLL_US, ota_task_step(&g_task));
+        g_clock_us += OTA_TASK_POLL_US;
+    }
+    TEST_ASSERT_EQUAL(OTA_TASK_PAUSED, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL_UINT32(before, g_received_len);
+
+    ota_task_resume(&g_task);
+    run_to_completion(10000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL_MEMORY(g_payload, g_received, PAYLOAD_SIZE);
+}
+
+void test_no_burst_after_pause(void) {
+    start(256, 10000, 1000, 100);
+    ota_task_pause(&g_task);
+    g_clock_us += 5000000;
+    ota_task_resume(&g_task);
+
+    ota_task_step(&g_task);
+
+    // Five paused seconds earn no credit
+    TEST_ASSERT_EQUAL_UINT32(0, g_received_len);
+}
+
+// ============================================================================
+// FAILURE TESTS
+// ============================================================================
+
+void test_starved_transport_waits(void) {
+    g_available = 1000;
+    start(512, 0, 1000, 100);
+
+    run_to_completion(100);
+    TEST_ASSERT_EQUAL(OTA_TASK_RUNNING, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL_UINT32(1000, g_received_len);
+    g_clock_us += OTA_TASK_STARVED_US;
+    TEST_ASSERT_EQUAL_UINT32(OTA_TASK_STARVED_US, ota_task_step(&g_task));
+
+    g_available = PAYLOAD_SIZE;
+    run_to_completion(10000);
+    TEST_ASSERT_EQUAL(OTA_TASK_DONE, ota_task_get_state(&g_task));
+    TEST_ASSERT_TRUE(g_task.stats.starved > 0);
+}
+
+void test_sink_error_fails_transfer(void) {
+    g_sink_fail_at = 3000;
+    g_sink_fail_status = OTA_STATUS_ERROR_LATTICE;
+    start(512, 0, 1000, 100);
+
+    run_to_completion(10000);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_FAILED, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL(OTA_STATUS_ERROR_LATTICE, g_task.result);
+    TEST_ASSERT_TRUE(g_transport_closed);
+}
+
+void test_transport_error_closes_sink(void) {
+    g_write_cost_us = 200;
+    start(512, 0, 600, 100);
+    ota_task_step(&g_task);
+    g_clock_us += 100000;
+    g_transport_fail = true;
+
+    run_to_completion(10);
+
+    TEST_ASSERT_EQUAL(OTA_TASK_FAILED, ota_task_get_state(&g_task));
+    TEST_ASSERT_EQUAL(OTA_STATUS_ERROR_NETWORK, g_task.result);
+    TEST_ASSERT_TRUE(g_sink_ended);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    for (uint32_t i = 0; i < PAYLOAD_SIZE; i++) {
+        g_payload[i] = (uint8_t)(i * 131 + (i >> 8));
+    }
+    g_clock_us = 1000;
+    g_write_cost_us = 20;
+    g_read_pos = 0;
+    g_available = PAYLOAD_SIZE;
+    g_transport_fail = false;
+    g_transport_closed = false;
+    g_received_len = 0;
+    g_sink_fail_at = 0;
+    g_sink_ended = false;
+}
+
+void tearDown(void) {
+    // Called after each test
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Transfers and budgets
+    RUN_TEST(test_transfer_completes_exactly);
+    RUN_TEST(test_bandwidth_budget);
+    RUN_TEST(test_slice_budget);
+    RUN_TEST(test_duty_cycle_budget);
+
+    // Pause / resume
+    RUN_TEST(test_pause_and_resume);
+    RUN_TEST(test_no_burst_after_pause);
+
+    // Failures
+    RUN_TEST(test_starved_transport_waits);
+    RUN_TEST(test_sink_error_fails_transfer);
+    RUN_TEST(test_transport_error_closes_sink);
+
+    return UNITY_END();
+}
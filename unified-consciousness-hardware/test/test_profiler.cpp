@@ -0,0 +1,213 @@
+/**
+ * @file test_profiler.cpp
+ * @brief Unit tests for the module profiler
+ *
+ * Tests validate:
+ * - Histogram bucket mapping and bounds across the 32-bit range
+ * - Exact min/mean/max and bucket-resolution percentiles
+ * - Tick-to-nanosecond conversion and reset
+ * - PROF_SCOPE recording the enclosing scope
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <thread>
+#include "ucf_profiler.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define TEST_TICKS_PER_US   240     // ESP32 at 240 MHz
+
+static void record_range(ProfProbe probe, uint32_t from, uint32_t to) {
+    for (uint32_t t = from; t <= to; t++) {
+        prof_record(probe, t);
+    }
+}
+
+// ============================================================================
+// BUCKET TESTS
+// ============================================================================
+
+void test_small_durations_are_exact(void) {
+    for (uint32_t t = 0; t < 8; t++) {
+        TEST_ASSERT_EQUAL(t, prof_bucket_index(t));
+        TEST_ASSERT_EQUAL(t, prof_bucket_upper(prof_bucket_index(t)));
+    }
+}
+
+void test_buckets_are_monotonic_and_cover_range(void) {
+    uint8_t last = 0;
+    for (uint32_t t = 1; t < 100000; t++) {
+        uint8_t b = prof_bucket_index(t);
+        TEST_ASSERT_TRUE(b >= last);
+        TEST_ASSERT_TRUE(t <= prof_bucket_upper(b));
+        if (b > 0) {
+            TEST_ASSERT_TRUE(t > prof_bucket_upper(b - 1));
+        }
+        last = b;
+    }
+    TEST_ASSERT_EQUAL(PROF_BUCKETS - 1, prof_bucket_index(0xFFFFFFFFu));
+    TEST_ASSERT_EQUAL(0xFFFFFFFFu, prof_bucket_upper(PROF_BUCKETS - 1));
+}
+
+void test_bucket_width_is_quarter_octave(void) {
+    // 1000 lies in [896, 1023]: octave 512, sub-bucket width 128
+    uint8_t b = prof_bucket_index(1000);
+    TEST_ASSERT_EQUAL(1023, prof_bucket_upper(b));
+    TEST_ASSERT_EQUAL(895, prof_bucket_upper(b - 1));
+}
+
+// ============================================================================
+// SUMMARY TESTS
+// ============================================================================
+
+void test_empty_probe_has_no_summary(void) {
+    ProfSummary s;
+    TEST_ASSERT_FALSE(prof_get(PROF_KURAMOTO_STEP, &s));
+    TEST_ASSERT_EQUAL(0, s.count);
+    TEST_ASSERT_EQUAL(0, prof_percentile(PROF_KURAMOTO_STEP, 99.0f));
+}
+
+void test_summary_exact_fields(void) {
+    prof_init(1);
+    prof_record(PROF_READ_FIELD, 100);
+    prof_record(PROF_READ_FIELD, 300);
+    prof_record(PROF_READ_FIELD, 200);
+
+    ProfSummary s;
+    TEST_ASSERT_TRUE(prof_get(PROF_READ_FIELD, &s));
+    TEST_ASSERT_EQUAL(3, s.count);
+    TEST_ASSERT_EQUAL(100000, s.min_ns);
+    TEST_ASSERT_EQUAL(200000, s.mean_ns);
+    TEST_ASSERT_EQUAL(300000, s.max_ns);
+}
+
+void test_percentiles_within_bucket_resolution(void) {
+    prof_init(1000);
+    record_range(PROF_K_FORMATION, 1, 1000);
+
+    ProfSummary s;
+    prof_get(PROF_K_FORMATION, &s);
+    // True p50 = 500, p99 = 990; estimates are bucket upper bounds
+    TEST_ASSERT_TRUE(s.p50_ns >= 500 && s.p50_ns <= 500 * 5 / 4);
+    TEST_ASSERT_TRUE(s.p99_ns >= 990 && s.p99_ns <= 1000);
+    TEST_ASSERT_TRUE(s.p99_ns <= s.max_ns);
+}
+
+void test_percentile_clamped_to_samples(void) {
+    prof_init(1000);
+    // One value in the middle of a wide bucket
+    prof_record(PROF_LEDS_UPDATE, 5000);
+    TEST_ASSERT_EQUAL(5000, prof_percentile(PROF_LEDS_UPDATE, 50.0f));
+    TEST_ASSERT_EQUAL(5000, prof_percentile(PROF_LEDS_UPDATE, 99.0f));
+}
+
+void test_outlier_shows_in_max_not_p99(void) {
+    prof_init(1000);
+    for (int i = 0; i < 1000; i++) {
+        prof_record(PROF_KURAMOTO_STEP, 100);
+    }
+    prof_record(PROF_KURAMOTO_STEP, 1000000);
+
+    ProfSummary s;
+    prof_get(PROF_KURAMOTO_STEP, &s);
+    TEST_ASSERT_TRUE(s.p99_ns >= 100 && s.p99_ns <= 100 * 5 / 4);
+    TEST_ASSERT_EQUAL(1000000, s.max_ns);
+}
+
+void test_ticks_convert_to_nanoseconds(void) {
+    prof_init(TEST_TICKS_PER_US);
+    prof_record(PROF_SIGIL_MATCH, 240);
+    prof_record(PROF_SIGIL_MATCH, 480);
+
+    ProfSummary s;
+    prof_get(PROF_SIGIL_MATCH, &s);
+    TEST_ASSERT_EQUAL(1000, s.min_ns);
+    TEST_ASSERT_EQUAL(1500, s.mean_ns);
+    TEST_ASSERT_EQUAL(2000, s.max_ns);
+}
+
+void test_reset_clears_all_probes(void) {
+    for (int p = 0; p < PROF_PROBE_COUNT; p++) {
+        prof_record((ProfProbe)p, 10);
+    }
+    prof_reset();
+
+    ProfSummary s;
+    for (int p = 0; p < PROF_PROBE_COUNT; p++) {
+        TEST_ASSERT_FALSE(prof_get((ProfProbe)p, &s));
+    }
+}
+
+void test_probe_names(void) {
+    TEST_ASSERT_EQUAL_STRING("kuramoto", prof_probe_name(PROF_KURAMOTO_STEP));
+    TEST_ASSERT_EQUAL_STRING("unknown", prof_probe_name(PROF_PROBE_COUNT));
+    prof_record(PROF_PROBE_COUNT, 10);     // Ignored
+}
+
+// ============================================================================
+// SCOPE TESTS
+// ============================================================================
+
+void test_scope_records_enclosing_block(void) {
+    prof_init(PROF_HOST_TICKS_PER_US);
+    {
+        PROF_SCOPE(PROF_PHASE_UPDATE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    ProfSummary s;
+    TEST_ASSERT_TRUE(prof_get(PROF_PHASE_UPDATE, &s));
+    TEST_ASSERT_EQUAL(1, s.count);
+    TEST_ASSERT_TRUE(s.min_ns >= 2000000);
+    TEST_ASSERT_TRUE(s.max_ns < 500000000);
+}
+
+void test_two_scopes_in_one_block(void) {
+    prof_init(PROF_HOST_TICKS_PER_US);
+    {
+        PROF_SCOPE(PROF_SENSORS_UPDATE);
+        PROF_SCOPE(PROF_EMANATION_UPDATE);
+    }
+    ProfSummary s;
+    TEST_ASSERT_TRUE(prof_get(PROF_SENSORS_UPDATE, &s));
+    TEST_ASSERT_TRUE(prof_get(PROF_EMANATION_UPDATE, &s));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    prof_init(PROF_HOST_TICKS_PER_US);
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Buckets
+    RUN_TEST(test_small_durations_are_exact);
+    RUN_TEST(test_buckets_are_monotonic_and_cover_range);
+    RUN_TEST(test_bucket_width_is_quarter_octave);
+
+    // Summaries
+    RUN_TEST(test_empty_probe_has_no_summary);
+    RUN_TEST(test_summary_exact_fields);
+    RUN_TEST(test_percentiles_within_bucket_resolution);
+    RUN_TEST(test_percentile_clamped_to_samples);
+    RUN_TEST(test_outlier_shows_in_max_not_p99);
+    RUN_TEST(test_ticks_convert_to_nanoseconds);
+    RUN_TEST(test_reset_clears_all_probes);
+    RUN_TEST(test_probe_names);
+
+    // Scopes
+    RUN_TEST(test_scope_records_enclosing_block);
+    RUN_TEST(test_two_scopes_in_one_block);
+
+    return UNITY_END();
+}
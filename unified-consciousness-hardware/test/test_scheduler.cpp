@@ -0,0 +1,370 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief Unit tests for the cooperative loop scheduler
+ *
+ * Everything runs on the virtual clock: a task's cost is the time it
+ * advances the clock by.
+ *
+ * Tests validate:
+ * - Fixed release grid, priorities and deadline tie-breaks
+ * - Deadline misses, budget overruns, jitter and the catch-up cap
+ * - Enable/disable and idle time
+ * - Run hook event order
+ * - The main_v4 real-time table meets the 1 kHz Kuramoto deadline of one
+ *   period; merged on one core at full budget, the misses are counted
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_scheduler.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define MAX_TRACE   64
+
+typedef struct {
+    char id;
+    uint32_t cost_us;
+    uint32_t runs;
+} FakeTask;
+
+static Scheduler g_sched;
+static char g_trace[MAX_TRACE + 1];
+static uint8_t g_trace_len;
+
+static void fake_task(uint32_t now_us, void* ctx) {
+    FakeTask* f = (FakeTask*)ctx;
+    f->runs++;
+    if (g_trace_len < MAX_TRACE) {
+        g_trace[g_trace_len++] = f->id;
+        g_trace[g_trace_len] = '\0';
+    }
+    sched_virtual_advance(f->cost_us);
+}
+
+static int add_task(FakeTask* f, uint32_t period, uint32_t budget, uint8_t priority) {
+    SchedTaskConfig c;
+    memset(&c, 0, sizeof(c));
+    c.name = "fake";
+    c.fn = fake_task;
+    c.ctx = f;
+    c.period_us = period;
+    c.budget_us = budget;
+    c.priority = priority;
+    return sched_add(&g_sched, &c);
+}
+
+// ============================================================================
+// SCHEDULING TESTS
+// ============================================================================
+
+void test_releases_follow_fixed_grid(void) {
+    FakeTask a = { 'a', 300, 0 };
+    int id = add_task(&a, 1000, 0, 1);
+    TEST_ASSERT_EQUAL(0, id);
+
+    sched_run_virtual(&g_sched, 10000);
+
+    // Costs do not push later releases back
+    TEST_ASSERT_EQUAL(10, a.runs);
+    const SchedTask* t = sched_get_task(&g_sched, id);
+    TEST_ASSERT_EQUAL(10000, t->release_us);
+    TEST_ASSERT_EQUAL(0, t->stats.max_jitter_us);
+}
+
+void test_higher_priority_runs_first(void) {
+    FakeTask lo = { 'l', 100, 0 }, hi = { 'h', 100, 0 }, mid = { 'm', 100, 0 };
+    add_task(&lo, 1000, 0, 1);
+    add_task(&hi, 1000, 0, 9);
+    add_task(&mid, 1000, 0, 5);
+
+    TEST_ASSERT_EQUAL(3, sched_run(&g_sched));
+    TEST_ASSERT_EQUAL_STRING("hml", g_trace);
+}
+
+void test_earliest_deadline_breaks_ties(void) {
+    FakeTask slow = { 's', 10, 0 }, fast = { 'f', 10, 0 };
+    add_task(&slow, 10000, 0, 3);
+    add_task(&fast, 1000, 0, 3);
+
+    sched_run(&g_sched);
+    TEST_ASSERT_EQUAL_STRING("fs", g_trace);
+}
+
+void test_overrunning_task_does_not_monopolize(void) {
+    // Longer than its period: its missed releases are dropped, not queued
+    FakeTask hog = { 'h', 2000, 0 }, other = { 'o', 10, 0 };
+    add_task(&hog, 1000, 0, 9);
+    add_task(&other, 1000, 0, 1);
+
+    TEST_ASSERT_EQUAL(2, sched_run(&g_sched));
+    TEST_ASSERT_EQUAL_STRING("ho", g_trace);
+}
+
+void test_urgent_release_preempts_rest_of_pass(void) {
+    FakeTask fast = { 'f', 100, 0 }, a = { 'a', 1200, 0 }, b = { 'b', 500, 0 };
+    add_task(&fast, 1000, 0, 9);
+    add_task(&a, 10000, 0, 2);
+    add_task(&b, 10000, 0, 1);
+
+    // fast is released again at 1000, while a is running
+    TEST_ASSERT_EQUAL(4, sched_run(&g_sched));
+    TEST_ASSERT_EQUAL_STRING("fafb", g_trace);
+}
+
+void test_overload_returns_to_loop(void) {
+    FakeTask a = { 'a', 900, 0 }, b = { 'b', 900, 0 };
+    SchedTaskConfig c = { "a", fake_task, &a, 1000, 0, 0, 0, 2, 5 };
+    sched_add(&g_sched, &c);
+    c.ctx = &b;
+    c.priority = 1;
+    sched_add(&g_sched, &c);
+
+    TEST_ASSERT_EQUAL(SCHED_MAX_DISPATCH, sched_run(&g_sched));
+}
+
+void test_deadline_miss_and_jitter(void) {
+    FakeTask fast = { 'f', 100, 0 }, blocker = { 'b', 2500, 0 };
+    int f = add_task(&fast, 1000, 0, 9);
+    add_task(&blocker, 5000, 0, 1);
+
+    sched_run_virtual(&g_sched, 5000);
+
+    // The 1000 release waits behind the 2.5 ms blocker; 2000 is dropped
+    const SchedTaskStats* st = &sched_get_task(&g_sched, f)->stats;
+    TEST_ASSERT_EQUAL(1, st->misses);
+    TEST_ASSERT_EQUAL(1600, st->max_jitter_us);
+    TEST_ASSERT_EQUAL(1, st->skipped);
+}
+
+void test_budget_overrun_counted(void) {
+    FakeTask a = { 'a', 600, 0 };
+    int id = add_task(&a, 1000, 500, 1);
+
+    sched_run_virtual(&g_sched, 3000);
+
+    const SchedTaskStats* st = &sched_get_task(&g_sched, id)->stats;
+    TEST_ASSERT_EQUAL(3, st->overruns);
+    TEST_ASSERT_EQUAL(0, st->misses);
+    TEST_ASSERT_EQUAL(600, st->max_exec_us);
+}
+
+void test_catchup_cap(void) {
+    FakeTask a = { 'a', 10, 0 };
+    SchedTaskConfig c;
+    memset(&c, 0, sizeof(c));
+    c.name = "catchup";
+    c.fn = fake_task;
+    c.ctx = &a;
+    c.period_us = 1000;
+    c.max_catchup = 2;
+    int id = sched_add(&g_sched, &c);
+
+    // Stall for ten periods
+    sched_virtual_advance(10500);
+    sched_run(&g_sched);
+    sched_run(&g_sched);
+    sched_run(&g_sched);
+    sched_run(&g_sched);
+
+    // One late run plus two kept releases back to back; the rest dropped
+    const SchedTask* t = sched_get_task(&g_sched, id);
+    TEST_ASSERT_EQUAL(3, a.runs);
+    TEST_ASSERT_EQUAL(8, t->stats.skipped);
+    TEST_ASSERT_EQUAL(11000, t->release_us);
+}
+
+void test_disable_and_idle_time(void) {
+    FakeTask a = { 'a', 0, 0 }, b = { 'b', 0, 0 };
+    int ia = add_task(&a, 1000, 0, 1);
+    int ib = add_task(&b, 4000, 0, 1);
+
+    sched_run(&g_sched);
+    TEST_ASSERT_EQUAL(1000, sched_idle_us(&g_sched));
+
+    sched_enable(&g_sched, ia, false);
+    TEST_ASSERT_EQUAL(4000, sched_idle_us(&g_sched));
+
+    sched_run_virtual(&g_sched, 8000);
+    TEST_ASSERT_EQUAL(1, a.runs);
+    TEST_ASSERT_EQUAL(2, b.runs);
+
+    sched_enable(&g_sched, ia, true);
+    TEST_ASSERT_EQUAL(0, sched_idle_us(&g_sched));
+    sched_enable(&g_sched, ib, false);
+    sched_enable(&g_sched, ia, false);
+    TEST_ASSERT_EQUAL(0, sched_idle_us(&g_sched));
+}
+
+void test_load_percent(void) {
+    FakeTask a = { 'a', 250, 0 };
+    add_task(&a, 1000, 0, 1);
+
+    sched_run_virtual(&g_sched, 100000);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 25.0f, sched_load_percent(&g_sched));
+
+    sched_reset_stats(&g_sched);
+    TEST_ASSERT_EQUAL(0, sched_get_task(&g_sched, 0)->stats.runs);
+}
+
+void test_rejects_invalid_tasks(void) {
+    FakeTask a = { 'a', 0, 0 };
+    TEST_ASSERT_EQUAL(-1, add_task(&a, 0, 0, 1));
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        TEST_ASSERT_EQUAL(i, add_task(&a, 1000, 0, 1));
+    }
+    TEST_ASSERT_EQUAL(-1, add_task(&a, 1000, 0, 1));
+}
+
+// ============================================================================
+// LOAD TESTS
+// ============================================================================
+
+void test_v4_rt_table_meets_kuramoto_period(void) {
+    // main_v4 RT_TASKS on their own core, the sensor update reading through
+    // the bus worker: every other run fits in the period minus Kuramoto's
+    // budget, so a release never waits past its one-period deadline
+    static FakeTask costs[4] = {
+        { 'k', 200, 0 }, { 's', 800, 0 }, { 'c', 500, 0 }, { 'o', 100, 0 },
+    };
+    const SchedTaskConfig table[4] = {
+        { "kuramoto",   fake_task, &costs[0], 1000,    0,    200,  0,       7, 0 },
+        { "sensors",    fake_task, &costs[1], 10000,   0,    4000, 0,       6, 0 },
+        { "commands",   fake_task, &costs[2], 20000,   0,    500,  12500,   4, 0 },
+        { "outputs",    fake_task, &costs[3], 1000,    0,    100,  0,       0, 0 },
+    };
+    for (int i = 0; i < 4; i++) {
+        sched_add(&g_sched, &table[i]);
+    }
+
+    sched_run_virtual(&g_sched, 10000000);
+
+    const SchedTaskStats* kur = &sched_get_task(&g_sched, 0)->stats;
+    TEST_ASSERT_EQUAL(10000, kur->runs);
+    TEST_ASSERT_EQUAL(0, kur->misses);
+    TEST_ASSERT_EQUAL(0, kur->skipped);
+    TEST_ASSERT_LESS_OR_EQUAL(800, kur->max_jitter_us);
+}
+
+void test_v4_table_at_full_budget_reports_kuramoto_misses(void) {
+    // main_v4 RT_TASKS + IO_TASKS on one core (the fallback when the
+    // partition cannot start), every run costing its whole budget (~95% load).
+    // A 4 ms sensor read (bus worker not running) holds Kuramoto past its
+    // 1 ms deadline; the misses are counted, not hidden by a wider deadline.
+    static FakeTask costs[9] = {
+        { 'k', 200, 0 }, { 's', 4000, 0 }, { 'm', 500, 0 }, { 'l', 1500, 0 },
+        { 'c', 500, 0 }, { 'v', 1000, 0 }, { 'p', 2000, 0 }, { 'x', 500, 0 },
+        { 'n', 500, 0 },
+    };
+    const SchedTaskConfig table[9] = {
+        { "kuramoto",   fake_task, &costs[0], 1000,    0,    200,  0,       7, 0 },
+        { "sensors",    fake_task, &costs[1], 10000,   0,    4000, 0,       6, 0 },
+        { "commands",   fake_task, &costs[2], 20000,   0,    500,  12500,   4, 0 },
+        { "leds",       fake_task, &costs[3], 16667,   0,    1500, 5000,    5, 0 },
+        { "console",    fake_task, &costs[4], 20000,   0,    500,  7500,    4, 0 },
+        { "services",   fake_task, &costs[5], 5000,    0,    1000, 2500,    3, 0 },
+        { "status",     fake_task, &costs[6], 1000000, 0,    2000, 0,       2, 0 },
+        { "validation", fake_task, &costs[7], 5000000, 0,    500,  0,       1, 0 },
+        { "snapshot",   fake_task, &costs[8], 300000,  0,    500,  300000,  0, 0 },
+    };
+    for (int i = 0; i < 9; i++) {
+        sched_add(&g_sched, &table[i]);
+    }
+
+    sched_run_virtual(&g_sched, 10000000);
+
+    const SchedTaskStats* kur = &sched_get_task(&g_sched, 0)->stats;
+    const SchedTaskStats* sen = &sched_get_task(&g_sched, 1)->stats;
+    TEST_ASSERT_GREATER_THAN(0, kur->misses);
+    TEST_ASSERT_EQUAL(10000, kur->runs + kur->skipped);
+    TEST_ASSERT_EQUAL(0, sen->misses);
+    TEST_ASSERT_EQUAL(0, sen->skipped);
+    TEST_ASSERT_EQUAL(1000, sen->runs);
+    TEST_ASSERT_LESS_OR_EQUAL(5000, kur->max_jitter_us);
+    TEST_ASSERT_EQUAL(0, kur->overruns);
+}
+
+void test_long_task_breaks_kuramoto_deadline(void) {
+    FakeTask kur = { 'k', 200, 0 }, slow = { 's', 6000, 0 };
+    SchedTaskConfig c = { "kuramoto", fake_task, &kur, 1000, 5000, 200, 0, 7, 0 };
+    int k = sched_add(&g_sched, &c);
+    add_task(&slow, 100000, 4000, 1);
+
+    sched_run_virtual(&g_sched, 1000000);
+
+    TEST_ASSERT_GREATER_THAN(0, sched_get_task(&g_sched, k)->stats.misses);
+    TEST_ASSERT_EQUAL(10, sched_get_task(&g_sched, 1)->stats.overruns);
+}
+
+// ============================================================================
+// RUN HOOK TESTS
+// ============================================================================
+
+static void trace_hook(const Scheduler* s, const SchedTask* task, SchedHookEvent event) {
+    static const char MARKS[] = { '<', '>', '|' };
+    if (g_trace_len < MAX_TRACE) {
+        g_trace[g_trace_len++] = MARKS[event];
+        g_trace[g_trace_len] = '\0';
+    }
+    if (event != SCHED_HOOK_PASS) {
+        TEST_ASSERT_EQUAL_PTR(&g_sched.tasks[0], task);
+    } else {
+        TEST_ASSERT_NULL(task);
+    }
+}
+
+void test_hook_sees_runs_and_passes(void) {
+    FakeTask a = { 'a', 100, 0 };
+    add_task(&a, 1000, 0, 1);
+
+    sched_set_hook(trace_hook);
+    sched_run(&g_sched);
+    sched_run(&g_sched);
+    sched_set_hook(NULL);
+    sched_run(&g_sched);
+
+    // Begin, body, end, pass; then an idle pass; nothing once removed
+    TEST_ASSERT_EQUAL_STRING("<a>||", g_trace);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    sched_virtual_set(0);
+    sched_init(&g_sched, sched_virtual_clock);
+    g_trace[0] = '\0';
+    g_trace_len = 0;
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Scheduling
+    RUN_TEST(test_releases_follow_fixed_grid);
+    RUN_TEST(test_higher_priority_runs_first);
+    RUN_TEST(test_earliest_deadline_breaks_ties);
+    RUN_TEST(test_overrunning_task_does_not_monopolize);
+    RUN_TEST(test_urgent_release_preempts_rest_of_pass);
+    RUN_TEST(test_overload_returns_to_loop);
+    RUN_TEST(test_deadline_miss_and_jitter);
+    RUN_TEST(test_budget_overrun_counted);
+    RUN_TEST(test_catchup_cap);
+    RUN_TEST(test_disable_and_idle_time);
+    RUN_TEST(test_load_percent);
+    RUN_TEST(test_rejects_invalid_tasks);
+    RUN_TEST(test_hook_sees_runs_and_passes);
+
+    // Load
+    RUN_TEST(test_v4_rt_table_meets_kuramoto_period);
+    RUN_TEST(test_v4_table_at_full_budget_reports_kuramoto_misses);
+    RUN_TEST(test_long_task_breaks_kuramoto_deadline);
+
+    return UNITY_END();
+}
@@ -0,0 +1,383 @@
+/**
+ * @file test_session_log.cpp
+ * @brief Unit tests for the session recorder
+ *
+ * Tests run against the file backend, wrapped to check flash access
+ * patterns and to inject torn writes. A "reboot" is a fresh
+ * session_log_init() on the same file.
+ *
+ * Tests validate:
+ * - Record round trips through compression and the reader
+ * - Frame decimation and immediate change events
+ * - Page-sized, rate-limited flash operations
+ * - Sessions and sequence numbers across reboots
+ * - Ring wrap-around, torn blocks and writer overrun
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "ucf_session_log.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define LOG_PATH        "test_session_log.bin"
+#define SECTOR_SIZE     4096
+#define SECTOR_COUNT    4
+#define VALUE_TOLERANCE (0.51f / SESSION_LOG_VALUE_SCALE)
+
+static StorageFile g_file;
+static StorageBackend g_file_backend;
+static StorageBackend g_backend;
+
+static uint32_t g_ops;
+static uint32_t g_max_write;
+static bool g_crossed_page;
+static int32_t g_fail_after;        // Bytes to program before failing (-1 = never)
+
+static SessionLogReader g_reader;
+static uint32_t g_now;
+
+static bool checked_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    return g_file_backend.read(addr, buf, len, g_file_backend.ctx);
+}
+
+static bool checked_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    g_ops++;
+    if (len > g_max_write) {
+        g_max_write = (uint32_t)len;
+    }
+    if (addr / SESSION_LOG_PAGE_SIZE != (addr + len - 1) / SESSION_LOG_PAGE_SIZE) {
+        g_crossed_page = true;
+    }
+    if (g_fail_after >= 0) {
+        size_t n = ((size_t)g_fail_after < len) ? (size_t)g_fail_after : len;
+        g_fail_after -= (int32_t)n;
+        if (n < len) {
+            g_file_backend.write(addr, data, n, g_file_backend.ctx);
+            g_fail_after = 0;
+            return false;
+        }
+    }
+    return g_file_backend.write(addr, data, len, g_file_backend.ctx);
+}
+
+static bool checked_erase(uint16_t sector, void* ctx) {
+    g_ops++;
+    return g_file_backend.erase(sector, g_file_backend.ctx);
+}
+
+static void reboot(void) {
+    TEST_ASSERT_TRUE(session_log_init(&g_backend));
+}
+
+static SessionFrame make_frame(float z) {
+    SessionFrame f;
+    memset(&f, 0, sizeof(f));
+    f.z = z;
+    f.r = 0.5f + z * 0.25f;
+    f.kappa = z * 0.9f;
+    f.eta = 1.0f - z;
+    f.phase = (z < 0.618f) ? 0 : (z < 0.866f) ? 1 : 2;
+    f.active_sensors = 7;
+    return f;
+}
+
+/**
+ * @brief Feed frames every 10 ms, ticking the writer as loop() would
+ */
+static void run_for(uint32_t ms, float z0, float dz_per_s) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        float z = z0 + dz_per_s * (float)t / 1000.0f;
+        SessionFrame f = make_frame(z - floorf(z));
+        session_log_frame(g_now, &f);
+        session_log_tick(g_now);
+        g_now += 10;
+    }
+}
+
+/**
+ * @brief Read the whole log, counting records of one type (0 = all)
+ */
+static uint32_t count_records(uint8_t type) {
+    SessionLogRecord rec;
+    uint32_t n = 0;
+    if (!session_log_reader_open(&g_reader, &g_backend)) {
+        return 0;
+    }
+    while (session_log_reader_next(&g_reader, &rec)) {
+        if (type == 0 || rec.type == type) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// ============================================================================
+// ROUND TRIP TESTS
+// ============================================================================
+
+void test_empty_log_has_no_blocks(void) {
+    TEST_ASSERT_FALSE(session_log_reader_open(&g_reader, &g_backend));
+    TEST_ASSERT_EQUAL_UINT16(1, session_log_get_stats()->session);
+}
+
+void test_frames_round_trip(void) {
+    SessionFrame f = make_frame(0.3f);
+    f.triad_state = 2;
+    f.triad_crossings = 1;
+    session_log_frame(1000, &f);
+    f.z = 0.31f;
+    f.r = 0.77f;
+    session_log_frame(1200, &f);
+    TEST_ASSERT_TRUE(session_log_flush());
+
+    SessionLogRecord rec;
+    TEST_ASSERT_TRUE(session_log_reader_open(&g_reader, &g_backend));
+
+    const uint8_t expected[] = {SESSION_REC_START, SESSION_REC_PHASE, SESSION_REC_TRIAD,
+                                SESSION_REC_KFORMATION, SESSION_REC_FRAME, SESSION_REC_FRAME};
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        TEST_ASSERT_TRUE(session_log_reader_next(&g_reader, &rec));
+        TEST_ASSERT_EQUAL_UINT8(expected[i], rec.type);
+        TEST_ASSERT_EQUAL_UINT16(1, rec.session);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1200, rec.time_ms);
+    TEST_ASSERT_FLOAT_WITHIN(VALUE_TOLERANCE, 0.31f, rec.state.z);
+    TEST_ASSERT_FLOAT_WITHIN(VALUE_TOLERANCE, 0.77f, rec.state.r);
+    TEST_ASSERT_FLOAT_WITHIN(VALUE_TOLERANCE, 0.3f * 0.9f, rec.state.kappa);
+    TEST_ASSERT_EQUAL_UINT8(2, rec.state.triad_state);
+    TEST_ASSERT_EQUAL_UINT8(1, rec.state.triad_crossings);
+    TEST_ASSERT_EQUAL_UINT8(7, rec.state.active_sensors);
+    TEST_ASSERT_FALSE(session_log_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.corrupt);
+}
+
+void test_smooth_session_compresses(void) {
+    run_for(120000, 0.2f, 0.01f);
+    TEST_ASSERT_TRUE(session_log_flush());
+
+    const SessionLogStats* stats = session_log_get_stats();
+    TEST_ASSERT_TRUE(stats->blocks >= 2);
+    TEST_ASSERT_TRUE(stats->flash_bytes < stats->raw_bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->dropped);
+    TEST_ASSERT_EQUAL_UINT32(stats->records, count_records(0));
+    TEST_ASSERT_EQUAL_UINT32(120000 / SESSION_LOG_FRAME_INTERVAL_MS, count_records(SESSION_REC_FRAME));
+}
+
+// ============================================================================
+// RECORDING POLICY TESTS
+// ============================================================================
+
+void test_frames_are_decimated(void) {
+    run_for(1000, 0.2f, 0.0f);
+
+    const SessionLogStats* stats = session_log_get_stats();
+    TEST_ASSERT_EQUAL_UINT32(1000 / SESSION_LOG_FRAME_INTERVAL_MS, stats->records - 4);
+    TEST_ASSERT_EQUAL_UINT32(100 - 1000 / SESSION_LOG_FRAME_INTERVAL_MS, stats->frames_skipped);
+}
+
+void test_events_recorded_between_frames(void) {
+    SessionFrame f = make_frame(0.5f);
+    session_log_frame(0, &f);
+
+    f = make_frame(0.7f);           // PARADOX, inside the decimation window
+    session_log_frame(10, &f);
+    f.k_formation = true;
+    session_log_frame(20, &f);
+    TEST_ASSERT_TRUE(session_log_flush());
+
+    SessionLogRecord rec;
+    bool saw_phase = false;
+    bool saw_kformation = false;
+    TEST_ASSERT_TRUE(session_log_reader_open(&g_reader, &g_backend));
+    while (session_log_reader_next(&g_reader, &rec)) {
+        if (rec.type == SESSION_REC_PHASE && rec.time_ms == 10) {
+            TEST_ASSERT_EQUAL_UINT8(0, rec.phase_from);
+            TEST_ASSERT_EQUAL_UINT8(1, rec.state.phase);
+            TEST_ASSERT_FLOAT_WITHIN(VALUE_TOLERANCE, 0.7f, rec.state.z);
+            saw_phase = true;
+        }
+        if (rec.type == SESSION_REC_KFORMATION && rec.time_ms == 20) {
+            TEST_ASSERT_TRUE(rec.state.k_formation);
+            saw_kformation = true;
+        }
+    }
+    TEST_ASSERT_TRUE(saw_phase);
+    TEST_ASSERT_TRUE(saw_kformation);
+}
+
+void test_flash_operations_are_paged_and_rate_limited(void) {
+    // One block aged past the seal deadline without any ticks
+    for (uint32_t t = 0; t <= SESSION_LOG_SEAL_MS; t += SESSION_LOG_FRAME_INTERVAL_MS) {
+        SessionFrame f = make_frame((float)((t * 7919) % 1000) / 1000.0f);
+        session_log_frame(t, &f);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, g_ops);
+
+    // Seal plus one operation (the sector erase), then nothing until the interval passes
+    g_now = SESSION_LOG_SEAL_MS;
+    session_log_tick(g_now);
+    TEST_ASSERT_EQUAL_UINT32(1, g_ops);
+    for (uint32_t i = 1; i < SESSION_LOG_OP_INTERVAL_MS; i++) {
+        session_log_tick(g_now + i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, g_ops);
+
+    // Drain the sealed block: at most one operation per interval
+    const SessionLogStats* stats = session_log_get_stats();
+    for (int i = 0; i < 100; i++) {
+        uint32_t ops = g_ops;
+        g_now += SESSION_LOG_OP_INTERVAL_MS;
+        session_log_tick(g_now);
+        TEST_ASSERT_TRUE(g_ops - ops <= 1);
+    }
+
+    // Second block is still open (younger than the seal deadline)
+    TEST_ASSERT_TRUE(session_log_flush());
+    TEST_ASSERT_TRUE(g_max_write <= SESSION_LOG_PAGE_SIZE);
+    TEST_ASSERT_FALSE(g_crossed_page);
+    TEST_ASSERT_EQUAL_UINT32(stats->records, count_records(0));
+}
+
+// ============================================================================
+// PERSISTENCE TESTS
+// ============================================================================
+
+void test_sessions_continue_across_reboots(void) {
+    run_for(2000, 0.2f, 0.1f);
+    TEST_ASSERT_TRUE(session_log_flush());
+    uint32_t next_seq = session_log_get_stats()->next_seq;
+
+    reboot();
+    TEST_ASSERT_EQUAL_UINT16(2, session_log_get_stats()->session);
+    TEST_ASSERT_EQUAL_UINT32(next_seq, session_log_get_stats()->next_seq);
+    run_for(2000, 0.5f, 0.1f);
+    TEST_ASSERT_TRUE(session_log_flush());
+
+    SessionLogRecord rec;
+    uint16_t last_session = 0;
+    uint32_t starts = 0;
+    TEST_ASSERT_TRUE(session_log_reader_open(&g_reader, &g_backend));
+    while (session_log_reader_next(&g_reader, &rec)) {
+        TEST_ASSERT_TRUE(rec.session >= last_session);
+        last_session = rec.session;
+        starts += (rec.type == SESSION_REC_START);
+    }
+    TEST_ASSERT_EQUAL_UINT16(2, last_session);
+    TEST_ASSERT_EQUAL_UINT32(2, starts);
+
+    // Second session appended to the same sector without an erase
+    TEST_ASSERT_EQUAL_UINT32(0, session_log_get_stats()->erases);
+}
+
+void test_ring_wraps_and_keeps_newest(void) {
+    // Noisy data so each sector holds only a few blocks
+    for (int i = 0; i < 40; i++) {
+        run_for(SESSION_LOG_SEAL_MS, (float)i * 0.37f, 1.7f);
+    }
+    TEST_ASSERT_TRUE(session_log_flush());
+    TEST_ASSERT_TRUE(session_log_get_stats()->erases > SECTOR_COUNT);
+
+    SessionLogRecord rec;
+    uint32_t last_seq = 0;
+    uint32_t last_time = 0;
+    uint32_t first_time = UINT32_MAX;
+    TEST_ASSERT_TRUE(session_log_reader_open(&g_reader, &g_backend));
+    while (session_log_reader_next(&g_reader, &rec)) {
+        TEST_ASSERT_TRUE(rec.seq >= last_seq);
+        TEST_ASSERT_TRUE(rec.time_ms >= last_time);
+        last_seq = rec.seq;
+        last_time = rec.time_ms;
+        if (first_time == UINT32_MAX) first_time = rec.time_ms;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(session_log_get_stats()->next_seq - 1, last_seq);
+    TEST_ASSERT_TRUE(first_time > 0);              // Oldest data overwritten
+    TEST_ASSERT_TRUE(last_time >= g_now - SESSION_LOG_FRAME_INTERVAL_MS - 10);
+}
+
+void test_torn_block_is_skipped_after_reboot(void) {
+    run_for(5000, 0.2f, 0.1f);
+    TEST_ASSERT_TRUE(session_log_flush());
+    uint32_t frames = count_records(SESSION_REC_FRAME);
+
+    // Power loss part way through the next block
+    run_for(5000, 0.6f, 0.1f);
+    g_fail_after = 100;
+    session_log_flush();
+    g_fail_after = -1;
+
+    reboot();
+    run_for(1000, 0.3f, 0.0f);
+    TEST_ASSERT_TRUE(session_log_flush());
+
+    // First session intact, torn block lost, new session readable
+    uint32_t after = count_records(SESSION_REC_FRAME);
+    TEST_ASSERT_EQUAL_UINT32(frames + 1000 / SESSION_LOG_FRAME_INTERVAL_MS, after);
+    TEST_ASSERT_EQUAL_UINT32(1, g_reader.corrupt);
+}
+
+void test_overrun_drops_records_without_corruption(void) {
+    // No ticks: the writer never drains, so the second full block has nowhere to go
+    SessionFrame f;
+    for (uint32_t i = 0; i < 3000; i++) {
+        f = make_frame((float)((i * 7919) % 1000) / 1000.0f);
+        session_log_frame(i * SESSION_LOG_FRAME_INTERVAL_MS, &f);
+    }
+    TEST_ASSERT_TRUE(session_log_get_stats()->dropped > 0);
+
+    TEST_ASSERT_TRUE(session_log_flush());
+    count_records(SESSION_REC_FRAME);
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(session_log_get_stats()->blocks, g_reader.blocks);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    remove(LOG_PATH);
+    TEST_ASSERT_TRUE(storage_file_open(&g_file, LOG_PATH, SECTOR_SIZE, SECTOR_COUNT, &g_file_backend));
+    g_backend = g_file_backend;
+    g_backend.read = checked_read;
+    g_backend.write = checked_write;
+    g_backend.erase = checked_erase;
+    g_ops = 0;
+    g_max_write = 0;
+    g_crossed_page = false;
+    g_fail_after = -1;
+    g_now = 0;
+    reboot();
+}
+
+void tearDown(void) {
+    storage_file_close(&g_file);
+    remove(LOG_PATH);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round trips
+    RUN_TEST(test_empty_log_has_no_blocks);
+    RUN_TEST(test_frames_round_trip);
+    RUN_TEST(test_smooth_session_compresses);
+
+    // Recording policy
+    RUN_TEST(test_frames_are_decimated);
+    RUN_TEST(test_events_recorded_between_frames);
+    RUN_TEST(test_flash_operations_are_paged_and_rate_limited);
+
+    // Persistence
+    RUN_TEST(test_sessions_continue_across_reboots);
+    RUN_TEST(test_ring_wraps_and_keeps_newest);
+    RUN_TEST(test_torn_block_is_skipped_after_reboot);
+    RUN_TEST(test_overrun_drops_records_without_corruption);
+
+    return UNITY_END();
+}
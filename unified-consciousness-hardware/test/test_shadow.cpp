@@ -0,0 +1,192 @@
+/**
+ * @file test_shadow.cpp
+ * @brief Unit tests for the output shadow registers
+ *
+ * Tests validate:
+ * - Binding writes the initial value at once (or waits when unknown)
+ * - A flush writes only the outputs whose value changed
+ * - Sets within one tick coalesce into one write of the last value
+ * - Invalidation forces a rewrite of an unchanged value
+ * - Totals: requested, written and avoided
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_shadow.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define MAX_WRITES 16
+
+typedef struct {
+    uint32_t values[MAX_WRITES];
+    size_t count;
+} WriteLog;
+
+static WriteLog g_digipot;
+static WriteLog g_led;
+
+static void record_write(uint32_t value, void* ctx) {
+    WriteLog* log = (WriteLog*)ctx;
+    if (log->count < MAX_WRITES) {
+        log->values[log->count] = value;
+    }
+    log->count++;
+}
+
+// ============================================================================
+// BIND TESTS
+// ============================================================================
+
+void test_bind_writes_initial_value(void) {
+    shadow_bind(SHADOW_LED_TRIAD, record_write, &g_led, 0);
+    TEST_ASSERT_EQUAL(1, g_led.count);
+    TEST_ASSERT_EQUAL(0, g_led.values[0]);
+
+    // Already on the hardware
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+    TEST_ASSERT_EQUAL(0, shadow_get(SHADOW_LED_TRIAD));
+}
+
+void test_bind_unknown_waits_for_set(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, SHADOW_UNKNOWN);
+    TEST_ASSERT_EQUAL(0, g_digipot.count);
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+
+    shadow_set(SHADOW_DIGIPOT, 77);
+    TEST_ASSERT_EQUAL(1, shadow_flush());
+    TEST_ASSERT_EQUAL(1, g_digipot.count);
+    TEST_ASSERT_EQUAL(77, g_digipot.values[0]);
+}
+
+void test_unbound_output_never_written(void) {
+    shadow_set(SHADOW_LED_TRUE, 1);
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+    TEST_ASSERT_EQUAL(1, shadow_get(SHADOW_LED_TRUE));
+}
+
+// ============================================================================
+// FLUSH TESTS
+// ============================================================================
+
+void test_unchanged_value_not_written(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, SHADOW_UNKNOWN);
+    for (int tick = 0; tick < 1000; tick++) {
+        shadow_set(SHADOW_DIGIPOT, 64);
+        shadow_flush();
+    }
+    TEST_ASSERT_EQUAL(1, g_digipot.count);
+}
+
+void test_changes_written_once_each(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, SHADOW_UNKNOWN);
+    shadow_bind(SHADOW_LED_K_FORMATION, record_write, &g_led, 0);
+    g_led.count = 0;
+
+    shadow_set(SHADOW_DIGIPOT, 10);
+    shadow_set(SHADOW_LED_K_FORMATION, 1);
+    TEST_ASSERT_EQUAL(2, shadow_flush());
+    shadow_set(SHADOW_DIGIPOT, 10);
+    shadow_set(SHADOW_LED_K_FORMATION, 0);
+    TEST_ASSERT_EQUAL(1, shadow_flush());
+
+    TEST_ASSERT_EQUAL(1, g_digipot.count);
+    TEST_ASSERT_EQUAL(2, g_led.count);
+    TEST_ASSERT_EQUAL(1, g_led.values[0]);
+    TEST_ASSERT_EQUAL(0, g_led.values[1]);
+}
+
+void test_sets_coalesce_within_tick(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, SHADOW_UNKNOWN);
+    shadow_set(SHADOW_DIGIPOT, 1);
+    shadow_set(SHADOW_DIGIPOT, 2);
+    shadow_set(SHADOW_DIGIPOT, 3);
+    TEST_ASSERT_EQUAL(1, shadow_flush());
+    TEST_ASSERT_EQUAL(1, g_digipot.count);
+    TEST_ASSERT_EQUAL(3, g_digipot.values[0]);
+
+    // A change undone before the flush costs nothing
+    shadow_set(SHADOW_DIGIPOT, 4);
+    shadow_set(SHADOW_DIGIPOT, 3);
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+}
+
+void test_invalidate_forces_rewrite(void) {
+    shadow_bind(SHADOW_LED_UNTRUE, record_write, &g_led, 1);
+    shadow_invalidate(SHADOW_LED_UNTRUE);
+    TEST_ASSERT_EQUAL(1, shadow_flush());
+    TEST_ASSERT_EQUAL(2, g_led.count);
+    TEST_ASSERT_EQUAL(1, g_led.values[1]);
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+}
+
+void test_invalid_arguments_ignored(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, 5);
+    shadow_set(SHADOW_DIGIPOT, SHADOW_UNKNOWN);
+    shadow_set((ShadowId)SHADOW_COUNT, 1);
+    TEST_ASSERT_EQUAL(5, shadow_get(SHADOW_DIGIPOT));
+    TEST_ASSERT_EQUAL(SHADOW_UNKNOWN, shadow_get((ShadowId)SHADOW_COUNT));
+    TEST_ASSERT_EQUAL(0, shadow_flush());
+}
+
+// ============================================================================
+// STATS TESTS
+// ============================================================================
+
+void test_stats_count_avoided_writes(void) {
+    shadow_bind(SHADOW_DIGIPOT, record_write, &g_digipot, SHADOW_UNKNOWN);
+    shadow_bind(SHADOW_LED_PARADOX, record_write, &g_led, 0);
+    for (int tick = 0; tick < 100; tick++) {
+        shadow_set(SHADOW_DIGIPOT, tick < 50 ? 20 : 21);
+        shadow_set(SHADOW_LED_PARADOX, 0);
+        shadow_flush();
+    }
+
+    ShadowStats stats;
+    shadow_get_stats(&stats);
+    TEST_ASSERT_EQUAL(200, stats.requested);
+    TEST_ASSERT_EQUAL(2, stats.written);         // Bind writes are not counted
+    TEST_ASSERT_EQUAL(198, stats.avoided);
+
+    shadow_init();
+    shadow_get_stats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.requested);
+    TEST_ASSERT_EQUAL(0, stats.written);
+    TEST_ASSERT_EQUAL(0, stats.avoided);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    shadow_init();
+    memset(&g_digipot, 0, sizeof(g_digipot));
+    memset(&g_led, 0, sizeof(g_led));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Bind
+    RUN_TEST(test_bind_writes_initial_value);
+    RUN_TEST(test_bind_unknown_waits_for_set);
+    RUN_TEST(test_unbound_output_never_written);
+
+    // Flush
+    RUN_TEST(test_unchanged_value_not_written);
+    RUN_TEST(test_changes_written_once_each);
+    RUN_TEST(test_sets_coalesce_within_tick);
+    RUN_TEST(test_invalidate_forces_rewrite);
+    RUN_TEST(test_invalid_arguments_ignored);
+
+    // Stats
+    RUN_TEST(test_stats_count_avoided_writes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,424 @@
+/**
+ * @file test_storage.cpp
+ * @brief Unit tests for the persistent storage manager
+ *
+ * Tests run against the file backend, wrapped to count operations and to
+ * inject torn writes. A "reboot" is a fresh storage_init() on the same file.
+ *
+ * Tests validate:
+ * - Region registration, versioning and round trips across reboots
+ * - A blank store is formatted once, after the backend's before_format()
+ * - Lazy, coalesced commits
+ * - Atomic records (torn writes, interrupted compaction)
+ * - Wear levelling across sectors, erase counts kept across reboots
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "ucf_storage.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define STORE_PATH      "test_storage.bin"
+#define SECTOR_SIZE     512
+#define SECTOR_COUNT    4
+
+static StorageFile g_file;
+static StorageBackend g_file_backend;
+static StorageBackend g_backend;
+
+static uint32_t g_writes;
+static uint32_t g_erases;
+static uint32_t g_formats;
+static int32_t g_fail_after;        // Bytes to program before failing (-1 = never)
+
+static bool counting_read(uint32_t addr, void* buf, size_t len, void* ctx) {
+    return g_file_backend.read(addr, buf, len, g_file_backend.ctx);
+}
+
+static bool counting_write(uint32_t addr, const void* data, size_t len, void* ctx) {
+    g_writes++;
+    if (g_fail_after >= 0) {
+        // Power loss: program only part of the data
+        size_t n = ((size_t)g_fail_after < len) ? (size_t)g_fail_after : len;
+        g_fail_after -= (int32_t)n;
+        if (n < len) {
+            g_file_backend.write(addr, data, n, g_file_backend.ctx);
+            g_fail_after = 0;
+            return false;
+        }
+    }
+    return g_file_backend.write(addr, data, len, g_file_backend.ctx);
+}
+
+static bool counting_erase(uint16_t sector, void* ctx) {
+    g_erases++;
+    return g_file_backend.erase(sector, g_file_backend.ctx);
+}
+
+static void counting_before_format(void* ctx) {
+    // Nothing erased yet: the backend can still read what it held
+    g_formats++;
+    TEST_ASSERT_EQUAL(0, g_erases);
+}
+
+static void reboot(void) {
+    storage_file_close(&g_file);
+    TEST_ASSERT_TRUE(storage_file_open(&g_file, STORE_PATH, SECTOR_SIZE, SECTOR_COUNT, &g_file_backend));
+    g_backend = g_file_backend;
+    g_backend.read = counting_read;
+    g_backend.write = counting_write;
+    g_backend.erase = counting_erase;
+    g_backend.before_format = counting_before_format;
+    g_fail_after = -1;
+    TEST_ASSERT_TRUE(storage_init(&g_backend));
+}
+
+typedef struct {
+    uint32_t magic;
+    float values[4];
+} TestRecord;
+
+static TestRecord make_record(uint32_t magic) {
+    TestRecord rec;
+    rec.magic = magic;
+    for (int i = 0; i < 4; i++) {
+        rec.values[i] = magic * 0.5f + i;
+    }
+    return rec;
+}
+
+// ============================================================================
+// REGION TESTS
+// ============================================================================
+
+void test_empty_store_reports_not_found(void) {
+    TestRecord rec;
+    TEST_ASSERT_TRUE(storage_register(1, "a", sizeof(TestRecord), 1));
+
+    TEST_ASSERT_EQUAL(STORAGE_ERR_NOT_FOUND, storage_read(1, &rec, sizeof(rec)));
+    TEST_ASSERT_EQUAL(STORAGE_ERR_PARAM, storage_read(2, &rec, sizeof(rec)));
+}
+
+void test_blank_store_formatted_once(void) {
+    // setUp() mounted a blank store
+    TEST_ASSERT_EQUAL(1, g_formats);
+
+    reboot();
+    TEST_ASSERT_EQUAL(1, g_formats);
+}
+
+void test_round_trip_across_reboot(void) {
+    TestRecord in = make_record(7), out;
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_register(2, "b", 100, 1);
+
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_write(1, &in, sizeof(in)));
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_flush());
+
+    reboot();
+    TEST_ASSERT_TRUE(storage_register(1, "a", sizeof(TestRecord), 1));
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_read(1, &out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(in));
+
+    storage_register(2, "b", 100, 1);
+    TEST_ASSERT_EQUAL(STORAGE_ERR_NOT_FOUND, storage_region_status(2));
+}
+
+void test_register_is_idempotent(void) {
+    TEST_ASSERT_TRUE(storage_register(1, "a", 32, 1));
+    TEST_ASSERT_TRUE(storage_register(1, "a", 32, 1));
+    TEST_ASSERT_FALSE(storage_register(1, "a", 64, 1));
+    TEST_ASSERT_FALSE(storage_register(1, "a", 32, 2));
+}
+
+void test_shadow_capacity_enforced(void) {
+    TEST_ASSERT_TRUE(storage_register(1, "big", STORAGE_SHADOW_SIZE - 16, 1));
+    TEST_ASSERT_FALSE(storage_register(2, "more", 32, 1));
+}
+
+void test_version_change_not_loaded(void) {
+    TestRecord in = make_record(3), out;
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_write(1, &in, sizeof(in));
+    storage_flush();
+
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 2);
+    TEST_ASSERT_EQUAL(STORAGE_ERR_VERSION, storage_read(1, &out, sizeof(out)));
+
+    // Writing the new layout replaces the old record
+    storage_write(1, &in, sizeof(in));
+    storage_flush();
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 2);
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_read(1, &out, sizeof(out)));
+}
+
+// ============================================================================
+// COMMIT TESTS
+// ============================================================================
+
+void test_writes_are_lazy(void) {
+    TestRecord in = make_record(1);
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    g_writes = 0;
+
+    storage_write(1, &in, sizeof(in));
+
+    TEST_ASSERT_EQUAL_UINT32(0, g_writes);
+    TEST_ASSERT_TRUE(storage_pending());
+}
+
+void test_tick_commits_after_window(void) {
+    TestRecord in = make_record(1);
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_write(1, &in, sizeof(in));
+
+    storage_tick(1000);
+    storage_tick(1000 + STORAGE_COMMIT_DELAY_MS - 1);
+    TEST_ASSERT_TRUE(storage_pending());
+
+    storage_tick(1000 + STORAGE_COMMIT_DELAY_MS);
+    TEST_ASSERT_FALSE(storage_pending());
+    TEST_ASSERT_EQUAL_UINT32(1, storage_get_stats()->commits);
+}
+
+void test_writes_coalesce_into_one_record(void) {
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_register(2, "b", 64, 1);
+
+    for (uint32_t i = 0; i < 50; i++) {
+        TestRecord rec = make_record(i);
+        uint8_t byte = (uint8_t)i;
+        storage_write(1, &rec, sizeof(rec));
+        storage_write_at(2, (uint16_t)i, &byte, 1);
+    }
+    storage_flush();
+
+    // One record per region, however many writes preceded the commit
+    TEST_ASSERT_EQUAL_UINT32(2, storage_get_stats()->records);
+    TEST_ASSERT_EQUAL_UINT32(99, storage_get_stats()->coalesced);
+}
+
+void test_unchanged_write_skipped(void) {
+    TestRecord in = make_record(5);
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_write(1, &in, sizeof(in));
+    storage_flush();
+
+    storage_write(1, &in, sizeof(in));
+
+    TEST_ASSERT_FALSE(storage_pending());
+    TEST_ASSERT_EQUAL_UINT32(1, storage_get_stats()->unchanged);
+}
+
+// ============================================================================
+// ATOMICITY TESTS
+// ============================================================================
+
+void test_torn_write_keeps_previous_record(void) {
+    TestRecord old_rec = make_record(10), new_rec = make_record(11), out;
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_write(1, &old_rec, sizeof(old_rec));
+    storage_flush();
+
+    storage_write(1, &new_rec, sizeof(new_rec));
+    g_fail_after = STORAGE_RECORD_HEADER_SIZE + 6;
+    TEST_ASSERT_EQUAL(STORAGE_ERR_IO, storage_flush());
+
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_read(1, &out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(&old_rec, &out, sizeof(out));
+    TEST_ASSERT_EQUAL_UINT32(1, storage_get_stats()->corrupt);
+
+    // The damaged sector is abandoned on the next commit
+    storage_write(1, &new_rec, sizeof(new_rec));
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_flush());
+    TEST_ASSERT_EQUAL_UINT32(1, storage_get_stats()->compactions);
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_read(1, &out, sizeof(out));
+    TEST_ASSERT_EQUAL_MEMORY(&new_rec, &out, sizeof(out));
+}
+
+void test_interrupted_compaction_keeps_old_sector(void) {
+    TestRecord out;
+    uint32_t record_len = STORAGE_RECORD_HEADER_SIZE + sizeof(TestRecord);
+    uint32_t fits = (SECTOR_SIZE - STORAGE_SECTOR_HEADER_SIZE) / record_len;
+    storage_register(1, "a", sizeof(TestRecord), 1);
+
+    // Fill the active sector
+    for (uint32_t i = 1; i <= fits; i++) {
+        TestRecord rec = make_record(i);
+        storage_write(1, &rec, sizeof(rec));
+        storage_flush();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, storage_get_stats()->compactions);
+
+    // Power fails while the compaction writes the new sector header
+    TestRecord next = make_record(fits + 1);
+    storage_write(1, &next, sizeof(next));
+    g_fail_after = (int32_t)record_len + 4;
+    TEST_ASSERT_EQUAL(STORAGE_ERR_IO, storage_flush());
+
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    TestRecord committed = make_record(fits);
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_read(1, &out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(&committed, &out, sizeof(out));
+}
+
+void test_unregistered_region_survives_compaction(void) {
+    uint8_t keep[40], out[40];
+    memset(keep, 0x5A, sizeof(keep));
+    storage_register(9, "legacy", sizeof(keep), 1);
+    storage_write(9, keep, sizeof(keep));
+    storage_flush();
+
+    // Firmware without region 9 compacts several times
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    for (uint32_t i = 0; i < 200; i++) {
+        TestRecord rec = make_record(i);
+        storage_write(1, &rec, sizeof(rec));
+        storage_flush();
+    }
+    TEST_ASSERT_TRUE(storage_get_stats()->compactions > SECTOR_COUNT);
+
+    reboot();
+    storage_register(9, "legacy", sizeof(keep), 1);
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_read(9, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(keep, out, sizeof(out));
+}
+
+// ============================================================================
+// WEAR LEVELLING TESTS
+// ============================================================================
+
+void test_erases_spread_across_sectors(void) {
+    TestRecord out;
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    storage_register(2, "b", 120, 1);
+
+    for (uint32_t i = 0; i < 400; i++) {
+        TestRecord rec = make_record(i);
+        storage_write(1, &rec, sizeof(rec));
+        storage_flush();
+    }
+
+    // Rotation: every sector erased about equally often
+    uint32_t compactions = storage_get_stats()->compactions;
+    TEST_ASSERT_TRUE(compactions >= 4 * SECTOR_COUNT);
+    TEST_ASSERT_TRUE(storage_get_stats()->max_erase_count <= compactions / SECTOR_COUNT + 2);
+
+    // Appending instead of rewriting: far fewer erases than commits
+    TEST_ASSERT_TRUE(g_erases * 5 < 400);
+
+    reboot();
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    TestRecord last = make_record(399);
+    storage_read(1, &out, sizeof(out));
+    TEST_ASSERT_EQUAL_MEMORY(&last, &out, sizeof(out));
+}
+
+void test_idle_tick_pre_erases_next_sector(void) {
+    storage_register(1, "a", sizeof(TestRecord), 1);
+    while (storage_get_used() <= SECTOR_SIZE / 2) {
+        TestRecord rec = make_record(storage_get_used());
+        storage_write(1, &rec, sizeof(rec));
+        storage_flush();
+    }
+
+    uint32_t erases = g_erases;
+    storage_tick(0);
+    TEST_ASSERT_EQUAL_UINT32(erases + 1, g_erases);
+
+    // The compaction that follows does not erase again
+    while (storage_get_stats()->compactions == 0) {
+        TestRecord rec = make_record(storage_get_used() + 1);
+        storage_write(1, &rec, sizeof(rec));
+        storage_flush();
+    }
+    TEST_ASSERT_EQUAL_UINT32(erases + 1, g_erases);
+}
+
+void test_pre_erase_count_survives_reboot(void) {
+    const int cycles = 8;
+    for (int c = 0; c < cycles; c++) {
+        storage_register(1, "a", sizeof(TestRecord), 1);
+        while (storage_get_used() <= SECTOR_SIZE / 2) {
+            TestRecord rec = make_record(storage_get_used());
+            storage_write(1, &rec, sizeof(rec));
+            storage_flush();
+        }
+        storage_tick(0);
+
+        // Power cycle between the pre-erase and the compaction
+        reboot();
+        storage_register(1, "a", sizeof(TestRecord), 1);
+        while (storage_get_stats()->compactions == 0) {
+            TestRecord rec = make_record(storage_get_used() + 1);
+            storage_write(1, &rec, sizeof(rec));
+            storage_flush();
+        }
+    }
+
+    // Every erase since the format is on some sector's count
+    reboot();
+    TEST_ASSERT_TRUE(g_erases >= 2 * cycles);
+    TEST_ASSERT_TRUE(storage_get_stats()->max_erase_count * SECTOR_COUNT >= g_erases);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    remove(STORE_PATH);
+    g_file.file = NULL;
+    g_formats = 0;
+    g_erases = 0;
+    reboot();
+    g_writes = 0;
+    g_erases = 0;
+}
+
+void tearDown(void) {
+    storage_file_close(&g_file);
+    remove(STORE_PATH);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Regions
+    RUN_TEST(test_empty_store_reports_not_found);
+    RUN_TEST(test_blank_store_formatted_once);
+    RUN_TEST(test_round_trip_across_reboot);
+    RUN_TEST(test_register_is_idempotent);
+    RUN_TEST(test_shadow_capacity_enforced);
+    RUN_TEST(test_version_change_not_loaded);
+
+    // Commits
+    RUN_TEST(test_writes_are_lazy);
+    RUN_TEST(test_tick_commits_after_window);
+    RUN_TEST(test_writes_coalesce_into_one_record);
+    RUN_TEST(test_unchanged_write_skipped);
+
+    // Atomicity
+    RUN_TEST(test_torn_write_keeps_previous_record);
+    RUN_TEST(test_interrupted_compaction_keeps_old_sector);
+    RUN_TEST(test_unregistered_region_survives_compaction);
+
+    // Wear levelling
+    RUN_TEST(test_erases_spread_across_sectors);
+    RUN_TEST(test_idle_tick_pre_erases_next_sector);
+    RUN_TEST(test_pre_erase_count_survives_reboot);
+
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+/**
+ * @file test_timestep.cpp
+ * @brief Unit tests for the fixed-step accumulator
+ *
+ * Tests validate:
+ * - One step per release at the step period, whatever the jitter
+ * - Constant dt and no time lost between runs
+ * - Late runs catch up, up to the cap; the rest counts as an overrun
+ * - Catch-up steps keep their own simulated times
+ * - Clock wrap-around and long stalls
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "ucf_timestep.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define STEP_US     1000
+#define MAX_STEPS   4
+
+static Timestep g_clock;
+
+// ============================================================================
+// STEP TESTS
+// ============================================================================
+
+void test_one_step_per_release(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 5000);
+    for (int i = 1; i <= 100; i++) {
+        TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 5000 + i * STEP_US));
+    }
+}
+
+void test_jitter_does_not_move_steps(void) {
+    // Up to just under half a step late, in any order
+    const int jitter[] = { 0, 480, 3, 250, 499, 0, 120, 17 };
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    for (int i = 1; i <= 1000; i++) {
+        uint32_t now = (uint32_t)i * STEP_US + jitter[i % 8];
+        TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, now));
+    }
+
+    TimestepStats stats;
+    timestep_get_stats(&g_clock, &stats);
+    TEST_ASSERT_EQUAL(1000, stats.steps);
+    TEST_ASSERT_EQUAL(1, stats.max_steps);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+}
+
+void test_dt_is_constant(void) {
+    timestep_init(&g_clock, 2500, MAX_STEPS, 0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0025f, timestep_dt(&g_clock));
+    timestep_advance(&g_clock, 7777);
+    TEST_ASSERT_EQUAL_FLOAT(0.0025f, timestep_dt(&g_clock));
+}
+
+void test_no_time_lost_between_runs(void) {
+    // Irregular runs: total steps follow total time
+    const uint32_t gaps[] = { 300, 1700, 900, 2100, 50, 950, 1000, 3000 };
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    uint32_t now = 0;
+    uint32_t steps = 0;
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 8; i++) {
+            now += gaps[i];
+            steps += timestep_advance(&g_clock, now);
+        }
+    }
+    // 500 ms; the first step boundary is half a step in
+    TEST_ASSERT_EQUAL(500, steps);
+}
+
+// ============================================================================
+// CATCH-UP TESTS
+// ============================================================================
+
+void test_late_run_catches_up(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 1000));
+    TEST_ASSERT_EQUAL(3, timestep_advance(&g_clock, 4000));
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 5000));
+
+    TimestepStats stats;
+    timestep_get_stats(&g_clock, &stats);
+    TEST_ASSERT_EQUAL(5, stats.steps);
+    TEST_ASSERT_EQUAL(3, stats.max_steps);
+    TEST_ASSERT_EQUAL(0, stats.overruns);
+}
+
+void test_catch_up_steps_keep_their_times(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 1000));
+
+    // Steps end at 1500, 2500 and 3500 (half a step of phase since init)
+    uint8_t steps = timestep_advance(&g_clock, 4200);
+    TEST_ASSERT_EQUAL(3, steps);
+    TEST_ASSERT_EQUAL(4200 - 1500, timestep_age_us(&g_clock, steps, 0));
+    TEST_ASSERT_EQUAL(4200 - 2500, timestep_age_us(&g_clock, steps, 1));
+    TEST_ASSERT_EQUAL(4200 - 3500, timestep_age_us(&g_clock, steps, 2));
+}
+
+void test_cap_drops_excess_steps(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    TEST_ASSERT_EQUAL(MAX_STEPS, timestep_advance(&g_clock, 11000));   // 11 due
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 12000));           // Back on the grid
+
+    TimestepStats stats;
+    timestep_get_stats(&g_clock, &stats);
+    TEST_ASSERT_EQUAL(MAX_STEPS + 1, stats.steps);
+    TEST_ASSERT_EQUAL(1, stats.overruns);
+    TEST_ASSERT_EQUAL(11 - MAX_STEPS, stats.dropped_steps);
+    TEST_ASSERT_EQUAL(MAX_STEPS, stats.max_steps);
+}
+
+void test_long_stall_is_bounded(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0);
+    TEST_ASSERT_EQUAL(MAX_STEPS, timestep_advance(&g_clock, 4000000000u));
+
+    TimestepStats stats;
+    timestep_get_stats(&g_clock, &stats);
+    TEST_ASSERT_EQUAL(4000000 - MAX_STEPS, stats.dropped_steps);
+}
+
+void test_clock_wraps(void) {
+    timestep_init(&g_clock, STEP_US, MAX_STEPS, 0xFFFFFFFFu - 1500);
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 0xFFFFFFFFu - 500));
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 499));
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 1499));
+}
+
+void test_invalid_config_clamped(void) {
+    timestep_init(&g_clock, 0, 0, 0);
+    TEST_ASSERT_EQUAL(1, g_clock.step_us);
+    TEST_ASSERT_EQUAL(1, g_clock.max_steps);
+    TEST_ASSERT_EQUAL(1, timestep_advance(&g_clock, 10));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    memset(&g_clock, 0, sizeof(g_clock));
+}
+
+void tearDown(void) {
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Steps
+    RUN_TEST(test_one_step_per_release);
+    RUN_TEST(test_jitter_does_not_move_steps);
+    RUN_TEST(test_dt_is_constant);
+    RUN_TEST(test_no_time_lost_between_runs);
+
+    // Catch-up
+    RUN_TEST(test_late_run_catches_up);
+    RUN_TEST(test_catch_up_steps_keep_their_times);
+    RUN_TEST(test_cap_drops_excess_steps);
+    RUN_TEST(test_long_stall_is_bounded);
+    RUN_TEST(test_clock_wraps);
+    RUN_TEST(test_invalid_config_clamped);
+
+    return UNITY_END();
+}
@@ -0,0 +1,375 @@
+/**
+ * @file test_trace.cpp
+ * @brief Unit tests for the sensor trace
+ *
+ * Tests record into a memory image through a sink that can be made to
+ * fail, then read or replay that image.
+ *
+ * Tests validate:
+ * - Record round trips through chunks and the reader
+ * - Seeking by time across chunks
+ * - Replay substitution of touch frames, samples and commands
+ * - Corrupt chunks skipped, bad headers rejected
+ * - Ring overflow and sink errors counted, never blocking the hooks
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "ucf_trace.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define IMAGE_CAPACITY  (TRACE_FILE_HEADER_SIZE + 16 * TRACE_CHUNK_SIZE)
+#define TOUCH_PER_CHUNK ((TRACE_CHUNK_SIZE - TRACE_CHUNK_HEADER_SIZE) / \
+                         (TRACE_RECORD_HEADER_SIZE + TRACE_HEX_COUNT * 2))
+
+static uint8_t g_image[IMAGE_CAPACITY];
+static size_t g_image_len;
+static bool g_sink_fails;
+static TraceReader g_reader;
+
+static bool memory_write(const void* data, size_t len, void* ctx) {
+    (void)ctx;
+    if (g_sink_fails || g_image_len + len > sizeof(g_image)) {
+        return false;
+    }
+    memcpy(g_image + g_image_len, data, len);
+    g_image_len += len;
+    return true;
+}
+
+static void make_frame(uint16_t* raw, uint16_t seed) {
+    for (int i = 0; i < TRACE_HEX_COUNT; i++) {
+        raw[i] = (uint16_t)(seed * 31 + i);
+    }
+}
+
+/**
+ * @brief Record touch frames every 10 ms from t0, one mag sample each
+ */
+static void record_frames(uint32_t t0, uint32_t count, bool tick) {
+    for (uint32_t n = 0; n < count; n++) {
+        uint16_t raw[TRACE_HEX_COUNT];
+        make_frame(raw, (uint16_t)n);
+        trace_touch(t0 + n * 10, raw);
+        int16_t xyz[3] = { (int16_t)n, (int16_t)-n, (int16_t)(n * 2) };
+        trace_mag(t0 + n * 10 + 5, xyz);
+        if (tick) {
+            trace_tick();
+        }
+    }
+}
+
+static uint32_t count_records(uint8_t type) {
+    TraceRecord rec;
+    uint32_t n = 0;
+    if (!trace_reader_open(&g_reader, g_image, g_image_len)) {
+        return 0;
+    }
+    while (trace_reader_next(&g_reader, &rec)) {
+        if (type == 0 || rec.type == type) {
+            n++;
+        }
+    }
+    return n;
+}
+
+// ============================================================================
+// ROUND TRIP TESTS
+// ============================================================================
+
+void test_header_only_trace_has_no_records(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 1234));
+    trace_record_end();
+
+    TEST_ASSERT_EQUAL_UINT32(TRACE_FILE_HEADER_SIZE, g_image_len);
+    TEST_ASSERT_TRUE(trace_reader_open(&g_reader, g_image, g_image_len));
+    TEST_ASSERT_EQUAL_UINT32(1234, g_reader.start_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.chunk_count);
+    TEST_ASSERT_EQUAL_UINT32(0, count_records(0));
+}
+
+void test_records_round_trip(void) {
+    uint16_t raw[TRACE_HEX_COUNT];
+    make_frame(raw, 7);
+    int16_t xyz[3] = { -1200, 345, 32767 };
+
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    trace_touch(100, raw);
+    trace_mag(105, xyz);
+    TEST_ASSERT_EQUAL_INT('s', trace_command(110, 's'));
+    TEST_ASSERT_EQUAL_INT(-1, trace_command(111, -1));
+    trace_record_end();
+
+    // Header plus one full-size chunk
+    TEST_ASSERT_EQUAL_UINT32(TRACE_FILE_HEADER_SIZE + TRACE_CHUNK_SIZE, g_image_len);
+    TEST_ASSERT_EQUAL_UINT32(3, trace_get_stats()->records);
+
+    TraceRecord rec;
+    TEST_ASSERT_TRUE(trace_reader_open(&g_reader, g_image, g_image_len));
+    TEST_ASSERT_TRUE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_REC_TOUCH, rec.type);
+    TEST_ASSERT_EQUAL_UINT32(100, rec.time_ms);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(raw, rec.touch, TRACE_HEX_COUNT);
+
+    TEST_ASSERT_TRUE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_REC_MAG, rec.type);
+    TEST_ASSERT_EQUAL_UINT32(105, rec.time_ms);
+    TEST_ASSERT_EQUAL_INT16(-1200, rec.mag[0]);
+    TEST_ASSERT_EQUAL_INT16(345, rec.mag[1]);
+    TEST_ASSERT_EQUAL_INT16(32767, rec.mag[2]);
+
+    TEST_ASSERT_TRUE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_REC_COMMAND, rec.type);
+    TEST_ASSERT_EQUAL_UINT8('s', rec.command);
+    TEST_ASSERT_EQUAL_UINT32(1, rec.frame);
+
+    TEST_ASSERT_FALSE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.corrupt);
+}
+
+void test_records_span_chunks_in_order(void) {
+    const uint32_t frames = TOUCH_PER_CHUNK * 4;
+
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, frames, true);
+    trace_record_end();
+
+    TEST_ASSERT_EQUAL_UINT32(0, (g_image_len - TRACE_FILE_HEADER_SIZE) % TRACE_CHUNK_SIZE);
+    TEST_ASSERT_TRUE(trace_get_stats()->chunks > 4);
+    TEST_ASSERT_EQUAL_UINT32(g_image_len, trace_get_stats()->bytes);
+
+    TraceRecord rec;
+    uint32_t touch = 0;
+    uint32_t last_ms = 0;
+    TEST_ASSERT_TRUE(trace_reader_open(&g_reader, g_image, g_image_len));
+    while (trace_reader_next(&g_reader, &rec)) {
+        TEST_ASSERT_TRUE(rec.time_ms >= last_ms);
+        last_ms = rec.time_ms;
+        if (rec.type == TRACE_REC_TOUCH) {
+            uint16_t expected[TRACE_HEX_COUNT];
+            make_frame(expected, (uint16_t)touch);
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, rec.touch, TRACE_HEX_COUNT);
+            touch++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(frames, touch);
+    TEST_ASSERT_EQUAL_UINT32(frames, count_records(TRACE_REC_MAG));
+}
+
+void test_seek_lands_on_chunk_holding_time(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, TOUCH_PER_CHUNK * 4, true);
+    trace_record_end();
+
+    const uint32_t target = TOUCH_PER_CHUNK * 25;    // Inside the third chunk
+    TraceRecord rec;
+    TEST_ASSERT_TRUE(trace_reader_open(&g_reader, g_image, g_image_len));
+    trace_reader_seek(&g_reader, target);
+    TEST_ASSERT_TRUE(g_reader.chunk > 0);
+    TEST_ASSERT_TRUE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_TRUE(rec.time_ms <= target);
+
+    // The target is reached within the chunk
+    bool found = false;
+    do {
+        if (rec.time_ms >= target) {
+            found = true;
+            break;
+        }
+    } while (trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_TRUE(rec.time_ms - target < 10);
+
+    // Before the first record: start of the trace
+    trace_reader_seek(&g_reader, 0);
+    TEST_ASSERT_TRUE(trace_reader_next(&g_reader, &rec));
+    TEST_ASSERT_EQUAL_UINT32(0, rec.time_ms);
+}
+
+// ============================================================================
+// REPLAY TESTS
+// ============================================================================
+
+void test_replay_substitutes_recorded_inputs(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, 10, true);
+    trace_record_end();
+
+    TEST_ASSERT_TRUE(trace_replay_begin(g_image, g_image_len));
+    for (uint16_t n = 0; n < 10; n++) {
+        uint16_t raw[TRACE_HEX_COUNT];
+        uint16_t expected[TRACE_HEX_COUNT];
+        memset(raw, 0xAA, sizeof(raw));
+        make_frame(expected, n);
+        trace_touch(0, raw);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, raw, TRACE_HEX_COUNT);
+
+        int16_t xyz[3] = { 999, 999, 999 };
+        trace_mag(0, xyz);
+        TEST_ASSERT_EQUAL_INT16((int16_t)n, xyz[0]);
+        TEST_ASSERT_EQUAL_INT16((int16_t)-n, xyz[1]);
+    }
+    TEST_ASSERT_FALSE(trace_get_stats()->replay_done);
+
+    // Past the end the live frame is kept and replay reports done
+    uint16_t raw[TRACE_HEX_COUNT];
+    memset(raw, 0x55, sizeof(raw));
+    trace_touch(0, raw);
+    TEST_ASSERT_EQUAL_UINT16(0x5555, raw[0]);
+    TEST_ASSERT_TRUE(trace_get_stats()->replay_done);
+    TEST_ASSERT_EQUAL_UINT32(10, trace_get_stats()->replay_frames);
+    TEST_ASSERT_EQUAL_UINT32(10, trace_get_stats()->replay_mags);
+}
+
+void test_replay_releases_commands_after_their_frame(void) {
+    uint16_t raw[TRACE_HEX_COUNT];
+    make_frame(raw, 0);
+
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    trace_touch(0, raw);
+    trace_touch(10, raw);
+    trace_command(15, 'p');
+    trace_touch(20, raw);
+    trace_record_end();
+
+    TEST_ASSERT_TRUE(trace_replay_begin(g_image, g_image_len));
+    TEST_ASSERT_EQUAL_INT(-1, trace_command(0, -1));
+    trace_touch(0, raw);
+    TEST_ASSERT_EQUAL_INT(-1, trace_command(0, -1));
+    trace_touch(0, raw);
+
+    // Due now; a live key in the same poll loses to it
+    TEST_ASSERT_EQUAL_INT('p', trace_command(0, 'x'));
+    TEST_ASSERT_EQUAL_INT(-1, trace_command(0, -1));
+    TEST_ASSERT_EQUAL_INT('t', trace_command(0, 't'));
+    TEST_ASSERT_EQUAL_UINT32(1, trace_get_stats()->replay_commands);
+}
+
+void test_replay_can_be_re_recorded(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, TOUCH_PER_CHUNK * 2, true);
+    trace_record_end();
+
+    static uint8_t original[IMAGE_CAPACITY];
+    size_t original_len = g_image_len;
+    memcpy(original, g_image, g_image_len);
+
+    g_image_len = 0;
+    TEST_ASSERT_TRUE(trace_replay_begin(original, original_len));
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    for (uint32_t n = 0; n < TOUCH_PER_CHUNK * 2; n++) {
+        uint16_t raw[TRACE_HEX_COUNT] = { 0 };
+        int16_t xyz[3] = { 0, 0, 0 };
+        trace_touch(n * 10, raw);
+        trace_mag(n * 10 + 5, xyz);
+        trace_tick();
+    }
+    trace_record_end();
+
+    TEST_ASSERT_EQUAL_UINT32(original_len, g_image_len);
+    TEST_ASSERT_EQUAL_MEMORY(original, g_image, original_len);
+}
+
+// ============================================================================
+// FAULT TESTS
+// ============================================================================
+
+void test_corrupt_chunk_is_skipped(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, TOUCH_PER_CHUNK * 3, true);
+    trace_record_end();
+    uint32_t all = count_records(TRACE_REC_TOUCH);
+
+    // Flip one payload byte in the second chunk
+    g_image[TRACE_FILE_HEADER_SIZE + TRACE_CHUNK_SIZE + TRACE_CHUNK_HEADER_SIZE + 10] ^= 0x01;
+
+    uint32_t left = count_records(TRACE_REC_TOUCH);
+    TEST_ASSERT_EQUAL_UINT32(1, g_reader.corrupt);
+    TEST_ASSERT_TRUE(left < all);
+    TEST_ASSERT_TRUE(left > 0);
+}
+
+void test_bad_header_is_rejected(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, 4, true);
+    trace_record_end();
+
+    TEST_ASSERT_FALSE(trace_reader_open(&g_reader, g_image, TRACE_FILE_HEADER_SIZE - 1));
+    g_image[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(trace_reader_open(&g_reader, g_image, g_image_len));
+    TEST_ASSERT_FALSE(trace_replay_begin(g_image, g_image_len));
+    g_image[0] ^= 0xFF;
+    g_image[4] = TRACE_VERSION + 1;
+    TEST_ASSERT_FALSE(trace_reader_open(&g_reader, g_image, g_image_len));
+}
+
+void test_ring_overflow_drops_whole_chunks(void) {
+    // No ticks: the ring fills and further chunks are dropped
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    record_frames(0, TOUCH_PER_CHUNK * 8, false);
+    TEST_ASSERT_TRUE(trace_get_stats()->dropped_chunks > 0);
+    trace_record_end();
+
+    // What reached the sink is intact
+    TEST_ASSERT_TRUE(count_records(0) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, g_reader.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(TRACE_RING_CHUNKS, g_reader.chunk_count);
+}
+
+void test_sink_errors_are_counted(void) {
+    TEST_ASSERT_TRUE(trace_record_begin(memory_write, NULL, 0));
+    g_sink_fails = true;
+    record_frames(0, TOUCH_PER_CHUNK * 2, true);
+    trace_record_end();
+
+    TEST_ASSERT_TRUE(trace_get_stats()->write_errors >= 2);
+    TEST_ASSERT_EQUAL_UINT32(TRACE_FILE_HEADER_SIZE, g_image_len);
+
+    // A failed header leaves recording off
+    TEST_ASSERT_FALSE(trace_record_begin(memory_write, NULL, 0));
+    TEST_ASSERT_EQUAL_UINT8(TRACE_MODE_OFF, trace_get_stats()->mode);
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    trace_record_end();
+    trace_replay_end();
+    memset(g_image, 0, sizeof(g_image));
+    g_image_len = 0;
+    g_sink_fails = false;
+}
+
+void tearDown(void) {
+    trace_record_end();
+    trace_replay_end();
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Round trips
+    RUN_TEST(test_header_only_trace_has_no_records);
+    RUN_TEST(test_records_round_trip);
+    RUN_TEST(test_records_span_chunks_in_order);
+    RUN_TEST(test_seek_lands_on_chunk_holding_time);
+
+    // Replay
+    RUN_TEST(test_replay_substitutes_recorded_inputs);
+    RUN_TEST(test_replay_releases_commands_after_their_frame);
+    RUN_TEST(test_replay_can_be_re_recorded);
+
+    // Faults
+    RUN_TEST(test_corrupt_chunk_is_skipped);
+    RUN_TEST(test_bad_header_is_rejected);
+    RUN_TEST(test_ring_overflow_drops_whole_chunks);
+    RUN_TEST(test_sink_errors_are_counted);
+
+    return UNITY_END();
+}
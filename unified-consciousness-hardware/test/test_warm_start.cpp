@@ -0,0 +1,216 @@
+/**
+ * @file test_warm_start.cpp
+ * @brief Unit tests for warm-start snapshots and the baseline check
+ *
+ * Snapshots go through the storage manager on the file backend; a "reboot"
+ * is a fresh storage_init() on the same file.
+ *
+ * Tests validate:
+ * - Snapshot round trip across reboots, empty store and version changes
+ * - Baseline check: confirm, replace, cold calibration
+ * - Noisy (touched) windows are discarded, and the check gives up eventually
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "ucf_warm_start.h"
+
+// ============================================================================
+// TEST HELPERS
+// ============================================================================
+
+#define STORE_PATH      "test_warm_start.bin"
+#define SECTOR_SIZE     1024
+#define SECTOR_COUNT    4
+#define BASELINE        600
+
+static StorageFile g_file;
+static StorageBackend g_backend;
+
+static void reboot(void) {
+    storage_file_close(&g_file);
+    TEST_ASSERT_TRUE(storage_file_open(&g_file, STORE_PATH, SECTOR_SIZE, SECTOR_COUNT, &g_backend));
+    TEST_ASSERT_TRUE(storage_init(&g_backend));
+}
+
+static WarmSnapshot make_snapshot(void) {
+    WarmSnapshot s;
+    memset(&s, 0, sizeof(s));
+    for (int i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        s.hex_baselines[i] = (uint16_t)(BASELINE + i);
+    }
+    s.z_smoothed = 0.7f;
+    s.phase_z_smoothed = 0.72f;
+    for (int i = 0; i < WARM_SNAPSHOT_OSCILLATORS; i++) {
+        s.kuramoto_phases[i] = 0.1f * i;
+    }
+    s.kuramoto_coupling = 0.35f;
+    s.pll_integrator = -0.02f;
+    s.boot_count = 3;
+    return s;
+}
+
+/**
+ * @brief Feed one window of readings: base + offset, with +/- jitter
+ */
+static WarmCheckState feed_window(BaselineCheck* check, int offset, int jitter) {
+    WarmCheckState state = check->state;
+    for (int s = 0; s < WARM_CHECK_SAMPLES; s++) {
+        uint16_t raw[WARM_SNAPSHOT_HEX_COUNT];
+        for (int i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+            raw[i] = (uint16_t)(BASELINE + i + offset + ((s & 1) ? jitter : -jitter));
+        }
+        state = baseline_check_add(check, raw);
+    }
+    return state;
+}
+
+// ============================================================================
+// SNAPSHOT TESTS
+// ============================================================================
+
+void test_empty_store_has_no_snapshot(void) {
+    WarmSnapshot s;
+    TEST_ASSERT_FALSE(warm_start_load(&s));
+}
+
+void test_snapshot_round_trip_across_reboot(void) {
+    WarmSnapshot in = make_snapshot(), out;
+    TEST_ASSERT_TRUE(warm_start_save(&in));
+    TEST_ASSERT_EQUAL(STORAGE_OK, storage_flush());
+
+    reboot();
+    TEST_ASSERT_TRUE(warm_start_load(&out));
+    TEST_ASSERT_EQUAL_MEMORY(&in, &out, sizeof(in));
+}
+
+void test_snapshot_of_other_version_ignored(void) {
+    WarmSnapshot in = make_snapshot(), out;
+    storage_register(STORAGE_REGION_SNAPSHOT, "snapshot", sizeof(WarmSnapshot),
+                     WARM_SNAPSHOT_VERSION + 1);
+    storage_write(STORAGE_REGION_SNAPSHOT, &in, sizeof(in));
+    storage_flush();
+
+    reboot();
+    TEST_ASSERT_FALSE(warm_start_load(&out));
+}
+
+void test_snapshot_without_baselines_ignored(void) {
+    WarmSnapshot in = make_snapshot(), out;
+    in.hex_baselines[5] = 0;
+    warm_start_save(&in);
+    TEST_ASSERT_FALSE(warm_start_load(&out));
+}
+
+// ============================================================================
+// BASELINE CHECK TESTS
+// ============================================================================
+
+void test_matching_grid_confirms(void) {
+    WarmSnapshot s = make_snapshot();
+    BaselineCheck check;
+    baseline_check_begin(&check, s.hex_baselines);
+    TEST_ASSERT_TRUE(baseline_check_active(&check));
+
+    TEST_ASSERT_EQUAL(WARM_CHECK_CONFIRMED, feed_window(&check, 3, 2));
+    TEST_ASSERT_FALSE(baseline_check_active(&check));
+    TEST_ASSERT_EQUAL(WARM_SNAPSHOT_HEX_COUNT, check.agree);
+}
+
+void test_drifted_grid_replaces(void) {
+    WarmSnapshot s = make_snapshot();
+    BaselineCheck check;
+    baseline_check_begin(&check, s.hex_baselines);
+
+    TEST_ASSERT_EQUAL(WARM_CHECK_REPLACED, feed_window(&check, 40, 1));
+    TEST_ASSERT_EQUAL(0, check.agree);
+    for (int i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        TEST_ASSERT_EQUAL(BASELINE + i + 40, check.result[i]);
+    }
+}
+
+void test_few_drifted_channels_still_confirm(void) {
+    WarmSnapshot s = make_snapshot();
+    int drifted = WARM_SNAPSHOT_HEX_COUNT - WARM_CHECK_MIN_AGREE;
+    for (int i = 0; i < drifted; i++) {
+        s.hex_baselines[i] += 50;
+    }
+    BaselineCheck check;
+    baseline_check_begin(&check, s.hex_baselines);
+
+    TEST_ASSERT_EQUAL(WARM_CHECK_CONFIRMED, feed_window(&check, 0, 0));
+    TEST_ASSERT_EQUAL(WARM_CHECK_MIN_AGREE, check.agree);
+}
+
+void test_cold_check_measures(void) {
+    BaselineCheck check;
+    baseline_check_begin(&check, NULL);
+
+    TEST_ASSERT_EQUAL(WARM_CHECK_REPLACED, feed_window(&check, 0, 3));
+    for (int i = 0; i < WARM_SNAPSHOT_HEX_COUNT; i++) {
+        TEST_ASSERT_EQUAL(BASELINE + i, check.result[i]);
+    }
+}
+
+void test_touched_window_discarded(void) {
+    WarmSnapshot s = make_snapshot();
+    BaselineCheck check;
+    baseline_check_begin(&check, s.hex_baselines);
+
+    // A finger on the grid: large swings, the window is thrown away
+    TEST_ASSERT_EQUAL(WARM_CHECK_COLLECTING, feed_window(&check, -30, 20));
+    TEST_ASSERT_EQUAL(1, check.windows);
+    TEST_ASSERT_EQUAL(0, check.samples);
+
+    TEST_ASSERT_EQUAL(WARM_CHECK_CONFIRMED, feed_window(&check, 0, 1));
+}
+
+void test_check_gives_up_when_never_quiet(void) {
+    BaselineCheck check;
+    baseline_check_begin(&check, NULL);
+
+    WarmCheckState state = WARM_CHECK_COLLECTING;
+    for (int w = 0; w < WARM_CHECK_MAX_WINDOWS; w++) {
+        state = feed_window(&check, 0, WARM_CHECK_NOISE);
+    }
+    TEST_ASSERT_EQUAL(WARM_CHECK_GAVE_UP, state);
+
+    // Further samples are ignored
+    TEST_ASSERT_EQUAL(WARM_CHECK_GAVE_UP, feed_window(&check, 0, 0));
+}
+
+// ============================================================================
+// UNITY TEST RUNNER
+// ============================================================================
+
+void setUp(void) {
+    remove(STORE_PATH);
+    g_file.file = NULL;
+    reboot();
+}
+
+void tearDown(void) {
+    storage_file_close(&g_file);
+    remove(STORE_PATH);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    // Snapshots
+    RUN_TEST(test_empty_store_has_no_snapshot);
+    RUN_TEST(test_snapshot_round_trip_across_reboot);
+    RUN_TEST(test_snapshot_of_other_version_ignored);
+    RUN_TEST(test_snapshot_without_baselines_ignored);
+
+    // Baseline check
+    RUN_TEST(test_matching_grid_confirms);
+    RUN_TEST(test_drifted_grid_replaces);
+    RUN_TEST(test_few_drifted_channels_still_confirm);
+    RUN_TEST(test_cold_check_measures);
+    RUN_TEST(test_touched_window_discarded);
+    RUN_TEST(test_check_gives_up_when_never_quiet);
+
+    return UNITY_END();
+}
@@ -0,0 +1,456 @@
+/**
+ * @file kernel_bench.cpp
+ * @brief Microbenchmarks for the firmware's hot kernels
+ *
+ * Times the per-frame and per-sample kernels (field math, hex FFTs,
+ * oscillator steps, coherence, sigil match, lattice search, photonic
+ * encode/decode, audio samples, LED rendering) on the inputs they see in
+ * the firmware. The bench is a sketch for the native HAL: the modules run
+ * unmodified, with the HAL's NeoPixel, SPI, Wire and flash behind them.
+ *
+ * Inputs are touch frames. Three synthetic sets (idle noise, a finger
+ * sweeping the grid, a whole-grid press) are generated from --seed; with
+ * --replay the recorded touch frames of a sensor trace form a fourth set
+ * named "trace". Every frame is run through HexGrid and KFormation once up
+ * front, so each kernel gets the field, z, phase and kappa it would get on
+ * the device. Kernels whose cost does not depend on the input run once,
+ * with input "-".
+ *
+ * Output on stdout is one tab-separated line per case, for scripts (what
+ * the modules print over Serial goes to stderr):
+ *   kernel  input  calls  median_ns  min_ns
+ * where calls is the batch size and the times are per call over
+ * BENCH_REPEATS batches, each at least BENCH_BATCH_NS long. The
+ * "loop_overhead" case is the cost of the harness itself. Compare two
+ * runs with join(1) on the first two columns.
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=gnu++17 -O2 -pthread -DARDUINO=10812 -DESP32=1 -DARDUINO_ARCH_ESP32=1 \
+ *       -DUCF_NATIVE_HAL=1 -DUCF_V4_MODULES=1 -Ilib/ucf_native_hal/include \
+ *       -Iinclude -Iinclude/ucf tools/kernel_bench.cpp \
+ *       $(ls src/*.cpp | grep -v /main) lib/ucf_native_hal/src/*.cpp -o kernel_bench
+ *
+ * Usage (native HAL options; --fast-bus keeps show()'s wire and latch time
+ * out of the LED cases):
+ *   ./kernel_bench --fast-bus [--seed N] [--replay trace.bin] [--flash DIR]
+ *
+ * Host only (POSIX).
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Legacy modules first, so constants.h is parsed before the v4 macros
+#include "hex_grid.h"
+#include "k_formation.h"
+#include "sigil_rom.h"
+#include "emanation.h"
+#include "kuramoto_stabilizer.h"
+#include "photonic_capture.h"
+
+#include "ucf/ucf_sacred_constants_v4.h"
+#include "ucf/ucf_umbral_calculus.h"
+#include "ucf_solfeggio.h"
+#include "ucf_leds.h"
+#include "ucf_trace.h"
+#include "ucf_native_hal.h"
+
+using namespace UCF;
+
+// ucf_kuramoto.cpp has no header of its own, and eisenstein.h redefines
+// the v4 phase helpers
+void kuramoto_init(void);
+void kuramoto_step(double K, double dt);
+extern "C" void eisenstein_hex_fft(const float* values, float* coeffs);
+
+// ============================================================================
+// BENCH CONSTANTS
+// ============================================================================
+
+#define BENCH_FRAMES            1024        // Frames per synthetic input
+#define BENCH_MAX_FRAMES        65536       // Frames taken from a trace
+#define BENCH_REPEATS           15
+#define BENCH_BATCH_NS          2000000     // Minimum batch length
+#define BENCH_BASELINE          600         // Untouched MPR121 counts
+#define BENCH_LATTICE_DEPTH     3           // umbral_nearest_lattice complexity
+
+// ============================================================================
+// TYPE DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief One touch frame and everything the firmware derives from it
+ */
+typedef struct {
+    uint16_t raw[HEX_SENSOR_COUNT];
+    HexFieldState field;
+    uint8_t phase;                              // 0 UNTRUE, 1 PARADOX, 2 TRUE
+    float kappa;
+    uint16_t photonic[PHOTONIC_SENSOR_COUNT];   // Capture of the frame's pattern
+} BenchFrame;
+
+typedef struct {
+    const char* name;
+    uint16_t baselines[HEX_SENSOR_COUNT];
+    std::vector<BenchFrame> frames;
+} BenchInput;
+
+typedef struct {
+    const char* name;
+    bool per_input;                             // false: run once, input "-"
+    void (*prepare)(const BenchInput& input);   // NULL: nothing to set up
+    void (*run)(const BenchFrame& frame);
+} BenchKernel;
+
+// ============================================================================
+// PRIVATE STATE
+// ============================================================================
+
+static HexGrid g_grid;
+static KFormation g_kformation;
+static SigilROM g_sigils;
+static Emanation g_emanation;
+static KuramotoStabilizer g_stabilizer;
+static PhotonicCapture g_photonic;
+
+static volatile float g_sink;
+static std::vector<BenchInput> g_inputs;
+static FILE* g_out = NULL;                  // Results; Serial goes to stderr
+
+// ============================================================================
+// INPUTS
+// ============================================================================
+
+static void add_noise(uint16_t* raw, const uint16_t* baselines, const float* drop) {
+    for (uint8_t i = 0; i < HEX_SENSOR_COUNT; i++) {
+        long counts = (long)baselines[i] - lroundf(drop[i]) + random(-3, 4);
+        raw[i] = (uint16_t)(counts < 0 ? 0 : counts);
+    }
+}
+
+/**
+ * @brief Counts drop as a Gaussian of the distance from a contact point
+ */
+static void touch_at(float* drop, float cx, float cy, float depth, float spread) {
+    for (uint8_t i = 0; i < HEX_SENSOR_COUNT; i++) {
+        float x, y;
+        HexGrid::indexToCartesian(i, x, y);
+        float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+        drop[i] += depth * expf(-d2 / (spread * spread));
+    }
+}
+
+static BenchInput synthetic_input(const char* name) {
+    BenchInput input;
+    input.name = name;
+    for (uint8_t i = 0; i < HEX_SENSOR_COUNT; i++) {
+        input.baselines[i] = BENCH_BASELINE + (i * 37) % 50;
+    }
+
+    input.frames.resize(BENCH_FRAMES);
+    for (uint32_t f = 0; f < BENCH_FRAMES; f++) {
+        float drop[HEX_SENSOR_COUNT] = { 0 };
+        float t = (float)f / BENCH_FRAMES;
+
+        if (strcmp(name, "sweep") == 0) {
+            // One finger spirals out from the centre and back
+            float radius = 2.0f * (1.0f - fabsf(2.0f * t - 1.0f));
+            float angle = TWO_PI * 4.0f * t;
+            touch_at(drop, radius * cosf(angle), radius * sinf(angle), 140.0f, 0.8f);
+        } else if (strcmp(name, "press") == 0) {
+            // A palm presses to full depth and lifts
+            float depth = 160.0f * sinf(PI * t);
+            touch_at(drop, 0.0f, 0.0f, depth, 2.5f);
+        }
+        add_noise(input.frames[f].raw, input.baselines, drop);
+    }
+    return input;
+}
+
+/**
+ * @brief Collect the touch frames of a trace file
+ * @return false if the file cannot be read or holds no touch frames
+ */
+static bool trace_input(const char* path, BenchInput* input) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    std::vector<uint8_t> image;
+    uint8_t buf[TRACE_CHUNK_SIZE];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        image.insert(image.end(), buf, buf + n);
+    }
+    fclose(file);
+
+    TraceReader reader;
+    if (!trace_reader_open(&reader, image.data(), image.size())) {
+        return false;
+    }
+
+    input->name = "trace";
+    TraceRecord rec;
+    while (input->frames.size() < BENCH_MAX_FRAMES && trace_reader_next(&reader, &rec)) {
+        if (rec.type == TRACE_REC_TOUCH) {
+            BenchFrame frame;
+            memcpy(frame.raw, rec.touch, sizeof(frame.raw));
+            input->frames.push_back(frame);
+        }
+    }
+
+    // Touches only lower the counts, so each cell's highest count is its baseline
+    memset(input->baselines, 0, sizeof(input->baselines));
+    for (const BenchFrame& frame : input->frames) {
+        for (uint8_t i = 0; i < HEX_SENSOR_COUNT; i++) {
+            input->baselines[i] = max(input->baselines[i], frame.raw[i]);
+        }
+    }
+    return !input->frames.empty();
+}
+
+/**
+ * @brief Run an input through the pipeline once to fill in the derived values
+ */
+static void derive(BenchInput& input) {
+    g_grid.setBaselines(input.baselines);
+    g_kformation.resetStats();
+
+    for (BenchFrame& frame : input.frames) {
+        frame.field = g_grid.readField(frame.raw);
+        frame.phase = static_cast<uint8_t>(z_to_phase(frame.field.z));
+        frame.kappa = g_kformation.update(frame.field).kappa;
+
+        PhotonicPattern pattern = g_photonic.generatePattern(frame.field.z, frame.phase, frame.kappa);
+        for (uint8_t i = 0; i < PHOTONIC_SENSOR_COUNT; i++) {
+            frame.photonic[i] = (uint16_t)((pattern.intensities[i] << 8) + random(0, 256));
+        }
+    }
+}
+
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+static void prepare_grid(const BenchInput& input) {
+    g_grid.setBaselines(input.baselines);
+}
+
+static void prepare_coherence(const BenchInput& input) {
+    // Fill the coherence window with the input's last frames
+    for (const BenchFrame& frame : input.frames) {
+        g_kformation.update(frame.field);
+    }
+}
+
+static void prepare_audio(const BenchInput& input) {
+    g_emanation.updateFromZ(0.7f);
+    g_emanation.enableAudio(true);
+    solfeggio_update_from_z(0.7f);
+    solfeggio_enable(true);
+    solfeggio_note_on();
+}
+
+static void prepare_leds(const BenchInput& input) {
+    g_emanation.enableVisual(true);
+}
+
+static void run_overhead(const BenchFrame& frame) {
+    g_sink = frame.kappa;
+}
+
+static void run_read_field(const BenchFrame& frame) {
+    g_sink = g_grid.readField(frame.raw).z;
+}
+
+static void run_compute_z(const BenchFrame& frame) {
+    // HexGrid::hexFFT and its scaling
+    g_sink = g_grid.computeZ(frame.field);
+}
+
+static void run_eisenstein_fft(const BenchFrame& frame) {
+    float coeffs[6];
+    eisenstein_hex_fft(frame.field.readings, coeffs);
+    g_sink = coeffs[0];
+}
+
+static void run_stabilizer_step(const BenchFrame& frame) {
+    g_stabilizer.step(0.001f, millis());
+}
+
+static void run_kuramoto_step(const BenchFrame& frame) {
+    kuramoto_step(KURAMOTO_K, KURAMOTO_DT);
+}
+
+static void run_coherence(const BenchFrame& frame) {
+    g_sink = g_kformation.computeCoherence();
+}
+
+static void run_sigil_match(const BenchFrame& frame) {
+    g_sink = g_sigils.findMatchingSigil(frame.field).confidence;
+}
+
+static void run_nearest_lattice(const BenchFrame& frame) {
+    LatticeCoord coord;
+    g_sink = (float)umbral_nearest_lattice(frame.field.z + frame.kappa, BENCH_LATTICE_DEPTH, &coord);
+}
+
+static void run_generate_pattern(const BenchFrame& frame) {
+    g_sink = g_photonic.generatePattern(frame.field.z, frame.phase, frame.kappa).intensities[0];
+}
+
+static void run_decode_pattern(const BenchFrame& frame) {
+    g_sink = g_photonic.decodePattern(frame.photonic).z;
+}
+
+static void run_emanation_sample(const BenchFrame& frame) {
+    g_sink = g_emanation.getNextAudioSample();
+}
+
+static void run_solfeggio_sample(const BenchFrame& frame) {
+    g_sink = solfeggio_get_sample();
+}
+
+static void run_emanation_leds(const BenchFrame& frame) {
+    // Colour, pattern and show() for the frame's z
+    g_emanation.updateFromZ(frame.field.z);
+}
+
+static void run_leds_update(const BenchFrame& frame) {
+    leds_update(frame.field.z, (ConsciousnessPhase)frame.phase);
+}
+
+static const BenchKernel KERNELS[] = {
+    { "loop_overhead",                      false, NULL,              run_overhead },
+    { "HexGrid::readField",                 true,  prepare_grid,      run_read_field },
+    { "HexGrid::computeZ",                  true,  NULL,              run_compute_z },
+    { "eisenstein_hex_fft",                 true,  NULL,              run_eisenstein_fft },
+    { "KuramotoStabilizer::step",           false, NULL,              run_stabilizer_step },
+    { "kuramoto_step",                      false, NULL,              run_kuramoto_step },
+    { "KFormation::computeCoherence",       true,  prepare_coherence, run_coherence },
+    { "SigilROM::findMatchingSigil",        true,  NULL,              run_sigil_match },
+    { "umbral_nearest_lattice",             true,  NULL,              run_nearest_lattice },
+    { "PhotonicCapture::generatePattern",   true,  NULL,              run_generate_pattern },
+    { "PhotonicCapture::decodePattern",     true,  NULL,              run_decode_pattern },
+    { "Emanation::getNextAudioSample",      false, prepare_audio,     run_emanation_sample },
+    { "solfeggio_get_sample",               false, prepare_audio,     run_solfeggio_sample },
+    { "Emanation::updateFromZ",             true,  prepare_leds,      run_emanation_leds },
+    { "leds_update",                        true,  NULL,              run_leds_update },
+};
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+/**
+ * @brief Time 'calls' calls of a kernel, cycling through the input's frames
+ * @return Nanoseconds for the whole batch
+ */
+static double time_batch(const BenchKernel& kernel, const BenchInput& input, uint32_t calls) {
+    const BenchFrame* frames = input.frames.data();
+    size_t count = input.frames.size();
+    size_t f = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; i++) {
+        kernel.run(frames[f]);
+        if (++f == count) {
+            f = 0;
+        }
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void run_case(const BenchKernel& kernel, const BenchInput& input, const char* label) {
+    if (kernel.prepare != NULL) {
+        kernel.prepare(input);
+    }
+
+    // Size the batch, which also warms caches and branch predictors
+    uint32_t calls = 1;
+    while (time_batch(kernel, input, calls) < BENCH_BATCH_NS && calls < (1u << 30)) {
+        calls *= 2;
+    }
+
+    double per_call[BENCH_REPEATS];
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        per_call[r] = time_batch(kernel, input, calls) / calls;
+    }
+    std::sort(per_call, per_call + BENCH_REPEATS);
+
+    fprintf(g_out, "%s\t%s\t%u\t%.1f\t%.1f\n", kernel.name, label, calls,
+           per_call[BENCH_REPEATS / 2], per_call[0]);
+}
+
+// ============================================================================
+// SKETCH
+// ============================================================================
+
+void setup() {
+    const NativeHalOptions* options = native_hal_options();
+
+    // Keep stdout to the results, whatever the modules print
+    g_out = fdopen(dup(STDOUT_FILENO), "w");
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    g_grid.setThreshold(0.3f);
+    g_kformation.begin();
+    g_photonic.begin();
+    g_emanation.begin();
+    g_stabilizer.begin();
+    kuramoto_init();
+    solfeggio_init();
+    leds_init();
+    if (!g_sigils.begin() || (!g_sigils.isInitialized() && !g_sigils.initializeDefaults())) {
+        fprintf(stderr, "[bench] sigil storage unavailable\n");
+    }
+
+    g_inputs.push_back(synthetic_input("idle"));
+    g_inputs.push_back(synthetic_input("sweep"));
+    g_inputs.push_back(synthetic_input("press"));
+    if (options->replay_path != NULL) {
+        BenchInput recorded;
+        if (!trace_input(options->replay_path, &recorded)) {
+            fprintf(stderr, "[bench] %s: no touch frames\n", options->replay_path);
+            _exit(1);
+        }
+        g_inputs.push_back(recorded);
+    }
+    for (BenchInput& input : g_inputs) {
+        derive(input);
+    }
+
+    fprintf(g_out, "# seed=%lu fast_bus=%d trace=%s\n", (unsigned long)options->seed,
+           options->fast_bus ? 1 : 0, options->replay_path ? options->replay_path : "-");
+    fprintf(g_out, "# kernel\tinput\tcalls\tmedian_ns\tmin_ns\n");
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t cases = 0;
+    for (const BenchKernel& kernel : KERNELS) {
+        if (!kernel.per_input) {
+            run_case(kernel, g_inputs[0], "-");
+            cases++;
+            continue;
+        }
+        for (const BenchInput& input : g_inputs) {
+            run_case(kernel, input, input.name);
+            cases++;
+        }
+    }
+
+    fflush(g_out);
+    fflush(stdout);
+    fprintf(stderr, "[bench] %lu cases in %.1f s\n", (unsigned long)cases,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    // As --seconds does: the HAL's threads are not joined
+    _exit(0);
+}
+
+void loop() {
+}
@@ -0,0 +1,419 @@
+/**
+ * @file ota_delta_host.cpp
+ * @brief Host tool to build and apply delta OTA patches
+ *
+ * diff:  builds a UCFD patch (see ucf_ota_delta.h) that turns the firmware
+ *        image currently on the devices into a new build. Matching uses a
+ *        hash-chained index of the old image with bsdiff-style approximate
+ *        extension, so code that only moved or had addresses shifted is
+ *        encoded as sparse ADD bytes instead of literals. The patch is
+ *        applied in memory through the device decoder before it is written.
+ *
+ * apply: reconstructs the new image with the same decoder and streaming
+ *        verifier the device uses.
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=c++17 -O2 -Iinclude -Iinclude/ucf tools/ota_delta_host.cpp \
+ *       src/ucf_ota_delta.cpp src/ucf_ota_verify.cpp src/ucf_checksum.cpp -o ota_delta_host
+ *
+ * Usage:
+ *   ./ota_delta_host diff  old.bin new.bin patch.ucfd
+ *   ./ota_delta_host apply old.bin patch.ucfd new.bin
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ucf_ota_delta.h"
+#include "ucf_ota_verify.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+// ============================================================================
+// MATCHER PARAMETERS
+// ============================================================================
+
+#define HASH_KEY_SIZE       8       // Bytes hashed per index entry
+#define HASH_BITS           20
+#define MAX_CHAIN           64      // Candidates examined per position
+#define MIN_MATCH           12      // Shortest exact match worth re-aligning for
+#define REALIGN_GAIN        8       // Required gain over the current alignment
+#define MIN_ZERO_RUN        6       // Zero diff bytes worth splitting ADD into COPY
+
+// ============================================================================
+// FILE HELPERS
+// ============================================================================
+
+static bool read_file(const char* path, Bytes& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = out.empty() || fread(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+static bool write_file(const char* path, const Bytes& data) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot create\n", path);
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+static void sha256(const Bytes& data, uint8_t* digest) {
+    OTASha256 sha;
+    ota_sha256_init(&sha);
+    ota_sha256_update(&sha, data.data(), data.size());
+    ota_sha256_final(&sha, digest);
+}
+
+// ============================================================================
+// PATCH WRITER
+// ============================================================================
+
+struct PatchWriter {
+    Bytes out;
+    uint32_t old_pos = 0;
+
+    void varint(uint32_t v) {
+        while (v >= 0x80) {
+            out.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t)v);
+    }
+
+    void op(uint8_t code, uint32_t arg) {
+        out.push_back(code);
+        varint(arg);
+    }
+
+    void seek_to(uint32_t pos) {
+        if (pos != old_pos) {
+            int32_t delta = (int32_t)(pos - old_pos);
+            op(OTA_DELTA_OP_SEEK, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+            old_pos = pos;
+        }
+    }
+
+    void insert(const uint8_t* data, uint32_t len) {
+        if (len == 0) return;
+        op(OTA_DELTA_OP_INSERT, len);
+        out.insert(out.end(), data, data + len);
+    }
+
+    /**
+     * Encode new[0..len) against old[0..len) at the current old cursor,
+     * using COPY for long runs of identical bytes and ADD elsewhere.
+     */
+    void diff(const uint8_t* oldp, const uint8_t* newp, uint32_t len) {
+        auto zero_run = [&](uint32_t i) {
+            uint32_t j = i;
+            while (j < len && oldp[j] == newp[j]) j++;
+            return j - i;
+        };
+
+        uint32_t i = 0;
+        while (i < len) {
+            uint32_t z = zero_run(i);
+            if (z >= MIN_ZERO_RUN || i + z == len) {
+                op(OTA_DELTA_OP_COPY, z);
+                i += z;
+                continue;
+            }
+
+            uint32_t j = i;
+            while (j < len) {
+                z = zero_run(j);
+                if (z >= MIN_ZERO_RUN) break;
+                j += (z > 0) ? z : 1;
+            }
+
+            op(OTA_DELTA_OP_ADD, j - i);
+            for (uint32_t k = i; k < j; k++) {
+                out.push_back((uint8_t)(newp[k] - oldp[k]));
+            }
+            i = j;
+        }
+        old_pos += len;
+    }
+};
+
+// ============================================================================
+// DIFF
+// ============================================================================
+
+struct Matcher {
+    const Bytes& old_img;
+    std::vector<int32_t> head;
+    std::vector<int32_t> chain;
+
+    explicit Matcher(const Bytes& o) : old_img(o), head(1u << HASH_BITS, -1), chain(o.size(), -1) {
+        for (size_t i = 0; i + HASH_KEY_SIZE <= old_img.size(); i++) {
+            uint32_t h = hash(&old_img[i]);
+            chain[i] = head[h];
+            head[h] = (int32_t)i;
+        }
+    }
+
+    static uint32_t hash(const uint8_t* p) {
+        uint64_t k;
+        memcpy(&k, p, sizeof(k));
+        return (uint32_t)((k * 0x9E3779B97F4A7C15ull) >> (64 - HASH_BITS));
+    }
+
+    uint32_t match_len(uint32_t o, const Bytes& n, uint32_t s) const {
+        uint32_t len = 0;
+        while (o + len < old_img.size() && s + len < n.size() && old_img[o + len] == n[s + len]) len++;
+        return len;
+    }
+
+    /**
+     * Longest exact match for new[s..] in the old image
+     */
+    uint32_t best(const Bytes& n, uint32_t s, uint32_t* pos) const {
+        uint32_t best_len = 0;
+        int steps = 0;
+        for (int32_t c = head[hash(&n[s])]; c >= 0 && steps < MAX_CHAIN; c = chain[c], steps++) {
+            uint32_t len = match_len((uint32_t)c, n, s);
+            if (len > best_len) {
+                best_len = len;
+                *pos = (uint32_t)c;
+            }
+        }
+        return best_len;
+    }
+};
+
+static Bytes build_patch(const Bytes& old_img, const Bytes& new_img) {
+    PatchWriter w;
+    OTADeltaHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = OTA_DELTA_MAGIC;
+    header.version = OTA_DELTA_VERSION;
+    header.old_size = (uint32_t)old_img.size();
+    header.new_size = (uint32_t)new_img.size();
+    sha256(old_img, header.old_sha256);
+    sha256(new_img, header.new_sha256);
+
+    w.out.resize(OTA_DELTA_HEADER_SIZE);
+    ota_delta_encode_header(&header, w.out.data());
+
+    Matcher m(old_img);
+    const uint32_t old_size = header.old_size;
+    const uint32_t new_size = header.new_size;
+
+    auto old_at = [&](int64_t i) -> int { return (i >= 0 && i < old_size) ? old_img[i] : -1; };
+
+    int64_t cur_delta = 0;          // old offset = new offset + cur_delta
+    uint32_t last_scan = 0;         // First new byte not yet encoded
+    uint32_t scan = 0;
+
+    // Forward-extend the current alignment from last_scan, then
+    // backward-extend the new alignment from scan (bsdiff lenf/lenb)
+    auto emit_segment = [&](uint32_t end, int64_t next_pos, bool has_next) {
+        uint32_t span = end - last_scan;
+        uint32_t lenf = 0, lenb = 0;
+        int64_t score = 0, best = 0;
+
+        for (uint32_t i = 0; i < span; i++) {
+            int o = old_at(last_scan + cur_delta + i);
+            if (o < 0) break;
+            score += (o == new_img[last_scan + i]) ? 1 : -1;
+            if (score > best) { best = score; lenf = i + 1; }
+        }
+
+        if (has_next) {
+            score = 0; best = 0;
+            for (uint32_t i = 1; i <= span; i++) {
+                int o = old_at(next_pos - i);
+                if (o < 0) break;
+                score += (o == new_img[end - i]) ? 1 : -1;
+                if (score > best) { best = score; lenb = i; }
+            }
+
+            if (lenf + lenb > span) {
+                uint32_t overlap = lenf + lenb - span;
+                int64_t s = 0, ss = 0;
+                uint32_t lens = 0;
+                for (uint32_t i = 0; i < overlap; i++) {
+                    uint32_t nf = last_scan + lenf - overlap + i;
+                    if (old_at(nf + cur_delta) == new_img[nf]) s++;
+                    uint32_t nb = end - lenb + i;
+                    if (old_at(next_pos - lenb + i) == new_img[nb]) s--;
+                    if (s > ss) { ss = s; lens = i + 1; }
+                }
+                lenf += lens - overlap;
+                lenb -= lens;
+            }
+        }
+
+        if (lenf > 0) {
+            uint32_t o = (uint32_t)(last_scan + cur_delta);
+            w.seek_to(o);
+            w.diff(&old_img[o], &new_img[last_scan], lenf);
+        }
+        w.insert(&new_img[last_scan + lenf], span - lenf - lenb);
+
+        last_scan = end - lenb;
+    };
+
+    while (scan + HASH_KEY_SIZE <= new_size) {
+        uint32_t pos = 0;
+        uint32_t len = m.best(new_img, scan, &pos);
+
+        if (len < MIN_MATCH || pos - (int64_t)scan == cur_delta) {
+            scan += (len >= MIN_MATCH) ? len : 1;
+            continue;
+        }
+
+        // Bytes the current alignment already gets right over the same span
+        uint32_t old_score = 0;
+        for (uint32_t i = 0; i < len; i++) {
+            if (old_at(scan + cur_delta + i) == new_img[scan + i]) old_score++;
+        }
+        if (len <= old_score + REALIGN_GAIN) {
+            scan++;
+            continue;
+        }
+
+        emit_segment(scan, pos, true);
+        cur_delta = (int64_t)pos - scan;
+        scan += len;
+    }
+
+    emit_segment(new_size, 0, false);
+    w.out.push_back(OTA_DELTA_OP_END);
+    return w.out;
+}
+
+// ============================================================================
+// APPLY
+// ============================================================================
+
+struct ApplyContext {
+    const Bytes* old_img;
+    Bytes new_img;
+    OTAStreamVerifier verifier;
+};
+
+static bool host_begin(const OTADeltaHeader* header, void* ctx) {
+    ApplyContext* a = (ApplyContext*)ctx;
+    uint8_t digest[OTA_SHA256_SIZE];
+    sha256(*a->old_img, digest);
+
+    if (header->old_size != a->old_img->size() || memcmp(digest, header->old_sha256, sizeof(digest)) != 0) {
+        fprintf(stderr, "patch was built against a different base image\n");
+        return false;
+    }
+
+    ota_verify_init(&a->verifier, header->new_size, OTA_VERIFY_FLAG_REQUIRE_SHA);
+    ota_verify_set_expected_sha256(&a->verifier, header->new_sha256);
+    a->new_img.reserve(header->new_size);
+    return true;
+}
+
+static bool host_read_old(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    ApplyContext* a = (ApplyContext*)ctx;
+    memcpy(buf, a->old_img->data() + offset, len);
+    return true;
+}
+
+static bool host_write_new(const uint8_t* data, size_t len, void* ctx) {
+    ApplyContext* a = (ApplyContext*)ctx;
+    a->new_img.insert(a->new_img.end(), data, data + len);
+    ota_verify_update(&a->verifier, data, len);
+    return true;
+}
+
+/**
+ * @brief Apply a patch in device-sized chunks
+ * @return true if the patch decoded and the result matches its digest
+ */
+static bool apply_patch(const Bytes& old_img, const Bytes& patch, ApplyContext& a) {
+    const size_t chunk = 1460;
+    a.old_img = &old_img;
+
+    OTADeltaIO io = { host_begin, host_read_old, host_write_new, &a };
+    OTADeltaDecoder decoder;
+    ota_delta_init(&decoder, &io);
+
+    OTADeltaStatus status = OTA_DELTA_PENDING;
+    for (size_t off = 0; off < patch.size() && status == OTA_DELTA_PENDING; off += chunk) {
+        size_t n = (patch.size() - off < chunk) ? patch.size() - off : chunk;
+        status = ota_delta_update(&decoder, patch.data() + off, n);
+    }
+    status = ota_delta_finish(&decoder);
+
+    if (status != OTA_DELTA_DONE) {
+        fprintf(stderr, "patch: %s\n", ota_delta_status_string(status));
+        return false;
+    }
+
+    // Images without the lattice signature (e.g. test data) still round-trip;
+    // the device rejects them when strict_lattice_check is set
+    OTAVerifyStatus verdict = ota_verify_finish(&a.verifier);
+    if (verdict == OTA_VERIFY_ERR_LATTICE) {
+        fprintf(stderr, "warning: %s\n", ota_verify_status_string(verdict));
+    } else if (verdict != OTA_VERIFY_ACCEPTED) {
+        fprintf(stderr, "result: %s\n", ota_verify_status_string(verdict));
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    if (argc != 5 || (strcmp(argv[1], "diff") != 0 && strcmp(argv[1], "apply") != 0)) {
+        fprintf(stderr, "usage: %s diff old.bin new.bin patch.ucfd\n"
+                        "       %s apply old.bin patch.ucfd new.bin\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    Bytes old_img, input;
+    if (!read_file(argv[2], old_img) || !read_file(argv[3], input)) {
+        return 1;
+    }
+
+    if (strcmp(argv[1], "diff") == 0) {
+        if (old_img.empty() || input.empty() ||
+            old_img.size() > OTA_MAX_FIRMWARE_SIZE || input.size() > OTA_MAX_FIRMWARE_SIZE) {
+            fprintf(stderr, "image sizes must be in (0, %d] bytes\n", OTA_MAX_FIRMWARE_SIZE);
+            return 1;
+        }
+
+        Bytes patch = build_patch(old_img, input);
+
+        ApplyContext check;
+        if (!apply_patch(old_img, patch, check) || check.new_img != input) {
+            fprintf(stderr, "internal error: patch does not reproduce %s\n", argv[3]);
+            return 1;
+        }
+
+        printf("%s: %zu -> %zu bytes, patch %zu bytes (%.1f%% of full image)\n",
+               argv[4], old_img.size(), input.size(), patch.size(),
+               input.empty() ? 0.0 : 100.0 * patch.size() / input.size());
+        return write_file(argv[4], patch) ? 0 : 1;
+    }
+
+    ApplyContext a;
+    if (!apply_patch(old_img, input, a)) {
+        return 1;
+    }
+    printf("%s: %zu bytes, digest verified\n", argv[4], a.new_img.size());
+    return write_file(argv[4], a.new_img) ? 0 : 1;
+}
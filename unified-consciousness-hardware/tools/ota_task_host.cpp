@@ -0,0 +1,270 @@
+/**
+ * @file ota_task_host.cpp
+ * @brief Host stand-in for a background OTA transfer
+ *
+ * Runs a simulated 1 kHz control loop and a budgeted OTA transfer on one
+ * host thread, with wall-clock timing. The transport serves a file at a
+ * simulated link rate; the sink is the real streaming verifier (and patch
+ * decoder for delta updates). Reports transfer time, the verdict, and how
+ * late control ticks ran because of OTA slices.
+ *
+ * Because everything shares one core here, tick lateness is bounded by the
+ * slice budget; on the ESP32 the transfer runs on the other core.
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=c++17 -O2 -Iinclude -Iinclude/ucf tools/ota_task_host.cpp \
+ *       src/ucf_ota_task.cpp src/ucf_ota_delta.cpp src/ucf_ota_verify.cpp \
+ *       src/ucf_checksum.cpp -o ota_task_host
+ *
+ * Usage:
+ *   ./ota_task_host [-b budget_Bps] [-l link_Bps] [-s slice_us] [-d duty_%]
+ *                   [-c chunk] [-o old.bin] payload
+ *   (-o marks the payload as a UCFD patch against old.bin)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "ucf_ota_task.h"
+#include "ucf_ota_delta.h"
+#include "ucf_ota_verify.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+#define TICK_US             1000    // Control loop period (1 kHz)
+#define TICK_WORK_US        150     // Simulated control work per tick
+#define RUN_LIMIT_US        600000000u
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+
+static std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+static uint32_t host_clock_us(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+static void spin_until(uint32_t t) {
+    while ((int32_t)(host_clock_us() - t) < 0) {
+    }
+}
+
+// ============================================================================
+// STAND-IN TRANSPORT (file served at a link rate)
+// ============================================================================
+
+struct FileTransport {
+    Bytes data;
+    bool is_delta;
+    uint32_t link_bps;
+    uint32_t start_us;
+    uint32_t pos;
+};
+
+static bool file_open(OTATransferInfo* info, void* ctx) {
+    FileTransport* f = (FileTransport*)ctx;
+    info->size = (uint32_t)f->data.size();
+    info->is_delta = f->is_delta;
+    f->start_us = host_clock_us();
+    f->pos = 0;
+    return true;
+}
+
+static int32_t file_read(uint8_t* buf, size_t max_len, void* ctx) {
+    FileTransport* f = (FileTransport*)ctx;
+    if (f->pos == f->data.size()) {
+        return OTA_TRANSPORT_EOF;
+    }
+
+    uint64_t arrived = f->data.size();
+    if (f->link_bps) {
+        arrived = (uint64_t)(host_clock_us() - f->start_us) * f->link_bps / 1000000u;
+        if (arrived > f->data.size()) arrived = f->data.size();
+    }
+
+    uint32_t n = (uint32_t)(arrived - f->pos);
+    if (n > max_len) n = (uint32_t)max_len;
+    memcpy(buf, f->data.data() + f->pos, n);
+    f->pos += n;
+    return (int32_t)n;
+}
+
+// ============================================================================
+// SINK (verifier, optionally behind the patch decoder)
+// ============================================================================
+
+struct HostSink {
+    const Bytes* old_img;
+    OTADeltaDecoder delta;
+    OTAStreamVerifier verifier;
+    bool is_delta;
+    bool failed;
+};
+
+static bool delta_begin(const OTADeltaHeader* header, void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    if (!s->old_img || header->old_size != s->old_img->size()) {
+        return false;
+    }
+    ota_verify_init(&s->verifier, header->new_size, 0);
+    ota_verify_set_expected_sha256(&s->verifier, header->new_sha256);
+    return true;
+}
+
+static bool delta_read_old(uint32_t offset, uint8_t* buf, size_t len, void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    memcpy(buf, s->old_img->data() + offset, len);
+    return true;
+}
+
+static bool delta_write_new(const uint8_t* data, size_t len, void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    OTAVerifyStatus v = ota_verify_update(&s->verifier, data, len);
+    return v == OTA_VERIFY_PENDING || v == OTA_VERIFY_ACCEPTED || v == OTA_VERIFY_ERR_LATTICE;
+}
+
+static bool sink_begin(const OTATransferInfo* info, void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    s->is_delta = info->is_delta;
+    if (s->is_delta) {
+        OTADeltaIO io = { delta_begin, delta_read_old, delta_write_new, s };
+        ota_delta_init(&s->delta, &io);
+    } else {
+        ota_verify_init(&s->verifier, info->size, 0);
+    }
+    return true;
+}
+
+static OTAStatus sink_write(const uint8_t* data, size_t len, void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    if (s->is_delta) {
+        OTADeltaStatus d = ota_delta_update(&s->delta, data, len);
+        return (d == OTA_DELTA_PENDING || d == OTA_DELTA_DONE) ? OTA_STATUS_DOWNLOADING
+                                                              : OTA_STATUS_ERROR_CHECKSUM;
+    }
+    OTAVerifyStatus v = ota_verify_update(&s->verifier, data, len);
+    return (v == OTA_VERIFY_ERR_SIZE || v == OTA_VERIFY_ERR_HEADER) ? OTA_STATUS_ERROR_SIZE
+                                                                    : OTA_STATUS_DOWNLOADING;
+}
+
+static OTAStatus sink_end(void* ctx) {
+    HostSink* s = (HostSink*)ctx;
+    if (s->is_delta && ota_delta_finish(&s->delta) != OTA_DELTA_DONE) {
+        return OTA_STATUS_ERROR_CHECKSUM;
+    }
+    OTAVerifyStatus v = ota_verify_finish(&s->verifier);
+    printf("verdict: %s\n", ota_verify_status_string(v));
+    // Lattice signature is not required for host payloads
+    return (v == OTA_VERIFY_ACCEPTED || v == OTA_VERIFY_ERR_LATTICE) ? OTA_STATUS_SUCCESS
+                                                                      : OTA_STATUS_ERROR_CHECKSUM;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static bool read_file(const char* path, Bytes& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = out.empty() || fread(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    OTATaskConfig config;
+    ota_task_default_config(&config);
+    FileTransport file = {};
+    Bytes old_img;
+    int arg = 1;
+
+    while (arg + 1 < argc && argv[arg][0] == '-') {
+        const char* v = argv[arg + 1];
+        switch (argv[arg][1]) {
+            case 'b': config.bytes_per_sec = (uint32_t)atol(v); break;
+            case 'l': file.link_bps = (uint32_t)atol(v); break;
+            case 's': config.slice_us = (uint32_t)atol(v); break;
+            case 'd': config.duty_percent = (uint8_t)atoi(v); break;
+            case 'c': config.chunk_size = (uint16_t)atoi(v); break;
+            case 'o':
+                if (!read_file(v, old_img)) return 1;
+                file.is_delta = true;
+                break;
+            default:
+                fprintf(stderr, "unknown option %s\n", argv[arg]);
+                return 2;
+        }
+        arg += 2;
+    }
+
+    if (arg != argc - 1) {
+        fprintf(stderr, "usage: %s [-b budget_Bps] [-l link_Bps] [-s slice_us] [-d duty_%%] "
+                        "[-c chunk] [-o old.bin] payload\n", argv[0]);
+        return 2;
+    }
+    if (!read_file(argv[arg], file.data)) {
+        return 1;
+    }
+
+    HostSink sink_state = {};
+    sink_state.old_img = file.is_delta ? &old_img : NULL;
+
+    OTATransport transport = { file_open, file_read, NULL, &file };
+    OTASink sink = { sink_begin, sink_write, sink_end, &sink_state };
+
+    OTATask task;
+    ota_task_init(&task, &config, host_clock_us);
+    if (!ota_task_start(&task, &transport, &sink)) {
+        fprintf(stderr, "transfer did not start\n");
+        return 1;
+    }
+
+    // Cooperative loop: control ticks have priority, OTA slices fill the gaps
+    uint32_t start = host_clock_us();
+    uint32_t next_tick = start;
+    uint32_t next_ota = start;
+    uint32_t ticks = 0, late_ticks = 0, missed_ticks = 0, max_late = 0;
+
+    while (ota_task_get_state(&task) == OTA_TASK_RUNNING && host_clock_us() - start < RUN_LIMIT_US) {
+        uint32_t now = host_clock_us();
+
+        if ((int32_t)(now - next_tick) >= 0) {
+            uint32_t late = now - next_tick;
+            if (late > max_late) max_late = late;
+            if (late > TICK_US / 10) late_ticks++;
+            if (late >= TICK_US) missed_ticks++;
+            ticks++;
+            spin_until(now + TICK_WORK_US);
+            next_tick += TICK_US;
+            continue;
+        }
+
+        if ((int32_t)(now - next_ota) >= 0) {
+            next_ota = now + ota_task_step(&task);
+        }
+    }
+
+    uint32_t elapsed = host_clock_us() - start;
+    const OTATaskStats* st = &task.stats;
+
+    printf("%s: %s, %u bytes in %.3f s (%.1f KB/s)\n", argv[arg],
+           ota_task_state_string(ota_task_get_state(&task)), st->bytes,
+           elapsed / 1e6, st->bytes / 1024.0 / (elapsed / 1e6));
+    printf("ota: %u slices, max %u us, busy %.1f%%, starved %u\n",
+           st->slices, st->max_slice_us, 100.0 * st->busy_us / elapsed, st->starved);
+    printf("control: %u ticks, %u late (>%u us), %u missed, max lateness %u us\n",
+           ticks, late_ticks, TICK_US / 10, missed_ticks, max_late);
+
+    return ota_task_get_state(&task) == OTA_TASK_DONE ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file ota_verify_host.cpp
+ * @brief Host harness for the streaming OTA verifier
+ *
+ * Feeds firmware image files through ota_verify_update() in fixed-size
+ * chunks, exactly as the device does during download, and prints the
+ * verdict. Exit status is 0 only if every image is accepted.
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=c++17 -O2 -Iinclude -Iinclude/ucf \
+ *       tools/ota_verify_host.cpp src/ucf_ota_verify.cpp src/ucf_checksum.cpp -o ota_verify_host
+ *
+ * Usage:
+ *   ./ota_verify_host [-c chunk_bytes] [-s sha256_hex] firmware.bin [...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ucf_ota_verify.h"
+
+#define DEFAULT_CHUNK_SIZE  1460    // One TCP segment, as seen by the device
+
+static bool parse_hex_digest(const char* hex, uint8_t* out) {
+    if (strlen(hex) != OTA_SHA256_SIZE * 2) return false;
+    for (int i = 0; i < OTA_SHA256_SIZE; i++) {
+        unsigned int byte;
+        if (sscanf(hex + i * 2, "%2x", &byte) != 1) return false;
+        out[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+static bool verify_file(const char* path, size_t chunk_size, const uint8_t* digest) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size <= 0 || size > OTA_MAX_FIRMWARE_SIZE) {
+        fprintf(stderr, "%s: size %ld outside (0, %d]\n", path, size, OTA_MAX_FIRMWARE_SIZE);
+        fclose(f);
+        return false;
+    }
+
+    OTAStreamVerifier v;
+    ota_verify_init(&v, (uint32_t)size, OTA_VERIFY_FLAG_ESP_IMAGE | OTA_VERIFY_FLAG_REQUIRE_SHA);
+    if (digest) {
+        ota_verify_set_expected_sha256(&v, digest);
+    }
+
+    uint8_t* chunk = (uint8_t*)malloc(chunk_size);
+    OTAVerifyStatus status = OTA_VERIFY_PENDING;
+    size_t n;
+
+    while (status == OTA_VERIFY_PENDING && (n = fread(chunk, 1, chunk_size, f)) > 0) {
+        status = ota_verify_update(&v, chunk, n);
+    }
+    status = ota_verify_finish(&v);
+
+    free(chunk);
+    fclose(f);
+
+    LatticeValidation validation;
+    ota_verify_get_validation(&v, &validation);
+
+    printf("%s: %s (%u bytes, crc32=0x%08X, signature@0x%X, patterns=0x%02X)\n",
+           path, ota_verify_status_string(status), (unsigned)v.received,
+           (unsigned)validation.firmware_checksum, (unsigned)v.signature_offset,
+           (unsigned)v.found_mask);
+
+    return status == OTA_VERIFY_ACCEPTED;
+}
+
+int main(int argc, char** argv) {
+    size_t chunk_size = DEFAULT_CHUNK_SIZE;
+    uint8_t digest[OTA_SHA256_SIZE];
+    const uint8_t* digest_ptr = NULL;
+    int first_file = 1;
+
+    while (first_file < argc && argv[first_file][0] == '-') {
+        if (strcmp(argv[first_file], "-c") == 0 && first_file + 1 < argc) {
+            chunk_size = (size_t)atoi(argv[first_file + 1]);
+            first_file += 2;
+        } else if (strcmp(argv[first_file], "-s") == 0 && first_file + 1 < argc) {
+            if (!parse_hex_digest(argv[first_file + 1], digest)) {
+                fprintf(stderr, "invalid SHA-256 hex digest\n");
+                return 2;
+            }
+            digest_ptr = digest;
+            first_file += 2;
+        } else {
+            break;
+        }
+    }
+
+    if (first_file >= argc || chunk_size == 0) {
+        fprintf(stderr, "usage: %s [-c chunk_bytes] [-s sha256_hex] firmware.bin [...]\n", argv[0]);
+        return 2;
+    }
+
+    bool all_ok = true;
+    for (int i = first_file; i < argc; i++) {
+        all_ok &= verify_file(argv[i], chunk_size, digest_ptr);
+    }
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file session_log_host.cpp
+ * @brief Host reader for session log images
+ *
+ * Decodes a dump of the "ucflog" partition and prints every record, one
+ * per line, oldest first. Also generates synthetic images to size the
+ * partition: the summary line reports flash bytes per hour of session.
+ *
+ * Dump the partition from a device (offset/size from partitions_ucf.csv):
+ *   esptool.py read_flash 0x360000 0x80000 ucflog.bin
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=c++17 -O2 -Iinclude -Iinclude/ucf tools/session_log_host.cpp \
+ *       src/ucf_session_log.cpp src/ucf_storage_file.cpp src/ucf_checksum.cpp \
+ *       -o session_log_host
+ *
+ * Usage:
+ *   ./session_log_host [-c] [-s session] ucflog.bin     print records (-c: CSV)
+ *   ./session_log_host -g minutes [-n sectors] out.bin  write a synthetic session
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ucf_session_log.h"
+
+#define SECTOR_SIZE         4096
+#define DEFAULT_SECTORS     128     // 512 KB, as in partitions_ucf.csv
+#define SENSOR_INTERVAL_MS  10      // loop() sensor rate
+
+static SessionLogReader g_reader;
+
+static bool open_image(const char* path, uint16_t sectors, StorageFile* sf, StorageBackend* backend) {
+    if (sectors == 0) {
+        FILE* f = fopen(path, "rb");
+        if (!f) {
+            fprintf(stderr, "%s: cannot open\n", path);
+            return false;
+        }
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fclose(f);
+        if (size < SECTOR_SIZE || size % SECTOR_SIZE != 0) {
+            fprintf(stderr, "%s: size %ld is not a multiple of %d\n", path, size, SECTOR_SIZE);
+            return false;
+        }
+        sectors = (uint16_t)(size / SECTOR_SIZE);
+    }
+    if (!storage_file_open(sf, path, SECTOR_SIZE, sectors, backend)) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Simulated session: slow drift with touch bursts and periodic unlocks
+ */
+static int generate(const char* path, uint32_t minutes, uint16_t sectors) {
+    remove(path);
+    StorageFile sf;
+    StorageBackend backend;
+    if (!open_image(path, sectors, &sf, &backend) || !session_log_init(&backend)) {
+        return 1;
+    }
+
+    SessionFrame f;
+    memset(&f, 0, sizeof(f));
+    uint32_t end = minutes * 60000;
+    for (uint32_t now = 0; now < end; now += SENSOR_INTERVAL_MS) {
+        float t = (float)now / 1000.0f;
+        f.z = 0.5f + 0.35f * sinf(t * 0.05f) + 0.1f * sinf(t * 0.7f) + 0.002f * (float)(rand() % 5);
+        f.r = 0.6f + 0.3f * sinf(t * 0.02f);
+        f.kappa = 0.5f + 0.4f * sinf(t * 0.03f);
+        f.eta = expf(-36.0f * (f.z - 0.866f) * (f.z - 0.866f));
+        f.phase = (f.z < 0.618f) ? 0 : (f.z < 0.866f) ? 1 : 2;
+        f.active_sensors = (uint8_t)(f.z * 19.0f);
+        f.triad_state = (uint8_t)((now / 45000) % 7);
+        f.triad_crossings = (uint8_t)((now / 15000) % 4);
+        f.k_formation = f.kappa > 0.85f && f.eta > 0.618f;
+        session_log_frame(now, &f);
+        session_log_tick(now);
+    }
+    session_log_flush();
+
+    const SessionLogStats* stats = session_log_get_stats();
+    double hours = minutes / 60.0;
+    double per_hour = stats->flash_bytes / hours;
+    printf("records=%u blocks=%u raw=%u flash=%u ratio=%.2f erases=%u dropped=%u\n",
+           stats->records, stats->blocks, stats->raw_bytes, stats->flash_bytes,
+           stats->raw_bytes ? (double)stats->flash_bytes / stats->raw_bytes : 0.0,
+           stats->erases, stats->dropped);
+    printf("flash_bytes_per_hour=%.0f retention_hours=%.1f\n",
+           per_hour, per_hour > 0 ? (double)SECTOR_SIZE * (backend.sector_count - 1) / per_hour : 0.0);
+
+    storage_file_close(&sf);
+    return 0;
+}
+
+static int dump(const char* path, bool csv, int session) {
+    StorageFile sf;
+    StorageBackend backend;
+    if (!open_image(path, 0, &sf, &backend)) {
+        return 1;
+    }
+    if (!session_log_reader_open(&g_reader, &backend)) {
+        fprintf(stderr, "%s: no log blocks\n", path);
+        storage_file_close(&sf);
+        return 1;
+    }
+
+    if (csv) {
+        printf("session,seq,time_ms,type,z,r,kappa,eta,phase,triad_state,triad_crossings,k_formation,active\n");
+    }
+
+    SessionLogRecord rec;
+    uint32_t records = 0;
+    while (session_log_reader_next(&g_reader, &rec)) {
+        if (session >= 0 && rec.session != session) {
+            continue;
+        }
+        records++;
+        const SessionFrame* s = &rec.state;
+        if (csv) {
+            printf("%u,%u,%u,%s,%.4f,%.4f,%.4f,%.4f,%u,%u,%u,%u,%u\n",
+                   rec.session, rec.seq, rec.time_ms, session_log_type_string(rec.type),
+                   s->z, s->r, s->kappa, s->eta, s->phase, s->triad_state,
+                   s->triad_crossings, s->k_formation ? 1 : 0, s->active_sensors);
+            continue;
+        }
+        printf("[%u] %10u ms %-10s ", rec.session, rec.time_ms, session_log_type_string(rec.type));
+        switch (rec.type) {
+            case SESSION_REC_FRAME:
+                printf("z=%.3f r=%.3f kappa=%.3f eta=%.3f active=%u\n",
+                       s->z, s->r, s->kappa, s->eta, s->active_sensors);
+                break;
+            case SESSION_REC_PHASE:
+                printf("%u -> %u at z=%.3f\n", rec.phase_from, s->phase, s->z);
+                break;
+            case SESSION_REC_TRIAD:
+                printf("state=%u crossings=%u\n", s->triad_state, s->triad_crossings);
+                break;
+            case SESSION_REC_KFORMATION:
+                printf("%s kappa=%.3f eta=%.3f R=%u\n", s->k_formation ? "on" : "off",
+                       s->kappa, s->eta, s->active_sensors);
+                break;
+            default:
+                printf("\n");
+                break;
+        }
+    }
+
+    fprintf(stderr, "%u records, %u blocks, %u corrupt\n", records, g_reader.blocks, g_reader.corrupt);
+    storage_file_close(&sf);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    int session = -1;
+    uint32_t minutes = 0;
+    uint16_t sectors = DEFAULT_SECTORS;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            session = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            minutes = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            sectors = (uint16_t)atoi(argv[++i]);
+        } else {
+            break;
+        }
+    }
+    if (i != argc - 1) {
+        fprintf(stderr, "usage: %s [-c] [-s session] image.bin\n"
+                        "       %s -g minutes [-n sectors] out.bin\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    return minutes ? generate(argv[i], minutes, sectors) : dump(argv[i], csv, session);
+}
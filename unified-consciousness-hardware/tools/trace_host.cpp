@@ -0,0 +1,173 @@
+/**
+ * @file trace_host.cpp
+ * @brief Host reader for sensor traces
+ *
+ * Prints the records of a trace written by the native firmware build
+ * (--record), one per line. The image is mmap()ed, so seeking into a long
+ * trace with -f touches only the chunks it reads.
+ *
+ * Build (from unified-consciousness-hardware/):
+ *   g++ -std=c++17 -O2 -Iinclude -Iinclude/ucf tools/trace_host.cpp \
+ *       src/ucf_trace.cpp src/ucf_checksum.cpp -o trace_host
+ *
+ * Usage:
+ *   ./trace_host [-c] [-x] [-t type] [-f from_ms] [-n count] trace.bin
+ *     -c  CSV
+ *     -x  inputs only, no times
+ *     -t  one record type: touch, mag or command
+ *     -f  start at the chunk holding this time
+ *     -n  stop after this many records
+ *
+ * To check a replay, re-record it (--replay a.bin --record b.bin) and diff
+ * "-x -t touch" (and mag, command) of both: each type's stream must match.
+ * How the types interleave follows the loop's timing and may differ.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ucf_trace.h"
+
+static void print_record(const TraceRecord* rec, bool csv, bool inputs_only) {
+    if (csv) {
+        if (!inputs_only) {
+            printf("%u,", rec->time_ms);
+        }
+        printf("%s", trace_type_string(rec->type));
+        switch (rec->type) {
+            case TRACE_REC_TOUCH:
+                for (int i = 0; i < TRACE_HEX_COUNT; i++) {
+                    printf(",%u", rec->touch[i]);
+                }
+                break;
+            case TRACE_REC_MAG:
+                printf(",%d,%d,%d", rec->mag[0], rec->mag[1], rec->mag[2]);
+                break;
+            case TRACE_REC_COMMAND:
+                printf(",%u,%u", rec->command, rec->frame);
+                break;
+        }
+        printf("\n");
+        return;
+    }
+
+    if (!inputs_only) {
+        printf("%10u ms ", rec->time_ms);
+    }
+    printf("%-8s", trace_type_string(rec->type));
+    switch (rec->type) {
+        case TRACE_REC_TOUCH:
+            for (int i = 0; i < TRACE_HEX_COUNT; i++) {
+                printf(" %4u", rec->touch[i]);
+            }
+            printf("\n");
+            break;
+        case TRACE_REC_MAG:
+            printf(" x=%d y=%d z=%d\n", rec->mag[0], rec->mag[1], rec->mag[2]);
+            break;
+        case TRACE_REC_COMMAND:
+            printf(" '%c' after frame %u\n",
+                   (rec->command >= 0x20 && rec->command < 0x7F) ? rec->command : '?', rec->frame);
+            break;
+        default:
+            printf("\n");
+            break;
+    }
+}
+
+static int dump(const char* path, bool csv, bool inputs_only, int type, long from_ms, long count) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "%s: cannot map\n", path);
+        return 1;
+    }
+
+    TraceReader reader;
+    if (!trace_reader_open(&reader, (const uint8_t*)data, (size_t)st.st_size)) {
+        fprintf(stderr, "%s: not a sensor trace\n", path);
+        return 1;
+    }
+    if (from_ms >= 0) {
+        trace_reader_seek(&reader, (uint32_t)from_ms);
+    }
+
+    if (csv) {
+        printf(inputs_only ? "type,values...\n" : "time_ms,type,values...\n");
+    }
+
+    TraceRecord rec;
+    uint32_t records = 0;
+    uint32_t by_type[4] = { 0, 0, 0, 0 };
+    uint32_t first_ms = 0;
+    uint32_t last_ms = 0;
+    while ((count < 0 || records < (uint32_t)count) && trace_reader_next(&reader, &rec)) {
+        if ((from_ms >= 0 && rec.time_ms < (uint32_t)from_ms) || (type > 0 && rec.type != type)) {
+            continue;
+        }
+        if (records == 0) {
+            first_ms = rec.time_ms;
+        }
+        last_ms = rec.time_ms;
+        records++;
+        by_type[rec.type < 4 ? rec.type : 0]++;
+        print_record(&rec, csv, inputs_only);
+    }
+
+    fprintf(stderr, "%u records (%u touch, %u mag, %u command) over %u ms, %u chunks, %u corrupt\n",
+            records, by_type[TRACE_REC_TOUCH], by_type[TRACE_REC_MAG], by_type[TRACE_REC_COMMAND],
+            last_ms - first_ms, reader.chunk_count, reader.corrupt);
+    munmap(data, (size_t)st.st_size);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    bool inputs_only = false;
+    long from_ms = -1;
+    long count = -1;
+    int type = 0;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "-x") == 0) {
+            inputs_only = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (int t = TRACE_REC_TOUCH; t <= TRACE_REC_COMMAND; t++) {
+                if (strcasecmp(name, trace_type_string((uint8_t)t)) == 0) {
+                    type = t;
+                }
+            }
+            if (type == 0) {
+                fprintf(stderr, "unknown record type: %s\n", name);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            from_ms = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            count = atol(argv[++i]);
+        } else {
+            break;
+        }
+    }
+    if (i != argc - 1) {
+        fprintf(stderr, "usage: %s [-c] [-x] [-t type] [-f from_ms] [-n count] trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    return dump(argv[i], csv, inputs_only, type, from_ms, count);
+}